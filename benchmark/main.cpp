@@ -0,0 +1,238 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include <reactphysics3d/reactphysics3d.h>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+/// Reactphysics3D namespace
+using namespace reactphysics3d;
+
+// Benchmark of the broad-phase algorithms
+/// Each scenario is simulated with each broad-phase algorithm and the average time of a
+/// simulation step is reported. The scenarios are the "pile" and "cubes" scenes of the
+/// testbed application (without rendering). The objects of a scene are created in a column
+/// and the column is repeated on a grid to make the scene as dense as needed. Note that
+/// the pile falls on a flat floor instead of the sandbox mesh of the testbed. The simulation
+/// steps do not cast rays. Note that the ray casting of the sweep-and-prune is a linear scan
+/// of all the objects. Therefore, its ray casting timings cannot be compared with the ones of
+/// the other algorithms.
+///
+/// Usage: benchmark [nbSteps] [nbThreads] [nbColumns]
+
+// Function that creates the objects of a scenario in a world
+using CreateSceneFunction = void (*)(PhysicsCommon& physicsCommon, PhysicsWorld* world, uint nbColumns);
+
+// Scenario of the benchmark
+struct Scenario {
+
+    /// Name of the scenario
+    std::string name;
+
+    /// Function that creates the objects of the scenario
+    CreateSceneFunction createScene;
+};
+
+// Return the position of a column of objects on the grid of columns
+static Vector3 getColumnPosition(uint column, uint nbColumns) {
+
+    const decimal spacing = decimal(12.0);
+    const uint nbColumnsPerSide = static_cast<uint>(std::ceil(std::sqrt(static_cast<double>(nbColumns))));
+    const decimal offset = decimal(0.5) * spacing * decimal(nbColumnsPerSide - 1);
+
+    return Vector3(decimal(column % nbColumnsPerSide) * spacing - offset, 0,
+                   decimal(column / nbColumnsPerSide) * spacing - offset);
+}
+
+// Create a dynamic rigid body with a single collider
+static void createBody(PhysicsWorld* world, CollisionShape* shape, const Vector3& position) {
+
+    RigidBody* body = world->createRigidBody(Transform(position, Quaternion::identity()));
+    Collider* collider = body->addCollider(shape, Transform::identity());
+    collider->getMaterial().setBounciness(decimal(0.2));
+}
+
+// Create the static floor under the columns of objects
+static void createFloor(PhysicsCommon& physicsCommon, PhysicsWorld* world, uint nbColumns) {
+
+    const uint nbColumnsPerSide = static_cast<uint>(std::ceil(std::sqrt(static_cast<double>(nbColumns))));
+    const decimal halfSize = decimal(25.0) + decimal(6.0) * decimal(nbColumnsPerSide);
+
+    BoxShape* floorShape = physicsCommon.createBoxShape(Vector3(halfSize, decimal(0.5), halfSize));
+    RigidBody* floor = world->createRigidBody(Transform::identity());
+    floor->setType(BodyType::STATIC);
+    floor->addCollider(floorShape, Transform::identity());
+}
+
+// Create the "pile" scenario (boxes, spheres and capsules falling on each other)
+static void createPileScene(PhysicsCommon& physicsCommon, PhysicsWorld* world, uint nbColumns) {
+
+    const uint nbBoxes = 150;
+    const uint nbSpheres = 80;
+    const uint nbCapsules = 5;
+    const decimal radius = decimal(3.0);
+
+    BoxShape* boxShape = physicsCommon.createBoxShape(Vector3(1, 1, 1));
+    SphereShape* sphereShape = physicsCommon.createSphereShape(decimal(1.5));
+    CapsuleShape* capsuleShape = physicsCommon.createCapsuleShape(decimal(1.0), decimal(1.0));
+
+    for (uint c=0; c < nbColumns; c++) {
+
+        const Vector3 columnPosition = getColumnPosition(c, nbColumns);
+
+        for (uint i=0; i < nbBoxes; i++) {
+            const decimal angle = decimal(i) * decimal(30.0);
+            createBody(world, boxShape, columnPosition + Vector3(radius * std::cos(angle), decimal(85.0) + decimal(i) * decimal(2.8),
+                                                                 radius * std::sin(angle)));
+        }
+
+        for (uint i=0; i < nbSpheres; i++) {
+            const decimal angle = decimal(i) * decimal(35.0);
+            createBody(world, sphereShape, columnPosition + Vector3(radius * std::cos(angle), decimal(75.0) + decimal(i) * decimal(2.3),
+                                                                    radius * std::sin(angle)));
+        }
+
+        for (uint i=0; i < nbCapsules; i++) {
+            const decimal angle = decimal(i) * decimal(45.0);
+            createBody(world, capsuleShape, columnPosition + Vector3(radius * std::cos(angle), decimal(40.0) + decimal(i) * decimal(1.3),
+                                                                     radius * std::sin(angle)));
+        }
+    }
+
+    createFloor(physicsCommon, world, nbColumns);
+}
+
+// Create the "cubes" scenario (a column of cubes falling on the floor)
+static void createCubesScene(PhysicsCommon& physicsCommon, PhysicsWorld* world, uint nbColumns) {
+
+    const uint nbCubes = 40;
+    const decimal radius = decimal(2.0);
+
+    BoxShape* boxShape = physicsCommon.createBoxShape(Vector3(1, 1, 1));
+
+    for (uint c=0; c < nbColumns; c++) {
+
+        const Vector3 columnPosition = getColumnPosition(c, nbColumns);
+
+        for (uint i=0; i < nbCubes; i++) {
+            const decimal angle = decimal(i) * decimal(30.0);
+            createBody(world, boxShape, columnPosition + Vector3(radius * std::cos(angle), decimal(10.0) + decimal(i) * decimal(2.3), 0));
+        }
+    }
+
+    createFloor(physicsCommon, world, nbColumns);
+}
+
+// Broad-phase algorithm of the benchmark
+struct BroadPhase {
+
+    /// Name of the broad-phase algorithm
+    std::string name;
+
+    /// Type of the broad-phase algorithm
+    BroadPhaseAlgorithmType type;
+};
+
+// Simulate a scenario and return the average time of a simulation step (in milliseconds)
+static double runScenario(const Scenario& scenario, BroadPhaseAlgorithmType broadPhaseAlgorithm, uint nbSteps,
+                          uint nbThreads, uint nbColumns) {
+
+    PhysicsCommon physicsCommon;
+
+    PhysicsWorld::WorldSettings settings;
+    settings.worldName = scenario.name;
+    settings.broadPhaseAlgorithm = broadPhaseAlgorithm;
+    if (nbThreads > 1) {
+        settings.taskScheduler = physicsCommon.createDefaultTaskScheduler(nbThreads);
+    }
+
+    PhysicsWorld* world = physicsCommon.createPhysicsWorld(settings);
+    scenario.createScene(physicsCommon, world, nbColumns);
+
+    const decimal timeStep = decimal(1.0) / decimal(60.0);
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    for (uint i=0; i < nbSteps; i++) {
+        world->update(timeStep);
+    }
+
+    const auto endTime = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::milli>(endTime - startTime).count() / nbSteps;
+}
+
+int main(int argc, char** argv) {
+
+    const uint nbSteps = argc > 1 ? static_cast<uint>(std::atoi(argv[1])) : 600;
+    const uint nbThreads = argc > 2 ? static_cast<uint>(std::atoi(argv[2])) : 1;
+    const uint nbColumns = argc > 3 ? static_cast<uint>(std::atoi(argv[3])) : 4;
+
+    if (nbSteps == 0 || nbColumns == 0) {
+        std::cerr << "Usage: " << argv[0] << " [nbSteps] [nbThreads] [nbColumns]" << std::endl;
+        return 1;
+    }
+
+    const Scenario scenarios[] = {{"pile", createPileScene}, {"cubes", createCubesScene}};
+    const BroadPhase broadPhases[] = {{"DynamicAABBTree", BroadPhaseAlgorithmType::DYNAMIC_AABB_TREE},
+                                      {"SweepAndPrune", BroadPhaseAlgorithmType::SWEEP_AND_PRUNE},
+                                      {"HashGrid", BroadPhaseAlgorithmType::HASH_GRID}};
+
+    std::cout << "Broad-phase benchmark: " << nbSteps << " steps, " << nbThreads << " thread(s), "
+              << nbColumns << " column(s) of objects" << std::endl << std::endl;
+    std::cout << std::left << std::setw(10) << "Scenario" << std::setw(20) << "Broad-phase"
+              << std::right << std::setw(12) << "ms/step" << std::endl;
+
+    for (const Scenario& scenario : scenarios) {
+
+        // The speedups are relative to the dynamic AABB tree (the first broad-phase)
+        double treeTime = 0.0;
+
+        for (const BroadPhase& broadPhase : broadPhases) {
+
+            const double time = runScenario(scenario, broadPhase.type, nbSteps, nbThreads, nbColumns);
+
+            std::cout << std::left << std::setw(10) << scenario.name << std::setw(20) << broadPhase.name
+                      << std::right << std::setw(12) << std::fixed << std::setprecision(3) << time;
+            if (broadPhase.type == BroadPhaseAlgorithmType::DYNAMIC_AABB_TREE) {
+                treeTime = time;
+            }
+            else {
+                std::cout << "  (x" << std::setprecision(2) << (treeTime / time) << ")";
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    std::cout << std::endl << "Note: no ray is cast during the steps. The ray casting of the sweep-and-prune is a linear scan"
+              << std::endl << "of all the objects and its timings are not comparable with the other algorithms." << std::endl;
+
+    return 0;
+}
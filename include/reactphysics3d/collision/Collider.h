@@ -36,6 +36,7 @@ namespace  reactphysics3d {
 
 // Declarations
 class MemoryManager;
+struct RayPacket;
 
 // Class Collider
 /**
@@ -78,6 +79,9 @@ class Collider {
         /// changed by the user
         void setHasCollisionShapeChangedSize(bool hasCollisionShapeChangedSize);
 
+        /// Raycast method for the rays of a packet in the bit mask
+        uint32 raycast(const RayPacket& packet, uint32 rayMask, RaycastInfo* outRaycastInfos);
+
     public:
 
         // -------------------- Methods -------------------- //
@@ -148,6 +152,12 @@ class Collider {
         /// Return the broad-phase id
         int getBroadPhaseId() const;
 
+        /// Return the percentage used to inflate the fat AABB of the collider in the broad-phase
+        decimal getFatAABBInflatePercentage() const;
+
+        /// Set the percentage used to inflate the fat AABB of the collider in the broad-phase
+        void setFatAABBInflatePercentage(decimal percentage);
+
         /// Return a reference to the material properties of the collider
         Material& getMaterial();
 
@@ -178,6 +188,7 @@ class Collider {
         friend class PhysicsWorld;
         friend class GJKAlgorithm;
         friend class ConvexMeshShape;
+        friend struct RaycastBatchTest;
         friend class CollisionShape;
         friend class ContactManifoldSet;
 		friend class MiddlePhaseTriangleCallback;
@@ -63,6 +63,12 @@ class PolyhedronMesh {
         /// Centroid of the polyhedron
         Vector3 mCentroid;
 
+        /// Maximum number of vertices of a face of the polyhedron
+        uint mNbMaxFaceVertices;
+
+        /// True if no two adjacent faces are coplanar and no face has two collinear consecutive edges
+        bool mIsStrictlyConvex;
+
         // -------------------- Methods -------------------- //
 
         /// Constructor
@@ -77,6 +83,9 @@ class PolyhedronMesh {
         /// Compute the centroid of the polyhedron
         void computeCentroid() ;
 
+        /// Compute whether the edges of the half-edge structure are the edges of the convex hull
+        void computeIsStrictlyConvex();
+
         /// Compute and return the area of a face
         decimal getFaceArea(uint faceIndex) const;
 
@@ -96,6 +105,9 @@ class PolyhedronMesh {
         /// Return the number of faces
         uint getNbFaces() const;
 
+        /// Return the maximum number of vertices of a face
+        uint getNbMaxFaceVertices() const;
+
         /// Return a face normal
         Vector3 getFaceNormal(uint faceIndex) const;
 
@@ -108,6 +120,9 @@ class PolyhedronMesh {
         /// Compute and return the volume of the polyhedron
         decimal getVolume() const;
 
+        /// Return true if no two adjacent faces are coplanar and no face has collinear edges
+        bool isStrictlyConvex() const;
+
         // ---------- Friendship ---------- //
 
         friend class PhysicsCommon;
@@ -129,6 +144,14 @@ inline uint PolyhedronMesh::getNbFaces() const {
    return mHalfEdgeStructure.getNbFaces();
 }
 
+// Return the maximum number of vertices of a face
+/**
+ * @return The maximum number of vertices of a face of the mesh
+ */
+inline uint PolyhedronMesh::getNbMaxFaceVertices() const {
+    return mNbMaxFaceVertices;
+}
+
 // Return a face normal
 /**
  * @param faceIndex The index of a given face of the mesh
@@ -155,6 +178,16 @@ inline Vector3 PolyhedronMesh::getCentroid() const {
     return mCentroid;
 }
 
+// Return true if no two adjacent faces are coplanar and no face has collinear edges
+/// In that case, the edges of the mesh are exactly the edges of the polyhedron and a support
+/// vertex can be found by walking from a vertex to its neighbors (hill-climbing)
+/**
+ * @return True if the vertex adjacency of the mesh can be used for hill-climbing
+ */
+inline bool PolyhedronMesh::isStrictlyConvex() const {
+    return mIsStrictlyConvex;
+}
+
 }
 
 #endif
@@ -0,0 +1,130 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+
+#ifndef REACTPHYSICS3D_RAY_PACKET_H
+#define REACTPHYSICS3D_RAY_PACKET_H
+
+// Libraries
+#include <reactphysics3d/configuration.h>
+#include <reactphysics3d/mathematics/Ray.h>
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Declarations
+class AABB;
+struct Transform;
+
+// Structure RayPacket
+/**
+ * This structure represents a group of up to four rays that are cast at the same time
+ * through an AABB tree. The origins, the inverse directions and the maximum fractions of
+ * the rays are stored as a structure of arrays so that an AABB is tested against the
+ * four rays with a single sequence of SIMD instructions. When the rays are coherent (similar
+ * origins and directions), they visit mostly the same nodes of the tree and the cost of
+ * the traversal is shared between the rays. Each ray of the packet is clipped independently
+ * to its closest hit. An unused ray of the packet has a negative maximum fraction and is never hit.
+ */
+struct RayPacket {
+
+    public:
+
+        // -------------------- Constants -------------------- //
+
+        /// Maximum number of rays in a packet
+        static const uint32 MAX_NB_RAYS = 4;
+
+        // -------------------- Attributes -------------------- //
+
+        /// First points of the rays (origins)
+        Vector3 points1[MAX_NB_RAYS];
+
+        /// Second points of the rays
+        Vector3 points2[MAX_NB_RAYS];
+
+        /// x coordinates of the origins of the rays
+        decimal originX[MAX_NB_RAYS];
+
+        /// y coordinates of the origins of the rays
+        decimal originY[MAX_NB_RAYS];
+
+        /// z coordinates of the origins of the rays
+        decimal originZ[MAX_NB_RAYS];
+
+        /// x components of the inverse directions of the rays
+        decimal inverseDirectionX[MAX_NB_RAYS];
+
+        /// y components of the inverse directions of the rays
+        decimal inverseDirectionY[MAX_NB_RAYS];
+
+        /// z components of the inverse directions of the rays
+        decimal inverseDirectionZ[MAX_NB_RAYS];
+
+        /// Maximum fractions of the rays (negative for an unused ray)
+        decimal maxFractions[MAX_NB_RAYS];
+
+        /// Number of rays in the packet
+        uint32 nbRays;
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        RayPacket(const Ray* rays, uint32 nbRays);
+
+        /// Constructor with the rays of another packet transformed and scaled into a local-space
+        RayPacket(const RayPacket& packet, uint32 rayMask, const Transform& transform, const Vector3& scale);
+
+        /// Return a ray of the packet clipped to its current maximum fraction
+        Ray getRay(uint32 rayIndex) const;
+
+        /// Clip a ray of the packet to a hit fraction if the hit is closer than the current one
+        void clipRay(uint32 rayIndex, decimal hitFraction);
+
+        /// Return the bit mask of the rays of the packet that intersect an AABB
+        uint32 testAABB(const Vector3& aabbMin, const Vector3& aabbMax, decimal* outEntryFractions) const;
+
+        /// Return the bit mask of the rays of the packet that intersect an AABB
+        uint32 testAABB(const AABB& aabb, decimal* outEntryFractions) const;
+};
+
+// Return a ray of the packet clipped to its current maximum fraction
+inline Ray RayPacket::getRay(uint32 rayIndex) const {
+    assert(rayIndex < nbRays);
+    return Ray(points1[rayIndex], points2[rayIndex], maxFractions[rayIndex]);
+}
+
+// Clip a ray of the packet to a hit fraction if the hit is closer than the current one
+/// A negative hit fraction is ignored.
+inline void RayPacket::clipRay(uint32 rayIndex, decimal hitFraction) {
+    assert(rayIndex < nbRays);
+    if (hitFraction >= decimal(0.0) && hitFraction < maxFractions[rayIndex]) {
+        maxFractions[rayIndex] = hitFraction;
+    }
+}
+
+}
+
+#endif
@@ -37,6 +37,7 @@ class CollisionBody;
 class Collider;
 class CollisionShape;
 struct Ray;
+struct RayPacket;
 
 // Structure RaycastInfo
 /**
@@ -143,6 +144,23 @@ struct RaycastTest {
         decimal raycastAgainstShape(Collider* shape, const Ray& ray);
 };
 
+/// Structure RaycastBatchTest
+struct RaycastBatchTest {
+
+    public:
+
+        /// Closest hits of the rays of the current packet
+        RaycastInfo* hits;
+
+        /// Constructor
+        RaycastBatchTest(RaycastInfo* packetHits) {
+            hits = packetHits;
+        }
+
+        /// Ray cast test of the rays of a packet in the bit mask against a collider
+        void raycastAgainstShape(Collider* shape, RayPacket& packet, uint32 rayMask);
+};
+
 }
 
 #endif
@@ -0,0 +1,114 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_BROAD_PHASE_ALGORITHM_H
+#define REACTPHYSICS3D_BROAD_PHASE_ALGORITHM_H
+
+// Libraries
+#include <reactphysics3d/configuration.h>
+#include <reactphysics3d/containers/List.h>
+#include <reactphysics3d/containers/Pair.h>
+#include <reactphysics3d/containers/Stack.h>
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Declarations
+class AABB;
+struct Vector3;
+struct Ray;
+struct RayPacket;
+class DynamicAABBTreeRaycastCallback;
+class DynamicAABBTreeRayPacketCallback;
+class MemoryManager;
+class Profiler;
+
+// Class BroadPhaseAlgorithm
+/**
+ * This abstract class is the interface of the spatial data structures used by the
+ * broad-phase collision detection to store the fat AABBs of the colliders. Each object
+ * of the structure is identified by a broad-phase ID and has a pointer to its data (the
+ * collider). The fat AABB of an object is its AABB inflated by a percentage of its size.
+ * It only changes when the real AABB of the object is not inside of it anymore. An object
+ * can be static (collider of a static body). The AABB of a static object is not inflated
+ * and a pair of two static objects is never reported.
+ */
+class BroadPhaseAlgorithm {
+
+    public:
+
+        /// Destructor
+        virtual ~BroadPhaseAlgorithm() = default;
+
+        /// Add an object with a given AABB and return its broad-phase ID
+        virtual int32 addObject(const AABB& aabb, void* data, bool isStatic)=0;
+
+        /// Remove an object
+        virtual void removeObject(int32 broadPhaseId)=0;
+
+        /// Update the AABB of an object. Return true if the fat AABB of the object has changed.
+        /// A new fat AABB is inflated by "fatAABBInflatePercentage" (or by the default percentage of
+        /// the algorithm if negative) and extended by the predicted "displacement" of the object.
+        virtual bool updateObject(int32 broadPhaseId, const AABB& newAABB, const Vector3& displacement,
+                                  decimal fatAABBInflatePercentage, bool forceReInsert)=0;
+
+        /// Set whether an object is static or not
+        virtual void setObjectIsStatic(int32 broadPhaseId, bool isStatic)=0;
+
+        /// Return the fat AABB of an object
+        virtual const AABB& getFatAABB(int32 broadPhaseId) const=0;
+
+        /// Return the data pointer of an object
+        virtual void* getObjectData(int32 broadPhaseId) const=0;
+
+        /// Add all the pairs of objects with overlapping fat AABBs where at least one object
+        /// is in the list of moved objects and at least one object is not static. A pair may be
+        /// reported several times and an object may be reported with itself.
+        virtual void computeOverlappingPairs(MemoryManager& memoryManager, const List<int32>& movedObjects,
+                                             List<Pair<int32, int32>>& overlappingPairs)=0;
+
+        /// Report all the objects with a fat AABB hit by a ray to a callback
+        virtual void raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const=0;
+
+        /// Report all the objects with a fat AABB hit by some rays of a packet to a callback. The
+        /// stack can be used for the traversal of the structure. This method can be called by
+        /// several threads at the same time.
+        virtual void raycast(RayPacket& packet, Stack<int32>& stack, DynamicAABBTreeRayPacketCallback& callback) const=0;
+
+        /// Reorder the internal data of the structure in memory to make the queries more cache friendly
+        virtual void compact()=0;
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+        /// Set the profiler
+        virtual void setProfiler(Profiler* profiler)=0;
+
+#endif
+
+};
+
+}
+
+#endif
@@ -30,6 +30,7 @@
 #include <reactphysics3d/configuration.h>
 #include <reactphysics3d/collision/shapes/AABB.h>
 #include <reactphysics3d/containers/Set.h>
+#include <reactphysics3d/containers/Stack.h>
 
 /// Namespace ReactPhysics3D
 namespace reactphysics3d {
@@ -40,9 +41,11 @@ class BroadPhaseRaycastTestCallback;
 class DynamicAABBTreeOverlapCallback;
 class CollisionBody;
 struct RaycastTest;
+struct RayPacket;
 class AABB;
 class Profiler;
 class MemoryAllocator;
+class TaskScheduler;
 
 
 // Structure TreeNode
@@ -94,6 +97,34 @@ struct TreeNode {
     bool isLeaf() const;
 };
 
+// Structure DynamicAABBTreeObject
+/**
+ * This structure represents an object (AABB and data) that is inserted into
+ * a dynamic AABB tree with the DynamicAABBTree::build() method.
+ */
+struct DynamicAABBTreeObject {
+
+    /// AABB of the object
+    AABB aabb;
+
+    // Two pieces of data or a pointer stored at the leaf node of the object
+    union {
+        int32 dataInt[2];
+        void* dataPointer;
+    };
+
+    /// Constructor (where node data are two integers)
+    DynamicAABBTreeObject(const AABB& objectAABB, int32 data1, int32 data2) : aabb(objectAABB) {
+        dataInt[0] = data1;
+        dataInt[1] = data2;
+    }
+
+    /// Constructor (where node data is a pointer)
+    DynamicAABBTreeObject(const AABB& objectAABB, void* data) : aabb(objectAABB) {
+        dataPointer = data;
+    }
+};
+
 // Class DynamicAABBTreeOverlapCallback
 /**
  * Overlapping callback method that has to be used as parameter of the
@@ -127,6 +158,23 @@ class DynamicAABBTreeRaycastCallback {
 
 };
 
+// Class DynamicAABBTreeRayPacketCallback
+/**
+ * Raycast callback in the Dynamic AABB Tree called when the AABB of a leaf
+ * node is hit by some rays of a packet. The callback clips the hit rays of the
+ * packet to their closest hit.
+ */
+class DynamicAABBTreeRayPacketCallback {
+
+    public:
+
+        // Called when the AABB of a leaf node is hit by the rays of a packet in the bit mask
+        virtual void raycastBroadPhaseShape(int32 nodeId, RayPacket& packet, uint32 rayMask)=0;
+
+        virtual ~DynamicAABBTreeRayPacketCallback() = default;
+
+};
+
 // Class DynamicAABBTree
 /**
  * This class implements a dynamic AABB tree that is used for broad-phase
@@ -138,6 +186,46 @@ class DynamicAABBTree {
 
     private:
 
+        /// Range [startIndex, endIndex) of the objects of a bulk-build and the node of its sub-tree
+        struct BuildRange {
+
+            /// Index of the first object of the range
+            uint32 startIndex;
+
+            /// Index after the last object of the range
+            uint32 endIndex;
+
+            /// ID of the root node of the sub-tree of the range
+            int32 nodeID;
+
+            /// ID of the parent node of the sub-tree
+            int32 parentID;
+        };
+
+        /// Temporary arrays used during a bulk-build of the tree
+        struct BuildArrays {
+
+            /// Indices of the objects (reordered while the tree is built)
+            uint32* objectsIndices;
+
+            /// Fat AABBs of the objects
+            AABB* fatAABBs;
+
+            /// Centers of the fat AABBs of the objects
+            Vector3* centroids;
+
+            /// Output array with the node ID of each object (can be null)
+            int32* nodesIDs;
+        };
+
+        // -------------------- Constants -------------------- //
+
+        /// Number of bins used to find the best split of a range of objects during a bulk-build
+        static const uint32 NB_BUILD_BINS = 16;
+
+        /// Minimum number of objects in a range of a bulk-build to build its sub-tree in a separate task
+        static const uint32 BUILD_TASK_MIN_NB_OBJECTS = 1024;
+
         // -------------------- Attributes -------------------- //
 
         /// Memory allocator
@@ -158,6 +246,9 @@ class DynamicAABBTree {
         /// Number of nodes in the tree
         int32 mNbNodes;
 
+        /// ID of the next node to visit by the incremental optimization of the tree
+        int32 mOptimizationNodeID;
+
         /// The fat AABB is the initial AABB inflated by a given percentage of its size.
         decimal mFatAABBInflatePercentage;
 
@@ -186,7 +277,10 @@ class DynamicAABBTree {
         int32 balanceSubTreeAtNode(int32 nodeID);
 
         /// Compute the height of a given node in the tree
-        int computeHeight(int32 nodeID);
+        int computeHeight(int32 nodeID) const;
+
+        /// Apply the best rotation (if any) at a given internal node
+        void rotateNode(int32 nodeID);
 
         /// Internally add an object into the tree
         int32 addObjectInternal(const AABB& aabb);
@@ -194,6 +288,17 @@ class DynamicAABBTree {
         /// Initialize the tree
         void init();
 
+        /// Split a range of objects of a bulk-build and return the index of the first object of the second part
+        uint32 splitBuildRange(const BuildArrays& arrays, const BuildRange& range) const;
+
+        /// Create the nodes of the sub-tree of a range of objects of a bulk-build
+        void buildRange(const List<DynamicAABBTreeObject>& objects, const BuildArrays& arrays, const BuildRange& range,
+                        uint32 maxRangeSize, List<BuildRange>* outPendingRanges);
+
+        /// Compute the pairs of nodes to visit after a pair of nodes during a tree-vs-tree traversal
+        uint32 computeChildrenNodePairs(const DynamicAABBTree& otherTree, const Pair<int32, int32>& nodePair,
+                                        int32* outNodesIDs, int32* outOtherNodesIDs) const;
+
 #ifndef NDEBUG
 
         /// Check if the tree structure is valid (for debugging purpose)
@@ -220,12 +325,20 @@ class DynamicAABBTree {
         /// Add an object into the tree (where node data is a pointer)
         int32 addObject(const AABB& aabb, void* data);
 
+        /// Build the whole tree from an array of objects in a single pass
+        void build(const List<DynamicAABBTreeObject>& objects, List<int32>* outNodesIDs = nullptr,
+                   TaskScheduler* taskScheduler = nullptr);
+
         /// Remove an object from the tree
         void removeObject(int32 nodeID);
 
         /// Update the dynamic tree after an object has moved.
         bool updateObject(int32 nodeID, const AABB& newAABB, bool forceReinsert = false);
 
+        /// Update the dynamic tree after an object has moved with a given displacement and inflation percentage
+        bool updateObject(int32 nodeID, const AABB& newAABB, const Vector3& displacement,
+                          decimal fatAABBInflatePercentage, bool forceReinsert = false);
+
         /// Return the fat AABB corresponding to a given node ID
         const AABB& getFatAABB(int32 nodeID) const;
 
@@ -242,11 +355,39 @@ class DynamicAABBTree {
         /// Report all shapes overlapping with the AABB given in parameter.
         void reportAllShapesOverlappingWithAABB(const AABB& aabb, List<int>& overlappingNodes) const;
 
+        /// Report all shapes overlapping with an AABB as pairs of an object ID and the first data integer of the node
+        void reportAllShapesOverlappingWithAABB(const AABB& aabb, int32 objectId, Stack<int32>& stack,
+                                                List<Pair<int32, int32>>& outOverlappingPairs) const;
+
+        /// Report the pairs of leaves with overlapping AABBs in this tree and another tree (or in this tree only)
+        void reportAllOverlappingLeaves(const DynamicAABBTree& otherTree, Stack<Pair<int32, int32>>& stack,
+                                        List<Pair<int32, int32>>& outOverlappingPairs) const;
+
+        /// Report the pairs of leaves with overlapping AABBs below a pair of nodes of this tree and another tree
+        void reportOverlappingLeaves(const DynamicAABBTree& otherTree, const Pair<int32, int32>& nodePair,
+                                     Stack<Pair<int32, int32>>& stack, List<Pair<int32, int32>>& outOverlappingPairs) const;
+
+        /// Split the traversal of this tree and another tree into pairs of nodes that can be traversed independently
+        void splitTreeVsTreeTraversal(const DynamicAABBTree& otherTree, uint32 minNbNodePairs,
+                                      List<Pair<int32, int32>>& outNodePairs) const;
+
         /// Ray casting method
         void raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const;
 
+        /// Ray casting method for a packet of rays
+        void raycast(RayPacket& packet, Stack<int32>& stack, DynamicAABBTreeRayPacketCallback& callback) const;
+
+        /// Reorder the nodes of the tree in memory in depth-first order
+        void compact(List<int32>* outNewNodesIDs = nullptr);
+
+        /// Optimize a given number of internal nodes of the tree with rotations
+        void optimizeIncremental(uint32 nbNodesToOptimize);
+
         /// Compute the height of the tree
-        int computeHeight();
+        int computeHeight() const;
+
+        /// Compute the surface area heuristic (SAH) cost of the tree
+        decimal computeSAHCost() const;
 
         /// Return the root AABB of the tree
         AABB getRootAABB() const;
@@ -261,6 +402,10 @@ class DynamicAABBTree {
 
 #endif
 
+        // -------------------- Friendship -------------------- //
+
+        friend class WideAABBTree;
+        friend class QuantizedAABBTree;
 };
 
 // Return true if the node is a leaf of the tree
@@ -268,6 +413,12 @@ inline bool TreeNode::isLeaf() const {
     return (height == 0);
 }
 
+// Update the dynamic tree after an object has moved.
+/// The fat AABB of the object is inflated with the percentage of the tree if it is reinserted.
+inline bool DynamicAABBTree::updateObject(int32 nodeID, const AABB& newAABB, bool forceReinsert) {
+    return updateObject(nodeID, newAABB, Vector3::zero(), mFatAABBInflatePercentage, forceReinsert);
+}
+
 // Return the fat AABB corresponding to a given node ID
 inline const AABB& DynamicAABBTree::getFatAABB(int32 nodeID) const {
     assert(nodeID >= 0 && nodeID < mNbAllocatedNodes);
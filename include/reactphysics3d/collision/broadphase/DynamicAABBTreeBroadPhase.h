@@ -0,0 +1,342 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_DYNAMIC_AABB_TREE_BROAD_PHASE_H
+#define REACTPHYSICS3D_DYNAMIC_AABB_TREE_BROAD_PHASE_H
+
+// Libraries
+#include <reactphysics3d/collision/broadphase/BroadPhaseAlgorithm.h>
+#include <reactphysics3d/collision/broadphase/DynamicAABBTree.h>
+#include <reactphysics3d/collision/broadphase/WideAABBTree.h>
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Declarations
+class TaskScheduler;
+
+// Class TreeRaycastCallback
+/**
+ * Raycast callback used to cast a ray against one of the trees of the broad-phase. It
+ * reports the broad-phase IDs of the hit objects to another callback and keeps the smallest
+ * hit fraction so that the ray can be clipped before it is cast against the other tree.
+ */
+class TreeRaycastCallback : public DynamicAABBTreeRaycastCallback {
+
+    public:
+
+        /// Tree hit by the ray
+        const DynamicAABBTree& mTree;
+
+        /// Callback that receives the broad-phase IDs of the hit objects
+        DynamicAABBTreeRaycastCallback& mCallback;
+
+        /// Smallest hit fraction
+        decimal mMaxFraction;
+
+        /// True if the callback has asked to stop the ray casting
+        bool mIsStopped;
+
+        // Constructor
+        TreeRaycastCallback(const DynamicAABBTree& tree, DynamicAABBTreeRaycastCallback& callback, decimal maxFraction)
+            : mTree(tree), mCallback(callback), mMaxFraction(maxFraction), mIsStopped(false) {
+
+        }
+
+        // Destructor
+        virtual ~TreeRaycastCallback() override = default;
+
+        // Called when the AABB of a leaf node is hit by a ray
+        virtual decimal raycastBroadPhaseShape(int32 nodeId, const Ray& ray) override;
+};
+
+// Class TreeRayPacketCallback
+/**
+ * Raycast callback used to cast a packet of rays against one of the trees of the broad-phase.
+ * It reports the broad-phase IDs of the hit objects to another callback.
+ */
+class TreeRayPacketCallback : public DynamicAABBTreeRayPacketCallback {
+
+    public:
+
+        /// Tree hit by the rays
+        const DynamicAABBTree& mTree;
+
+        /// Callback that receives the broad-phase IDs of the hit objects
+        DynamicAABBTreeRayPacketCallback& mCallback;
+
+        // Constructor
+        TreeRayPacketCallback(const DynamicAABBTree& tree, DynamicAABBTreeRayPacketCallback& callback)
+            : mTree(tree), mCallback(callback) {
+
+        }
+
+        // Destructor
+        virtual ~TreeRayPacketCallback() override = default;
+
+        // Called when the AABB of a leaf node is hit by the rays of a packet in the bit mask
+        virtual void raycastBroadPhaseShape(int32 nodeId, RayPacket& packet, uint32 rayMask) override;
+};
+
+// Class DynamicAABBTreeBroadPhase
+/**
+ * Broad-phase algorithm that stores the fat AABBs of the objects in dynamic AABB trees.
+ * The static objects are stored in their own tree that is rebuilt with the SAH bulk-build
+ * when many static objects have been inserted (when a level is loaded for instance). The
+ * other objects are stored in a second tree. An object is removed and re-inserted into its
+ * tree when its AABB leaves its fat AABB. The moved objects are used to query the trees for
+ * overlapping objects. A moved static object only queries the tree of the non-static objects.
+ * When most of the non-static objects have moved, the trees are traversed together instead.
+ * Once the static tree has not been modified during a whole frame, it is collapsed into a
+ * wide tree that is used instead of the static tree for the queries.
+ * This is the default broad-phase algorithm. It works well with large worlds where only a
+ * part of the objects move at each frame.
+ */
+class DynamicAABBTreeBroadPhase : public BroadPhaseAlgorithm {
+
+    private:
+
+        // Structure TreeProxy
+        /**
+         * An object of the broad-phase
+         */
+        struct TreeProxy {
+
+            /// Data pointer of the object
+            void* data;
+
+            /// ID of the node of the object in its tree (-1 if the proxy is free)
+            int32 nodeId;
+
+            /// True if the object is in the static tree
+            bool isStatic;
+
+            /// True if the object is one of the moved objects during the computation of the overlapping pairs
+            bool hasMoved;
+        };
+
+        // -------------------- Constants -------------------- //
+
+        /// Minimum number of objects inserted one by one into the static tree (and percentage of
+        /// the number of static objects) from which the static tree is built again from scratch
+        static const uint32 MIN_NB_STATIC_INSERTIONS_REBUILD = 64;
+
+        // -------------------- Attributes -------------------- //
+
+        /// Memory allocator
+        MemoryAllocator& mAllocator;
+
+        /// Dynamic AABB tree with the non-static objects
+        DynamicAABBTree mDynamicTree;
+
+        /// Dynamic AABB tree with the static objects
+        DynamicAABBTree mStaticTree;
+
+        /// Wide tree collapsed from the static tree (empty if the static tree has been modified)
+        WideAABBTree mStaticWideTree;
+
+        /// True if the static tree has been modified since the last computation of the overlapping pairs
+        bool mIsStaticTreeModified;
+
+        /// True if the nodes of the static tree are in depth-first order (built or compacted and not modified since)
+        bool mIsStaticTreeCompacted;
+
+        /// Array of proxies indexed by broad-phase ID
+        List<TreeProxy> mProxies;
+
+        /// Broad-phase IDs of the free proxies
+        List<int32> mFreeProxies;
+
+        /// Number of static objects
+        uint32 mNbStaticObjects;
+
+        /// Number of objects inserted one by one into the static tree since it has been built
+        uint32 mNbStaticInsertions;
+
+        /// Default percentage of the size of the AABBs used to inflate the fat AABBs of the non-static objects
+        decimal mFatAABBInflatePercentage;
+
+        /// Maximum number of internal nodes of the tree of the non-static objects optimized at each frame
+        uint32 mDynamicTreeOptimizationBudget;
+
+        /// Task scheduler used to split the work among several threads (null if single-threaded)
+        TaskScheduler* mTaskScheduler;
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+        /// Pointer to the profiler
+        Profiler* mProfiler;
+
+#endif
+
+        // -------------------- Methods -------------------- //
+
+        /// Return the tree of an object
+        const DynamicAABBTree& getTree(const TreeProxy& proxy) const;
+
+        /// Build the static tree again from scratch
+        void rebuildStaticTree();
+
+        /// Notify that the static tree has been modified
+        void setStaticTreeModified();
+
+        /// Reorder the nodes of one of the trees in memory and update the nodes of the proxies
+        void compactTree(bool isStaticTree);
+
+        /// Report the objects overlapping with a range of the moved objects
+        void reportOverlappingObjects(const List<int32>& movedObjects, uint32 startIndex, uint32 endIndex,
+                                      List<Pair<int32, int32>>& overlappingPairs) const;
+
+        /// Compute the overlapping pairs of the moved objects using several threads
+        void computeOverlappingPairsParallel(MemoryManager& memoryManager, const List<int32>& movedObjects,
+                                             List<Pair<int32, int32>>& overlappingPairs);
+
+        /// Compute the overlapping pairs of the moved objects by traversing the trees together
+        void computeOverlappingPairsTreeVsTree(MemoryManager& memoryManager, const List<int32>& movedObjects,
+                                               List<Pair<int32, int32>>& overlappingPairs);
+
+        /// Add the pairs of objects where at least one object has moved
+        void addMovedPairs(const List<Pair<int32, int32>>& pairs, List<Pair<int32, int32>>& overlappingPairs) const;
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        DynamicAABBTreeBroadPhase(MemoryAllocator& allocator, decimal fatAABBInflatePercentage,
+                                  uint32 dynamicTreeOptimizationBudget = 0, TaskScheduler* taskScheduler = nullptr);
+
+        /// Destructor
+        virtual ~DynamicAABBTreeBroadPhase() override = default;
+
+        /// Deleted copy-constructor
+        DynamicAABBTreeBroadPhase(const DynamicAABBTreeBroadPhase& broadPhase) = delete;
+
+        /// Deleted assignment operator
+        DynamicAABBTreeBroadPhase& operator=(const DynamicAABBTreeBroadPhase& broadPhase) = delete;
+
+        /// Add an object with a given AABB and return its broad-phase ID
+        virtual int32 addObject(const AABB& aabb, void* data, bool isStatic) override;
+
+        /// Remove an object
+        virtual void removeObject(int32 broadPhaseId) override;
+
+        /// Update the AABB of an object. Return true if the fat AABB of the object has changed
+        virtual bool updateObject(int32 broadPhaseId, const AABB& newAABB, const Vector3& displacement,
+                                  decimal fatAABBInflatePercentage, bool forceReInsert) override;
+
+        /// Set whether an object is static or not
+        virtual void setObjectIsStatic(int32 broadPhaseId, bool isStatic) override;
+
+        /// Return the fat AABB of an object
+        virtual const AABB& getFatAABB(int32 broadPhaseId) const override;
+
+        /// Return the data pointer of an object
+        virtual void* getObjectData(int32 broadPhaseId) const override;
+
+        /// Add all the pairs of objects with overlapping fat AABBs where at least one object has moved
+        virtual void computeOverlappingPairs(MemoryManager& memoryManager, const List<int32>& movedObjects,
+                                             List<Pair<int32, int32>>& overlappingPairs) override;
+
+        /// Report all the objects with a fat AABB hit by a ray to a callback
+        virtual void raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const override;
+
+        /// Report all the objects with a fat AABB hit by some rays of a packet to a callback
+        virtual void raycast(RayPacket& packet, Stack<int32>& stack, DynamicAABBTreeRayPacketCallback& callback) const override;
+
+        /// Reorder the nodes of the trees in memory to make the queries more cache friendly
+        virtual void compact() override;
+
+        /// Report the objects with a fat AABB overlapping a given AABB as pairs of an ID and their broad-phase ID
+        void reportObjectsOverlappingWithAABB(const AABB& aabb, int32 id, bool skipStaticObjects, Stack<int32>& stack,
+                                              List<Pair<int32, int32>>& overlappingPairs) const;
+
+        /// Return the tree of the non-static objects
+        const DynamicAABBTree& getDynamicTree() const;
+
+        /// Return the tree of the static objects
+        const DynamicAABBTree& getStaticTree() const;
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+        /// Set the profiler
+        virtual void setProfiler(Profiler* profiler) override;
+
+#endif
+
+};
+
+// Return the tree of an object
+inline const DynamicAABBTree& DynamicAABBTreeBroadPhase::getTree(const TreeProxy& proxy) const {
+    return proxy.isStatic ? mStaticTree : mDynamicTree;
+}
+
+// Return the tree of the non-static objects
+inline const DynamicAABBTree& DynamicAABBTreeBroadPhase::getDynamicTree() const {
+    return mDynamicTree;
+}
+
+// Return the tree of the static objects
+inline const DynamicAABBTree& DynamicAABBTreeBroadPhase::getStaticTree() const {
+    return mStaticTree;
+}
+
+// Notify that the static tree has been modified
+/// The wide tree does not match the static tree anymore
+inline void DynamicAABBTreeBroadPhase::setStaticTreeModified() {
+    mStaticWideTree.reset();
+    mIsStaticTreeModified = true;
+    mIsStaticTreeCompacted = false;
+}
+
+// Return the fat AABB of an object
+inline const AABB& DynamicAABBTreeBroadPhase::getFatAABB(int32 broadPhaseId) const {
+    assert(broadPhaseId >= 0 && broadPhaseId < static_cast<int32>(mProxies.size()));
+    assert(mProxies[broadPhaseId].nodeId != -1);
+    return getTree(mProxies[broadPhaseId]).getFatAABB(mProxies[broadPhaseId].nodeId);
+}
+
+// Return the data pointer of an object
+inline void* DynamicAABBTreeBroadPhase::getObjectData(int32 broadPhaseId) const {
+    assert(broadPhaseId >= 0 && broadPhaseId < static_cast<int32>(mProxies.size()));
+    assert(mProxies[broadPhaseId].nodeId != -1);
+    return mProxies[broadPhaseId].data;
+}
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+// Set the profiler
+inline void DynamicAABBTreeBroadPhase::setProfiler(Profiler* profiler) {
+    mProfiler = profiler;
+    mDynamicTree.setProfiler(profiler);
+    mStaticTree.setProfiler(profiler);
+    mStaticWideTree.setProfiler(profiler);
+}
+
+#endif
+
+}
+
+#endif
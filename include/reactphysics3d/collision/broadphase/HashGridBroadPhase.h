@@ -0,0 +1,378 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+
+#ifndef REACTPHYSICS3D_HASH_GRID_BROAD_PHASE_H
+#define REACTPHYSICS3D_HASH_GRID_BROAD_PHASE_H
+
+// Libraries
+#include <reactphysics3d/collision/broadphase/BroadPhaseAlgorithm.h>
+#include <reactphysics3d/collision/broadphase/DynamicAABBTreeBroadPhase.h>
+#include <reactphysics3d/collision/shapes/AABB.h>
+#include <reactphysics3d/containers/Set.h>
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Declarations
+class MemoryAllocator;
+class TaskScheduler;
+
+// Class GridTreeRaycastCallback
+/**
+ * Raycast callback used to cast a ray against the objects of the hash grid broad-phase
+ * that are stored in its trees. It converts the IDs of the objects in the trees into the
+ * broad-phase IDs of the grid and keeps the smallest hit fraction so that the ray can be
+ * clipped before it is cast through the grid.
+ */
+class GridTreeRaycastCallback : public DynamicAABBTreeRaycastCallback {
+
+    public:
+
+        /// Broad-phase IDs of the objects of the grid indexed by their ID in the trees
+        const List<int32>& mTreeObjectsProxies;
+
+        /// Callback that receives the broad-phase IDs of the hit objects
+        DynamicAABBTreeRaycastCallback& mCallback;
+
+        /// Smallest hit fraction
+        decimal mMaxFraction;
+
+        /// True if the callback has asked to stop the ray casting
+        bool mIsStopped;
+
+        // Constructor
+        GridTreeRaycastCallback(const List<int32>& treeObjectsProxies, DynamicAABBTreeRaycastCallback& callback, decimal maxFraction)
+            : mTreeObjectsProxies(treeObjectsProxies), mCallback(callback), mMaxFraction(maxFraction), mIsStopped(false) {
+
+        }
+
+        // Destructor
+        virtual ~GridTreeRaycastCallback() override = default;
+
+        // Called when the fat AABB of an object of the trees is hit by a ray
+        virtual decimal raycastBroadPhaseShape(int32 treeObjectId, const Ray& ray) override;
+};
+
+// Class GridTreeRayPacketCallback
+/**
+ * Raycast callback used to cast a packet of rays against the objects of the hash grid
+ * broad-phase that are stored in its trees. It converts the IDs of the objects in the trees
+ * into the broad-phase IDs of the grid.
+ */
+class GridTreeRayPacketCallback : public DynamicAABBTreeRayPacketCallback {
+
+    public:
+
+        /// Broad-phase IDs of the objects of the grid indexed by their ID in the trees
+        const List<int32>& mTreeObjectsProxies;
+
+        /// Callback that receives the broad-phase IDs of the hit objects
+        DynamicAABBTreeRayPacketCallback& mCallback;
+
+        // Constructor
+        GridTreeRayPacketCallback(const List<int32>& treeObjectsProxies, DynamicAABBTreeRayPacketCallback& callback)
+            : mTreeObjectsProxies(treeObjectsProxies), mCallback(callback) {
+
+        }
+
+        // Destructor
+        virtual ~GridTreeRayPacketCallback() override = default;
+
+        // Called when the fat AABB of an object of the trees is hit by the rays of a packet in the bit mask
+        virtual void raycastBroadPhaseShape(int32 treeObjectId, RayPacket& packet, uint32 rayMask) override;
+};
+
+// Class HashGridBroadPhase
+/**
+ * Broad-phase algorithm that stores the fat AABBs of the non-static objects in a uniform
+ * grid of cubic cells. The grid is not bounded: the cells are stored in a hash table where
+ * each bucket is a linked list of the objects of the cells that have the same hash. An object
+ * is only stored in the cell that contains the minimum corner of its fat AABB. Because the
+ * objects of the grid are smaller than a cell, a query only has to visit the cells next to the
+ * queried AABB. The size of the cells is either given by the user or computed from the average
+ * size of the non-static objects. The static objects and the objects that are too large for
+ * the cells are stored in the dynamic AABB trees of an internal tree broad-phase. This algorithm
+ * is faster than the dynamic AABB tree for worlds with many small objects of similar sizes that
+ * move at each frame (particles, debris, ...) because an object that leaves its fat AABB only
+ * has to be moved from one linked list to another one.
+ */
+class HashGridBroadPhase : public BroadPhaseAlgorithm {
+
+    private:
+
+        // Structure GridProxy
+        /**
+         * An object of the broad-phase
+         */
+        struct GridProxy {
+
+            /// Fat AABB of the object (only used if the object is in the grid)
+            AABB fatAABB;
+
+            /// Data pointer of the object
+            void* data;
+
+            /// ID of the object in the tree broad-phase (-1 if the object is not in the trees)
+            int32 treeObjectId;
+
+            /// Coordinates of the cell that contains the minimum corner of the fat AABB (if the object is in the grid)
+            int32 cell[3];
+
+            /// Previous object in the linked list of the bucket (-1 if none)
+            int32 previous;
+
+            /// Next object in the linked list of the bucket (-1 if none)
+            int32 next;
+
+            /// True if the object is static
+            bool isStatic;
+
+            /// True if the object is in the grid
+            bool isInGrid;
+        };
+
+        // -------------------- Constants -------------------- //
+
+        /// Minimum number of buckets of the hash table of the cells
+        static const uint32 MIN_NB_BUCKETS = 64;
+
+        // -------------------- Attributes -------------------- //
+
+        /// Memory allocator
+        MemoryAllocator& mAllocator;
+
+        /// Broad-phase with the static objects and the objects that are too large for the cells
+        DynamicAABBTreeBroadPhase mTreeBroadPhase;
+
+        /// Broad-phase IDs of the objects of the grid indexed by their ID in the tree broad-phase
+        List<int32> mTreeObjectsProxies;
+
+        /// Array of proxies indexed by broad-phase ID
+        List<GridProxy> mProxies;
+
+        /// Broad-phase IDs of the free proxies
+        List<int32> mFreeProxies;
+
+        /// First object of the linked list of each bucket of the hash table (-1 if the bucket is empty)
+        List<int32> mBuckets;
+
+        /// Size of the cells (zero if the grid has not been built yet)
+        decimal mCellSize;
+
+        /// Inverse of the size of the cells
+        decimal mInverseCellSize;
+
+        /// True if the size of the cells is computed from the size of the objects
+        bool mIsCellSizeAutomatic;
+
+        /// Number of objects in the grid
+        uint32 mNbGridObjects;
+
+        /// Number of non-static objects (in the grid or in the trees)
+        uint32 mNbNonStaticObjects;
+
+        /// Sum of the sizes of the fat AABBs of the non-static objects
+        decimal mSumObjectsSizes;
+
+        /// AABB that contains the fat AABBs of all the objects of the grid (it only grows until the grid is rebuilt)
+        AABB mGridBounds;
+
+        /// Default percentage of the size of the AABBs used to inflate the fat AABBs of the non-static objects
+        decimal mFatAABBInflatePercentage;
+
+        /// Task scheduler used to split the work among several threads (null if single-threaded)
+        TaskScheduler* mTaskScheduler;
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+        /// Pointer to the profiler
+        Profiler* mProfiler;
+
+#endif
+
+        // -------------------- Methods -------------------- //
+
+        /// Return true if an object with a given fat AABB can be stored in the grid
+        bool isSmallEnoughForGrid(const AABB& fatAABB) const;
+
+        /// Compute the coordinates of the cell that contains a point
+        void computeCell(const Vector3& point, int32* outCell) const;
+
+        /// Return the index of the bucket of a cell
+        uint32 computeBucketIndex(int32 x, int32 y, int32 z) const;
+
+        /// Add an object into the linked list of the bucket of its cell
+        void addToGrid(int32 broadPhaseId);
+
+        /// Remove an object from the linked list of its bucket
+        void removeFromGrid(int32 broadPhaseId);
+
+        /// Move an object of the grid into the trees with its current fat AABB
+        void moveToTrees(int32 broadPhaseId);
+
+        /// Move an object of the trees into the grid with its current fat AABB
+        void moveToGrid(int32 broadPhaseId);
+
+        /// Register the ID of an object in the tree broad-phase
+        void setTreeObjectId(int32 broadPhaseId, int32 treeObjectId);
+
+        /// Build the grid again with a given cell size
+        void rebuildGrid(decimal cellSize);
+
+        /// Report the objects of the grid overlapping with an AABB
+        void reportGridObjectsOverlappingWithAABB(const AABB& aabb, int32 broadPhaseId,
+                                                  List<Pair<int32, int32>>& overlappingPairs) const;
+
+        /// Report the objects overlapping with a range of the moved objects
+        void reportOverlappingObjects(const List<int32>& movedObjects, uint32 startIndex, uint32 endIndex,
+                                      List<Pair<int32, int32>>& overlappingPairs) const;
+
+        /// Compute the overlapping pairs of the moved objects using several threads
+        void computeOverlappingPairsParallel(MemoryManager& memoryManager, const List<int32>& movedObjects,
+                                             List<Pair<int32, int32>>& overlappingPairs);
+
+        /// Add the pairs of a list that have not been reported yet to the overlapping pairs
+        static void addPairsOnce(const List<Pair<int32, int32>>& pairs, Set<uint64>& reportedPairs,
+                                 List<Pair<int32, int32>>& overlappingPairs);
+
+        /// Visit the objects of the grid in the cells crossed by a ray
+        template<typename Visitor>
+        void visitGridObjectsAlongRay(const Vector3& point1, const Vector3& point2, const decimal& maxFraction,
+                                      Visitor& visitor) const;
+
+        /// Visit the objects of the grid that overlap with a cell crossed by a ray
+        template<typename Visitor>
+        bool visitGridObjectsInCell(const int32* cell, int previousAxis, const int32* step, Visitor& visitor) const;
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        HashGridBroadPhase(MemoryAllocator& allocator, decimal fatAABBInflatePercentage, decimal cellSize = decimal(0.0),
+                           uint32 dynamicTreeOptimizationBudget = 0, TaskScheduler* taskScheduler = nullptr);
+
+        /// Destructor
+        virtual ~HashGridBroadPhase() override = default;
+
+        /// Deleted copy-constructor
+        HashGridBroadPhase(const HashGridBroadPhase& broadPhase) = delete;
+
+        /// Deleted assignment operator
+        HashGridBroadPhase& operator=(const HashGridBroadPhase& broadPhase) = delete;
+
+        /// Add an object with a given AABB and return its broad-phase ID
+        virtual int32 addObject(const AABB& aabb, void* data, bool isStatic) override;
+
+        /// Remove an object
+        virtual void removeObject(int32 broadPhaseId) override;
+
+        /// Update the AABB of an object. Return true if the fat AABB of the object has changed
+        virtual bool updateObject(int32 broadPhaseId, const AABB& newAABB, const Vector3& displacement,
+                                  decimal fatAABBInflatePercentage, bool forceReInsert) override;
+
+        /// Set whether an object is static or not
+        virtual void setObjectIsStatic(int32 broadPhaseId, bool isStatic) override;
+
+        /// Return the fat AABB of an object
+        virtual const AABB& getFatAABB(int32 broadPhaseId) const override;
+
+        /// Return the data pointer of an object
+        virtual void* getObjectData(int32 broadPhaseId) const override;
+
+        /// Add all the pairs of objects with overlapping fat AABBs where at least one object has moved
+        virtual void computeOverlappingPairs(MemoryManager& memoryManager, const List<int32>& movedObjects,
+                                             List<Pair<int32, int32>>& overlappingPairs) override;
+
+        /// Report all the objects with a fat AABB hit by a ray to a callback
+        virtual void raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const override;
+
+        /// Report all the objects with a fat AABB hit by some rays of a packet to a callback
+        virtual void raycast(RayPacket& packet, Stack<int32>& stack, DynamicAABBTreeRayPacketCallback& callback) const override;
+
+        /// Reorder the internal data of the structure in memory to make the queries more cache friendly
+        virtual void compact() override;
+
+        /// Return the size of the cells of the grid (zero if the grid has not been built yet)
+        decimal getCellSize() const;
+
+        /// Return the number of objects stored in the grid (the other ones are in the trees)
+        uint32 getNbGridObjects() const;
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+        /// Set the profiler
+        virtual void setProfiler(Profiler* profiler) override;
+
+#endif
+
+};
+
+// Return true if an object with a given fat AABB can be stored in the grid
+/// The fat AABB must be a bit smaller than a cell so that it never overlaps more than two
+/// cells along an axis despite the rounding errors
+inline bool HashGridBroadPhase::isSmallEnoughForGrid(const AABB& fatAABB) const {
+    return mCellSize > decimal(0.0) && fatAABB.getExtent().getMaxValue() < decimal(0.99) * mCellSize;
+}
+
+// Return the fat AABB of an object
+inline const AABB& HashGridBroadPhase::getFatAABB(int32 broadPhaseId) const {
+    assert(broadPhaseId >= 0 && broadPhaseId < static_cast<int32>(mProxies.size()));
+    assert(mProxies[broadPhaseId].isInGrid || mProxies[broadPhaseId].treeObjectId != -1);
+    const GridProxy& proxy = mProxies[broadPhaseId];
+    return proxy.isInGrid ? proxy.fatAABB : mTreeBroadPhase.getFatAABB(proxy.treeObjectId);
+}
+
+// Return the data pointer of an object
+inline void* HashGridBroadPhase::getObjectData(int32 broadPhaseId) const {
+    assert(broadPhaseId >= 0 && broadPhaseId < static_cast<int32>(mProxies.size()));
+    assert(mProxies[broadPhaseId].isInGrid || mProxies[broadPhaseId].treeObjectId != -1);
+    return mProxies[broadPhaseId].data;
+}
+
+// Return the size of the cells of the grid (zero if the grid has not been built yet)
+inline decimal HashGridBroadPhase::getCellSize() const {
+    return mCellSize;
+}
+
+// Return the number of objects stored in the grid (the other ones are in the trees)
+inline uint32 HashGridBroadPhase::getNbGridObjects() const {
+    return mNbGridObjects;
+}
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+// Set the profiler
+inline void HashGridBroadPhase::setProfiler(Profiler* profiler) {
+    mProfiler = profiler;
+    mTreeBroadPhase.setProfiler(profiler);
+}
+
+#endif
+
+}
+
+#endif
@@ -0,0 +1,262 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_QUANTIZED_AABB_TREE_H
+#define REACTPHYSICS3D_QUANTIZED_AABB_TREE_H
+
+// Libraries
+#include <reactphysics3d/configuration.h>
+#include <reactphysics3d/collision/broadphase/DynamicAABBTree.h>
+#include <reactphysics3d/collision/broadphase/WideAABBTree.h>
+#include <reactphysics3d/containers/List.h>
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Declarations
+class MemoryAllocator;
+class Profiler;
+struct Ray;
+struct RayPacket;
+
+// Structure QuantizedTreeNode
+/**
+ * This structure represents a node of a quantized AABB tree. A node has up to four
+ * children. The AABBs of the children are stored with 16-bits integer coordinates
+ * relative to the AABB of the node itself. The internal children of a node are stored
+ * next to each other in the array of nodes and the leaf children are stored next to each
+ * other in the array of leaves so that only the index of the first ones is stored.
+ */
+struct QuantizedTreeNode {
+
+    // -------------------- Constants -------------------- //
+
+    /// Maximum number of children of a node
+    static const uint32 NB_CHILDREN = 4;
+
+    /// Largest quantized coordinate (the maximum coordinate of the AABB of the node)
+    static const uint16 MAX_QUANTIZED_VALUE = 65535;
+
+    // -------------------- Attributes -------------------- //
+
+    /// Quantized minimum x coordinates of the AABBs of the children
+    uint16 minX[NB_CHILDREN];
+
+    /// Quantized minimum y coordinates of the AABBs of the children
+    uint16 minY[NB_CHILDREN];
+
+    /// Quantized minimum z coordinates of the AABBs of the children
+    uint16 minZ[NB_CHILDREN];
+
+    /// Quantized maximum x coordinates of the AABBs of the children
+    uint16 maxX[NB_CHILDREN];
+
+    /// Quantized maximum y coordinates of the AABBs of the children
+    uint16 maxY[NB_CHILDREN];
+
+    /// Quantized maximum z coordinates of the AABBs of the children
+    uint16 maxZ[NB_CHILDREN];
+
+    /// Index of the node of the first internal child
+    int32 firstInternalChild;
+
+    /// Index of the first leaf child
+    int32 firstLeafChild;
+
+    /// Number of children of the node
+    uint8 nbChildren;
+
+    /// Bit mask of the children that are leaves
+    uint8 leafMask;
+};
+
+// Class QuantizedAABBTree
+/**
+ * This class represents a static and compressed AABB tree where each node has up to four
+ * children. It is built by collapsing the nodes of a DynamicAABBTree that never changes
+ * anymore (the triangles of a concave mesh for instance). The AABBs of the children of a
+ * node are quantized with 16-bits integers relative to the AABB of the node and the two
+ * data integers of the leaves are copied into the tree so that the dynamic tree can be
+ * destroyed after the build. A node with four children is about the size of a single
+ * node of the dynamic tree. The quantized AABBs are always a bit larger than the original ones. The
+ * leaves are reported with their index in the tree.
+ */
+class QuantizedAABBTree {
+
+    private:
+
+        // -------------------- Structures -------------------- //
+
+        /// Node to visit during a query with its AABB decoded from its parent
+        struct NodeToVisit {
+
+            /// Index of the node
+            int32 nodeIndex;
+
+            /// AABB of the node
+            AABB aabb;
+
+            /// Constructor
+            NodeToVisit(int32 index, const AABB& nodeAABB) : nodeIndex(index), aabb(nodeAABB) {
+
+            }
+        };
+
+        // -------------------- Attributes -------------------- //
+
+        /// Memory allocator
+        MemoryAllocator& mAllocator;
+
+        /// Nodes of the tree (the root node is the first one)
+        List<QuantizedTreeNode> mNodes;
+
+        /// Two data integers for each leaf of the tree
+        List<int32> mLeavesData;
+
+        /// AABB of the root node
+        AABB mRootAABB;
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+		/// Pointer to the profiler
+		Profiler* mProfiler;
+
+#endif
+
+        // -------------------- Methods -------------------- //
+
+        /// Return the size of a quantization step along each axis of the AABB of a node
+        static Vector3 computeQuantizationStep(const AABB& nodeAABB);
+
+        /// Return the coordinate of a quantized value along an axis of the AABB of a node
+        static decimal dequantize(uint16 value, decimal nodeMin, decimal nodeMax, decimal step);
+
+        /// Return the largest quantized value whose coordinate is smaller or equal to a minimum coordinate
+        static uint16 quantizeMin(decimal coordinate, decimal nodeMin, decimal nodeMax, decimal step);
+
+        /// Return the smallest quantized value whose coordinate is larger or equal to a maximum coordinate
+        static uint16 quantizeMax(decimal coordinate, decimal nodeMin, decimal nodeMax, decimal step);
+
+        /// Decode the AABBs of the children of a node into a wide tree node
+        void decodeNode(const QuantizedTreeNode& node, const AABB& nodeAABB, WideTreeNode& outNode) const;
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        QuantizedAABBTree(MemoryAllocator& allocator);
+
+        /// Destructor
+        ~QuantizedAABBTree() = default;
+
+        /// Deleted copy-constructor
+        QuantizedAABBTree(const QuantizedAABBTree& tree) = delete;
+
+        /// Deleted assignment operator
+        QuantizedAABBTree& operator=(const QuantizedAABBTree& tree) = delete;
+
+        /// Build the tree by collapsing and quantizing the nodes of a dynamic AABB tree
+        void build(const DynamicAABBTree& tree);
+
+        /// Return true if the tree does not have any node
+        bool isEmpty() const;
+
+        /// Return the number of nodes of the tree
+        uint32 getNbNodes() const;
+
+        /// Return the number of leaves of the tree
+        uint32 getNbLeaves() const;
+
+        /// Return the number of bytes used by the nodes and the leaves of the tree
+        size_t getSizeInBytes() const;
+
+        /// Return the two data integers of a leaf
+        const int32* getLeafDataInt(int32 leafIndex) const;
+
+        /// Return the AABB of the root node of the tree
+        const AABB& getRootAABB() const;
+
+        /// Report the indices of all the leaves overlapping with an AABB
+        void reportAllShapesOverlappingWithAABB(const AABB& aabb, List<int32>& overlappingLeaves) const;
+
+        /// Ray casting method
+        void raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const;
+
+        /// Ray casting method for a packet of rays
+        void raycast(RayPacket& packet, MemoryAllocator& allocator, DynamicAABBTreeRayPacketCallback& callback) const;
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+		/// Set the profiler
+		void setProfiler(Profiler* profiler);
+
+#endif
+
+};
+
+// Return true if the tree does not have any node
+inline bool QuantizedAABBTree::isEmpty() const {
+    return mNodes.size() == 0;
+}
+
+// Return the number of nodes of the tree
+inline uint32 QuantizedAABBTree::getNbNodes() const {
+    return static_cast<uint32>(mNodes.size());
+}
+
+// Return the number of leaves of the tree
+inline uint32 QuantizedAABBTree::getNbLeaves() const {
+    return static_cast<uint32>(mLeavesData.size() / 2);
+}
+
+// Return the number of bytes used by the nodes and the leaves of the tree
+inline size_t QuantizedAABBTree::getSizeInBytes() const {
+    return mNodes.size() * sizeof(QuantizedTreeNode) + mLeavesData.size() * sizeof(int32);
+}
+
+// Return the two data integers of a leaf
+inline const int32* QuantizedAABBTree::getLeafDataInt(int32 leafIndex) const {
+    assert(leafIndex >= 0 && leafIndex < static_cast<int32>(getNbLeaves()));
+    return &(mLeavesData[2 * leafIndex]);
+}
+
+// Return the AABB of the root node of the tree
+inline const AABB& QuantizedAABBTree::getRootAABB() const {
+    return mRootAABB;
+}
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+// Set the profiler
+inline void QuantizedAABBTree::setProfiler(Profiler* profiler) {
+    mProfiler = profiler;
+}
+
+#endif
+
+}
+
+#endif
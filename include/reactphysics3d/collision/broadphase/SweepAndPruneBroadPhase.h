@@ -0,0 +1,234 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_SWEEP_AND_PRUNE_BROAD_PHASE_H
+#define REACTPHYSICS3D_SWEEP_AND_PRUNE_BROAD_PHASE_H
+
+// Libraries
+#include <reactphysics3d/collision/broadphase/BroadPhaseAlgorithm.h>
+#include <reactphysics3d/collision/shapes/AABB.h>
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Declarations
+class MemoryAllocator;
+class TaskScheduler;
+
+// Class SweepAndPruneBroadPhase
+/**
+ * Broad-phase algorithm that keeps the fat AABBs of the objects sorted by their minimum
+ * coordinate along a sweep axis. At each frame, the array is sorted again with an insertion
+ * sort which is almost linear because the objects only move a little between two frames.
+ * The overlapping pairs are then found with a single sweep over the sorted array. The sweep
+ * axis is the one with the largest variance of the AABB centers. This algorithm is faster
+ * than the dynamic AABB tree for dense worlds where most of the objects move at each frame.
+ * Note that a ray cast has to test all the objects with a fat AABB that overlaps the ray
+ * along the sweep axis.
+ */
+class SweepAndPruneBroadPhase : public BroadPhaseAlgorithm {
+
+    private:
+
+        // Structure SortedProxy
+        /**
+         * An object in the array sorted along the sweep axis
+         */
+        struct SortedProxy {
+
+            /// Fat AABB of the object
+            AABB fatAABB;
+
+            /// Broad-phase ID of the object (-1 if the object has been removed)
+            int32 broadPhaseId;
+
+            /// True if the object is static
+            bool isStatic;
+
+            /// True if the object has moved since the last computation of the overlapping pairs
+            bool hasMoved;
+        };
+
+        // Structure Proxy
+        /**
+         * An object of the broad-phase
+         */
+        struct Proxy {
+
+            /// Data pointer of the object
+            void* data;
+
+            /// Index of the object in the sorted array (-1 if the proxy is free)
+            int32 sortedIndex;
+        };
+
+        // -------------------- Constants -------------------- //
+
+        /// Minimum number of added objects (and percentage of the total number of objects)
+        /// from which the sorted array is sorted from scratch instead of with an insertion sort
+        static const uint32 MIN_NB_ADDED_OBJECTS_FULL_SORT = 64;
+
+        // -------------------- Attributes -------------------- //
+
+        /// Memory allocator
+        MemoryAllocator& mAllocator;
+
+        /// Percentage of the AABB size used to inflate the fat AABBs
+        decimal mFatAABBInflatePercentage;
+
+        /// Task scheduler used to split the work among several threads (null if single-threaded)
+        TaskScheduler* mTaskScheduler;
+
+        /// Array of proxies indexed by broad-phase ID
+        List<Proxy> mProxies;
+
+        /// Broad-phase IDs of the free proxies
+        List<int32> mFreeProxies;
+
+        /// Array of objects sorted by the minimum coordinate of their fat AABB along the sweep axis
+        List<SortedProxy> mSortedProxies;
+
+        /// Number of removed objects that are still in the sorted array
+        uint32 mNbRemovedProxies;
+
+        /// Number of objects added at the end of the sorted array since the last sort
+        uint32 mNbAddedProxies;
+
+        /// Index of the sweep axis (0 for x, 1 for y and 2 for z)
+        int mSweepAxis;
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+        /// Pointer to the profiler
+        Profiler* mProfiler;
+
+#endif
+
+        // -------------------- Methods -------------------- //
+
+        /// Compute the fat AABB of an object
+        AABB computeFatAABB(const AABB& aabb, bool isStatic) const;
+
+        /// Select the sweep axis with the largest variance of the AABB centers
+        int computeSweepAxis() const;
+
+        /// Remove the removed objects from the sorted array and sort it
+        void sortProxies();
+
+        /// Find the overlapping pairs of the objects in a range of the sorted array
+        void sweepProxies(uint32 startIndex, uint32 endIndex, List<Pair<int32, int32>>& overlappingPairs) const;
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        SweepAndPruneBroadPhase(MemoryAllocator& allocator, decimal fatAABBInflatePercentage,
+                                TaskScheduler* taskScheduler = nullptr);
+
+        /// Destructor
+        virtual ~SweepAndPruneBroadPhase() override = default;
+
+        /// Deleted copy-constructor
+        SweepAndPruneBroadPhase(const SweepAndPruneBroadPhase& broadPhase) = delete;
+
+        /// Deleted assignment operator
+        SweepAndPruneBroadPhase& operator=(const SweepAndPruneBroadPhase& broadPhase) = delete;
+
+        /// Add an object with a given AABB and return its broad-phase ID
+        virtual int32 addObject(const AABB& aabb, void* data, bool isStatic) override;
+
+        /// Remove an object
+        virtual void removeObject(int32 broadPhaseId) override;
+
+        /// Update the AABB of an object. Return true if the fat AABB of the object has changed
+        virtual bool updateObject(int32 broadPhaseId, const AABB& newAABB, const Vector3& displacement,
+                                  decimal fatAABBInflatePercentage, bool forceReInsert) override;
+
+        /// Set whether an object is static or not
+        virtual void setObjectIsStatic(int32 broadPhaseId, bool isStatic) override;
+
+        /// Return the fat AABB of an object
+        virtual const AABB& getFatAABB(int32 broadPhaseId) const override;
+
+        /// Return the data pointer of an object
+        virtual void* getObjectData(int32 broadPhaseId) const override;
+
+        /// Add all the pairs of objects with overlapping fat AABBs where at least one object has moved
+        virtual void computeOverlappingPairs(MemoryManager& memoryManager, const List<int32>& movedObjects,
+                                             List<Pair<int32, int32>>& overlappingPairs) override;
+
+        /// Report all the objects with a fat AABB hit by a ray to a callback
+        virtual void raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const override;
+
+        /// Report all the objects with a fat AABB hit by some rays of a packet to a callback
+        virtual void raycast(RayPacket& packet, Stack<int32>& stack, DynamicAABBTreeRayPacketCallback& callback) const override;
+
+        /// Reorder the internal data of the structure in memory to make the queries more cache friendly
+        virtual void compact() override;
+
+        /// Return the number of objects
+        uint32 getNbObjects() const;
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+        /// Set the profiler
+        virtual void setProfiler(Profiler* profiler) override;
+
+#endif
+
+};
+
+// Return the fat AABB of an object
+inline const AABB& SweepAndPruneBroadPhase::getFatAABB(int32 broadPhaseId) const {
+    assert(broadPhaseId >= 0 && broadPhaseId < static_cast<int32>(mProxies.size()));
+    assert(mProxies[broadPhaseId].sortedIndex != -1);
+    return mSortedProxies[mProxies[broadPhaseId].sortedIndex].fatAABB;
+}
+
+// Return the data pointer of an object
+inline void* SweepAndPruneBroadPhase::getObjectData(int32 broadPhaseId) const {
+    assert(broadPhaseId >= 0 && broadPhaseId < static_cast<int32>(mProxies.size()));
+    assert(mProxies[broadPhaseId].sortedIndex != -1);
+    return mProxies[broadPhaseId].data;
+}
+
+// Return the number of objects
+inline uint32 SweepAndPruneBroadPhase::getNbObjects() const {
+    return mSortedProxies.size() - mNbRemovedProxies;
+}
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+// Set the profiler
+inline void SweepAndPruneBroadPhase::setProfiler(Profiler* profiler) {
+    mProfiler = profiler;
+}
+
+#endif
+
+}
+
+#endif
@@ -0,0 +1,211 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_WIDE_AABB_TREE_H
+#define REACTPHYSICS3D_WIDE_AABB_TREE_H
+
+// Libraries
+#include <reactphysics3d/configuration.h>
+#include <reactphysics3d/collision/broadphase/DynamicAABBTree.h>
+#include <reactphysics3d/containers/List.h>
+#include <reactphysics3d/containers/Stack.h>
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Declarations
+class MemoryAllocator;
+class Profiler;
+struct Ray;
+struct RayPacket;
+
+// Structure WideTreeNode
+/**
+ * This structure represents a node of a wide AABB tree. A node has up to four
+ * children. The AABBs of the children are stored as a structure of arrays so that
+ * the four AABBs can be tested against a query with a single sequence of SIMD instructions.
+ */
+struct WideTreeNode {
+
+    // -------------------- Constants -------------------- //
+
+    /// Maximum number of children of a node
+    static const uint32 NB_CHILDREN = 4;
+
+    // -------------------- Attributes -------------------- //
+
+    /// Minimum x coordinates of the AABBs of the children
+    decimal minX[NB_CHILDREN];
+
+    /// Minimum y coordinates of the AABBs of the children
+    decimal minY[NB_CHILDREN];
+
+    /// Minimum z coordinates of the AABBs of the children
+    decimal minZ[NB_CHILDREN];
+
+    /// Maximum x coordinates of the AABBs of the children
+    decimal maxX[NB_CHILDREN];
+
+    /// Maximum y coordinates of the AABBs of the children
+    decimal maxY[NB_CHILDREN];
+
+    /// Maximum z coordinates of the AABBs of the children
+    decimal maxZ[NB_CHILDREN];
+
+    /// Index of the wide node of an internal child or ID of the node in the
+    /// dynamic AABB tree of a leaf child
+    int32 children[NB_CHILDREN];
+
+    /// First data integer of the leaf children
+    int32 dataInt[NB_CHILDREN];
+
+    /// Number of children of the node
+    uint8 nbChildren;
+
+    /// Bit mask of the children that are leaves
+    uint8 leafMask;
+
+    // -------------------- Methods -------------------- //
+
+    /// Return the AABB of a child
+    AABB getChildAABB(uint32 childIndex) const;
+
+    /// Return the bit mask of the children that overlap with an AABB
+    uint32 testChildrenCollision(const AABB& aabb) const;
+
+    /// Return the bit mask of the children that are hit by a ray segment
+    uint32 testChildrenRayIntersect(const Vector3& origin, const Vector3& inverseDirection,
+                                    decimal maxFraction, decimal* outHitFractions) const;
+};
+
+// Class WideAABBTree
+/**
+ * This class represents a static AABB tree where each node has up to four children.
+ * It is built by collapsing the nodes of a DynamicAABBTree once the dynamic tree does
+ * not change anymore (the triangles of a concave mesh or the static colliders of the
+ * broad-phase for instance). The AABBs of the four children of a node are tested
+ * against a query at the same time which divides the number of visited nodes by about two
+ * compared to the binary tree. The leaves of the wide tree are reported with the IDs
+ * of their nodes in the dynamic AABB tree so that their data can be read from the
+ * dynamic tree. The wide tree must be built again when the dynamic tree is modified.
+ */
+class WideAABBTree {
+
+    private:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Memory allocator
+        MemoryAllocator& mAllocator;
+
+        /// Nodes of the tree (the root node is the first one)
+        List<WideTreeNode> mNodes;
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+		/// Pointer to the profiler
+		Profiler* mProfiler;
+
+#endif
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        WideAABBTree(MemoryAllocator& allocator);
+
+        /// Destructor
+        ~WideAABBTree() = default;
+
+        /// Deleted copy-constructor
+        WideAABBTree(const WideAABBTree& tree) = delete;
+
+        /// Deleted assignment operator
+        WideAABBTree& operator=(const WideAABBTree& tree) = delete;
+
+        /// Build the tree by collapsing the nodes of a dynamic AABB tree
+        void build(const DynamicAABBTree& tree);
+
+        /// Remove all the nodes of the tree
+        void reset();
+
+        /// Return true if the tree does not have any node
+        bool isEmpty() const;
+
+        /// Return the number of nodes of the tree
+        uint32 getNbNodes() const;
+
+        /// Report the dynamic tree node IDs of all the leaves overlapping with an AABB
+        void reportAllShapesOverlappingWithAABB(const AABB& aabb, List<int32>& overlappingNodes) const;
+
+        /// Report all the leaves overlapping with an AABB as pairs of an object ID and the first data integer of the leaf
+        void reportAllShapesOverlappingWithAABB(const AABB& aabb, int32 objectId, Stack<int32>& stack,
+                                                List<Pair<int32, int32>>& outOverlappingPairs) const;
+
+        /// Ray casting method
+        void raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const;
+
+        /// Ray casting method for a packet of rays
+        void raycast(RayPacket& packet, Stack<int32>& stack, DynamicAABBTreeRayPacketCallback& callback) const;
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+		/// Set the profiler
+		void setProfiler(Profiler* profiler);
+
+#endif
+
+};
+
+// Return the AABB of a child
+inline AABB WideTreeNode::getChildAABB(uint32 childIndex) const {
+    assert(childIndex < nbChildren);
+    return AABB(Vector3(minX[childIndex], minY[childIndex], minZ[childIndex]),
+                Vector3(maxX[childIndex], maxY[childIndex], maxZ[childIndex]));
+}
+
+// Return true if the tree does not have any node
+inline bool WideAABBTree::isEmpty() const {
+    return mNodes.size() == 0;
+}
+
+// Return the number of nodes of the tree
+inline uint32 WideAABBTree::getNbNodes() const {
+    return static_cast<uint32>(mNodes.size());
+}
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+// Set the profiler
+inline void WideAABBTree::setProfiler(Profiler* profiler) {
+    mProfiler = profiler;
+}
+
+#endif
+
+}
+
+#endif
@@ -0,0 +1,100 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_BOX_VS_BOX_ALGORITHM_H
+#define	REACTPHYSICS3D_BOX_VS_BOX_ALGORITHM_H
+
+// Libraries
+#include <reactphysics3d/collision/narrowphase/NarrowPhaseAlgorithm.h>
+#include <reactphysics3d/mathematics/mathematics.h>
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Declarations
+struct NarrowPhaseInfoBatch;
+
+// Class BoxVsBoxAlgorithm
+/**
+ * This class is used to compute the narrow-phase collision detection
+ * between two box collision shapes. This is a specialized version of the
+ * SAT algorithm. The 15 potential separating axes (three face normals of
+ * each box and the nine cross products of their edges) are tested with
+ * closed-form expressions using the relative orientation of the two boxes.
+ * The contact points of a face contact are computed by clipping the incident
+ * face with the side planes of the reference face using fixed-size arrays.
+ */
+class BoxVsBoxAlgorithm : public NarrowPhaseAlgorithm {
+
+    protected :
+
+        // -------------------- Constants -------------------- //
+
+        /// Maximum number of vertices of the incident face clipped by the four side planes of the reference face
+        static const uint MAX_NB_CLIPPED_VERTICES = 8;
+
+        /// Relative tolerance used to favor the face axes of the first box and the face axes over the edge axes
+        static const decimal SEPARATING_AXIS_RELATIVE_TOLERANCE;
+
+        /// Absolute tolerance used to favor the face axes of the first box and the face axes over the edge axes
+        static const decimal SEPARATING_AXIS_ABSOLUTE_TOLERANCE;
+
+        /// Square length of the cross product of two edges under which the edges are considered parallel
+        static const decimal PARALLEL_EDGES_EPSILON;
+
+        // -------------------- Methods -------------------- //
+
+        /// Compute the contact points between a face of the reference box and the incident box
+        static bool computeFaceContactPoints(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchIndex, bool isReferenceBox1,
+                                             const Vector3& referenceHalfExtents, const Vector3& incidentHalfExtents,
+                                             const Transform& incidentToReference, int referenceAxis, decimal referenceAxisSign);
+
+        /// Clip a polygon with a plane orthogonal to an axis of the reference box
+        static uint clipPolygonWithPlane(const Vector3* vertices, uint nbVertices, int axis, decimal axisSign,
+                                         decimal halfExtent, Vector3* outClippedVertices);
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        BoxVsBoxAlgorithm() = default;
+
+        /// Destructor
+        virtual ~BoxVsBoxAlgorithm() override = default;
+
+        /// Deleted copy-constructor
+        BoxVsBoxAlgorithm(const BoxVsBoxAlgorithm& algorithm) = delete;
+
+        /// Deleted assignment operator
+        BoxVsBoxAlgorithm& operator=(const BoxVsBoxAlgorithm& algorithm) = delete;
+
+        /// Compute the narrow-phase collision detection between two boxes
+        bool testCollision(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchStartIndex, uint batchNbItems);
+};
+
+}
+
+#endif
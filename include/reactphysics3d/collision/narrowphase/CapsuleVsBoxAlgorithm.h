@@ -0,0 +1,105 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_CAPSULE_VS_BOX_ALGORITHM_H
+#define	REACTPHYSICS3D_CAPSULE_VS_BOX_ALGORITHM_H
+
+// Libraries
+#include <reactphysics3d/collision/narrowphase/NarrowPhaseAlgorithm.h>
+#include <reactphysics3d/mathematics/mathematics.h>
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Declarations
+struct NarrowPhaseInfoBatch;
+
+// Class CapsuleVsBoxAlgorithm
+/**
+ * This class is used to compute the narrow-phase collision detection
+ * between a capsule and a box. The capsule is a segment with a margin
+ * around it. The exact closest points between the inner segment of the
+ * capsule and the box are computed in the local-space of the box. If
+ * the segment does not intersect the box, the contact normal goes from
+ * the closest point of the box toward the closest point of the segment.
+ * Otherwise, the three face normals of the box and the cross products of
+ * the segment with the three edge directions of the box are tested as in
+ * the SAT algorithm. Two contact points are created when the segment lies
+ * along a face of the box.
+ */
+class CapsuleVsBoxAlgorithm : public NarrowPhaseAlgorithm {
+
+    protected :
+
+        // -------------------- Constants -------------------- //
+
+        /// Maximum number of values of the segment parameter where the distance to the box changes of expression
+        /// (the two end-points of the segment and the six side planes of the box)
+        static const uint MAX_NB_SEGMENT_BREAKPOINTS = 8;
+
+        /// Relative tolerance used to favor the face axes of the box over the edge axes
+        static const decimal SEPARATING_AXIS_RELATIVE_TOLERANCE;
+
+        /// Absolute tolerance used to favor the face axes of the box over the edge axes
+        static const decimal SEPARATING_AXIS_ABSOLUTE_TOLERANCE;
+
+        /// Square length of the cross product of the segment with an edge under which they are considered parallel
+        static const decimal PARALLEL_EDGES_EPSILON;
+
+        // -------------------- Methods -------------------- //
+
+        /// Compute the squared distance between a segment and a box and the parameter of the closest point of the segment
+        static decimal computeSegmentBoxDistanceSquare(const Vector3& segmentPointA, const Vector3& segmentPointB,
+                                                       const Vector3& halfExtents, decimal& outSegmentParameter);
+
+        /// Compute the contact points between the segment and a face of the box
+        static bool computeFaceContactPoints(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchIndex, bool isCapsuleShape1,
+                                             const Vector3& segmentPointA, const Vector3& segmentPointB, const Vector3& halfExtents,
+                                             decimal radius, int faceAxis, decimal faceAxisSign,
+                                             const Transform& boxToCapsuleTransform, const Quaternion& boxToWorldOrientation);
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        CapsuleVsBoxAlgorithm() = default;
+
+        /// Destructor
+        virtual ~CapsuleVsBoxAlgorithm() override = default;
+
+        /// Deleted copy-constructor
+        CapsuleVsBoxAlgorithm(const CapsuleVsBoxAlgorithm& algorithm) = delete;
+
+        /// Deleted assignment operator
+        CapsuleVsBoxAlgorithm& operator=(const CapsuleVsBoxAlgorithm& algorithm) = delete;
+
+        /// Compute the narrow-phase collision detection between a capsule and a box
+        bool testCollision(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchStartIndex, uint batchNbItems);
+};
+
+}
+
+#endif
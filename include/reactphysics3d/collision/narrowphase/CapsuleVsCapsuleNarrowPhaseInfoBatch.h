@@ -63,7 +63,7 @@ struct CapsuleVsCapsuleNarrowPhaseInfoBatch : public NarrowPhaseInfoBatch {
         /// Add shapes to be tested during narrow-phase collision detection into the batch
         virtual void addNarrowPhaseInfo(uint64 pairId, uint64 pairIndex, Entity collider1, Entity collider2, CollisionShape* shape1,
                                         CollisionShape* shape2, const Transform& shape1Transform,
-                                        const Transform& shape2Transform, bool needToReportContacts, MemoryAllocator& shapeAllocator) override;
+                                        const Transform& shape2Transform, bool needToReportContacts) override;
 
         // Initialize the containers using cached capacity
         virtual void reserveMemory() override;
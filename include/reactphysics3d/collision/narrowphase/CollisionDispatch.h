@@ -33,6 +33,9 @@
 #include <reactphysics3d/collision/narrowphase/CapsuleVsCapsuleAlgorithm.h>
 #include <reactphysics3d/collision/narrowphase/CapsuleVsConvexPolyhedronAlgorithm.h>
 #include <reactphysics3d/collision/narrowphase/ConvexPolyhedronVsConvexPolyhedronAlgorithm.h>
+#include <reactphysics3d/collision/narrowphase/BoxVsBoxAlgorithm.h>
+#include <reactphysics3d/collision/narrowphase/SphereVsBoxAlgorithm.h>
+#include <reactphysics3d/collision/narrowphase/CapsuleVsBoxAlgorithm.h>
 #include <reactphysics3d/collision/shapes/CollisionShape.h>
 
 namespace reactphysics3d {
@@ -46,7 +49,10 @@ enum class NarrowPhaseAlgorithmType {
     CapsuleVsCapsule,
     SphereVsConvexPolyhedron,
     CapsuleVsConvexPolyhedron,
-    ConvexPolyhedronVsConvexPolyhedron
+    ConvexPolyhedronVsConvexPolyhedron,
+    BoxVsBox,
+    SphereVsBox,
+    CapsuleVsBox
 };
 
 // Class CollisionDispatch
@@ -80,6 +86,15 @@ class CollisionDispatch {
         /// True if the convex polyhedron vs convex polyhedron algorithm is the default one
         bool mIsConvexPolyhedronVsConvexPolyhedronDefault = true;
 
+        /// True if the box vs box algorithm is the default one
+        bool mIsBoxVsBoxDefault = true;
+
+        /// True if the sphere vs box algorithm is the default one
+        bool mIsSphereVsBoxDefault = true;
+
+        /// True if the capsule vs box algorithm is the default one
+        bool mIsCapsuleVsBoxDefault = true;
+
         /// Sphere vs Sphere collision algorithm
         SphereVsSphereAlgorithm* mSphereVsSphereAlgorithm;
 
@@ -98,6 +113,15 @@ class CollisionDispatch {
         /// Convex Polyhedron vs Convex Polyhedron collision algorithm
         ConvexPolyhedronVsConvexPolyhedronAlgorithm* mConvexPolyhedronVsConvexPolyhedronAlgorithm;
 
+        /// Box vs Box collision algorithm
+        BoxVsBoxAlgorithm* mBoxVsBoxAlgorithm;
+
+        /// Sphere vs Box collision algorithm
+        SphereVsBoxAlgorithm* mSphereVsBoxAlgorithm;
+
+        /// Capsule vs Box collision algorithm
+        CapsuleVsBoxAlgorithm* mCapsuleVsBoxAlgorithm;
+
         /// Collision detection matrix (algorithms to use)
         NarrowPhaseAlgorithmType mCollisionMatrix[NB_COLLISION_SHAPE_TYPES][NB_COLLISION_SHAPE_TYPES];
 
@@ -156,6 +180,24 @@ class CollisionDispatch {
         /// Get the Convex Polyhedron vs Convex Polyhedron narrow-phase collision detection algorithm
         ConvexPolyhedronVsConvexPolyhedronAlgorithm* getConvexPolyhedronVsConvexPolyhedronAlgorithm();
 
+        /// Set the Box vs Box narrow-phase collision detection algorithm
+        void setBoxVsBoxAlgorithm(BoxVsBoxAlgorithm* algorithm);
+
+        /// Get the Box vs Box narrow-phase collision detection algorithm
+        BoxVsBoxAlgorithm* getBoxVsBoxAlgorithm();
+
+        /// Set the Sphere vs Box narrow-phase collision detection algorithm
+        void setSphereVsBoxAlgorithm(SphereVsBoxAlgorithm* algorithm);
+
+        /// Get the Sphere vs Box narrow-phase collision detection algorithm
+        SphereVsBoxAlgorithm* getSphereVsBoxAlgorithm();
+
+        /// Set the Capsule vs Box narrow-phase collision detection algorithm
+        void setCapsuleVsBoxAlgorithm(CapsuleVsBoxAlgorithm* algorithm);
+
+        /// Get the Capsule vs Box narrow-phase collision detection algorithm
+        CapsuleVsBoxAlgorithm* getCapsuleVsBoxAlgorithm();
+
         /// Fill-in the collision detection matrix
         void fillInCollisionMatrix();
 
@@ -163,6 +205,9 @@ class CollisionDispatch {
         NarrowPhaseAlgorithmType selectNarrowPhaseAlgorithm(const CollisionShapeType& shape1Type,
                                                             const CollisionShapeType& shape2Type) const;
 
+        /// Return the narrow-phase algorithm type to use for two convex collision shapes
+        NarrowPhaseAlgorithmType selectNarrowPhaseAlgorithm(const CollisionShape* shape1, const CollisionShape* shape2) const;
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
 		/// Set the profiler
@@ -202,6 +247,21 @@ inline ConvexPolyhedronVsConvexPolyhedronAlgorithm* CollisionDispatch::getConvex
     return mConvexPolyhedronVsConvexPolyhedronAlgorithm;
 }
 
+// Get the Box vs Box narrow-phase collision detection algorithm
+inline BoxVsBoxAlgorithm* CollisionDispatch::getBoxVsBoxAlgorithm() {
+    return mBoxVsBoxAlgorithm;
+}
+
+// Get the Sphere vs Box narrow-phase collision detection algorithm
+inline SphereVsBoxAlgorithm* CollisionDispatch::getSphereVsBoxAlgorithm() {
+    return mSphereVsBoxAlgorithm;
+}
+
+// Get the Capsule vs Box narrow-phase collision detection algorithm
+inline CapsuleVsBoxAlgorithm* CollisionDispatch::getCapsuleVsBoxAlgorithm() {
+    return mCapsuleVsBoxAlgorithm;
+}
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
 // Set the profiler
@@ -214,6 +274,9 @@ inline void CollisionDispatch::setProfiler(Profiler* profiler) {
     mSphereVsConvexPolyhedronAlgorithm->setProfiler(profiler);
     mCapsuleVsConvexPolyhedronAlgorithm->setProfiler(profiler);
     mConvexPolyhedronVsConvexPolyhedronAlgorithm->setProfiler(profiler);
+    mBoxVsBoxAlgorithm->setProfiler(profiler);
+    mSphereVsBoxAlgorithm->setProfiler(profiler);
+    mCapsuleVsBoxAlgorithm->setProfiler(profiler);
 }
 
 #endif
@@ -29,6 +29,7 @@
 // Libraries
 #include <reactphysics3d/decimal.h>
 #include <reactphysics3d/configuration.h>
+#include <reactphysics3d/mathematics/Vector3.h>
 
 /// ReactPhysics3D namespace
 namespace reactphysics3d {
@@ -74,6 +75,10 @@ class GJKAlgorithm {
 
         // -------------------- Methods -------------------- //
 
+        /// Return a local support point of a shape without its margin starting the search at a cached vertex
+        static Vector3 getCachedLocalSupportPointWithoutMargin(const ConvexShape* shape, const Vector3& direction,
+                                                               uint& supportVertexIndex);
+
     public :
 
         enum class GJKResult {
@@ -28,6 +28,7 @@
 
 // Libraries
 #include <reactphysics3d/engine/OverlappingPairs.h>
+#include <reactphysics3d/collision/ContactPointInfo.h>
 
 /// Namespace ReactPhysics3D
 namespace reactphysics3d {
@@ -36,7 +37,6 @@ namespace reactphysics3d {
 class CollisionShape;
 struct LastFrameCollisionInfo;
 class ContactManifoldInfo;
-struct ContactPointInfo;
 
 // Struct NarrowPhaseInfoBatch
 /**
@@ -58,6 +58,24 @@ struct NarrowPhaseInfoBatch {
         /// Cached capacity
         uint mCachedCapacity = 0;
 
+        /// Cached number of slots of the contact points array
+        uint mCachedContactPointsCapacity = 0;
+
+        /// Number of slots allocated in the contact points array
+        uint mContactPointsCapacity = 0;
+
+        /// Number of slots of the contact points array reserved by the objects of the batch
+        uint mNbContactPointsSlots = 0;
+
+        /// Allocate the contact points array with a given number of slots
+        void allocateContactPoints(uint nbSlots);
+
+        /// Release the contact points array
+        void releaseContactPoints();
+
+        /// Return the maximum number of contact points that the narrow-phase algorithms compute for two shapes
+        static uint8 computeNbMaxContactPoints(const CollisionShape* shape1, const CollisionShape* shape2);
+
     public:
 
         /// List of Broadphase overlapping pairs ids
@@ -87,11 +105,15 @@ struct NarrowPhaseInfoBatch {
         /// Result of the narrow-phase collision detection test
         List<bool> isColliding;
 
-        /// List of contact points created during the narrow-phase
-        List<List<ContactPointInfo*>> contactPoints;
+        /// Array with the contact points created during the narrow-phase. The contact points of the
+        /// object i of the batch are stored contiguously starting at contactPointsStartIndices[i]
+        ContactPointInfo* contactPoints = nullptr;
 
-        /// Memory allocators for the collision shape (Used to release TriangleShape memory in destructor)
-        List<MemoryAllocator*> collisionShapeAllocators;
+        /// Index of the first slot of each object of the batch in the contact points array
+        List<uint> contactPointsStartIndices;
+
+        /// Number of contact points of each object of the batch in the contact points array
+        List<uint8> nbContactPoints;
 
         /// Collision infos of the previous frame
         List<LastFrameCollisionInfo*> lastFrameCollisionInfos;
@@ -108,12 +130,18 @@ struct NarrowPhaseInfoBatch {
         /// Add shapes to be tested during narrow-phase collision detection into the batch
         virtual void addNarrowPhaseInfo(uint64 pairId, uint64 pairIndex, Entity collider1, Entity collider2, CollisionShape* shape1,
                                 CollisionShape* shape2, const Transform& shape1Transform,
-                                const Transform& shape2Transform, bool needToReportContacts, MemoryAllocator& shapeAllocator);
+                                const Transform& shape2Transform, bool needToReportContacts);
 
         /// Add a new contact point
         virtual void addContactPoint(uint index, const Vector3& contactNormal, decimal penDepth,
                              const Vector3& localPt1, const Vector3& localPt2);
 
+        /// Return a pointer to the first contact point of an object of the batch
+        ContactPointInfo* getContactPoints(uint index);
+
+        /// Return the number of slots of an object of the batch in the contact points array
+        uint8 getNbMaxContactPoints(uint index) const;
+
         /// Reset the remaining contact points
         void resetContactPoints(uint index);
 
@@ -129,6 +157,23 @@ inline uint NarrowPhaseInfoBatch::getNbObjects() const {
     return overlappingPairIds.size();
 }
 
+// Return a pointer to the first contact point of an object of the batch
+inline ContactPointInfo* NarrowPhaseInfoBatch::getContactPoints(uint index) {
+    assert(contactPointsStartIndices[index] <= mContactPointsCapacity);
+    return contactPoints + contactPointsStartIndices[index];
+}
+
+// Return the number of slots of an object of the batch in the contact points array
+inline uint8 NarrowPhaseInfoBatch::getNbMaxContactPoints(uint index) const {
+    const uint endIndex = index + 1 < contactPointsStartIndices.size() ? contactPointsStartIndices[index + 1] : mNbContactPointsSlots;
+    return static_cast<uint8>(endIndex - contactPointsStartIndices[index]);
+}
+
+// Reset the remaining contact points
+inline void NarrowPhaseInfoBatch::resetContactPoints(uint index) {
+    nbContactPoints[index] = 0;
+}
+
 }
 
 #endif
@@ -45,6 +45,7 @@ class NarrowPhaseAlgorithm;
 enum class NarrowPhaseAlgorithmType;
 class Transform;
 struct Vector3;
+class TriangleShape;
 
 // Class NarrowPhaseInput
 /**
@@ -61,17 +62,45 @@ class NarrowPhaseInput {
         NarrowPhaseInfoBatch mSphereVsConvexPolyhedronBatch;
         NarrowPhaseInfoBatch mCapsuleVsConvexPolyhedronBatch;
         NarrowPhaseInfoBatch mConvexPolyhedronVsConvexPolyhedronBatch;
+        NarrowPhaseInfoBatch mBoxVsBoxBatch;
+        NarrowPhaseInfoBatch mSphereVsBoxBatch;
+        NarrowPhaseInfoBatch mCapsuleVsBoxBatch;
+        NarrowPhaseInfoBatch mCachedContactPointsBatch;
+
+        /// Memory allocator
+        MemoryAllocator& mMemoryAllocator;
+
+        /// Blocks of triangle shapes created in the middle-phase for the convex vs concave pairs
+        List<TriangleShape*> mTriangleShapesBlocks;
+
+        /// Number of triangle shapes in each block of triangle shapes
+        List<uint> mNbTriangleShapesPerBlock;
+
+        // -------------------- Methods -------------------- //
+
+        /// Destroy the triangle shapes and release their memory
+        void destroyTriangleShapes();
 
     public:
 
         /// Constructor
         NarrowPhaseInput(MemoryAllocator& allocator, OverlappingPairs& overlappingPairs);
 
+        /// Destructor
+        ~NarrowPhaseInput();
+
+        /// Create the triangle shapes of the concave shape triangles overlapping with a convex shape
+        TriangleShape* createTriangleShapes(const List<Vector3>& trianglesVertices, const List<Vector3>& trianglesVerticesNormals,
+                                            const List<uint>& shapeIds);
+
         /// Add shapes to be tested during narrow-phase collision detection into the batch
         void addNarrowPhaseTest(uint64 pairId, uint64 pairIndex, Entity collider1, Entity collider2, CollisionShape* shape1,
                         CollisionShape* shape2, const Transform& shape1Transform,
-                        const Transform& shape2Transform, NarrowPhaseAlgorithmType narrowPhaseAlgorithmType, bool reportContacts,
-                        MemoryAllocator& shapeAllocator);
+                        const Transform& shape2Transform, NarrowPhaseAlgorithmType narrowPhaseAlgorithmType, bool reportContacts);
+
+        /// Add shapes whose cached contact points are re-projected instead of running the narrow-phase collision detection
+        void addCachedContactPointsTest(uint64 pairId, uint64 pairIndex, Entity collider1, Entity collider2, CollisionShape* shape1,
+                                        CollisionShape* shape2, const Transform& shape1Transform, const Transform& shape2Transform);
 
         /// Get a reference to the sphere vs sphere batch
         SphereVsSphereNarrowPhaseInfoBatch& getSphereVsSphereBatch();
@@ -91,6 +120,18 @@ class NarrowPhaseInput {
         /// Get a reference to the convex polyhedron vs convex polyhedron batch
         NarrowPhaseInfoBatch& getConvexPolyhedronVsConvexPolyhedronBatch();
 
+        /// Get a reference to the box vs box batch
+        NarrowPhaseInfoBatch& getBoxVsBoxBatch();
+
+        /// Get a reference to the sphere vs box batch
+        NarrowPhaseInfoBatch& getSphereVsBoxBatch();
+
+        /// Get a reference to the capsule vs box batch
+        NarrowPhaseInfoBatch& getCapsuleVsBoxBatch();
+
+        /// Get a reference to the batch of shapes whose cached contact points are re-projected
+        NarrowPhaseInfoBatch& getCachedContactPointsBatch();
+
         /// Reserve memory for the containers with cached capacity
         void reserveMemory();
 
@@ -129,5 +170,25 @@ inline NarrowPhaseInfoBatch& NarrowPhaseInput::getConvexPolyhedronVsConvexPolyhe
    return mConvexPolyhedronVsConvexPolyhedronBatch;
 }
 
+// Get a reference to the box vs box batch contacts
+inline NarrowPhaseInfoBatch& NarrowPhaseInput::getBoxVsBoxBatch() {
+   return mBoxVsBoxBatch;
+}
+
+// Get a reference to the sphere vs box batch
+inline NarrowPhaseInfoBatch& NarrowPhaseInput::getSphereVsBoxBatch() {
+   return mSphereVsBoxBatch;
+}
+
+// Get a reference to the capsule vs box batch
+inline NarrowPhaseInfoBatch& NarrowPhaseInput::getCapsuleVsBoxBatch() {
+   return mCapsuleVsBoxBatch;
+}
+
+// Get a reference to the batch of shapes whose cached contact points are re-projected
+inline NarrowPhaseInfoBatch& NarrowPhaseInput::getCachedContactPointsBatch() {
+   return mCachedContactPointsBatch;
+}
+
 }
 #endif
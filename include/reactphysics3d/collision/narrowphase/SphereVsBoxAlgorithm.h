@@ -0,0 +1,72 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_SPHERE_VS_BOX_ALGORITHM_H
+#define	REACTPHYSICS3D_SPHERE_VS_BOX_ALGORITHM_H
+
+// Libraries
+#include <reactphysics3d/collision/narrowphase/NarrowPhaseAlgorithm.h>
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Declarations
+struct NarrowPhaseInfoBatch;
+
+// Class SphereVsBoxAlgorithm
+/**
+ * This class is used to compute the narrow-phase collision detection
+ * between a sphere and a box. The center of the sphere is clamped to
+ * the box in the local-space of the box to get the closest point of the
+ * box. If the center of the sphere is inside the box, the sphere is pushed
+ * out through the face of the box that is the closest to its center.
+ * Contrary to the generic sphere vs convex polyhedron algorithm, neither
+ * GJK nor SAT are needed.
+ */
+class SphereVsBoxAlgorithm : public NarrowPhaseAlgorithm {
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        SphereVsBoxAlgorithm() = default;
+
+        /// Destructor
+        virtual ~SphereVsBoxAlgorithm() override = default;
+
+        /// Deleted copy-constructor
+        SphereVsBoxAlgorithm(const SphereVsBoxAlgorithm& algorithm) = delete;
+
+        /// Deleted assignment operator
+        SphereVsBoxAlgorithm& operator=(const SphereVsBoxAlgorithm& algorithm) = delete;
+
+        /// Compute the narrow-phase collision detection between a sphere and a box
+        bool testCollision(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchStartIndex, uint batchNbItems);
+};
+
+}
+
+#endif
@@ -48,6 +48,19 @@ class SphereVsCapsuleAlgorithm : public NarrowPhaseAlgorithm {
 
     protected :
 
+        // -------------------- Constants -------------------- //
+
+        /// Number of consecutive pairs of shapes tested for overlap at the same time
+        static const uint NB_PAIRS_PER_OVERLAP_TEST = 4;
+
+        // -------------------- Methods -------------------- //
+
+        /// Return the bit mask of the pairs of shapes that may overlap among (at most) four consecutive items of a batch
+        static uint32 computeOverlapMask(const SphereVsCapsuleNarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchIndex, uint nbItems);
+
+        /// Compute the narrow-phase collision detection of a single item of a batch
+        static bool testPairCollision(SphereVsCapsuleNarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchIndex);
+
     public :
 
         // -------------------- Methods -------------------- //
@@ -36,7 +36,9 @@ namespace reactphysics3d {
 /**
  * This structure collects all the potential collisions from the middle-phase algorithm
  * that have to be tested during narrow-phase collision detection. This class collects all the
- * sphere vs capsule collision detection tests.
+ * sphere vs capsule collision detection tests. The world-space centers of the spheres and inner
+ * segments of the capsules are also stored in separate lists of coordinates so that several
+ * pairs can be tested at the same time.
  */
 struct SphereVsCapsuleNarrowPhaseInfoBatch : public NarrowPhaseInfoBatch {
 
@@ -54,6 +56,33 @@ struct SphereVsCapsuleNarrowPhaseInfoBatch : public NarrowPhaseInfoBatch {
         /// List of heights for the capsules
         List<decimal> capsuleHeights;
 
+        /// List of x coordinates of the world-space centers of the spheres
+        List<decimal> sphereCentersX;
+
+        /// List of y coordinates of the world-space centers of the spheres
+        List<decimal> sphereCentersY;
+
+        /// List of z coordinates of the world-space centers of the spheres
+        List<decimal> sphereCentersZ;
+
+        /// List of x coordinates of the world-space centers of the capsules
+        List<decimal> capsuleCentersX;
+
+        /// List of y coordinates of the world-space centers of the capsules
+        List<decimal> capsuleCentersY;
+
+        /// List of z coordinates of the world-space centers of the capsules
+        List<decimal> capsuleCentersZ;
+
+        /// List of x coordinates of the vectors from the centers to the top of the inner segments of the capsules (in world-space)
+        List<decimal> capsuleHalfSegmentsX;
+
+        /// List of y coordinates of the vectors from the centers to the top of the inner segments of the capsules (in world-space)
+        List<decimal> capsuleHalfSegmentsY;
+
+        /// List of z coordinates of the vectors from the centers to the top of the inner segments of the capsules (in world-space)
+        List<decimal> capsuleHalfSegmentsZ;
+
         /// Constructor
         SphereVsCapsuleNarrowPhaseInfoBatch(MemoryAllocator& allocator, OverlappingPairs& overlappingPairs);
 
@@ -63,7 +92,7 @@ struct SphereVsCapsuleNarrowPhaseInfoBatch : public NarrowPhaseInfoBatch {
         /// Add shapes to be tested during narrow-phase collision detection into the batch
         virtual void addNarrowPhaseInfo(uint64 pairId, uint64 pairIndex, Entity collider1, Entity collider2, CollisionShape* shape1,
                                         CollisionShape* shape2, const Transform& shape1Transform,
-                                        const Transform& shape2Transform, bool needToReportContacts, MemoryAllocator& shapeAllocator) override;
+                                        const Transform& shape2Transform, bool needToReportContacts) override;
 
         // Initialize the containers using cached capacity
         virtual void reserveMemory() override;
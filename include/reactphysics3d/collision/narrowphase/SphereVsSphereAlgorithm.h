@@ -48,6 +48,19 @@ class SphereVsSphereAlgorithm : public NarrowPhaseAlgorithm {
 
     protected :
 
+        // -------------------- Constants -------------------- //
+
+        /// Number of consecutive pairs of spheres tested for overlap at the same time
+        static const uint NB_PAIRS_PER_OVERLAP_TEST = 4;
+
+        // -------------------- Methods -------------------- //
+
+        /// Return the bit mask of the overlapping pairs of spheres among (at most) four consecutive items of a batch
+        static uint32 computeOverlapMask(const SphereVsSphereNarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchIndex, uint nbItems);
+
+        /// Compute the contact point of two overlapping spheres
+        static void computeContactPoint(SphereVsSphereNarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchIndex);
+
     public :
 
         // -------------------- Methods -------------------- //
@@ -36,7 +36,8 @@ namespace reactphysics3d {
 /**
  * This structure collects all the potential collisions from the middle-phase algorithm
  * that have to be tested during narrow-phase collision detection. This class collects all the
- * sphere vs sphere collision detection tests.
+ * sphere vs sphere collision detection tests. The world-space centers of the spheres are also
+ * stored in separate lists of coordinates so that several pairs can be tested at the same time.
  */
 struct SphereVsSphereNarrowPhaseInfoBatch : public NarrowPhaseInfoBatch {
 
@@ -48,6 +49,24 @@ struct SphereVsSphereNarrowPhaseInfoBatch : public NarrowPhaseInfoBatch {
         /// List of radiuses for the second spheres
         List<decimal> sphere2Radiuses;
 
+        /// List of x coordinates of the world-space centers of the first spheres
+        List<decimal> sphere1CentersX;
+
+        /// List of y coordinates of the world-space centers of the first spheres
+        List<decimal> sphere1CentersY;
+
+        /// List of z coordinates of the world-space centers of the first spheres
+        List<decimal> sphere1CentersZ;
+
+        /// List of x coordinates of the world-space centers of the second spheres
+        List<decimal> sphere2CentersX;
+
+        /// List of y coordinates of the world-space centers of the second spheres
+        List<decimal> sphere2CentersY;
+
+        /// List of z coordinates of the world-space centers of the second spheres
+        List<decimal> sphere2CentersZ;
+
         /// Constructor
         SphereVsSphereNarrowPhaseInfoBatch(MemoryAllocator& allocator, OverlappingPairs& overlappingPairs);
 
@@ -57,7 +76,7 @@ struct SphereVsSphereNarrowPhaseInfoBatch : public NarrowPhaseInfoBatch {
         /// Add shapes to be tested during narrow-phase collision detection into the batch
         virtual void addNarrowPhaseInfo(uint64 airId, uint64 pairIndex, Entity collider1, Entity collider2, CollisionShape* shape1,
                                         CollisionShape* shape2, const Transform& shape1Transform,
-                                        const Transform& shape2Transform, bool needToReportContacts, MemoryAllocator& shapeAllocator) override;
+                                        const Transform& shape2Transform, bool needToReportContacts) override;
 
         // Initialize the containers using cached capacity
         virtual void reserveMemory() override;
@@ -88,12 +88,18 @@ class AABB {
         /// Inflate each side of the AABB by a given size
         void inflate(decimal dx, decimal dy, decimal dz);
 
+        /// Extend the AABB in the direction of a displacement vector
+        void extend(const Vector3& displacement);
+
         /// Return true if the current AABB is overlapping with the AABB in argument
         bool testCollision(const AABB& aabb) const;
 
         /// Return the volume of the AABB
         decimal getVolume() const;
 
+        /// Return the surface area of the AABB
+        decimal getSurfaceArea() const;
+
         /// Merge the AABB in parameter with the current one
         void mergeWithAABB(const AABB& aabb);
 
@@ -162,6 +168,20 @@ inline void AABB::inflate(decimal dx, decimal dy, decimal dz) {
     mMinCoordinates -= Vector3(dx, dy, dz);
 }
 
+// Extend the AABB in the direction of a displacement vector
+/// Only the side of the AABB in the direction of the displacement is moved on each axis
+inline void AABB::extend(const Vector3& displacement) {
+
+    for (int i=0; i < 3; i++) {
+        if (displacement[i] < decimal(0.0)) {
+            mMinCoordinates[i] += displacement[i];
+        }
+        else {
+            mMaxCoordinates[i] += displacement[i];
+        }
+    }
+}
+
 // Return true if the current AABB is overlapping with the AABB in argument.
 /// Two AABBs overlap if they overlap in the three x, y and z axis at the same time
 inline bool AABB::testCollision(const AABB& aabb) const {
@@ -180,6 +200,12 @@ inline decimal AABB::getVolume() const {
     return (diff.x * diff.y * diff.z);
 }
 
+// Return the surface area of the AABB
+inline decimal AABB::getSurfaceArea() const {
+    const Vector3 diff = mMaxCoordinates - mMinCoordinates;
+    return decimal(2.0) * (diff.x * diff.y + diff.y * diff.z + diff.z * diff.x);
+}
+
 // Return true if the AABB of a triangle intersects the AABB
 inline bool AABB::testCollisionTriangleAABB(const Vector3* trianglePoints) const {
 
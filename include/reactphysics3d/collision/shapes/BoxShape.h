@@ -104,6 +104,9 @@ class BoxShape : public ConvexPolyhedronShape {
         /// Return the number of faces of the polyhedron
         virtual uint getNbFaces() const override;
 
+        /// Return the maximum number of vertices of a face of the polyhedron
+        virtual uint getNbMaxFaceVertices() const override;
+
         /// Return a given face of the polyhedron
         virtual const HalfEdgeStructure::Face& getFace(uint faceIndex) const override;
 
@@ -196,6 +199,11 @@ inline uint BoxShape::getNbFaces() const {
     return 6;
 }
 
+// Return the maximum number of vertices of a face of the polyhedron
+inline uint BoxShape::getNbMaxFaceVertices() const {
+    return 4;
+}
+
 // Return a given face of the polyhedron
 inline const HalfEdgeStructure::Face& BoxShape::getFace(uint faceIndex) const {
     assert(faceIndex < mHalfEdgeStructure.getNbFaces());
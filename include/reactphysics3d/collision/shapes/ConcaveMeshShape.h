@@ -28,7 +28,7 @@
 
 // Libraries
 #include <reactphysics3d/collision/shapes/ConcaveShape.h>
-#include <reactphysics3d/collision/broadphase/DynamicAABBTree.h>
+#include <reactphysics3d/collision/broadphase/QuantizedAABBTree.h>
 #include <reactphysics3d/containers/List.h>
 
 namespace reactphysics3d {
@@ -38,6 +38,7 @@ class ConcaveMeshShape;
 class Profiler;
 class TriangleShape;
 class TriangleMesh;
+class TaskScheduler;
 
 // class ConvexTriangleAABBOverlapCallback
 class ConvexTriangleAABBOverlapCallback : public DynamicAABBTreeOverlapCallback {
@@ -49,21 +50,21 @@ class ConvexTriangleAABBOverlapCallback : public DynamicAABBTreeOverlapCallback
         // Reference to the concave mesh shape
         const ConcaveMeshShape& mConcaveMeshShape;
 
-        // Reference to the Dynamic AABB tree
-        const DynamicAABBTree& mDynamicAABBTree;
+        // Reference to the AABB tree of the mesh
+        const QuantizedAABBTree& mTree;
 
     public:
 
         // Constructor
         ConvexTriangleAABBOverlapCallback(TriangleCallback& triangleCallback, const ConcaveMeshShape& concaveShape,
-                                          const DynamicAABBTree& dynamicAABBTree)
-          : mTriangleTestCallback(triangleCallback), mConcaveMeshShape(concaveShape), mDynamicAABBTree(dynamicAABBTree) {
+                                          const QuantizedAABBTree& tree)
+          : mTriangleTestCallback(triangleCallback), mConcaveMeshShape(concaveShape), mTree(tree) {
 
         }
 
-        // Called when a overlapping node has been found during the call to
-        // DynamicAABBTree:reportAllShapesOverlappingWithAABB()
-        virtual void notifyOverlappingNode(int nodeId) override;
+        // Called when a overlapping leaf has been found during the call to
+        // QuantizedAABBTree:reportAllShapesOverlappingWithAABB()
+        virtual void notifyOverlappingNode(int leafIndex) override;
 
 };
 
@@ -72,8 +73,8 @@ class ConcaveMeshRaycastCallback : public DynamicAABBTreeRaycastCallback {
 
     private :
 
-        List<int32> mHitAABBNodes;
-        const DynamicAABBTree& mDynamicAABBTree;
+        List<int32> mHitAABBLeaves;
+        const QuantizedAABBTree& mTree;
         const ConcaveMeshShape& mConcaveMeshShape;
         Collider* mCollider;
         RaycastInfo& mRaycastInfo;
@@ -92,15 +93,15 @@ class ConcaveMeshRaycastCallback : public DynamicAABBTreeRaycastCallback {
     public:
 
         // Constructor
-        ConcaveMeshRaycastCallback(const DynamicAABBTree& dynamicAABBTree, const ConcaveMeshShape& concaveMeshShape,
+        ConcaveMeshRaycastCallback(const QuantizedAABBTree& tree, const ConcaveMeshShape& concaveMeshShape,
                                    Collider* collider, RaycastInfo& raycastInfo, const Ray& ray, const Vector3& meshScale, MemoryAllocator& allocator)
-            : mHitAABBNodes(allocator), mDynamicAABBTree(dynamicAABBTree), mConcaveMeshShape(concaveMeshShape), mCollider(collider),
+            : mHitAABBLeaves(allocator), mTree(tree), mConcaveMeshShape(concaveMeshShape), mCollider(collider),
               mRaycastInfo(raycastInfo), mRay(ray), mIsHit(false), mAllocator(allocator), mMeshScale(meshScale) {
 
         }
 
-        /// Collect all the AABB nodes that are hit by the ray in the Dynamic AABB Tree
-        virtual decimal raycastBroadPhaseShape(int32 nodeId, const Ray& ray) override;
+        /// Collect all the leaves that are hit by the ray in the AABB tree
+        virtual decimal raycastBroadPhaseShape(int32 leafIndex, const Ray& ray) override;
 
         /// Raycast all collision shapes that have been collected
         void raycastTriangles();
@@ -120,6 +121,42 @@ class ConcaveMeshRaycastCallback : public DynamicAABBTreeRaycastCallback {
 #endif
 };
 
+// Class ConcaveMeshRayPacketCallback
+/**
+ * Callback used to cast a packet of rays against the triangles of a concave mesh. The rays
+ * that hit a leaf of the tree are tested against its triangle and each ray is clipped to its
+ * closest hit so that the next leaves are tested with shorter rays.
+ */
+class ConcaveMeshRayPacketCallback : public DynamicAABBTreeRayPacketCallback {
+
+    private :
+
+        const QuantizedAABBTree& mTree;
+        const ConcaveMeshShape& mConcaveMeshShape;
+        Collider* mCollider;
+        RaycastInfo* mRaycastInfos;
+        const Vector3& mMeshScale;
+        uint32 mHitMask;
+
+    public:
+
+        // Constructor
+        ConcaveMeshRayPacketCallback(const QuantizedAABBTree& tree, const ConcaveMeshShape& concaveMeshShape,
+                                     Collider* collider, RaycastInfo* raycastInfos, const Vector3& meshScale)
+            : mTree(tree), mConcaveMeshShape(concaveMeshShape), mCollider(collider),
+              mRaycastInfos(raycastInfos), mMeshScale(meshScale), mHitMask(0) {
+
+        }
+
+        /// Raycast the rays of the packet that hit a leaf against its triangle
+        virtual void raycastBroadPhaseShape(int32 leafIndex, RayPacket& packet, uint32 rayMask) override;
+
+        /// Return the bit mask of the rays that have hit a triangle
+        uint32 getHitMask() const {
+            return mHitMask;
+        }
+};
+
 // Class ConcaveMeshShape
 /**
  * This class represents a static concave mesh shape. Note that collision detection
@@ -135,8 +172,8 @@ class ConcaveMeshShape : public ConcaveShape {
         /// Pointer to the triangle mesh
         TriangleMesh* mTriangleMesh;
 
-        /// Dynamic AABB tree to accelerate collision with the triangles
-        DynamicAABBTree mDynamicAABBTree;
+        /// Compressed AABB tree to accelerate collision with the triangles
+        QuantizedAABBTree mTree;
 
         /// Array with computed vertices normals for each TriangleVertexArray of the triangle mesh (only
         /// if the user did not provide its own vertices normals)
@@ -145,16 +182,21 @@ class ConcaveMeshShape : public ConcaveShape {
         // -------------------- Methods -------------------- //
 
         /// Constructor
-        ConcaveMeshShape(TriangleMesh* triangleMesh, MemoryAllocator& allocator, const Vector3& scaling = Vector3(1, 1, 1));
+        ConcaveMeshShape(TriangleMesh* triangleMesh, MemoryAllocator& allocator, const Vector3& scaling = Vector3(1, 1, 1),
+                         TaskScheduler* taskScheduler = nullptr);
 
         /// Raycast method with feedback information
         virtual bool raycast(const Ray& ray, RaycastInfo& raycastInfo, Collider* collider, MemoryAllocator& allocator) const override;
 
+        /// Raycast method for the rays of a packet in local-space
+        uint32 raycast(const RayPacket& packet, uint32 rayMask, RaycastInfo* outRaycastInfos, Collider* collider,
+                       MemoryAllocator& allocator) const;
+
         /// Return the number of bytes used by the collision shape
         virtual size_t getSizeInBytes() const override;
 
-        /// Insert all the triangles into the dynamic AABB tree
-        void initBVHTree();
+        /// Build the AABB tree of the triangles
+        void initBVHTree(MemoryAllocator& allocator, TaskScheduler* taskScheduler);
 
         /// Return the three vertices coordinates (in the list outTriangleVertices) of a triangle
         void getTriangleVertices(uint subPart, uint triangleIndex, Vector3* outTriangleVertices) const;
@@ -207,6 +249,8 @@ class ConcaveMeshShape : public ConcaveShape {
 
         friend class ConvexTriangleAABBOverlapCallback;
         friend class ConcaveMeshRaycastCallback;
+        friend class ConcaveMeshRayPacketCallback;
+        friend class Collider;
         friend class PhysicsCommon;
         friend class DebugRenderer;
 };
@@ -225,18 +269,18 @@ inline size_t ConcaveMeshShape::getSizeInBytes() const {
 inline void ConcaveMeshShape::getLocalBounds(Vector3& min, Vector3& max) const {
 
     // Get the AABB of the whole tree
-    AABB treeAABB = mDynamicAABBTree.getRootAABB();
+    const AABB& treeAABB = mTree.getRootAABB();
 
     min = treeAABB.getMin();
     max = treeAABB.getMax();
 }
 
-// Called when a overlapping node has been found during the call to
-// DynamicAABBTree:reportAllShapesOverlappingWithAABB()
-inline void ConvexTriangleAABBOverlapCallback::notifyOverlappingNode(int nodeId) {
+// Called when a overlapping leaf has been found during the call to
+// QuantizedAABBTree:reportAllShapesOverlappingWithAABB()
+inline void ConvexTriangleAABBOverlapCallback::notifyOverlappingNode(int leafIndex) {
 
-    // Get the node data (triangle index and mesh subpart index)
-    int32* data = mDynamicAABBTree.getNodeDataInt(nodeId);
+    // Get the leaf data (triangle index and mesh subpart index)
+    const int32* data = mTree.getLeafDataInt(leafIndex);
 
     // Get the triangle vertices for this node from the concave mesh shape
     Vector3 trianglePoints[3];
@@ -257,7 +301,7 @@ inline void ConcaveMeshShape::setProfiler(Profiler* profiler) {
 
     CollisionShape::setProfiler(profiler);
 
-    mDynamicAABBTree.setProfiler(profiler);
+    mTree.setProfiler(profiler);
 }
 
 
@@ -68,6 +68,9 @@ class ConcaveShape : public CollisionShape {
         /// Scale of the shape
         Vector3 mScale;
 
+        /// Version of the data of the shape (incremented each time its triangles are modified)
+        uint32 mDataVersion;
+
         // -------------------- Methods -------------------- //
 
         /// Return true if a point is inside the collision shape
@@ -101,6 +104,12 @@ class ConcaveShape : public CollisionShape {
         /// Set the scale of the shape
         void setScale(const Vector3& scale);
 
+        /// Return the version of the data of the shape
+        uint32 getDataVersion() const;
+
+        /// Notify the shape that its data (vertices or height values) have been modified
+        virtual void notifyDataChanged();
+
         /// Return the local inertia tensor of the collision shape
         virtual Vector3 getLocalInertiaTensor(decimal mass) const override;
 
@@ -157,10 +166,26 @@ inline const Vector3& ConcaveShape::getScale() const {
 /// after changing the scale of a collision shape
 inline void ConcaveShape::setScale(const Vector3& scale) {
     mScale = scale;
+    mDataVersion++;
 
     notifyColliderAboutChangedSize();
 }
 
+// Return the version of the data of the shape
+/// The version is incremented each time the triangles of the shape are modified. It is used
+/// to invalidate the triangles of the shape cached by the collision detection.
+inline uint32 ConcaveShape::getDataVersion() const {
+    return mDataVersion;
+}
+
+// Notify the shape that its data (vertices or height values) have been modified
+/// The shape does not copy the vertices or height values given by the user. Therefore, this method
+/// must be called after modifying them so that the triangles cached by the collision detection are
+/// computed again.
+inline void ConcaveShape::notifyDataChanged() {
+    mDataVersion++;
+}
+
 // Return the local inertia tensor of the shape
 /**
  * @param mass Mass to use to compute the inertia tensor of the collision shape
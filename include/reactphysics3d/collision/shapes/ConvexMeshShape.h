@@ -74,6 +74,12 @@ class ConvexMeshShape : public ConvexPolyhedronShape {
         /// Return a local support point in a given direction without the object margin.
         virtual Vector3 getLocalSupportPointWithoutMargin(const Vector3& direction) const override;
 
+        /// Return a local support point without the object margin starting the search at a cached vertex
+        Vector3 getCachedLocalSupportPointWithoutMargin(const Vector3& direction, uint& supportVertexIndex) const;
+
+        /// Return the index of the vertex with the largest dot product with a (scaled) direction
+        uint computeSupportVertexIndex(const Vector3& scaledDirection, uint startVertexIndex) const;
+
         /// Return true if a point is inside the collision shape
         virtual bool testPointInside(const Vector3& localPoint, Collider* collider) const override;
 
@@ -111,6 +117,9 @@ class ConvexMeshShape : public ConvexPolyhedronShape {
         /// Return the number of faces of the polyhedron
         virtual uint getNbFaces() const override;
 
+        /// Return the maximum number of vertices of a face of the polyhedron
+        virtual uint getNbMaxFaceVertices() const override;
+
         /// Return a given face of the polyhedron
         virtual const HalfEdgeStructure::Face& getFace(uint faceIndex) const override;
 
@@ -144,6 +153,7 @@ class ConvexMeshShape : public ConvexPolyhedronShape {
         // ----- Friendship ----- //
 
         friend class PhysicsCommon;
+        friend class GJKAlgorithm;
 };
 
 // Return the number of bytes used by the collision shape
@@ -196,6 +206,11 @@ inline uint ConvexMeshShape::getNbFaces() const {
     return mPolyhedronMesh->getHalfEdgeStructure().getNbFaces();
 }
 
+// Return the maximum number of vertices of a face of the polyhedron
+inline uint ConvexMeshShape::getNbMaxFaceVertices() const {
+    return mPolyhedronMesh->getNbMaxFaceVertices();
+}
+
 // Return a given face of the polyhedron
 inline const HalfEdgeStructure::Face& ConvexMeshShape::getFace(uint faceIndex) const {
     assert(faceIndex < getNbFaces());
@@ -61,6 +61,9 @@ class ConvexPolyhedronShape : public ConvexShape {
         /// Return the number of faces of the polyhedron
         virtual uint getNbFaces() const=0;
 
+        /// Return the maximum number of vertices of a face of the polyhedron
+        virtual uint getNbMaxFaceVertices() const=0;
+
         /// Return a given face of the polyhedron
         virtual const HalfEdgeStructure::Face& getFace(uint faceIndex) const=0;
 
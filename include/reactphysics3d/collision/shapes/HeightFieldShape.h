@@ -91,6 +91,20 @@ class HeightFieldShape : public ConcaveShape {
         /// Local AABB of the height field (without scaling)
         AABB mAABB;
 
+        /// Minimum height (in the non-scaled local-space) of each tile of all the levels of the min/max height pyramid
+        List<decimal> mPyramidMinHeights;
+
+        /// Maximum height (in the non-scaled local-space) of each tile of all the levels of the min/max height pyramid
+        List<decimal> mPyramidMaxHeights;
+
+        /// Index of the first tile of each level of the min/max height pyramid (empty if the pyramid is disabled)
+        List<uint> mPyramidLevelStartIndices;
+
+        // -------------------- Constants -------------------- //
+
+        /// Number of grid cells along each side of the tiles of the first level of the min/max height pyramid
+        static const int PYRAMID_LEAF_TILE_SIZE;
+
         // -------------------- Methods -------------------- //
 
         /// Constructor
@@ -102,6 +116,31 @@ class HeightFieldShape : public ConcaveShape {
         /// Raycast method with feedback information
         virtual bool raycast(const Ray& ray, RaycastInfo& raycastInfo, Collider* collider, MemoryAllocator& allocator) const override;
 
+        /// Raycast against the two triangles of a given grid cell of the height field
+        bool raycastGridCell(int i, int j, const Ray& ray, decimal& outHitFraction, Vector3& outHitPoint,
+                             Vector3& outHitNormal) const;
+
+        /// Return the ray fraction where a ray leaves a range of grid coordinates along one axis of the grid
+        static decimal computeRayExitFraction(decimal originCoord, decimal direction, int minCoord, int maxCoord);
+
+        /// Add the two triangles of a given grid cell of the height field into the lists of triangles
+        void addGridCellTriangles(int i, int j, List<Vector3>& triangleVertices, List<Vector3>& triangleVerticesNormals,
+                                  List<uint>& shapeIds) const;
+
+        /// Add the triangles of the cells of a tile of the min/max height pyramid overlapping with an AABB
+        void addPyramidTileTriangles(int level, int tileI, int tileJ, int iMin, int iMax, int jMin, int jMax,
+                                     decimal minHeight, decimal maxHeight, List<Vector3>& triangleVertices,
+                                     List<Vector3>& triangleVerticesNormals, List<uint>& shapeIds) const;
+
+        /// Return the number of tiles of a level of the min/max height pyramid along a grid axis with a given number of cells
+        static int getNbPyramidTiles(int nbCells, int level);
+
+        /// Return the index of a tile of the min/max height pyramid in the arrays of min/max heights
+        uint getPyramidTileIndex(int level, int tileI, int tileJ) const;
+
+        /// Compute the min/max height pyramid from the current height values
+        void computeMinMaxHeightPyramid();
+
         /// Return the number of bytes used by the collision shape
         virtual size_t getSizeInBytes() const override;
 
@@ -148,6 +187,15 @@ class HeightFieldShape : public ConcaveShape {
         /// Return the type of height value in the height field
         HeightDataType getHeightDataType() const;
 
+        /// Enable/disable the min/max height pyramid used to cull the triangles of the overlap queries and raycasts
+        void enableMinMaxHeightPyramid(bool isEnabled);
+
+        /// Return true if the min/max height pyramid is enabled
+        bool isMinMaxHeightPyramidEnabled() const;
+
+        /// Notify the shape that its height values have been modified
+        virtual void notifyDataChanged() override;
+
         /// Return the local bounds of the shape in x, y and z directions.
         virtual void getLocalBounds(Vector3& min, Vector3& max) const override;
 
@@ -181,6 +229,27 @@ inline HeightFieldShape::HeightDataType HeightFieldShape::getHeightDataType() co
     return mHeightDataType;
 }
 
+// Return true if the min/max height pyramid is enabled
+inline bool HeightFieldShape::isMinMaxHeightPyramidEnabled() const {
+    return mPyramidLevelStartIndices.size() > 0;
+}
+
+// Return the number of tiles of a level of the min/max height pyramid along a grid axis with a given number of cells
+inline int HeightFieldShape::getNbPyramidTiles(int nbCells, int level) {
+    const int tileSize = PYRAMID_LEAF_TILE_SIZE << level;
+    return (nbCells + tileSize - 1) / tileSize;
+}
+
+// Return the index of a tile of the min/max height pyramid in the arrays of min/max heights
+inline uint HeightFieldShape::getPyramidTileIndex(int level, int tileI, int tileJ) const {
+
+    assert(level >= 0 && level < static_cast<int>(mPyramidLevelStartIndices.size()));
+    assert(tileI >= 0 && tileI < getNbPyramidTiles(mNbColumns - 1, level));
+    assert(tileJ >= 0 && tileJ < getNbPyramidTiles(mNbRows - 1, level));
+
+    return mPyramidLevelStartIndices[level] + tileJ * getNbPyramidTiles(mNbColumns - 1, level) + tileI;
+}
+
 // Return the number of bytes used by the collision shape
 inline size_t HeightFieldShape::getSizeInBytes() const {
     return sizeof(HeightFieldShape);
@@ -29,6 +29,7 @@
 // Libraries
 #include <reactphysics3d/mathematics/mathematics.h>
 #include <reactphysics3d/collision/shapes/ConvexPolyhedronShape.h>
+#include <reactphysics3d/memory/DefaultAllocator.h>
 
 /// ReactPhysics3D namespace
 namespace reactphysics3d {
@@ -73,11 +74,15 @@ class TriangleShape : public ConvexPolyhedronShape {
         /// Raycast test type for the triangle (front, back, front-back)
         TriangleRaycastSide mRaycastTestType;
 
-        /// Faces information for the two faces of the triangle
-        HalfEdgeStructure::Face mFaces[2];
+        /// Memory allocator of the vertices indices of the shared faces
+        static DefaultAllocator mFacesAllocator;
 
-        /// Edges information for the six edges of the triangle
-        HalfEdgeStructure::Edge mEdges[6];
+        /// Faces information for the two faces of the triangle (shared by all the triangles
+        /// so that creating a triangle shape does not allocate memory)
+        static const HalfEdgeStructure::Face mFaces[2];
+
+        /// Edges information for the six edges of the triangle (shared by all the triangles)
+        static const HalfEdgeStructure::Edge mEdges[6];
 
         // -------------------- Methods -------------------- //
 
@@ -100,6 +105,9 @@ class TriangleShape : public ConvexPolyhedronShape {
         /// Generate the id of the shape (used for temporal coherence)
         void generateId();
 
+        /// Create a face of the half-edge structure shared by all the triangles
+        static HalfEdgeStructure::Face createFace(uint vertex1, uint vertex2, uint vertex3, uint edgeIndex);
+
         // -------------------- Methods -------------------- //
 
         /// This method implements the technique described in Game Physics Pearl book
@@ -142,6 +150,9 @@ class TriangleShape : public ConvexPolyhedronShape {
         /// Return the number of faces of the polyhedron
         virtual uint getNbFaces() const override;
 
+        /// Return the maximum number of vertices of a face of the polyhedron
+        virtual uint getNbMaxFaceVertices() const override;
+
         /// Return a given face of the polyhedron
         virtual const HalfEdgeStructure::Face& getFace(uint faceIndex) const override;
 
@@ -175,6 +186,10 @@ class TriangleShape : public ConvexPolyhedronShape {
                                                      const Transform& shape1ToWorld, const Transform& shape2ToWorld,
                                                      decimal penetrationDepth, Vector3& outSmoothVertexNormal);
 
+        /// Compute the intersection between a ray and a triangle
+        static bool raycastTriangle(const Ray& ray, const Vector3* points, TriangleRaycastSide raycastTestType,
+                                    decimal& outHitFraction, Vector3& outHitPoint, Vector3& outHitNormal);
+
         /// Return the string representation of the shape
         virtual std::string to_string() const override;
 
@@ -185,6 +200,7 @@ class TriangleShape : public ConvexPolyhedronShape {
         friend class MiddlePhaseTriangleCallback;
         friend class HeightFieldShape;
         friend class CollisionDetectionSystem;
+        friend class NarrowPhaseInput;
 };
 
 // Return the number of bytes used by the collision shape
@@ -236,6 +252,11 @@ inline uint TriangleShape::getNbFaces() const {
     return 2;
 }
 
+// Return the maximum number of vertices of a face of the polyhedron
+inline uint TriangleShape::getNbMaxFaceVertices() const {
+    return 3;
+}
+
 // Return a given face of the polyhedron
 inline const HalfEdgeStructure::Face& TriangleShape::getFace(uint faceIndex) const {
     assert(faceIndex < 2);
@@ -92,6 +92,10 @@ class ColliderComponents : public Components {
         /// Array with the list of involved overlapping pairs for each collider
         List<uint64>* mOverlappingPairs;
 
+        /// Array with the percentage of the size of the AABB of each collider used to inflate
+        /// its fat AABB in the broad-phase (negative to use the default percentage)
+        decimal* mFatAABBInflatePercentages;
+
         /// True if the size of the collision shape associated with the collider
         /// has been changed by the user
         bool* mHasCollisionShapeChangedSize;
@@ -192,6 +196,12 @@ class ColliderComponents : public Components {
         /// Return a reference to the list of overlapping pairs for a given collider
         List<uint64>& getOverlappingPairs(Entity colliderEntity);
 
+        /// Return the percentage used to inflate the fat AABB of a collider in the broad-phase
+        decimal getFatAABBInflatePercentage(Entity colliderEntity) const;
+
+        /// Set the percentage used to inflate the fat AABB of a collider in the broad-phase
+        void setFatAABBInflatePercentage(Entity colliderEntity, decimal percentage);
+
         /// Return true if the size of collision shape of the collider has been changed by the user
         bool getHasCollisionShapeChangedSize(Entity colliderEntity) const;
 
@@ -324,6 +334,22 @@ inline List<uint64>& ColliderComponents::getOverlappingPairs(Entity colliderEnti
     return mOverlappingPairs[mMapEntityToComponentIndex[colliderEntity]];
 }
 
+// Return the percentage used to inflate the fat AABB of a collider in the broad-phase
+inline decimal ColliderComponents::getFatAABBInflatePercentage(Entity colliderEntity) const {
+
+    assert(mMapEntityToComponentIndex.containsKey(colliderEntity));
+
+    return mFatAABBInflatePercentages[mMapEntityToComponentIndex[colliderEntity]];
+}
+
+// Set the percentage used to inflate the fat AABB of a collider in the broad-phase
+inline void ColliderComponents::setFatAABBInflatePercentage(Entity colliderEntity, decimal percentage) {
+
+    assert(mMapEntityToComponentIndex.containsKey(colliderEntity));
+
+    mFatAABBInflatePercentages[mMapEntityToComponentIndex[colliderEntity]] = percentage;
+}
+
 // Return true if the size of collision shape of the collider has been changed by the user
 inline bool ColliderComponents::getHasCollisionShapeChangedSize(Entity colliderEntity) const {
 
@@ -44,6 +44,13 @@
     #define LINUX_OS
 #endif
 
+// SSE instructions are used by some collision queries when they are available
+// (single precision only because the queries process four floats at a time)
+#if !defined(IS_RP3D_DOUBLE_PRECISION_ENABLED) && (defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || \
+                                                   (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+    #define RP3D_SSE_ENABLED
+#endif
+
 /// Namespace reactphysics3d
 namespace reactphysics3d {
 
@@ -81,6 +88,16 @@ enum class JointsPositionCorrectionTechnique {BAUMGARTE_JOINTS, NON_LINEAR_GAUSS
 ///                 bodies momentum. This is the option used by default.
 enum class ContactsPositionCorrectionTechnique {BAUMGARTE_CONTACTS, SPLIT_IMPULSES};
 
+/// Algorithm used by the broad-phase collision detection to find the overlapping colliders
+/// DYNAMIC_AABB_TREE : Dynamic AABB tree. Works well when only a part of the colliders move
+///                     at each frame. This is the option used by default.
+/// SWEEP_AND_PRUNE : Array of colliders sorted along an axis. Faster for dense worlds where
+///                   most of the colliders move at each frame but slower for ray casting.
+/// HASH_GRID : Uniform grid of cells stored in a hash table. Faster for worlds with many small
+///             colliders of similar sizes that move at each frame (particles, debris, ...). The
+///             static and large colliders are stored in dynamic AABB trees.
+enum class BroadPhaseAlgorithmType {DYNAMIC_AABB_TREE, SWEEP_AND_PRUNE, HASH_GRID};
+
 // ------------------- Constants ------------------- //
 
 /// Smallest decimal value (negative)
@@ -103,6 +120,61 @@ constexpr decimal PI_TIMES_2 = decimal(6.28318530);
 /// without triggering a large modification of the tree each frame which can be costly
 constexpr decimal DYNAMIC_TREE_FAT_AABB_INFLATE_PERCENTAGE = decimal(0.08);
 
+/// When the velocity prediction of the fat AABBs is enabled, the fat AABB of a moving collider
+/// is also extended in the direction of its motion by the displacement of the collider during
+/// the last frame multiplied by this factor. A factor larger than one keeps the collider inside of
+/// its fat AABB for more than one frame and when it accelerates. The value is not critical: with the
+/// scenes of the benchmark application, the simulation times do not change by more than the noise
+/// between two runs for factors between 1.0 and 3.0
+constexpr decimal FAT_AABB_DISPLACEMENT_MULTIPLIER = decimal(1.7);
+
+/// In the hash grid broad-phase, the size of the cells is the average size of the fat AABBs of
+/// the non-static colliders multiplied by this factor (when the cell size is not set by the user)
+constexpr decimal HASH_GRID_CELL_SIZE_MULTIPLIER = decimal(2.0);
+
+/// In the dynamic AABB tree broad-phase, when the number of moved colliders is at least this fraction
+/// of the number of non-static colliders, the overlapping pairs are found by traversing the trees
+/// together instead of querying the trees from their root with each moved collider
+constexpr decimal TREE_VS_TREE_MIN_MOVED_FRACTION = decimal(0.25);
+
+/// Minimum number of pairs of nodes the traversal of two trees is split into in the dynamic AABB
+/// tree broad-phase. This number does not depend on the number of threads so that the overlapping
+/// pairs are always found in the same order
+constexpr uint32 TREE_VS_TREE_MIN_NB_NODE_PAIRS = 64;
+
+/// Size (in bytes) of a cache line. The data written by several threads at the same time are
+/// aligned on cache lines so that the threads do not invalidate the cache lines of each other
+constexpr uint32 CACHE_LINE_SIZE = 64;
+
+/// When a stage of the simulation is split among several threads (with a task scheduler),
+/// this is the number of items (bodies, colliders, ...) processed by a single task
+constexpr uint32 PARALLEL_FOR_GRAIN_SIZE = 256;
+
+/// Number of moved shapes tested for overlap by a single task in the broad-phase
+/// when it is split among several threads
+constexpr uint32 BROAD_PHASE_GRAIN_SIZE = 64;
+
+/// Minimum number of narrow-phase tests (pairs of shapes) of a batch processed by a single task
+/// when the narrow-phase collision detection is split among several threads
+constexpr uint32 NARROW_PHASE_GRAIN_SIZE = 64;
+
+/// Maximum number of tasks per thread used to split a batch of narrow-phase tests. Each of
+/// those tasks allocates its temporary memory with its own single frame allocator
+constexpr uint32 NARROW_PHASE_NB_TASKS_PER_THREAD = 4;
+
+/// Maximum number of contact points of a convex vs convex pair cached after its narrow-phase test to
+/// be reused in the next frames while the relative pose of the two shapes barely changes
+constexpr uint32 NB_MAX_CACHED_CONTACT_POINTS = 8;
+
+/// The overlapping triangles of the concave shape of a convex vs concave pair are cached for the AABB
+/// of the convex shape inflated by this percentage of its size. They are reused in the next frames
+/// while the AABB of the convex shape stays inside this inflated AABB
+constexpr decimal OVERLAPPING_TRIANGLES_CACHE_AABB_INFLATE_PERCENTAGE = decimal(0.2);
+
+/// Number of packets of four rays cast by a single task when a batch of rays
+/// is split among several threads
+constexpr uint32 RAYCAST_BATCH_GRAIN_SIZE = 16;
+
 /// Current version of ReactPhysics3D
 const std::string RP3D_VERSION = std::string("0.8.0");
 
@@ -0,0 +1,172 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_DEFAULT_TASK_SCHEDULER_H
+#define REACTPHYSICS3D_DEFAULT_TASK_SCHEDULER_H
+
+// Libraries
+#include <reactphysics3d/engine/TaskScheduler.h>
+#include <reactphysics3d/memory/MemoryAllocator.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Class DefaultTaskScheduler
+/**
+ * This class is the default task scheduler of the library. It is a pool of worker
+ * threads with one queue of chunks per thread. When a range of items is submitted,
+ * the chunks are evenly distributed among the queues of the threads (the calling thread
+ * takes part in the work). A thread that has emptied its own queue steals chunks from
+ * the end of the queues of the other threads.
+ */
+class DefaultTaskScheduler : public TaskScheduler {
+
+    private:
+
+        /// Queue of chunks of a thread. The chunks are stored as a contiguous range [start, end)
+        /// of chunk indices. Each queue is padded to a cache line to avoid false sharing
+        struct alignas(CACHE_LINE_SIZE) WorkerQueue {
+
+            /// Mutex to protect the queue
+            std::mutex mutex;
+
+            /// Index of the first chunk of the queue
+            uint32 start = 0;
+
+            /// Index after the last chunk of the queue
+            uint32 end = 0;
+        };
+
+        /// Synchronization objects shared by all the threads
+        struct alignas(CACHE_LINE_SIZE) SharedState {
+
+            /// Mutex used to submit a single range of items at a time
+            std::mutex submitMutex;
+
+            /// Mutex used to wake up the worker threads
+            std::mutex wakeMutex;
+
+            /// Condition variable used to wake up the worker threads
+            std::condition_variable wakeCondition;
+
+            /// Mutex used to wait for the end of the current range
+            std::mutex doneMutex;
+
+            /// Condition variable used to wait for the end of the current range
+            std::condition_variable doneCondition;
+
+            /// Number of chunks of the current range that have not been executed yet
+            std::atomic<uint32> nbRemainingChunks;
+
+            /// Constructor
+            SharedState() : nbRemainingChunks(0) {
+
+            }
+        };
+
+        // -------------------- Attributes -------------------- //
+
+        /// Memory allocator
+        MemoryAllocator& mAllocator;
+
+        /// Number of threads (including the calling thread)
+        uint32 mNbThreads;
+
+        /// Memory allocated for the shared state and the queues (before its alignment on a cache line)
+        void* mAlignedMemory;
+
+        /// Size (in bytes) of the memory allocated for the shared state and the queues
+        size_t mAlignedMemorySize;
+
+        /// Synchronization objects shared by all the threads (aligned on a cache line)
+        SharedState* mSharedState;
+
+        /// Array with the queue of each thread (the first one is the queue of the calling thread)
+        WorkerQueue* mQueues;
+
+        /// Array with the worker threads (mNbThreads - 1 threads)
+        std::thread* mThreads;
+
+        /// Index of the current range (incremented each time a new range is submitted)
+        uint64 mRangeIndex;
+
+        /// True if the worker threads have to stop
+        bool mIsStopping;
+
+        /// Task of the current range
+        const RangeTask* mTask;
+
+        /// Number of items of the current range
+        uint32 mNbItems;
+
+        /// Number of items per chunk of the current range
+        uint32 mGrainSize;
+
+        // -------------------- Methods -------------------- //
+
+        /// Main loop of a worker thread
+        void runWorkerThread(uint32 threadIndex);
+
+        /// Execute the chunks of the queue of a thread and steal chunks from the other threads
+        void executeChunks(uint32 threadIndex);
+
+        /// Pop the next chunk to execute for a given thread. Return false if there are no more chunks
+        bool popChunk(uint32 threadIndex, uint32& chunkIndex);
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        DefaultTaskScheduler(MemoryAllocator& allocator, uint32 nbThreads = 0);
+
+        /// Destructor
+        virtual ~DefaultTaskScheduler() override;
+
+        /// Deleted copy-constructor
+        DefaultTaskScheduler(const DefaultTaskScheduler& scheduler) = delete;
+
+        /// Deleted assignment operator
+        DefaultTaskScheduler& operator=(const DefaultTaskScheduler& scheduler) = delete;
+
+        /// Return the number of threads that can execute tasks (including the calling thread)
+        virtual uint32 getNbThreads() const override;
+
+        /// Execute a task over the items [0, nbItems) split into chunks of (at most) grainSize items
+        virtual void parallelFor(uint32 nbItems, uint32 grainSize, const RangeTask& task) override;
+};
+
+// Return the number of threads that can execute tasks (including the calling thread)
+inline uint32 DefaultTaskScheduler::getNbThreads() const {
+    return mNbThreads;
+}
+
+}
+
+#endif
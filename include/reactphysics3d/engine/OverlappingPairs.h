@@ -28,6 +28,7 @@
 
 // Libraries
 #include <reactphysics3d/collision/Collider.h>
+#include <reactphysics3d/collision/shapes/AABB.h>
 #include <reactphysics3d/containers/Map.h>
 #include <reactphysics3d/containers/Pair.h>
 #include <reactphysics3d/containers/Set.h>
@@ -47,6 +48,39 @@ enum class NarrowPhaseAlgorithmType;
 class CollisionShape;
 class CollisionDispatch;
 
+// Structure CachedContactPoints
+/**
+ * This structure contains the contact points of the last narrow-phase test of a convex vs
+ * convex pair of shapes. They are re-projected in the next frames instead of running the test
+ * again while the relative pose of the two shapes barely changes. This structure is only
+ * allocated for the pairs whose contact points have been cached.
+ */
+struct CachedContactPoints {
+
+    /// Number of cached contact points
+    uint8 nbContactPoints;
+
+    /// Transform from the local-space of the second shape to the local-space of the first shape at the last narrow-phase test
+    Transform shape2ToShape1Transform;
+
+    /// Cached contact normals (in the local-space of the first shape)
+    Vector3 contactNormals[NB_MAX_CACHED_CONTACT_POINTS];
+
+    /// Cached contact points (in the local-space of the first shape)
+    Vector3 localPoints1[NB_MAX_CACHED_CONTACT_POINTS];
+
+    /// Cached contact points (in the local-space of the second shape)
+    Vector3 localPoints2[NB_MAX_CACHED_CONTACT_POINTS];
+
+    /// Cached penetration depths of the contact points
+    decimal penetrationDepths[NB_MAX_CACHED_CONTACT_POINTS];
+
+    /// Constructor
+    CachedContactPoints() : nbContactPoints(0) {
+
+    }
+};
+
 // Structure LastFrameCollisionInfo
 /**
  * This structure contains collision info about the last frame.
@@ -74,6 +108,12 @@ struct LastFrameCollisionInfo {
     /// Previous separating axis
     Vector3 gjkSeparatingAxis;
 
+    /// Index of the previous support vertex of the first shape (start of the next support search)
+    uint gjkSupportVertexIndex1;
+
+    /// Index of the previous support vertex of the second shape (start of the next support search)
+    uint gjkSupportVertexIndex2;
+
     // SAT Algorithm
     bool satIsAxisFacePolyhedron1;
     bool satIsAxisFacePolyhedron2;
@@ -81,6 +121,17 @@ struct LastFrameCollisionInfo {
     uint satMinEdge1Index;
     uint satMinEdge2Index;
 
+    // ----- Contact points cache -----
+
+    /// True if the contact points of the last narrow-phase test of the two shapes are cached
+    bool hasCachedContactPoints;
+
+    /// True if the cached contact points are reused in the current frame instead of running the narrow-phase test
+    bool isUsingCachedContactPoints;
+
+    /// Cached contact points (null if the contact points of the shapes have never been cached)
+    CachedContactPoints* cachedContactPoints;
+
     /// Constructor
     LastFrameCollisionInfo() {
 
@@ -91,6 +142,45 @@ struct LastFrameCollisionInfo {
         wasUsingGJK = false;
 
         gjkSeparatingAxis = Vector3(0, 1, 0);
+        gjkSupportVertexIndex1 = 0;
+        gjkSupportVertexIndex2 = 0;
+
+        hasCachedContactPoints = false;
+        isUsingCachedContactPoints = false;
+        cachedContactPoints = nullptr;
+    }
+};
+
+// Structure OverlappingTrianglesCache
+/**
+ * This structure contains the triangles of the concave shape of a convex vs concave
+ * overlapping pair that overlap with an AABB enclosing the convex shape. The middle-phase
+ * reuses them as long as the AABB of the convex shape stays inside the cached AABB.
+ */
+struct OverlappingTrianglesCache {
+
+    /// True if the cached triangles are valid
+    bool isValid;
+
+    /// AABB (in the local-space of the concave shape) used to compute the cached triangles
+    AABB aabb;
+
+    /// Version of the data of the concave shape when the cached triangles were computed
+    uint32 concaveShapeDataVersion;
+
+    /// Vertices of the cached triangles (in the local-space of the concave shape)
+    List<Vector3> triangleVertices;
+
+    /// Vertices normals of the cached triangles
+    List<Vector3> triangleVerticesNormals;
+
+    /// Shape ids of the cached triangles
+    List<uint> shapeIds;
+
+    /// Constructor
+    OverlappingTrianglesCache(MemoryAllocator& allocator)
+        : isValid(false), concaveShapeDataVersion(0), triangleVertices(allocator), triangleVerticesNormals(allocator), shapeIds(allocator) {
+
     }
 };
 
@@ -161,6 +251,9 @@ class OverlappingPairs {
         /// shape Ids of the two collision shapes.
         Map<uint64, LastFrameCollisionInfo*>* mLastFrameCollisionInfos;
 
+        /// Cache of the overlapping triangles of the convex vs concave pairs (null if not created yet)
+        OverlappingTrianglesCache** mOverlappingTrianglesCaches;
+
         /// True if we need to test if the convex vs convex overlapping pairs of shapes still overlap
         bool* mNeedToTestOverlap;
 
@@ -209,6 +302,12 @@ class OverlappingPairs {
         /// Compute the index where we need to insert the new pair
         uint64 prepareAddPair(bool isConvexVsConvex);
 
+        /// Destroy the cache of overlapping triangles of a pair (if any)
+        void destroyOverlappingTrianglesCache(uint64 pairIndex);
+
+        /// Destroy a last frame collision info and its cached contact points (if any)
+        void destroyLastFrameCollisionInfo(LastFrameCollisionInfo* lastFrameCollisionInfo);
+
         /// Destroy a pair at a given index
         void destroyPair(uint64 index);
 
@@ -276,6 +375,15 @@ class OverlappingPairs {
         /// Add a new last frame collision info if it does not exist for the given shapes already
         LastFrameCollisionInfo* addLastFrameInfoIfNecessary(uint64 pairIndex, uint32 shapeId1, uint32 shapeId2);
 
+        /// Add a new cache of overlapping triangles for a convex vs concave pair if it does not exist already
+        OverlappingTrianglesCache* addOverlappingTrianglesCacheIfNecessary(uint64 pairIndex);
+
+        /// Add the cached contact points of a last frame collision info if they do not exist already
+        CachedContactPoints* addCachedContactPointsIfNecessary(LastFrameCollisionInfo* lastFrameCollisionInfo);
+
+        /// Prevent the cached contact points of a given overlapping pair from being reused
+        void clearCachedContactPoints(uint64 pairId);
+
         /// Update whether a given overlapping pair is active or not
         void updateOverlappingPairIsActive(uint64 pairId);
 
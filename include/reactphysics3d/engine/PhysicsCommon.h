@@ -37,6 +37,7 @@
 #include <reactphysics3d/collision/shapes/ConcaveMeshShape.h>
 #include <reactphysics3d/collision/TriangleMesh.h>
 #include <reactphysics3d/utils/DefaultLogger.h>
+#include <reactphysics3d/engine/DefaultTaskScheduler.h>
 
 /// ReactPhysics3D namespace
 namespace reactphysics3d {
@@ -92,6 +93,9 @@ class PhysicsCommon {
         /// Set of default loggers
         Set<DefaultLogger*> mDefaultLoggers;
 
+        /// Set of default task schedulers
+        Set<DefaultTaskScheduler*> mDefaultTaskSchedulers;
+
         // -------------------- Methods -------------------- //
 
         /// Destroy and release everything that has been allocated
@@ -158,7 +162,8 @@ class PhysicsCommon {
         void destroyHeightFieldShape(HeightFieldShape* heightFieldShape);
 
         /// Create and return a concave mesh shape
-        ConcaveMeshShape* createConcaveMeshShape(TriangleMesh* triangleMesh, const Vector3& scaling = Vector3(1, 1, 1));
+        ConcaveMeshShape* createConcaveMeshShape(TriangleMesh* triangleMesh, const Vector3& scaling = Vector3(1, 1, 1),
+                                                 TaskScheduler* taskScheduler = nullptr);
 
         /// Destroy a concave mesh shape
         void destroyConcaveMeshShape(ConcaveMeshShape* concaveMeshShape);
@@ -181,6 +186,12 @@ class PhysicsCommon {
         /// Destroy a default logger
         void destroyDefaultLogger(DefaultLogger* logger);
 
+        /// Create and return a new default task scheduler
+        DefaultTaskScheduler* createDefaultTaskScheduler(uint32 nbThreads = 0);
+
+        /// Destroy a default task scheduler
+        void destroyDefaultTaskScheduler(DefaultTaskScheduler* taskScheduler);
+
         /// Return the current logger
         static Logger* getLogger();
 
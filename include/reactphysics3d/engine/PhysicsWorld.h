@@ -50,6 +50,7 @@
 #include <reactphysics3d/systems/ContactSolverSystem.h>
 #include <reactphysics3d/systems/DynamicsSystem.h>
 #include <reactphysics3d/engine/Islands.h>
+#include <reactphysics3d/engine/TaskScheduler.h>
 #include <reactphysics3d/utils/DebugRenderer.h>
 #include <sstream>
 
@@ -124,6 +125,43 @@ class PhysicsWorld {
             /// than the value bellow, the manifold are considered to be similar.
             decimal cosAngleSimilarContactManifold;
 
+            /// Algorithm used by the broad-phase collision detection
+            BroadPhaseAlgorithmType broadPhaseAlgorithm;
+
+            /// Maximum number of internal nodes of the dynamic AABB tree of the broad-phase that are
+            /// optimized with rotations at each frame to avoid the decay of the tree after many
+            /// insertions and removals (zero to disable the optimization)
+            uint dynamicTreeOptimizationBudget;
+
+            /// True if the fat AABBs of the colliders in the broad-phase are extended in the direction
+            /// of the linear velocity of their body. This reduces the number of updates of the broad-phase
+            /// for fast moving bodies (projectiles, vehicles, ...)
+            bool isFatAABBVelocityPredictionEnabled;
+
+            /// Size of the cells of the hash grid broad-phase. If zero, the size of the cells is
+            /// computed from the average size of the colliders (only used by the hash grid algorithm)
+            decimal hashGridCellSize;
+
+            /// The contact points of a convex vs convex pair are re-projected from the last narrow-phase
+            /// test of the pair instead of running the test again while the relative translation of the
+            /// two colliders since this test is smaller than this distance (in meters). The reuse is only
+            /// enabled if both this threshold and narrowPhaseReuseAngularThreshold are positive (zero by default).
+            /// It saves the narrow-phase tests of resting bodies but the re-projected contact points are an
+            /// approximation: the contact normals and the contact features are the ones of the last test.
+            /// Therefore, the larger the threshold, the less accurate the contacts (keep it to a few millimeters)
+            decimal narrowPhaseReuseLinearThreshold;
+
+            /// The contact points of a convex vs convex pair are re-projected from the last narrow-phase
+            /// test of the pair instead of running the test again while the relative rotation of the
+            /// two colliders since this test is smaller than this angle (in radians). The reuse is only
+            /// enabled if both this threshold and narrowPhaseReuseLinearThreshold are positive (zero by default).
+            /// As for the linear threshold, it trades the accuracy of the contacts for speed (keep it to a fraction of degree)
+            decimal narrowPhaseReuseAngularThreshold;
+
+            /// Task scheduler used to split the simulation step among several threads. If null, the
+            /// simulation runs on the calling thread. The scheduler must outlive the physics world
+            TaskScheduler* taskScheduler;
+
             WorldSettings() {
 
                 worldName = "";
@@ -141,6 +179,13 @@ class PhysicsWorld {
                 defaultSleepAngularVelocity = decimal(3.0) * (PI / decimal(180.0));
                 nbMaxContactManifolds = 3;
                 cosAngleSimilarContactManifold = decimal(0.95);
+                broadPhaseAlgorithm = BroadPhaseAlgorithmType::DYNAMIC_AABB_TREE;
+                dynamicTreeOptimizationBudget = 32;
+                isFatAABBVelocityPredictionEnabled = false;
+                hashGridCellSize = decimal(0.0);
+                narrowPhaseReuseLinearThreshold = decimal(0.0);
+                narrowPhaseReuseAngularThreshold = decimal(0.0);
+                taskScheduler = nullptr;
 
             }
 
@@ -166,6 +211,14 @@ class PhysicsWorld {
                 ss << "defaultSleepAngularVelocity=" << defaultSleepAngularVelocity << std::endl;
                 ss << "nbMaxContactManifolds=" << nbMaxContactManifolds << std::endl;
                 ss << "cosAngleSimilarContactManifold=" << cosAngleSimilarContactManifold << std::endl;
+                ss << "broadPhaseAlgorithm=" << (broadPhaseAlgorithm == BroadPhaseAlgorithmType::SWEEP_AND_PRUNE ? "SweepAndPrune" :
+                                                 broadPhaseAlgorithm == BroadPhaseAlgorithmType::HASH_GRID ? "HashGrid" : "DynamicAABBTree") << std::endl;
+                ss << "dynamicTreeOptimizationBudget=" << dynamicTreeOptimizationBudget << std::endl;
+                ss << "isFatAABBVelocityPredictionEnabled=" << isFatAABBVelocityPredictionEnabled << std::endl;
+                ss << "hashGridCellSize=" << hashGridCellSize << std::endl;
+                ss << "narrowPhaseReuseLinearThreshold=" << narrowPhaseReuseLinearThreshold << std::endl;
+                ss << "narrowPhaseReuseAngularThreshold=" << narrowPhaseReuseAngularThreshold << std::endl;
+                ss << "taskSchedulerNbThreads=" << (taskScheduler != nullptr ? taskScheduler->getNbThreads() : 1) << std::endl;
 
                 return ss.str();
             }
@@ -326,6 +379,10 @@ class PhysicsWorld {
         /// Ray cast method
         void raycast(const Ray& ray, RaycastCallback* raycastCallback, unsigned short raycastWithCategoryMaskBits = 0xFFFF) const;
 
+        /// Ray cast method for a batch of rays that returns the closest hit of each ray
+        void raycast(const Ray* rays, uint32 nbRays, RaycastInfo* outRaycastInfos,
+                     unsigned short raycastWithCategoryMaskBits = 0xFFFF) const;
+
         /// Return true if two bodies overlap (collide)
         bool testOverlap(CollisionBody* body1, CollisionBody* body2);
 
@@ -350,6 +407,9 @@ class PhysicsWorld {
         /// Return the current world-space AABB of given collider
         AABB getWorldAABB(const Collider* collider) const;
 
+        /// Reorder the internal data of the broad-phase in memory to make the queries faster
+        void compactBroadPhase();
+
         /// Return the name of the world
         const std::string& getName() const;
 
@@ -512,6 +572,25 @@ inline void PhysicsWorld::raycast(const Ray& ray,
     mCollisionDetection.raycast(raycastCallback, ray, raycastWithCategoryMaskBits);
 }
 
+// Ray cast method for a batch of rays that returns the closest hit of each ray
+/// This method is faster than a raycast() call per ray when many rays are cast at the same
+/// time (line-of-sight tests, wheels of vehicles, ...). Groups of consecutive rays are cast
+/// together and the batch is split among the threads of the task scheduler of the world.
+/// You should give coherent rays (with similar origins and directions) next to each other
+/// in the array. The collider of the RaycastInfo object of a ray is null if the ray does
+/// not hit anything.
+/**
+ * @param rays Array with the rays to use for raycasting
+ * @param nbRays Number of rays in the array
+ * @param outRaycastInfos Array (with at least nbRays elements) where the closest hit of each ray is written
+ * @param raycastWithCategoryMaskBits Bits mask corresponding to the category of
+ *                                    bodies to be raycasted
+ */
+inline void PhysicsWorld::raycast(const Ray* rays, uint32 nbRays, RaycastInfo* outRaycastInfos,
+                                  unsigned short raycastWithCategoryMaskBits) const {
+    mCollisionDetection.raycast(rays, nbRays, outRaycastInfos, raycastWithCategoryMaskBits);
+}
+
 // Test collision and report contacts between two bodies.
 /// Use this method if you only want to get all the contacts between two bodies.
 /// All the contacts will be reported using the callback object in paramater.
@@ -0,0 +1,82 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_TASK_SCHEDULER_H
+#define REACTPHYSICS3D_TASK_SCHEDULER_H
+
+// Libraries
+#include <reactphysics3d/configuration.h>
+#include <functional>
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Class TaskScheduler
+/**
+ * This abstract class is the interface used by the library to run parts of the
+ * simulation step on several threads. A physics world that has a task scheduler
+ * in its settings splits the stages written over index ranges (velocity and
+ * position integration, update of the colliders, ...) into chunks that are
+ * executed by the scheduler. Each index of a range is always processed by a single
+ * task and writes only its own data. Therefore, the result of a simulation step does
+ * not depend on the number of threads. You can inherit from this class to plug the
+ * library into your own job system or use the DefaultTaskScheduler.
+ */
+class TaskScheduler {
+
+    public:
+
+        /// Task executed on a sub-range [startIndex, endIndex) of the items
+        using RangeTask = std::function<void(uint32 startIndex, uint32 endIndex)>;
+
+        /// Destructor
+        virtual ~TaskScheduler() = default;
+
+        /// Return the number of threads that can execute tasks (including the calling thread)
+        virtual uint32 getNbThreads() const=0;
+
+        /// Execute a task over the items [0, nbItems) split into chunks of (at most) grainSize items.
+        /// This method must only return once all the chunks have been executed. The chunks can be
+        /// executed in any order and on any thread (including the calling one).
+        virtual void parallelFor(uint32 nbItems, uint32 grainSize, const RangeTask& task)=0;
+};
+
+// Execute a task over the items [0, nbItems) with a task scheduler or on the calling thread
+// if there is no scheduler or not enough items to split the work
+inline void parallelFor(TaskScheduler* scheduler, uint32 nbItems, uint32 grainSize, const TaskScheduler::RangeTask& task) {
+
+    if (nbItems == 0) return;
+
+    if (scheduler != nullptr && nbItems > grainSize && scheduler->getNbThreads() > 1) {
+        scheduler->parallelFor(nbItems, grainSize, task);
+    }
+    else {
+        task(0, nbItems);
+    }
+}
+
+}
+
+#endif
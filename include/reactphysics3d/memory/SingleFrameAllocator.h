@@ -81,7 +81,7 @@ class SingleFrameAllocator : public MemoryAllocator {
         // -------------------- Methods -------------------- //
 
         /// Constructor
-        SingleFrameAllocator(MemoryAllocator& baseAllocator);
+        SingleFrameAllocator(MemoryAllocator& baseAllocator, size_t initAllocatedMemory = 0);
 
         /// Destructor
         virtual ~SingleFrameAllocator() override;
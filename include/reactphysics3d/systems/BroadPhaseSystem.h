@@ -23,16 +23,18 @@
 *                                                                               *
 ********************************************************************************/
 
-#ifndef REACTPHYSICS3D_BROAD_PHASE_ALGORITHM_H
-#define REACTPHYSICS3D_BROAD_PHASE_ALGORITHM_H
+#ifndef REACTPHYSICS3D_BROAD_PHASE_SYSTEM_H
+#define REACTPHYSICS3D_BROAD_PHASE_SYSTEM_H
 
 // Libraries
 #include <reactphysics3d/collision/broadphase/DynamicAABBTree.h>
+#include <reactphysics3d/collision/broadphase/BroadPhaseAlgorithm.h>
 #include <reactphysics3d/containers/LinkedList.h>
 #include <reactphysics3d/containers/Set.h>
 #include <reactphysics3d/components/ColliderComponents.h>
 #include <reactphysics3d/components/TransformComponents.h>
 #include <reactphysics3d/components/RigidBodyComponents.h>
+#include <reactphysics3d/engine/TaskScheduler.h>
 #include <cstring>
 
 /// Namespace ReactPhysics3D
@@ -45,6 +47,7 @@ class CollisionBody;
 class Collider;
 class MemoryManager;
 class Profiler;
+struct RaycastBatchTest;
 
 // class AABBOverlapCallback
 class AABBOverlapCallback : public DynamicAABBTreeOverlapCallback {
@@ -73,7 +76,7 @@ class BroadPhaseRaycastCallback : public DynamicAABBTreeRaycastCallback {
 
     private :
 
-        const DynamicAABBTree& mDynamicAABBTree;
+        const BroadPhaseAlgorithm& mBroadPhaseAlgorithm;
 
         unsigned short mRaycastWithCategoryMaskBits;
 
@@ -82,9 +85,9 @@ class BroadPhaseRaycastCallback : public DynamicAABBTreeRaycastCallback {
     public:
 
         // Constructor
-        BroadPhaseRaycastCallback(const DynamicAABBTree& dynamicAABBTree, unsigned short raycastWithCategoryMaskBits,
+        BroadPhaseRaycastCallback(const BroadPhaseAlgorithm& broadPhaseAlgorithm, unsigned short raycastWithCategoryMaskBits,
                                   RaycastTest& raycastTest)
-            : mDynamicAABBTree(dynamicAABBTree), mRaycastWithCategoryMaskBits(raycastWithCategoryMaskBits),
+            : mBroadPhaseAlgorithm(broadPhaseAlgorithm), mRaycastWithCategoryMaskBits(raycastWithCategoryMaskBits),
               mRaycastTest(raycastTest) {
 
         }
@@ -97,22 +100,100 @@ class BroadPhaseRaycastCallback : public DynamicAABBTreeRaycastCallback {
 
 };
 
+// Class BroadPhaseRayPacketCallback
+/**
+ * Callback called when the fat AABB of a collider is hit by some rays of a packet
+ * in the broad-phase.
+ */
+class BroadPhaseRayPacketCallback : public DynamicAABBTreeRayPacketCallback {
+
+    private :
+
+        const BroadPhaseAlgorithm& mBroadPhaseAlgorithm;
+
+        unsigned short mRaycastWithCategoryMaskBits;
+
+        RaycastBatchTest& mRaycastBatchTest;
+
+    public:
+
+        // Constructor
+        BroadPhaseRayPacketCallback(const BroadPhaseAlgorithm& broadPhaseAlgorithm, unsigned short raycastWithCategoryMaskBits,
+                                    RaycastBatchTest& raycastBatchTest)
+            : mBroadPhaseAlgorithm(broadPhaseAlgorithm), mRaycastWithCategoryMaskBits(raycastWithCategoryMaskBits),
+              mRaycastBatchTest(raycastBatchTest) {
+
+        }
+
+        // Destructor
+        virtual ~BroadPhaseRayPacketCallback() override = default;
+
+        // Called for a broad-phase shape that has to be tested for raycast by the rays of a packet in the bit mask
+        virtual void raycastBroadPhaseShape(int32 nodeId, RayPacket& packet, uint32 rayMask) override;
+
+};
+
 // Class BroadPhaseSystem
 /**
  * This class represents the broad-phase collision detection. The
  * goal of the broad-phase collision detection is to compute the pairs of colliders
  * that have their AABBs overlapping. Only those pairs of bodies will be tested
- * later for collision during the narrow-phase collision detection. A dynamic AABB
- * tree data structure is used for fast broad-phase collision detection.
+ * later for collision during the narrow-phase collision detection. The fat AABBs
+ * of the colliders are stored in a broad-phase algorithm (dynamic AABB tree or
+ * sweep-and-prune) selected in the settings of the world.
  */
 class BroadPhaseSystem {
 
     protected :
 
+        // -------------------- Constants -------------------- //
+
+        /// Number of colliders whose AABBs are computed together by the batch kernels
+        static constexpr uint32 COLLIDERS_AABBS_BATCH_SIZE = 64;
+
+        // -------------------- Structures -------------------- //
+
+        /// Structure of arrays with the world-space data of the oriented boxes of a batch of colliders
+        /// (boxes and bounding boxes of capsules). Each array is read or written by a loop without
+        /// branches over the boxes of the batch so that the compiler can vectorize it.
+        struct OrientedBoxesBatch {
+
+            uint32 indices[COLLIDERS_AABBS_BATCH_SIZE];
+            decimal positionsX[COLLIDERS_AABBS_BATCH_SIZE];
+            decimal positionsY[COLLIDERS_AABBS_BATCH_SIZE];
+            decimal positionsZ[COLLIDERS_AABBS_BATCH_SIZE];
+            decimal orientationsX[COLLIDERS_AABBS_BATCH_SIZE];
+            decimal orientationsY[COLLIDERS_AABBS_BATCH_SIZE];
+            decimal orientationsZ[COLLIDERS_AABBS_BATCH_SIZE];
+            decimal orientationsW[COLLIDERS_AABBS_BATCH_SIZE];
+            decimal halfExtentsX[COLLIDERS_AABBS_BATCH_SIZE];
+            decimal halfExtentsY[COLLIDERS_AABBS_BATCH_SIZE];
+            decimal halfExtentsZ[COLLIDERS_AABBS_BATCH_SIZE];
+            decimal extentsX[COLLIDERS_AABBS_BATCH_SIZE];
+            decimal extentsY[COLLIDERS_AABBS_BATCH_SIZE];
+            decimal extentsZ[COLLIDERS_AABBS_BATCH_SIZE];
+        };
+
+        /// Structure of arrays with the world-space data of the spheres of a batch of colliders
+        struct SpheresBatch {
+
+            uint32 indices[COLLIDERS_AABBS_BATCH_SIZE];
+            decimal positionsX[COLLIDERS_AABBS_BATCH_SIZE];
+            decimal positionsY[COLLIDERS_AABBS_BATCH_SIZE];
+            decimal positionsZ[COLLIDERS_AABBS_BATCH_SIZE];
+            decimal radiuses[COLLIDERS_AABBS_BATCH_SIZE];
+        };
+
         // -------------------- Attributes -------------------- //
 
-        /// Dynamic AABB tree
-        DynamicAABBTree mDynamicAABBTree;
+        /// Memory allocator used to allocate the broad-phase algorithm
+        MemoryAllocator& mAllocator;
+
+        /// Type of the broad-phase algorithm
+        BroadPhaseAlgorithmType mBroadPhaseAlgorithmType;
+
+        /// Broad-phase algorithm that stores the fat AABBs of the colliders
+        BroadPhaseAlgorithm* mBroadPhaseAlgorithm;
 
         /// Reference to the colliders components
         ColliderComponents& mCollidersComponents;
@@ -131,6 +212,19 @@ class BroadPhaseSystem {
         /// Reference to the collision detection object
         CollisionDetectionSystem& mCollisionDetection;
 
+        /// True if the fat AABBs of the colliders of moving rigid bodies are extended in the
+        /// direction of their linear velocity
+        bool mIsFatAABBVelocityPredictionEnabled;
+
+        /// Task scheduler used to split the update of the colliders among several threads (null if single-threaded)
+        TaskScheduler* mTaskScheduler;
+
+        /// World-space AABBs of the colliders computed during the last update of the colliders
+        List<AABB> mCollidersAABBs;
+
+        /// For each collider of the last update, true if its AABB is not inside its fat AABB anymore
+        List<bool> mHaveCollidersLeftFatAABB;
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
 		/// Pointer to the profiler
@@ -139,23 +233,39 @@ class BroadPhaseSystem {
 #endif
         // -------------------- Methods -------------------- //
 
-        /// Notify the Dynamic AABB tree that a collider needs to be updated
+        /// Notify the broad-phase algorithm that a collider needs to be updated
         void updateColliderInternal(int32 broadPhaseId, Collider* collider, const AABB& aabb,
+                                    const Vector3& displacement, decimal fatAABBInflatePercentage,
                                     bool forceReInsert);
 
+        /// Return true if a collider belongs to a static body
+        bool isColliderStatic(const Collider* collider) const;
+
         /// Update the broad-phase state of some colliders components
         void updateCollidersComponents(uint32 startIndex, uint32 nbItems, decimal timeStep);
 
+        /// Compute the world-space AABBs of a range of colliders components
+        void computeCollidersAABBs(uint32 startIndex, uint32 endIndex, AABB* outAABBs) const;
+
+        /// Compute the world-space AABBs of the oriented boxes of a batch of colliders
+        static void computeOrientedBoxesAABBs(OrientedBoxesBatch& boxes, uint32 nbBoxes, AABB* outAABBs);
+
+        /// Compute the world-space AABBs of the spheres of a batch of colliders
+        static void computeSpheresAABBs(const SpheresBatch& spheres, uint32 nbSpheres, AABB* outAABBs);
+
     public :
 
         // -------------------- Methods -------------------- //
 
         /// Constructor
         BroadPhaseSystem(CollisionDetectionSystem& collisionDetection, ColliderComponents& collidersComponents,
-                         TransformComponents& transformComponents, RigidBodyComponents& rigidBodyComponents);
+                         TransformComponents& transformComponents, RigidBodyComponents& rigidBodyComponents,
+                         BroadPhaseAlgorithmType broadPhaseAlgorithmType = BroadPhaseAlgorithmType::DYNAMIC_AABB_TREE,
+                         uint32 dynamicTreeOptimizationBudget = 0, TaskScheduler* taskScheduler = nullptr,
+                         bool isFatAABBVelocityPredictionEnabled = false, decimal hashGridCellSize = decimal(0.0));
 
         /// Destructor
-        ~BroadPhaseSystem() = default;
+        ~BroadPhaseSystem();
 
         /// Deleted copy-constructor
         BroadPhaseSystem(const BroadPhaseSystem& algorithm) = delete;
@@ -169,6 +279,12 @@ class BroadPhaseSystem {
         /// Remove a collider from the broad-phase collision detection
         void removeCollider(Collider* collider);
 
+        /// Update the broad-phase state of a collider after the type of its body has changed
+        void updateColliderBodyType(Collider* collider);
+
+        /// Reorder the internal data of the broad-phase in memory to make the queries more cache friendly
+        void compact();
+
         /// Update the broad-phase state of a single collider
         void updateCollider(Entity colliderEntity, decimal timeStep);
 
@@ -198,6 +314,10 @@ class BroadPhaseSystem {
         /// Ray casting method
         void raycast(const Ray& ray, RaycastTest& raycastTest, unsigned short raycastWithCategoryMaskBits) const;
 
+        /// Ray cast the rays of a packet against the colliders of the broad-phase
+        void raycast(RayPacket& packet, Stack<int32>& stack, RaycastBatchTest& raycastBatchTest,
+                     unsigned short raycastWithCategoryMaskBits) const;
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
 		/// Set the profiler
@@ -207,9 +327,14 @@ class BroadPhaseSystem {
 
 };
 
+// Reorder the internal data of the broad-phase in memory to make the queries more cache friendly
+inline void BroadPhaseSystem::compact() {
+    mBroadPhaseAlgorithm->compact();
+}
+
 // Return the fat AABB of a given broad-phase shape
 inline const AABB& BroadPhaseSystem::getFatAABB(int broadPhaseId) const  {
-    return mDynamicAABBTree.getFatAABB(broadPhaseId);
+    return mBroadPhaseAlgorithm->getFatAABB(broadPhaseId);
 }
 
 // Remove a collider from the array of colliders that have moved in the last simulation step
@@ -222,7 +347,7 @@ inline void BroadPhaseSystem::removeMovedCollider(int broadPhaseID) {
 
 // Return the collider corresponding to the broad-phase node id in parameter
 inline Collider* BroadPhaseSystem::getColliderForBroadPhaseId(int broadPhaseId) const {
-    return static_cast<Collider*>(mDynamicAABBTree.getNodeDataPointer(broadPhaseId));
+    return static_cast<Collider*>(mBroadPhaseAlgorithm->getObjectData(broadPhaseId));
 }
 
 #ifdef IS_RP3D_PROFILING_ENABLED
@@ -230,7 +355,7 @@ inline Collider* BroadPhaseSystem::getColliderForBroadPhaseId(int broadPhaseId)
 // Set the profiler
 inline void BroadPhaseSystem::setProfiler(Profiler* profiler) {
 	mProfiler = profiler;
-	mDynamicAABBTree.setProfiler(profiler);
+	mBroadPhaseAlgorithm->setProfiler(profiler);
 }
 
 #endif
@@ -43,6 +43,7 @@
 #include <reactphysics3d/containers/Set.h>
 #include <reactphysics3d/components/ColliderComponents.h>
 #include <reactphysics3d/components/TransformComponents.h>
+#include <reactphysics3d/engine/TaskScheduler.h>
 
 /// ReactPhysics3D namespace
 namespace reactphysics3d {
@@ -55,6 +56,7 @@ class RaycastCallback;
 class ContactPoint;
 class MemoryManager;
 class EventListener;
+class SingleFrameAllocator;
 class CollisionDispatch;
 
 // Class CollisionDetectionSystem
@@ -75,6 +77,14 @@ class CollisionDetectionSystem {
         /// Maximum number of contact points in a reduced contact manifold
         static const int8 MAX_CONTACT_POINTS_IN_MANIFOLD = 4;
 
+        /// Initial size (in bytes) of the single frame allocators of the narrow-phase tasks
+        static const size_t NARROW_PHASE_ALLOCATOR_INIT_NB_BYTES = 65536;
+
+        // -------------------- Types -------------------- //
+
+        /// Narrow-phase test of the objects [batchStartIndex, batchStartIndex + batchNbItems) of a batch
+        using NarrowPhaseBatchTest = std::function<bool(uint32 batchStartIndex, uint32 batchNbItems, MemoryAllocator& allocator)>;
+
         // -------------------- Attributes -------------------- //
 
         /// Memory manager
@@ -89,6 +99,9 @@ class CollisionDetectionSystem {
         /// Pointer to the physics world
         PhysicsWorld* mWorld;
 
+        /// Task scheduler used to split the work among several threads (null if single-threaded)
+        TaskScheduler* mTaskScheduler;
+
         /// Set of pair of bodies that cannot collide between each other
         Set<bodypair> mNoCollisionPairs;
 
@@ -104,6 +117,13 @@ class CollisionDetectionSystem {
         /// Narrow-phase collision detection input
         NarrowPhaseInput mNarrowPhaseInput;
 
+        /// Array of single frame allocators used by the tasks of the narrow-phase when it is
+        /// split among several threads (one allocator per task)
+        SingleFrameAllocator* mNarrowPhaseAllocators;
+
+        /// Number of single frame allocators of the narrow-phase tasks
+        uint32 mNbNarrowPhaseAllocators;
+
         /// List of the potential contact points
         List<ContactPointInfo> mPotentialContactPoints;
 
@@ -179,7 +199,17 @@ class CollisionDetectionSystem {
         void computeBroadPhase();
 
         /// Compute the middle-phase collision detection
-        void computeMiddlePhase(NarrowPhaseInput& narrowPhaseInput, bool needToReportContacts);
+        void computeMiddlePhase(NarrowPhaseInput& narrowPhaseInput, bool needToReportContacts, bool isCachedContactPointsReuseAllowed);
+
+        /// Return true if the cached contact points of two shapes can be reused with their current transforms
+        bool canReuseCachedContactPoints(const LastFrameCollisionInfo* lastFrameInfo, const Transform& shape1ToWorldTransform,
+                                         const Transform& shape2ToWorldTransform, decimal minCosHalfRotationAngle) const;
+
+        /// Cache the contact points of an object of a batch after its narrow-phase collision detection test
+        void cacheContactPoints(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchIndex);
+
+        /// Re-project the cached contact points of the objects of a batch with the current transforms of their shapes
+        static bool projectCachedContactPoints(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchStartIndex, uint batchNbItems);
 
         // Compute the middle-phase collision detection
         void computeMiddlePhaseCollisionSnapshot(List<uint64>& convexPairs, List<uint64>& concavePairs, NarrowPhaseInput& narrowPhaseInput,
@@ -213,6 +243,10 @@ class CollisionDetectionSystem {
         /// Execute the narrow-phase collision detection algorithm on batches
         bool testNarrowPhaseCollision(NarrowPhaseInput& narrowPhaseInput, bool clipWithPreviousAxisIfStillColliding, MemoryAllocator& allocator);
 
+        /// Execute a narrow-phase collision detection algorithm on a batch
+        bool testNarrowPhaseBatchCollision(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, MemoryAllocator& allocator,
+                                           const NarrowPhaseBatchTest& batchTest);
+
         /// Compute the concave vs convex middle-phase algorithm for a given pair of bodies
         void computeConvexVsConcaveMiddlePhase(uint64 pairIndex, MemoryAllocator& allocator,
                                                NarrowPhaseInput& narrowPhaseInput);
@@ -286,10 +320,13 @@ class CollisionDetectionSystem {
         /// Constructor
         CollisionDetectionSystem(PhysicsWorld* world, ColliderComponents& collidersComponents,
                            TransformComponents& transformComponents, CollisionBodyComponents& collisionBodyComponents, RigidBodyComponents& rigidBodyComponents,
-                           MemoryManager& memoryManager);
+                           MemoryManager& memoryManager, TaskScheduler* taskScheduler = nullptr,
+                           BroadPhaseAlgorithmType broadPhaseAlgorithmType = BroadPhaseAlgorithmType::DYNAMIC_AABB_TREE,
+                           uint32 dynamicTreeOptimizationBudget = 0, bool isFatAABBVelocityPredictionEnabled = false,
+                           decimal hashGridCellSize = decimal(0.0));
 
         /// Destructor
-        ~CollisionDetectionSystem() = default;
+        ~CollisionDetectionSystem();
 
         /// Deleted copy-constructor
         CollisionDetectionSystem(const CollisionDetectionSystem& collisionDetection) = delete;
@@ -321,9 +358,18 @@ class CollisionDetectionSystem {
         /// Ask for a collision shape to be tested again during broad-phase.
         void askForBroadPhaseCollisionCheck(Collider* collider);
 
+        /// Notify the broad-phase that the type of the body of a collider has changed
+        void updateColliderBodyType(Collider* collider);
+
+        /// Reorder the internal data of the broad-phase in memory to make the queries more cache friendly
+        void compactBroadPhase();
+
         /// Notify that the overlapping pairs where a given collider is involved need to be tested for overlap
         void notifyOverlappingPairsToTestOverlap(Collider* collider);
 
+        /// Prevent the cached contact points of the overlapping pairs of a given collider from being reused
+        void clearCachedContactPoints(Collider* collider);
+
         /// Report contacts and triggers
         void reportContactsAndTriggers();
 
@@ -334,6 +380,10 @@ class CollisionDetectionSystem {
         void raycast(RaycastCallback* raycastCallback, const Ray& ray,
                      unsigned short raycastWithCategoryMaskBits) const;
 
+        /// Ray casting method for a batch of rays that returns the closest hit of each ray
+        void raycast(const Ray* rays, uint32 nbRays, RaycastInfo* outRaycastInfos,
+                     unsigned short raycastWithCategoryMaskBits) const;
+
         /// Return true if two bodies (collide) overlap
         bool testOverlap(CollisionBody* body1, CollisionBody* body2);
 
@@ -418,6 +468,19 @@ inline void CollisionDetectionSystem::askForBroadPhaseCollisionCheck(Collider* c
     }
 }
 
+// Notify the broad-phase that the type of the body of a collider has changed
+inline void CollisionDetectionSystem::updateColliderBodyType(Collider* collider) {
+
+    if (collider->getBroadPhaseId() != -1) {
+        mBroadPhaseSystem.updateColliderBodyType(collider);
+    }
+}
+
+// Reorder the internal data of the broad-phase in memory to make the queries more cache friendly
+inline void CollisionDetectionSystem::compactBroadPhase() {
+    mBroadPhaseSystem.compact();
+}
+
 // Return a pointer to the world
 inline PhysicsWorld* CollisionDetectionSystem::getWorld() {
     return mWorld;
@@ -32,6 +32,7 @@
 #include <reactphysics3d/components/RigidBodyComponents.h>
 #include <reactphysics3d/components/TransformComponents.h>
 #include <reactphysics3d/components/ColliderComponents.h>
+#include <reactphysics3d/engine/TaskScheduler.h>
 
 namespace reactphysics3d {
 
@@ -69,6 +70,9 @@ class DynamicsSystem {
         /// Reference to the world gravity vector
         Vector3& mGravity;
 
+        /// Task scheduler used to split the work among several threads (null if single-threaded)
+        TaskScheduler* mTaskScheduler;
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
         /// Pointer to the profiler
@@ -82,7 +86,8 @@ class DynamicsSystem {
         /// Constructor
         DynamicsSystem(PhysicsWorld& world, CollisionBodyComponents& collisionBodyComponents,
                        RigidBodyComponents& rigidBodyComponents, TransformComponents& transformComponents,
-                       ColliderComponents& colliderComponents, bool& isGravityEnabled, Vector3& gravity);
+                       ColliderComponents& colliderComponents, bool& isGravityEnabled, Vector3& gravity,
+                       TaskScheduler* taskScheduler = nullptr);
 
         /// Destructor
         ~DynamicsSystem() = default;
@@ -109,6 +114,9 @@ class DynamicsSystem {
         /// Reset the split velocities of the bodies
         void resetSplitVelocities();
 
+        /// Reset the split velocities of the bodies in the range [startIndex, endIndex)
+        void resetSplitVelocities(uint32 startIndex, uint32 endIndex);
+
 };
 
 #ifdef IS_RP3D_PROFILING_ENABLED
@@ -398,6 +398,8 @@ class ProfileSample {
 
 
 // Use this macro to start profile a block of code
+// The profiler is not thread-safe. Therefore, this macro must not be used in a method that can
+// be executed by the tasks of the task scheduler (several threads at the same time).
 #define RP3D_PROFILE(name, profiler) ProfileSample profileSample(name, profiler)
 
 // Return true if we are at the root of the profiler tree
@@ -104,6 +104,12 @@ void RigidBody::setType(BodyType type) {
         mWorld.mRigidBodyComponents.setInverseInertiaTensorLocal(mEntity, inverseInertiaTensorLocal);
     }
 
+    // Move the colliders of the body into the static or non-static part of the broad-phase
+    const List<Entity>& colliderEntities = mWorld.mCollisionBodyComponents.getColliders(mEntity);
+    for (uint i=0; i < colliderEntities.size(); i++) {
+        mWorld.mCollisionDetection.updateColliderBodyType(mWorld.mCollidersComponents.getCollider(colliderEntities[i]));
+    }
+
     // Awake the body
     setIsSleeping(false);
 
@@ -27,6 +27,8 @@
 #include <reactphysics3d/collision/Collider.h>
 #include <reactphysics3d/utils/Logger.h>
 #include <reactphysics3d/collision/RaycastInfo.h>
+#include <reactphysics3d/collision/RayPacket.h>
+#include <reactphysics3d/collision/shapes/ConcaveMeshShape.h>
 #include <reactphysics3d/memory/MemoryManager.h>
 #include <reactphysics3d/engine/PhysicsWorld.h>
 #include <reactphysics3d/engine/PhysicsCommon.h>
@@ -196,6 +198,58 @@ bool Collider::raycast(const Ray& ray, RaycastInfo& raycastInfo) {
     return isHit;
 }
 
+// Raycast method for the rays of a packet in the bit mask
+/// The closest hit of each ray is written in the array of raycast infos (indexed by the rays
+/// of the packet) and the bit mask of the rays that hit the collider is returned. The rays of
+/// a concave mesh are cast as a packet through the tree of the mesh. This method is not profiled
+/// because it can be called by several threads at the same time.
+uint32 Collider::raycast(const RayPacket& packet, uint32 rayMask, RaycastInfo* outRaycastInfos) {
+
+    // If the corresponding body is not active, it cannot be hit by rays
+    if (!mBody->isActive()) return 0;
+
+    // Convert the rays into the local-space of the collision shape
+    const Transform localToWorldTransform = mBody->mWorld.mCollidersComponents.getLocalToWorldTransform(mEntity);
+    const Transform worldToLocalTransform = localToWorldTransform.getInverse();
+
+    const CollisionShape* collisionShape = mBody->mWorld.mCollidersComponents.getCollisionShape(mEntity);
+
+    uint32 hitMask = 0;
+    if (collisionShape->getName() == CollisionShapeName::TRIANGLE_MESH) {
+
+        const RayPacket localPacket(packet, rayMask, worldToLocalTransform, Vector3(1, 1, 1));
+        hitMask = static_cast<const ConcaveMeshShape*>(collisionShape)->raycast(localPacket, rayMask, outRaycastInfos, this,
+                                                                                mMemoryManager.getPoolAllocator());
+    }
+    else {
+
+        for (uint32 i=0; i < packet.nbRays; i++) {
+
+            if ((rayMask & (1u << i)) == 0) continue;
+
+            Ray rayLocal(worldToLocalTransform * packet.points1[i],
+                         worldToLocalTransform * packet.points2[i],
+                         packet.maxFractions[i]);
+
+            if (collisionShape->raycast(rayLocal, outRaycastInfos[i], this, mMemoryManager.getPoolAllocator())) {
+                hitMask |= 1u << i;
+            }
+        }
+    }
+
+    // Convert the raycast infos of the hit rays into world-space
+    for (uint32 i=0; i < packet.nbRays; i++) {
+
+        if ((hitMask & (1u << i)) == 0) continue;
+
+        outRaycastInfos[i].worldPoint = localToWorldTransform * outRaycastInfos[i].worldPoint;
+        outRaycastInfos[i].worldNormal = localToWorldTransform.getOrientation() * outRaycastInfos[i].worldNormal;
+        outRaycastInfos[i].worldNormal.normalize();
+    }
+
+    return hitMask;
+}
+
 // Return the collision category bits
 /**
  * @return The collision category bits mask of the collider
@@ -212,9 +266,50 @@ unsigned short Collider::getCollideWithMaskBits() const {
     return mBody->mWorld.mCollidersComponents.getCollideWithMaskBits(mEntity);
 }
 
+// Return the percentage used to inflate the fat AABB of the collider in the broad-phase
+/**
+ * @return The percentage of the size of the AABB used to inflate the fat AABB of the collider
+ *         or a negative value if the default percentage of the world is used
+ */
+decimal Collider::getFatAABBInflatePercentage() const {
+    return mBody->mWorld.mCollidersComponents.getFatAABBInflatePercentage(mEntity);
+}
+
+// Set the percentage used to inflate the fat AABB of the collider in the broad-phase
+/// A larger fat AABB is updated less often in the broad-phase when the collider moves but
+/// it also creates more overlapping pairs to test in the middle-phase. This can be used
+/// to give more margin to a fast moving collider (projectile, vehicle, ...).
+/**
+ * @param percentage The percentage of the size of the AABB used to inflate the fat AABB
+ *                   (a negative value to use the default percentage of the world)
+ */
+void Collider::setFatAABBInflatePercentage(decimal percentage) {
+
+    mBody->mWorld.mCollidersComponents.setFatAABBInflatePercentage(mEntity, percentage);
+
+    // If the collider is in the broad-phase (a collider that is not, for instance the collider of a
+    // disabled body, uses the new percentage when it is added to the broad-phase)
+    if (getBroadPhaseId() != -1) {
+
+        // Reset the fat AABB of the collider in the broad-phase with the new percentage
+        setHasCollisionShapeChangedSize(true);
+        mBody->mWorld.mCollisionDetection.updateCollider(mEntity, 0);
+    }
+
+    RP3D_LOG(mBody->mWorld.mConfig.worldName, Logger::Level::Information, Logger::Category::Collider,
+             "Collider " + std::to_string(getBroadPhaseId()) + ": Set fatAABBInflatePercentage=" +
+             std::to_string(percentage),  __FILE__, __LINE__);
+}
+
 // Notify the collider that the size of the collision shape has been changed by the user
 void Collider::setHasCollisionShapeChangedSize(bool hasCollisionShapeChangedSize) {
+
     mBody->mWorld.mCollidersComponents.setHasCollisionShapeChangedSize(mEntity, hasCollisionShapeChangedSize);
+
+    // The contact points cached with the previous size of the collision shape cannot be reused
+    if (hasCollisionShapeChangedSize) {
+        mBody->mWorld.mCollisionDetection.clearCachedContactPoints(this);
+    }
 }
 
 // Set a new material for this rigid body
@@ -28,6 +28,7 @@
 #include <reactphysics3d/memory/MemoryManager.h>
 #include <reactphysics3d/collision/PolygonVertexArray.h>
 #include <cstdlib>
+#include <algorithm>
 
 using namespace reactphysics3d;
 
@@ -39,7 +40,8 @@ using namespace reactphysics3d;
  */
 PolyhedronMesh::PolyhedronMesh(PolygonVertexArray* polygonVertexArray, MemoryAllocator &allocator)
                : mMemoryAllocator(allocator), mHalfEdgeStructure(allocator, polygonVertexArray->getNbFaces(), polygonVertexArray->getNbVertices(),
-                                    (polygonVertexArray->getNbFaces() + polygonVertexArray->getNbVertices() - 2) * 2) {
+                                    (polygonVertexArray->getNbFaces() + polygonVertexArray->getNbVertices() - 2) * 2),
+                 mNbMaxFaceVertices(0) {
 
    mPolygonVertexArray = polygonVertexArray;
 
@@ -54,6 +56,9 @@ PolyhedronMesh::PolyhedronMesh(PolygonVertexArray* polygonVertexArray, MemoryAll
 
    // Compute the centroid
    computeCentroid();
+
+   // Check if the vertex adjacency can be used to find the support vertices
+   computeIsStrictlyConvex();
 }
 
 // Destructor
@@ -84,6 +89,8 @@ void PolyhedronMesh::createHalfEdgeStructure() {
 
         assert(faceVertices.size() >= 3);
 
+        mNbMaxFaceVertices = std::max(mNbMaxFaceVertices, face->nbVertices);
+
         // Addd the face into the half-edge structure
         mHalfEdgeStructure.addFace(faceVertices);
     }
@@ -155,6 +162,40 @@ void PolyhedronMesh::computeCentroid() {
     mCentroid /= getNbVertices();
 }
 
+// Compute whether the edges of the half-edge structure are the edges of the convex hull
+/// If two adjacent faces are coplanar or if a vertex lies on a straight side of a face, a walk from
+/// vertex to vertex can stop at a vertex that is not the support vertex in a given direction
+void PolyhedronMesh::computeIsStrictlyConvex() {
+
+    const decimal epsilon = decimal(0.0001);
+
+    mIsStrictlyConvex = true;
+
+    // For each half-edge of the mesh
+    for (uint e=0; e < mHalfEdgeStructure.getNbHalfEdges(); e++) {
+
+        const HalfEdgeStructure::Edge& edge = mHalfEdgeStructure.getHalfEdge(e);
+        const HalfEdgeStructure::Edge& twinEdge = mHalfEdgeStructure.getHalfEdge(edge.twinEdgeIndex);
+        const HalfEdgeStructure::Edge& nextEdge = mHalfEdgeStructure.getHalfEdge(edge.nextEdgeIndex);
+        const HalfEdgeStructure::Edge& nextNextEdge = mHalfEdgeStructure.getHalfEdge(nextEdge.nextEdgeIndex);
+
+        // If the two faces adjacent to the edge are coplanar
+        if (getFaceNormal(edge.faceIndex).dot(getFaceNormal(twinEdge.faceIndex)) > decimal(1.0) - epsilon) {
+            mIsStrictlyConvex = false;
+            return;
+        }
+
+        // If the edge and the next edge of its face are collinear
+        const Vector3 edgeDirection = getVertex(nextEdge.vertexIndex) - getVertex(edge.vertexIndex);
+        const Vector3 nextEdgeDirection = getVertex(nextNextEdge.vertexIndex) - getVertex(nextEdge.vertexIndex);
+        if (edgeDirection.cross(nextEdgeDirection).lengthSquare() <=
+            epsilon * edgeDirection.lengthSquare() * nextEdgeDirection.lengthSquare()) {
+            mIsStrictlyConvex = false;
+            return;
+        }
+    }
+}
+
 // Compute and return the area of a face
 decimal PolyhedronMesh::getFaceArea(uint faceIndex) const {
 
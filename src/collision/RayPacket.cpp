@@ -0,0 +1,152 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+
+// Libraries
+#include <reactphysics3d/collision/RayPacket.h>
+#include <reactphysics3d/collision/shapes/AABB.h>
+#include <reactphysics3d/mathematics/Transform.h>
+
+// An AABB is tested against the four rays of a packet with SSE instructions
+// when they are available
+#ifdef RP3D_SSE_ENABLED
+    #include <xmmintrin.h>
+#endif
+
+using namespace reactphysics3d;
+
+// Static constants definitions
+const uint32 RayPacket::MAX_NB_RAYS;
+
+// Constructor
+/// The rays that are not given have a negative maximum fraction and are never hit.
+RayPacket::RayPacket(const Ray* rays, uint32 nbRays) : nbRays(nbRays) {
+
+    assert(nbRays > 0 && nbRays <= MAX_NB_RAYS);
+
+    for (uint32 i=0; i < MAX_NB_RAYS; i++) {
+
+        const Ray& ray = rays[i < nbRays ? i : 0];
+
+        points1[i] = ray.point1;
+        points2[i] = ray.point2;
+
+        // Compute the inverse of the ray direction (a large value is used for the
+        // null components to avoid the indeterminate form zero times infinity)
+        const Vector3 direction = ray.point2 - ray.point1;
+        originX[i] = ray.point1.x;
+        originY[i] = ray.point1.y;
+        originZ[i] = ray.point1.z;
+        inverseDirectionX[i] = direction.x != decimal(0.0) ? decimal(1.0) / direction.x : DECIMAL_LARGEST;
+        inverseDirectionY[i] = direction.y != decimal(0.0) ? decimal(1.0) / direction.y : DECIMAL_LARGEST;
+        inverseDirectionZ[i] = direction.z != decimal(0.0) ? decimal(1.0) / direction.z : DECIMAL_LARGEST;
+        maxFractions[i] = i < nbRays ? ray.maxFraction : decimal(-1.0);
+    }
+}
+
+// Constructor with the rays of another packet transformed and scaled into a local-space
+/// The points of the rays become scale * (transform * point). The rays of the other
+/// packet that are not in the mask are not hit in the new packet.
+RayPacket::RayPacket(const RayPacket& packet, uint32 rayMask, const Transform& transform, const Vector3& scale)
+          : nbRays(packet.nbRays) {
+
+    for (uint32 i=0; i < MAX_NB_RAYS; i++) {
+
+        points1[i] = (transform * packet.points1[i]) * scale;
+        points2[i] = (transform * packet.points2[i]) * scale;
+
+        const Vector3 direction = points2[i] - points1[i];
+        originX[i] = points1[i].x;
+        originY[i] = points1[i].y;
+        originZ[i] = points1[i].z;
+        inverseDirectionX[i] = direction.x != decimal(0.0) ? decimal(1.0) / direction.x : DECIMAL_LARGEST;
+        inverseDirectionY[i] = direction.y != decimal(0.0) ? decimal(1.0) / direction.y : DECIMAL_LARGEST;
+        inverseDirectionZ[i] = direction.z != decimal(0.0) ? decimal(1.0) / direction.z : DECIMAL_LARGEST;
+        maxFractions[i] = (rayMask & (1u << i)) != 0 ? packet.maxFractions[i] : decimal(-1.0);
+    }
+}
+
+// Return the bit mask of the rays of the packet that intersect an AABB
+/// This is the slab test of the AABB with each ray point1 + t * (point2 - point1) where
+/// t is in [0, maxFraction]. The fraction where each ray enters the AABB is also returned.
+uint32 RayPacket::testAABB(const Vector3& aabbMin, const Vector3& aabbMax, decimal* outEntryFractions) const {
+
+    // Tolerance to counteract arithmetic errors when a ray grazes the AABB
+    const decimal epsilon = decimal(0.00001);
+
+#ifdef RP3D_SSE_ENABLED
+
+    const __m128 originXs = _mm_loadu_ps(originX);
+    const __m128 originYs = _mm_loadu_ps(originY);
+    const __m128 originZs = _mm_loadu_ps(originZ);
+    const __m128 inverseDirectionXs = _mm_loadu_ps(inverseDirectionX);
+    const __m128 inverseDirectionYs = _mm_loadu_ps(inverseDirectionY);
+    const __m128 inverseDirectionZs = _mm_loadu_ps(inverseDirectionZ);
+
+    const __m128 t1X = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(aabbMin.x), originXs), inverseDirectionXs);
+    const __m128 t2X = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(aabbMax.x), originXs), inverseDirectionXs);
+    const __m128 t1Y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(aabbMin.y), originYs), inverseDirectionYs);
+    const __m128 t2Y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(aabbMax.y), originYs), inverseDirectionYs);
+    const __m128 t1Z = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(aabbMin.z), originZs), inverseDirectionZs);
+    const __m128 t2Z = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(aabbMax.z), originZs), inverseDirectionZs);
+
+    __m128 tMin = _mm_max_ps(_mm_max_ps(_mm_min_ps(t1X, t2X), _mm_min_ps(t1Y, t2Y)), _mm_min_ps(t1Z, t2Z));
+    __m128 tMax = _mm_min_ps(_mm_min_ps(_mm_max_ps(t1X, t2X), _mm_max_ps(t1Y, t2Y)), _mm_max_ps(t1Z, t2Z));
+    tMin = _mm_max_ps(tMin, _mm_setzero_ps());
+    tMax = _mm_add_ps(_mm_min_ps(tMax, _mm_loadu_ps(maxFractions)), _mm_set1_ps(epsilon));
+
+    _mm_storeu_ps(outEntryFractions, tMin);
+
+    return static_cast<uint32>(_mm_movemask_ps(_mm_cmple_ps(tMin, tMax)));
+
+#else
+
+    uint32 mask = 0;
+    for (uint32 i=0; i < MAX_NB_RAYS; i++) {
+
+        const decimal t1X = (aabbMin.x - originX[i]) * inverseDirectionX[i];
+        const decimal t2X = (aabbMax.x - originX[i]) * inverseDirectionX[i];
+        const decimal t1Y = (aabbMin.y - originY[i]) * inverseDirectionY[i];
+        const decimal t2Y = (aabbMax.y - originY[i]) * inverseDirectionY[i];
+        const decimal t1Z = (aabbMin.z - originZ[i]) * inverseDirectionZ[i];
+        const decimal t2Z = (aabbMax.z - originZ[i]) * inverseDirectionZ[i];
+
+        const decimal tMin = std::max(std::max(std::max(std::min(t1X, t2X), std::min(t1Y, t2Y)), std::min(t1Z, t2Z)), decimal(0.0));
+        const decimal tMax = std::min(std::min(std::min(std::max(t1X, t2X), std::max(t1Y, t2Y)), std::max(t1Z, t2Z)), maxFractions[i]);
+
+        outEntryFractions[i] = tMin;
+        mask |= static_cast<uint32>(tMin <= tMax + epsilon) << i;
+    }
+
+    return mask;
+
+#endif
+
+}
+
+// Return the bit mask of the rays of the packet that intersect an AABB
+uint32 RayPacket::testAABB(const AABB& aabb, decimal* outEntryFractions) const {
+    return testAABB(aabb.getMin(), aabb.getMax(), outEntryFractions);
+}
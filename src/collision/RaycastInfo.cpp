@@ -27,6 +27,7 @@
 #include <reactphysics3d/decimal.h>
 #include <reactphysics3d/collision/RaycastInfo.h>
 #include <reactphysics3d/collision/Collider.h>
+#include <reactphysics3d/collision/RayPacket.h>
 
 using namespace reactphysics3d;
 
@@ -47,3 +48,29 @@ decimal RaycastTest::raycastAgainstShape(Collider* shape, const Ray& ray) {
 
     return ray.maxFraction;
 }
+
+// Ray cast test of the rays of a packet in the bit mask against a collider
+/// The hits of the rays that are closer than their current closest hit replace it and the
+/// rays are clipped so that the next colliders are tested with shorter rays.
+void RaycastBatchTest::raycastAgainstShape(Collider* shape, RayPacket& packet, uint32 rayMask) {
+
+    // Ray casting test against the collision shape
+    RaycastInfo raycastInfos[RayPacket::MAX_NB_RAYS];
+    uint32 hitMask = shape->raycast(packet, rayMask, raycastInfos);
+
+    for (uint32 i=0; hitMask != 0; i++, hitMask >>= 1) {
+
+        if ((hitMask & 1) == 0 || raycastInfos[i].hitFraction > packet.maxFractions[i]) continue;
+
+        RaycastInfo& hit = hits[i];
+        hit.worldPoint = raycastInfos[i].worldPoint;
+        hit.worldNormal = raycastInfos[i].worldNormal;
+        hit.hitFraction = raycastInfos[i].hitFraction;
+        hit.meshSubpart = raycastInfos[i].meshSubpart;
+        hit.triangleIndex = raycastInfos[i].triangleIndex;
+        hit.body = raycastInfos[i].body;
+        hit.collider = raycastInfos[i].collider;
+
+        packet.clipRay(i, raycastInfos[i].hitFraction);
+    }
+}
@@ -26,8 +26,11 @@
 // Libraries
 #include <reactphysics3d/collision/broadphase/DynamicAABBTree.h>
 #include <reactphysics3d/systems/BroadPhaseSystem.h>
+#include <reactphysics3d/collision/RayPacket.h>
 #include <reactphysics3d/containers/Stack.h>
 #include <reactphysics3d/utils/Profiler.h>
+#include <reactphysics3d/engine/TaskScheduler.h>
+#include <algorithm>
 
 using namespace reactphysics3d;
 
@@ -52,6 +55,7 @@ DynamicAABBTree::~DynamicAABBTree() {
 void DynamicAABBTree::init() {
 
     mRootNodeID = TreeNode::NULL_TREE_NODE;
+    mOptimizationNodeID = 0;
     mNbNodes = 0;
     mNbAllocatedNodes = 8;
 
@@ -153,6 +157,372 @@ int32 DynamicAABBTree::addObjectInternal(const AABB& aabb) {
     return nodeID;
 }
 
+// Reorder the nodes of the tree in memory in depth-first order
+/// After many insertions and removals, the nodes are allocated from the free list and a node is
+/// usually far from its children in memory. This method moves the nodes so that the left child
+/// of a node is just after it in memory. The root node gets the ID zero. The IDs of the nodes
+/// change and therefore the new ID of each node is returned in the list outNewNodesIDs (indexed
+/// by the previous ID of the node with -1 for the free nodes) if it is not null.
+void DynamicAABBTree::compact(List<int32>* outNewNodesIDs) {
+
+    RP3D_PROFILE("DynamicAABBTree::compact()", mProfiler);
+
+    // Compute the new ID of each node in depth-first order
+    List<int32> newNodesIDs(mAllocator, static_cast<uint32>(mNbAllocatedNodes));
+    for (int32 i=0; i < mNbAllocatedNodes; i++) {
+        newNodesIDs.add(TreeNode::NULL_TREE_NODE);
+    }
+
+    int32 nbNodes = 0;
+    if (mRootNodeID != TreeNode::NULL_TREE_NODE) {
+
+        Stack<int32> stack(mAllocator, 64);
+        stack.push(mRootNodeID);
+        while (stack.size() > 0) {
+
+            const int32 nodeID = stack.pop();
+            newNodesIDs[nodeID] = nbNodes;
+            nbNodes++;
+
+            if (!mNodes[nodeID].isLeaf()) {
+                stack.push(mNodes[nodeID].children[1]);
+                stack.push(mNodes[nodeID].children[0]);
+            }
+        }
+    }
+
+    assert(nbNodes == mNbNodes);
+
+    // Copy the nodes into a new array with the new IDs
+    TreeNode* newNodes = static_cast<TreeNode*>(mAllocator.allocate(static_cast<size_t>(mNbAllocatedNodes) * sizeof(TreeNode)));
+    assert(newNodes);
+    for (int32 i=0; i < mNbAllocatedNodes; i++) {
+
+        const int32 newNodeID = newNodesIDs[i];
+        if (newNodeID == TreeNode::NULL_TREE_NODE) continue;
+
+        TreeNode& node = newNodes[newNodeID];
+        node = mNodes[i];
+        node.parentID = i == mRootNodeID ? TreeNode::NULL_TREE_NODE : newNodesIDs[mNodes[i].parentID];
+        if (!node.isLeaf()) {
+            node.children[0] = newNodesIDs[mNodes[i].children[0]];
+            node.children[1] = newNodesIDs[mNodes[i].children[1]];
+        }
+    }
+
+    // The free nodes are after the nodes of the tree
+    for (int32 i=mNbNodes; i < mNbAllocatedNodes; i++) {
+        newNodes[i].nextNodeID = i + 1 < mNbAllocatedNodes ? i + 1 : TreeNode::NULL_TREE_NODE;
+        newNodes[i].height = -1;
+    }
+    mFreeNodeID = mNbNodes < mNbAllocatedNodes ? mNbNodes : TreeNode::NULL_TREE_NODE;
+
+    mAllocator.release(mNodes, static_cast<size_t>(mNbAllocatedNodes) * sizeof(TreeNode));
+    mNodes = newNodes;
+    if (mRootNodeID != TreeNode::NULL_TREE_NODE) {
+        mRootNodeID = 0;
+    }
+    mOptimizationNodeID = 0;
+
+    if (outNewNodesIDs != nullptr) {
+        outNewNodesIDs->clear();
+        outNewNodesIDs->addRange(newNodesIDs);
+    }
+}
+
+// Build the whole tree from an array of objects in a single pass
+/// The tree must be empty. The tree is built top-down: each range of objects is split in
+/// two parts using the binned Surface Area Heuristic (SAH). This is much faster than inserting
+/// the objects one by one and gives a tree of better quality. If a task scheduler is given, the
+/// sub-trees are built in parallel. The resulting tree does not depend on the number of threads.
+/**
+ * @param objects Array with the AABB and the data of each object to insert into the tree
+ * @param outNodesIDs If not null, this list is filled with the node ID of each object
+ * @param taskScheduler Task scheduler used to build the sub-trees in parallel (can be null)
+ */
+void DynamicAABBTree::build(const List<DynamicAABBTreeObject>& objects, List<int32>* outNodesIDs,
+                            TaskScheduler* taskScheduler) {
+
+    RP3D_PROFILE("DynamicAABBTree::build()", mProfiler);
+
+    assert(mRootNodeID == TreeNode::NULL_TREE_NODE && mNbNodes == 0);
+
+    const uint32 nbObjects = static_cast<uint32>(objects.size());
+    if (nbObjects == 0) return;
+
+    // A binary tree with n leaves has 2n-1 nodes. The nodes of the sub-tree of a range
+    // of k objects are stored contiguously (depth-first order) in 2k-1 nodes.
+    const int32 nbTreeNodes = static_cast<int32>(2 * nbObjects - 1);
+    if (nbTreeNodes > mNbAllocatedNodes) {
+        mAllocator.release(mNodes, static_cast<size_t>(mNbAllocatedNodes) * sizeof(TreeNode));
+        mNbAllocatedNodes = nbTreeNodes;
+        mNodes = static_cast<TreeNode*>(mAllocator.allocate(static_cast<size_t>(mNbAllocatedNodes) * sizeof(TreeNode)));
+        assert(mNodes);
+    }
+
+    // Initialize the remaining free nodes
+    for (int32 i=nbTreeNodes; i < mNbAllocatedNodes - 1; i++) {
+        mNodes[i].nextNodeID = i + 1;
+        mNodes[i].height = -1;
+    }
+    if (nbTreeNodes < mNbAllocatedNodes) {
+        mNodes[mNbAllocatedNodes - 1].nextNodeID = TreeNode::NULL_TREE_NODE;
+        mNodes[mNbAllocatedNodes - 1].height = -1;
+        mFreeNodeID = nbTreeNodes;
+    }
+    else {
+        mFreeNodeID = TreeNode::NULL_TREE_NODE;
+    }
+    mNbNodes = nbTreeNodes;
+    mRootNodeID = 0;
+
+    // Allocate the temporary arrays
+    BuildArrays arrays;
+    arrays.objectsIndices = static_cast<uint32*>(mAllocator.allocate(nbObjects * sizeof(uint32)));
+    arrays.fatAABBs = static_cast<AABB*>(mAllocator.allocate(nbObjects * sizeof(AABB)));
+    arrays.centroids = static_cast<Vector3*>(mAllocator.allocate(nbObjects * sizeof(Vector3)));
+    arrays.nodesIDs = outNodesIDs != nullptr ? static_cast<int32*>(mAllocator.allocate(nbObjects * sizeof(int32))) : nullptr;
+
+    // Compute the fat AABBs of the objects (inflate the AABBs by a constant percentage of their size)
+    for (uint32 i=0; i < nbObjects; i++) {
+
+        const AABB& aabb = objects[i].aabb;
+        const Vector3 gap(aabb.getExtent() * mFatAABBInflatePercentage * decimal(0.5f));
+        new (arrays.fatAABBs + i) AABB(aabb.getMin() - gap, aabb.getMax() + gap);
+        new (arrays.centroids + i) Vector3(arrays.fatAABBs[i].getCenter());
+        arrays.objectsIndices[i] = i;
+    }
+
+    BuildRange rootRange;
+    rootRange.startIndex = 0;
+    rootRange.endIndex = nbObjects;
+    rootRange.nodeID = mRootNodeID;
+    rootRange.parentID = TreeNode::NULL_TREE_NODE;
+
+    // If the sub-trees can be built in parallel
+    if (taskScheduler != nullptr && taskScheduler->getNbThreads() > 1 && nbObjects > 2 * BUILD_TASK_MIN_NB_OBJECTS) {
+
+        // Build the top of the tree on the calling thread until the ranges are small enough
+        // to give a few ranges to each thread
+        uint32 maxRangeSize = nbObjects / (4 * taskScheduler->getNbThreads());
+        if (maxRangeSize < BUILD_TASK_MIN_NB_OBJECTS) maxRangeSize = BUILD_TASK_MIN_NB_OBJECTS;
+        List<BuildRange> pendingRanges(mAllocator);
+        buildRange(objects, arrays, rootRange, maxRangeSize, &pendingRanges);
+
+        // Build the sub-trees of the remaining ranges in parallel
+        taskScheduler->parallelFor(static_cast<uint32>(pendingRanges.size()), 1,
+                                   [this, &objects, &arrays, &pendingRanges](uint32 startIndex, uint32 endIndex) {
+
+            for (uint32 i=startIndex; i < endIndex; i++) {
+                buildRange(objects, arrays, pendingRanges[i], 0, nullptr);
+            }
+        });
+    }
+    else {
+        buildRange(objects, arrays, rootRange, 0, nullptr);
+    }
+
+    // Compute the AABBs and heights of the internal nodes. The children of a node always
+    // have larger IDs than the node itself, so we process the nodes in reverse order.
+    for (int32 nodeID = nbTreeNodes - 1; nodeID >= 0; nodeID--) {
+
+        TreeNode& node = mNodes[nodeID];
+        if (!node.isLeaf()) {
+
+            const TreeNode& leftChild = mNodes[node.children[0]];
+            const TreeNode& rightChild = mNodes[node.children[1]];
+            node.aabb.mergeTwoAABBs(leftChild.aabb, rightChild.aabb);
+            node.height = std::max(leftChild.height, rightChild.height) + 1;
+        }
+    }
+
+    // Report the node ID of each object
+    if (outNodesIDs != nullptr) {
+        outNodesIDs->clear();
+        outNodesIDs->reserve(nbObjects);
+        for (uint32 i=0; i < nbObjects; i++) {
+            outNodesIDs->add(arrays.nodesIDs[i]);
+        }
+        mAllocator.release(arrays.nodesIDs, nbObjects * sizeof(int32));
+    }
+
+    // Release the temporary arrays
+    mAllocator.release(arrays.objectsIndices, nbObjects * sizeof(uint32));
+    mAllocator.release(arrays.fatAABBs, nbObjects * sizeof(AABB));
+    mAllocator.release(arrays.centroids, nbObjects * sizeof(Vector3));
+}
+
+// Create the nodes of the sub-tree of a range of objects of a bulk-build
+/// If "outPendingRanges" is not null, the ranges with at most "maxRangeSize" objects are not
+/// built but added to this list instead (to be built later by another task). The AABBs and
+/// heights of the internal nodes are computed afterwards by the build() method.
+void DynamicAABBTree::buildRange(const List<DynamicAABBTreeObject>& objects, const BuildArrays& arrays,
+                                 const BuildRange& range, uint32 maxRangeSize, List<BuildRange>* outPendingRanges) {
+
+    Stack<BuildRange> stack(mAllocator, 64);
+    stack.push(range);
+
+    while (stack.size() > 0) {
+
+        const BuildRange currentRange = stack.pop();
+        const uint32 nbObjectsInRange = currentRange.endIndex - currentRange.startIndex;
+        assert(nbObjectsInRange > 0);
+
+        TreeNode& node = mNodes[currentRange.nodeID];
+        node.parentID = currentRange.parentID;
+
+        // If the range contains a single object, we create a leaf node
+        if (nbObjectsInRange == 1) {
+
+            const uint32 objectIndex = arrays.objectsIndices[currentRange.startIndex];
+            node.aabb = arrays.fatAABBs[objectIndex];
+            node.height = 0;
+            node.dataInt[0] = objects[objectIndex].dataInt[0];
+            node.dataInt[1] = objects[objectIndex].dataInt[1];
+            if (arrays.nodesIDs != nullptr) {
+                arrays.nodesIDs[objectIndex] = currentRange.nodeID;
+            }
+
+            continue;
+        }
+
+        // If the range is small enough to be built by another task
+        if (outPendingRanges != nullptr && nbObjectsInRange <= maxRangeSize) {
+            outPendingRanges->add(currentRange);
+            continue;
+        }
+
+        // Split the range in two parts
+        const uint32 splitIndex = splitBuildRange(arrays, currentRange);
+        assert(splitIndex > currentRange.startIndex && splitIndex < currentRange.endIndex);
+
+        // The left sub-tree directly follows the node and the right sub-tree follows the left one
+        BuildRange leftRange;
+        leftRange.startIndex = currentRange.startIndex;
+        leftRange.endIndex = splitIndex;
+        leftRange.nodeID = currentRange.nodeID + 1;
+        leftRange.parentID = currentRange.nodeID;
+
+        BuildRange rightRange;
+        rightRange.startIndex = splitIndex;
+        rightRange.endIndex = currentRange.endIndex;
+        rightRange.nodeID = currentRange.nodeID + static_cast<int32>(2 * (splitIndex - currentRange.startIndex));
+        rightRange.parentID = currentRange.nodeID;
+
+        // Internal node (its AABB and height are computed later)
+        node.children[0] = leftRange.nodeID;
+        node.children[1] = rightRange.nodeID;
+        node.height = 1;
+
+        stack.push(rightRange);
+        stack.push(leftRange);
+    }
+}
+
+// Split a range of objects of a bulk-build and return the index of the first object of the second part
+/// The centers of the AABBs of the objects are put into bins along each axis and we select the
+/// split between two bins with the smallest Surface Area Heuristic (SAH) cost.
+uint32 DynamicAABBTree::splitBuildRange(const BuildArrays& arrays, const BuildRange& range) const {
+
+    uint32* objectsIndices = arrays.objectsIndices;
+    const Vector3* centroids = arrays.centroids;
+
+    // Compute the bounds of the centers of the objects
+    Vector3 minCentroid = centroids[objectsIndices[range.startIndex]];
+    Vector3 maxCentroid = minCentroid;
+    for (uint32 i=range.startIndex + 1; i < range.endIndex; i++) {
+        minCentroid = Vector3::min(minCentroid, centroids[objectsIndices[i]]);
+        maxCentroid = Vector3::max(maxCentroid, centroids[objectsIndices[i]]);
+    }
+
+    decimal bestCost = DECIMAL_LARGEST;
+    int bestAxis = -1;
+    uint32 bestBin = 0;
+
+    AABB binsAABBs[NB_BUILD_BINS];
+    uint32 binsNbObjects[NB_BUILD_BINS];
+    decimal rightCosts[NB_BUILD_BINS];
+    uint32 rightNbObjects[NB_BUILD_BINS];
+
+    // For each axis
+    for (int axis=0; axis < 3; axis++) {
+
+        const decimal extent = maxCentroid[axis] - minCentroid[axis];
+        if (extent <= MACHINE_EPSILON) continue;
+
+        const decimal binFactor = decimal(NB_BUILD_BINS) / extent;
+
+        // Put the objects into the bins
+        for (uint32 b=0; b < NB_BUILD_BINS; b++) {
+            binsNbObjects[b] = 0;
+        }
+        for (uint32 i=range.startIndex; i < range.endIndex; i++) {
+
+            const uint32 objectIndex = objectsIndices[i];
+            const uint32 bin = std::min(static_cast<uint32>((centroids[objectIndex][axis] - minCentroid[axis]) * binFactor),
+                                        NB_BUILD_BINS - 1);
+            if (binsNbObjects[bin] == 0) {
+                binsAABBs[bin] = arrays.fatAABBs[objectIndex];
+            }
+            else {
+                binsAABBs[bin].mergeWithAABB(arrays.fatAABBs[objectIndex]);
+            }
+            binsNbObjects[bin]++;
+        }
+
+        // Compute the cost of the right part of each split (sweep from the right)
+        AABB rightAABB;
+        uint32 nbRight = 0;
+        for (uint32 b=NB_BUILD_BINS - 1; b > 0; b--) {
+            if (binsNbObjects[b] > 0) {
+                if (nbRight == 0) rightAABB = binsAABBs[b];
+                else rightAABB.mergeWithAABB(binsAABBs[b]);
+                nbRight += binsNbObjects[b];
+            }
+            rightNbObjects[b] = nbRight;
+            rightCosts[b] = nbRight > 0 ? rightAABB.getSurfaceArea() * decimal(nbRight) : decimal(0.0);
+        }
+
+        // Compute the cost of each split between bin b and bin b+1 (sweep from the left)
+        AABB leftAABB;
+        uint32 nbLeft = 0;
+        for (uint32 b=0; b < NB_BUILD_BINS - 1; b++) {
+            if (binsNbObjects[b] > 0) {
+                if (nbLeft == 0) leftAABB = binsAABBs[b];
+                else leftAABB.mergeWithAABB(binsAABBs[b]);
+                nbLeft += binsNbObjects[b];
+            }
+
+            if (nbLeft > 0 && rightNbObjects[b + 1] > 0) {
+
+                const decimal cost = leftAABB.getSurfaceArea() * decimal(nbLeft) + rightCosts[b + 1];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestBin = b;
+                }
+            }
+        }
+    }
+
+    // If all the objects have the same center, we split the range in the middle
+    if (bestAxis == -1) {
+        return range.startIndex + (range.endIndex - range.startIndex) / 2;
+    }
+
+    // Move the objects of the bins on the left of the split at the beginning of the range
+    const decimal binFactor = decimal(NB_BUILD_BINS) / (maxCentroid[bestAxis] - minCentroid[bestAxis]);
+    const decimal minCentroidAxis = minCentroid[bestAxis];
+    uint32* splitObject = std::partition(objectsIndices + range.startIndex, objectsIndices + range.endIndex,
+                                         [centroids, bestAxis, binFactor, minCentroidAxis, bestBin](uint32 objectIndex) {
+        const uint32 bin = std::min(static_cast<uint32>((centroids[objectIndex][bestAxis] - minCentroidAxis) * binFactor),
+                                    NB_BUILD_BINS - 1);
+        return bin <= bestBin;
+    });
+
+    return static_cast<uint32>(splitObject - objectsIndices);
+}
+
 // Remove an object from the tree
 void DynamicAABBTree::removeObject(int32 nodeID) {
 
@@ -171,7 +541,12 @@ void DynamicAABBTree::removeObject(int32 nodeID) {
 /// If the "forceReInsert" parameter is true, we force the existing AABB to take the size
 /// of the "newAABB" parameter even if it is larger than "newAABB". This can be used to shrink the
 /// AABB in the tree for instance if the corresponding collision shape has been shrunk.
-bool DynamicAABBTree::updateObject(int32 nodeID, const AABB& newAABB, bool forceReinsert) {
+/// When the node is reinserted, its fat AABB is the new AABB inflated by the "fatAABBInflatePercentage"
+/// percentage of its size and extended in the direction of the "displacement" vector (predicted motion
+/// of the object) so that an object moving at a constant velocity does not have to be reinserted at
+/// each frame.
+bool DynamicAABBTree::updateObject(int32 nodeID, const AABB& newAABB, const Vector3& displacement,
+                                   decimal fatAABBInflatePercentage, bool forceReinsert) {
 
     RP3D_PROFILE("DynamicAABBTree::updateObject()", mProfiler);
 
@@ -187,12 +562,15 @@ bool DynamicAABBTree::updateObject(int32 nodeID, const AABB& newAABB, bool force
     // If the new AABB is outside the fat AABB, we remove the corresponding node
     removeLeafNode(nodeID);
 
-    // Compute the fat AABB by inflating the AABB with by a constant percentage of the size of the AABB
+    // Compute the fat AABB by inflating the AABB with by a percentage of the size of the AABB
     mNodes[nodeID].aabb = newAABB;
-    const Vector3 gap(newAABB.getExtent() * mFatAABBInflatePercentage * decimal(0.5f));
+    const Vector3 gap(newAABB.getExtent() * fatAABBInflatePercentage * decimal(0.5f));
     mNodes[nodeID].aabb.mMinCoordinates -= gap;
     mNodes[nodeID].aabb.mMaxCoordinates += gap;
 
+    // Extend the fat AABB in the direction of the predicted motion of the object
+    mNodes[nodeID].aabb.extend(displacement);
+
     assert(mNodes[nodeID].aabb.contains(newAABB));
 
     // Reinsert the node into the tree
@@ -574,11 +952,11 @@ int32 DynamicAABBTree::balanceSubTreeAtNode(int32 nodeID) {
 }
 
 /// Take a list of shapes to be tested for broad-phase overlap and return a list of pair of overlapping shapes
+/// Only the nodes in the range [startIndex, endIndex) of the list are tested so that the
+/// ranges can be given to different tasks.
 void DynamicAABBTree::reportAllShapesOverlappingWithShapes(const List<int32>& nodesToTest, size_t startIndex,
                                                            size_t endIndex, List<Pair<int32, int32>>& outOverlappingNodes) const {
 
-    RP3D_PROFILE("DynamicAABBTree::reportAllShapesOverlappingWithAABB()", mProfiler);
-
     // Create a stack with the nodes to visit
     Stack<int32> stack(mAllocator, 64);
 
@@ -665,6 +1043,186 @@ void DynamicAABBTree::reportAllShapesOverlappingWithAABB(const AABB& aabb, List<
     }
 }
 
+// Report all shapes overlapping with an AABB as pairs of an object ID and the first data integer of the node
+/// The stack used for the traversal is given by the caller so that it can be reused between queries
+/// and so that each task of a parallel query uses its own stack.
+void DynamicAABBTree::reportAllShapesOverlappingWithAABB(const AABB& aabb, int32 objectId, Stack<int32>& stack,
+                                                         List<Pair<int32, int32>>& outOverlappingPairs) const {
+
+    assert(stack.size() == 0);
+
+    stack.push(mRootNodeID);
+
+    // While there are still nodes to visit
+    while(stack.size() > 0) {
+
+        // Get the next node ID to visit
+        const int32 nodeIDToVisit = stack.pop();
+
+        // Skip it if it is a null node
+        if (nodeIDToVisit == TreeNode::NULL_TREE_NODE) continue;
+
+        // Get the corresponding node
+        const TreeNode* nodeToVisit = mNodes + nodeIDToVisit;
+
+        // If the AABB in parameter overlaps with the AABB of the node to visit
+        if (aabb.testCollision(nodeToVisit->aabb)) {
+
+            // If the node is a leaf
+            if (nodeToVisit->isLeaf()) {
+
+                // Add the pair with the data of the node
+                outOverlappingPairs.add(Pair<int32, int32>(objectId, nodeToVisit->dataInt[0]));
+            }
+            else {  // If the node is not a leaf
+
+                // We need to visit its children
+                stack.push(nodeToVisit->children[0]);
+                stack.push(nodeToVisit->children[1]);
+            }
+        }
+    }
+}
+
+// Compute the pairs of nodes to visit after a pair of nodes during a tree-vs-tree traversal
+/// A pair with twice the same node of the same tree is replaced by the pairs of its children
+/// with themselves and with each other. Otherwise, if the AABBs of the two nodes overlap,
+/// the node with the largest AABB is replaced by its children. The number of pairs written
+/// in the two output arrays (at most three) is returned.
+uint32 DynamicAABBTree::computeChildrenNodePairs(const DynamicAABBTree& otherTree, const Pair<int32, int32>& nodePair,
+                                                 int32* outNodesIDs, int32* outOtherNodesIDs) const {
+
+    const TreeNode& node = mNodes[nodePair.first];
+    const TreeNode& otherNode = otherTree.mNodes[nodePair.second];
+
+    // If this is the same node of the same tree (self-collision of its sub-tree)
+    if (&otherTree == this && nodePair.first == nodePair.second) {
+
+        if (node.isLeaf()) return 0;
+
+        outNodesIDs[0] = node.children[0];
+        outOtherNodesIDs[0] = node.children[0];
+        outNodesIDs[1] = node.children[1];
+        outOtherNodesIDs[1] = node.children[1];
+        outNodesIDs[2] = node.children[0];
+        outOtherNodesIDs[2] = node.children[1];
+
+        return 3;
+    }
+
+    if ((node.isLeaf() && otherNode.isLeaf()) || !node.aabb.testCollision(otherNode.aabb)) return 0;
+
+    // Descend into the node with the largest AABB
+    if (otherNode.isLeaf() || (!node.isLeaf() && node.aabb.getSurfaceArea() >= otherNode.aabb.getSurfaceArea())) {
+        outNodesIDs[0] = node.children[0];
+        outNodesIDs[1] = node.children[1];
+        outOtherNodesIDs[0] = outOtherNodesIDs[1] = nodePair.second;
+    }
+    else {
+        outNodesIDs[0] = outNodesIDs[1] = nodePair.first;
+        outOtherNodesIDs[0] = otherNode.children[0];
+        outOtherNodesIDs[1] = otherNode.children[1];
+    }
+
+    return 2;
+}
+
+// Report the pairs of leaves with overlapping AABBs in this tree and another tree (or in this tree only)
+/// The two trees are traversed together from their roots which is much faster than querying one tree
+/// with each leaf of the other tree when most of the leaves must be tested. If the other tree is this
+/// tree, each pair of overlapping leaves of the tree is reported once. The pairs contain the first
+/// data integer of the leaf of this tree and of the leaf of the other tree. The stack used for the
+/// traversal is given by the caller so that it can be reused.
+void DynamicAABBTree::reportAllOverlappingLeaves(const DynamicAABBTree& otherTree, Stack<Pair<int32, int32>>& stack,
+                                                 List<Pair<int32, int32>>& outOverlappingPairs) const {
+
+    if (mRootNodeID == TreeNode::NULL_TREE_NODE || otherTree.mRootNodeID == TreeNode::NULL_TREE_NODE) return;
+
+    reportOverlappingLeaves(otherTree, Pair<int32, int32>(mRootNodeID, otherTree.mRootNodeID), stack, outOverlappingPairs);
+}
+
+// Report the pairs of leaves with overlapping AABBs below a pair of nodes of this tree and another tree
+/// The pairs of nodes whose AABBs overlap are pushed on the stack until both nodes are leaves.
+void DynamicAABBTree::reportOverlappingLeaves(const DynamicAABBTree& otherTree, const Pair<int32, int32>& nodePair,
+                                              Stack<Pair<int32, int32>>& stack, List<Pair<int32, int32>>& outOverlappingPairs) const {
+
+    assert(stack.size() == 0);
+
+    stack.push(nodePair);
+
+    // While there are still pairs of nodes to visit
+    while (stack.size() > 0) {
+
+        const Pair<int32, int32> pairToVisit = stack.pop();
+
+        const TreeNode& node = mNodes[pairToVisit.first];
+        const TreeNode& otherNode = otherTree.mNodes[pairToVisit.second];
+
+        // If the two nodes are leaves (and not the same leaf)
+        if (node.isLeaf() && otherNode.isLeaf()) {
+
+            if ((&otherTree != this || pairToVisit.first != pairToVisit.second) && node.aabb.testCollision(otherNode.aabb)) {
+                outOverlappingPairs.add(Pair<int32, int32>(node.dataInt[0], otherNode.dataInt[0]));
+            }
+
+            continue;
+        }
+
+        // Visit the pairs of children
+        int32 childrenIDs[3];
+        int32 otherChildrenIDs[3];
+        const uint32 nbChildrenPairs = computeChildrenNodePairs(otherTree, pairToVisit, childrenIDs, otherChildrenIDs);
+        for (uint32 i=0; i < nbChildrenPairs; i++) {
+            stack.push(Pair<int32, int32>(childrenIDs[i], otherChildrenIDs[i]));
+        }
+    }
+}
+
+// Split the traversal of this tree and another tree into pairs of nodes that can be traversed independently
+/// The pairs of nodes are replaced by the pairs of their children one level at a time until there are
+/// at least a given number of pairs. The pairs of leaves with overlapping AABBs below all the output
+/// pairs of nodes are the pairs reported by reportAllOverlappingLeaves() and each one of them is below
+/// a single output pair. This is used to split the traversal among several threads.
+void DynamicAABBTree::splitTreeVsTreeTraversal(const DynamicAABBTree& otherTree, uint32 minNbNodePairs,
+                                               List<Pair<int32, int32>>& outNodePairs) const {
+
+    outNodePairs.clear();
+
+    if (mRootNodeID == TreeNode::NULL_TREE_NODE || otherTree.mRootNodeID == TreeNode::NULL_TREE_NODE) return;
+
+    outNodePairs.add(Pair<int32, int32>(mRootNodeID, otherTree.mRootNodeID));
+
+    List<Pair<int32, int32>> nextNodePairs(mAllocator);
+    bool hasSplitPairs = true;
+    while (outNodePairs.size() < minNbNodePairs && hasSplitPairs) {
+
+        nextNodePairs.clear();
+        hasSplitPairs = false;
+
+        for (uint32 i=0; i < outNodePairs.size(); i++) {
+
+            const Pair<int32, int32>& nodePair = outNodePairs[i];
+
+            // The pairs of leaves are kept because they are tested during the traversal
+            if (mNodes[nodePair.first].isLeaf() && otherTree.mNodes[nodePair.second].isLeaf()) {
+                nextNodePairs.add(nodePair);
+                continue;
+            }
+
+            int32 childrenIDs[3];
+            int32 otherChildrenIDs[3];
+            const uint32 nbChildrenPairs = computeChildrenNodePairs(otherTree, nodePair, childrenIDs, otherChildrenIDs);
+            for (uint32 j=0; j < nbChildrenPairs; j++) {
+                nextNodePairs.add(Pair<int32, int32>(childrenIDs[j], otherChildrenIDs[j]));
+            }
+
+            hasSplitPairs = true;
+        }
+
+        outNodePairs = nextNodePairs;
+    }
+}
+
 // Ray casting method
 void DynamicAABBTree::raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const {
 
@@ -727,6 +1285,53 @@ void DynamicAABBTree::raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& ca
     }
 }
 
+// Ray casting method for a packet of rays
+/// The rays of the packet traverse the tree together. A node is visited if it is hit by at
+/// least one ray of the packet. The callback is called with the bit mask of the rays that hit
+/// each leaf and it clips those rays to their closest hit. The children of a node are visited in
+/// the order of the first ray that hits the node. The stack used for the traversal is given by the
+/// caller so that it can be reused between packets.
+void DynamicAABBTree::raycast(RayPacket& packet, Stack<int32>& stack, DynamicAABBTreeRayPacketCallback& callback) const {
+
+    assert(stack.size() == 0);
+
+    if (mRootNodeID == TreeNode::NULL_TREE_NODE) return;
+
+    decimal entryFractions[RayPacket::MAX_NB_RAYS];
+
+    stack.push(mRootNodeID);
+
+    while (stack.size() > 0) {
+
+        const int32 nodeID = stack.pop();
+        const TreeNode* node = mNodes + nodeID;
+
+        // Test the node AABB against the four rays of the packet at the same time
+        const uint32 rayMask = packet.testAABB(node->aabb, entryFractions);
+        if (rayMask == 0) continue;
+
+        // If the node is a leaf of the tree
+        if (node->isLeaf()) {
+
+            // Call the callback that will raycast the hit rays against the broad-phase shape
+            callback.raycastBroadPhaseShape(nodeID, packet, rayMask);
+        }
+        else {
+
+            // Find the child that is the closest one along the direction of the first hit ray
+            uint32 rayIndex = 0;
+            while ((rayMask & (1u << rayIndex)) == 0) rayIndex++;
+            const Vector3 direction = packet.points2[rayIndex] - packet.points1[rayIndex];
+            const bool isFirstChildCloser = direction.dot(mNodes[node->children[0]].aabb.getCenter()) <=
+                                            direction.dot(mNodes[node->children[1]].aabb.getCenter());
+
+            // Push the farthest child first so that the closest one is visited first
+            stack.push(node->children[isFirstChildCloser ? 1 : 0]);
+            stack.push(node->children[isFirstChildCloser ? 0 : 1]);
+        }
+    }
+}
+
 #ifndef NDEBUG
 
 // Check if the tree structure is valid (for debugging purpose)
@@ -801,15 +1406,17 @@ void DynamicAABBTree::checkNode(int32 nodeID) const {
     }
 }
 
+#endif
+
 // Compute the height of the tree
-int DynamicAABBTree::computeHeight() {
+int DynamicAABBTree::computeHeight() const {
    return computeHeight(mRootNodeID);
 }
 
 // Compute the height of a given node in the tree
-int DynamicAABBTree::computeHeight(int32 nodeID) {
+int DynamicAABBTree::computeHeight(int32 nodeID) const {
     assert(nodeID >= 0 && nodeID < mNbAllocatedNodes);
-    TreeNode* node = mNodes + nodeID;
+    const TreeNode* node = mNodes + nodeID;
 
     // If the node is a leaf, its height is zero
     if (node->isLeaf()) {
@@ -824,4 +1431,164 @@ int DynamicAABBTree::computeHeight(int32 nodeID) {
     return 1 + std::max(leftHeight, rightHeight);
 }
 
-#endif
+// Compute the surface area heuristic (SAH) cost of the tree
+/// This is the sum of the surface areas of the internal nodes divided by the surface area
+/// of the root node. It is proportional to the expected number of internal nodes visited by a
+/// random query. It grows when the tree degrades and can be used to monitor its quality.
+decimal DynamicAABBTree::computeSAHCost() const {
+
+    if (mRootNodeID == TreeNode::NULL_TREE_NODE || mNodes[mRootNodeID].isLeaf()) return decimal(0.0);
+
+    decimal internalNodesArea = decimal(0.0);
+    for (int32 i=0; i < mNbAllocatedNodes; i++) {
+
+        // The free nodes have a negative height and the leaves have a null height
+        if (mNodes[i].height > 0) {
+            internalNodesArea += mNodes[i].aabb.getSurfaceArea();
+        }
+    }
+
+    return internalNodesArea / mNodes[mRootNodeID].aabb.getSurfaceArea();
+}
+
+// Optimize a given number of internal nodes of the tree with rotations
+/// The tree slowly degrades when many objects are removed and inserted. This method can be
+/// called at each frame with a small number of nodes to keep the quality of the tree without
+/// rebuilding it. The nodes are visited in a round-robin order over the frames and the best
+/// rotation (according to the surface area heuristic) is applied at each visited node.
+void DynamicAABBTree::optimizeIncremental(uint32 nbNodesToOptimize) {
+
+    RP3D_PROFILE("DynamicAABBTree::optimizeIncremental()", mProfiler);
+
+    if (mRootNodeID == TreeNode::NULL_TREE_NODE) return;
+
+    // Visit each allocated node at most once
+    int32 nbVisitedNodes = 0;
+    while (nbNodesToOptimize > 0 && nbVisitedNodes < mNbAllocatedNodes) {
+
+        if (mOptimizationNodeID >= mNbAllocatedNodes) {
+            mOptimizationNodeID = 0;
+        }
+
+        const int32 nodeID = mOptimizationNodeID;
+        mOptimizationNodeID++;
+        nbVisitedNodes++;
+
+        // Only the internal nodes with at least one grand-child can be rotated
+        if (mNodes[nodeID].height < 2) continue;
+
+        rotateNode(nodeID);
+        nbNodesToOptimize--;
+    }
+}
+
+// Apply the best rotation (if any) at a given internal node
+/// The rotations are the ones described in "Fast, Effective BVH Updates for Animated Scenes" by
+/// Kopta et al. A child of the node is swapped with a grand-child from the other side or two
+/// grand-children from different sides are swapped. The set of objects under the node does not
+/// change and therefore its AABB does not change either. The rotation that reduces the most the
+/// sum of the surface areas of the children of the node is applied. A rotation that would increase
+/// the height of the node is not applied so that the tree stays balanced.
+void DynamicAABBTree::rotateNode(int32 nodeID) {
+
+    const TreeNode* node = mNodes + nodeID;
+    assert(!node->isLeaf());
+
+    const int32 childrenIDs[2] = {node->children[0], node->children[1]};
+    const TreeNode* children[2] = {mNodes + childrenIDs[0], mNodes + childrenIDs[1]};
+
+    // Nodes swapped by the best rotation
+    decimal bestAreaReduction = decimal(0.0);
+    int32 bestNode1ID = TreeNode::NULL_TREE_NODE;
+    int32 bestNode2ID = TreeNode::NULL_TREE_NODE;
+
+    // Try to swap a child with a grand-child from the other side
+    for (int c=0; c < 2; c++) {
+
+        const TreeNode* child = children[c];
+        if (child->isLeaf()) continue;
+
+        const int32 otherChildID = childrenIDs[1 - c];
+        const decimal childArea = child->aabb.getSurfaceArea();
+
+        for (int g=0; g < 2; g++) {
+
+            // The rotation must not increase the height of the node
+            const int newChildHeight = std::max(mNodes[otherChildID].height, mNodes[child->children[1 - g]].height) + 1;
+            if (std::max(newChildHeight, static_cast<int>(mNodes[child->children[g]].height)) + 1 > node->height) continue;
+
+            AABB newChildAABB;
+            newChildAABB.mergeTwoAABBs(mNodes[otherChildID].aabb, mNodes[child->children[1 - g]].aabb);
+
+            const decimal areaReduction = childArea - newChildAABB.getSurfaceArea();
+            if (areaReduction > bestAreaReduction) {
+                bestAreaReduction = areaReduction;
+                bestNode1ID = otherChildID;
+                bestNode2ID = child->children[g];
+            }
+        }
+    }
+
+    // Try to swap two grand-children from different sides
+    if (!children[0]->isLeaf() && !children[1]->isLeaf()) {
+
+        const decimal childrenArea = children[0]->aabb.getSurfaceArea() + children[1]->aabb.getSurfaceArea();
+
+        for (int i=0; i < 2; i++) {
+            for (int j=0; j < 2; j++) {
+
+                // The rotation must not increase the height of the node
+                const int newChild1Height = std::max(mNodes[children[1]->children[j]].height, mNodes[children[0]->children[1 - i]].height) + 1;
+                const int newChild2Height = std::max(mNodes[children[0]->children[i]].height, mNodes[children[1]->children[1 - j]].height) + 1;
+                if (std::max(newChild1Height, newChild2Height) + 1 > node->height) continue;
+
+                AABB newChild1AABB;
+                AABB newChild2AABB;
+                newChild1AABB.mergeTwoAABBs(mNodes[children[1]->children[j]].aabb, mNodes[children[0]->children[1 - i]].aabb);
+                newChild2AABB.mergeTwoAABBs(mNodes[children[0]->children[i]].aabb, mNodes[children[1]->children[1 - j]].aabb);
+
+                const decimal areaReduction = childrenArea - newChild1AABB.getSurfaceArea() - newChild2AABB.getSurfaceArea();
+                if (areaReduction > bestAreaReduction) {
+                    bestAreaReduction = areaReduction;
+                    bestNode1ID = children[0]->children[i];
+                    bestNode2ID = children[1]->children[j];
+                }
+            }
+        }
+    }
+
+    // If no rotation improves the tree
+    if (bestNode1ID == TreeNode::NULL_TREE_NODE) return;
+
+    // Swap the two nodes
+    const int32 parent1ID = mNodes[bestNode1ID].parentID;
+    const int32 parent2ID = mNodes[bestNode2ID].parentID;
+    TreeNode* parent1 = mNodes + parent1ID;
+    TreeNode* parent2 = mNodes + parent2ID;
+    parent1->children[parent1->children[0] == bestNode1ID ? 0 : 1] = bestNode2ID;
+    parent2->children[parent2->children[0] == bestNode2ID ? 0 : 1] = bestNode1ID;
+    mNodes[bestNode1ID].parentID = parent2ID;
+    mNodes[bestNode2ID].parentID = parent1ID;
+
+    // Recompute the AABBs and the heights of the modified children of the node
+    const int32 parentsIDs[2] = {parent1ID, parent2ID};
+    for (int i=0; i < 2; i++) {
+        if (parentsIDs[i] != nodeID) {
+            TreeNode* parent = mNodes + parentsIDs[i];
+            parent->aabb.mergeTwoAABBs(mNodes[parent->children[0]].aabb, mNodes[parent->children[1]].aabb);
+            parent->height = std::max(mNodes[parent->children[0]].height, mNodes[parent->children[1]].height) + 1;
+        }
+    }
+
+    // Recompute the heights of the node and of its ancestors
+    int32 currentNodeID = nodeID;
+    while (currentNodeID != TreeNode::NULL_TREE_NODE) {
+
+        TreeNode* currentNode = mNodes + currentNodeID;
+        const int16 height = std::max(mNodes[currentNode->children[0]].height, mNodes[currentNode->children[1]].height) + 1;
+        if (height == currentNode->height) break;
+        currentNode->height = height;
+
+        currentNodeID = currentNode->parentID;
+    }
+}
@@ -0,0 +1,514 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include <reactphysics3d/collision/broadphase/DynamicAABBTreeBroadPhase.h>
+#include <reactphysics3d/collision/RayPacket.h>
+#include <reactphysics3d/engine/TaskScheduler.h>
+#include <reactphysics3d/memory/MemoryManager.h>
+#include <reactphysics3d/containers/Set.h>
+#include <reactphysics3d/utils/Profiler.h>
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;
+
+// Static constants definitions
+const uint32 DynamicAABBTreeBroadPhase::MIN_NB_STATIC_INSERTIONS_REBUILD;
+
+// Constructor
+/// The AABBs of the static objects are not inflated because those objects do not move
+DynamicAABBTreeBroadPhase::DynamicAABBTreeBroadPhase(MemoryAllocator& allocator, decimal fatAABBInflatePercentage,
+                                                     uint32 dynamicTreeOptimizationBudget, TaskScheduler* taskScheduler)
+                          :mAllocator(allocator), mDynamicTree(allocator, fatAABBInflatePercentage), mStaticTree(allocator),
+                           mStaticWideTree(allocator), mIsStaticTreeModified(false), mIsStaticTreeCompacted(false), mProxies(allocator), mFreeProxies(allocator), mNbStaticObjects(0), mNbStaticInsertions(0),
+                           mFatAABBInflatePercentage(fatAABBInflatePercentage), mDynamicTreeOptimizationBudget(dynamicTreeOptimizationBudget), mTaskScheduler(taskScheduler) {
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+    mProfiler = nullptr;
+
+#endif
+
+}
+
+// Add an object with a given AABB and return its broad-phase ID
+int32 DynamicAABBTreeBroadPhase::addObject(const AABB& aabb, void* data, bool isStatic) {
+
+    // Get a free proxy (or create a new one)
+    int32 broadPhaseId;
+    if (mFreeProxies.size() > 0) {
+        broadPhaseId = mFreeProxies[mFreeProxies.size() - 1];
+        mFreeProxies.removeAt(mFreeProxies.size() - 1);
+    }
+    else {
+        broadPhaseId = static_cast<int32>(mProxies.size());
+        mProxies.add(TreeProxy());
+    }
+
+    // Add the object into its tree. The node stores the broad-phase ID of the object
+    TreeProxy& proxy = mProxies[broadPhaseId];
+    proxy.data = data;
+    proxy.isStatic = isStatic;
+    proxy.hasMoved = false;
+    if (isStatic) {
+        proxy.nodeId = mStaticTree.addObject(aabb, broadPhaseId, 0);
+        mNbStaticObjects++;
+        mNbStaticInsertions++;
+        setStaticTreeModified();
+    }
+    else {
+        proxy.nodeId = mDynamicTree.addObject(aabb, broadPhaseId, 0);
+    }
+
+    return broadPhaseId;
+}
+
+// Remove an object
+void DynamicAABBTreeBroadPhase::removeObject(int32 broadPhaseId) {
+
+    assert(broadPhaseId >= 0 && broadPhaseId < static_cast<int32>(mProxies.size()));
+    assert(mProxies[broadPhaseId].nodeId != -1);
+
+    TreeProxy& proxy = mProxies[broadPhaseId];
+    if (proxy.isStatic) {
+        mStaticTree.removeObject(proxy.nodeId);
+        mNbStaticObjects--;
+        setStaticTreeModified();
+    }
+    else {
+        mDynamicTree.removeObject(proxy.nodeId);
+    }
+
+    proxy.data = nullptr;
+    proxy.nodeId = -1;
+    mFreeProxies.add(broadPhaseId);
+}
+
+// Update the AABB of an object. Return true if the fat AABB of the object has changed
+/// The fat AABB of a static object is neither inflated nor extended by its displacement
+bool DynamicAABBTreeBroadPhase::updateObject(int32 broadPhaseId, const AABB& newAABB, const Vector3& displacement,
+                                             decimal fatAABBInflatePercentage, bool forceReInsert) {
+
+    assert(broadPhaseId >= 0 && broadPhaseId < static_cast<int32>(mProxies.size()));
+    assert(mProxies[broadPhaseId].nodeId != -1);
+
+    const TreeProxy& proxy = mProxies[broadPhaseId];
+    if (proxy.isStatic) {
+
+        const bool hasBeenReInserted = mStaticTree.updateObject(proxy.nodeId, newAABB, forceReInsert);
+        if (hasBeenReInserted) {
+            mNbStaticInsertions++;
+            setStaticTreeModified();
+        }
+
+        return hasBeenReInserted;
+    }
+
+    if (fatAABBInflatePercentage < decimal(0.0)) {
+        fatAABBInflatePercentage = mFatAABBInflatePercentage;
+    }
+
+    return mDynamicTree.updateObject(proxy.nodeId, newAABB, displacement, fatAABBInflatePercentage, forceReInsert);
+}
+
+// Set whether an object is static or not
+/// The object is moved into the other tree with its current fat AABB
+void DynamicAABBTreeBroadPhase::setObjectIsStatic(int32 broadPhaseId, bool isStatic) {
+
+    assert(broadPhaseId >= 0 && broadPhaseId < static_cast<int32>(mProxies.size()));
+    assert(mProxies[broadPhaseId].nodeId != -1);
+
+    TreeProxy& proxy = mProxies[broadPhaseId];
+    if (proxy.isStatic == isStatic) return;
+
+    const AABB fatAABB = getTree(proxy).getFatAABB(proxy.nodeId);
+
+    if (isStatic) {
+        mDynamicTree.removeObject(proxy.nodeId);
+        proxy.nodeId = mStaticTree.addObject(fatAABB, broadPhaseId, 0);
+        mNbStaticObjects++;
+        mNbStaticInsertions++;
+    }
+    else {
+        mStaticTree.removeObject(proxy.nodeId);
+        proxy.nodeId = mDynamicTree.addObject(fatAABB, broadPhaseId, 0);
+        mNbStaticObjects--;
+    }
+
+    proxy.isStatic = isStatic;
+    setStaticTreeModified();
+}
+
+// Build the static tree again from scratch
+/// The tree is built with the SAH bulk-build which gives a better tree than the
+/// insertion of the objects one by one.
+void DynamicAABBTreeBroadPhase::rebuildStaticTree() {
+
+    RP3D_PROFILE("DynamicAABBTreeBroadPhase::rebuildStaticTree()", mProfiler);
+
+    // Get the static objects
+    List<DynamicAABBTreeObject> staticObjects(mAllocator, mNbStaticObjects);
+    for (uint32 i=0; i < mProxies.size(); i++) {
+        const TreeProxy& proxy = mProxies[i];
+        if (proxy.nodeId != -1 && proxy.isStatic) {
+            staticObjects.add(DynamicAABBTreeObject(mStaticTree.getFatAABB(proxy.nodeId), static_cast<int32>(i), 0));
+        }
+    }
+
+    assert(staticObjects.size() == mNbStaticObjects);
+
+    // Build the tree
+    List<int32> nodesIds(mAllocator, mNbStaticObjects);
+    mStaticTree.reset();
+    mStaticTree.build(staticObjects, &nodesIds, mTaskScheduler);
+
+    // Update the nodes of the proxies
+    for (uint32 i=0; i < staticObjects.size(); i++) {
+        mProxies[staticObjects[i].dataInt[0]].nodeId = nodesIds[i];
+    }
+
+    mNbStaticInsertions = 0;
+    setStaticTreeModified();
+
+    // The nodes of a tree built from its objects are already in depth-first order
+    mIsStaticTreeCompacted = true;
+}
+
+// Reorder the nodes of one of the trees in memory and update the nodes of the proxies
+void DynamicAABBTreeBroadPhase::compactTree(bool isStaticTree) {
+
+    DynamicAABBTree& tree = isStaticTree ? mStaticTree : mDynamicTree;
+
+    List<int32> newNodesIDs(mAllocator);
+    tree.compact(&newNodesIDs);
+    if (isStaticTree) {
+        mIsStaticTreeCompacted = true;
+    }
+
+    for (uint32 i=0; i < mProxies.size(); i++) {
+        TreeProxy& proxy = mProxies[i];
+        if (proxy.nodeId != -1 && proxy.isStatic == isStaticTree) {
+            proxy.nodeId = newNodesIDs[proxy.nodeId];
+        }
+    }
+}
+
+// Reorder the nodes of the trees in memory to make the queries more cache friendly
+/// The static tree is already compacted automatically before it is collapsed into the wide tree.
+/// This method can be called after many objects have been added, removed or moved.
+void DynamicAABBTreeBroadPhase::compact() {
+
+    RP3D_PROFILE("DynamicAABBTreeBroadPhase::compact()", mProfiler);
+
+    compactTree(false);
+
+    // The wide tree refers to the nodes of the static tree and must be collapsed again
+    compactTree(true);
+    if (!mStaticWideTree.isEmpty()) {
+        mStaticWideTree.build(mStaticTree);
+    }
+}
+
+// Report the objects overlapping with a range of the moved objects
+/// A non-static object is tested against both trees and a static object is only tested
+/// against the tree of the non-static objects. The range [startIndex, endIndex) allows the
+/// moved objects to be split between several tasks.
+void DynamicAABBTreeBroadPhase::reportOverlappingObjects(const List<int32>& movedObjects, uint32 startIndex, uint32 endIndex,
+                                                         List<Pair<int32, int32>>& overlappingPairs) const {
+
+    // Stack used to traverse the trees
+    Stack<int32> stack(mAllocator, 64);
+
+    for (uint32 i=startIndex; i < endIndex; i++) {
+
+        const int32 broadPhaseId = movedObjects[i];
+
+        assert(broadPhaseId != -1);
+        assert(mProxies[broadPhaseId].nodeId != -1);
+
+        const TreeProxy& proxy = mProxies[broadPhaseId];
+        const AABB& fatAABB = getTree(proxy).getFatAABB(proxy.nodeId);
+
+        reportObjectsOverlappingWithAABB(fatAABB, broadPhaseId, proxy.isStatic, stack, overlappingPairs);
+    }
+}
+
+// Report the objects with a fat AABB overlapping a given AABB as pairs of an ID and their broad-phase ID
+/// The static objects are skipped if "skipStaticObjects" is true. This method is not profiled
+/// because it can be called by several threads at the same time.
+void DynamicAABBTreeBroadPhase::reportObjectsOverlappingWithAABB(const AABB& aabb, int32 id, bool skipStaticObjects, Stack<int32>& stack,
+                                                                 List<Pair<int32, int32>>& overlappingPairs) const {
+
+    mDynamicTree.reportAllShapesOverlappingWithAABB(aabb, id, stack, overlappingPairs);
+
+    if (!skipStaticObjects) {
+        if (!mStaticWideTree.isEmpty()) {
+            mStaticWideTree.reportAllShapesOverlappingWithAABB(aabb, id, stack, overlappingPairs);
+        }
+        else {
+            mStaticTree.reportAllShapesOverlappingWithAABB(aabb, id, stack, overlappingPairs);
+        }
+    }
+}
+
+// Add all the pairs of objects with overlapping fat AABBs where at least one object has moved
+void DynamicAABBTreeBroadPhase::computeOverlappingPairs(MemoryManager& memoryManager, const List<int32>& movedObjects,
+                                                        List<Pair<int32, int32>>& overlappingPairs) {
+
+    // Optimize a part of the tree of the non-static objects
+    if (mDynamicTreeOptimizationBudget > 0) {
+        mDynamicTree.optimizeIncremental(mDynamicTreeOptimizationBudget);
+    }
+
+    // If many static objects have been inserted since the static tree has been built
+    if (mNbStaticInsertions >= MIN_NB_STATIC_INSERTIONS_REBUILD && mNbStaticInsertions * 4 >= mNbStaticObjects) {
+        rebuildStaticTree();
+    }
+
+    // Collapse the static tree into the wide tree once it has not been modified during a whole frame
+    // (the static objects are usually all created at the same time and then never move)
+    if (mIsStaticTreeModified) {
+        mIsStaticTreeModified = false;
+    }
+    else if (mStaticWideTree.isEmpty() && mNbStaticObjects > 0) {
+
+        // The static tree does not need to be compacted if it has just been built
+        if (!mIsStaticTreeCompacted) {
+            compactTree(true);
+        }
+        mStaticWideTree.build(mStaticTree);
+    }
+
+    const uint32 nbNonStaticObjects = mProxies.size() - mFreeProxies.size() - mNbStaticObjects;
+
+    // If most of the non-static objects have moved, it is faster to traverse the trees together than to
+    // query them from their root with each moved object (which visits the top of the trees many times)
+    if (movedObjects.size() > 0 &&
+        decimal(movedObjects.size()) >= TREE_VS_TREE_MIN_MOVED_FRACTION * decimal(nbNonStaticObjects)) {
+
+        computeOverlappingPairsTreeVsTree(memoryManager, movedObjects, overlappingPairs);
+    }
+    // If there are enough moved objects to split the work among several threads
+    else if (mTaskScheduler != nullptr && mTaskScheduler->getNbThreads() > 1 && movedObjects.size() > BROAD_PHASE_GRAIN_SIZE) {
+
+        computeOverlappingPairsParallel(memoryManager, movedObjects, overlappingPairs);
+    }
+    else {
+
+        // Ask the trees to report all the objects that overlap with the moved objects
+        reportOverlappingObjects(movedObjects, 0, static_cast<uint32>(movedObjects.size()), overlappingPairs);
+    }
+}
+
+// Compute the overlapping pairs of the moved objects using several threads
+/// The moved objects are split into chunks that query the tree concurrently. Each chunk
+/// writes into its own list of pairs. The lists are then merged in the order of the chunks
+/// so that the pairs are reported in the same order as with a single thread. A pair of two
+/// moved objects is found twice (once from each object) and only its first occurrence is kept.
+void DynamicAABBTreeBroadPhase::computeOverlappingPairsParallel(MemoryManager& memoryManager, const List<int32>& movedObjects,
+                                                                List<Pair<int32, int32>>& overlappingPairs) {
+
+    const uint32 nbMovedObjects = movedObjects.size();
+    const uint32 nbChunks = (nbMovedObjects + BROAD_PHASE_GRAIN_SIZE - 1) / BROAD_PHASE_GRAIN_SIZE;
+
+    // Create one list of overlapping pairs per chunk
+    List<List<Pair<int32, int32>>> chunksOverlappingPairs(memoryManager.getPoolAllocator(), nbChunks);
+    for (uint32 i=0; i < nbChunks; i++) {
+        chunksOverlappingPairs.add(List<Pair<int32, int32>>(memoryManager.getPoolAllocator(), 2 * BROAD_PHASE_GRAIN_SIZE));
+    }
+
+    // Query the tree for each chunk of moved objects
+    mTaskScheduler->parallelFor(nbChunks, 1, [this, &movedObjects, &chunksOverlappingPairs, nbMovedObjects](uint32 startChunk, uint32 endChunk) {
+
+        for (uint32 c=startChunk; c < endChunk; c++) {
+
+            const uint32 startIndex = c * BROAD_PHASE_GRAIN_SIZE;
+            const uint32 endIndex = std::min(startIndex + BROAD_PHASE_GRAIN_SIZE, nbMovedObjects);
+            reportOverlappingObjects(movedObjects, startIndex, endIndex, chunksOverlappingPairs[c]);
+        }
+    });
+
+    // Merge the lists of the chunks and remove the duplicated pairs
+    uint32 nbPairs = 0;
+    for (uint32 i=0; i < nbChunks; i++) {
+        nbPairs += chunksOverlappingPairs[i].size();
+    }
+    overlappingPairs.reserve(overlappingPairs.size() + nbPairs);
+    Set<uint64> reportedPairs(memoryManager.getPoolAllocator(), nbPairs);
+    for (uint32 i=0; i < nbChunks; i++) {
+
+        const List<Pair<int32, int32>>& chunkOverlappingPairs = chunksOverlappingPairs[i];
+        for (uint32 j=0; j < chunkOverlappingPairs.size(); j++) {
+
+            const Pair<int32, int32>& nodePair = chunkOverlappingPairs[j];
+
+            // Skip pairs with same overlapping nodes
+            if (nodePair.first == nodePair.second) continue;
+
+            const uint64 pairId = pairNumbers(std::max(nodePair.first, nodePair.second), std::min(nodePair.first, nodePair.second));
+            if (reportedPairs.add(pairId)) {
+                overlappingPairs.add(nodePair);
+            }
+        }
+    }
+}
+
+// Compute the overlapping pairs of the moved objects by traversing the trees together
+/// The tree of the non-static objects is traversed with itself and with the static tree. This
+/// finds each pair of overlapping objects once. The pairs where none of the two objects has moved
+/// are then removed. The traversals are split into pairs of nodes that can be traversed by different
+/// threads and the pairs are merged in the order of the pairs of nodes. The split does not depend on
+/// the number of threads and therefore, the pairs are found in the same order with or without threads.
+void DynamicAABBTreeBroadPhase::computeOverlappingPairsTreeVsTree(MemoryManager& memoryManager, const List<int32>& movedObjects,
+                                                                  List<Pair<int32, int32>>& overlappingPairs) {
+
+    RP3D_PROFILE("DynamicAABBTreeBroadPhase::computeOverlappingPairsTreeVsTree()", mProfiler);
+
+    // Flag the moved objects
+    for (uint32 i=0; i < movedObjects.size(); i++) {
+        assert(mProxies[movedObjects[i]].nodeId != -1);
+        mProxies[movedObjects[i]].hasMoved = true;
+    }
+
+    // Split the two traversals into pairs of nodes that can be traversed independently
+    List<Pair<int32, int32>> dynamicNodePairs(memoryManager.getPoolAllocator());
+    List<Pair<int32, int32>> staticNodePairs(memoryManager.getPoolAllocator());
+    mDynamicTree.splitTreeVsTreeTraversal(mDynamicTree, TREE_VS_TREE_MIN_NB_NODE_PAIRS, dynamicNodePairs);
+    mDynamicTree.splitTreeVsTreeTraversal(mStaticTree, TREE_VS_TREE_MIN_NB_NODE_PAIRS, staticNodePairs);
+
+    // Create one list of overlapping pairs per pair of nodes
+    const uint32 nbNodePairs = dynamicNodePairs.size() + staticNodePairs.size();
+    List<List<Pair<int32, int32>>> nodePairsOverlappingPairs(memoryManager.getPoolAllocator(), nbNodePairs);
+    for (uint32 i=0; i < nbNodePairs; i++) {
+        nodePairsOverlappingPairs.add(List<Pair<int32, int32>>(memoryManager.getPoolAllocator()));
+    }
+
+    // Traverse the trees below each pair of nodes
+    auto traverseNodePairs = [this, &dynamicNodePairs, &staticNodePairs, &nodePairsOverlappingPairs](uint32 startIndex, uint32 endIndex) {
+
+        Stack<Pair<int32, int32>> stack(mAllocator, 64);
+        for (uint32 i=startIndex; i < endIndex; i++) {
+
+            if (i < dynamicNodePairs.size()) {
+                mDynamicTree.reportOverlappingLeaves(mDynamicTree, dynamicNodePairs[i], stack, nodePairsOverlappingPairs[i]);
+            }
+            else {
+                mDynamicTree.reportOverlappingLeaves(mStaticTree, staticNodePairs[i - dynamicNodePairs.size()], stack,
+                                                     nodePairsOverlappingPairs[i]);
+            }
+        }
+    };
+
+    // If there are enough moved objects to split the work among several threads
+    if (mTaskScheduler != nullptr && movedObjects.size() > BROAD_PHASE_GRAIN_SIZE) {
+        parallelFor(mTaskScheduler, nbNodePairs, 1, traverseNodePairs);
+    }
+    else {
+        traverseNodePairs(0, nbNodePairs);
+    }
+
+    // Merge the pairs in the order of the pairs of nodes
+    for (uint32 i=0; i < nbNodePairs; i++) {
+        addMovedPairs(nodePairsOverlappingPairs[i], overlappingPairs);
+    }
+
+    // Reset the flags of the moved objects
+    for (uint32 i=0; i < movedObjects.size(); i++) {
+        mProxies[movedObjects[i]].hasMoved = false;
+    }
+}
+
+// Add the pairs of objects where at least one object has moved
+void DynamicAABBTreeBroadPhase::addMovedPairs(const List<Pair<int32, int32>>& pairs,
+                                              List<Pair<int32, int32>>& overlappingPairs) const {
+
+    for (uint32 i=0; i < pairs.size(); i++) {
+        if (mProxies[pairs[i].first].hasMoved || mProxies[pairs[i].second].hasMoved) {
+            overlappingPairs.add(pairs[i]);
+        }
+    }
+}
+
+// Report all the objects with a fat AABB hit by a ray to a callback
+/// The ray is cast against the static tree first. The ray is then clipped with the smallest
+/// hit fraction before it is cast against the tree of the non-static objects.
+void DynamicAABBTreeBroadPhase::raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const {
+
+    RP3D_PROFILE("DynamicAABBTreeBroadPhase::raycast()", mProfiler);
+
+    TreeRaycastCallback staticTreeCallback(mStaticTree, callback, ray.maxFraction);
+    if (!mStaticWideTree.isEmpty()) {
+        mStaticWideTree.raycast(ray, staticTreeCallback);
+    }
+    else {
+        mStaticTree.raycast(ray, staticTreeCallback);
+    }
+
+    if (staticTreeCallback.mIsStopped) return;
+
+    TreeRaycastCallback dynamicTreeCallback(mDynamicTree, callback, staticTreeCallback.mMaxFraction);
+    mDynamicTree.raycast(Ray(ray.point1, ray.point2, staticTreeCallback.mMaxFraction), dynamicTreeCallback);
+}
+
+// Report all the objects with a fat AABB hit by some rays of a packet to a callback
+/// The rays are clipped by the hits in the static tree before they are cast against the
+/// tree of the non-static objects.
+void DynamicAABBTreeBroadPhase::raycast(RayPacket& packet, Stack<int32>& stack, DynamicAABBTreeRayPacketCallback& callback) const {
+
+    TreeRayPacketCallback staticTreeCallback(mStaticTree, callback);
+    if (!mStaticWideTree.isEmpty()) {
+        mStaticWideTree.raycast(packet, stack, staticTreeCallback);
+    }
+    else {
+        mStaticTree.raycast(packet, stack, staticTreeCallback);
+    }
+
+    TreeRayPacketCallback dynamicTreeCallback(mDynamicTree, callback);
+    mDynamicTree.raycast(packet, stack, dynamicTreeCallback);
+}
+
+// Called when the AABB of a leaf node is hit by a ray
+decimal TreeRaycastCallback::raycastBroadPhaseShape(int32 nodeId, const Ray& ray) {
+
+    // Report the broad-phase ID of the object stored in the node
+    const decimal hitFraction = mCallback.raycastBroadPhaseShape(mTree.getNodeDataInt(nodeId)[0], ray);
+
+    // If the callback has asked to stop the ray casting
+    if (hitFraction == decimal(0.0)) {
+        mIsStopped = true;
+    }
+    else if (hitFraction > decimal(0.0) && hitFraction < mMaxFraction) {
+        mMaxFraction = hitFraction;
+    }
+
+    return hitFraction;
+}
+
+// Called when the AABB of a leaf node is hit by the rays of a packet in the bit mask
+void TreeRayPacketCallback::raycastBroadPhaseShape(int32 nodeId, RayPacket& packet, uint32 rayMask) {
+
+    // Report the broad-phase ID of the object stored in the node
+    mCallback.raycastBroadPhaseShape(mTree.getNodeDataInt(nodeId)[0], packet, rayMask);
+}
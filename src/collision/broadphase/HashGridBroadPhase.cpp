@@ -0,0 +1,854 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+
+// Libraries
+#include <reactphysics3d/collision/broadphase/HashGridBroadPhase.h>
+#include <reactphysics3d/collision/RayPacket.h>
+#include <reactphysics3d/engine/TaskScheduler.h>
+#include <reactphysics3d/memory/MemoryManager.h>
+#include <reactphysics3d/containers/Set.h>
+#include <reactphysics3d/utils/Profiler.h>
+#include <cmath>
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;
+
+// Static constants definitions
+const uint32 HashGridBroadPhase::MIN_NB_BUCKETS;
+
+// Constructor
+/// If the cell size is zero, the size of the cells is computed from the average size of the
+/// non-static objects and the grid is built the first time the overlapping pairs are computed
+HashGridBroadPhase::HashGridBroadPhase(MemoryAllocator& allocator, decimal fatAABBInflatePercentage, decimal cellSize,
+                                       uint32 dynamicTreeOptimizationBudget, TaskScheduler* taskScheduler)
+                   :mAllocator(allocator), mTreeBroadPhase(allocator, fatAABBInflatePercentage, dynamicTreeOptimizationBudget, taskScheduler),
+                    mTreeObjectsProxies(allocator), mProxies(allocator), mFreeProxies(allocator), mBuckets(allocator, MIN_NB_BUCKETS),
+                    mCellSize(std::max(cellSize, decimal(0.0))), mInverseCellSize(cellSize > decimal(0.0) ? decimal(1.0) / cellSize : decimal(0.0)),
+                    mIsCellSizeAutomatic(cellSize <= decimal(0.0)), mNbGridObjects(0), mNbNonStaticObjects(0), mSumObjectsSizes(0),
+                    mGridBounds(Vector3(DECIMAL_LARGEST, DECIMAL_LARGEST, DECIMAL_LARGEST), Vector3(DECIMAL_SMALLEST, DECIMAL_SMALLEST, DECIMAL_SMALLEST)),
+                    mFatAABBInflatePercentage(fatAABBInflatePercentage), mTaskScheduler(taskScheduler) {
+
+    for (uint32 i=0; i < MIN_NB_BUCKETS; i++) {
+        mBuckets.add(-1);
+    }
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+    mProfiler = nullptr;
+
+#endif
+
+}
+
+// Compute the coordinates of the cell that contains a point
+/// The coordinates are clamped to avoid an overflow for the points very far from the origin
+void HashGridBroadPhase::computeCell(const Vector3& point, int32* outCell) const {
+
+    const decimal maxCoordinate = decimal(1 << 30);
+
+    for (int i=0; i < 3; i++) {
+        const decimal coordinate = std::floor(point[i] * mInverseCellSize);
+        outCell[i] = static_cast<int32>(std::max(-maxCoordinate, std::min(coordinate, maxCoordinate)));
+    }
+}
+
+// Return the index of the bucket of a cell
+inline uint32 HashGridBroadPhase::computeBucketIndex(int32 x, int32 y, int32 z) const {
+
+    const uint32 hash = (static_cast<uint32>(x) * 73856093u) ^ (static_cast<uint32>(y) * 19349663u) ^
+                        (static_cast<uint32>(z) * 83492791u);
+
+    // The number of buckets is a power of two
+    return hash & (mBuckets.size() - 1);
+}
+
+// Add an object into the linked list of the bucket of its cell
+void HashGridBroadPhase::addToGrid(int32 broadPhaseId) {
+
+    GridProxy& proxy = mProxies[broadPhaseId];
+
+    computeCell(proxy.fatAABB.getMin(), proxy.cell);
+    const uint32 bucketIndex = computeBucketIndex(proxy.cell[0], proxy.cell[1], proxy.cell[2]);
+
+    proxy.previous = -1;
+    proxy.next = mBuckets[bucketIndex];
+    if (proxy.next != -1) {
+        mProxies[proxy.next].previous = broadPhaseId;
+    }
+    mBuckets[bucketIndex] = broadPhaseId;
+
+    proxy.isInGrid = true;
+    mNbGridObjects++;
+    mGridBounds.mergeWithAABB(proxy.fatAABB);
+}
+
+// Remove an object from the linked list of its bucket
+void HashGridBroadPhase::removeFromGrid(int32 broadPhaseId) {
+
+    GridProxy& proxy = mProxies[broadPhaseId];
+    assert(proxy.isInGrid);
+
+    if (proxy.previous != -1) {
+        mProxies[proxy.previous].next = proxy.next;
+    }
+    else {
+        mBuckets[computeBucketIndex(proxy.cell[0], proxy.cell[1], proxy.cell[2])] = proxy.next;
+    }
+    if (proxy.next != -1) {
+        mProxies[proxy.next].previous = proxy.previous;
+    }
+
+    proxy.isInGrid = false;
+    mNbGridObjects--;
+}
+
+// Register the ID of an object in the tree broad-phase
+void HashGridBroadPhase::setTreeObjectId(int32 broadPhaseId, int32 treeObjectId) {
+
+    mProxies[broadPhaseId].treeObjectId = treeObjectId;
+
+    while (mTreeObjectsProxies.size() <= static_cast<uint32>(treeObjectId)) {
+        mTreeObjectsProxies.add(-1);
+    }
+    mTreeObjectsProxies[treeObjectId] = broadPhaseId;
+}
+
+// Move an object of the grid into the trees with its current fat AABB
+/// The object must have been removed from the grid before
+void HashGridBroadPhase::moveToTrees(int32 broadPhaseId) {
+
+    const GridProxy& proxy = mProxies[broadPhaseId];
+    assert(!proxy.isInGrid);
+
+    const int32 treeObjectId = mTreeBroadPhase.addObject(proxy.fatAABB, nullptr, proxy.isStatic);
+
+    // The fat AABB must not be inflated a second time
+    if (!proxy.isStatic) {
+        mTreeBroadPhase.updateObject(treeObjectId, proxy.fatAABB, Vector3::zero(), decimal(0.0), true);
+    }
+
+    setTreeObjectId(broadPhaseId, treeObjectId);
+}
+
+// Move an object of the trees into the grid with its current fat AABB
+void HashGridBroadPhase::moveToGrid(int32 broadPhaseId) {
+
+    GridProxy& proxy = mProxies[broadPhaseId];
+    assert(proxy.treeObjectId != -1 && !proxy.isStatic);
+
+    proxy.fatAABB = mTreeBroadPhase.getFatAABB(proxy.treeObjectId);
+    mTreeBroadPhase.removeObject(proxy.treeObjectId);
+    mTreeObjectsProxies[proxy.treeObjectId] = -1;
+    proxy.treeObjectId = -1;
+
+    addToGrid(broadPhaseId);
+}
+
+// Add an object with a given AABB and return its broad-phase ID
+/// The static objects and the objects that are too large for the cells are added into the trees
+int32 HashGridBroadPhase::addObject(const AABB& aabb, void* data, bool isStatic) {
+
+    // Get a free proxy (or create a new one)
+    int32 broadPhaseId;
+    if (mFreeProxies.size() > 0) {
+        broadPhaseId = mFreeProxies[mFreeProxies.size() - 1];
+        mFreeProxies.removeAt(mFreeProxies.size() - 1);
+    }
+    else {
+        broadPhaseId = static_cast<int32>(mProxies.size());
+        mProxies.add(GridProxy());
+    }
+
+    GridProxy& proxy = mProxies[broadPhaseId];
+    proxy.data = data;
+    proxy.treeObjectId = -1;
+    proxy.isStatic = isStatic;
+    proxy.isInGrid = false;
+
+    if (!isStatic) {
+
+        const Vector3 gap(aabb.getExtent() * mFatAABBInflatePercentage * decimal(0.5f));
+        proxy.fatAABB = AABB(aabb.getMin() - gap, aabb.getMax() + gap);
+
+        mNbNonStaticObjects++;
+        mSumObjectsSizes += proxy.fatAABB.getExtent().getMaxValue();
+
+        if (isSmallEnoughForGrid(proxy.fatAABB)) {
+            addToGrid(broadPhaseId);
+            return broadPhaseId;
+        }
+    }
+
+    // The tree broad-phase computes the same fat AABB
+    setTreeObjectId(broadPhaseId, mTreeBroadPhase.addObject(aabb, nullptr, isStatic));
+
+    return broadPhaseId;
+}
+
+// Remove an object
+void HashGridBroadPhase::removeObject(int32 broadPhaseId) {
+
+    assert(broadPhaseId >= 0 && broadPhaseId < static_cast<int32>(mProxies.size()));
+
+    GridProxy& proxy = mProxies[broadPhaseId];
+    assert(proxy.isInGrid || proxy.treeObjectId != -1);
+
+    if (!proxy.isStatic) {
+        mNbNonStaticObjects--;
+        mSumObjectsSizes -= getFatAABB(broadPhaseId).getExtent().getMaxValue();
+    }
+
+    if (proxy.isInGrid) {
+        removeFromGrid(broadPhaseId);
+    }
+    else {
+        mTreeBroadPhase.removeObject(proxy.treeObjectId);
+        mTreeObjectsProxies[proxy.treeObjectId] = -1;
+        proxy.treeObjectId = -1;
+    }
+
+    proxy.data = nullptr;
+    mFreeProxies.add(broadPhaseId);
+}
+
+// Update the AABB of an object. Return true if the fat AABB of the object has changed
+/// An object is moved between the grid and the trees when its new fat AABB does not fit
+/// into a cell anymore (or fits again)
+bool HashGridBroadPhase::updateObject(int32 broadPhaseId, const AABB& newAABB, const Vector3& displacement,
+                                      decimal fatAABBInflatePercentage, bool forceReInsert) {
+
+    assert(broadPhaseId >= 0 && broadPhaseId < static_cast<int32>(mProxies.size()));
+
+    GridProxy& proxy = mProxies[broadPhaseId];
+    assert(proxy.isInGrid || proxy.treeObjectId != -1);
+
+    // If the object is in the trees
+    if (!proxy.isInGrid) {
+
+        const decimal previousSize = getFatAABB(broadPhaseId).getExtent().getMaxValue();
+
+        if (!mTreeBroadPhase.updateObject(proxy.treeObjectId, newAABB, displacement, fatAABBInflatePercentage, forceReInsert)) {
+            return false;
+        }
+
+        if (!proxy.isStatic) {
+
+            const AABB& fatAABB = mTreeBroadPhase.getFatAABB(proxy.treeObjectId);
+            mSumObjectsSizes += fatAABB.getExtent().getMaxValue() - previousSize;
+
+            if (isSmallEnoughForGrid(fatAABB)) {
+                moveToGrid(broadPhaseId);
+            }
+        }
+
+        return true;
+    }
+
+    // If the new AABB is still inside the fat AABB of the object
+    if (!forceReInsert && proxy.fatAABB.contains(newAABB)) {
+        return false;
+    }
+
+    mSumObjectsSizes -= proxy.fatAABB.getExtent().getMaxValue();
+    removeFromGrid(broadPhaseId);
+
+    // Compute the new fat AABB
+    const decimal inflatePercentage = fatAABBInflatePercentage < decimal(0.0) ? mFatAABBInflatePercentage :
+                                                                                fatAABBInflatePercentage;
+    const Vector3 gap(newAABB.getExtent() * inflatePercentage * decimal(0.5f));
+    proxy.fatAABB = AABB(newAABB.getMin() - gap, newAABB.getMax() + gap);
+
+    // Extend the fat AABB in the direction of the predicted motion of the object
+    proxy.fatAABB.extend(displacement);
+
+    mSumObjectsSizes += proxy.fatAABB.getExtent().getMaxValue();
+
+    if (isSmallEnoughForGrid(proxy.fatAABB)) {
+        addToGrid(broadPhaseId);
+    }
+    else {
+        moveToTrees(broadPhaseId);
+    }
+
+    return true;
+}
+
+// Set whether an object is static or not
+/// The current fat AABB of the object is kept. The static objects are always in the trees.
+void HashGridBroadPhase::setObjectIsStatic(int32 broadPhaseId, bool isStatic) {
+
+    assert(broadPhaseId >= 0 && broadPhaseId < static_cast<int32>(mProxies.size()));
+
+    GridProxy& proxy = mProxies[broadPhaseId];
+    assert(proxy.isInGrid || proxy.treeObjectId != -1);
+
+    if (proxy.isStatic == isStatic) return;
+
+    const decimal size = getFatAABB(broadPhaseId).getExtent().getMaxValue();
+
+    proxy.isStatic = isStatic;
+
+    if (isStatic) {
+
+        mNbNonStaticObjects--;
+        mSumObjectsSizes -= size;
+
+        if (proxy.isInGrid) {
+            removeFromGrid(broadPhaseId);
+            moveToTrees(broadPhaseId);
+        }
+        else {
+            mTreeBroadPhase.setObjectIsStatic(proxy.treeObjectId, true);
+        }
+    }
+    else {
+
+        mNbNonStaticObjects++;
+        mSumObjectsSizes += size;
+
+        mTreeBroadPhase.setObjectIsStatic(proxy.treeObjectId, false);
+        if (isSmallEnoughForGrid(mTreeBroadPhase.getFatAABB(proxy.treeObjectId))) {
+            moveToGrid(broadPhaseId);
+        }
+    }
+}
+
+// Build the grid again with a given cell size
+/// The objects are moved between the grid and the trees according to the new cell size. The
+/// fat AABBs of the objects do not change and therefore the overlapping pairs stay the same.
+void HashGridBroadPhase::rebuildGrid(decimal cellSize) {
+
+    RP3D_PROFILE("HashGridBroadPhase::rebuildGrid()", mProfiler);
+
+    assert(cellSize > decimal(0.0));
+
+    mCellSize = cellSize;
+    mInverseCellSize = decimal(1.0) / cellSize;
+
+    // Use about two buckets per object to keep the linked lists short
+    uint32 nbBuckets = MIN_NB_BUCKETS;
+    while (nbBuckets < 2 * mNbNonStaticObjects) {
+        nbBuckets *= 2;
+    }
+    mBuckets.clear();
+    mBuckets.reserve(nbBuckets);
+    for (uint32 i=0; i < nbBuckets; i++) {
+        mBuckets.add(-1);
+    }
+
+    mNbGridObjects = 0;
+    mSumObjectsSizes = decimal(0.0);
+    mGridBounds = AABB(Vector3(DECIMAL_LARGEST, DECIMAL_LARGEST, DECIMAL_LARGEST), Vector3(DECIMAL_SMALLEST, DECIMAL_SMALLEST, DECIMAL_SMALLEST));
+
+    // The objects are inserted in reverse order so that the linked lists are sorted by broad-phase ID
+    for (int32 i = static_cast<int32>(mProxies.size()) - 1; i >= 0; i--) {
+
+        GridProxy& proxy = mProxies[i];
+
+        // Skip the free proxies and the static objects
+        if (proxy.isStatic || (!proxy.isInGrid && proxy.treeObjectId == -1)) continue;
+
+        const AABB& fatAABB = getFatAABB(i);
+        const bool isSmallEnough = isSmallEnoughForGrid(fatAABB);
+        mSumObjectsSizes += fatAABB.getExtent().getMaxValue();
+
+        if (proxy.isInGrid) {
+
+            // The linked lists have been cleared
+            proxy.isInGrid = false;
+
+            if (isSmallEnough) {
+                addToGrid(i);
+            }
+            else {
+                moveToTrees(i);
+            }
+        }
+        else if (isSmallEnough) {
+            moveToGrid(i);
+        }
+    }
+}
+
+// Report the objects of the grid overlapping with an AABB
+/// An object of the grid is stored in the cell of the minimum corner of its fat AABB and is
+/// smaller than a cell. Therefore, the objects that overlap the AABB are in the cells that
+/// overlap the AABB and in the cells just before them.
+void HashGridBroadPhase::reportGridObjectsOverlappingWithAABB(const AABB& aabb, int32 broadPhaseId,
+                                                              List<Pair<int32, int32>>& overlappingPairs) const {
+
+    if (mNbGridObjects == 0) return;
+
+    int32 minCell[3];
+    int32 maxCell[3];
+    computeCell(aabb.getMin(), minCell);
+    computeCell(aabb.getMax(), maxCell);
+
+    // Check if the AABB covers more cells than there are buckets. The number of cells along each
+    // axis is compared with the remaining quotient so that the product of the numbers cannot overflow
+    const uint64 nbBuckets = mBuckets.size();
+    uint64 nbCells = 1;
+    bool isLargeAABB = false;
+    for (int i=0; i < 3; i++) {
+        minCell[i]--;
+        const uint64 nbAxisCells = static_cast<uint64>(static_cast<int64>(maxCell[i]) - minCell[i] + 1);
+        if (nbAxisCells > nbBuckets / nbCells) {
+            isLargeAABB = true;
+            break;
+        }
+        nbCells *= nbAxisCells;
+    }
+
+    // If the AABB covers more cells than there are buckets (large object), test all the objects of the grid
+    if (isLargeAABB) {
+
+        for (uint32 i=0; i < mProxies.size(); i++) {
+
+            const int32 otherId = static_cast<int32>(i);
+            if (mProxies[i].isInGrid && otherId != broadPhaseId && aabb.testCollision(mProxies[i].fatAABB)) {
+                overlappingPairs.add(Pair<int32, int32>(broadPhaseId, otherId));
+            }
+        }
+
+        return;
+    }
+
+    for (int32 x = minCell[0]; x <= maxCell[0]; x++) {
+        for (int32 y = minCell[1]; y <= maxCell[1]; y++) {
+            for (int32 z = minCell[2]; z <= maxCell[2]; z++) {
+
+                // For each object in the bucket of the cell
+                int32 otherId = mBuckets[computeBucketIndex(x, y, z)];
+                while (otherId != -1) {
+
+                    const GridProxy& otherProxy = mProxies[otherId];
+
+                    // The bucket can also contain the objects of other cells with the same hash
+                    if (otherProxy.cell[0] == x && otherProxy.cell[1] == y && otherProxy.cell[2] == z &&
+                        otherId != broadPhaseId && aabb.testCollision(otherProxy.fatAABB)) {
+
+                        overlappingPairs.add(Pair<int32, int32>(broadPhaseId, otherId));
+                    }
+
+                    otherId = otherProxy.next;
+                }
+            }
+        }
+    }
+}
+
+// Report the objects overlapping with a range of the moved objects
+/// Each moved object is tested against the objects of the grid. A moved object of the grid is
+/// also tested against the objects of the trees (the moved objects of the trees are tested against
+/// the trees by the tree broad-phase). Different ranges of the moved objects can be given to
+/// different tasks.
+void HashGridBroadPhase::reportOverlappingObjects(const List<int32>& movedObjects, uint32 startIndex, uint32 endIndex,
+                                                  List<Pair<int32, int32>>& overlappingPairs) const {
+
+    // Stack used to traverse the trees
+    Stack<int32> stack(mAllocator, 64);
+
+    for (uint32 i=startIndex; i < endIndex; i++) {
+
+        const int32 broadPhaseId = movedObjects[i];
+
+        assert(broadPhaseId != -1);
+
+        const GridProxy& proxy = mProxies[broadPhaseId];
+        const AABB& fatAABB = getFatAABB(broadPhaseId);
+
+        reportGridObjectsOverlappingWithAABB(fatAABB, broadPhaseId, overlappingPairs);
+
+        if (proxy.isInGrid) {
+
+            const uint32 startPairIndex = overlappingPairs.size();
+            mTreeBroadPhase.reportObjectsOverlappingWithAABB(fatAABB, broadPhaseId, false, stack, overlappingPairs);
+
+            // Convert the IDs of the objects of the trees
+            for (uint32 j=startPairIndex; j < overlappingPairs.size(); j++) {
+                overlappingPairs[j].second = mTreeObjectsProxies[overlappingPairs[j].second];
+            }
+        }
+    }
+}
+
+// Add all the pairs of objects with overlapping fat AABBs where at least one object has moved
+void HashGridBroadPhase::computeOverlappingPairs(MemoryManager& memoryManager, const List<int32>& movedObjects,
+                                                 List<Pair<int32, int32>>& overlappingPairs) {
+
+    RP3D_PROFILE("HashGridBroadPhase::computeOverlappingPairs()", mProfiler);
+
+    // Build the grid again if the size of the objects has changed a lot
+    // or if there are too many objects for the number of buckets
+    if (mIsCellSizeAutomatic && mNbNonStaticObjects > 0) {
+
+        const decimal cellSize = HASH_GRID_CELL_SIZE_MULTIPLIER * mSumObjectsSizes / decimal(mNbNonStaticObjects);
+        if (cellSize > decimal(2.0) * mCellSize || cellSize < decimal(0.5) * mCellSize) {
+            rebuildGrid(cellSize);
+        }
+    }
+    if (mNbGridObjects > mBuckets.size()) {
+        rebuildGrid(mCellSize);
+    }
+
+    // Compute the overlapping pairs of the moved objects of the trees within the trees
+    List<int32> movedTreeObjects(memoryManager.getPoolAllocator());
+    for (uint32 i=0; i < movedObjects.size(); i++) {
+        const GridProxy& proxy = mProxies[movedObjects[i]];
+        if (!proxy.isInGrid) {
+            movedTreeObjects.add(proxy.treeObjectId);
+        }
+    }
+    List<Pair<int32, int32>> treeOverlappingPairs(memoryManager.getPoolAllocator());
+    mTreeBroadPhase.computeOverlappingPairs(memoryManager, movedTreeObjects, treeOverlappingPairs);
+    overlappingPairs.reserve(overlappingPairs.size() + treeOverlappingPairs.size());
+    for (uint32 i=0; i < treeOverlappingPairs.size(); i++) {
+        overlappingPairs.add(Pair<int32, int32>(mTreeObjectsProxies[treeOverlappingPairs[i].first],
+                                                mTreeObjectsProxies[treeOverlappingPairs[i].second]));
+    }
+
+    // If there are enough moved objects to split the work among several threads
+    if (mTaskScheduler != nullptr && mTaskScheduler->getNbThreads() > 1 && movedObjects.size() > BROAD_PHASE_GRAIN_SIZE) {
+
+        computeOverlappingPairsParallel(memoryManager, movedObjects, overlappingPairs);
+    }
+    else {
+
+        // Report the pairs in a temporary list to remove the pairs found twice (once from each moved object)
+        List<Pair<int32, int32>> movedOverlappingPairs(memoryManager.getPoolAllocator(), 2 * movedObjects.size());
+        reportOverlappingObjects(movedObjects, 0, static_cast<uint32>(movedObjects.size()), movedOverlappingPairs);
+
+        overlappingPairs.reserve(overlappingPairs.size() + movedOverlappingPairs.size());
+        Set<uint64> reportedPairs(memoryManager.getPoolAllocator(), movedOverlappingPairs.size());
+        addPairsOnce(movedOverlappingPairs, reportedPairs, overlappingPairs);
+    }
+}
+
+// Compute the overlapping pairs of the moved objects using several threads
+/// The moved objects are split into chunks that query the grid and the trees concurrently.
+/// Each chunk writes into its own list of pairs. The lists are then merged in the order of
+/// the chunks and the pairs found twice (once from each moved object) are only kept once.
+void HashGridBroadPhase::computeOverlappingPairsParallel(MemoryManager& memoryManager, const List<int32>& movedObjects,
+                                                         List<Pair<int32, int32>>& overlappingPairs) {
+
+    const uint32 nbMovedObjects = movedObjects.size();
+    const uint32 nbChunks = (nbMovedObjects + BROAD_PHASE_GRAIN_SIZE - 1) / BROAD_PHASE_GRAIN_SIZE;
+
+    // Create one list of overlapping pairs per chunk
+    List<List<Pair<int32, int32>>> chunksOverlappingPairs(memoryManager.getPoolAllocator(), nbChunks);
+    for (uint32 i=0; i < nbChunks; i++) {
+        chunksOverlappingPairs.add(List<Pair<int32, int32>>(memoryManager.getPoolAllocator(), 2 * BROAD_PHASE_GRAIN_SIZE));
+    }
+
+    // Query the grid and the trees for each chunk of moved objects
+    mTaskScheduler->parallelFor(nbChunks, 1, [this, &movedObjects, &chunksOverlappingPairs, nbMovedObjects](uint32 startChunk, uint32 endChunk) {
+
+        for (uint32 c=startChunk; c < endChunk; c++) {
+
+            const uint32 startIndex = c * BROAD_PHASE_GRAIN_SIZE;
+            const uint32 endIndex = std::min(startIndex + BROAD_PHASE_GRAIN_SIZE, nbMovedObjects);
+            reportOverlappingObjects(movedObjects, startIndex, endIndex, chunksOverlappingPairs[c]);
+        }
+    });
+
+    // Merge the lists of the chunks and remove the duplicated pairs
+    uint32 nbPairs = 0;
+    for (uint32 i=0; i < nbChunks; i++) {
+        nbPairs += chunksOverlappingPairs[i].size();
+    }
+    overlappingPairs.reserve(overlappingPairs.size() + nbPairs);
+    Set<uint64> reportedPairs(memoryManager.getPoolAllocator(), nbPairs);
+    for (uint32 i=0; i < nbChunks; i++) {
+        addPairsOnce(chunksOverlappingPairs[i], reportedPairs, overlappingPairs);
+    }
+}
+
+// Add the pairs of a list that have not been reported yet to the overlapping pairs
+/// The set contains the IDs of the pairs already reported. The two orders of the objects
+/// of a pair have the same ID.
+void HashGridBroadPhase::addPairsOnce(const List<Pair<int32, int32>>& pairs, Set<uint64>& reportedPairs,
+                                      List<Pair<int32, int32>>& overlappingPairs) {
+
+    for (uint32 i=0; i < pairs.size(); i++) {
+
+        const Pair<int32, int32>& pair = pairs[i];
+        const uint64 pairId = pairNumbers(std::max(pair.first, pair.second), std::min(pair.first, pair.second));
+        if (reportedPairs.add(pairId)) {
+            overlappingPairs.add(pair);
+        }
+    }
+}
+
+// Visit the objects of the grid in the cells crossed by a ray
+/// The cells are traversed in the order of the ray with a 3D-DDA. The traversal stops when the
+/// next cell is beyond the maximum fraction of the ray (that can be reduced by the visitor) or
+/// when the visitor returns false. The ray is first clipped with the bounds of the grid. If it
+/// still crosses more cells than there are objects in the grid, all the objects are visited instead.
+template<typename Visitor>
+void HashGridBroadPhase::visitGridObjectsAlongRay(const Vector3& point1, const Vector3& point2, const decimal& maxFraction,
+                                                  Visitor& visitor) const {
+
+    if (mNbGridObjects == 0) return;
+
+    const Vector3 direction = point2 - point1;
+
+    // Clip the ray with the bounds of the grid
+    decimal startFraction = decimal(0.0);
+    decimal endFraction = maxFraction;
+    for (int i=0; i < 3; i++) {
+
+        if (std::abs(direction[i]) < MACHINE_EPSILON) {
+            if (point1[i] < mGridBounds.getMin()[i] || point1[i] > mGridBounds.getMax()[i]) return;
+        }
+        else {
+
+            const decimal inverseDirection = decimal(1.0) / direction[i];
+            decimal fraction1 = (mGridBounds.getMin()[i] - point1[i]) * inverseDirection;
+            decimal fraction2 = (mGridBounds.getMax()[i] - point1[i]) * inverseDirection;
+            if (fraction1 > fraction2) std::swap(fraction1, fraction2);
+
+            startFraction = std::max(startFraction, fraction1);
+            endFraction = std::min(endFraction, fraction2);
+            if (startFraction > endFraction) return;
+        }
+    }
+
+    int32 cell[3];
+    int32 endCell[3];
+    computeCell(point1 + startFraction * direction, cell);
+    computeCell(point1 + endFraction * direction, endCell);
+
+    uint64 nbCells = 1;
+    for (int i=0; i < 3; i++) {
+        const int64 nbSteps = static_cast<int64>(endCell[i]) - cell[i];
+        nbCells += static_cast<uint64>(nbSteps >= 0 ? nbSteps : -nbSteps);
+    }
+
+    // If the ray crosses more cells than there are objects in the grid, visit all the objects
+    if (nbCells > mNbGridObjects) {
+
+        for (uint32 i=0; i < mProxies.size(); i++) {
+            if (mProxies[i].isInGrid && !visitor(static_cast<int32>(i))) return;
+        }
+
+        return;
+    }
+
+    // Fraction of the ray at the next cell boundary along each axis and fraction between two boundaries
+    int32 step[3];
+    decimal nextFraction[3];
+    decimal deltaFraction[3];
+    for (int i=0; i < 3; i++) {
+
+        if (std::abs(direction[i]) < MACHINE_EPSILON) {
+            step[i] = 0;
+            nextFraction[i] = DECIMAL_LARGEST;
+            deltaFraction[i] = DECIMAL_LARGEST;
+        }
+        else {
+            step[i] = direction[i] > decimal(0.0) ? 1 : -1;
+            const decimal boundary = decimal(direction[i] > decimal(0.0) ? cell[i] + 1 : cell[i]) * mCellSize;
+            nextFraction[i] = (boundary - point1[i]) / direction[i];
+            deltaFraction[i] = mCellSize / std::abs(direction[i]);
+        }
+    }
+
+    // The number of steps is bounded in case of rounding errors
+    int previousAxis = -1;
+    for (uint64 s=0; s < nbCells + 2; s++) {
+
+        if (!visitGridObjectsInCell(cell, previousAxis, step, visitor)) return;
+
+        // Move to the next cell along the axis with the closest boundary
+        const int axis = nextFraction[0] < nextFraction[1] ? (nextFraction[0] < nextFraction[2] ? 0 : 2) :
+                                                            (nextFraction[1] < nextFraction[2] ? 1 : 2);
+        if (nextFraction[axis] > std::min(endFraction, maxFraction)) return;
+
+        cell[axis] += step[axis];
+        nextFraction[axis] += deltaFraction[axis];
+        previousAxis = axis;
+    }
+}
+
+// Visit the objects of the grid that overlap with a cell crossed by a ray
+/// The objects that overlap the cell are stored in the cell or in the cells just before it along
+/// each axis. Because the traversed cells are monotonic along each axis, an object that also
+/// overlaps the previous cell of the traversal has already been visited and is skipped. This way,
+/// each object is visited only once without having to mark it. Return false if the visitor has
+/// asked to stop the traversal.
+template<typename Visitor>
+bool HashGridBroadPhase::visitGridObjectsInCell(const int32* cell, int previousAxis, const int32* step, Visitor& visitor) const {
+
+    for (int32 dx=0; dx < 2; dx++) {
+        for (int32 dy=0; dy < 2; dy++) {
+            for (int32 dz=0; dz < 2; dz++) {
+
+                const int32 x = cell[0] - dx;
+                const int32 y = cell[1] - dy;
+                const int32 z = cell[2] - dz;
+
+                int32 broadPhaseId = mBuckets[computeBucketIndex(x, y, z)];
+                while (broadPhaseId != -1) {
+
+                    const GridProxy& proxy = mProxies[broadPhaseId];
+                    const int32 nextId = proxy.next;
+
+                    if (proxy.cell[0] == x && proxy.cell[1] == y && proxy.cell[2] == z) {
+
+                        int32 maxCell[3];
+                        computeCell(proxy.fatAABB.getMax(), maxCell);
+
+                        const bool isOverlappingCell = maxCell[0] >= cell[0] && maxCell[1] >= cell[1] && maxCell[2] >= cell[2];
+                        bool isOverlappingPreviousCell = false;
+                        if (previousAxis != -1) {
+                            const int32 previousCoordinate = cell[previousAxis] - step[previousAxis];
+                            isOverlappingPreviousCell = proxy.cell[previousAxis] <= previousCoordinate &&
+                                                        maxCell[previousAxis] >= previousCoordinate;
+                        }
+
+                        if (isOverlappingCell && !isOverlappingPreviousCell && !visitor(broadPhaseId)) return false;
+                    }
+
+                    broadPhaseId = nextId;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+// Report all the objects with a fat AABB hit by a ray to a callback
+/// The ray is cast against the trees first. The ray is then clipped with the smallest hit
+/// fraction before it is cast through the cells of the grid.
+void HashGridBroadPhase::raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const {
+
+    RP3D_PROFILE("HashGridBroadPhase::raycast()", mProfiler);
+
+    GridTreeRaycastCallback treeCallback(mTreeObjectsProxies, callback, ray.maxFraction);
+    mTreeBroadPhase.raycast(ray, treeCallback);
+
+    if (treeCallback.mIsStopped) return;
+
+    decimal maxFraction = treeCallback.mMaxFraction;
+
+    auto visitor = [&ray, &callback, &maxFraction, this](int32 broadPhaseId) {
+
+        Ray rayTemp(ray.point1, ray.point2, maxFraction);
+
+        // Test if the ray intersects with the fat AABB of the object
+        if (!mProxies[broadPhaseId].fatAABB.testRayIntersect(rayTemp)) return true;
+
+        // Call the callback that will raycast again the broad-phase shape
+        const decimal hitFraction = callback.raycastBroadPhaseShape(broadPhaseId, rayTemp);
+
+        // If the user returned a hitFraction of zero, it means that
+        // the raycasting should stop here
+        if (hitFraction == decimal(0.0)) {
+            return false;
+        }
+
+        // If the user returned a positive fraction, we update the maximum fraction.
+        // If the user returned a negative fraction, we continue the raycasting as if
+        // the object did not exist
+        if (hitFraction > decimal(0.0) && hitFraction < maxFraction) {
+            maxFraction = hitFraction;
+        }
+
+        return true;
+    };
+
+    visitGridObjectsAlongRay(ray.point1, ray.point2, maxFraction, visitor);
+}
+
+// Report all the objects with a fat AABB hit by some rays of a packet to a callback
+/// The rays are cast against the trees first. Then, each ray of the packet is cast through
+/// the cells of the grid on its own because the rays do not cross the same cells.
+void HashGridBroadPhase::raycast(RayPacket& packet, Stack<int32>& stack, DynamicAABBTreeRayPacketCallback& callback) const {
+
+    GridTreeRayPacketCallback treeCallback(mTreeObjectsProxies, callback);
+    mTreeBroadPhase.raycast(packet, stack, treeCallback);
+
+    decimal entryFractions[RayPacket::MAX_NB_RAYS];
+
+    for (uint32 i=0; i < packet.nbRays; i++) {
+
+        if (packet.maxFractions[i] < decimal(0.0)) continue;
+
+        const uint32 rayMask = 1u << i;
+
+        auto visitor = [&packet, &callback, &entryFractions, rayMask, this](int32 broadPhaseId) {
+
+            // Test if the ray intersects with the fat AABB of the object
+            if ((packet.testAABB(mProxies[broadPhaseId].fatAABB, entryFractions) & rayMask) != 0) {
+
+                // Call the callback that will raycast the ray against the broad-phase shape
+                callback.raycastBroadPhaseShape(broadPhaseId, packet, rayMask);
+            }
+
+            return true;
+        };
+
+        visitGridObjectsAlongRay(packet.points1[i], packet.points2[i], packet.maxFractions[i], visitor);
+    }
+}
+
+// Reorder the internal data of the structure in memory to make the queries more cache friendly
+/// The objects of the grid are linked again in the order of their broad-phase IDs
+void HashGridBroadPhase::compact() {
+
+    RP3D_PROFILE("HashGridBroadPhase::compact()", mProfiler);
+
+    mTreeBroadPhase.compact();
+
+    if (mCellSize > decimal(0.0)) {
+        rebuildGrid(mCellSize);
+    }
+}
+
+// Called when the fat AABB of an object of the trees is hit by a ray
+decimal GridTreeRaycastCallback::raycastBroadPhaseShape(int32 treeObjectId, const Ray& ray) {
+
+    // Report the broad-phase ID of the object in the grid broad-phase
+    const decimal hitFraction = mCallback.raycastBroadPhaseShape(mTreeObjectsProxies[treeObjectId], ray);
+
+    // If the callback has asked to stop the ray casting
+    if (hitFraction == decimal(0.0)) {
+        mIsStopped = true;
+    }
+    else if (hitFraction > decimal(0.0) && hitFraction < mMaxFraction) {
+        mMaxFraction = hitFraction;
+    }
+
+    return hitFraction;
+}
+
+// Called when the fat AABB of an object of the trees is hit by the rays of a packet in the bit mask
+void GridTreeRayPacketCallback::raycastBroadPhaseShape(int32 treeObjectId, RayPacket& packet, uint32 rayMask) {
+
+    // Report the broad-phase ID of the object in the grid broad-phase
+    mCallback.raycastBroadPhaseShape(mTreeObjectsProxies[treeObjectId], packet, rayMask);
+}
@@ -0,0 +1,450 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include <reactphysics3d/collision/broadphase/QuantizedAABBTree.h>
+#include <reactphysics3d/collision/RaycastInfo.h>
+#include <reactphysics3d/collision/RayPacket.h>
+#include <reactphysics3d/utils/Profiler.h>
+#include <cmath>
+
+using namespace reactphysics3d;
+
+// Static constants definitions
+const uint32 QuantizedTreeNode::NB_CHILDREN;
+const uint16 QuantizedTreeNode::MAX_QUANTIZED_VALUE;
+
+// Return the size of a quantization step along each axis of the AABB of a node
+inline Vector3 QuantizedAABBTree::computeQuantizationStep(const AABB& nodeAABB) {
+    return (nodeAABB.getMax() - nodeAABB.getMin()) / decimal(QuantizedTreeNode::MAX_QUANTIZED_VALUE);
+}
+
+// Return the coordinate of a quantized value along an axis of the AABB of a node
+/// The largest quantized value is exactly the maximum coordinate of the node so that
+/// the rounding errors cannot move the decoded AABBs of the children out of their parent.
+inline decimal QuantizedAABBTree::dequantize(uint16 value, decimal nodeMin, decimal nodeMax, decimal step) {
+    return value == QuantizedTreeNode::MAX_QUANTIZED_VALUE ? nodeMax : nodeMin + decimal(value) * step;
+}
+
+// Return the largest quantized value whose coordinate is smaller or equal to a minimum coordinate
+uint16 QuantizedAABBTree::quantizeMin(decimal coordinate, decimal nodeMin, decimal nodeMax, decimal step) {
+
+    if (step <= decimal(0.0)) return 0;
+
+    const decimal estimate = std::floor((coordinate - nodeMin) / step);
+    uint32 value = estimate <= decimal(0.0) ? 0 : std::min(static_cast<uint32>(estimate),
+                                                           uint32(QuantizedTreeNode::MAX_QUANTIZED_VALUE));
+
+    // Correct the estimate if a rounding error has moved the coordinate inside the child
+    while (value > 0 && dequantize(static_cast<uint16>(value), nodeMin, nodeMax, step) > coordinate) {
+        value--;
+    }
+
+    return static_cast<uint16>(value);
+}
+
+// Return the smallest quantized value whose coordinate is larger or equal to a maximum coordinate
+uint16 QuantizedAABBTree::quantizeMax(decimal coordinate, decimal nodeMin, decimal nodeMax, decimal step) {
+
+    if (step <= decimal(0.0)) return QuantizedTreeNode::MAX_QUANTIZED_VALUE;
+
+    const decimal estimate = std::ceil((coordinate - nodeMin) / step);
+    uint32 value = estimate <= decimal(0.0) ? 0 : std::min(static_cast<uint32>(estimate),
+                                                           uint32(QuantizedTreeNode::MAX_QUANTIZED_VALUE));
+
+    // Correct the estimate if a rounding error has moved the coordinate inside the child
+    while (value < QuantizedTreeNode::MAX_QUANTIZED_VALUE &&
+           dequantize(static_cast<uint16>(value), nodeMin, nodeMax, step) < coordinate) {
+        value++;
+    }
+
+    return static_cast<uint16>(value);
+}
+
+// Constructor
+QuantizedAABBTree::QuantizedAABBTree(MemoryAllocator& allocator)
+                  : mAllocator(allocator), mNodes(allocator), mLeavesData(allocator) {
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+    mProfiler = nullptr;
+
+#endif
+
+}
+
+// Build the tree by collapsing and quantizing the nodes of a dynamic AABB tree
+/// The nodes of the dynamic tree are collapsed into nodes with four children like in
+/// WideAABBTree::build(). The AABBs of the children of a node are quantized relative to the
+/// AABB of the node decoded from its own parent (and not its exact AABB) because this is the
+/// only AABB known during the queries. The minimum coordinates are rounded down and the maximum
+/// coordinates are rounded up so that a decoded AABB always contains the original one.
+void QuantizedAABBTree::build(const DynamicAABBTree& tree) {
+
+    RP3D_PROFILE("QuantizedAABBTree::build()", mProfiler);
+
+    mNodes.clear();
+    mLeavesData.clear();
+    mRootAABB = AABB();
+
+    if (tree.mRootNodeID == TreeNode::NULL_TREE_NODE) return;
+
+    mNodes.reserve(static_cast<uint32>(tree.mNbNodes) / 3 + 1);
+    mLeavesData.reserve(static_cast<uint32>(tree.mNbNodes) + 1);
+    mRootAABB = tree.mNodes[tree.mRootNodeID].aabb;
+
+    // Decoded AABBs of the nodes of the tree (only used during the build)
+    List<AABB> nodesAABBs(mAllocator, static_cast<uint32>(tree.mNbNodes) / 3 + 1);
+
+    // Nodes of the dynamic tree to collapse with the index of their quantized node
+    Stack<Pair<int32, int32>> stack(mAllocator, 64);
+    mNodes.add(QuantizedTreeNode());
+    nodesAABBs.add(mRootAABB);
+    stack.push(Pair<int32, int32>(tree.mRootNodeID, 0));
+
+    while (stack.size() > 0) {
+
+        const Pair<int32, int32> nodeToCollapse = stack.pop();
+        const TreeNode& treeNode = tree.mNodes[nodeToCollapse.first];
+
+        // Find the nodes of the dynamic tree that become the children of the quantized node
+        int32 children[QuantizedTreeNode::NB_CHILDREN];
+        uint32 nbChildren;
+        if (treeNode.isLeaf()) {
+            children[0] = nodeToCollapse.first;
+            nbChildren = 1;
+        }
+        else {
+
+            children[0] = treeNode.children[0];
+            children[1] = treeNode.children[1];
+            nbChildren = 2;
+
+            while (nbChildren < QuantizedTreeNode::NB_CHILDREN) {
+
+                // Find the internal child with the largest surface area
+                int32 largestChildIndex = -1;
+                decimal largestArea = decimal(-1.0);
+                for (uint32 i=0; i < nbChildren; i++) {
+                    const TreeNode& child = tree.mNodes[children[i]];
+                    if (!child.isLeaf() && child.aabb.getSurfaceArea() > largestArea) {
+                        largestArea = child.aabb.getSurfaceArea();
+                        largestChildIndex = static_cast<int32>(i);
+                    }
+                }
+
+                // If all the children are leaves
+                if (largestChildIndex == -1) break;
+
+                // Replace the child by its own two children
+                const TreeNode& largestChild = tree.mNodes[children[largestChildIndex]];
+                children[largestChildIndex] = largestChild.children[0];
+                children[nbChildren] = largestChild.children[1];
+                nbChildren++;
+            }
+        }
+
+        const AABB nodeAABB = nodesAABBs[nodeToCollapse.second];
+        const Vector3& nodeMin = nodeAABB.getMin();
+        const Vector3& nodeMax = nodeAABB.getMax();
+        const Vector3 step = computeQuantizationStep(nodeAABB);
+
+        // Create the quantized node (its internal children and its leaves are added
+        // next to each other at the end of the arrays)
+        QuantizedTreeNode node;
+        node.nbChildren = static_cast<uint8>(nbChildren);
+        node.leafMask = 0;
+        node.firstInternalChild = static_cast<int32>(mNodes.size());
+        node.firstLeafChild = static_cast<int32>(getNbLeaves());
+        for (uint32 i=0; i < QuantizedTreeNode::NB_CHILDREN; i++) {
+
+            // The empty slots have an inverted AABB
+            if (i >= nbChildren) {
+                node.minX[i] = node.minY[i] = node.minZ[i] = QuantizedTreeNode::MAX_QUANTIZED_VALUE;
+                node.maxX[i] = node.maxY[i] = node.maxZ[i] = 0;
+                continue;
+            }
+
+            const TreeNode& child = tree.mNodes[children[i]];
+            const Vector3& min = child.aabb.getMin();
+            const Vector3& max = child.aabb.getMax();
+            node.minX[i] = quantizeMin(min.x, nodeMin.x, nodeMax.x, step.x);
+            node.minY[i] = quantizeMin(min.y, nodeMin.y, nodeMax.y, step.y);
+            node.minZ[i] = quantizeMin(min.z, nodeMin.z, nodeMax.z, step.z);
+            node.maxX[i] = quantizeMax(max.x, nodeMin.x, nodeMax.x, step.x);
+            node.maxY[i] = quantizeMax(max.y, nodeMin.y, nodeMax.y, step.y);
+            node.maxZ[i] = quantizeMax(max.z, nodeMin.z, nodeMax.z, step.z);
+
+            if (child.isLeaf()) {
+                mLeavesData.add(child.dataInt[0]);
+                mLeavesData.add(child.dataInt[1]);
+                node.leafMask |= static_cast<uint8>(1u << i);
+            }
+            else {
+
+                // Decode the AABB of the child the same way as during the queries
+                const Vector3 childMin(dequantize(node.minX[i], nodeMin.x, nodeMax.x, step.x),
+                                       dequantize(node.minY[i], nodeMin.y, nodeMax.y, step.y),
+                                       dequantize(node.minZ[i], nodeMin.z, nodeMax.z, step.z));
+                const Vector3 childMax(dequantize(node.maxX[i], nodeMin.x, nodeMax.x, step.x),
+                                       dequantize(node.maxY[i], nodeMin.y, nodeMax.y, step.y),
+                                       dequantize(node.maxZ[i], nodeMin.z, nodeMax.z, step.z));
+
+                stack.push(Pair<int32, int32>(children[i], static_cast<int32>(mNodes.size())));
+                mNodes.add(QuantizedTreeNode());
+                nodesAABBs.add(AABB(childMin, childMax));
+            }
+        }
+
+        mNodes[nodeToCollapse.second] = node;
+    }
+}
+
+// Decode the AABBs of the children of a node into a wide tree node
+/// The children of the wide node are the indices of the internal children in the array of
+/// nodes and the indices of the leaf children in the array of leaves.
+inline void QuantizedAABBTree::decodeNode(const QuantizedTreeNode& node, const AABB& nodeAABB,
+                                          WideTreeNode& outNode) const {
+
+    const Vector3& nodeMin = nodeAABB.getMin();
+    const Vector3& nodeMax = nodeAABB.getMax();
+    const Vector3 step = computeQuantizationStep(nodeAABB);
+
+    outNode.nbChildren = node.nbChildren;
+    outNode.leafMask = node.leafMask;
+
+    int32 nextInternalChild = node.firstInternalChild;
+    int32 nextLeafChild = node.firstLeafChild;
+    for (uint32 i=0; i < QuantizedTreeNode::NB_CHILDREN; i++) {
+
+        // The empty slots have an inverted AABB that does not overlap with anything
+        if (i >= node.nbChildren) {
+            outNode.minX[i] = outNode.minY[i] = outNode.minZ[i] = DECIMAL_LARGEST;
+            outNode.maxX[i] = outNode.maxY[i] = outNode.maxZ[i] = DECIMAL_SMALLEST;
+            outNode.children[i] = TreeNode::NULL_TREE_NODE;
+            outNode.dataInt[i] = 0;
+            continue;
+        }
+
+        outNode.minX[i] = dequantize(node.minX[i], nodeMin.x, nodeMax.x, step.x);
+        outNode.minY[i] = dequantize(node.minY[i], nodeMin.y, nodeMax.y, step.y);
+        outNode.minZ[i] = dequantize(node.minZ[i], nodeMin.z, nodeMax.z, step.z);
+        outNode.maxX[i] = dequantize(node.maxX[i], nodeMin.x, nodeMax.x, step.x);
+        outNode.maxY[i] = dequantize(node.maxY[i], nodeMin.y, nodeMax.y, step.y);
+        outNode.maxZ[i] = dequantize(node.maxZ[i], nodeMin.z, nodeMax.z, step.z);
+        outNode.children[i] = (node.leafMask & (1u << i)) != 0 ? nextLeafChild++ : nextInternalChild++;
+        outNode.dataInt[i] = 0;
+    }
+}
+
+// Report the indices of all the leaves overlapping with an AABB
+void QuantizedAABBTree::reportAllShapesOverlappingWithAABB(const AABB& aabb, List<int32>& overlappingLeaves) const {
+
+    RP3D_PROFILE("QuantizedAABBTree::reportAllShapesOverlappingWithAABB()", mProfiler);
+
+    if (mNodes.size() == 0) return;
+
+    // Create a stack with the nodes to visit
+    Stack<NodeToVisit> stack(mAllocator, 64);
+    stack.push(NodeToVisit(0, mRootAABB));
+
+    // While there are still nodes to visit
+    while (stack.size() > 0) {
+
+        const NodeToVisit nodeToVisit = stack.pop();
+
+        WideTreeNode node;
+        decodeNode(mNodes[nodeToVisit.nodeIndex], nodeToVisit.aabb, node);
+
+        // Test the four children at the same time
+        uint32 overlapMask = node.testChildrenCollision(aabb);
+
+        for (uint32 i=0; overlapMask != 0; i++, overlapMask >>= 1) {
+
+            if ((overlapMask & 1) == 0) continue;
+
+            if (node.leafMask & (1u << i)) {
+                overlappingLeaves.add(node.children[i]);
+            }
+            else {
+                stack.push(NodeToVisit(node.children[i], node.getChildAABB(i)));
+            }
+        }
+    }
+}
+
+// Ray casting method
+/// The callback is called with the index of each leaf hit by the ray. The children of a node
+/// are visited in the order where they are hit by the ray so that the ray can be clipped
+/// early by the hit fractions returned by the callback.
+void QuantizedAABBTree::raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const {
+
+    RP3D_PROFILE("QuantizedAABBTree::raycast()", mProfiler);
+
+    if (mNodes.size() == 0) return;
+
+    decimal maxFraction = ray.maxFraction;
+
+    // Compute the inverse of the ray direction (a large value is used for the
+    // null components to avoid the indeterminate form zero times infinity)
+    const Vector3 direction = ray.point2 - ray.point1;
+    const Vector3 inverseDirection(direction.x != decimal(0.0) ? decimal(1.0) / direction.x : DECIMAL_LARGEST,
+                                   direction.y != decimal(0.0) ? decimal(1.0) / direction.y : DECIMAL_LARGEST,
+                                   direction.z != decimal(0.0) ? decimal(1.0) / direction.z : DECIMAL_LARGEST);
+
+    Stack<NodeToVisit> stack(mAllocator, 64);
+    stack.push(NodeToVisit(0, mRootAABB));
+
+    while (stack.size() > 0) {
+
+        const NodeToVisit nodeToVisit = stack.pop();
+
+        WideTreeNode node;
+        decodeNode(mNodes[nodeToVisit.nodeIndex], nodeToVisit.aabb, node);
+
+        // Test the ray against the four children at the same time
+        decimal hitFractions[QuantizedTreeNode::NB_CHILDREN];
+        uint32 hitMask = node.testChildrenRayIntersect(ray.point1, inverseDirection, maxFraction, hitFractions);
+
+        // Sort the hit children by increasing hit fraction
+        uint32 hitChildren[QuantizedTreeNode::NB_CHILDREN];
+        uint32 nbHitChildren = 0;
+        for (uint32 i=0; hitMask != 0; i++, hitMask >>= 1) {
+
+            if ((hitMask & 1) == 0) continue;
+
+            uint32 j = nbHitChildren;
+            while (j > 0 && hitFractions[hitChildren[j - 1]] > hitFractions[i]) {
+                hitChildren[j] = hitChildren[j - 1];
+                j--;
+            }
+            hitChildren[j] = i;
+            nbHitChildren++;
+        }
+
+        // Report the hit leaves from the closest one
+        for (uint32 i=0; i < nbHitChildren; i++) {
+
+            const uint32 childIndex = hitChildren[i];
+            if ((node.leafMask & (1u << childIndex)) == 0 || hitFractions[childIndex] > maxFraction) continue;
+
+            // Call the callback that will raycast again the broad-phase shape
+            const decimal hitFraction = callback.raycastBroadPhaseShape(node.children[childIndex],
+                                                                         Ray(ray.point1, ray.point2, maxFraction));
+
+            // If the user returned a hitFraction of zero, it means that
+            // the raycasting should stop here
+            if (hitFraction == decimal(0.0)) {
+                return;
+            }
+
+            // If the user returned a positive fraction, we clip the ray. If the user returned
+            // a negative fraction, we continue the raycasting as if the collider did not exist
+            if (hitFraction > decimal(0.0) && hitFraction < maxFraction) {
+                maxFraction = hitFraction;
+            }
+        }
+
+        // Push the internal children in the stack so that the closest one is visited first
+        for (uint32 i=nbHitChildren; i > 0; i--) {
+
+            const uint32 childIndex = hitChildren[i - 1];
+            if ((node.leafMask & (1u << childIndex)) == 0 && hitFractions[childIndex] <= maxFraction) {
+                stack.push(NodeToVisit(node.children[childIndex], node.getChildAABB(childIndex)));
+            }
+        }
+    }
+}
+
+// Ray casting method for a packet of rays
+/// The rays of the packet traverse the tree together. The callback is called with the index of
+/// each leaf hit by at least one ray and with the bit mask of the hit rays. The children of a node
+/// are visited in the order where they are entered by the rays. The stack used for the traversal
+/// is allocated with the given memory allocator.
+void QuantizedAABBTree::raycast(RayPacket& packet, MemoryAllocator& allocator,
+                                DynamicAABBTreeRayPacketCallback& callback) const {
+
+    if (mNodes.size() == 0) return;
+
+    Stack<NodeToVisit> stack(allocator, 64);
+    stack.push(NodeToVisit(0, mRootAABB));
+
+    while (stack.size() > 0) {
+
+        const NodeToVisit nodeToVisit = stack.pop();
+
+        WideTreeNode node;
+        decodeNode(mNodes[nodeToVisit.nodeIndex], nodeToVisit.aabb, node);
+
+        // Test each child against the four rays and sort the hit children by increasing
+        // fraction where the first ray enters them
+        uint32 rayMasks[QuantizedTreeNode::NB_CHILDREN];
+        decimal hitFractions[QuantizedTreeNode::NB_CHILDREN];
+        uint32 hitChildren[QuantizedTreeNode::NB_CHILDREN];
+        uint32 nbHitChildren = 0;
+        for (uint32 i=0; i < node.nbChildren; i++) {
+
+            decimal entryFractions[RayPacket::MAX_NB_RAYS];
+            const AABB childAABB = node.getChildAABB(i);
+            rayMasks[i] = packet.testAABB(childAABB.getMin(), childAABB.getMax(), entryFractions);
+            if (rayMasks[i] == 0) continue;
+
+            hitFractions[i] = DECIMAL_LARGEST;
+            for (uint32 r=0; r < RayPacket::MAX_NB_RAYS; r++) {
+                if ((rayMasks[i] & (1u << r)) != 0 && entryFractions[r] < hitFractions[i]) {
+                    hitFractions[i] = entryFractions[r];
+                }
+            }
+
+            uint32 j = nbHitChildren;
+            while (j > 0 && hitFractions[hitChildren[j - 1]] > hitFractions[i]) {
+                hitChildren[j] = hitChildren[j - 1];
+                j--;
+            }
+            hitChildren[j] = i;
+            nbHitChildren++;
+        }
+
+        // Report the hit leaves from the closest one
+        for (uint32 i=0; i < nbHitChildren; i++) {
+
+            const uint32 childIndex = hitChildren[i];
+            if ((node.leafMask & (1u << childIndex)) != 0) {
+
+                // Call the callback that will raycast the hit rays against the broad-phase shape
+                callback.raycastBroadPhaseShape(node.children[childIndex], packet, rayMasks[childIndex]);
+            }
+        }
+
+        // Push the internal children in the stack so that the closest one is visited first
+        for (uint32 i=nbHitChildren; i > 0; i--) {
+
+            const uint32 childIndex = hitChildren[i - 1];
+            if ((node.leafMask & (1u << childIndex)) == 0) {
+                stack.push(NodeToVisit(node.children[childIndex], node.getChildAABB(childIndex)));
+            }
+        }
+    }
+}
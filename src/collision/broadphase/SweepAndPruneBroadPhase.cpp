@@ -0,0 +1,437 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include <reactphysics3d/collision/broadphase/SweepAndPruneBroadPhase.h>
+#include <reactphysics3d/collision/broadphase/DynamicAABBTree.h>
+#include <reactphysics3d/collision/RayPacket.h>
+#include <reactphysics3d/engine/TaskScheduler.h>
+#include <reactphysics3d/memory/MemoryManager.h>
+#include <reactphysics3d/utils/Profiler.h>
+#include <algorithm>
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;
+
+// Static constants definitions
+const uint32 SweepAndPruneBroadPhase::MIN_NB_ADDED_OBJECTS_FULL_SORT;
+
+// Constructor
+SweepAndPruneBroadPhase::SweepAndPruneBroadPhase(MemoryAllocator& allocator, decimal fatAABBInflatePercentage,
+                                                 TaskScheduler* taskScheduler)
+                        :mAllocator(allocator), mFatAABBInflatePercentage(fatAABBInflatePercentage),
+                         mTaskScheduler(taskScheduler), mProxies(allocator), mFreeProxies(allocator),
+                         mSortedProxies(allocator), mNbRemovedProxies(0), mNbAddedProxies(0), mSweepAxis(0) {
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+    mProfiler = nullptr;
+
+#endif
+
+}
+
+// Compute the fat AABB of an object
+/// The AABB is inflated by a constant percentage of its size (as in the dynamic AABB tree).
+/// The AABB of a static object is not inflated.
+AABB SweepAndPruneBroadPhase::computeFatAABB(const AABB& aabb, bool isStatic) const {
+
+    if (isStatic) return aabb;
+
+    const Vector3 gap(aabb.getExtent() * mFatAABBInflatePercentage * decimal(0.5f));
+    return AABB(aabb.getMin() - gap, aabb.getMax() + gap);
+}
+
+// Add an object with a given AABB and return its broad-phase ID
+int32 SweepAndPruneBroadPhase::addObject(const AABB& aabb, void* data, bool isStatic) {
+
+    // Get a free proxy (or create a new one)
+    int32 broadPhaseId;
+    if (mFreeProxies.size() > 0) {
+        broadPhaseId = mFreeProxies[mFreeProxies.size() - 1];
+        mFreeProxies.removeAt(mFreeProxies.size() - 1);
+    }
+    else {
+        broadPhaseId = static_cast<int32>(mProxies.size());
+        mProxies.add(Proxy());
+    }
+
+    // Add the object at the end of the sorted array. It will be moved at
+    // its sorted position the next time the array is sorted
+    mProxies[broadPhaseId].data = data;
+    mProxies[broadPhaseId].sortedIndex = static_cast<int32>(mSortedProxies.size());
+    mSortedProxies.add(SortedProxy{computeFatAABB(aabb, isStatic), broadPhaseId, isStatic, false});
+    mNbAddedProxies++;
+
+    return broadPhaseId;
+}
+
+// Remove an object
+/// The object is only marked as removed in the sorted array. It will be removed
+/// from the array the next time the array is sorted.
+void SweepAndPruneBroadPhase::removeObject(int32 broadPhaseId) {
+
+    assert(broadPhaseId >= 0 && broadPhaseId < static_cast<int32>(mProxies.size()));
+    assert(mProxies[broadPhaseId].sortedIndex != -1);
+
+    SortedProxy& sortedProxy = mSortedProxies[mProxies[broadPhaseId].sortedIndex];
+    sortedProxy.broadPhaseId = -1;
+    sortedProxy.hasMoved = false;
+    mNbRemovedProxies++;
+
+    mProxies[broadPhaseId].data = nullptr;
+    mProxies[broadPhaseId].sortedIndex = -1;
+    mFreeProxies.add(broadPhaseId);
+}
+
+// Update the AABB of an object. Return true if the fat AABB of the object has changed
+bool SweepAndPruneBroadPhase::updateObject(int32 broadPhaseId, const AABB& newAABB, const Vector3& displacement,
+                                           decimal fatAABBInflatePercentage, bool forceReInsert) {
+
+    RP3D_PROFILE("SweepAndPruneBroadPhase::updateObject()", mProfiler);
+
+    assert(broadPhaseId >= 0 && broadPhaseId < static_cast<int32>(mProxies.size()));
+    assert(mProxies[broadPhaseId].sortedIndex != -1);
+
+    SortedProxy& sortedProxy = mSortedProxies[mProxies[broadPhaseId].sortedIndex];
+
+    // If the new AABB is still inside the fat AABB of the object
+    if (!forceReInsert && sortedProxy.fatAABB.contains(newAABB)) {
+        return false;
+    }
+
+    // Compute the new fat AABB. The array will be sorted again before the next sweep
+    if (sortedProxy.isStatic) {
+        sortedProxy.fatAABB = newAABB;
+    }
+    else {
+
+        const decimal inflatePercentage = fatAABBInflatePercentage < decimal(0.0) ? mFatAABBInflatePercentage :
+                                                                                    fatAABBInflatePercentage;
+        const Vector3 gap(newAABB.getExtent() * inflatePercentage * decimal(0.5f));
+        sortedProxy.fatAABB = AABB(newAABB.getMin() - gap, newAABB.getMax() + gap);
+
+        // Extend the fat AABB in the direction of the predicted motion of the object
+        sortedProxy.fatAABB.extend(displacement);
+    }
+
+    return true;
+}
+
+// Set whether an object is static or not
+/// The current fat AABB of the object is kept (and inflated if the object is not static anymore)
+void SweepAndPruneBroadPhase::setObjectIsStatic(int32 broadPhaseId, bool isStatic) {
+
+    assert(broadPhaseId >= 0 && broadPhaseId < static_cast<int32>(mProxies.size()));
+    assert(mProxies[broadPhaseId].sortedIndex != -1);
+
+    SortedProxy& sortedProxy = mSortedProxies[mProxies[broadPhaseId].sortedIndex];
+    if (sortedProxy.isStatic == isStatic) return;
+
+    sortedProxy.fatAABB = computeFatAABB(sortedProxy.fatAABB, isStatic);
+    sortedProxy.isStatic = isStatic;
+}
+
+// Select the sweep axis with the largest variance of the AABB centers
+/// The variance is computed relative to the first center to limit the loss of precision.
+/// To avoid switching between two axes at each frame, the current axis is kept unless
+/// the variance of another axis is clearly larger.
+int SweepAndPruneBroadPhase::computeSweepAxis() const {
+
+    Vector3 reference;
+    Vector3 sum(0, 0, 0);
+    Vector3 sumSquares(0, 0, 0);
+    uint32 nbObjects = 0;
+    for (uint32 i=0; i < mSortedProxies.size(); i++) {
+
+        if (mSortedProxies[i].broadPhaseId == -1) continue;
+
+        const Vector3 center = mSortedProxies[i].fatAABB.getCenter();
+        if (nbObjects == 0) {
+            reference = center;
+        }
+
+        const Vector3 offset = center - reference;
+        sum += offset;
+        sumSquares += offset * offset;
+        nbObjects++;
+    }
+
+    if (nbObjects < 2) return mSweepAxis;
+
+    const decimal invNbObjects = decimal(1.0) / decimal(nbObjects);
+    const Vector3 mean = sum * invNbObjects;
+    const Vector3 variance = sumSquares * invNbObjects - mean * mean;
+
+    const int maxAxis = variance.getMaxAxis();
+    return variance[maxAxis] > decimal(1.5) * variance[mSweepAxis] ? maxAxis : mSweepAxis;
+}
+
+// Remove the removed objects from the sorted array and sort it
+/// Most of the time, the objects have only moved a little since the last sort and the array
+/// is almost sorted. Therefore, we use an insertion sort. The array is sorted from scratch
+/// when the sweep axis has changed or when many objects have been added.
+void SweepAndPruneBroadPhase::sortProxies() {
+
+    RP3D_PROFILE("SweepAndPruneBroadPhase::sortProxies()", mProfiler);
+
+    const int sweepAxis = computeSweepAxis();
+    const uint32 nbSortedProxies = static_cast<uint32>(mSortedProxies.size());
+
+    const bool isFullSortNeeded = sweepAxis != mSweepAxis ||
+                                  (mNbAddedProxies >= MIN_NB_ADDED_OBJECTS_FULL_SORT && mNbAddedProxies * 8 > nbSortedProxies);
+    mSweepAxis = sweepAxis;
+
+    uint32 nbProxies = 0;
+
+    if (isFullSortNeeded) {
+
+        // Remove the removed objects
+        for (uint32 i=0; i < nbSortedProxies; i++) {
+            if (mSortedProxies[i].broadPhaseId != -1) {
+                mSortedProxies[nbProxies] = mSortedProxies[i];
+                nbProxies++;
+            }
+        }
+
+        if (nbProxies > 0) {
+            std::sort(&(mSortedProxies[0]), &(mSortedProxies[0]) + nbProxies,
+                      [sweepAxis](const SortedProxy& proxy1, const SortedProxy& proxy2) {
+                return proxy1.fatAABB.getMin()[sweepAxis] < proxy2.fatAABB.getMin()[sweepAxis];
+            });
+        }
+
+        for (uint32 i=0; i < nbProxies; i++) {
+            mProxies[mSortedProxies[i].broadPhaseId].sortedIndex = static_cast<int32>(i);
+        }
+    }
+    else {
+
+        // Insertion sort that also removes the removed objects
+        for (uint32 i=0; i < nbSortedProxies; i++) {
+
+            if (mSortedProxies[i].broadPhaseId == -1) continue;
+
+            const SortedProxy sortedProxy = mSortedProxies[i];
+            const decimal minCoordinate = sortedProxy.fatAABB.getMin()[sweepAxis];
+
+            uint32 j = nbProxies;
+            while (j > 0 && mSortedProxies[j - 1].fatAABB.getMin()[sweepAxis] > minCoordinate) {
+                mSortedProxies[j] = mSortedProxies[j - 1];
+                mProxies[mSortedProxies[j].broadPhaseId].sortedIndex = static_cast<int32>(j);
+                j--;
+            }
+
+            mSortedProxies[j] = sortedProxy;
+            mProxies[sortedProxy.broadPhaseId].sortedIndex = static_cast<int32>(j);
+            nbProxies++;
+        }
+    }
+
+    // Remove the unused elements at the end of the array
+    while (mSortedProxies.size() > nbProxies) {
+        mSortedProxies.removeAt(static_cast<uint>(mSortedProxies.size() - 1));
+    }
+
+    mNbRemovedProxies = 0;
+    mNbAddedProxies = 0;
+}
+
+// Find the overlapping pairs of the objects in a range of the sorted array
+/// Each object is only tested against the following objects of the sorted array that
+/// overlap with it along the sweep axis. Therefore, each pair is reported only once. The pairs
+/// of two static objects are skipped. Different ranges can be swept by different tasks.
+void SweepAndPruneBroadPhase::sweepProxies(uint32 startIndex, uint32 endIndex, List<Pair<int32, int32>>& overlappingPairs) const {
+
+    const uint32 nbProxies = static_cast<uint32>(mSortedProxies.size());
+
+    for (uint32 i=startIndex; i < endIndex; i++) {
+
+        const SortedProxy& sortedProxy1 = mSortedProxies[i];
+        const decimal maxCoordinate = sortedProxy1.fatAABB.getMax()[mSweepAxis];
+
+        for (uint32 j=i+1; j < nbProxies && mSortedProxies[j].fatAABB.getMin()[mSweepAxis] <= maxCoordinate; j++) {
+
+            const SortedProxy& sortedProxy2 = mSortedProxies[j];
+
+            // At least one of the two objects must have moved and must not be static
+            if (!sortedProxy1.hasMoved && !sortedProxy2.hasMoved) continue;
+            if (sortedProxy1.isStatic && sortedProxy2.isStatic) continue;
+
+            if (sortedProxy1.fatAABB.testCollision(sortedProxy2.fatAABB)) {
+
+                // The moved object is reported first (as with the dynamic AABB tree)
+                if (sortedProxy1.hasMoved) {
+                    overlappingPairs.add(Pair<int32, int32>(sortedProxy1.broadPhaseId, sortedProxy2.broadPhaseId));
+                }
+                else {
+                    overlappingPairs.add(Pair<int32, int32>(sortedProxy2.broadPhaseId, sortedProxy1.broadPhaseId));
+                }
+            }
+        }
+    }
+}
+
+// Add all the pairs of objects with overlapping fat AABBs where at least one object has moved
+void SweepAndPruneBroadPhase::computeOverlappingPairs(MemoryManager& memoryManager, const List<int32>& movedObjects,
+                                                      List<Pair<int32, int32>>& overlappingPairs) {
+
+    RP3D_PROFILE("SweepAndPruneBroadPhase::computeOverlappingPairs()", mProfiler);
+
+    // Sort the objects along the sweep axis
+    sortProxies();
+
+    if (movedObjects.size() == 0) return;
+
+    // Flag the moved objects
+    for (uint32 i=0; i < movedObjects.size(); i++) {
+        mSortedProxies[mProxies[movedObjects[i]].sortedIndex].hasMoved = true;
+    }
+
+    const uint32 nbProxies = static_cast<uint32>(mSortedProxies.size());
+
+    // If there are enough objects to split the sweep among several threads
+    if (mTaskScheduler != nullptr && mTaskScheduler->getNbThreads() > 1 && nbProxies > PARALLEL_FOR_GRAIN_SIZE) {
+
+        const uint32 nbChunks = (nbProxies + PARALLEL_FOR_GRAIN_SIZE - 1) / PARALLEL_FOR_GRAIN_SIZE;
+
+        // Create one list of overlapping pairs per chunk
+        List<List<Pair<int32, int32>>> chunksOverlappingPairs(memoryManager.getPoolAllocator(), nbChunks);
+        for (uint32 i=0; i < nbChunks; i++) {
+            chunksOverlappingPairs.add(List<Pair<int32, int32>>(memoryManager.getPoolAllocator(), PARALLEL_FOR_GRAIN_SIZE));
+        }
+
+        // Sweep each chunk of the sorted array
+        mTaskScheduler->parallelFor(nbChunks, 1, [this, &chunksOverlappingPairs, nbProxies](uint32 startChunk, uint32 endChunk) {
+
+            for (uint32 c=startChunk; c < endChunk; c++) {
+
+                const uint32 startIndex = c * PARALLEL_FOR_GRAIN_SIZE;
+                const uint32 endIndex = std::min(startIndex + PARALLEL_FOR_GRAIN_SIZE, nbProxies);
+                sweepProxies(startIndex, endIndex, chunksOverlappingPairs[c]);
+            }
+        });
+
+        // Merge the lists of the chunks in order (a pair is only found by a single chunk)
+        for (uint32 i=0; i < nbChunks; i++) {
+            overlappingPairs.addRange(chunksOverlappingPairs[i]);
+        }
+    }
+    else {
+        sweepProxies(0, nbProxies, overlappingPairs);
+    }
+
+    // Reset the flags of the moved objects
+    for (uint32 i=0; i < movedObjects.size(); i++) {
+        mSortedProxies[mProxies[movedObjects[i]].sortedIndex].hasMoved = false;
+    }
+}
+
+// Report all the objects with a fat AABB hit by a ray to a callback
+/// The array may not be sorted anymore if some objects have been updated since the last
+/// sweep. Therefore, all the objects that overlap the ray along the sweep axis are tested.
+void SweepAndPruneBroadPhase::raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const {
+
+    RP3D_PROFILE("SweepAndPruneBroadPhase::raycast()", mProfiler);
+
+    decimal maxFraction = ray.maxFraction;
+
+    // Interval of the ray along the sweep axis
+    const Vector3 rayEnd = ray.point1 + maxFraction * (ray.point2 - ray.point1);
+    const decimal rayMin = std::min(ray.point1[mSweepAxis], rayEnd[mSweepAxis]);
+    const decimal rayMax = std::max(ray.point1[mSweepAxis], rayEnd[mSweepAxis]);
+
+    for (uint32 i=0; i < mSortedProxies.size(); i++) {
+
+        const SortedProxy& sortedProxy = mSortedProxies[i];
+
+        // Skip the removed objects and the objects that do not overlap the ray along the sweep axis
+        if (sortedProxy.broadPhaseId == -1) continue;
+        if (sortedProxy.fatAABB.getMin()[mSweepAxis] > rayMax || sortedProxy.fatAABB.getMax()[mSweepAxis] < rayMin) continue;
+
+        Ray rayTemp(ray.point1, ray.point2, maxFraction);
+
+        // Test if the ray intersects with the fat AABB of the object
+        if (!sortedProxy.fatAABB.testRayIntersect(rayTemp)) continue;
+
+        // Call the callback that will raycast again the broad-phase shape
+        decimal hitFraction = callback.raycastBroadPhaseShape(sortedProxy.broadPhaseId, rayTemp);
+
+        // If the user returned a hitFraction of zero, it means that
+        // the raycasting should stop here
+        if (hitFraction == decimal(0.0)) {
+            return;
+        }
+
+        // If the user returned a positive fraction, we update the maximum fraction.
+        // If the user returned a negative fraction, we continue the raycasting as if
+        // the object did not exist
+        if (hitFraction > decimal(0.0) && hitFraction < maxFraction) {
+            maxFraction = hitFraction;
+        }
+    }
+}
+
+// Report all the objects with a fat AABB hit by some rays of a packet to a callback
+/// The sorted objects are tested against the four rays at the same time. This method is not
+/// profiled because it can be called by several threads at the same time.
+void SweepAndPruneBroadPhase::raycast(RayPacket& packet, Stack<int32>&, DynamicAABBTreeRayPacketCallback& callback) const {
+
+    // Interval of the rays along the sweep axis
+    decimal rayMin = DECIMAL_LARGEST;
+    decimal rayMax = DECIMAL_SMALLEST;
+    for (uint32 i=0; i < packet.nbRays; i++) {
+
+        if (packet.maxFractions[i] < decimal(0.0)) continue;
+
+        const Vector3 rayEnd = packet.points1[i] + packet.maxFractions[i] * (packet.points2[i] - packet.points1[i]);
+        rayMin = std::min(rayMin, std::min(packet.points1[i][mSweepAxis], rayEnd[mSweepAxis]));
+        rayMax = std::max(rayMax, std::max(packet.points1[i][mSweepAxis], rayEnd[mSweepAxis]));
+    }
+
+    decimal entryFractions[RayPacket::MAX_NB_RAYS];
+
+    for (uint32 i=0; i < mSortedProxies.size(); i++) {
+
+        const SortedProxy& sortedProxy = mSortedProxies[i];
+
+        // Skip the removed objects and the objects that do not overlap the rays along the sweep axis
+        if (sortedProxy.broadPhaseId == -1) continue;
+        if (sortedProxy.fatAABB.getMin()[mSweepAxis] > rayMax || sortedProxy.fatAABB.getMax()[mSweepAxis] < rayMin) continue;
+
+        // Test if the rays intersect with the fat AABB of the object
+        const uint32 rayMask = packet.testAABB(sortedProxy.fatAABB, entryFractions);
+        if (rayMask == 0) continue;
+
+        // Call the callback that will raycast the hit rays against the broad-phase shape
+        callback.raycastBroadPhaseShape(sortedProxy.broadPhaseId, packet, rayMask);
+    }
+}
+
+// Reorder the internal data of the structure in memory to make the queries more cache friendly
+/// Nothing to do here because the sorted array is already compacted at each sweep
+void SweepAndPruneBroadPhase::compact() {
+
+}
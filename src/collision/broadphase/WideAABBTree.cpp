@@ -0,0 +1,470 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include <reactphysics3d/collision/broadphase/WideAABBTree.h>
+#include <reactphysics3d/collision/RaycastInfo.h>
+#include <reactphysics3d/collision/RayPacket.h>
+#include <reactphysics3d/utils/Profiler.h>
+
+// The AABBs of the four children of a node are tested with SSE instructions
+// when they are available
+#ifdef RP3D_SSE_ENABLED
+    #include <xmmintrin.h>
+#endif
+
+using namespace reactphysics3d;
+
+// Static constants definitions
+const uint32 WideTreeNode::NB_CHILDREN;
+
+// Constructor
+WideAABBTree::WideAABBTree(MemoryAllocator& allocator) : mAllocator(allocator), mNodes(allocator) {
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+    mProfiler = nullptr;
+
+#endif
+
+}
+
+// Build the tree by collapsing the nodes of a dynamic AABB tree
+/// Each internal node of the dynamic tree is replaced by its two children, starting with the
+/// child of largest surface area, until a wide node has four children. Therefore, about half of
+/// the levels of the dynamic tree disappear in the wide tree.
+void WideAABBTree::build(const DynamicAABBTree& tree) {
+
+    RP3D_PROFILE("WideAABBTree::build()", mProfiler);
+
+    mNodes.clear();
+
+    if (tree.mRootNodeID == TreeNode::NULL_TREE_NODE) return;
+
+    mNodes.reserve(static_cast<uint32>(tree.mNbNodes) / 4 + 1);
+
+    // Nodes of the dynamic tree to collapse with the index of their wide node
+    Stack<Pair<int32, int32>> stack(mAllocator, 64);
+    mNodes.add(WideTreeNode());
+    stack.push(Pair<int32, int32>(tree.mRootNodeID, 0));
+
+    while (stack.size() > 0) {
+
+        const Pair<int32, int32> nodeToCollapse = stack.pop();
+        const TreeNode& treeNode = tree.mNodes[nodeToCollapse.first];
+
+        // Find the nodes of the dynamic tree that become the children of the wide node
+        int32 children[WideTreeNode::NB_CHILDREN];
+        uint32 nbChildren;
+        if (treeNode.isLeaf()) {
+            children[0] = nodeToCollapse.first;
+            nbChildren = 1;
+        }
+        else {
+
+            children[0] = treeNode.children[0];
+            children[1] = treeNode.children[1];
+            nbChildren = 2;
+
+            while (nbChildren < WideTreeNode::NB_CHILDREN) {
+
+                // Find the internal child with the largest surface area
+                int32 largestChildIndex = -1;
+                decimal largestArea = decimal(-1.0);
+                for (uint32 i=0; i < nbChildren; i++) {
+                    const TreeNode& child = tree.mNodes[children[i]];
+                    if (!child.isLeaf() && child.aabb.getSurfaceArea() > largestArea) {
+                        largestArea = child.aabb.getSurfaceArea();
+                        largestChildIndex = static_cast<int32>(i);
+                    }
+                }
+
+                // If all the children are leaves
+                if (largestChildIndex == -1) break;
+
+                // Replace the child by its own two children
+                const TreeNode& largestChild = tree.mNodes[children[largestChildIndex]];
+                children[largestChildIndex] = largestChild.children[0];
+                children[nbChildren] = largestChild.children[1];
+                nbChildren++;
+            }
+        }
+
+        // Create the wide node
+        WideTreeNode node;
+        node.nbChildren = static_cast<uint8>(nbChildren);
+        node.leafMask = 0;
+        for (uint32 i=0; i < WideTreeNode::NB_CHILDREN; i++) {
+
+            // The empty slots have an inverted AABB that does not overlap with anything
+            if (i >= nbChildren) {
+                node.minX[i] = node.minY[i] = node.minZ[i] = DECIMAL_LARGEST;
+                node.maxX[i] = node.maxY[i] = node.maxZ[i] = DECIMAL_SMALLEST;
+                node.children[i] = TreeNode::NULL_TREE_NODE;
+                node.dataInt[i] = 0;
+                continue;
+            }
+
+            const TreeNode& child = tree.mNodes[children[i]];
+            const Vector3& min = child.aabb.getMin();
+            const Vector3& max = child.aabb.getMax();
+            node.minX[i] = min.x;
+            node.minY[i] = min.y;
+            node.minZ[i] = min.z;
+            node.maxX[i] = max.x;
+            node.maxY[i] = max.y;
+            node.maxZ[i] = max.z;
+
+            if (child.isLeaf()) {
+                node.children[i] = children[i];
+                node.dataInt[i] = child.dataInt[0];
+                node.leafMask |= static_cast<uint8>(1u << i);
+            }
+            else {
+                node.children[i] = static_cast<int32>(mNodes.size());
+                node.dataInt[i] = 0;
+                mNodes.add(WideTreeNode());
+                stack.push(Pair<int32, int32>(children[i], node.children[i]));
+            }
+        }
+
+        mNodes[nodeToCollapse.second] = node;
+    }
+}
+
+// Remove all the nodes of the tree
+/// The memory of the nodes is kept to build the tree again later
+void WideAABBTree::reset() {
+    mNodes.clear();
+}
+
+// Return the bit mask of the children that overlap with an AABB
+uint32 WideTreeNode::testChildrenCollision(const AABB& aabb) const {
+
+    const Vector3& min = aabb.getMin();
+    const Vector3& max = aabb.getMax();
+
+#ifdef RP3D_SSE_ENABLED
+
+    const __m128 overlapX = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(minX), _mm_set1_ps(max.x)),
+                                       _mm_cmpge_ps(_mm_loadu_ps(maxX), _mm_set1_ps(min.x)));
+    const __m128 overlapY = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(minY), _mm_set1_ps(max.y)),
+                                       _mm_cmpge_ps(_mm_loadu_ps(maxY), _mm_set1_ps(min.y)));
+    const __m128 overlapZ = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(minZ), _mm_set1_ps(max.z)),
+                                       _mm_cmpge_ps(_mm_loadu_ps(maxZ), _mm_set1_ps(min.z)));
+
+    return static_cast<uint32>(_mm_movemask_ps(_mm_and_ps(_mm_and_ps(overlapX, overlapY), overlapZ)));
+
+#else
+
+    uint32 mask = 0;
+    for (uint32 i=0; i < NB_CHILDREN; i++) {
+        const bool isOverlapping = minX[i] <= max.x && maxX[i] >= min.x &&
+                                   minY[i] <= max.y && maxY[i] >= min.y &&
+                                   minZ[i] <= max.z && maxZ[i] >= min.z;
+        mask |= static_cast<uint32>(isOverlapping) << i;
+    }
+
+    return mask;
+
+#endif
+
+}
+
+// Return the bit mask of the children that are hit by a ray segment
+/// This is the slab test of the four AABBs with the ray point1 + t * (point2 - point1) where
+/// t is in [0, maxFraction]. The fraction where the ray enters each AABB is also returned.
+uint32 WideTreeNode::testChildrenRayIntersect(const Vector3& origin, const Vector3& inverseDirection,
+                                              decimal maxFraction, decimal* outHitFractions) const {
+
+    // Tolerance to counteract arithmetic errors when the ray grazes an AABB
+    const decimal epsilon = decimal(0.00001);
+
+#ifdef RP3D_SSE_ENABLED
+
+    const __m128 originX = _mm_set1_ps(origin.x);
+    const __m128 originY = _mm_set1_ps(origin.y);
+    const __m128 originZ = _mm_set1_ps(origin.z);
+    const __m128 inverseDirectionX = _mm_set1_ps(inverseDirection.x);
+    const __m128 inverseDirectionY = _mm_set1_ps(inverseDirection.y);
+    const __m128 inverseDirectionZ = _mm_set1_ps(inverseDirection.z);
+
+    const __m128 t1X = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(minX), originX), inverseDirectionX);
+    const __m128 t2X = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(maxX), originX), inverseDirectionX);
+    const __m128 t1Y = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(minY), originY), inverseDirectionY);
+    const __m128 t2Y = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(maxY), originY), inverseDirectionY);
+    const __m128 t1Z = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(minZ), originZ), inverseDirectionZ);
+    const __m128 t2Z = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(maxZ), originZ), inverseDirectionZ);
+
+    __m128 tMin = _mm_max_ps(_mm_max_ps(_mm_min_ps(t1X, t2X), _mm_min_ps(t1Y, t2Y)), _mm_min_ps(t1Z, t2Z));
+    __m128 tMax = _mm_min_ps(_mm_min_ps(_mm_max_ps(t1X, t2X), _mm_max_ps(t1Y, t2Y)), _mm_max_ps(t1Z, t2Z));
+    tMin = _mm_max_ps(tMin, _mm_setzero_ps());
+    tMax = _mm_add_ps(_mm_min_ps(tMax, _mm_set1_ps(maxFraction)), _mm_set1_ps(epsilon));
+
+    _mm_storeu_ps(outHitFractions, tMin);
+
+    return static_cast<uint32>(_mm_movemask_ps(_mm_cmple_ps(tMin, tMax))) & ((1u << nbChildren) - 1);
+
+#else
+
+    uint32 mask = 0;
+    for (uint32 i=0; i < NB_CHILDREN; i++) {
+
+        const decimal t1X = (minX[i] - origin.x) * inverseDirection.x;
+        const decimal t2X = (maxX[i] - origin.x) * inverseDirection.x;
+        const decimal t1Y = (minY[i] - origin.y) * inverseDirection.y;
+        const decimal t2Y = (maxY[i] - origin.y) * inverseDirection.y;
+        const decimal t1Z = (minZ[i] - origin.z) * inverseDirection.z;
+        const decimal t2Z = (maxZ[i] - origin.z) * inverseDirection.z;
+
+        const decimal tMin = std::max(std::max(std::max(std::min(t1X, t2X), std::min(t1Y, t2Y)), std::min(t1Z, t2Z)), decimal(0.0));
+        const decimal tMax = std::min(std::min(std::min(std::max(t1X, t2X), std::max(t1Y, t2Y)), std::max(t1Z, t2Z)), maxFraction);
+
+        outHitFractions[i] = tMin;
+        mask |= static_cast<uint32>(tMin <= tMax + epsilon) << i;
+    }
+
+    return mask & ((1u << nbChildren) - 1);
+
+#endif
+
+}
+
+// Report the dynamic tree node IDs of all the leaves overlapping with an AABB
+void WideAABBTree::reportAllShapesOverlappingWithAABB(const AABB& aabb, List<int32>& overlappingNodes) const {
+
+    RP3D_PROFILE("WideAABBTree::reportAllShapesOverlappingWithAABB()", mProfiler);
+
+    if (mNodes.size() == 0) return;
+
+    // Create a stack with the nodes to visit
+    Stack<int32> stack(mAllocator, 64);
+    stack.push(0);
+
+    // While there are still nodes to visit
+    while (stack.size() > 0) {
+
+        const WideTreeNode& node = mNodes[stack.pop()];
+
+        // Test the four children at the same time
+        uint32 overlapMask = node.testChildrenCollision(aabb);
+
+        for (uint32 i=0; overlapMask != 0; i++, overlapMask >>= 1) {
+
+            if ((overlapMask & 1) == 0) continue;
+
+            if (node.leafMask & (1u << i)) {
+                overlappingNodes.add(node.children[i]);
+            }
+            else {
+                stack.push(node.children[i]);
+            }
+        }
+    }
+}
+
+// Report all the leaves overlapping with an AABB as pairs of an object ID and the first data integer of the leaf
+/// The stack used for the traversal is given by the caller so that it can be reused between queries.
+/// The tree is only read here so that several tasks can query it at the same time.
+void WideAABBTree::reportAllShapesOverlappingWithAABB(const AABB& aabb, int32 objectId, Stack<int32>& stack,
+                                                      List<Pair<int32, int32>>& outOverlappingPairs) const {
+
+    assert(stack.size() == 0);
+
+    if (mNodes.size() == 0) return;
+
+    stack.push(0);
+
+    // While there are still nodes to visit
+    while (stack.size() > 0) {
+
+        const WideTreeNode& node = mNodes[stack.pop()];
+
+        // Test the four children at the same time
+        uint32 overlapMask = node.testChildrenCollision(aabb);
+
+        for (uint32 i=0; overlapMask != 0; i++, overlapMask >>= 1) {
+
+            if ((overlapMask & 1) == 0) continue;
+
+            if (node.leafMask & (1u << i)) {
+                outOverlappingPairs.add(Pair<int32, int32>(objectId, node.dataInt[i]));
+            }
+            else {
+                stack.push(node.children[i]);
+            }
+        }
+    }
+}
+
+// Ray casting method
+/// The callback is called with the dynamic tree node ID of each leaf hit by the ray. The
+/// children of a node are visited in the order where they are hit by the ray so that the
+/// ray can be clipped early by the hit fractions returned by the callback.
+void WideAABBTree::raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const {
+
+    RP3D_PROFILE("WideAABBTree::raycast()", mProfiler);
+
+    if (mNodes.size() == 0) return;
+
+    decimal maxFraction = ray.maxFraction;
+
+    // Compute the inverse of the ray direction (a large value is used for the
+    // null components to avoid the indeterminate form zero times infinity)
+    const Vector3 direction = ray.point2 - ray.point1;
+    const Vector3 inverseDirection(direction.x != decimal(0.0) ? decimal(1.0) / direction.x : DECIMAL_LARGEST,
+                                   direction.y != decimal(0.0) ? decimal(1.0) / direction.y : DECIMAL_LARGEST,
+                                   direction.z != decimal(0.0) ? decimal(1.0) / direction.z : DECIMAL_LARGEST);
+
+    Stack<int32> stack(mAllocator, 64);
+    stack.push(0);
+
+    while (stack.size() > 0) {
+
+        const WideTreeNode& node = mNodes[stack.pop()];
+
+        // Test the ray against the four children at the same time
+        decimal hitFractions[WideTreeNode::NB_CHILDREN];
+        uint32 hitMask = node.testChildrenRayIntersect(ray.point1, inverseDirection, maxFraction, hitFractions);
+
+        // Sort the hit children by increasing hit fraction
+        uint32 hitChildren[WideTreeNode::NB_CHILDREN];
+        uint32 nbHitChildren = 0;
+        for (uint32 i=0; hitMask != 0; i++, hitMask >>= 1) {
+
+            if ((hitMask & 1) == 0) continue;
+
+            uint32 j = nbHitChildren;
+            while (j > 0 && hitFractions[hitChildren[j - 1]] > hitFractions[i]) {
+                hitChildren[j] = hitChildren[j - 1];
+                j--;
+            }
+            hitChildren[j] = i;
+            nbHitChildren++;
+        }
+
+        // Report the hit leaves from the closest one
+        for (uint32 i=0; i < nbHitChildren; i++) {
+
+            const uint32 childIndex = hitChildren[i];
+            if ((node.leafMask & (1u << childIndex)) == 0 || hitFractions[childIndex] > maxFraction) continue;
+
+            // Call the callback that will raycast again the broad-phase shape
+            const decimal hitFraction = callback.raycastBroadPhaseShape(node.children[childIndex],
+                                                                         Ray(ray.point1, ray.point2, maxFraction));
+
+            // If the user returned a hitFraction of zero, it means that
+            // the raycasting should stop here
+            if (hitFraction == decimal(0.0)) {
+                return;
+            }
+
+            // If the user returned a positive fraction, we clip the ray. If the user returned
+            // a negative fraction, we continue the raycasting as if the collider did not exist
+            if (hitFraction > decimal(0.0) && hitFraction < maxFraction) {
+                maxFraction = hitFraction;
+            }
+        }
+
+        // Push the internal children in the stack so that the closest one is visited first
+        for (uint32 i=nbHitChildren; i > 0; i--) {
+
+            const uint32 childIndex = hitChildren[i - 1];
+            if ((node.leafMask & (1u << childIndex)) == 0 && hitFractions[childIndex] <= maxFraction) {
+                stack.push(node.children[childIndex]);
+            }
+        }
+    }
+}
+
+// Ray casting method for a packet of rays
+/// The rays of the packet traverse the tree together and each child of a node is tested
+/// against the four rays at the same time. The callback is called with the dynamic tree node
+/// ID of each leaf hit by at least one ray and with the bit mask of the hit rays. The children of
+/// a node are visited in the order where they are entered by the rays. The stack used for the
+/// traversal is given by the caller so that it can be reused between packets. This method is not
+/// profiled because it can be called by several threads at the same time.
+void WideAABBTree::raycast(RayPacket& packet, Stack<int32>& stack, DynamicAABBTreeRayPacketCallback& callback) const {
+
+    assert(stack.size() == 0);
+
+    if (mNodes.size() == 0) return;
+
+    stack.push(0);
+
+    while (stack.size() > 0) {
+
+        const WideTreeNode& node = mNodes[stack.pop()];
+
+        // Test each child against the four rays and sort the hit children by increasing
+        // fraction where the first ray enters them
+        uint32 rayMasks[WideTreeNode::NB_CHILDREN];
+        decimal hitFractions[WideTreeNode::NB_CHILDREN];
+        uint32 hitChildren[WideTreeNode::NB_CHILDREN];
+        uint32 nbHitChildren = 0;
+        for (uint32 i=0; i < node.nbChildren; i++) {
+
+            decimal entryFractions[RayPacket::MAX_NB_RAYS];
+            rayMasks[i] = packet.testAABB(Vector3(node.minX[i], node.minY[i], node.minZ[i]),
+                                          Vector3(node.maxX[i], node.maxY[i], node.maxZ[i]), entryFractions);
+            if (rayMasks[i] == 0) continue;
+
+            hitFractions[i] = DECIMAL_LARGEST;
+            for (uint32 r=0; r < RayPacket::MAX_NB_RAYS; r++) {
+                if ((rayMasks[i] & (1u << r)) != 0 && entryFractions[r] < hitFractions[i]) {
+                    hitFractions[i] = entryFractions[r];
+                }
+            }
+
+            uint32 j = nbHitChildren;
+            while (j > 0 && hitFractions[hitChildren[j - 1]] > hitFractions[i]) {
+                hitChildren[j] = hitChildren[j - 1];
+                j--;
+            }
+            hitChildren[j] = i;
+            nbHitChildren++;
+        }
+
+        // Report the hit leaves from the closest one
+        for (uint32 i=0; i < nbHitChildren; i++) {
+
+            const uint32 childIndex = hitChildren[i];
+            if ((node.leafMask & (1u << childIndex)) != 0) {
+
+                // Call the callback that will raycast the hit rays against the broad-phase shape
+                callback.raycastBroadPhaseShape(node.children[childIndex], packet, rayMasks[childIndex]);
+            }
+        }
+
+        // Push the internal children in the stack so that the closest one is visited first
+        for (uint32 i=nbHitChildren; i > 0; i--) {
+
+            const uint32 childIndex = hitChildren[i - 1];
+            if ((node.leafMask & (1u << childIndex)) == 0) {
+                stack.push(node.children[childIndex]);
+            }
+        }
+    }
+}
@@ -0,0 +1,364 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include <reactphysics3d/collision/narrowphase/BoxVsBoxAlgorithm.h>
+#include <reactphysics3d/collision/shapes/BoxShape.h>
+#include <reactphysics3d/collision/narrowphase/NarrowPhaseInfoBatch.h>
+#include <reactphysics3d/utils/Profiler.h>
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;
+
+// Static constants definitions
+const uint BoxVsBoxAlgorithm::MAX_NB_CLIPPED_VERTICES;
+const decimal BoxVsBoxAlgorithm::SEPARATING_AXIS_RELATIVE_TOLERANCE = decimal(1.002);
+const decimal BoxVsBoxAlgorithm::SEPARATING_AXIS_ABSOLUTE_TOLERANCE = decimal(0.0005);
+const decimal BoxVsBoxAlgorithm::PARALLEL_EDGES_EPSILON = decimal(0.000001);
+
+// Compute the narrow-phase collision detection between two boxes
+/// The tests are done in the local-space of the first box. In this space, the column j of the
+/// rotation matrix of the second box is its j-th axis. Therefore, the projections of the boxes
+/// onto the face normals and onto the cross products of the edges only need the entries of this
+/// matrix (see the book "Real-Time Collision Detection" by Christer Ericson). As in the SAT
+/// algorithm, the face normals are preferred to the edges cross products when the penetration
+/// depths are almost the same because face contacts are more stable.
+bool BoxVsBoxAlgorithm::testCollision(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchStartIndex, uint batchNbItems) {
+
+    RP3D_PROFILE("BoxVsBoxAlgorithm::testCollision()", mProfiler);
+
+    bool isCollisionFound = false;
+
+    for (uint batchIndex = batchStartIndex; batchIndex < batchStartIndex + batchNbItems; batchIndex++) {
+
+        assert(narrowPhaseInfoBatch.collisionShapes1[batchIndex]->getName() == CollisionShapeName::BOX);
+        assert(narrowPhaseInfoBatch.collisionShapes2[batchIndex]->getName() == CollisionShapeName::BOX);
+        assert(narrowPhaseInfoBatch.nbContactPoints[batchIndex] == 0);
+
+        const BoxShape* box1 = static_cast<const BoxShape*>(narrowPhaseInfoBatch.collisionShapes1[batchIndex]);
+        const BoxShape* box2 = static_cast<const BoxShape*>(narrowPhaseInfoBatch.collisionShapes2[batchIndex]);
+
+        const Vector3 halfExtents1 = box1->getHalfExtents();
+        const Vector3 halfExtents2 = box2->getHalfExtents();
+
+        // Transform from the local-space of box 2 to the local-space of box 1
+        const Transform box2ToBox1 = narrowPhaseInfoBatch.shape1ToWorldTransforms[batchIndex].getInverse() *
+                                     narrowPhaseInfoBatch.shape2ToWorldTransforms[batchIndex];
+        const Matrix3x3 rotation = box2ToBox1.getOrientation().getMatrix();
+        const Vector3& center2 = box2ToBox1.getPosition();
+
+        Matrix3x3 absRotation;
+        for (int i=0; i < 3; i++) {
+            for (int j=0; j < 3; j++) {
+                absRotation[i][j] = std::abs(rotation[i][j]);
+            }
+        }
+
+        bool isSeparated = false;
+
+        // Test the face normals of box 1
+        decimal minPenetrationDepth1 = DECIMAL_LARGEST;
+        int minAxis1 = 0;
+        for (int i=0; i < 3 && !isSeparated; i++) {
+
+            const decimal penetrationDepth = halfExtents1[i] + halfExtents2.dot(absRotation[i]) - std::abs(center2[i]);
+            if (penetrationDepth <= decimal(0.0)) {
+                isSeparated = true;
+            }
+            else if (penetrationDepth < minPenetrationDepth1) {
+                minPenetrationDepth1 = penetrationDepth;
+                minAxis1 = i;
+            }
+        }
+
+        // Test the face normals of box 2
+        decimal minPenetrationDepth2 = DECIMAL_LARGEST;
+        int minAxis2 = 0;
+        for (int j=0; j < 3 && !isSeparated; j++) {
+
+            const Vector3 axis2 = rotation.getColumn(j);
+            const decimal penetrationDepth = halfExtents1.dot(absRotation.getColumn(j)) + halfExtents2[j] - std::abs(center2.dot(axis2));
+            if (penetrationDepth <= decimal(0.0)) {
+                isSeparated = true;
+            }
+            else if (penetrationDepth < minPenetrationDepth2) {
+                minPenetrationDepth2 = penetrationDepth;
+                minAxis2 = j;
+            }
+        }
+
+        // Test the cross products of the edges of box 1 (axis i) and box 2 (axis j)
+        decimal minEdgesPenetrationDepth = DECIMAL_LARGEST;
+        int minEdge1 = 0;
+        int minEdge2 = 0;
+        for (int i=0; i < 3 && !isSeparated; i++) {
+
+            const int i1 = (i + 1) % 3;
+            const int i2 = (i + 2) % 3;
+
+            for (int j=0; j < 3 && !isSeparated; j++) {
+
+                const int j1 = (j + 1) % 3;
+                const int j2 = (j + 2) % 3;
+
+                // If the two edges are parallel, their cross product is not a separating axis candidate
+                const decimal axisLengthSquare = rotation[i1][j] * rotation[i1][j] + rotation[i2][j] * rotation[i2][j];
+                if (axisLengthSquare < PARALLEL_EDGES_EPSILON) continue;
+
+                const decimal projectedCenter2 = center2[i2] * rotation[i1][j] - center2[i1] * rotation[i2][j];
+                const decimal radius1 = halfExtents1[i1] * absRotation[i2][j] + halfExtents1[i2] * absRotation[i1][j];
+                const decimal radius2 = halfExtents2[j1] * absRotation[i][j2] + halfExtents2[j2] * absRotation[i][j1];
+                const decimal penetrationDepth = (radius1 + radius2 - std::abs(projectedCenter2)) / std::sqrt(axisLengthSquare);
+                if (penetrationDepth <= decimal(0.0)) {
+                    isSeparated = true;
+                }
+                else if (penetrationDepth < minEdgesPenetrationDepth) {
+                    minEdgesPenetrationDepth = penetrationDepth;
+                    minEdge1 = i;
+                    minEdge2 = j;
+                }
+            }
+        }
+
+        if (isSeparated) continue;
+
+        // Favor the face normals of box 1 over the ones of box 2 and the face normals over the edges
+        // cross products for consistency between frames and stability of the contact manifolds
+        const bool isReferenceBox1 = minPenetrationDepth1 < minPenetrationDepth2 * SEPARATING_AXIS_RELATIVE_TOLERANCE +
+                                                            SEPARATING_AXIS_ABSOLUTE_TOLERANCE;
+        const decimal minFacePenetrationDepth = isReferenceBox1 ? minPenetrationDepth1 : minPenetrationDepth2;
+
+        // If the minimum penetration depth is along the cross product of two edges
+        if (minEdgesPenetrationDepth * SEPARATING_AXIS_RELATIVE_TOLERANCE + SEPARATING_AXIS_ABSOLUTE_TOLERANCE < minFacePenetrationDepth) {
+
+            // If we need to report contacts
+            if (narrowPhaseInfoBatch.reportContacts[batchIndex]) {
+
+                // Compute the separating axis (pointing from box 1 toward box 2)
+                const Vector3 edge1Direction(minEdge1 == 0 ? 1 : 0, minEdge1 == 1 ? 1 : 0, minEdge1 == 2 ? 1 : 0);
+                const Vector3 edge2Direction = rotation.getColumn(minEdge2);
+                Vector3 normal = edge1Direction.cross(edge2Direction);
+                normal.normalize();
+                if (normal.dot(center2) < decimal(0.0)) {
+                    normal = -normal;
+                }
+
+                // Find the edge of box 1 that is the furthest along the separating axis
+                Vector3 edge1Center;
+                for (int k=0; k < 3; k++) {
+                    edge1Center[k] = k == minEdge1 ? decimal(0.0) : (normal[k] >= decimal(0.0) ? halfExtents1[k] : -halfExtents1[k]);
+                }
+
+                // Find the edge of box 2 that is the furthest in the opposite direction of the separating axis
+                Vector3 edge2Center = center2;
+                for (int k=0; k < 3; k++) {
+                    if (k != minEdge2) {
+                        const Vector3 axis2 = rotation.getColumn(k);
+                        edge2Center += normal.dot(axis2) >= decimal(0.0) ? -halfExtents2[k] * axis2 : halfExtents2[k] * axis2;
+                    }
+                }
+
+                // Compute the closest points between the two edges (in the local-space of box 1)
+                const Vector3 edge1Vector = halfExtents1[minEdge1] * edge1Direction;
+                const Vector3 edge2Vector = halfExtents2[minEdge2] * edge2Direction;
+                Vector3 closestPointEdge1, closestPointEdge2;
+                computeClosestPointBetweenTwoSegments(edge1Center - edge1Vector, edge1Center + edge1Vector,
+                                                      edge2Center - edge2Vector, edge2Center + edge2Vector,
+                                                      closestPointEdge1, closestPointEdge2);
+
+                // Create the contact point
+                const Vector3 normalWorld = narrowPhaseInfoBatch.shape1ToWorldTransforms[batchIndex].getOrientation() * normal;
+                narrowPhaseInfoBatch.addContactPoint(batchIndex, normalWorld, minEdgesPenetrationDepth, closestPointEdge1,
+                                                     box2ToBox1.getInverse() * closestPointEdge2);
+            }
+        }
+        else if (isReferenceBox1) {
+
+            // The reference face is the face of box 1 that faces box 2
+            const decimal axisSign = center2[minAxis1] >= decimal(0.0) ? decimal(1.0) : decimal(-1.0);
+            if (!computeFaceContactPoints(narrowPhaseInfoBatch, batchIndex, true, halfExtents1, halfExtents2, box2ToBox1,
+                                          minAxis1, axisSign)) {
+
+                // There should be clipping points here. If it is not the case, it might be
+                // because of a numerical issue
+                continue;
+            }
+        }
+        else {
+
+            // The reference face is the face of box 2 that faces box 1
+            const Transform box1ToBox2 = box2ToBox1.getInverse();
+            const decimal axisSign = box1ToBox2.getPosition()[minAxis2] >= decimal(0.0) ? decimal(1.0) : decimal(-1.0);
+            if (!computeFaceContactPoints(narrowPhaseInfoBatch, batchIndex, false, halfExtents2, halfExtents1, box1ToBox2,
+                                          minAxis2, axisSign)) {
+                continue;
+            }
+        }
+
+        narrowPhaseInfoBatch.isColliding[batchIndex] = true;
+        isCollisionFound = true;
+    }
+
+    return isCollisionFound;
+}
+
+// Compute the contact points between a face of the reference box and the incident box
+/// The incident face (the face of the incident box that is the most anti-parallel to the reference
+/// face) is clipped by the four side planes of the reference face. The clipped points below the
+/// reference face are the contact points. This method returns true if contact points have been found.
+/**
+ * @param isReferenceBox1 True if the reference box is the first box of the batch item
+ * @param referenceHalfExtents Half-extents of the reference box
+ * @param incidentHalfExtents Half-extents of the incident box
+ * @param incidentToReference Transform from the local-space of the incident box to the local-space of the reference box
+ * @param referenceAxis Index of the local axis of the reference box that is the normal of the reference face
+ * @param referenceAxisSign Sign of the normal of the reference face (pointing toward the incident box) along this axis
+ */
+bool BoxVsBoxAlgorithm::computeFaceContactPoints(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchIndex, bool isReferenceBox1,
+                                                 const Vector3& referenceHalfExtents, const Vector3& incidentHalfExtents,
+                                                 const Transform& incidentToReference, int referenceAxis, decimal referenceAxisSign) {
+
+    const Matrix3x3 incidentRotation = incidentToReference.getOrientation().getMatrix();
+
+    // Find the incident face (the face normal of the incident box that is the most anti-parallel to the reference face normal)
+    int incidentAxis = 0;
+    decimal maxAbsDotProduct = decimal(-1.0);
+    for (int j=0; j < 3; j++) {
+        const decimal absDotProduct = std::abs(incidentRotation[referenceAxis][j]);
+        if (absDotProduct > maxAbsDotProduct) {
+            maxAbsDotProduct = absDotProduct;
+            incidentAxis = j;
+        }
+    }
+    const decimal incidentAxisSign = incidentRotation[referenceAxis][incidentAxis] * referenceAxisSign > decimal(0.0) ? decimal(-1.0) : decimal(1.0);
+
+    // Compute the vertices of the incident face in the local-space of the reference box
+    const Vector3 incidentFaceCenter = incidentToReference.getPosition() + incidentRotation.getColumn(incidentAxis) *
+                                       (incidentAxisSign * incidentHalfExtents[incidentAxis]);
+    const int incidentAxis1 = (incidentAxis + 1) % 3;
+    const int incidentAxis2 = (incidentAxis + 2) % 3;
+    const Vector3 incidentFaceU = incidentRotation.getColumn(incidentAxis1) * incidentHalfExtents[incidentAxis1];
+    const Vector3 incidentFaceV = incidentRotation.getColumn(incidentAxis2) * incidentHalfExtents[incidentAxis2];
+
+    Vector3 clippedVertices[MAX_NB_CLIPPED_VERTICES];
+    Vector3 tempVertices[MAX_NB_CLIPPED_VERTICES];
+    clippedVertices[0] = incidentFaceCenter + incidentFaceU + incidentFaceV;
+    clippedVertices[1] = incidentFaceCenter - incidentFaceU + incidentFaceV;
+    clippedVertices[2] = incidentFaceCenter - incidentFaceU - incidentFaceV;
+    clippedVertices[3] = incidentFaceCenter + incidentFaceU - incidentFaceV;
+    uint nbClippedVertices = 4;
+
+    // Clip the incident face with the four side planes of the reference face
+    const int referenceAxis1 = (referenceAxis + 1) % 3;
+    const int referenceAxis2 = (referenceAxis + 2) % 3;
+    nbClippedVertices = clipPolygonWithPlane(clippedVertices, nbClippedVertices, referenceAxis1, decimal(1.0),
+                                             referenceHalfExtents[referenceAxis1], tempVertices);
+    nbClippedVertices = clipPolygonWithPlane(tempVertices, nbClippedVertices, referenceAxis1, decimal(-1.0),
+                                             referenceHalfExtents[referenceAxis1], clippedVertices);
+    nbClippedVertices = clipPolygonWithPlane(clippedVertices, nbClippedVertices, referenceAxis2, decimal(1.0),
+                                             referenceHalfExtents[referenceAxis2], tempVertices);
+    nbClippedVertices = clipPolygonWithPlane(tempVertices, nbClippedVertices, referenceAxis2, decimal(-1.0),
+                                             referenceHalfExtents[referenceAxis2], clippedVertices);
+
+    // Compute the world normal (from box 1 toward box 2)
+    Vector3 normal(0, 0, 0);
+    normal[referenceAxis] = referenceAxisSign;
+    const Vector3 normalWorld = isReferenceBox1 ? narrowPhaseInfoBatch.shape1ToWorldTransforms[batchIndex].getOrientation() * normal :
+                                                  -(narrowPhaseInfoBatch.shape2ToWorldTransforms[batchIndex].getOrientation() * normal);
+
+    const Transform referenceToIncident = incidentToReference.getInverse();
+
+    // We only keep the clipped points that are below the reference face
+    bool contactPointsFound = false;
+    for (uint i=0; i < nbClippedVertices; i++) {
+
+        const decimal penetrationDepth = referenceHalfExtents[referenceAxis] - referenceAxisSign * clippedVertices[i][referenceAxis];
+        if (penetrationDepth > decimal(0.0)) {
+
+            contactPointsFound = true;
+
+            // If we need to report contacts
+            if (narrowPhaseInfoBatch.reportContacts[batchIndex]) {
+
+                // Convert the clipped incident face vertex into the incident box local-space
+                const Vector3 contactPointIncident = referenceToIncident * clippedVertices[i];
+
+                // Project the contact point onto the reference face
+                Vector3 contactPointReference = clippedVertices[i];
+                contactPointReference[referenceAxis] = referenceAxisSign * referenceHalfExtents[referenceAxis];
+
+                // Create a new contact point
+                narrowPhaseInfoBatch.addContactPoint(batchIndex, normalWorld, penetrationDepth,
+                                                     isReferenceBox1 ? contactPointReference : contactPointIncident,
+                                                     isReferenceBox1 ? contactPointIncident : contactPointReference);
+            }
+        }
+    }
+
+    return contactPointsFound;
+}
+
+// Clip a polygon with a plane orthogonal to an axis of the reference box
+/// This is the Sutherland-Hodgman clipping of the polygon with the plane (axisSign * x[axis] = halfExtent).
+/// The part of the polygon where (axisSign * x[axis] <= halfExtent) is kept. Each clipping plane adds at
+/// most one vertex to the polygon and therefore a quad clipped by four planes has at most eight vertices.
+uint BoxVsBoxAlgorithm::clipPolygonWithPlane(const Vector3* vertices, uint nbVertices, int axis, decimal axisSign,
+                                             decimal halfExtent, Vector3* outClippedVertices) {
+
+    if (nbVertices == 0) return 0;
+
+    uint nbClippedVertices = 0;
+
+    uint previousIndex = nbVertices - 1;
+    decimal previousDistance = axisSign * vertices[previousIndex][axis] - halfExtent;
+
+    for (uint i=0; i < nbVertices; i++) {
+
+        const decimal distance = axisSign * vertices[i][axis] - halfExtent;
+
+        // If the edge crosses the clipping plane, add the intersection point
+        if ((previousDistance > decimal(0.0) && distance < decimal(0.0)) ||
+            (previousDistance < decimal(0.0) && distance > decimal(0.0))) {
+
+            assert(nbClippedVertices < MAX_NB_CLIPPED_VERTICES);
+            const decimal t = previousDistance / (previousDistance - distance);
+            outClippedVertices[nbClippedVertices] = vertices[previousIndex] + t * (vertices[i] - vertices[previousIndex]);
+            nbClippedVertices++;
+        }
+
+        // If the current vertex is inside, keep it
+        if (distance <= decimal(0.0)) {
+
+            assert(nbClippedVertices < MAX_NB_CLIPPED_VERTICES);
+            outClippedVertices[nbClippedVertices] = vertices[i];
+            nbClippedVertices++;
+        }
+
+        previousIndex = i;
+        previousDistance = distance;
+    }
+
+    return nbClippedVertices;
+}
@@ -0,0 +1,420 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include <reactphysics3d/collision/narrowphase/CapsuleVsBoxAlgorithm.h>
+#include <reactphysics3d/collision/shapes/CapsuleShape.h>
+#include <reactphysics3d/collision/shapes/BoxShape.h>
+#include <reactphysics3d/collision/narrowphase/NarrowPhaseInfoBatch.h>
+#include <reactphysics3d/utils/Profiler.h>
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;
+
+// Static constants definitions
+const uint CapsuleVsBoxAlgorithm::MAX_NB_SEGMENT_BREAKPOINTS;
+const decimal CapsuleVsBoxAlgorithm::SEPARATING_AXIS_RELATIVE_TOLERANCE = decimal(1.002);
+const decimal CapsuleVsBoxAlgorithm::SEPARATING_AXIS_ABSOLUTE_TOLERANCE = decimal(0.0005);
+const decimal CapsuleVsBoxAlgorithm::PARALLEL_EDGES_EPSILON = decimal(0.000001);
+
+// Compute the narrow-phase collision detection between a capsule and a box
+/// The tests are done in the local-space of the box. If the inner segment of the capsule does not
+/// intersect the box, the contact normal goes from the closest point of the box toward the closest
+/// point of the segment. Otherwise, the capsule is in deep penetration and the contact normal is the
+/// separating axis candidate (face normal of the box or cross product of the segment with an edge of
+/// the box) with the minimum penetration depth.
+bool CapsuleVsBoxAlgorithm::testCollision(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchStartIndex, uint batchNbItems) {
+
+    RP3D_PROFILE("CapsuleVsBoxAlgorithm::testCollision()", mProfiler);
+
+    bool isCollisionFound = false;
+
+    for (uint batchIndex = batchStartIndex; batchIndex < batchStartIndex + batchNbItems; batchIndex++) {
+
+        assert(narrowPhaseInfoBatch.nbContactPoints[batchIndex] == 0);
+
+        const bool isCapsuleShape1 = narrowPhaseInfoBatch.collisionShapes1[batchIndex]->getType() == CollisionShapeType::CAPSULE;
+
+        assert(isCapsuleShape1 || narrowPhaseInfoBatch.collisionShapes2[batchIndex]->getType() == CollisionShapeType::CAPSULE);
+        assert(narrowPhaseInfoBatch.collisionShapes1[batchIndex]->getName() == CollisionShapeName::BOX ||
+               narrowPhaseInfoBatch.collisionShapes2[batchIndex]->getName() == CollisionShapeName::BOX);
+
+        const CapsuleShape* capsuleShape = static_cast<const CapsuleShape*>(isCapsuleShape1 ? narrowPhaseInfoBatch.collisionShapes1[batchIndex] :
+                                                                                              narrowPhaseInfoBatch.collisionShapes2[batchIndex]);
+        const BoxShape* boxShape = static_cast<const BoxShape*>(isCapsuleShape1 ? narrowPhaseInfoBatch.collisionShapes2[batchIndex] :
+                                                                                  narrowPhaseInfoBatch.collisionShapes1[batchIndex]);
+
+        const Transform& capsuleToWorldTransform = isCapsuleShape1 ? narrowPhaseInfoBatch.shape1ToWorldTransforms[batchIndex] :
+                                                                     narrowPhaseInfoBatch.shape2ToWorldTransforms[batchIndex];
+        const Transform& boxToWorldTransform = isCapsuleShape1 ? narrowPhaseInfoBatch.shape2ToWorldTransforms[batchIndex] :
+                                                                 narrowPhaseInfoBatch.shape1ToWorldTransforms[batchIndex];
+
+        // Compute the end-points of the inner segment of the capsule in the local-space of the box
+        const Transform capsuleToBoxTransform = boxToWorldTransform.getInverse() * capsuleToWorldTransform;
+        const decimal capsuleHalfHeight = capsuleShape->getHeight() * decimal(0.5);
+        const Vector3 segmentPointA = capsuleToBoxTransform * Vector3(0, -capsuleHalfHeight, 0);
+        const Vector3 segmentPointB = capsuleToBoxTransform * Vector3(0, capsuleHalfHeight, 0);
+
+        const Vector3 halfExtents = boxShape->getHalfExtents();
+        const decimal radius = capsuleShape->getRadius();
+
+        // Compute the distance between the inner segment of the capsule and the box
+        decimal segmentParameter;
+        const decimal distanceSquare = computeSegmentBoxDistanceSquare(segmentPointA, segmentPointB, halfExtents, segmentParameter);
+
+        // If the capsule and the box are separated
+        if (distanceSquare >= radius * radius) continue;
+
+        // If we need to report contacts
+        if (narrowPhaseInfoBatch.reportContacts[batchIndex]) {
+
+            const Transform boxToCapsuleTransform = capsuleToBoxTransform.getInverse();
+            const Quaternion& boxToWorldOrientation = boxToWorldTransform.getOrientation();
+            const Vector3 segment = segmentPointB - segmentPointA;
+
+            // If the inner segment of the capsule is outside the box (the box only overlaps the margin of the capsule)
+            if (distanceSquare > MACHINE_EPSILON) {
+
+                const Vector3 closestPointSegment = segmentPointA + segmentParameter * segment;
+                const Vector3 closestPointBox(clamp(closestPointSegment.x, -halfExtents.x, halfExtents.x),
+                                              clamp(closestPointSegment.y, -halfExtents.y, halfExtents.y),
+                                              clamp(closestPointSegment.z, -halfExtents.z, halfExtents.z));
+
+                const decimal distance = std::sqrt(distanceSquare);
+                const Vector3 normal = (closestPointSegment - closestPointBox) / distance;
+
+                // Find if the closest point of the box is inside a face (not on an edge or a vertex)
+                int nbAxesOutsideBox = 0;
+                int faceAxis = 0;
+                for (int i=0; i < 3; i++) {
+                    if (std::abs(closestPointSegment[i]) > halfExtents[i]) {
+                        nbAxesOutsideBox++;
+                        faceAxis = i;
+                    }
+                }
+
+                // If the segment is parallel to this face, we create two contact points (the
+                // end-points of the segment clipped by the face) for the stability of the contact manifold
+                bool isFaceContactCreated = false;
+                if (nbAxesOutsideBox == 1 && segment.lengthSquare() > MACHINE_EPSILON &&
+                    areOrthogonalVectors(segment.getUnit(), normal)) {
+
+                    const decimal faceAxisSign = normal[faceAxis] > decimal(0.0) ? decimal(1.0) : decimal(-1.0);
+                    isFaceContactCreated = computeFaceContactPoints(narrowPhaseInfoBatch, batchIndex, isCapsuleShape1, segmentPointA,
+                                                                    segmentPointB, halfExtents, radius, faceAxis, faceAxisSign,
+                                                                    boxToCapsuleTransform, boxToWorldOrientation);
+                }
+
+                if (!isFaceContactCreated) {
+
+                    const Vector3 contactPointCapsule = boxToCapsuleTransform * (closestPointSegment - normal * radius);
+
+                    // The contact normal must go from the first shape toward the second one
+                    Vector3 normalWorld = boxToWorldOrientation * normal;
+                    if (isCapsuleShape1) {
+                        normalWorld = -normalWorld;
+                    }
+
+                    narrowPhaseInfoBatch.addContactPoint(batchIndex, normalWorld, radius - distance,
+                                                         isCapsuleShape1 ? contactPointCapsule : closestPointBox,
+                                                         isCapsuleShape1 ? closestPointBox : contactPointCapsule);
+                }
+            }
+            else {
+
+                // The inner segment of the capsule intersects the box. We look for the separating axis
+                // candidate with the minimum penetration depth (the normals are from the box toward the capsule)
+
+                // Test the face normals of the box
+                decimal minFacePenetrationDepth = DECIMAL_LARGEST;
+                int minFaceAxis = 0;
+                decimal minFaceAxisSign = decimal(1.0);
+                for (int i=0; i < 3; i++) {
+
+                    const decimal segmentMin = std::min(segmentPointA[i], segmentPointB[i]);
+                    const decimal segmentMax = std::max(segmentPointA[i], segmentPointB[i]);
+
+                    const decimal penetrationDepthPositive = halfExtents[i] - segmentMin + radius;
+                    const decimal penetrationDepthNegative = halfExtents[i] + segmentMax + radius;
+                    if (penetrationDepthPositive < minFacePenetrationDepth) {
+                        minFacePenetrationDepth = penetrationDepthPositive;
+                        minFaceAxis = i;
+                        minFaceAxisSign = decimal(1.0);
+                    }
+                    if (penetrationDepthNegative < minFacePenetrationDepth) {
+                        minFacePenetrationDepth = penetrationDepthNegative;
+                        minFaceAxis = i;
+                        minFaceAxisSign = decimal(-1.0);
+                    }
+                }
+
+                // Test the cross products of the segment with the edges of the box
+                decimal minEdgePenetrationDepth = DECIMAL_LARGEST;
+                int minEdge = 0;
+                Vector3 minEdgeNormal;
+                if (segment.lengthSquare() > MACHINE_EPSILON) {
+
+                    const Vector3 segmentDirection = segment.getUnit();
+                    for (int j=0; j < 3; j++) {
+
+                        // If the segment is parallel to the edge, their cross product is not a separating axis candidate
+                        const Vector3 edgeDirection(j == 0 ? 1 : 0, j == 1 ? 1 : 0, j == 2 ? 1 : 0);
+                        Vector3 axis = segmentDirection.cross(edgeDirection);
+                        const decimal axisLengthSquare = axis.lengthSquare();
+                        if (axisLengthSquare < PARALLEL_EDGES_EPSILON) continue;
+                        axis /= std::sqrt(axisLengthSquare);
+
+                        const decimal boxRadius = halfExtents.dot(Vector3(std::abs(axis.x), std::abs(axis.y), std::abs(axis.z)));
+                        const decimal projectedSegment = axis.dot(segmentPointA);
+
+                        const decimal penetrationDepthPositive = boxRadius - projectedSegment + radius;
+                        const decimal penetrationDepthNegative = boxRadius + projectedSegment + radius;
+                        if (penetrationDepthPositive < minEdgePenetrationDepth) {
+                            minEdgePenetrationDepth = penetrationDepthPositive;
+                            minEdge = j;
+                            minEdgeNormal = axis;
+                        }
+                        if (penetrationDepthNegative < minEdgePenetrationDepth) {
+                            minEdgePenetrationDepth = penetrationDepthNegative;
+                            minEdge = j;
+                            minEdgeNormal = -axis;
+                        }
+                    }
+                }
+
+                // If the minimum penetration depth is along the cross product of the segment with an edge
+                // (the face normals are favored for the stability of the contact manifolds)
+                if (minEdgePenetrationDepth * SEPARATING_AXIS_RELATIVE_TOLERANCE + SEPARATING_AXIS_ABSOLUTE_TOLERANCE < minFacePenetrationDepth) {
+
+                    // Find the edge of the box that is the furthest along the separating axis
+                    Vector3 edgeCenter;
+                    for (int k=0; k < 3; k++) {
+                        edgeCenter[k] = k == minEdge ? decimal(0.0) : (minEdgeNormal[k] >= decimal(0.0) ? halfExtents[k] : -halfExtents[k]);
+                    }
+                    Vector3 edgeVector;
+                    edgeVector.setToZero();
+                    edgeVector[minEdge] = halfExtents[minEdge];
+
+                    // Compute the closest points between the edge and the segment
+                    Vector3 closestPointSegment, closestPointBox;
+                    computeClosestPointBetweenTwoSegments(segmentPointA, segmentPointB, edgeCenter - edgeVector, edgeCenter + edgeVector,
+                                                          closestPointSegment, closestPointBox);
+
+                    const Vector3 contactPointCapsule = boxToCapsuleTransform * (closestPointSegment - minEdgeNormal * radius);
+
+                    // The contact normal must go from the first shape toward the second one
+                    Vector3 normalWorld = boxToWorldOrientation * minEdgeNormal;
+                    if (isCapsuleShape1) {
+                        normalWorld = -normalWorld;
+                    }
+
+                    narrowPhaseInfoBatch.addContactPoint(batchIndex, normalWorld, minEdgePenetrationDepth,
+                                                         isCapsuleShape1 ? contactPointCapsule : closestPointBox,
+                                                         isCapsuleShape1 ? closestPointBox : contactPointCapsule);
+                }
+                else if (!computeFaceContactPoints(narrowPhaseInfoBatch, batchIndex, isCapsuleShape1, segmentPointA, segmentPointB,
+                                                   halfExtents, radius, minFaceAxis, minFaceAxisSign, boxToCapsuleTransform,
+                                                   boxToWorldOrientation)) {
+
+                    // There should be clipping points here. If it is not the case, it might be
+                    // because of a numerical issue
+                    continue;
+                }
+            }
+        }
+
+        narrowPhaseInfoBatch.isColliding[batchIndex] = true;
+        isCollisionFound = true;
+    }
+
+    return isCollisionFound;
+}
+
+// Compute the squared distance between a segment and a box and the parameter of the closest point of the segment
+/// The squared distance between a point of the segment and the box is a piecewise quadratic function of
+/// the segment parameter. The pieces are delimited by the values of the parameter where the segment crosses
+/// the side planes of the box. On each piece, the coordinates of the segment are either inside the slab of
+/// the box or beyond a given side plane. Therefore, the minimum of the function on each piece can be computed
+/// in closed form. The points of the segment are (segmentPointA + t * (segmentPointB - segmentPointA)) with t in [0, 1].
+/**
+ * @param segmentPointA First end-point of the segment (in the local-space of the box)
+ * @param segmentPointB Second end-point of the segment (in the local-space of the box)
+ * @param halfExtents Half-extents of the box
+ * @param outSegmentParameter Parameter of the closest point of the segment to the box
+ * @return The squared distance between the segment and the box (zero if they intersect)
+ */
+decimal CapsuleVsBoxAlgorithm::computeSegmentBoxDistanceSquare(const Vector3& segmentPointA, const Vector3& segmentPointB,
+                                                               const Vector3& halfExtents, decimal& outSegmentParameter) {
+
+    const Vector3 segment = segmentPointB - segmentPointA;
+
+    // Compute the sorted values of the segment parameter that delimit the pieces of the distance function
+    decimal breakpoints[MAX_NB_SEGMENT_BREAKPOINTS];
+    uint nbBreakpoints = 0;
+    breakpoints[nbBreakpoints++] = decimal(0.0);
+    for (int i=0; i < 3; i++) {
+        if (segment[i] != decimal(0.0)) {
+
+            const decimal t1 = (-halfExtents[i] - segmentPointA[i]) / segment[i];
+            const decimal t2 = (halfExtents[i] - segmentPointA[i]) / segment[i];
+            if (t1 > decimal(0.0) && t1 < decimal(1.0)) breakpoints[nbBreakpoints++] = t1;
+            if (t2 > decimal(0.0) && t2 < decimal(1.0)) breakpoints[nbBreakpoints++] = t2;
+        }
+    }
+    breakpoints[nbBreakpoints++] = decimal(1.0);
+    assert(nbBreakpoints <= MAX_NB_SEGMENT_BREAKPOINTS);
+
+    for (uint i=1; i < nbBreakpoints; i++) {
+        const decimal value = breakpoints[i];
+        uint j = i;
+        while (j > 0 && breakpoints[j - 1] > value) {
+            breakpoints[j] = breakpoints[j - 1];
+            j--;
+        }
+        breakpoints[j] = value;
+    }
+
+    decimal minDistanceSquare = DECIMAL_LARGEST;
+    outSegmentParameter = decimal(0.0);
+
+    // For each piece of the distance function
+    for (uint k=0; k + 1 < nbBreakpoints; k++) {
+
+        const decimal tMin = breakpoints[k];
+        const decimal tMax = breakpoints[k + 1];
+        const decimal tMiddle = decimal(0.5) * (tMin + tMax);
+        const Vector3 middlePoint = segmentPointA + tMiddle * segment;
+
+        // Compute the minimum of the quadratic function on this piece. Only the coordinates
+        // beyond a side plane of the box contribute to the distance
+        decimal numerator = decimal(0.0);
+        decimal denominator = decimal(0.0);
+        for (int i=0; i < 3; i++) {
+            if (middlePoint[i] > halfExtents[i]) {
+                numerator += (segmentPointA[i] - halfExtents[i]) * segment[i];
+                denominator += segment[i] * segment[i];
+            }
+            else if (middlePoint[i] < -halfExtents[i]) {
+                numerator += (segmentPointA[i] + halfExtents[i]) * segment[i];
+                denominator += segment[i] * segment[i];
+            }
+        }
+
+        // If the function is constant on this piece (segment parallel to the box features), we
+        // take the middle of the piece to get a closest point that does not jump between frames
+        const decimal t = denominator > MACHINE_EPSILON ? clamp(-numerator / denominator, tMin, tMax) : tMiddle;
+
+        const Vector3 point = segmentPointA + t * segment;
+        const Vector3 closestPointBox(clamp(point.x, -halfExtents.x, halfExtents.x),
+                                      clamp(point.y, -halfExtents.y, halfExtents.y),
+                                      clamp(point.z, -halfExtents.z, halfExtents.z));
+        const decimal distanceSquare = (point - closestPointBox).lengthSquare();
+        if (distanceSquare < minDistanceSquare) {
+            minDistanceSquare = distanceSquare;
+            outSegmentParameter = t;
+        }
+    }
+
+    return minDistanceSquare;
+}
+
+// Compute the contact points between the segment and a face of the box
+/// The segment is clipped by the four side planes of the face and a contact point is
+/// created at each end-point of the clipped segment that penetrates the face. This
+/// method returns true if contact points have been found.
+/**
+ * @param isCapsuleShape1 True if the capsule is the first shape of the batch item
+ * @param segmentPointA First end-point of the inner segment of the capsule (in the local-space of the box)
+ * @param segmentPointB Second end-point of the inner segment of the capsule (in the local-space of the box)
+ * @param halfExtents Half-extents of the box
+ * @param radius Radius of the capsule
+ * @param faceAxis Index of the local axis of the box that is the normal of the face
+ * @param faceAxisSign Sign of the normal of the face (pointing toward the capsule) along this axis
+ * @param boxToCapsuleTransform Transform from the local-space of the box to the local-space of the capsule
+ * @param boxToWorldOrientation Orientation of the box in world-space
+ */
+bool CapsuleVsBoxAlgorithm::computeFaceContactPoints(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchIndex, bool isCapsuleShape1,
+                                                     const Vector3& segmentPointA, const Vector3& segmentPointB, const Vector3& halfExtents,
+                                                     decimal radius, int faceAxis, decimal faceAxisSign,
+                                                     const Transform& boxToCapsuleTransform, const Quaternion& boxToWorldOrientation) {
+
+    const Vector3 segment = segmentPointB - segmentPointA;
+
+    // Clip the segment with the four side planes of the face
+    decimal tMin = decimal(0.0);
+    decimal tMax = decimal(1.0);
+    for (int i=0; i < 3; i++) {
+
+        if (i == faceAxis) continue;
+
+        if (std::abs(segment[i]) < MACHINE_EPSILON) {
+            if (std::abs(segmentPointA[i]) > halfExtents[i]) return false;
+        }
+        else {
+            decimal t1 = (-halfExtents[i] - segmentPointA[i]) / segment[i];
+            decimal t2 = (halfExtents[i] - segmentPointA[i]) / segment[i];
+            if (t1 > t2) std::swap(t1, t2);
+            tMin = std::max(tMin, t1);
+            tMax = std::min(tMax, t2);
+        }
+    }
+    if (tMin > tMax) return false;
+
+    Vector3 normal;
+    normal.setToZero();
+    normal[faceAxis] = faceAxisSign;
+
+    // The contact normal must go from the first shape toward the second one
+    Vector3 normalWorld = boxToWorldOrientation * normal;
+    if (isCapsuleShape1) {
+        normalWorld = -normalWorld;
+    }
+
+    // Only one contact point is created if the clipped segment is a single point
+    const uint nbClippedPoints = tMax - tMin > MACHINE_EPSILON ? 2 : 1;
+    const decimal clippedParameters[2] = {tMin, tMax};
+
+    bool isContactPointCreated = false;
+    for (uint i=0; i < nbClippedPoints; i++) {
+
+        const Vector3 clippedPoint = segmentPointA + clippedParameters[i] * segment;
+
+        // If the clipped point is not below the face (with the margin of the capsule)
+        const decimal penetrationDepth = radius - (faceAxisSign * clippedPoint[faceAxis] - halfExtents[faceAxis]);
+        if (penetrationDepth <= decimal(0.0)) continue;
+
+        // The contact point of the box is the projection of the clipped point onto the face
+        Vector3 contactPointBox = clippedPoint;
+        contactPointBox[faceAxis] = faceAxisSign * halfExtents[faceAxis];
+        const Vector3 contactPointCapsule = boxToCapsuleTransform * (clippedPoint - normal * radius);
+
+        narrowPhaseInfoBatch.addContactPoint(batchIndex, normalWorld, penetrationDepth,
+                                             isCapsuleShape1 ? contactPointCapsule : contactPointBox,
+                                             isCapsuleShape1 ? contactPointBox : contactPointCapsule);
+        isContactPointCreated = true;
+    }
+
+    return isContactPointCreated;
+}
@@ -41,7 +41,7 @@ bool CapsuleVsCapsuleAlgorithm::testCollision(CapsuleVsCapsuleNarrowPhaseInfoBat
 
     for (uint batchIndex = batchStartIndex; batchIndex < batchStartIndex + batchNbItems; batchIndex++) {
 
-        assert(narrowPhaseInfoBatch.contactPoints[batchIndex].size() == 0);
+        assert(narrowPhaseInfoBatch.nbContactPoints[batchIndex] == 0);
 
         assert(!narrowPhaseInfoBatch.isColliding[batchIndex]);
 
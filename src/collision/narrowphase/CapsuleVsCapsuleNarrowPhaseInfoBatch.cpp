@@ -39,10 +39,10 @@ CapsuleVsCapsuleNarrowPhaseInfoBatch::CapsuleVsCapsuleNarrowPhaseInfoBatch(Memor
 
 // Add shapes to be tested during narrow-phase collision detection into the batch
 void CapsuleVsCapsuleNarrowPhaseInfoBatch::addNarrowPhaseInfo(uint64 pairId, uint64 pairIndex, Entity collider1, Entity collider2, CollisionShape* shape1, CollisionShape* shape2,
-                                                            const Transform& shape1Transform, const Transform& shape2Transform, bool needToReportContacts, MemoryAllocator &shapeAllocator) {
+                                                            const Transform& shape1Transform, const Transform& shape2Transform, bool needToReportContacts) {
 
     NarrowPhaseInfoBatch::addNarrowPhaseInfo(pairId, pairIndex, collider1, collider2, shape1, shape2, shape1Transform,
-                                             shape2Transform, needToReportContacts, shapeAllocator);
+                                             shape2Transform, needToReportContacts);
 
     assert(shape1->getType() == CollisionShapeType::CAPSULE);
     assert(shape2->getType() == CollisionShapeType::CAPSULE);
@@ -77,7 +77,7 @@ bool CapsuleVsConvexPolyhedronAlgorithm::testCollision(NarrowPhaseInfoBatch& nar
                narrowPhaseInfoBatch.collisionShapes2[batchIndex]->getType() == CollisionShapeType::CAPSULE);
 
         // If we have found a contact point inside the margins (shallow penetration)
-        if (gjkResults[batchIndex] == GJKAlgorithm::GJKResult::COLLIDE_IN_MARGIN) {
+        if (gjkResults[batchIndex - batchStartIndex] == GJKAlgorithm::GJKResult::COLLIDE_IN_MARGIN) {
 
             // If we need to report contacts
             if (narrowPhaseInfoBatch.reportContacts[batchIndex]) {
@@ -88,9 +88,9 @@ bool CapsuleVsConvexPolyhedronAlgorithm::testCollision(NarrowPhaseInfoBatch& nar
                 // capsule inner segment and parallel to the contact point normal, we would like to create
                 // two contact points instead of a single one (as in the deep contact case with SAT algorithm)
 
-                // Get the contact point created by GJK
-                assert(narrowPhaseInfoBatch.contactPoints[batchIndex].size() > 0);
-                ContactPointInfo*& contactPoint = narrowPhaseInfoBatch.contactPoints[batchIndex][0];
+                // Get a copy of the contact point created by GJK (its slot is reused by the new contact points)
+                assert(narrowPhaseInfoBatch.nbContactPoints[batchIndex] > 0);
+                const ContactPointInfo contactPoint = narrowPhaseInfoBatch.getContactPoints(batchIndex)[0];
 
                 bool isCapsuleShape1 = narrowPhaseInfoBatch.collisionShapes1[batchIndex]->getType() == CollisionShapeType::CAPSULE;
 
@@ -113,13 +113,13 @@ bool CapsuleVsConvexPolyhedronAlgorithm::testCollision(NarrowPhaseInfoBatch& nar
                     Vector3 capsuleInnerSegmentDirection = capsuleToWorld.getOrientation() * (capsuleSegB - capsuleSegA);
                     capsuleInnerSegmentDirection.normalize();
 
-                    bool isFaceNormalInDirectionOfContactNormal = faceNormalWorld.dot(contactPoint->normal) > decimal(0.0);
+                    bool isFaceNormalInDirectionOfContactNormal = faceNormalWorld.dot(contactPoint.normal) > decimal(0.0);
                     bool isFaceNormalInContactDirection = (isCapsuleShape1 && !isFaceNormalInDirectionOfContactNormal) || (!isCapsuleShape1 && isFaceNormalInDirectionOfContactNormal);
 
                     // If the polyhedron face normal is orthogonal to the capsule inner segment and parallel to the contact point normal and the face normal
                     // is in direction of the contact normal (from the polyhedron point of view).
                     if (isFaceNormalInContactDirection && areOrthogonalVectors(faceNormalWorld, capsuleInnerSegmentDirection)
-                        && areParallelVectors(faceNormalWorld, contactPoint->normal)) {
+                        && areParallelVectors(faceNormalWorld, contactPoint.normal)) {
 
                         // Remove the previous contact point computed by GJK
                         narrowPhaseInfoBatch.resetContactPoints(batchIndex);
@@ -143,7 +143,7 @@ bool CapsuleVsConvexPolyhedronAlgorithm::testCollision(NarrowPhaseInfoBatch& nar
                         }
 
                         // Compute and create two contact points
-                        bool contactsFound = satAlgorithm.computeCapsulePolyhedronFaceContactPoints(f, capsuleShape->getRadius(), polyhedron, contactPoint->penetrationDepth,
+                        bool contactsFound = satAlgorithm.computeCapsulePolyhedronFaceContactPoints(f, capsuleShape->getRadius(), polyhedron, contactPoint.penetrationDepth,
                                                                   polyhedronToCapsuleTransform, faceNormalWorld, separatingAxisCapsuleSpace,
                                                                   capsuleSegAPolyhedronSpace, capsuleSegBPolyhedronSpace,
                                                                   narrowPhaseInfoBatch, batchIndex, isCapsuleShape1);
@@ -172,7 +172,7 @@ bool CapsuleVsConvexPolyhedronAlgorithm::testCollision(NarrowPhaseInfoBatch& nar
         }
 
         // If we have overlap even without the margins (deep penetration)
-        if (gjkResults[batchIndex] == GJKAlgorithm::GJKResult::INTERPENETRATE) {
+        if (gjkResults[batchIndex - batchStartIndex] == GJKAlgorithm::GJKResult::INTERPENETRATE) {
 
             // Run the SAT algorithm to find the separating axis and compute contact point
             narrowPhaseInfoBatch.isColliding[batchIndex] = satAlgorithm.testCollisionCapsuleVsConvexPolyhedron(narrowPhaseInfoBatch, batchIndex);
@@ -38,6 +38,9 @@ CollisionDispatch::CollisionDispatch(MemoryAllocator& allocator) : mAllocator(al
     mSphereVsConvexPolyhedronAlgorithm = new (allocator.allocate(sizeof(SphereVsConvexPolyhedronAlgorithm))) SphereVsConvexPolyhedronAlgorithm();
     mCapsuleVsConvexPolyhedronAlgorithm = new (allocator.allocate(sizeof(CapsuleVsConvexPolyhedronAlgorithm))) CapsuleVsConvexPolyhedronAlgorithm();
     mConvexPolyhedronVsConvexPolyhedronAlgorithm = new (allocator.allocate(sizeof(ConvexPolyhedronVsConvexPolyhedronAlgorithm))) ConvexPolyhedronVsConvexPolyhedronAlgorithm();
+    mBoxVsBoxAlgorithm = new (allocator.allocate(sizeof(BoxVsBoxAlgorithm))) BoxVsBoxAlgorithm();
+    mSphereVsBoxAlgorithm = new (allocator.allocate(sizeof(SphereVsBoxAlgorithm))) SphereVsBoxAlgorithm();
+    mCapsuleVsBoxAlgorithm = new (allocator.allocate(sizeof(CapsuleVsBoxAlgorithm))) CapsuleVsBoxAlgorithm();
 
     // Fill in the collision matrix
     fillInCollisionMatrix();
@@ -65,6 +68,15 @@ CollisionDispatch::~CollisionDispatch() {
     if (mIsConvexPolyhedronVsConvexPolyhedronDefault) {
         mAllocator.release(mConvexPolyhedronVsConvexPolyhedronAlgorithm, sizeof(ConvexPolyhedronVsConvexPolyhedronAlgorithm));
     }
+    if (mIsBoxVsBoxDefault) {
+        mAllocator.release(mBoxVsBoxAlgorithm, sizeof(BoxVsBoxAlgorithm));
+    }
+    if (mIsSphereVsBoxDefault) {
+        mAllocator.release(mSphereVsBoxAlgorithm, sizeof(SphereVsBoxAlgorithm));
+    }
+    if (mIsCapsuleVsBoxDefault) {
+        mAllocator.release(mCapsuleVsBoxAlgorithm, sizeof(CapsuleVsBoxAlgorithm));
+    }
 }
 
 // Select and return the narrow-phase collision detection algorithm to
@@ -184,6 +196,39 @@ void CollisionDispatch::setConvexPolyhedronVsConvexPolyhedronAlgorithm(ConvexPol
     fillInCollisionMatrix();
 }
 
+// Set the Box vs Box narrow-phase collision detection algorithm
+void CollisionDispatch::setBoxVsBoxAlgorithm(BoxVsBoxAlgorithm* algorithm) {
+
+    if (mIsBoxVsBoxDefault) {
+        mAllocator.release(mBoxVsBoxAlgorithm, sizeof(BoxVsBoxAlgorithm));
+        mIsBoxVsBoxDefault = false;
+    }
+
+    mBoxVsBoxAlgorithm = algorithm;
+}
+
+// Set the Sphere vs Box narrow-phase collision detection algorithm
+void CollisionDispatch::setSphereVsBoxAlgorithm(SphereVsBoxAlgorithm* algorithm) {
+
+    if (mIsSphereVsBoxDefault) {
+        mAllocator.release(mSphereVsBoxAlgorithm, sizeof(SphereVsBoxAlgorithm));
+        mIsSphereVsBoxDefault = false;
+    }
+
+    mSphereVsBoxAlgorithm = algorithm;
+}
+
+// Set the Capsule vs Box narrow-phase collision detection algorithm
+void CollisionDispatch::setCapsuleVsBoxAlgorithm(CapsuleVsBoxAlgorithm* algorithm) {
+
+    if (mIsCapsuleVsBoxDefault) {
+        mAllocator.release(mCapsuleVsBoxAlgorithm, sizeof(CapsuleVsBoxAlgorithm));
+        mIsCapsuleVsBoxDefault = false;
+    }
+
+    mCapsuleVsBoxAlgorithm = algorithm;
+}
+
 
 // Fill-in the collision detection matrix
 void CollisionDispatch::fillInCollisionMatrix() {
@@ -213,5 +258,26 @@ NarrowPhaseAlgorithmType CollisionDispatch::selectNarrowPhaseAlgorithm(const Col
     return mCollisionMatrix[shape1Index][shape2Index];
 }
 
+// Return the narrow-phase algorithm type to use for two convex collision shapes
+/// A box is a convex polyhedron but the pairs with a box and a sphere, a capsule or another box
+/// are tested with specialized algorithms instead of the generic convex polyhedron ones.
+NarrowPhaseAlgorithmType CollisionDispatch::selectNarrowPhaseAlgorithm(const CollisionShape* shape1,
+                                                                       const CollisionShape* shape2) const {
+
+    if (shape1->getName() == CollisionShapeName::BOX && shape2->getName() == CollisionShapeName::BOX) {
+        return NarrowPhaseAlgorithmType::BoxVsBox;
+    }
+
+    if (shape1->getName() == CollisionShapeName::BOX || shape2->getName() == CollisionShapeName::BOX) {
 
+        const CollisionShapeType otherShapeType = shape1->getName() == CollisionShapeName::BOX ? shape2->getType() : shape1->getType();
+        if (otherShapeType == CollisionShapeType::SPHERE) {
+            return NarrowPhaseAlgorithmType::SphereVsBox;
+        }
+        if (otherShapeType == CollisionShapeType::CAPSULE) {
+            return NarrowPhaseAlgorithmType::CapsuleVsBox;
+        }
+    }
 
+    return selectNarrowPhaseAlgorithm(shape1->getType(), shape2->getType());
+}
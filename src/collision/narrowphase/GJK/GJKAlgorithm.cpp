@@ -28,6 +28,7 @@
 #include <reactphysics3d/constraint/ContactPoint.h>
 #include <reactphysics3d/engine/OverlappingPairs.h>
 #include <reactphysics3d/collision/shapes/TriangleShape.h>
+#include <reactphysics3d/collision/shapes/ConvexMeshShape.h>
 #include <reactphysics3d/configuration.h>
 #include <reactphysics3d/utils/Profiler.h>
 #include <reactphysics3d/containers/List.h>
@@ -112,8 +113,10 @@ void GJKAlgorithm::testCollision(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uin
         do {
 
             // Compute the support points for original objects (without margins) A and B
-            suppA = shape1->getLocalSupportPointWithoutMargin(-v);
-            suppB = body2Tobody1 * shape2->getLocalSupportPointWithoutMargin(rotateToBody2 * v);
+            // (the search of the support vertices starts at the previous support vertices)
+            suppA = getCachedLocalSupportPointWithoutMargin(shape1, -v, lastFrameCollisionInfo->gjkSupportVertexIndex1);
+            suppB = body2Tobody1 * getCachedLocalSupportPointWithoutMargin(shape2, rotateToBody2 * v,
+                                                                           lastFrameCollisionInfo->gjkSupportVertexIndex2);
 
             // Compute the support point for the Minkowski difference A-B
             w = suppA - suppB;
@@ -127,7 +130,7 @@ void GJKAlgorithm::testCollision(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uin
                 lastFrameCollisionInfo->gjkSeparatingAxis = v;
 
                 // No intersection, we return
-                assert(gjkResults.size() == batchIndex);
+                assert(gjkResults.size() == batchIndex - batchStartIndex);
                 gjkResults.add(GJKResult::SEPARATED);
                 noIntersection = true;
                 break;
@@ -202,14 +205,14 @@ void GJKAlgorithm::testCollision(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uin
 
             // If the penetration depth is negative (due too numerical errors), there is no contact
             if (penetrationDepth <= decimal(0.0)) {
-                assert(gjkResults.size() == batchIndex);
+                assert(gjkResults.size() == batchIndex - batchStartIndex);
                 gjkResults.add(GJKResult::SEPARATED);
                 continue;
             }
 
             // Do not generate a contact point with zero normal length
             if (normal.lengthSquare() < MACHINE_EPSILON) {
-                assert(gjkResults.size() == batchIndex);
+                assert(gjkResults.size() == batchIndex - batchStartIndex);
                 gjkResults.add(GJKResult::SEPARATED);
                 continue;
             }
@@ -225,13 +228,26 @@ void GJKAlgorithm::testCollision(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uin
                 narrowPhaseInfoBatch.addContactPoint(batchIndex, normal, penetrationDepth, pA, pB);
             }
 
-            assert(gjkResults.size() == batchIndex);
+            assert(gjkResults.size() == batchIndex - batchStartIndex);
             gjkResults.add(GJKResult::COLLIDE_IN_MARGIN);
 
             continue;
         }
 
-        assert(gjkResults.size() == batchIndex);
+        assert(gjkResults.size() == batchIndex - batchStartIndex);
         gjkResults.add(GJKResult::INTERPENETRATE);
     }
 }
+
+// Return a local support point of a shape without its margin starting the search at a cached vertex
+/// Only the convex meshes search their support vertex from a start vertex. The cached vertex index
+/// is not used by the other shapes.
+Vector3 GJKAlgorithm::getCachedLocalSupportPointWithoutMargin(const ConvexShape* shape, const Vector3& direction,
+                                                              uint& supportVertexIndex) {
+
+    if (shape->getName() == CollisionShapeName::CONVEX_MESH) {
+        return static_cast<const ConvexMeshShape*>(shape)->getCachedLocalSupportPointWithoutMargin(direction, supportVertexIndex);
+    }
+
+    return shape->getLocalSupportPointWithoutMargin(direction);
+}
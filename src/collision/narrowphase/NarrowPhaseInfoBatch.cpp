@@ -26,9 +26,10 @@
 // Libraries
 #include <reactphysics3d/collision/narrowphase/NarrowPhaseInfoBatch.h>
 #include <reactphysics3d/collision/ContactPointInfo.h>
-#include <reactphysics3d/collision/shapes/TriangleShape.h>
 #include <reactphysics3d/engine/OverlappingPairs.h>
+#include <reactphysics3d/collision/shapes/ConvexPolyhedronShape.h>
 #include <iostream>
+#include <algorithm>
 
 using namespace reactphysics3d;
 
@@ -37,7 +38,7 @@ NarrowPhaseInfoBatch::NarrowPhaseInfoBatch(MemoryAllocator& allocator, Overlappi
       : mMemoryAllocator(allocator), mOverlappingPairs(overlappingPairs), overlappingPairIds(allocator),
         colliderEntities1(allocator), colliderEntities2(allocator), collisionShapes1(allocator), collisionShapes2(allocator),
         shape1ToWorldTransforms(allocator), shape2ToWorldTransforms(allocator), reportContacts(allocator),
-        isColliding(allocator), contactPoints(allocator), collisionShapeAllocators(allocator),
+        isColliding(allocator), contactPointsStartIndices(allocator), nbContactPoints(allocator),
         lastFrameCollisionInfos(allocator) {
 
 }
@@ -49,8 +50,7 @@ NarrowPhaseInfoBatch::~NarrowPhaseInfoBatch() {
 
 // Add shapes to be tested during narrow-phase collision detection into the batch
 void NarrowPhaseInfoBatch::addNarrowPhaseInfo(uint64 pairId, uint64 pairIndex, Entity collider1, Entity collider2, CollisionShape* shape1, CollisionShape* shape2,
-                                              const Transform& shape1Transform, const Transform& shape2Transform, bool needToReportContacts,
-                                              MemoryAllocator& shapeAllocator) {
+                                              const Transform& shape1Transform, const Transform& shape2Transform, bool needToReportContacts) {
 
     overlappingPairIds.add(pairId);
     colliderEntities1.add(collider1);
@@ -60,52 +60,113 @@ void NarrowPhaseInfoBatch::addNarrowPhaseInfo(uint64 pairId, uint64 pairIndex, E
     shape1ToWorldTransforms.add(shape1Transform);
     shape2ToWorldTransforms.add(shape2Transform);
     reportContacts.add(needToReportContacts);
-    collisionShapeAllocators.add(&shapeAllocator);
-    contactPoints.add(List<ContactPointInfo*>(mMemoryAllocator));
     isColliding.add(false);
 
+    // Reserve the slots of the contact points of the two shapes in the contact points array
+    contactPointsStartIndices.add(mNbContactPointsSlots);
+    nbContactPoints.add(0);
+    mNbContactPointsSlots += computeNbMaxContactPoints(shape1, shape2);
+
+    // Grow the contact points array if necessary
+    if (mNbContactPointsSlots > mContactPointsCapacity) {
+        allocateContactPoints(std::max(mNbContactPointsSlots, mContactPointsCapacity * 2));
+    }
+
     // Add a collision info for the two collision shapes into the overlapping pair (if not present yet)
     LastFrameCollisionInfo* lastFrameInfo = mOverlappingPairs.addLastFrameInfoIfNecessary(pairIndex, shape1->getId(), shape2->getId());
     lastFrameCollisionInfos.add(lastFrameInfo);
 }
 
 // Add a new contact point
+/// The contact point is written in the next free slot of the object in the contact points array.
+/// The slots of an object are reserved for the maximum number of contact points of its two shapes.
+/// Note that no memory is allocated here and that the narrow-phase tests of different objects of the
+/// batch can therefore add their contact points from several threads.
 void NarrowPhaseInfoBatch::addContactPoint(uint index, const Vector3& contactNormal, decimal penDepth,
                      const Vector3& localPt1, const Vector3& localPt2) {
 
     assert(reportContacts[index]);
     assert(penDepth > decimal(0.0));
+    assert(nbContactPoints[index] < getNbMaxContactPoints(index));
+
+    ContactPointInfo* objectContactPoints = getContactPoints(index);
+    uint8& nbObjectContactPoints = nbContactPoints[index];
 
-    // Get the memory allocator
-    MemoryAllocator& allocator = mOverlappingPairs.getTemporaryAllocator();
+    // If all the contact point slots of the object are already used, the new contact point
+    // replaces the shallowest one if it is deeper (so that the slots of the next object are
+    // never overwritten)
+    if (nbObjectContactPoints >= getNbMaxContactPoints(index)) {
 
-    // Create the contact point info
-    ContactPointInfo* contactPointInfo = new (allocator.allocate(sizeof(ContactPointInfo)))
-            ContactPointInfo(contactNormal, penDepth, localPt1, localPt2);
+        uint8 shallowestIndex = 0;
+        for (uint8 i=1; i < nbObjectContactPoints; i++) {
+            if (objectContactPoints[i].penetrationDepth < objectContactPoints[shallowestIndex].penetrationDepth) {
+                shallowestIndex = i;
+            }
+        }
+
+        if (nbObjectContactPoints > 0 && penDepth > objectContactPoints[shallowestIndex].penetrationDepth) {
+            objectContactPoints[shallowestIndex] = ContactPointInfo(contactNormal, penDepth, localPt1, localPt2);
+        }
 
-    // Add it into the list of contact points
-    contactPoints[index].add(contactPointInfo);
+        return;
+    }
+
+    new (objectContactPoints + nbObjectContactPoints) ContactPointInfo(contactNormal, penDepth, localPt1, localPt2);
+    nbObjectContactPoints++;
 }
 
-// Reset the remaining contact points
-void NarrowPhaseInfoBatch::resetContactPoints(uint index) {
+// Return the maximum number of contact points that the narrow-phase algorithms compute for two shapes
+/// A sphere only touches the other shape at a single point and a capsule creates at most two contact
+/// points (the end-points of its clipped inner segment). The contact points of two polyhedra are the
+/// vertices of the incident face clipped by the side planes of the reference face. Each clipping
+/// plane adds at most one vertex to the clipped polygon.
+uint8 NarrowPhaseInfoBatch::computeNbMaxContactPoints(const CollisionShape* shape1, const CollisionShape* shape2) {
+
+    const CollisionShapeType type1 = shape1->getType();
+    const CollisionShapeType type2 = shape2->getType();
 
-    // Get the memory allocator
-    MemoryAllocator& allocator = mOverlappingPairs.getTemporaryAllocator();
+    if (type1 == CollisionShapeType::SPHERE || type2 == CollisionShapeType::SPHERE) return 1;
+    if (type1 == CollisionShapeType::CAPSULE || type2 == CollisionShapeType::CAPSULE) return 2;
 
-    // For each remaining contact point info
-    for (uint i=0; i < contactPoints[index].size(); i++) {
+    assert(type1 == CollisionShapeType::CONVEX_POLYHEDRON && type2 == CollisionShapeType::CONVEX_POLYHEDRON);
+
+    const uint nbMaxContactPoints = static_cast<const ConvexPolyhedronShape*>(shape1)->getNbMaxFaceVertices() +
+                                    static_cast<const ConvexPolyhedronShape*>(shape2)->getNbMaxFaceVertices();
+    assert(nbMaxContactPoints <= 255);
+
+    return static_cast<uint8>(nbMaxContactPoints);
+}
 
-        ContactPointInfo* contactPoint = contactPoints[index][i];
+// Allocate the contact points array with a given number of slots
+/// The contact points of the objects already in the batch are copied into the new array
+void NarrowPhaseInfoBatch::allocateContactPoints(uint nbSlots) {
 
-        // Call the destructor
-        contactPoint->~ContactPointInfo();
+    assert(nbSlots >= mNbContactPointsSlots);
 
-        // Delete the current element
-        allocator.release(contactPoint, sizeof(ContactPointInfo));
+    ContactPointInfo* newContactPoints = static_cast<ContactPointInfo*>(mMemoryAllocator.allocate(nbSlots * sizeof(ContactPointInfo)));
+
+    // Copy the existing contact points
+    for (uint i=0; i < nbContactPoints.size(); i++) {
+        for (uint8 p=0; p < nbContactPoints[i]; p++) {
+            const uint pointIndex = contactPointsStartIndices[i] + p;
+            new (newContactPoints + pointIndex) ContactPointInfo(contactPoints[pointIndex]);
+        }
     }
 
-    contactPoints[index].clear();
+    releaseContactPoints();
+
+    contactPoints = newContactPoints;
+    mContactPointsCapacity = nbSlots;
+}
+
+// Release the contact points array
+void NarrowPhaseInfoBatch::releaseContactPoints() {
+
+    if (contactPoints != nullptr) {
+        mMemoryAllocator.release(contactPoints, mContactPointsCapacity * sizeof(ContactPointInfo));
+        contactPoints = nullptr;
+        mContactPointsCapacity = 0;
+    }
 }
 
 // Initialize the containers using cached capacity
@@ -119,10 +180,14 @@ void NarrowPhaseInfoBatch::reserveMemory() {
     shape1ToWorldTransforms.reserve(mCachedCapacity);
     shape2ToWorldTransforms.reserve(mCachedCapacity);
     reportContacts.reserve(mCachedCapacity);
-    collisionShapeAllocators.reserve(mCachedCapacity);
     lastFrameCollisionInfos.reserve(mCachedCapacity);
     isColliding.reserve(mCachedCapacity);
-    contactPoints.reserve(mCachedCapacity);
+    contactPointsStartIndices.reserve(mCachedCapacity);
+    nbContactPoints.reserve(mCachedCapacity);
+
+    if (mCachedContactPointsCapacity > mContactPointsCapacity) {
+        allocateContactPoints(mCachedContactPointsCapacity);
+    }
 }
 
 // Clear all the objects in the batch
@@ -130,18 +195,7 @@ void NarrowPhaseInfoBatch::clear() {
 
     for (uint i=0; i < overlappingPairIds.size(); i++) {
 
-        assert(contactPoints[i].size() == 0);
-
-        // Release the memory of the TriangleShape (this memory was allocated in the
-        // MiddlePhaseTriangleCallback::testTriangle() method)
-        if (collisionShapes1.size() > 0 && collisionShapes1[i]->getName() == CollisionShapeName::TRIANGLE) {
-            collisionShapes1[i]->~CollisionShape();
-            collisionShapeAllocators[i]->release(collisionShapes1[i], sizeof(TriangleShape));
-        }
-        if (collisionShapes2.size() > 0 && collisionShapes2[i]->getName() == CollisionShapeName::TRIANGLE) {
-            collisionShapes2[i]->~CollisionShape();
-            collisionShapeAllocators[i]->release(collisionShapes2[i], sizeof(TriangleShape));
-        }
+        assert(nbContactPoints[i] == 0);
     }
 
     // Note that we clear the following containers and we release their allocated memory. Therefore,
@@ -150,6 +204,7 @@ void NarrowPhaseInfoBatch::clear() {
     // location of the allocated memory of a single frame allocator might change between two frames)
 
     mCachedCapacity = overlappingPairIds.size();
+    mCachedContactPointsCapacity = mNbContactPointsSlots;
 
     overlappingPairIds.clear(true);
     colliderEntities1.clear(true);
@@ -159,8 +214,10 @@ void NarrowPhaseInfoBatch::clear() {
     shape1ToWorldTransforms.clear(true);
     shape2ToWorldTransforms.clear(true);
     reportContacts.clear(true);
-    collisionShapeAllocators.clear(true);
     lastFrameCollisionInfos.clear(true);
     isColliding.clear(true);
-    contactPoints.clear(true);
+    contactPointsStartIndices.clear(true);
+    nbContactPoints.clear(true);
+    mNbContactPointsSlots = 0;
+    releaseContactPoints();
 }
@@ -26,6 +26,7 @@
 // Libraries
 #include <reactphysics3d/collision/narrowphase/NarrowPhaseInput.h>
 #include <reactphysics3d/collision/narrowphase/CollisionDispatch.h>
+#include <reactphysics3d/collision/shapes/TriangleShape.h>
 
 using namespace reactphysics3d;
 
@@ -34,33 +35,91 @@ NarrowPhaseInput::NarrowPhaseInput(MemoryAllocator& allocator, OverlappingPairs&
     :mSphereVsSphereBatch(allocator, overlappingPairs), mSphereVsCapsuleBatch(allocator, overlappingPairs),
      mCapsuleVsCapsuleBatch(allocator, overlappingPairs), mSphereVsConvexPolyhedronBatch(allocator, overlappingPairs),
      mCapsuleVsConvexPolyhedronBatch(allocator, overlappingPairs),
-     mConvexPolyhedronVsConvexPolyhedronBatch(allocator, overlappingPairs) {
+     mConvexPolyhedronVsConvexPolyhedronBatch(allocator, overlappingPairs), mBoxVsBoxBatch(allocator, overlappingPairs),
+     mSphereVsBoxBatch(allocator, overlappingPairs), mCapsuleVsBoxBatch(allocator, overlappingPairs),
+     mCachedContactPointsBatch(allocator, overlappingPairs), mMemoryAllocator(allocator),
+     mTriangleShapesBlocks(allocator), mNbTriangleShapesPerBlock(allocator) {
 
 }
 
+// Destructor
+NarrowPhaseInput::~NarrowPhaseInput() {
+    destroyTriangleShapes();
+}
+
+// Create the triangle shapes of the concave shape triangles overlapping with a convex shape
+/// All the triangle shapes of a pair are constructed in a single block of memory that is released
+/// when the narrow-phase input is cleared. Constructing a triangle shape does not allocate memory.
+TriangleShape* NarrowPhaseInput::createTriangleShapes(const List<Vector3>& trianglesVertices,
+                                                      const List<Vector3>& trianglesVerticesNormals, const List<uint>& shapeIds) {
+
+    const uint nbTriangles = shapeIds.size();
+    assert(nbTriangles > 0);
+    assert(trianglesVertices.size() == nbTriangles * 3);
+    assert(trianglesVerticesNormals.size() == nbTriangles * 3);
+
+    TriangleShape* triangleShapes = static_cast<TriangleShape*>(mMemoryAllocator.allocate(nbTriangles * sizeof(TriangleShape)));
+    for (uint i=0; i < nbTriangles; i++) {
+        new (triangleShapes + i) TriangleShape(&(trianglesVertices[i * 3]), &(trianglesVerticesNormals[i * 3]), shapeIds[i],
+                                               mMemoryAllocator);
+    }
+
+    mTriangleShapesBlocks.add(triangleShapes);
+    mNbTriangleShapesPerBlock.add(nbTriangles);
+
+    return triangleShapes;
+}
+
+// Destroy the triangle shapes and release their memory
+void NarrowPhaseInput::destroyTriangleShapes() {
+
+    for (uint b=0; b < mTriangleShapesBlocks.size(); b++) {
+
+        TriangleShape* triangleShapes = mTriangleShapesBlocks[b];
+        const uint nbTriangles = mNbTriangleShapesPerBlock[b];
+        for (uint i=0; i < nbTriangles; i++) {
+            triangleShapes[i].~TriangleShape();
+        }
+
+        mMemoryAllocator.release(triangleShapes, nbTriangles * sizeof(TriangleShape));
+    }
+
+    mTriangleShapesBlocks.clear(true);
+    mNbTriangleShapesPerBlock.clear(true);
+}
+
 // Add shapes to be tested during narrow-phase collision detection into the batch
 void NarrowPhaseInput::addNarrowPhaseTest(uint64 pairId, uint64 pairIndex, Entity collider1, Entity collider2, CollisionShape* shape1, CollisionShape* shape2,
                                           const Transform& shape1Transform, const Transform& shape2Transform,
-                                          NarrowPhaseAlgorithmType narrowPhaseAlgorithmType, bool reportContacts, MemoryAllocator& shapeAllocator) {
+                                          NarrowPhaseAlgorithmType narrowPhaseAlgorithmType, bool reportContacts) {
 
     switch (narrowPhaseAlgorithmType) {
         case NarrowPhaseAlgorithmType::SphereVsSphere:
-            mSphereVsSphereBatch.addNarrowPhaseInfo(pairId, pairIndex, collider1, collider2, shape1, shape2, shape1Transform, shape2Transform, reportContacts, shapeAllocator);
+            mSphereVsSphereBatch.addNarrowPhaseInfo(pairId, pairIndex, collider1, collider2, shape1, shape2, shape1Transform, shape2Transform, reportContacts);
             break;
         case NarrowPhaseAlgorithmType::SphereVsCapsule:
-            mSphereVsCapsuleBatch.addNarrowPhaseInfo(pairId, pairIndex, collider1, collider2, shape1, shape2, shape1Transform, shape2Transform, reportContacts, shapeAllocator);
+            mSphereVsCapsuleBatch.addNarrowPhaseInfo(pairId, pairIndex, collider1, collider2, shape1, shape2, shape1Transform, shape2Transform, reportContacts);
             break;
         case NarrowPhaseAlgorithmType::CapsuleVsCapsule:
-            mCapsuleVsCapsuleBatch.addNarrowPhaseInfo(pairId, pairIndex, collider1, collider2, shape1, shape2, shape1Transform, shape2Transform, reportContacts, shapeAllocator);
+            mCapsuleVsCapsuleBatch.addNarrowPhaseInfo(pairId, pairIndex, collider1, collider2, shape1, shape2, shape1Transform, shape2Transform, reportContacts);
             break;
         case NarrowPhaseAlgorithmType::SphereVsConvexPolyhedron:
-            mSphereVsConvexPolyhedronBatch.addNarrowPhaseInfo(pairId, pairIndex, collider1, collider2, shape1, shape2, shape1Transform, shape2Transform, reportContacts, shapeAllocator);
+            mSphereVsConvexPolyhedronBatch.addNarrowPhaseInfo(pairId, pairIndex, collider1, collider2, shape1, shape2, shape1Transform, shape2Transform, reportContacts);
             break;
         case NarrowPhaseAlgorithmType::CapsuleVsConvexPolyhedron:
-            mCapsuleVsConvexPolyhedronBatch.addNarrowPhaseInfo(pairId, pairIndex, collider1, collider2, shape1, shape2, shape1Transform, shape2Transform, reportContacts, shapeAllocator);
+            mCapsuleVsConvexPolyhedronBatch.addNarrowPhaseInfo(pairId, pairIndex, collider1, collider2, shape1, shape2, shape1Transform, shape2Transform, reportContacts);
             break;
         case NarrowPhaseAlgorithmType::ConvexPolyhedronVsConvexPolyhedron:
-            mConvexPolyhedronVsConvexPolyhedronBatch.addNarrowPhaseInfo(pairId, pairIndex, collider1, collider2, shape1, shape2, shape1Transform, shape2Transform, reportContacts, shapeAllocator);
+            mConvexPolyhedronVsConvexPolyhedronBatch.addNarrowPhaseInfo(pairId, pairIndex, collider1, collider2, shape1, shape2, shape1Transform, shape2Transform, reportContacts);
+            break;
+        case NarrowPhaseAlgorithmType::BoxVsBox:
+            mBoxVsBoxBatch.addNarrowPhaseInfo(pairId, pairIndex, collider1, collider2, shape1, shape2, shape1Transform, shape2Transform, reportContacts);
+            break;
+        case NarrowPhaseAlgorithmType::SphereVsBox:
+            mSphereVsBoxBatch.addNarrowPhaseInfo(pairId, pairIndex, collider1, collider2, shape1, shape2, shape1Transform, shape2Transform, reportContacts);
+            break;
+        case NarrowPhaseAlgorithmType::CapsuleVsBox:
+            mCapsuleVsBoxBatch.addNarrowPhaseInfo(pairId, pairIndex, collider1, collider2, shape1, shape2, shape1Transform, shape2Transform, reportContacts);
             break;
         case NarrowPhaseAlgorithmType::None:
             // Must never happen
@@ -69,6 +128,14 @@ void NarrowPhaseInput::addNarrowPhaseTest(uint64 pairId, uint64 pairIndex, Entit
     }
 }
 
+// Add shapes whose cached contact points are re-projected instead of running the narrow-phase collision detection
+void NarrowPhaseInput::addCachedContactPointsTest(uint64 pairId, uint64 pairIndex, Entity collider1, Entity collider2, CollisionShape* shape1,
+                                                  CollisionShape* shape2, const Transform& shape1Transform, const Transform& shape2Transform) {
+
+    mCachedContactPointsBatch.addNarrowPhaseInfo(pairId, pairIndex, collider1, collider2, shape1, shape2, shape1Transform, shape2Transform,
+                                                 true);
+}
+
 /// Reserve memory for the containers with cached capacity
 void NarrowPhaseInput::reserveMemory() {
 
@@ -78,6 +145,10 @@ void NarrowPhaseInput::reserveMemory() {
     mSphereVsConvexPolyhedronBatch.reserveMemory();
     mCapsuleVsConvexPolyhedronBatch.reserveMemory();
     mConvexPolyhedronVsConvexPolyhedronBatch.reserveMemory();
+    mBoxVsBoxBatch.reserveMemory();
+    mSphereVsBoxBatch.reserveMemory();
+    mCapsuleVsBoxBatch.reserveMemory();
+    mCachedContactPointsBatch.reserveMemory();
 }
 
 // Clear
@@ -89,4 +160,10 @@ void NarrowPhaseInput::clear() {
     mSphereVsConvexPolyhedronBatch.clear();
     mCapsuleVsConvexPolyhedronBatch.clear();
     mConvexPolyhedronVsConvexPolyhedronBatch.clear();
+    mBoxVsBoxBatch.clear();
+    mSphereVsBoxBatch.clear();
+    mCapsuleVsBoxBatch.clear();
+    mCachedContactPointsBatch.clear();
+
+    destroyTriangleShapes();
 }
@@ -0,0 +1,134 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include <reactphysics3d/collision/narrowphase/SphereVsBoxAlgorithm.h>
+#include <reactphysics3d/collision/shapes/SphereShape.h>
+#include <reactphysics3d/collision/shapes/BoxShape.h>
+#include <reactphysics3d/collision/narrowphase/NarrowPhaseInfoBatch.h>
+#include <reactphysics3d/utils/Profiler.h>
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;
+
+// Compute the narrow-phase collision detection between a sphere and a box
+/// The tests are done in the local-space of the box. If the center of the sphere is outside the
+/// box, the closest point of the box is the center clamped to the half-extents of the box and the
+/// contact normal goes from this point toward the center. Otherwise, the contact normal is the
+/// normal of the face of the box that is the closest to the center of the sphere.
+bool SphereVsBoxAlgorithm::testCollision(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchStartIndex, uint batchNbItems) {
+
+    RP3D_PROFILE("SphereVsBoxAlgorithm::testCollision()", mProfiler);
+
+    bool isCollisionFound = false;
+
+    for (uint batchIndex = batchStartIndex; batchIndex < batchStartIndex + batchNbItems; batchIndex++) {
+
+        assert(narrowPhaseInfoBatch.nbContactPoints[batchIndex] == 0);
+
+        const bool isSphereShape1 = narrowPhaseInfoBatch.collisionShapes1[batchIndex]->getType() == CollisionShapeType::SPHERE;
+
+        assert(isSphereShape1 || narrowPhaseInfoBatch.collisionShapes2[batchIndex]->getType() == CollisionShapeType::SPHERE);
+        assert(narrowPhaseInfoBatch.collisionShapes1[batchIndex]->getName() == CollisionShapeName::BOX ||
+               narrowPhaseInfoBatch.collisionShapes2[batchIndex]->getName() == CollisionShapeName::BOX);
+
+        const SphereShape* sphereShape = static_cast<const SphereShape*>(isSphereShape1 ? narrowPhaseInfoBatch.collisionShapes1[batchIndex] :
+                                                                                          narrowPhaseInfoBatch.collisionShapes2[batchIndex]);
+        const BoxShape* boxShape = static_cast<const BoxShape*>(isSphereShape1 ? narrowPhaseInfoBatch.collisionShapes2[batchIndex] :
+                                                                                 narrowPhaseInfoBatch.collisionShapes1[batchIndex]);
+
+        const Transform& sphereToWorldTransform = isSphereShape1 ? narrowPhaseInfoBatch.shape1ToWorldTransforms[batchIndex] :
+                                                                   narrowPhaseInfoBatch.shape2ToWorldTransforms[batchIndex];
+        const Transform& boxToWorldTransform = isSphereShape1 ? narrowPhaseInfoBatch.shape2ToWorldTransforms[batchIndex] :
+                                                                narrowPhaseInfoBatch.shape1ToWorldTransforms[batchIndex];
+
+        // Compute the center of the sphere in the local-space of the box
+        const Vector3 sphereCenter = boxToWorldTransform.getInverse() * sphereToWorldTransform.getPosition();
+        const Vector3 halfExtents = boxShape->getHalfExtents();
+        const decimal radius = sphereShape->getRadius();
+
+        // Compute the closest point of the box to the center of the sphere
+        Vector3 closestPointBox(clamp(sphereCenter.x, -halfExtents.x, halfExtents.x),
+                                clamp(sphereCenter.y, -halfExtents.y, halfExtents.y),
+                                clamp(sphereCenter.z, -halfExtents.z, halfExtents.z));
+
+        const decimal distanceSquare = (sphereCenter - closestPointBox).lengthSquare();
+
+        // If the sphere and the box are separated
+        if (distanceSquare >= radius * radius) continue;
+
+        // If we need to report contacts
+        if (narrowPhaseInfoBatch.reportContacts[batchIndex]) {
+
+            Vector3 normal;     // Contact normal from the box toward the sphere (in box-space)
+            decimal penetrationDepth;
+
+            // If the center of the sphere is outside the box
+            if (distanceSquare > MACHINE_EPSILON) {
+
+                const decimal distance = std::sqrt(distanceSquare);
+                normal = (sphereCenter - closestPointBox) / distance;
+                penetrationDepth = radius - distance;
+            }
+            else {
+
+                // Find the face of the box that is the closest to the center of the sphere
+                int minAxis = 0;
+                decimal minDistanceToFace = DECIMAL_LARGEST;
+                for (int i=0; i < 3; i++) {
+                    const decimal distanceToFace = halfExtents[i] - std::abs(sphereCenter[i]);
+                    if (distanceToFace < minDistanceToFace) {
+                        minDistanceToFace = distanceToFace;
+                        minAxis = i;
+                    }
+                }
+
+                normal.setToZero();
+                normal[minAxis] = sphereCenter[minAxis] >= decimal(0.0) ? decimal(1.0) : decimal(-1.0);
+                closestPointBox[minAxis] = normal[minAxis] * halfExtents[minAxis];
+                penetrationDepth = radius + minDistanceToFace;
+            }
+
+            // Compute the contact point on the sphere (in sphere local-space)
+            const Transform boxToSphereTransform = sphereToWorldTransform.getInverse() * boxToWorldTransform;
+            const Vector3 contactPointSphere = boxToSphereTransform * (sphereCenter - normal * radius);
+
+            // The contact normal must go from the first shape toward the second one
+            Vector3 normalWorld = boxToWorldTransform.getOrientation() * normal;
+            if (isSphereShape1) {
+                normalWorld = -normalWorld;
+            }
+
+            narrowPhaseInfoBatch.addContactPoint(batchIndex, normalWorld, penetrationDepth,
+                                                 isSphereShape1 ? contactPointSphere : closestPointBox,
+                                                 isSphereShape1 ? closestPointBox : contactPointSphere);
+        }
+
+        narrowPhaseInfoBatch.isColliding[batchIndex] = true;
+        isCollisionFound = true;
+    }
+
+    return isCollisionFound;
+}
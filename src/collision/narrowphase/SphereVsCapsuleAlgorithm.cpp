@@ -29,118 +29,225 @@
 #include <reactphysics3d/collision/shapes/CapsuleShape.h>
 #include <reactphysics3d/collision/narrowphase/SphereVsCapsuleNarrowPhaseInfoBatch.h>
 
+// The pairs of shapes are tested for overlap with SSE instructions when they are available
+#ifdef RP3D_SSE_ENABLED
+    #include <xmmintrin.h>
+#endif
+
 // We want to use the ReactPhysics3D namespace
 using namespace reactphysics3d;  
 
+// Static constants definitions
+const uint SphereVsCapsuleAlgorithm::NB_PAIRS_PER_OVERLAP_TEST;
+
 // Compute the narrow-phase collision detection between a sphere and a capsule
-// This technique is based on the "Robust Contact Creation for Physics Simulations" presentation
-// by Dirk Gregorius.
+/// The consecutive pairs of the batch are first tested four at a time with the world-space
+/// centers and segments of the batch. This test is conservative and only rejects the pairs that
+/// are separated. The remaining pairs are then tested one by one to compute the contact points.
 bool SphereVsCapsuleAlgorithm::testCollision(SphereVsCapsuleNarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchStartIndex, uint batchNbItems,
                                              MemoryAllocator& memoryAllocator) {
 
     bool isCollisionFound = false;
 
-    for (uint batchIndex = batchStartIndex; batchIndex < batchStartIndex + batchNbItems; batchIndex++) {
+    const uint batchEndIndex = batchStartIndex + batchNbItems;
+
+    // For each group of consecutive items in the batch
+    for (uint batchIndex = batchStartIndex; batchIndex < batchEndIndex; batchIndex += NB_PAIRS_PER_OVERLAP_TEST) {
 
-        assert(!narrowPhaseInfoBatch.isColliding[batchIndex]);
-        assert(narrowPhaseInfoBatch.contactPoints[batchIndex].size() == 0);
+        const uint nbItems = std::min(NB_PAIRS_PER_OVERLAP_TEST, batchEndIndex - batchIndex);
 
-        const bool isSphereShape1 = narrowPhaseInfoBatch.isSpheresShape1[batchIndex];
+        // Reject the separated pairs
+        const uint32 overlapMask = computeOverlapMask(narrowPhaseInfoBatch, batchIndex, nbItems);
 
-        // Get the transform from sphere local-space to capsule local-space
-        const Transform& sphereToWorldTransform = isSphereShape1 ? narrowPhaseInfoBatch.shape1ToWorldTransforms[batchIndex] : narrowPhaseInfoBatch.shape2ToWorldTransforms[batchIndex];
-        const Transform& capsuleToWorldTransform = isSphereShape1 ? narrowPhaseInfoBatch.shape2ToWorldTransforms[batchIndex] : narrowPhaseInfoBatch.shape1ToWorldTransforms[batchIndex];
-        const Transform worldToCapsuleTransform = capsuleToWorldTransform.getInverse();
-        const Transform sphereToCapsuleSpaceTransform = worldToCapsuleTransform * sphereToWorldTransform;
+        for (uint i=0; i < nbItems; i++) {
 
-        // Transform the center of the sphere into the local-space of the capsule shape
-        const Vector3 sphereCenter = sphereToCapsuleSpaceTransform.getPosition();
+            assert(!narrowPhaseInfoBatch.isColliding[batchIndex + i]);
+            assert(narrowPhaseInfoBatch.nbContactPoints[batchIndex + i] == 0);
+
+            if ((overlapMask & (1u << i)) != 0) {
+                isCollisionFound |= testPairCollision(narrowPhaseInfoBatch, batchIndex + i);
+            }
+        }
+    }
 
-        // Compute the end-points of the inner segment of the capsule
-        const decimal capsuleHalfHeight = narrowPhaseInfoBatch.capsuleHeights[batchIndex] * decimal(0.5);
-        const Vector3 capsuleSegA(0, -capsuleHalfHeight, 0);
-        const Vector3 capsuleSegB(0, capsuleHalfHeight, 0);
+    return isCollisionFound;
+}
 
-        // Compute the point on the inner capsule segment that is the closes to center of sphere
-        const Vector3 closestPointOnSegment = computeClosestPointOnSegment(capsuleSegA, capsuleSegB, sphereCenter);
+// Return the bit mask of the pairs of shapes that may overlap among (at most) four consecutive items of a batch
+/// The bit i of the mask is set if the distance between the center of the sphere and the inner segment
+/// of the capsule of the item (batchIndex + i) is smaller than the sum of their radiuses increased by a
+/// small tolerance. The tolerance makes sure that this test never rejects a pair that is found colliding
+/// by the test in the local-space of the capsule (in spite of the different rounding errors)
+uint32 SphereVsCapsuleAlgorithm::computeOverlapMask(const SphereVsCapsuleNarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchIndex, uint nbItems) {
+
+    assert(nbItems <= NB_PAIRS_PER_OVERLAP_TEST);
+
+    // Relative tolerance on the sum of the radiuses
+    const decimal tolerance = decimal(0.01);
+
+#ifdef RP3D_SSE_ENABLED
+
+    if (nbItems == NB_PAIRS_PER_OVERLAP_TEST) {
+
+        // Vectors from the centers of the capsules to the centers of the spheres
+        const __m128 capsuleToSphereX = _mm_sub_ps(_mm_loadu_ps(&narrowPhaseInfoBatch.sphereCentersX[batchIndex]),
+                                                   _mm_loadu_ps(&narrowPhaseInfoBatch.capsuleCentersX[batchIndex]));
+        const __m128 capsuleToSphereY = _mm_sub_ps(_mm_loadu_ps(&narrowPhaseInfoBatch.sphereCentersY[batchIndex]),
+                                                   _mm_loadu_ps(&narrowPhaseInfoBatch.capsuleCentersY[batchIndex]));
+        const __m128 capsuleToSphereZ = _mm_sub_ps(_mm_loadu_ps(&narrowPhaseInfoBatch.sphereCentersZ[batchIndex]),
+                                                   _mm_loadu_ps(&narrowPhaseInfoBatch.capsuleCentersZ[batchIndex]));
+        const __m128 halfSegmentX = _mm_loadu_ps(&narrowPhaseInfoBatch.capsuleHalfSegmentsX[batchIndex]);
+        const __m128 halfSegmentY = _mm_loadu_ps(&narrowPhaseInfoBatch.capsuleHalfSegmentsY[batchIndex]);
+        const __m128 halfSegmentZ = _mm_loadu_ps(&narrowPhaseInfoBatch.capsuleHalfSegmentsZ[batchIndex]);
+
+        // Compute the parameters in [-1, 1] of the closest points on the inner segments
+        const __m128 projections = _mm_add_ps(_mm_add_ps(_mm_mul_ps(capsuleToSphereX, halfSegmentX), _mm_mul_ps(capsuleToSphereY, halfSegmentY)),
+                                              _mm_mul_ps(capsuleToSphereZ, halfSegmentZ));
+        const __m128 halfSegmentsLengthSquare = _mm_add_ps(_mm_add_ps(_mm_mul_ps(halfSegmentX, halfSegmentX), _mm_mul_ps(halfSegmentY, halfSegmentY)),
+                                                           _mm_mul_ps(halfSegmentZ, halfSegmentZ));
+        __m128 t = _mm_div_ps(projections, _mm_max_ps(halfSegmentsLengthSquare, _mm_set1_ps(MACHINE_EPSILON)));
+        t = _mm_min_ps(_mm_max_ps(t, _mm_set1_ps(decimal(-1.0))), _mm_set1_ps(decimal(1.0)));
+
+        // Compute the squared distances between the centers of the spheres and the segments
+        const __m128 distanceX = _mm_sub_ps(capsuleToSphereX, _mm_mul_ps(t, halfSegmentX));
+        const __m128 distanceY = _mm_sub_ps(capsuleToSphereY, _mm_mul_ps(t, halfSegmentY));
+        const __m128 distanceZ = _mm_sub_ps(capsuleToSphereZ, _mm_mul_ps(t, halfSegmentZ));
+        const __m128 distancesSquare = _mm_add_ps(_mm_add_ps(_mm_mul_ps(distanceX, distanceX), _mm_mul_ps(distanceY, distanceY)),
+                                                  _mm_mul_ps(distanceZ, distanceZ));
+
+        // Compute the squared sums of the radiuses (with the tolerance)
+        const __m128 sumRadiuses = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&narrowPhaseInfoBatch.sphereRadiuses[batchIndex]),
+                                                         _mm_loadu_ps(&narrowPhaseInfoBatch.capsuleRadiuses[batchIndex])),
+                                              _mm_set1_ps(decimal(1.0) + tolerance));
+
+        return static_cast<uint32>(_mm_movemask_ps(_mm_cmplt_ps(distancesSquare, _mm_mul_ps(sumRadiuses, sumRadiuses))));
+    }
 
-        // Compute the distance between the sphere center and the closest point on the segment
-        Vector3 sphereCenterToSegment = (closestPointOnSegment - sphereCenter);
-        const decimal sphereSegmentDistanceSquare = sphereCenterToSegment.lengthSquare();
+#endif
 
-        // Compute the sum of the radius of the sphere and the capsule (virtual sphere)
-        decimal sumRadius = narrowPhaseInfoBatch.sphereRadiuses[batchIndex] + narrowPhaseInfoBatch.capsuleRadiuses[batchIndex];
+    uint32 mask = 0;
+    for (uint i=0; i < nbItems; i++) {
 
-        // If the collision shapes overlap
-        if (sphereSegmentDistanceSquare < sumRadius * sumRadius) {
+        const uint index = batchIndex + i;
 
-            decimal penetrationDepth;
-            Vector3 normalWorld;
-            Vector3 contactPointSphereLocal;
-            Vector3 contactPointCapsuleLocal;
+        const Vector3 capsuleToSphere(narrowPhaseInfoBatch.sphereCentersX[index] - narrowPhaseInfoBatch.capsuleCentersX[index],
+                                      narrowPhaseInfoBatch.sphereCentersY[index] - narrowPhaseInfoBatch.capsuleCentersY[index],
+                                      narrowPhaseInfoBatch.sphereCentersZ[index] - narrowPhaseInfoBatch.capsuleCentersZ[index]);
+        const Vector3 halfSegment(narrowPhaseInfoBatch.capsuleHalfSegmentsX[index], narrowPhaseInfoBatch.capsuleHalfSegmentsY[index],
+                                  narrowPhaseInfoBatch.capsuleHalfSegmentsZ[index]);
 
-            // If we need to report contacts
-            if (narrowPhaseInfoBatch.reportContacts[batchIndex]) {
+        // Compute the parameter in [-1, 1] of the closest point on the inner segment
+        decimal t = capsuleToSphere.dot(halfSegment) / std::max(halfSegment.lengthSquare(), MACHINE_EPSILON);
+        t = std::min(std::max(t, decimal(-1.0)), decimal(1.0));
 
-                // If the sphere center is not on the capsule inner segment
-                if (sphereSegmentDistanceSquare > MACHINE_EPSILON) {
+        const decimal distanceSquare = (capsuleToSphere - t * halfSegment).lengthSquare();
+        const decimal sumRadiuses = (narrowPhaseInfoBatch.sphereRadiuses[index] + narrowPhaseInfoBatch.capsuleRadiuses[index]) * (decimal(1.0) + tolerance);
 
-                    decimal sphereSegmentDistance = std::sqrt(sphereSegmentDistanceSquare);
-                    sphereCenterToSegment /= sphereSegmentDistance;
+        mask |= static_cast<uint32>(distanceSquare < sumRadiuses * sumRadiuses) << i;
+    }
 
-                    contactPointSphereLocal = sphereToCapsuleSpaceTransform.getInverse() * (sphereCenter + sphereCenterToSegment * narrowPhaseInfoBatch.sphereRadiuses[batchIndex]);
-                    contactPointCapsuleLocal = closestPointOnSegment - sphereCenterToSegment * narrowPhaseInfoBatch.capsuleRadiuses[batchIndex];
+    return mask;
+}
 
-                    normalWorld = capsuleToWorldTransform.getOrientation() * sphereCenterToSegment;
+// Compute the narrow-phase collision detection of a single item of a batch
+// This technique is based on the "Robust Contact Creation for Physics Simulations" presentation
+// by Dirk Gregorius.
+bool SphereVsCapsuleAlgorithm::testPairCollision(SphereVsCapsuleNarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchIndex) {
 
-                    penetrationDepth = sumRadius - sphereSegmentDistance;
+    const bool isSphereShape1 = narrowPhaseInfoBatch.isSpheresShape1[batchIndex];
 
-                    if (!isSphereShape1) {
-                        normalWorld = -normalWorld;
-                    }
-                }
-                else {  // If the sphere center is on the capsule inner segment (degenerate case)
+    // Get the transform from sphere local-space to capsule local-space
+    const Transform& sphereToWorldTransform = isSphereShape1 ? narrowPhaseInfoBatch.shape1ToWorldTransforms[batchIndex] : narrowPhaseInfoBatch.shape2ToWorldTransforms[batchIndex];
+    const Transform& capsuleToWorldTransform = isSphereShape1 ? narrowPhaseInfoBatch.shape2ToWorldTransforms[batchIndex] : narrowPhaseInfoBatch.shape1ToWorldTransforms[batchIndex];
+    const Transform worldToCapsuleTransform = capsuleToWorldTransform.getInverse();
+    const Transform sphereToCapsuleSpaceTransform = worldToCapsuleTransform * sphereToWorldTransform;
 
-                    // We take any direction that is orthogonal to the inner capsule segment as a contact normal
+    // Transform the center of the sphere into the local-space of the capsule shape
+    const Vector3 sphereCenter = sphereToCapsuleSpaceTransform.getPosition();
 
-                    // Capsule inner segment
-                    Vector3 capsuleSegment = (capsuleSegB - capsuleSegA).getUnit();
+    // Compute the end-points of the inner segment of the capsule
+    const decimal capsuleHalfHeight = narrowPhaseInfoBatch.capsuleHeights[batchIndex] * decimal(0.5);
+    const Vector3 capsuleSegA(0, -capsuleHalfHeight, 0);
+    const Vector3 capsuleSegB(0, capsuleHalfHeight, 0);
 
-                    Vector3 vec1(1, 0, 0);
-                    Vector3 vec2(0, 1, 0);
+    // Compute the point on the inner capsule segment that is the closes to center of sphere
+    const Vector3 closestPointOnSegment = computeClosestPointOnSegment(capsuleSegA, capsuleSegB, sphereCenter);
 
-                    // Get the vectors (among vec1 and vec2) that is the most orthogonal to the capsule inner segment (smallest absolute dot product)
-                    decimal cosA1 = std::abs(capsuleSegment.x);		// abs(vec1.dot(seg2))
-                    decimal cosA2 = std::abs(capsuleSegment.y);	    // abs(vec2.dot(seg2))
+    // Compute the distance between the sphere center and the closest point on the segment
+    Vector3 sphereCenterToSegment = (closestPointOnSegment - sphereCenter);
+    const decimal sphereSegmentDistanceSquare = sphereCenterToSegment.lengthSquare();
 
-                    penetrationDepth = sumRadius;
+    // Compute the sum of the radius of the sphere and the capsule (virtual sphere)
+    decimal sumRadius = narrowPhaseInfoBatch.sphereRadiuses[batchIndex] + narrowPhaseInfoBatch.capsuleRadiuses[batchIndex];
 
-                    // We choose as a contact normal, any direction that is perpendicular to the inner capsule segment
-                    Vector3 normalCapsuleSpace = cosA1 < cosA2 ? capsuleSegment.cross(vec1) : capsuleSegment.cross(vec2);
-                    normalWorld = capsuleToWorldTransform.getOrientation() * normalCapsuleSpace;
+    // If the collision shapes overlap
+    if (sphereSegmentDistanceSquare < sumRadius * sumRadius) {
 
-                    // Compute the two local contact points
-                    contactPointSphereLocal = sphereToCapsuleSpaceTransform.getInverse() * (sphereCenter + normalCapsuleSpace * narrowPhaseInfoBatch.sphereRadiuses[batchIndex]);
-                    contactPointCapsuleLocal = sphereCenter - normalCapsuleSpace * narrowPhaseInfoBatch.capsuleRadiuses[batchIndex];
-                }
+        decimal penetrationDepth;
+        Vector3 normalWorld;
+        Vector3 contactPointSphereLocal;
+        Vector3 contactPointCapsuleLocal;
 
-                if (penetrationDepth <= decimal(0.0)) {
+        // If we need to report contacts
+        if (narrowPhaseInfoBatch.reportContacts[batchIndex]) {
 
-                    // No collision
-                    continue;
+            // If the sphere center is not on the capsule inner segment
+            if (sphereSegmentDistanceSquare > MACHINE_EPSILON) {
+
+                decimal sphereSegmentDistance = std::sqrt(sphereSegmentDistanceSquare);
+                sphereCenterToSegment /= sphereSegmentDistance;
+
+                contactPointSphereLocal = sphereToCapsuleSpaceTransform.getInverse() * (sphereCenter + sphereCenterToSegment * narrowPhaseInfoBatch.sphereRadiuses[batchIndex]);
+                contactPointCapsuleLocal = closestPointOnSegment - sphereCenterToSegment * narrowPhaseInfoBatch.capsuleRadiuses[batchIndex];
+
+                normalWorld = capsuleToWorldTransform.getOrientation() * sphereCenterToSegment;
+
+                penetrationDepth = sumRadius - sphereSegmentDistance;
+
+                if (!isSphereShape1) {
+                    normalWorld = -normalWorld;
                 }
+            }
+            else {  // If the sphere center is on the capsule inner segment (degenerate case)
+
+                // We take any direction that is orthogonal to the inner capsule segment as a contact normal
+
+                // Capsule inner segment
+                Vector3 capsuleSegment = (capsuleSegB - capsuleSegA).getUnit();
+
+                Vector3 vec1(1, 0, 0);
+                Vector3 vec2(0, 1, 0);
 
-                // Create the contact info object
-                narrowPhaseInfoBatch.addContactPoint(batchIndex, normalWorld, penetrationDepth,
-                                                 isSphereShape1 ? contactPointSphereLocal : contactPointCapsuleLocal,
-                                                 isSphereShape1 ? contactPointCapsuleLocal : contactPointSphereLocal);
+                // Get the vectors (among vec1 and vec2) that is the most orthogonal to the capsule inner segment (smallest absolute dot product)
+                decimal cosA1 = std::abs(capsuleSegment.x);		// abs(vec1.dot(seg2))
+                decimal cosA2 = std::abs(capsuleSegment.y);	    // abs(vec2.dot(seg2))
+
+                penetrationDepth = sumRadius;
+
+                // We choose as a contact normal, any direction that is perpendicular to the inner capsule segment
+                Vector3 normalCapsuleSpace = cosA1 < cosA2 ? capsuleSegment.cross(vec1) : capsuleSegment.cross(vec2);
+                normalWorld = capsuleToWorldTransform.getOrientation() * normalCapsuleSpace;
+
+                // Compute the two local contact points
+                contactPointSphereLocal = sphereToCapsuleSpaceTransform.getInverse() * (sphereCenter + normalCapsuleSpace * narrowPhaseInfoBatch.sphereRadiuses[batchIndex]);
+                contactPointCapsuleLocal = sphereCenter - normalCapsuleSpace * narrowPhaseInfoBatch.capsuleRadiuses[batchIndex];
+            }
+
+            if (penetrationDepth <= decimal(0.0)) {
+
+                // No collision
+                return false;
             }
 
-            narrowPhaseInfoBatch.isColliding[batchIndex] = true;
-            isCollisionFound = true;
-            continue;
+            // Create the contact info object
+            narrowPhaseInfoBatch.addContactPoint(batchIndex, normalWorld, penetrationDepth,
+                                             isSphereShape1 ? contactPointSphereLocal : contactPointCapsuleLocal,
+                                             isSphereShape1 ? contactPointCapsuleLocal : contactPointSphereLocal);
         }
+
+        narrowPhaseInfoBatch.isColliding[batchIndex] = true;
+        return true;
     }
 
-    return isCollisionFound;
+    return false;
 }
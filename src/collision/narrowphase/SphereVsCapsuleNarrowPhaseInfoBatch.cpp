@@ -34,17 +34,19 @@ using namespace reactphysics3d;
 SphereVsCapsuleNarrowPhaseInfoBatch::SphereVsCapsuleNarrowPhaseInfoBatch(MemoryAllocator& allocator,
                                                                          OverlappingPairs& overlappingPairs)
       : NarrowPhaseInfoBatch(allocator, overlappingPairs), isSpheresShape1(allocator), sphereRadiuses(allocator), capsuleRadiuses(allocator),
-        capsuleHeights(allocator) {
+        capsuleHeights(allocator), sphereCentersX(allocator), sphereCentersY(allocator), sphereCentersZ(allocator),
+        capsuleCentersX(allocator), capsuleCentersY(allocator), capsuleCentersZ(allocator),
+        capsuleHalfSegmentsX(allocator), capsuleHalfSegmentsY(allocator), capsuleHalfSegmentsZ(allocator) {
 
 }
 
 // Add shapes to be tested during narrow-phase collision detection into the batch
 void SphereVsCapsuleNarrowPhaseInfoBatch::addNarrowPhaseInfo(uint64 pairId, uint64 pairIndex, Entity collider1, Entity collider2, CollisionShape* shape1, CollisionShape* shape2,
                                                             const Transform& shape1Transform, const Transform& shape2Transform,
-                                                            bool needToReportContacts, MemoryAllocator& shapeAllocator) {
+                                                            bool needToReportContacts) {
 
     NarrowPhaseInfoBatch::addNarrowPhaseInfo(pairId, pairIndex, collider1, collider2, shape1, shape2, shape1Transform,
-                                             shape2Transform, needToReportContacts, shapeAllocator);
+                                             shape2Transform, needToReportContacts);
 
     bool isSphereShape1 = shape1->getType() == CollisionShapeType::SPHERE;
     isSpheresShape1.add(isSphereShape1);
@@ -58,6 +60,21 @@ void SphereVsCapsuleNarrowPhaseInfoBatch::addNarrowPhaseInfo(uint64 pairId, uint
     sphereRadiuses.add(sphereShape->getRadius());
     capsuleRadiuses.add(capsuleShape->getRadius());
     capsuleHeights.add(capsuleShape->getHeight());
+
+    const Transform& sphereToWorldTransform = isSphereShape1 ? shape1Transform : shape2Transform;
+    const Transform& capsuleToWorldTransform = isSphereShape1 ? shape2Transform : shape1Transform;
+    const Vector3& sphereCenter = sphereToWorldTransform.getPosition();
+    const Vector3& capsuleCenter = capsuleToWorldTransform.getPosition();
+    const Vector3 capsuleHalfSegment = capsuleToWorldTransform.getOrientation() * Vector3(0, capsuleShape->getHeight() * decimal(0.5), 0);
+    sphereCentersX.add(sphereCenter.x);
+    sphereCentersY.add(sphereCenter.y);
+    sphereCentersZ.add(sphereCenter.z);
+    capsuleCentersX.add(capsuleCenter.x);
+    capsuleCentersY.add(capsuleCenter.y);
+    capsuleCentersZ.add(capsuleCenter.z);
+    capsuleHalfSegmentsX.add(capsuleHalfSegment.x);
+    capsuleHalfSegmentsY.add(capsuleHalfSegment.y);
+    capsuleHalfSegmentsZ.add(capsuleHalfSegment.z);
 }
 
 // Initialize the containers using cached capacity
@@ -69,6 +86,15 @@ void SphereVsCapsuleNarrowPhaseInfoBatch::reserveMemory() {
     sphereRadiuses.reserve(mCachedCapacity);
     capsuleRadiuses.reserve(mCachedCapacity);
     capsuleHeights.reserve(mCachedCapacity);
+    sphereCentersX.reserve(mCachedCapacity);
+    sphereCentersY.reserve(mCachedCapacity);
+    sphereCentersZ.reserve(mCachedCapacity);
+    capsuleCentersX.reserve(mCachedCapacity);
+    capsuleCentersY.reserve(mCachedCapacity);
+    capsuleCentersZ.reserve(mCachedCapacity);
+    capsuleHalfSegmentsX.reserve(mCachedCapacity);
+    capsuleHalfSegmentsY.reserve(mCachedCapacity);
+    capsuleHalfSegmentsZ.reserve(mCachedCapacity);
 }
 
 // Clear all the objects in the batch
@@ -85,4 +111,13 @@ void SphereVsCapsuleNarrowPhaseInfoBatch::clear() {
     sphereRadiuses.clear(true);
     capsuleRadiuses.clear(true);
     capsuleHeights.clear(true);
+    sphereCentersX.clear(true);
+    sphereCentersY.clear(true);
+    sphereCentersZ.clear(true);
+    capsuleCentersX.clear(true);
+    capsuleCentersY.clear(true);
+    capsuleCentersZ.clear(true);
+    capsuleHalfSegmentsX.clear(true);
+    capsuleHalfSegmentsY.clear(true);
+    capsuleHalfSegmentsZ.clear(true);
 }
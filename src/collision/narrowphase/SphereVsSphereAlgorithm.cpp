@@ -28,74 +28,147 @@
 #include <reactphysics3d/collision/shapes/SphereShape.h>
 #include <reactphysics3d/collision/narrowphase/SphereVsSphereNarrowPhaseInfoBatch.h>
 
+// The pairs of spheres are tested for overlap with SSE instructions when they are available
+#ifdef RP3D_SSE_ENABLED
+    #include <xmmintrin.h>
+#endif
+
 // We want to use the ReactPhysics3D namespace
 using namespace reactphysics3d;  
 
+// Static constants definitions
+const uint SphereVsSphereAlgorithm::NB_PAIRS_PER_OVERLAP_TEST;
+
+// Compute the narrow-phase collision detection between spheres
+/// The consecutive pairs of spheres of the batch are first tested for overlap four at a time
+/// using the world-space centers of the batch. The contact points are then only computed for
+/// the overlapping pairs.
 bool SphereVsSphereAlgorithm::testCollision(SphereVsSphereNarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchStartIndex, uint batchNbItems, MemoryAllocator& memoryAllocator) {
 
     bool isCollisionFound = false;
 
-    // For each item in the batch
-    for (uint batchIndex = batchStartIndex; batchIndex < batchStartIndex + batchNbItems; batchIndex++) {
+    const uint batchEndIndex = batchStartIndex + batchNbItems;
 
-        assert(narrowPhaseInfoBatch.contactPoints[batchIndex].size() == 0);
-        assert(!narrowPhaseInfoBatch.isColliding[batchIndex]);
+    // For each group of consecutive items in the batch
+    for (uint batchIndex = batchStartIndex; batchIndex < batchEndIndex; batchIndex += NB_PAIRS_PER_OVERLAP_TEST) {
 
-        // Get the local-space to world-space transforms
-        const Transform& transform1 = narrowPhaseInfoBatch.shape1ToWorldTransforms[batchIndex];
-        const Transform& transform2 = narrowPhaseInfoBatch.shape2ToWorldTransforms[batchIndex];
+        const uint nbItems = std::min(NB_PAIRS_PER_OVERLAP_TEST, batchEndIndex - batchIndex);
 
-        // Compute the distance between the centers
-        Vector3 vectorBetweenCenters = transform2.getPosition() - transform1.getPosition();
-        decimal squaredDistanceBetweenCenters = vectorBetweenCenters.lengthSquare();
+        // Test the pairs of spheres for overlap
+        const uint32 overlapMask = computeOverlapMask(narrowPhaseInfoBatch, batchIndex, nbItems);
 
-        // Compute the sum of the radius
-        decimal sumRadiuses = narrowPhaseInfoBatch.sphere1Radiuses[batchIndex] + narrowPhaseInfoBatch.sphere2Radiuses[batchIndex];
+        for (uint i=0; i < nbItems; i++) {
 
-        // Compute the product of the sum of the radius
-        decimal sumRadiusesProducts = sumRadiuses * sumRadiuses;
+            assert(narrowPhaseInfoBatch.nbContactPoints[batchIndex + i] == 0);
+            assert(!narrowPhaseInfoBatch.isColliding[batchIndex + i]);
 
-        // If the sphere collision shapes intersect
-        if (squaredDistanceBetweenCenters < sumRadiusesProducts) {
+            // If the sphere collision shapes intersect
+            if ((overlapMask & (1u << i)) != 0) {
 
-            // If we need to report contacts
-            if (narrowPhaseInfoBatch.reportContacts[batchIndex]) {
+                // If we need to report contacts
+                if (narrowPhaseInfoBatch.reportContacts[batchIndex + i]) {
+                    computeContactPoint(narrowPhaseInfoBatch, batchIndex + i);
+                }
 
-                const Transform transform1Inverse = transform1.getInverse();
-                const Transform transform2Inverse = transform2.getInverse();
+                narrowPhaseInfoBatch.isColliding[batchIndex + i] = true;
+                isCollisionFound = true;
+            }
+        }
+    }
 
-                decimal penetrationDepth = sumRadiuses - std::sqrt(squaredDistanceBetweenCenters);
-                Vector3 intersectionOnBody1;
-                Vector3 intersectionOnBody2;
-                Vector3 normal;
+    return isCollisionFound;
+}
 
-                // If the two sphere centers are not at the same position
-                if (squaredDistanceBetweenCenters > MACHINE_EPSILON) {
+// Return the bit mask of the overlapping pairs of spheres among (at most) four consecutive items of a batch
+/// The bit i of the mask is set if the two spheres of the item (batchIndex + i) overlap
+uint32 SphereVsSphereAlgorithm::computeOverlapMask(const SphereVsSphereNarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchIndex, uint nbItems) {
 
-                    Vector3 centerSphere2InBody1LocalSpace = transform1Inverse * transform2.getPosition();
-                    Vector3 centerSphere1InBody2LocalSpace = transform2Inverse * transform1.getPosition();
+    assert(nbItems <= NB_PAIRS_PER_OVERLAP_TEST);
 
-                    intersectionOnBody1 = narrowPhaseInfoBatch.sphere1Radiuses[batchIndex] * centerSphere2InBody1LocalSpace.getUnit();
-                    intersectionOnBody2 = narrowPhaseInfoBatch.sphere2Radiuses[batchIndex] * centerSphere1InBody2LocalSpace.getUnit();
-                    normal = vectorBetweenCenters.getUnit();
-                }
-                else {    // If the sphere centers are at the same position (degenerate case)
+#ifdef RP3D_SSE_ENABLED
 
-                    // Take any contact normal direction
-                    normal.setAllValues(0, 1, 0);
+    if (nbItems == NB_PAIRS_PER_OVERLAP_TEST) {
 
-                    intersectionOnBody1 = narrowPhaseInfoBatch.sphere1Radiuses[batchIndex] * (transform1Inverse.getOrientation() * normal);
-                    intersectionOnBody2 = narrowPhaseInfoBatch.sphere2Radiuses[batchIndex] * (transform2Inverse.getOrientation() * normal);
-                }
+        // Compute the squared distances between the centers
+        const __m128 vectorBetweenCentersX = _mm_sub_ps(_mm_loadu_ps(&narrowPhaseInfoBatch.sphere2CentersX[batchIndex]),
+                                                        _mm_loadu_ps(&narrowPhaseInfoBatch.sphere1CentersX[batchIndex]));
+        const __m128 vectorBetweenCentersY = _mm_sub_ps(_mm_loadu_ps(&narrowPhaseInfoBatch.sphere2CentersY[batchIndex]),
+                                                        _mm_loadu_ps(&narrowPhaseInfoBatch.sphere1CentersY[batchIndex]));
+        const __m128 vectorBetweenCentersZ = _mm_sub_ps(_mm_loadu_ps(&narrowPhaseInfoBatch.sphere2CentersZ[batchIndex]),
+                                                        _mm_loadu_ps(&narrowPhaseInfoBatch.sphere1CentersZ[batchIndex]));
+        const __m128 squaredDistancesBetweenCenters = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vectorBetweenCentersX, vectorBetweenCentersX),
+                                                                            _mm_mul_ps(vectorBetweenCentersY, vectorBetweenCentersY)),
+                                                                 _mm_mul_ps(vectorBetweenCentersZ, vectorBetweenCentersZ));
 
-                // Create the contact info object
-                narrowPhaseInfoBatch.addContactPoint(batchIndex, normal, penetrationDepth, intersectionOnBody1, intersectionOnBody2);
-            }
+        // Compute the squared sums of the radiuses
+        const __m128 sumRadiuses = _mm_add_ps(_mm_loadu_ps(&narrowPhaseInfoBatch.sphere1Radiuses[batchIndex]),
+                                              _mm_loadu_ps(&narrowPhaseInfoBatch.sphere2Radiuses[batchIndex]));
 
-            narrowPhaseInfoBatch.isColliding[batchIndex] = true;
-            isCollisionFound = true;
-        }
+        return static_cast<uint32>(_mm_movemask_ps(_mm_cmplt_ps(squaredDistancesBetweenCenters, _mm_mul_ps(sumRadiuses, sumRadiuses))));
     }
 
-    return isCollisionFound;
+#endif
+
+    uint32 mask = 0;
+    for (uint i=0; i < nbItems; i++) {
+
+        const uint index = batchIndex + i;
+
+        const decimal vectorBetweenCentersX = narrowPhaseInfoBatch.sphere2CentersX[index] - narrowPhaseInfoBatch.sphere1CentersX[index];
+        const decimal vectorBetweenCentersY = narrowPhaseInfoBatch.sphere2CentersY[index] - narrowPhaseInfoBatch.sphere1CentersY[index];
+        const decimal vectorBetweenCentersZ = narrowPhaseInfoBatch.sphere2CentersZ[index] - narrowPhaseInfoBatch.sphere1CentersZ[index];
+        const decimal squaredDistanceBetweenCenters = vectorBetweenCentersX * vectorBetweenCentersX + vectorBetweenCentersY * vectorBetweenCentersY +
+                                                      vectorBetweenCentersZ * vectorBetweenCentersZ;
+
+        const decimal sumRadiuses = narrowPhaseInfoBatch.sphere1Radiuses[index] + narrowPhaseInfoBatch.sphere2Radiuses[index];
+
+        mask |= static_cast<uint32>(squaredDistanceBetweenCenters < sumRadiuses * sumRadiuses) << i;
+    }
+
+    return mask;
+}
+
+// Compute the contact point of two overlapping spheres
+void SphereVsSphereAlgorithm::computeContactPoint(SphereVsSphereNarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchIndex) {
+
+    // Get the local-space to world-space transforms
+    const Transform& transform1 = narrowPhaseInfoBatch.shape1ToWorldTransforms[batchIndex];
+    const Transform& transform2 = narrowPhaseInfoBatch.shape2ToWorldTransforms[batchIndex];
+
+    // Compute the distance between the centers
+    Vector3 vectorBetweenCenters = transform2.getPosition() - transform1.getPosition();
+    decimal squaredDistanceBetweenCenters = vectorBetweenCenters.lengthSquare();
+
+    // Compute the sum of the radius
+    decimal sumRadiuses = narrowPhaseInfoBatch.sphere1Radiuses[batchIndex] + narrowPhaseInfoBatch.sphere2Radiuses[batchIndex];
+
+    const Transform transform1Inverse = transform1.getInverse();
+    const Transform transform2Inverse = transform2.getInverse();
+
+    decimal penetrationDepth = sumRadiuses - std::sqrt(squaredDistanceBetweenCenters);
+    Vector3 intersectionOnBody1;
+    Vector3 intersectionOnBody2;
+    Vector3 normal;
+
+    // If the two sphere centers are not at the same position
+    if (squaredDistanceBetweenCenters > MACHINE_EPSILON) {
+
+        Vector3 centerSphere2InBody1LocalSpace = transform1Inverse * transform2.getPosition();
+        Vector3 centerSphere1InBody2LocalSpace = transform2Inverse * transform1.getPosition();
+
+        intersectionOnBody1 = narrowPhaseInfoBatch.sphere1Radiuses[batchIndex] * centerSphere2InBody1LocalSpace.getUnit();
+        intersectionOnBody2 = narrowPhaseInfoBatch.sphere2Radiuses[batchIndex] * centerSphere1InBody2LocalSpace.getUnit();
+        normal = vectorBetweenCenters.getUnit();
+    }
+    else {    // If the sphere centers are at the same position (degenerate case)
+
+        // Take any contact normal direction
+        normal.setAllValues(0, 1, 0);
+
+        intersectionOnBody1 = narrowPhaseInfoBatch.sphere1Radiuses[batchIndex] * (transform1Inverse.getOrientation() * normal);
+        intersectionOnBody2 = narrowPhaseInfoBatch.sphere2Radiuses[batchIndex] * (transform2Inverse.getOrientation() * normal);
+    }
+
+    // Create the contact info object
+    narrowPhaseInfoBatch.addContactPoint(batchIndex, normal, penetrationDepth, intersectionOnBody1, intersectionOnBody2);
 }
@@ -31,16 +31,18 @@ using namespace reactphysics3d;
 
 // Constructor
 SphereVsSphereNarrowPhaseInfoBatch::SphereVsSphereNarrowPhaseInfoBatch(MemoryAllocator& allocator, OverlappingPairs& overlappingPairs)
-      : NarrowPhaseInfoBatch(allocator, overlappingPairs), sphere1Radiuses(allocator), sphere2Radiuses(allocator) {
+      : NarrowPhaseInfoBatch(allocator, overlappingPairs), sphere1Radiuses(allocator), sphere2Radiuses(allocator),
+        sphere1CentersX(allocator), sphere1CentersY(allocator), sphere1CentersZ(allocator),
+        sphere2CentersX(allocator), sphere2CentersY(allocator), sphere2CentersZ(allocator) {
 
 }
 
 // Add shapes to be tested during narrow-phase collision detection into the batch
 void SphereVsSphereNarrowPhaseInfoBatch::addNarrowPhaseInfo(uint64 pairId, uint64 pairIndex, Entity collider1, Entity collider2, CollisionShape* shape1, CollisionShape* shape2,
-                                                            const Transform& shape1Transform, const Transform& shape2Transform, bool needToReportContacts, MemoryAllocator &shapeAllocator) {
+                                                            const Transform& shape1Transform, const Transform& shape2Transform, bool needToReportContacts) {
 
     NarrowPhaseInfoBatch::addNarrowPhaseInfo(pairId, pairIndex, collider1, collider2, shape1, shape2, shape1Transform,
-                                             shape2Transform, needToReportContacts, shapeAllocator);
+                                             shape2Transform, needToReportContacts);
 
     assert(shape1->getType() == CollisionShapeType::SPHERE);
     assert(shape2->getType() == CollisionShapeType::SPHERE);
@@ -50,6 +52,15 @@ void SphereVsSphereNarrowPhaseInfoBatch::addNarrowPhaseInfo(uint64 pairId, uint6
 
     sphere1Radiuses.add(sphere1->getRadius());
     sphere2Radiuses.add(sphere2->getRadius());
+
+    const Vector3& center1 = shape1Transform.getPosition();
+    const Vector3& center2 = shape2Transform.getPosition();
+    sphere1CentersX.add(center1.x);
+    sphere1CentersY.add(center1.y);
+    sphere1CentersZ.add(center1.z);
+    sphere2CentersX.add(center2.x);
+    sphere2CentersY.add(center2.y);
+    sphere2CentersZ.add(center2.z);
 }
 
 // Initialize the containers using cached capacity
@@ -59,6 +70,12 @@ void SphereVsSphereNarrowPhaseInfoBatch::reserveMemory() {
 
     sphere1Radiuses.reserve(mCachedCapacity);
     sphere2Radiuses.reserve(mCachedCapacity);
+    sphere1CentersX.reserve(mCachedCapacity);
+    sphere1CentersY.reserve(mCachedCapacity);
+    sphere1CentersZ.reserve(mCachedCapacity);
+    sphere2CentersX.reserve(mCachedCapacity);
+    sphere2CentersY.reserve(mCachedCapacity);
+    sphere2CentersZ.reserve(mCachedCapacity);
 }
 
 // Clear all the objects in the batch
@@ -73,5 +90,11 @@ void SphereVsSphereNarrowPhaseInfoBatch::clear() {
 
     sphere1Radiuses.clear(true);
     sphere2Radiuses.clear(true);
+    sphere1CentersX.clear(true);
+    sphere1CentersY.clear(true);
+    sphere1CentersZ.clear(true);
+    sphere2CentersX.clear(true);
+    sphere2CentersY.clear(true);
+    sphere2CentersZ.clear(true);
 }
 
@@ -27,6 +27,8 @@
 #include <reactphysics3d/collision/shapes/ConcaveMeshShape.h>
 #include <reactphysics3d/memory/MemoryManager.h>
 #include <reactphysics3d/collision/RaycastInfo.h>
+#include <reactphysics3d/collision/RayPacket.h>
+#include <reactphysics3d/collision/Collider.h>
 #include <reactphysics3d/collision/TriangleMesh.h>
 #include <reactphysics3d/utils/Profiler.h>
 #include <reactphysics3d/collision/TriangleVertexArray.h>
@@ -34,20 +36,28 @@
 using namespace reactphysics3d;
 
 // Constructor
-ConcaveMeshShape::ConcaveMeshShape(TriangleMesh* triangleMesh, MemoryAllocator& allocator, const Vector3& scaling)
-                 : ConcaveShape(CollisionShapeName::TRIANGLE_MESH, allocator, scaling), mDynamicAABBTree(allocator) {
+ConcaveMeshShape::ConcaveMeshShape(TriangleMesh* triangleMesh, MemoryAllocator& allocator, const Vector3& scaling,
+                                   TaskScheduler* taskScheduler)
+                 : ConcaveShape(CollisionShapeName::TRIANGLE_MESH, allocator, scaling), mTree(allocator) {
 
     mTriangleMesh = triangleMesh;
     mRaycastTestType = TriangleRaycastSide::FRONT;
 
-    // Insert all the triangles into the dynamic AABB tree
-    initBVHTree();
+    // Build the AABB tree of the triangles
+    initBVHTree(allocator, taskScheduler);
 }
 
-// Insert all the triangles into the dynamic AABB tree
-void ConcaveMeshShape::initBVHTree() {
+// Build the AABB tree of the triangles
+/// A dynamic AABB tree is built in a single pass from the AABBs of all the triangles of the mesh.
+/// Because the mesh never changes, it is then compressed into a quantized tree and destroyed.
+void ConcaveMeshShape::initBVHTree(MemoryAllocator& allocator, TaskScheduler* taskScheduler) {
 
-    // TODO : Try to randomly add the triangles into the tree to obtain a better tree
+    uint nbTriangles = 0;
+    for (uint subPart=0; subPart<mTriangleMesh->getNbSubparts(); subPart++) {
+        nbTriangles += mTriangleMesh->getSubpart(subPart)->getNbTriangles();
+    }
+
+    List<DynamicAABBTreeObject> triangles(allocator, nbTriangles);
 
     // For each sub-part of the mesh
     for (uint subPart=0; subPart<mTriangleMesh->getNbSubparts(); subPart++) {
@@ -66,10 +76,17 @@ void ConcaveMeshShape::initBVHTree() {
             // Create the AABB for the triangle
             AABB aabb = AABB::createAABBForTriangle(trianglePoints);
 
-            // Add the AABB with the index of the triangle into the dynamic AABB tree
-            mDynamicAABBTree.addObject(aabb, subPart, triangleIndex);
+            // Add the AABB with the index of the triangle into the array of objects of the tree
+            triangles.add(DynamicAABBTreeObject(aabb, static_cast<int32>(subPart), static_cast<int32>(triangleIndex)));
         }
     }
+
+    // Build the dynamic AABB tree
+    DynamicAABBTree dynamicAABBTree(allocator);
+    dynamicAABBTree.build(triangles, nullptr, taskScheduler);
+
+    // Compress the tree
+    mTree.build(dynamicAABBTree);
 }
 
 // Return the three vertices coordinates (in the array outTriangleVertices) of a triangle
@@ -134,27 +151,25 @@ void ConcaveMeshShape::computeOverlappingTriangles(const AABB& localAABB, List<V
     RP3D_PROFILE("ConcaveMeshShape::computeOverlappingTriangles()", mProfiler);
 
     // Scale the input AABB with the inverse scale of the concave mesh (because
-    // we store the vertices without scale inside the dynamic AABB tree
+    // we store the vertices without scale inside the AABB tree
     AABB aabb(localAABB);
     aabb.applyScale(Vector3(decimal(1.0) / mScale.x, decimal(1.0) / mScale.y, decimal(1.0) / mScale.z));
 
-    // Compute the nodes of the internal AABB tree that are overlapping with the AABB
-    List<int> overlappingNodes(allocator);
-    mDynamicAABBTree.reportAllShapesOverlappingWithAABB(aabb, overlappingNodes);
+    // Compute the leaves of the internal AABB tree that are overlapping with the AABB
+    List<int> overlappingLeaves(allocator);
+    mTree.reportAllShapesOverlappingWithAABB(aabb, overlappingLeaves);
 
-    const uint nbOverlappingNodes = overlappingNodes.size();
+    const uint nbOverlappingLeaves = overlappingLeaves.size();
 
     // Add space in the list of triangles vertices/normals for the new triangles
-    triangleVertices.addWithoutInit(nbOverlappingNodes * 3);
-    triangleVerticesNormals.addWithoutInit(nbOverlappingNodes * 3);
-
-    // For each overlapping node
-    for (uint i=0; i < nbOverlappingNodes; i++) {
+    triangleVertices.addWithoutInit(nbOverlappingLeaves * 3);
+    triangleVerticesNormals.addWithoutInit(nbOverlappingLeaves * 3);
 
-        int nodeId = overlappingNodes[i];
+    // For each overlapping leaf
+    for (uint i=0; i < nbOverlappingLeaves; i++) {
 
-        // Get the node data (triangle index and mesh subpart index)
-        int32* data = mDynamicAABBTree.getNodeDataInt(nodeId);
+        // Get the leaf data (triangle index and mesh subpart index)
+        const int32* data = mTree.getLeafDataInt(overlappingLeaves[i]);
 
         // Get the triangle vertices for this node from the concave mesh shape
         getTriangleVertices(data[0], data[1], &(triangleVertices[i * 3]));
@@ -175,12 +190,12 @@ bool ConcaveMeshShape::raycast(const Ray& ray, RaycastInfo& raycastInfo, Collide
     RP3D_PROFILE("ConcaveMeshShape::raycast()", mProfiler);
 
     // Apply the concave mesh inverse scale factor because the mesh is stored without scaling
-    // inside the dynamic AABB tree
+    // inside the AABB tree
     const Vector3 inverseScale(decimal(1.0) / mScale.x, decimal(1.0) / mScale.y, decimal(1.0) / mScale.z);
     Ray scaledRay(ray.point1 * inverseScale, ray.point2 * inverseScale, ray.maxFraction);
 
     // Create the callback object that will compute ray casting against triangles
-    ConcaveMeshRaycastCallback raycastCallback(mDynamicAABBTree, *this, collider, raycastInfo, scaledRay, mScale, allocator);
+    ConcaveMeshRaycastCallback raycastCallback(mTree, *this, collider, raycastInfo, scaledRay, mScale, allocator);
 
 #ifdef IS_RP3D_PROFILING_ENABLED
 
@@ -190,16 +205,36 @@ bool ConcaveMeshShape::raycast(const Ray& ray, RaycastInfo& raycastInfo, Collide
 
 #endif
 
-    // Ask the Dynamic AABB Tree to report all AABB nodes that are hit by the ray.
+    // Ask the AABB tree to report all the leaves that are hit by the ray.
     // The raycastCallback object will then compute ray casting against the triangles
     // in the hit AABBs.
-    mDynamicAABBTree.raycast(scaledRay, raycastCallback);
+    mTree.raycast(scaledRay, raycastCallback);
 
     raycastCallback.raycastTriangles();
 
     return raycastCallback.getIsHit();
 }
 
+// Raycast method for the rays of a packet in local-space
+/// The rays of the packet that are in the bit mask traverse the tree of the mesh together. The
+/// closest hit of each ray is written in the array of raycast infos (indexed by the rays of the
+/// packet) and the bit mask of the rays that have hit the mesh is returned. This method is not
+/// profiled because it can be called by several threads at the same time.
+uint32 ConcaveMeshShape::raycast(const RayPacket& packet, uint32 rayMask, RaycastInfo* outRaycastInfos,
+                                 Collider* collider, MemoryAllocator& allocator) const {
+
+    // Apply the concave mesh inverse scale factor because the mesh is stored without scaling
+    // inside the AABB tree
+    const Vector3 inverseScale(decimal(1.0) / mScale.x, decimal(1.0) / mScale.y, decimal(1.0) / mScale.z);
+    RayPacket scaledPacket(packet, rayMask, Transform::identity(), inverseScale);
+
+    ConcaveMeshRayPacketCallback raycastCallback(mTree, *this, collider, outRaycastInfos, mScale);
+
+    mTree.raycast(scaledPacket, allocator, raycastCallback);
+
+    return raycastCallback.getHitMask();
+}
+
 // Compute the shape Id for a given triangle of the mesh
 uint ConcaveMeshShape::computeTriangleShapeId(uint subPart, uint triangleIndex) const {
 
@@ -218,11 +253,11 @@ uint ConcaveMeshShape::computeTriangleShapeId(uint subPart, uint triangleIndex)
     return shapeId + triangleIndex;
 }
 
-// Collect all the AABB nodes that are hit by the ray in the Dynamic AABB Tree
-decimal ConcaveMeshRaycastCallback::raycastBroadPhaseShape(int32 nodeId, const Ray& ray) {
+// Collect all the leaves that are hit by the ray in the AABB tree
+decimal ConcaveMeshRaycastCallback::raycastBroadPhaseShape(int32 leafIndex, const Ray& ray) {
 
-    // Add the id of the hit AABB node into
-    mHitAABBNodes.add(nodeId);
+    // Add the index of the hit leaf
+    mHitAABBLeaves.add(leafIndex);
 
     return ray.maxFraction;
 }
@@ -233,10 +268,10 @@ void ConcaveMeshRaycastCallback::raycastTriangles() {
     List<int>::Iterator it;
     decimal smallestHitFraction = mRay.maxFraction;
 
-    for (it = mHitAABBNodes.begin(); it != mHitAABBNodes.end(); ++it) {
+    for (it = mHitAABBLeaves.begin(); it != mHitAABBLeaves.end(); ++it) {
 
-        // Get the node data (triangle index and mesh subpart index)
-        int32* data = mDynamicAABBTree.getNodeDataInt(*it);
+        // Get the leaf data (triangle index and mesh subpart index)
+        const int32* data = mTree.getLeafDataInt(*it);
 
         // Get the triangle vertices for this node from the concave mesh shape
         Vector3 trianglePoints[3];
@@ -281,6 +316,45 @@ void ConcaveMeshRaycastCallback::raycastTriangles() {
     }
 }
 
+// Raycast the rays of the packet that hit a leaf against its triangle
+void ConcaveMeshRayPacketCallback::raycastBroadPhaseShape(int32 leafIndex, RayPacket& packet, uint32 rayMask) {
+
+    // Get the leaf data (triangle index and mesh subpart index)
+    const int32* data = mTree.getLeafDataInt(leafIndex);
+
+    // Get the triangle vertices for this node from the concave mesh shape
+    Vector3 trianglePoints[3];
+    mConcaveMeshShape.getTriangleVertices(data[0], data[1], trianglePoints);
+
+    for (uint32 i=0; rayMask != 0; i++, rayMask >>= 1) {
+
+        if ((rayMask & 1) == 0) continue;
+
+        // Ray casting test against the triangle
+        decimal hitFraction;
+        Vector3 hitPoint;
+        Vector3 hitNormal;
+        if (TriangleShape::raycastTriangle(packet.getRay(i), trianglePoints, mConcaveMeshShape.getRaycastTestType(),
+                                           hitFraction, hitPoint, hitNormal)) {
+
+            assert(hitFraction >= decimal(0.0));
+
+            RaycastInfo& raycastInfo = mRaycastInfos[i];
+            raycastInfo.body = mCollider->getBody();
+            raycastInfo.collider = mCollider;
+            raycastInfo.hitFraction = hitFraction;
+            raycastInfo.worldPoint = hitPoint * mMeshScale;
+            raycastInfo.worldNormal = hitNormal;
+            raycastInfo.meshSubpart = data[0];
+            raycastInfo.triangleIndex = data[1];
+
+            // Clip the ray so that only the closer triangles are tested
+            packet.clipRay(i, hitFraction);
+            mHitMask |= 1u << i;
+        }
+    }
+}
+
 // Return the string representation of the shape
 std::string ConcaveMeshShape::to_string() const {
 
@@ -48,35 +48,100 @@ ConvexMeshShape::ConvexMeshShape(PolyhedronMesh* polyhedronMesh, MemoryAllocator
 }
 
 // Return a local support point in a given direction without the object margin.
-/// If the edges information is not used for collision detection, this method will go through
-/// the whole vertices list and pick up the vertex with the largest dot product in the support
-/// direction. This is an O(n) process with "n" being the number of vertices in the mesh.
-/// However, if the edges information is used, we can cache the previous support vertex and use
-/// it as a start in a hill-climbing (local search) process to find the new support vertex which
-/// will be in most of the cases very close to the previous one. Using hill-climbing, this method
-/// runs in almost constant time.
+/// If the polyhedron mesh is strictly convex, the support vertex is found with a hill-climbing
+/// (local search) from the first vertex. Otherwise, this method goes through the whole vertices
+/// list and picks up the vertex with the largest dot product in the support direction.
 Vector3 ConvexMeshShape::getLocalSupportPointWithoutMargin(const Vector3& direction) const {
 
-    decimal maxDotProduct = DECIMAL_SMALLEST;
-    uint indexMaxDotProduct = 0;
+    uint supportVertexIndex = 0;
+    return getCachedLocalSupportPointWithoutMargin(direction, supportVertexIndex);
+}
 
-    // For each vertex of the mesh
-    for (uint i=0; i<mPolyhedronMesh->getNbVertices(); i++) {
+// Return a local support point without the object margin starting the search at a cached vertex
+/// If the polyhedron mesh is strictly convex, we use the vertex adjacency of the half-edge
+/// structure to walk from the cached support vertex (usually the support vertex of the previous
+/// query) to a neighbor vertex with a larger dot product until there is no such neighbor. The
+/// support vertex is usually very close to the previous one and therefore this method runs in
+/// almost constant time instead of going through all the vertices.
+/**
+ * @param direction Support direction in the local-space of the shape
+ * @param supportVertexIndex Index of the vertex where the search starts. It is replaced by
+ *                           the index of the support vertex that has been found
+ * @return The support point (without margin) in local-space
+ */
+Vector3 ConvexMeshShape::getCachedLocalSupportPointWithoutMargin(const Vector3& direction,
+                                                                 uint& supportVertexIndex) const {
+
+    // The support vertex of the scaled mesh is the support vertex of the mesh in the scaled direction
+    const Vector3 scaledDirection = direction * mScale;
+
+    if (supportVertexIndex >= mPolyhedronMesh->getNbVertices()) {
+        supportVertexIndex = 0;
+    }
+
+    supportVertexIndex = computeSupportVertexIndex(scaledDirection, supportVertexIndex);
+
+    // Return the vertex with the largest dot product in the support direction
+    return mPolyhedronMesh->getVertex(supportVertexIndex) * mScale;
+}
+
+// Return the index of the vertex with the largest dot product with a (scaled) direction
+uint ConvexMeshShape::computeSupportVertexIndex(const Vector3& scaledDirection, uint startVertexIndex) const {
+
+    uint indexMaxDotProduct = startVertexIndex;
+    decimal maxDotProduct = scaledDirection.dot(mPolyhedronMesh->getVertex(startVertexIndex));
+
+    if (mPolyhedronMesh->isStrictlyConvex()) {
 
-        // Compute the dot product of the current vertex
-        decimal dotProduct = direction.dot(mPolyhedronMesh->getVertex(i));
+        const HalfEdgeStructure& halfEdgeStructure = mPolyhedronMesh->getHalfEdgeStructure();
 
-        // If the current dot product is larger than the maximum one
-        if (dotProduct > maxDotProduct) {
-            indexMaxDotProduct = i;
-            maxDotProduct = dotProduct;
+        bool isNeighborBetter;
+        do {
+
+            isNeighborBetter = false;
+
+            // For each half-edge starting at the current vertex
+            const uint firstEdgeIndex = halfEdgeStructure.getVertex(indexMaxDotProduct).edgeIndex;
+            uint edgeIndex = firstEdgeIndex;
+            do {
+
+                // The twin half-edge starts at the neighbor vertex at the end of the edge
+                const HalfEdgeStructure::Edge& edge = halfEdgeStructure.getHalfEdge(edgeIndex);
+                const HalfEdgeStructure::Edge& twinEdge = halfEdgeStructure.getHalfEdge(edge.twinEdgeIndex);
+
+                const decimal dotProduct = scaledDirection.dot(mPolyhedronMesh->getVertex(twinEdge.vertexIndex));
+                if (dotProduct > maxDotProduct) {
+                    indexMaxDotProduct = twinEdge.vertexIndex;
+                    maxDotProduct = dotProduct;
+                    isNeighborBetter = true;
+                }
+
+                // The next half-edge of the twin half-edge also starts at the current vertex
+                edgeIndex = twinEdge.nextEdgeIndex;
+
+            } while (edgeIndex != firstEdgeIndex);
+
+        } while (isNeighborBetter);
+    }
+    else {
+
+        // For each vertex of the mesh
+        for (uint i=0; i<mPolyhedronMesh->getNbVertices(); i++) {
+
+            // Compute the dot product of the current vertex
+            decimal dotProduct = scaledDirection.dot(mPolyhedronMesh->getVertex(i));
+
+            // If the current dot product is larger than the maximum one
+            if (dotProduct > maxDotProduct) {
+                indexMaxDotProduct = i;
+                maxDotProduct = dotProduct;
+            }
         }
     }
 
     assert(maxDotProduct >= decimal(0.0));
 
-    // Return the vertex with the largest dot product in the support direction
-    return mPolyhedronMesh->getVertex(indexMaxDotProduct) * mScale;
+    return indexMaxDotProduct;
 }
 
 // Recompute the bounds of the mesh
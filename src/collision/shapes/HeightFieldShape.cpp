@@ -25,11 +25,15 @@
 
 // Libraries
 #include <reactphysics3d/collision/shapes/HeightFieldShape.h>
+#include <reactphysics3d/collision/Collider.h>
 #include <reactphysics3d/collision/RaycastInfo.h>
 #include <reactphysics3d/utils/Profiler.h>
 
 using namespace reactphysics3d;
 
+// Static constants definitions
+const int HeightFieldShape::PYRAMID_LEAF_TILE_SIZE = 4;
+
 // Constructor
 /**
  * @param nbGridColumns Number of columns in the grid of the height field
@@ -47,7 +51,8 @@ HeightFieldShape::HeightFieldShape(int nbGridColumns, int nbGridRows, decimal mi
                  : ConcaveShape(CollisionShapeName::HEIGHTFIELD, allocator, scaling), mNbColumns(nbGridColumns), mNbRows(nbGridRows),
                    mWidth(nbGridColumns - 1), mLength(nbGridRows - 1), mMinHeight(minHeight),
                    mMaxHeight(maxHeight), mUpAxis(upAxis), mIntegerHeightScale(integerHeightScale),
-                   mHeightDataType(dataType) {
+                   mHeightDataType(dataType), mPyramidMinHeights(allocator), mPyramidMaxHeights(allocator),
+                   mPyramidLevelStartIndices(allocator) {
 
     assert(nbGridColumns >= 2);
     assert(nbGridRows >= 2);
@@ -134,63 +139,115 @@ void HeightFieldShape::computeOverlappingTriangles(const AABB& localAABB, List<V
    assert(jMin >= 0 && jMin < mNbRows);
    assert(jMax >= 0 && jMax < mNbRows);
 
+   // If the min/max height pyramid is enabled
+   if (isMinMaxHeightPyramidEnabled()) {
+
+       // Traverse the pyramid from its top tile and skip the tiles with a height range outside the AABB
+       const int topLevel = static_cast<int>(mPyramidLevelStartIndices.size()) - 1;
+       addPyramidTileTriangles(topLevel, 0, 0, iMin, iMax, jMin, jMax, aabb.getMin()[mUpAxis], aabb.getMax()[mUpAxis],
+                               triangleVertices, triangleVerticesNormals, shapeIds);
+       return;
+   }
+
    // For each sub-grid points (except the last ones one each dimension)
    for (int i = iMin; i < iMax; i++) {
        for (int j = jMin; j < jMax; j++) {
-
-           // Compute the four point of the current quad
-           const Vector3 p1 = getVertexAt(i, j);
-           const Vector3 p2 = getVertexAt(i, j + 1);
-           const Vector3 p3 = getVertexAt(i + 1, j);
-           const Vector3 p4 = getVertexAt(i + 1, j + 1);
-
-           // Generate the first triangle for the current grid rectangle
-           triangleVertices.add(p1);
-           triangleVertices.add(p2);
-           triangleVertices.add(p3);
-
-           // Compute the triangle normal
-           Vector3 triangle1Normal = (p2 - p1).cross(p3 - p1).getUnit();
-
-           // Use the triangle face normal as vertices normals (this is an aproximation. The correct
-           // solution would be to compute all the normals of the neighbor triangles and use their
-           // weighted average (with incident angle as weight) at the vertices. However, this solution
-           // seems too expensive (it requires to compute the normal of all neighbor triangles instead
-           // and compute the angle of incident edges with asin(). Maybe we could also precompute the
-           // vertices normal at the HeightFieldShape constructor but it will require extra memory to
-           // store them.
-           triangleVerticesNormals.add(triangle1Normal);
-           triangleVerticesNormals.add(triangle1Normal);
-           triangleVerticesNormals.add(triangle1Normal);
-
-           // Compute the shape ID
-           shapeIds.add(computeTriangleShapeId(i, j, 0));
-
-           // Generate the second triangle for the current grid rectangle
-           triangleVertices.add(p3);
-           triangleVertices.add(p2);
-           triangleVertices.add(p4);
-
-           // Compute the triangle normal
-           Vector3 triangle2Normal = (p2 - p3).cross(p4 - p3).getUnit();
-
-           // Use the triangle face normal as vertices normals (this is an aproximation. The correct
-           // solution would be to compute all the normals of the neighbor triangles and use their
-           // weighted average (with incident angle as weight) at the vertices. However, this solution
-           // seems too expensive (it requires to compute the normal of all neighbor triangles instead
-           // and compute the angle of incident edges with asin(). Maybe we could also precompute the
-           // vertices normal at the HeightFieldShape constructor but it will require extra memory to
-           // store them.
-           triangleVerticesNormals.add(triangle2Normal);
-           triangleVerticesNormals.add(triangle2Normal);
-           triangleVerticesNormals.add(triangle2Normal);
-
-           // Compute the shape ID
-           shapeIds.add(computeTriangleShapeId(i, j, 1));
+           addGridCellTriangles(i, j, triangleVertices, triangleVerticesNormals, shapeIds);
        }
    }
 }
 
+// Add the two triangles of a given grid cell of the height field into the lists of triangles
+void HeightFieldShape::addGridCellTriangles(int i, int j, List<Vector3>& triangleVertices, List<Vector3>& triangleVerticesNormals,
+                                            List<uint>& shapeIds) const {
+
+    // Compute the four point of the current quad
+    const Vector3 p1 = getVertexAt(i, j);
+    const Vector3 p2 = getVertexAt(i, j + 1);
+    const Vector3 p3 = getVertexAt(i + 1, j);
+    const Vector3 p4 = getVertexAt(i + 1, j + 1);
+
+    // Generate the first triangle for the current grid rectangle
+    triangleVertices.add(p1);
+    triangleVertices.add(p2);
+    triangleVertices.add(p3);
+
+    // Compute the triangle normal
+    Vector3 triangle1Normal = (p2 - p1).cross(p3 - p1).getUnit();
+
+    // Use the triangle face normal as vertices normals (this is an aproximation. The correct
+    // solution would be to compute all the normals of the neighbor triangles and use their
+    // weighted average (with incident angle as weight) at the vertices. However, this solution
+    // seems too expensive (it requires to compute the normal of all neighbor triangles instead
+    // and compute the angle of incident edges with asin(). Maybe we could also precompute the
+    // vertices normal at the HeightFieldShape constructor but it will require extra memory to
+    // store them.
+    triangleVerticesNormals.add(triangle1Normal);
+    triangleVerticesNormals.add(triangle1Normal);
+    triangleVerticesNormals.add(triangle1Normal);
+
+    // Compute the shape ID
+    shapeIds.add(computeTriangleShapeId(i, j, 0));
+
+    // Generate the second triangle for the current grid rectangle
+    triangleVertices.add(p3);
+    triangleVertices.add(p2);
+    triangleVertices.add(p4);
+
+    // Compute the triangle normal
+    Vector3 triangle2Normal = (p2 - p3).cross(p4 - p3).getUnit();
+
+    // Use the triangle face normal as vertices normals (see the comment above)
+    triangleVerticesNormals.add(triangle2Normal);
+    triangleVerticesNormals.add(triangle2Normal);
+    triangleVerticesNormals.add(triangle2Normal);
+
+    // Compute the shape ID
+    shapeIds.add(computeTriangleShapeId(i, j, 1));
+}
+
+// Add the triangles of the cells of a tile of the min/max height pyramid overlapping with an AABB
+/// The cells [iMin, iMax) x [jMin, jMax) are the grid cells overlapping with the AABB in the plane of the grid
+/// and minHeight/maxHeight are the bounds of the AABB along the up axis (in the non-scaled local-space).
+void HeightFieldShape::addPyramidTileTriangles(int level, int tileI, int tileJ, int iMin, int iMax, int jMin, int jMax,
+                                               decimal minHeight, decimal maxHeight, List<Vector3>& triangleVertices,
+                                               List<Vector3>& triangleVerticesNormals, List<uint>& shapeIds) const {
+
+    // Compute the cells of the tile that are inside the cells to test
+    const int tileSize = PYRAMID_LEAF_TILE_SIZE << level;
+    const int tileIMin = std::max(tileI * tileSize, iMin);
+    const int tileIMax = std::min((tileI + 1) * tileSize, iMax);
+    const int tileJMin = std::max(tileJ * tileSize, jMin);
+    const int tileJMax = std::min((tileJ + 1) * tileSize, jMax);
+    if (tileIMin >= tileIMax || tileJMin >= tileJMax) return;
+
+    // If the height range of the tile does not overlap with the AABB, none of its triangles can overlap with it
+    const uint tileIndex = getPyramidTileIndex(level, tileI, tileJ);
+    if (mPyramidMinHeights[tileIndex] > maxHeight || mPyramidMaxHeights[tileIndex] < minHeight) return;
+
+    // If the tile is a leaf of the pyramid
+    if (level == 0) {
+
+        for (int i = tileIMin; i < tileIMax; i++) {
+            for (int j = tileJMin; j < tileJMax; j++) {
+                addGridCellTriangles(i, j, triangleVertices, triangleVerticesNormals, shapeIds);
+            }
+        }
+
+        return;
+    }
+
+    // Test the children tiles in the next level of the pyramid
+    const int nbChildTilesI = getNbPyramidTiles(mNbColumns - 1, level - 1);
+    const int nbChildTilesJ = getNbPyramidTiles(mNbRows - 1, level - 1);
+    for (int childI = tileI * 2; childI < std::min(tileI * 2 + 2, nbChildTilesI); childI++) {
+        for (int childJ = tileJ * 2; childJ < std::min(tileJ * 2 + 2, nbChildTilesJ); childJ++) {
+            addPyramidTileTriangles(level - 1, childI, childJ, iMin, iMax, jMin, jMax, minHeight, maxHeight,
+                                    triangleVertices, triangleVerticesNormals, shapeIds);
+        }
+    }
+}
+
 // Compute the min/max grid coords corresponding to the intersection of the AABB of the height field and
 // the AABB to collide
 void HeightFieldShape::computeMinMaxGridCoordinates(int* minCoords, int* maxCoords, const AABB& aabbToCollide) const {
@@ -222,73 +279,304 @@ void HeightFieldShape::computeMinMaxGridCoordinates(int* minCoords, int* maxCoor
 }
 
 // Raycast method with feedback information
-/// Note that only the first triangle hit by the ray in the mesh will be returned, even if
-/// the ray hits many triangles.
-bool HeightFieldShape::raycast(const Ray& ray, RaycastInfo& raycastInfo, Collider* collider, MemoryAllocator& allocator) const {
-
-    // TODO : Implement raycasting without using an AABB for the ray
-    //        but using a dynamic AABB tree or octree instead
+/// The ray is clipped with the AABB of the height field and the grid cells crossed by the ray
+/// are then visited in order along the ray (2D DDA walk over the grid). The walk stops at the first
+/// cell with a hit because the triangles of the next cells can only be hit further along the ray.
+/// Note that only the first triangle hit by the ray in the height field will be returned.
+bool HeightFieldShape::raycast(const Ray& ray, RaycastInfo& raycastInfo, Collider* collider, MemoryAllocator& /*allocator*/) const {
 
     RP3D_PROFILE("HeightFieldShape::raycast()", mProfiler);
 
-    // Compute the AABB for the ray
-    const Vector3 rayEnd = ray.point1 + ray.maxFraction * (ray.point2 - ray.point1);
-    const AABB rayAABB(Vector3::min(ray.point1, rayEnd), Vector3::max(ray.point1, rayEnd));
+    // Compute the ray in the non-scaled local-space of the height field (the ray fraction of
+    // a point is the same in the scaled and non-scaled spaces)
+    const Vector3 inverseScale(decimal(1.0) / mScale.x, decimal(1.0) / mScale.y, decimal(1.0) / mScale.z);
+    const Vector3 rayPoint = ray.point1 * inverseScale;
+    const Vector3 rayDirection = (ray.point2 - ray.point1) * inverseScale;
 
-    // Compute the triangles overlapping with the ray AABB
-    List<Vector3> triangleVertices(allocator);
-    List<Vector3> triangleVerticesNormals(allocator);
-    List<uint> shapeIds(allocator);
-    computeOverlappingTriangles(rayAABB, triangleVertices, triangleVerticesNormals, shapeIds, allocator);
+    // Clip the ray with the AABB of the height field
+    decimal tMin = decimal(0.0);
+    decimal tMax = ray.maxFraction;
+    for (int i=0; i < 3; i++) {
 
-    assert(triangleVertices.size() == triangleVerticesNormals.size());
-    assert(shapeIds.size() == triangleVertices.size() / 3);
-    assert(triangleVertices.size() % 3 == 0);
-    assert(triangleVerticesNormals.size() % 3 == 0);
+        // If the ray is parallel to the slab
+        if (std::abs(rayDirection[i]) < MACHINE_EPSILON) {
 
-    bool isHit = false;
-    decimal smallestHitFraction = ray.maxFraction;
+            // If the ray origin is not inside the slab, there is no hit
+            if (rayPoint[i] < mAABB.getMin()[i] || rayPoint[i] > mAABB.getMax()[i]) return false;
+        }
+        else {
 
-    // For each overlapping triangle
-    for (uint i=0; i < shapeIds.size(); i++)
-    {
-        // Create a triangle collision shape
-        TriangleShape triangleShape(&(triangleVertices[i * 3]), &(triangleVerticesNormals[i * 3]), shapeIds[i], allocator);
-        triangleShape.setRaycastTestType(getRaycastTestType());
+            // Compute the intersection of the ray with the near and far plane of the slab
+            const decimal oneOverD = decimal(1.0) / rayDirection[i];
+            decimal t1 = (mAABB.getMin()[i] - rayPoint[i]) * oneOverD;
+            decimal t2 = (mAABB.getMax()[i] - rayPoint[i]) * oneOverD;
+            if (t1 > t2) std::swap(t1, t2);
 
-    #ifdef IS_RP3D_PROFILING_ENABLED
+            tMin = std::max(tMin, t1);
+            tMax = std::min(tMax, t2);
 
+            if (tMin > tMax) return false;
+        }
+    }
+
+    // Axes of the grid columns and rows according to the up axis
+    const int columnAxis = mUpAxis == 0 ? 1 : 0;
+    const int rowAxis = mUpAxis == 2 ? 1 : 2;
+
+    // Grid coordinates of the ray origin (the grid coordinates range is [0 ... mWidth] and [0 ... mLength])
+    const decimal columnCoordOrigin = rayPoint[columnAxis] + mWidth * decimal(0.5);
+    const decimal rowCoordOrigin = rayPoint[rowAxis] + mLength * decimal(0.5);
+    const decimal columnDirection = rayDirection[columnAxis];
+    const decimal rowDirection = rayDirection[rowAxis];
+
+    // Grid cell where the clipped ray starts
+    int i = clamp(static_cast<int>(std::floor(columnCoordOrigin + tMin * columnDirection)), 0, mNbColumns - 2);
+    int j = clamp(static_cast<int>(std::floor(rowCoordOrigin + tMin * rowDirection)), 0, mNbRows - 2);
+
+    const int nbPyramidLevels = static_cast<int>(mPyramidLevelStartIndices.size());
+
+    // Walk through the grid cells crossed by the ray
+    decimal tEnter = tMin;
+    while (true) {
+
+        // Number of cells along each side of the tile of the grid the ray is leaving
+        int tileSize = 1;
+
+        // If the min/max height pyramid is enabled, find the largest tile containing the current cell
+        // such that the ray does not cross the height range of the tile before leaving it (such a
+        // tile can be skipped because none of its triangles can be hit)
+        for (int level=0; level < nbPyramidLevels; level++) {
+
+            const int levelTileSize = PYRAMID_LEAF_TILE_SIZE << level;
+            const int tileI = i / levelTileSize;
+            const int tileJ = j / levelTileSize;
+            const decimal tExit = std::min(std::min(computeRayExitFraction(columnCoordOrigin, columnDirection, tileI * levelTileSize,
+                                                                           (tileI + 1) * levelTileSize),
+                                                    computeRayExitFraction(rowCoordOrigin, rowDirection, tileJ * levelTileSize,
+                                                                           (tileJ + 1) * levelTileSize)), tMax);
+            const decimal heightEnter = rayPoint[mUpAxis] + tEnter * rayDirection[mUpAxis];
+            const decimal heightExit = rayPoint[mUpAxis] + tExit * rayDirection[mUpAxis];
+
+            const uint tileIndex = getPyramidTileIndex(level, tileI, tileJ);
+            if (std::max(heightEnter, heightExit) >= mPyramidMinHeights[tileIndex] &&
+                std::min(heightEnter, heightExit) <= mPyramidMaxHeights[tileIndex]) {
+                break;
+            }
+
+            tileSize = levelTileSize;
+        }
+
+        // If the current cell cannot be skipped, test its two triangles
+        if (tileSize == 1) {
+
+            decimal hitFraction;
+            Vector3 hitPoint;
+            Vector3 hitNormal;
+            if (raycastGridCell(i, j, ray, hitFraction, hitPoint, hitNormal)) {
+
+                assert(hitFraction >= decimal(0.0));
+
+                raycastInfo.body = collider->getBody();
+                raycastInfo.collider = collider;
+                raycastInfo.hitFraction = hitFraction;
+                raycastInfo.worldPoint = hitPoint;
+                raycastInfo.worldNormal = hitNormal;
+                raycastInfo.meshSubpart = -1;
+                raycastInfo.triangleIndex = -1;
 
-        // Set the profiler to the triangle shape
-        triangleShape.setProfiler(mProfiler);
+                return true;
+            }
+        }
 
-    #endif
+        // Compute the cells range of the tile and the ray fractions where the ray leaves it
+        const int tileIMin = (i / tileSize) * tileSize;
+        const int tileIMax = std::min(tileIMin + tileSize, mNbColumns - 1);
+        const int tileJMin = (j / tileSize) * tileSize;
+        const int tileJMax = std::min(tileJMin + tileSize, mNbRows - 1);
+        const decimal tExitColumn = computeRayExitFraction(columnCoordOrigin, columnDirection, tileIMin, tileIMax);
+        const decimal tExitRow = computeRayExitFraction(rowCoordOrigin, rowDirection, tileJMin, tileJMax);
 
-        // Ray casting test against the collision shape
-        RaycastInfo triangleRaycastInfo;
-        bool isTriangleHit = triangleShape.raycast(ray, triangleRaycastInfo, collider, allocator);
+        // Move to the next cell crossed by the ray after the tile (if the ray does not end before it)
+        if (tExitColumn < tExitRow) {
 
-        // If the ray hit the collision shape
-        if (isTriangleHit && triangleRaycastInfo.hitFraction <= smallestHitFraction) {
+            if (tExitColumn > tMax) break;
 
-            assert(triangleRaycastInfo.hitFraction >= decimal(0.0));
+            i = columnDirection > decimal(0.0) ? tileIMax : tileIMin - 1;
+            if (i < 0 || i > mNbColumns - 2) break;
+            j = clamp(static_cast<int>(std::floor(rowCoordOrigin + tExitColumn * rowDirection)), tileJMin, tileJMax - 1);
+            tEnter = tExitColumn;
+        }
+        else {
 
-            raycastInfo.body = triangleRaycastInfo.body;
-            raycastInfo.collider = triangleRaycastInfo.collider;
-            raycastInfo.hitFraction = triangleRaycastInfo.hitFraction;
-            raycastInfo.worldPoint = triangleRaycastInfo.worldPoint;
-            raycastInfo.worldNormal = triangleRaycastInfo.worldNormal;
-            raycastInfo.meshSubpart = -1;
-            raycastInfo.triangleIndex = -1;
+            if (tExitRow > tMax) break;
 
-            smallestHitFraction = triangleRaycastInfo.hitFraction;
-            isHit = true;
+            j = rowDirection > decimal(0.0) ? tileJMax : tileJMin - 1;
+            if (j < 0 || j > mNbRows - 2) break;
+            i = clamp(static_cast<int>(std::floor(columnCoordOrigin + tExitRow * columnDirection)), tileIMin, tileIMax - 1);
+            tEnter = tExitRow;
         }
     }
 
+    return false;
+}
+
+// Return the ray fraction where a ray leaves a range of grid coordinates along one axis of the grid
+/// The ray is assumed to be inside the range [minCoord, maxCoord]. DECIMAL_LARGEST is returned if the ray is
+/// parallel to the axis.
+decimal HeightFieldShape::computeRayExitFraction(decimal originCoord, decimal direction, int minCoord, int maxCoord) {
+
+    if (std::abs(direction) < MACHINE_EPSILON) return DECIMAL_LARGEST;
+
+    return (decimal(direction > decimal(0.0) ? maxCoord : minCoord) - originCoord) / direction;
+}
+
+// Raycast against the two triangles of a given grid cell of the height field
+/// The hit information is computed in the local-space of the shape
+bool HeightFieldShape::raycastGridCell(int i, int j, const Ray& ray, decimal& outHitFraction, Vector3& outHitPoint,
+                                       Vector3& outHitNormal) const {
+
+    assert(i >= 0 && i < mNbColumns - 1);
+    assert(j >= 0 && j < mNbRows - 1);
+
+    // Compute the four points of the cell (the two triangles are the same as the
+    // ones generated by the computeOverlappingTriangles() method)
+    const Vector3 p1 = getVertexAt(i, j);
+    const Vector3 p2 = getVertexAt(i, j + 1);
+    const Vector3 p3 = getVertexAt(i + 1, j);
+    const Vector3 p4 = getVertexAt(i + 1, j + 1);
+    const Vector3 triangle1Points[3] = {p1, p2, p3};
+    const Vector3 triangle2Points[3] = {p3, p2, p4};
+
+    bool isHit = false;
+    outHitFraction = ray.maxFraction;
+
+    // Note that the hits behind the ray origin are rejected because the triangle raycast only tests the line of the ray
+    const Vector3 rayDirection = ray.point2 - ray.point1;
+
+    decimal hitFraction;
+    Vector3 hitPoint;
+    Vector3 hitNormal;
+    if (TriangleShape::raycastTriangle(ray, triangle1Points, getRaycastTestType(), hitFraction, hitPoint, hitNormal) &&
+        hitFraction <= outHitFraction && (hitPoint - ray.point1).dot(rayDirection) >= decimal(0.0)) {
+
+        outHitFraction = hitFraction;
+        outHitPoint = hitPoint;
+        outHitNormal = hitNormal;
+        isHit = true;
+    }
+    if (TriangleShape::raycastTriangle(ray, triangle2Points, getRaycastTestType(), hitFraction, hitPoint, hitNormal) &&
+        hitFraction <= outHitFraction && (hitPoint - ray.point1).dot(rayDirection) >= decimal(0.0)) {
+
+        outHitFraction = hitFraction;
+        outHitPoint = hitPoint;
+        outHitNormal = hitNormal;
+        isHit = true;
+    }
+
     return isHit;
 }
 
+// Enable/disable the min/max height pyramid used to cull the triangles of the overlap queries and raycasts
+/// The pyramid stores the minimum and maximum heights of square tiles of the grid. Each tile of the first
+/// level contains PYRAMID_LEAF_TILE_SIZE x PYRAMID_LEAF_TILE_SIZE grid cells and each level has half the
+/// number of tiles of the previous level along each side until a single tile covers the whole grid. The
+/// extra memory is about 2.7 decimal values for 16 grid cells. The pyramid is computed from the current
+/// height values and it is computed again by notifyDataChanged().
+/**
+ * @param isEnabled True if the min/max height pyramid must be used
+ */
+void HeightFieldShape::enableMinMaxHeightPyramid(bool isEnabled) {
+
+    if (isEnabled) {
+        computeMinMaxHeightPyramid();
+    }
+    else {
+        mPyramidMinHeights.clear(true);
+        mPyramidMaxHeights.clear(true);
+        mPyramidLevelStartIndices.clear(true);
+    }
+
+    // The triangles reported by the overlap queries might change
+    ConcaveShape::notifyDataChanged();
+}
+
+// Notify the shape that its height values have been modified
+/// The min/max height pyramid (if enabled) is computed again from the new height values.
+void HeightFieldShape::notifyDataChanged() {
+
+    if (isMinMaxHeightPyramidEnabled()) {
+        computeMinMaxHeightPyramid();
+    }
+
+    ConcaveShape::notifyDataChanged();
+}
+
+// Compute the min/max height pyramid from the current height values
+void HeightFieldShape::computeMinMaxHeightPyramid() {
+
+    mPyramidMinHeights.clear();
+    mPyramidMaxHeights.clear();
+    mPyramidLevelStartIndices.clear();
+
+    const int nbCellColumns = mNbColumns - 1;
+    const int nbCellRows = mNbRows - 1;
+
+    // Height values origin
+    const decimal heightOrigin = -(mMaxHeight - mMinHeight) * decimal(0.5) - mMinHeight;
+
+    // Compute the height range of the tiles of the first level from the height values
+    mPyramidLevelStartIndices.add(0);
+    const int nbLeafTilesI = getNbPyramidTiles(nbCellColumns, 0);
+    const int nbLeafTilesJ = getNbPyramidTiles(nbCellRows, 0);
+    for (int tileJ=0; tileJ < nbLeafTilesJ; tileJ++) {
+        for (int tileI=0; tileI < nbLeafTilesI; tileI++) {
+
+            decimal minHeight = DECIMAL_LARGEST;
+            decimal maxHeight = DECIMAL_SMALLEST;
+            const int iMax = std::min((tileI + 1) * PYRAMID_LEAF_TILE_SIZE, nbCellColumns);
+            const int jMax = std::min((tileJ + 1) * PYRAMID_LEAF_TILE_SIZE, nbCellRows);
+            for (int j = tileJ * PYRAMID_LEAF_TILE_SIZE; j <= jMax; j++) {
+                for (int i = tileI * PYRAMID_LEAF_TILE_SIZE; i <= iMax; i++) {
+                    const decimal height = heightOrigin + getHeightAt(i, j);
+                    minHeight = std::min(minHeight, height);
+                    maxHeight = std::max(maxHeight, height);
+                }
+            }
+
+            mPyramidMinHeights.add(minHeight);
+            mPyramidMaxHeights.add(maxHeight);
+        }
+    }
+
+    // Compute the height range of the tiles of the next levels from the tiles of the previous level
+    int level = 0;
+    while (getNbPyramidTiles(nbCellColumns, level) > 1 || getNbPyramidTiles(nbCellRows, level) > 1) {
+
+        const int nbChildTilesI = getNbPyramidTiles(nbCellColumns, level);
+        const int nbChildTilesJ = getNbPyramidTiles(nbCellRows, level);
+        level++;
+        mPyramidLevelStartIndices.add(mPyramidMinHeights.size());
+
+        for (int tileJ=0; tileJ < getNbPyramidTiles(nbCellRows, level); tileJ++) {
+            for (int tileI=0; tileI < getNbPyramidTiles(nbCellColumns, level); tileI++) {
+
+                decimal minHeight = DECIMAL_LARGEST;
+                decimal maxHeight = DECIMAL_SMALLEST;
+                for (int childJ = tileJ * 2; childJ < std::min(tileJ * 2 + 2, nbChildTilesJ); childJ++) {
+                    for (int childI = tileI * 2; childI < std::min(tileI * 2 + 2, nbChildTilesI); childI++) {
+                        const uint childIndex = getPyramidTileIndex(level - 1, childI, childJ);
+                        minHeight = std::min(minHeight, mPyramidMinHeights[childIndex]);
+                        maxHeight = std::max(maxHeight, mPyramidMaxHeights[childIndex]);
+                    }
+                }
+
+                mPyramidMinHeights.add(minHeight);
+                mPyramidMaxHeights.add(maxHeight);
+            }
+        }
+    }
+}
+
 // Return the vertex (local-coordinates) of the height field at a given (x,y) position
 Vector3 HeightFieldShape::getVertexAt(int x, int y) const {
 
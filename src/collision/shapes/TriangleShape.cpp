@@ -34,6 +34,11 @@
 
 using namespace reactphysics3d;
 
+// Static constants definitions
+DefaultAllocator TriangleShape::mFacesAllocator;
+const HalfEdgeStructure::Face TriangleShape::mFaces[2] = {createFace(0, 1, 2, 0), createFace(0, 2, 1, 1)};
+const HalfEdgeStructure::Edge TriangleShape::mEdges[6] = {{0, 1, 0, 2}, {1, 0, 1, 5}, {1, 3, 0, 4},
+                                                          {2, 2, 1, 1}, {2, 5, 0, 0}, {0, 4, 1, 3}};
 
 // Constructor
 /**
@@ -47,7 +52,7 @@ using namespace reactphysics3d;
  */
 TriangleShape::TriangleShape(const Vector3* vertices, const Vector3* verticesNormals, uint shapeId,
                              MemoryAllocator& allocator)
-    : ConvexPolyhedronShape(CollisionShapeName::TRIANGLE, allocator), mFaces{HalfEdgeStructure::Face(allocator), HalfEdgeStructure::Face(allocator)} {
+    : ConvexPolyhedronShape(CollisionShapeName::TRIANGLE, allocator) {
 
     mPoints[0] = vertices[0];
     mPoints[1] = vertices[1];
@@ -61,67 +66,24 @@ TriangleShape::TriangleShape(const Vector3* vertices, const Vector3* verticesNor
     mVerticesNormals[1] = verticesNormals[1];
     mVerticesNormals[2] = verticesNormals[2];
 
-    // Faces
-    mFaces[0].faceVertices.reserve(3);
-    mFaces[0].faceVertices.add(0);
-    mFaces[0].faceVertices.add(1);
-    mFaces[0].faceVertices.add(2);
-    mFaces[0].edgeIndex = 0;
-
-    mFaces[1].faceVertices.reserve(3);
-    mFaces[1].faceVertices.add(0);
-    mFaces[1].faceVertices.add(2);
-    mFaces[1].faceVertices.add(1);
-    mFaces[1].edgeIndex = 1;
-
-    // Edges
-    for (uint i=0; i<6; i++) {
-        switch(i) {
-            case 0:
-                mEdges[0].vertexIndex = 0;
-                mEdges[0].twinEdgeIndex = 1;
-                mEdges[0].faceIndex = 0;
-                mEdges[0].nextEdgeIndex = 2;
-                break;
-            case 1:
-                mEdges[1].vertexIndex = 1;
-                mEdges[1].twinEdgeIndex = 0;
-                mEdges[1].faceIndex = 1;
-                mEdges[1].nextEdgeIndex = 5;
-                break;
-            case 2:
-                mEdges[2].vertexIndex = 1;
-                mEdges[2].twinEdgeIndex = 3;
-                mEdges[2].faceIndex = 0;
-                mEdges[2].nextEdgeIndex = 4;
-                break;
-            case 3:
-                mEdges[3].vertexIndex = 2;
-                mEdges[3].twinEdgeIndex = 2;
-                mEdges[3].faceIndex = 1;
-                mEdges[3].nextEdgeIndex = 1;
-                break;
-            case 4:
-                mEdges[4].vertexIndex = 2;
-                mEdges[4].twinEdgeIndex = 5;
-                mEdges[4].faceIndex = 0;
-                mEdges[4].nextEdgeIndex = 0;
-                break;
-            case 5:
-                mEdges[5].vertexIndex = 0;
-                mEdges[5].twinEdgeIndex = 4;
-                mEdges[5].faceIndex = 1;
-                mEdges[5].nextEdgeIndex = 3;
-                break;
-        }
-    }
-
-
     mRaycastTestType = TriangleRaycastSide::FRONT;
 
     mId = shapeId;
 }
 
+// Create a face of the half-edge structure shared by all the triangles
+HalfEdgeStructure::Face TriangleShape::createFace(uint vertex1, uint vertex2, uint vertex3, uint edgeIndex) {
+
+    HalfEdgeStructure::Face face(mFacesAllocator);
+    face.faceVertices.reserve(3);
+    face.faceVertices.add(vertex1);
+    face.faceVertices.add(vertex2);
+    face.faceVertices.add(vertex3);
+    face.edgeIndex = edgeIndex;
+
+    return face;
+}
+
 // This method compute the smooth mesh contact with a triangle in case one of the two collision
 // shapes is a triangle. The idea in this case is to use a smooth vertex normal of the triangle mesh
 // at the contact point instead of the triangle normal to avoid the internal edge collision issue.
@@ -244,47 +206,66 @@ void TriangleShape::computeAABB(AABB& aabb, const Transform& transform) const {
 }
 
 // Raycast method with feedback information
-/// This method use the line vs triangle raycasting technique described in
-/// Real-time Collision Detection by Christer Ericson.
 bool TriangleShape::raycast(const Ray& ray, RaycastInfo& raycastInfo, Collider* collider, MemoryAllocator& allocator) const {
 
     RP3D_PROFILE("TriangleShape::raycast()", mProfiler);
 
+    decimal hitFraction;
+    Vector3 localHitPoint;
+    Vector3 localHitNormal;
+    if (!raycastTriangle(ray, mPoints, mRaycastTestType, hitFraction, localHitPoint, localHitNormal)) return false;
+
+    raycastInfo.body = collider->getBody();
+    raycastInfo.collider = collider;
+    raycastInfo.worldPoint = localHitPoint;
+    raycastInfo.hitFraction = hitFraction;
+    raycastInfo.worldNormal = localHitNormal;
+
+    return true;
+}
+
+// Compute the intersection between a ray and a triangle
+/// This method use the line vs triangle raycasting technique described in
+/// Real-time Collision Detection by Christer Ericson. It does not need a triangle
+/// shape so that it can be used directly with the vertices of a triangle mesh.
+bool TriangleShape::raycastTriangle(const Ray& ray, const Vector3* points, TriangleRaycastSide raycastTestType,
+                                    decimal& outHitFraction, Vector3& outHitPoint, Vector3& outHitNormal) {
+
     const Vector3 pq = ray.point2 - ray.point1;
-    const Vector3 pa = mPoints[0] - ray.point1;
-    const Vector3 pb = mPoints[1] - ray.point1;
-    const Vector3 pc = mPoints[2] - ray.point1;
+    const Vector3 pa = points[0] - ray.point1;
+    const Vector3 pb = points[1] - ray.point1;
+    const Vector3 pc = points[2] - ray.point1;
 
     // Test if the line PQ is inside the eges BC, CA and AB. We use the triple
     // product for this test.
     const Vector3 m = pq.cross(pc);
     decimal u = pb.dot(m);
-    if (mRaycastTestType == TriangleRaycastSide::FRONT) {
+    if (raycastTestType == TriangleRaycastSide::FRONT) {
         if (u < decimal(0.0)) return false;
     }
-    else if (mRaycastTestType == TriangleRaycastSide::BACK) {
+    else if (raycastTestType == TriangleRaycastSide::BACK) {
         if (u > decimal(0.0)) return false;
     }
 
     decimal v = -pa.dot(m);
-    if (mRaycastTestType == TriangleRaycastSide::FRONT) {
+    if (raycastTestType == TriangleRaycastSide::FRONT) {
         if (v < decimal(0.0)) return false;
     }
-    else if (mRaycastTestType == TriangleRaycastSide::BACK) {
+    else if (raycastTestType == TriangleRaycastSide::BACK) {
         if (v > decimal(0.0)) return false;
     }
-    else if (mRaycastTestType == TriangleRaycastSide::FRONT_AND_BACK) {
+    else if (raycastTestType == TriangleRaycastSide::FRONT_AND_BACK) {
         if (!sameSign(u, v)) return false;
     }
 
     decimal w = pa.dot(pq.cross(pb));
-    if (mRaycastTestType == TriangleRaycastSide::FRONT) {
+    if (raycastTestType == TriangleRaycastSide::FRONT) {
         if (w < decimal(0.0)) return false;
     }
-    else if (mRaycastTestType == TriangleRaycastSide::BACK) {
+    else if (raycastTestType == TriangleRaycastSide::BACK) {
         if (w > decimal(0.0)) return false;
     }
-    else if (mRaycastTestType == TriangleRaycastSide::FRONT_AND_BACK) {
+    else if (raycastTestType == TriangleRaycastSide::FRONT_AND_BACK) {
         if (!sameSign(u, w)) return false;
     }
 
@@ -299,19 +280,17 @@ bool TriangleShape::raycast(const Ray& ray, RaycastInfo& raycastInfo, Collider*
     w *= denom;
 
     // Compute the local hit point using the barycentric coordinates
-    const Vector3 localHitPoint = u * mPoints[0] + v * mPoints[1] + w * mPoints[2];
+    const Vector3 localHitPoint = u * points[0] + v * points[1] + w * points[2];
     const decimal hitFraction = (localHitPoint - ray.point1).length() / pq.length();
 
     if (hitFraction < decimal(0.0) || hitFraction > ray.maxFraction) return false;
 
-    Vector3 localHitNormal = (mPoints[1] - mPoints[0]).cross(mPoints[2] - mPoints[0]);
+    Vector3 localHitNormal = (points[1] - points[0]).cross(points[2] - points[0]);
     if (localHitNormal.dot(pq) > decimal(0.0)) localHitNormal = -localHitNormal;
 
-    raycastInfo.body = collider->getBody();
-    raycastInfo.collider = collider;
-    raycastInfo.worldPoint = localHitPoint;
-    raycastInfo.hitFraction = hitFraction;
-    raycastInfo.worldNormal = localHitNormal;
+    outHitFraction = hitFraction;
+    outHitPoint = localHitPoint;
+    outHitNormal = localHitNormal;
 
     return true;
 }
@@ -37,7 +37,7 @@ using namespace reactphysics3d;
 ColliderComponents::ColliderComponents(MemoryAllocator& allocator)
                     :Components(allocator, sizeof(Entity) + sizeof(Entity) + sizeof(Collider*) + sizeof(int32) +
                 sizeof(Transform) + sizeof(CollisionShape*) + sizeof(unsigned short) +
-                sizeof(unsigned short) + sizeof(Transform) + sizeof(List<uint64>) + sizeof(bool) +
+                sizeof(unsigned short) + sizeof(Transform) + sizeof(List<uint64>) + sizeof(decimal) + sizeof(bool) +
                 sizeof(bool)) {
 
     // Allocate memory for the components data
@@ -67,7 +67,8 @@ void ColliderComponents::allocate(uint32 nbComponentsToAllocate) {
     unsigned short* newCollideWithMaskBits = reinterpret_cast<unsigned short*>(newCollisionCategoryBits + nbComponentsToAllocate);
     Transform* newLocalToWorldTransforms = reinterpret_cast<Transform*>(newCollideWithMaskBits + nbComponentsToAllocate);
     List<uint64>* newOverlappingPairs = reinterpret_cast<List<uint64>*>(newLocalToWorldTransforms + nbComponentsToAllocate);
-    bool* hasCollisionShapeChangedSize = reinterpret_cast<bool*>(newOverlappingPairs + nbComponentsToAllocate);
+    decimal* newFatAABBInflatePercentages = reinterpret_cast<decimal*>(newOverlappingPairs + nbComponentsToAllocate);
+    bool* hasCollisionShapeChangedSize = reinterpret_cast<bool*>(newFatAABBInflatePercentages + nbComponentsToAllocate);
     bool* isTrigger = reinterpret_cast<bool*>(hasCollisionShapeChangedSize + nbComponentsToAllocate);
 
     // If there was already components before
@@ -84,6 +85,7 @@ void ColliderComponents::allocate(uint32 nbComponentsToAllocate) {
         memcpy(newCollideWithMaskBits, mCollideWithMaskBits, mNbComponents * sizeof(unsigned short));
         memcpy(newLocalToWorldTransforms, mLocalToWorldTransforms, mNbComponents * sizeof(Transform));
         memcpy(newOverlappingPairs, mOverlappingPairs, mNbComponents * sizeof(List<uint64>));
+        memcpy(newFatAABBInflatePercentages, mFatAABBInflatePercentages, mNbComponents * sizeof(decimal));
         memcpy(hasCollisionShapeChangedSize, mHasCollisionShapeChangedSize, mNbComponents * sizeof(bool));
         memcpy(isTrigger, mIsTrigger, mNbComponents * sizeof(bool));
 
@@ -103,6 +105,7 @@ void ColliderComponents::allocate(uint32 nbComponentsToAllocate) {
     mCollideWithMaskBits = newCollideWithMaskBits;
     mLocalToWorldTransforms = newLocalToWorldTransforms;
     mOverlappingPairs = newOverlappingPairs;
+    mFatAABBInflatePercentages = newFatAABBInflatePercentages;
     mHasCollisionShapeChangedSize = hasCollisionShapeChangedSize;
     mIsTrigger = isTrigger;
 
@@ -126,6 +129,7 @@ void ColliderComponents::addComponent(Entity colliderEntity, bool isSleeping, co
     new (mCollideWithMaskBits + index) unsigned short(component.collideWithMaskBits);
     new (mLocalToWorldTransforms + index) Transform(component.localToWorldTransform);
     new (mOverlappingPairs + index) List<uint64>(mMemoryAllocator);
+    mFatAABBInflatePercentages[index] = decimal(-1.0);
     mHasCollisionShapeChangedSize[index] = false;
     mIsTrigger[index] = false;
 
@@ -154,6 +158,7 @@ void ColliderComponents::moveComponentToIndex(uint32 srcIndex, uint32 destIndex)
     new (mCollideWithMaskBits + destIndex) unsigned short(mCollideWithMaskBits[srcIndex]);
     new (mLocalToWorldTransforms + destIndex) Transform(mLocalToWorldTransforms[srcIndex]);
     new (mOverlappingPairs + destIndex) List<uint64>(mOverlappingPairs[srcIndex]);
+    mFatAABBInflatePercentages[destIndex] = mFatAABBInflatePercentages[srcIndex];
     mHasCollisionShapeChangedSize[destIndex] = mHasCollisionShapeChangedSize[srcIndex];
     mIsTrigger[destIndex] = mIsTrigger[srcIndex];
 
@@ -182,6 +187,7 @@ void ColliderComponents::swapComponents(uint32 index1, uint32 index2) {
     unsigned short collideWithMaskBits1 = mCollideWithMaskBits[index1];
     Transform localToWorldTransform1 = mLocalToWorldTransforms[index1];
     List<uint64> overlappingPairs = mOverlappingPairs[index1];
+    decimal fatAABBInflatePercentage = mFatAABBInflatePercentages[index1];
     bool hasCollisionShapeChangedSize = mHasCollisionShapeChangedSize[index1];
     bool isTrigger = mIsTrigger[index1];
 
@@ -201,6 +207,7 @@ void ColliderComponents::swapComponents(uint32 index1, uint32 index2) {
     new (mCollideWithMaskBits + index2) unsigned short(collideWithMaskBits1);
     new (mLocalToWorldTransforms + index2) Transform(localToWorldTransform1);
     new (mOverlappingPairs + index2) List<uint64>(overlappingPairs);
+    mFatAABBInflatePercentages[index2] = fatAABBInflatePercentage;
     mHasCollisionShapeChangedSize[index2] = hasCollisionShapeChangedSize;
     mIsTrigger[index2] = isTrigger;
 
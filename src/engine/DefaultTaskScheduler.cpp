@@ -0,0 +1,234 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2020 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include <reactphysics3d/engine/DefaultTaskScheduler.h>
+#include <new>
+#include <cstdint>
+
+using namespace reactphysics3d;
+
+namespace {
+
+// True if the current thread is executing a chunk of a task. In this case, a nested
+// call to parallelFor() is executed directly on the current thread
+thread_local bool isExecutingTask = false;
+}
+
+// Constructor
+/**
+ * @param allocator Memory allocator used to allocate the queues and the threads
+ * @param nbThreads Number of threads (including the calling thread). If zero, the number of
+ *                  hardware threads is used
+ */
+DefaultTaskScheduler::DefaultTaskScheduler(MemoryAllocator& allocator, uint32 nbThreads)
+                     : mAllocator(allocator), mNbThreads(nbThreads), mAlignedMemory(nullptr), mAlignedMemorySize(0),
+                       mSharedState(nullptr), mQueues(nullptr), mThreads(nullptr), mRangeIndex(0), mIsStopping(false),
+                       mTask(nullptr), mNbItems(0), mGrainSize(1) {
+
+    if (mNbThreads == 0) {
+        mNbThreads = static_cast<uint32>(std::thread::hardware_concurrency());
+    }
+    if (mNbThreads == 0) {
+        mNbThreads = 1;
+    }
+
+    // Create the shared state and the queues in memory aligned on a cache line (the memory
+    // allocator does not align its memory). A mutex or an atomic that is not aligned cannot be
+    // used by several threads and the queues must not share a cache line with each other
+    mAlignedMemorySize = sizeof(SharedState) + mNbThreads * sizeof(WorkerQueue) + CACHE_LINE_SIZE - 1;
+    mAlignedMemory = mAllocator.allocate(mAlignedMemorySize);
+    const uintptr_t alignedAddress = (reinterpret_cast<uintptr_t>(mAlignedMemory) + CACHE_LINE_SIZE - 1) &
+                                     ~static_cast<uintptr_t>(CACHE_LINE_SIZE - 1);
+    mSharedState = new (reinterpret_cast<void*>(alignedAddress)) SharedState();
+    mQueues = reinterpret_cast<WorkerQueue*>(alignedAddress + sizeof(SharedState));
+    for (uint32 i=0; i < mNbThreads; i++) {
+        new (mQueues + i) WorkerQueue();
+    }
+
+    // Create the worker threads (the calling thread is the thread with index 0)
+    if (mNbThreads > 1) {
+        mThreads = static_cast<std::thread*>(mAllocator.allocate((mNbThreads - 1) * sizeof(std::thread)));
+        for (uint32 i=1; i < mNbThreads; i++) {
+            new (mThreads + i - 1) std::thread(&DefaultTaskScheduler::runWorkerThread, this, i);
+        }
+    }
+}
+
+// Destructor
+DefaultTaskScheduler::~DefaultTaskScheduler() {
+
+    // Stop the worker threads
+    {
+        std::lock_guard<std::mutex> lock(mSharedState->wakeMutex);
+        mIsStopping = true;
+    }
+    mSharedState->wakeCondition.notify_all();
+
+    if (mThreads != nullptr) {
+        for (uint32 i=0; i < mNbThreads - 1; i++) {
+            mThreads[i].join();
+            mThreads[i].~thread();
+        }
+        mAllocator.release(mThreads, (mNbThreads - 1) * sizeof(std::thread));
+    }
+
+    for (uint32 i=0; i < mNbThreads; i++) {
+        mQueues[i].~WorkerQueue();
+    }
+    mSharedState->~SharedState();
+    mAllocator.release(mAlignedMemory, mAlignedMemorySize);
+}
+
+// Execute a task over the items [0, nbItems) split into chunks of (at most) grainSize items
+/**
+ * @param nbItems Number of items
+ * @param grainSize Maximum number of items per chunk
+ * @param task Task to execute on each chunk
+ */
+void DefaultTaskScheduler::parallelFor(uint32 nbItems, uint32 grainSize, const RangeTask& task) {
+
+    if (nbItems == 0) return;
+
+    const uint32 grain = grainSize > 0 ? grainSize : 1;
+    const uint32 nbChunks = (nbItems + grain - 1) / grain;
+
+    // If there is nothing to split or if we are already inside a task, we execute
+    // the whole range on the calling thread
+    if (mNbThreads == 1 || nbChunks == 1 || isExecutingTask) {
+        task(0, nbItems);
+        return;
+    }
+
+    // Only one range of items can be processed at a time
+    std::lock_guard<std::mutex> submitLock(mSharedState->submitMutex);
+
+    mTask = &task;
+    mNbItems = nbItems;
+    mGrainSize = grain;
+    mSharedState->nbRemainingChunks.store(nbChunks);
+
+    // Distribute the chunks evenly among the queues of the threads
+    for (uint32 i=0; i < mNbThreads; i++) {
+
+        std::lock_guard<std::mutex> queueLock(mQueues[i].mutex);
+        mQueues[i].start = static_cast<uint32>((uint64(nbChunks) * i) / mNbThreads);
+        mQueues[i].end = static_cast<uint32>((uint64(nbChunks) * (i + 1)) / mNbThreads);
+    }
+
+    // Wake up the worker threads
+    {
+        std::lock_guard<std::mutex> lock(mSharedState->wakeMutex);
+        mRangeIndex++;
+    }
+    mSharedState->wakeCondition.notify_all();
+
+    // The calling thread also executes chunks
+    executeChunks(0);
+
+    // Wait until all the chunks have been executed
+    std::unique_lock<std::mutex> doneLock(mSharedState->doneMutex);
+    mSharedState->doneCondition.wait(doneLock, [this]() { return mSharedState->nbRemainingChunks.load() == 0; });
+
+    mTask = nullptr;
+}
+
+// Main loop of a worker thread
+void DefaultTaskScheduler::runWorkerThread(uint32 threadIndex) {
+
+    uint64 lastRangeIndex = 0;
+
+    while (true) {
+
+        // Wait for a new range of items
+        {
+            std::unique_lock<std::mutex> lock(mSharedState->wakeMutex);
+            mSharedState->wakeCondition.wait(lock, [this, lastRangeIndex]() { return mIsStopping || mRangeIndex != lastRangeIndex; });
+
+            if (mIsStopping) return;
+
+            lastRangeIndex = mRangeIndex;
+        }
+
+        executeChunks(threadIndex);
+    }
+}
+
+// Execute the chunks of the queue of a thread and steal chunks from the other threads
+void DefaultTaskScheduler::executeChunks(uint32 threadIndex) {
+
+    isExecutingTask = true;
+
+    uint32 chunkIndex;
+    while (popChunk(threadIndex, chunkIndex)) {
+
+        const uint32 startIndex = chunkIndex * mGrainSize;
+        const uint32 endIndex = (mNbItems - startIndex) > mGrainSize ? startIndex + mGrainSize : mNbItems;
+
+        (*mTask)(startIndex, endIndex);
+
+        // If this was the last chunk of the range, we wake up the submitting thread
+        if (mSharedState->nbRemainingChunks.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(mSharedState->doneMutex);
+            mSharedState->doneCondition.notify_all();
+        }
+    }
+
+    isExecutingTask = false;
+}
+
+// Pop the next chunk to execute for a given thread. Return false if there are no more chunks
+/**
+ * @param threadIndex Index of the thread
+ * @param[out] chunkIndex Index of the chunk to execute
+ * @return True if a chunk has been found
+ */
+bool DefaultTaskScheduler::popChunk(uint32 threadIndex, uint32& chunkIndex) {
+
+    // Take the first chunk of our own queue
+    {
+        WorkerQueue& queue = mQueues[threadIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.start < queue.end) {
+            chunkIndex = queue.start;
+            queue.start++;
+            return true;
+        }
+    }
+
+    // Steal the last chunk of the queue of another thread
+    for (uint32 i=1; i < mNbThreads; i++) {
+
+        WorkerQueue& queue = mQueues[(threadIndex + i) % mNbThreads];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.start < queue.end) {
+            queue.end--;
+            chunkIndex = queue.end;
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -39,6 +39,7 @@ OverlappingPairs::OverlappingPairs(MemoryAllocator& persistentMemoryAllocator, M
                 : mPersistentAllocator(persistentMemoryAllocator), mTempMemoryAllocator(temporaryMemoryAllocator),
                   mNbPairs(0), mConcavePairsStartIndex(0), mPairDataSize(sizeof(uint64) + sizeof(int32) + sizeof(int32) + sizeof(Entity) +
                                                                          sizeof(Entity) + sizeof(Map<uint64, LastFrameCollisionInfo*>) +
+                                                                         sizeof(OverlappingTrianglesCache*) +
                                                                          sizeof(bool) + sizeof(bool) + sizeof(NarrowPhaseAlgorithmType) +
                                                                          sizeof(bool) + sizeof(bool) + sizeof(bool)),
                   mNbAllocatedPairs(0), mBuffer(nullptr),
@@ -61,12 +62,7 @@ OverlappingPairs::~OverlappingPairs() {
 
             // Remove all the remaining last frame collision info
             for (auto it = mLastFrameCollisionInfos[i].begin(); it != mLastFrameCollisionInfos[i].end(); ++it) {
-
-                // Call the constructor
-                it->second->~LastFrameCollisionInfo();
-
-                // Release memory
-                mPersistentAllocator.release(it->second, sizeof(LastFrameCollisionInfo));
+                destroyLastFrameCollisionInfo(it->second);
             }
 
             // Remove the involved overlapping pair to the two colliders
@@ -75,6 +71,8 @@ OverlappingPairs::~OverlappingPairs() {
             mColliderComponents.getOverlappingPairs(mColliders1[i]).remove(mPairIds[i]);
             mColliderComponents.getOverlappingPairs(mColliders2[i]).remove(mPairIds[i]);
 
+            destroyOverlappingTrianglesCache(i);
+
             destroyPair(i);
         }
 
@@ -136,12 +134,7 @@ void OverlappingPairs::removePair(uint64 pairId) {
 
     // Remove all the remaining last frame collision info
     for (auto it = mLastFrameCollisionInfos[index].begin(); it != mLastFrameCollisionInfos[index].end(); ++it) {
-
-        // Call the constructor
-        it->second->~LastFrameCollisionInfo();
-
-        // Release memory
-        mPersistentAllocator.release(it->second, sizeof(LastFrameCollisionInfo));
+        destroyLastFrameCollisionInfo(it->second);
     }
 
     // Remove the involved overlapping pair to the two colliders
@@ -150,6 +143,9 @@ void OverlappingPairs::removePair(uint64 pairId) {
     mColliderComponents.getOverlappingPairs(mColliders1[index]).remove(pairId);
     mColliderComponents.getOverlappingPairs(mColliders2[index]).remove(pairId);
 
+    // Remove the cache of overlapping triangles
+    destroyOverlappingTrianglesCache(index);
+
     // Destroy the pair
     destroyPair(index);
 
@@ -207,7 +203,8 @@ void OverlappingPairs::allocate(uint64 nbPairsToAllocate) {
     Entity* newColliders1 = reinterpret_cast<Entity*>(newPairBroadPhaseId2 + nbPairsToAllocate);
     Entity* newColliders2 = reinterpret_cast<Entity*>(newColliders1 + nbPairsToAllocate);
     Map<uint64, LastFrameCollisionInfo*>* newLastFrameCollisionInfos = reinterpret_cast<Map<uint64, LastFrameCollisionInfo*>*>(newColliders2 + nbPairsToAllocate);
-    bool* newNeedToTestOverlap = reinterpret_cast<bool*>(newLastFrameCollisionInfos + nbPairsToAllocate);
+    OverlappingTrianglesCache** newOverlappingTrianglesCaches = reinterpret_cast<OverlappingTrianglesCache**>(newLastFrameCollisionInfos + nbPairsToAllocate);
+    bool* newNeedToTestOverlap = reinterpret_cast<bool*>(newOverlappingTrianglesCaches + nbPairsToAllocate);
     bool* newIsActive = reinterpret_cast<bool*>(newNeedToTestOverlap + nbPairsToAllocate);
     NarrowPhaseAlgorithmType* newNarrowPhaseAlgorithmType = reinterpret_cast<NarrowPhaseAlgorithmType*>(newIsActive + nbPairsToAllocate);
     bool* newIsShape1Convex = reinterpret_cast<bool*>(newNarrowPhaseAlgorithmType + nbPairsToAllocate);
@@ -224,6 +221,7 @@ void OverlappingPairs::allocate(uint64 nbPairsToAllocate) {
         memcpy(newColliders1, mColliders1, mNbPairs * sizeof(Entity));
         memcpy(newColliders2, mColliders2, mNbPairs * sizeof(Entity));
         memcpy(newLastFrameCollisionInfos, mLastFrameCollisionInfos, mNbPairs * sizeof(Map<uint64, LastFrameCollisionInfo*>));
+        memcpy(newOverlappingTrianglesCaches, mOverlappingTrianglesCaches, mNbPairs * sizeof(OverlappingTrianglesCache*));
         memcpy(newNeedToTestOverlap, mNeedToTestOverlap, mNbPairs * sizeof(bool));
         memcpy(newIsActive, mIsActive, mNbPairs * sizeof(bool));
         memcpy(newNarrowPhaseAlgorithmType, mNarrowPhaseAlgorithmType, mNbPairs * sizeof(NarrowPhaseAlgorithmType));
@@ -242,6 +240,7 @@ void OverlappingPairs::allocate(uint64 nbPairsToAllocate) {
     mColliders1 = newColliders1;
     mColliders2 = newColliders2;
     mLastFrameCollisionInfos = newLastFrameCollisionInfos;
+    mOverlappingTrianglesCaches = newOverlappingTrianglesCaches;
     mNeedToTestOverlap = newNeedToTestOverlap;
     mIsActive = newIsActive;
     mNarrowPhaseAlgorithmType = newNarrowPhaseAlgorithmType;
@@ -285,7 +284,7 @@ uint64 OverlappingPairs::addPair(Collider* shape1, Collider* shape2) {
     NarrowPhaseAlgorithmType algorithmType;
     if (isConvexVsConvex) {
 
-        algorithmType = mCollisionDispatch.selectNarrowPhaseAlgorithm(collisionShape1->getType(), collisionShape2->getType());
+        algorithmType = mCollisionDispatch.selectNarrowPhaseAlgorithm(collisionShape1, collisionShape2);
     }
     else {
 
@@ -300,6 +299,7 @@ uint64 OverlappingPairs::addPair(Collider* shape1, Collider* shape2) {
     new (mColliders1 + index) Entity(shape1->getEntity());
     new (mColliders2 + index) Entity(shape2->getEntity());
     new (mLastFrameCollisionInfos + index) Map<uint64, LastFrameCollisionInfo*>(mPersistentAllocator);
+    new (mOverlappingTrianglesCaches + index) OverlappingTrianglesCache*(nullptr);
     new (mNeedToTestOverlap + index) bool(false);
     new (mIsActive + index) bool(true);
     new (mNarrowPhaseAlgorithmType + index) NarrowPhaseAlgorithmType(algorithmType);
@@ -339,6 +339,7 @@ void OverlappingPairs::movePairToIndex(uint64 srcIndex, uint64 destIndex) {
     new (mColliders1 + destIndex) Entity(mColliders1[srcIndex]);
     new (mColliders2 + destIndex) Entity(mColliders2[srcIndex]);
     new (mLastFrameCollisionInfos + destIndex) Map<uint64, LastFrameCollisionInfo*>(mLastFrameCollisionInfos[srcIndex]);
+    mOverlappingTrianglesCaches[destIndex] = mOverlappingTrianglesCaches[srcIndex];
     mNeedToTestOverlap[destIndex] = mNeedToTestOverlap[srcIndex];
     mIsActive[destIndex] = mIsActive[srcIndex];
     new (mNarrowPhaseAlgorithmType + destIndex) NarrowPhaseAlgorithmType(mNarrowPhaseAlgorithmType[srcIndex]);
@@ -367,6 +368,7 @@ void OverlappingPairs::swapPairs(uint64 index1, uint64 index2) {
     Entity collider1 = mColliders1[index1];
     Entity collider2 = mColliders2[index1];
     Map<uint64, LastFrameCollisionInfo*> lastFrameCollisionInfo(mLastFrameCollisionInfos[index1]);
+    OverlappingTrianglesCache* overlappingTrianglesCache = mOverlappingTrianglesCaches[index1];
     bool needTestOverlap = mNeedToTestOverlap[index1];
     bool isActive = mIsActive[index1];
     NarrowPhaseAlgorithmType narrowPhaseAlgorithmType = mNarrowPhaseAlgorithmType[index1];
@@ -386,6 +388,7 @@ void OverlappingPairs::swapPairs(uint64 index1, uint64 index2) {
     new (mColliders1 + index2) Entity(collider1);
     new (mColliders2 + index2) Entity(collider2);
     new (mLastFrameCollisionInfos + index2) Map<uint64, LastFrameCollisionInfo*>(lastFrameCollisionInfo);
+    mOverlappingTrianglesCaches[index2] = overlappingTrianglesCache;
     mNeedToTestOverlap[index2] = needTestOverlap;
     mIsActive[index2] = isActive;
     new (mNarrowPhaseAlgorithmType + index2) NarrowPhaseAlgorithmType(narrowPhaseAlgorithmType);
@@ -485,6 +488,31 @@ LastFrameCollisionInfo* OverlappingPairs::addLastFrameInfoIfNecessary(uint64 pai
     }
 }
 
+// Add a new cache of overlapping triangles for a convex vs concave pair if it does not exist already
+OverlappingTrianglesCache* OverlappingPairs::addOverlappingTrianglesCacheIfNecessary(uint64 pairIndex) {
+
+    assert(pairIndex >= mConcavePairsStartIndex && pairIndex < mNbPairs);
+
+    if (mOverlappingTrianglesCaches[pairIndex] == nullptr) {
+
+        mOverlappingTrianglesCaches[pairIndex] = new (mPersistentAllocator.allocate(sizeof(OverlappingTrianglesCache)))
+                                                 OverlappingTrianglesCache(mPersistentAllocator);
+    }
+
+    return mOverlappingTrianglesCaches[pairIndex];
+}
+
+// Destroy the cache of overlapping triangles of a pair (if any)
+void OverlappingPairs::destroyOverlappingTrianglesCache(uint64 pairIndex) {
+
+    if (mOverlappingTrianglesCaches[pairIndex] != nullptr) {
+
+        mOverlappingTrianglesCaches[pairIndex]->~OverlappingTrianglesCache();
+        mPersistentAllocator.release(mOverlappingTrianglesCaches[pairIndex], sizeof(OverlappingTrianglesCache));
+        mOverlappingTrianglesCaches[pairIndex] = nullptr;
+    }
+}
+
 // Delete all the obsolete last frame collision info
 void OverlappingPairs::clearObsoleteLastFrameCollisionInfos() {
 
@@ -500,8 +528,7 @@ void OverlappingPairs::clearObsoleteLastFrameCollisionInfos() {
             if (it->second->isObsolete) {
 
                 // Delete it
-                it->second->~LastFrameCollisionInfo();
-                mPersistentAllocator.release(it->second, sizeof(LastFrameCollisionInfo));
+                destroyLastFrameCollisionInfo(it->second);
 
                 it = mLastFrameCollisionInfos[i].remove(it);
             }
@@ -525,3 +552,42 @@ void OverlappingPairs::updateCollidingInPreviousFrame() {
         mCollidingInPreviousFrame[i] = mCollidingInCurrentFrame[i];
     }
 }
+
+// Add the cached contact points of a last frame collision info if they do not exist already
+/// The cached contact points are only allocated for the convex vs convex pairs whose contact points
+/// are cached. They are destroyed with their last frame collision info.
+CachedContactPoints* OverlappingPairs::addCachedContactPointsIfNecessary(LastFrameCollisionInfo* lastFrameCollisionInfo) {
+
+    if (lastFrameCollisionInfo->cachedContactPoints == nullptr) {
+        lastFrameCollisionInfo->cachedContactPoints = new (mPersistentAllocator.allocate(sizeof(CachedContactPoints)))
+                                                      CachedContactPoints();
+    }
+
+    return lastFrameCollisionInfo->cachedContactPoints;
+}
+
+// Prevent the cached contact points of a given overlapping pair from being reused
+/// The narrow-phase test of each pair of shapes of the overlapping pair will be run again
+/// during the next frame.
+void OverlappingPairs::clearCachedContactPoints(uint64 pairId) {
+
+    assert(mMapPairIdToPairIndex.containsKey(pairId));
+    const uint64 index = mMapPairIdToPairIndex[pairId];
+
+    // For each collision info
+    for (auto it = mLastFrameCollisionInfos[index].begin(); it != mLastFrameCollisionInfos[index].end(); ++it) {
+        it->second->hasCachedContactPoints = false;
+    }
+}
+
+// Destroy a last frame collision info and its cached contact points (if any)
+void OverlappingPairs::destroyLastFrameCollisionInfo(LastFrameCollisionInfo* lastFrameCollisionInfo) {
+
+    if (lastFrameCollisionInfo->cachedContactPoints != nullptr) {
+        lastFrameCollisionInfo->cachedContactPoints->~CachedContactPoints();
+        mPersistentAllocator.release(lastFrameCollisionInfo->cachedContactPoints, sizeof(CachedContactPoints));
+    }
+
+    lastFrameCollisionInfo->~LastFrameCollisionInfo();
+    mPersistentAllocator.release(lastFrameCollisionInfo, sizeof(LastFrameCollisionInfo));
+}
@@ -42,7 +42,8 @@ PhysicsCommon::PhysicsCommon(MemoryAllocator* baseMemoryAllocator)
                 mConvexMeshShapes(mMemoryManager.getHeapAllocator()), mConcaveMeshShapes(mMemoryManager.getHeapAllocator()),
                 mHeightFieldShapes(mMemoryManager.getHeapAllocator()), mPolyhedronMeshes(mMemoryManager.getHeapAllocator()),
                 mTriangleMeshes(mMemoryManager.getHeapAllocator()),
-                mProfilers(mMemoryManager.getHeapAllocator()), mDefaultLoggers(mMemoryManager.getHeapAllocator()) {
+                mProfilers(mMemoryManager.getHeapAllocator()), mDefaultLoggers(mMemoryManager.getHeapAllocator()),
+                mDefaultTaskSchedulers(mMemoryManager.getHeapAllocator()) {
 
 }
 
@@ -106,6 +107,11 @@ void PhysicsCommon::release() {
         destroyDefaultLogger(*it);
     }
 
+    // Destroy the default task schedulers
+    for (auto it = mDefaultTaskSchedulers.begin(); it != mDefaultTaskSchedulers.end(); ++it) {
+        destroyDefaultTaskScheduler(*it);
+    }
+
 // If profiling is enabled
 #ifdef IS_RP3D_PROFILING_ENABLED
 
@@ -378,11 +384,13 @@ void PhysicsCommon::destroyHeightFieldShape(HeightFieldShape* heightFieldShape)
 /**
  * @param triangleMesh A pointer to the triangle mesh to use to create the concave mesh shape
  * @param scaling An optional scaling factor to scale the triangle mesh
+ * @param taskScheduler An optional task scheduler used to build the tree of triangles in parallel
  * @return A pointer to the created concave mesh shape
  */
-ConcaveMeshShape* PhysicsCommon::createConcaveMeshShape(TriangleMesh* triangleMesh, const Vector3& scaling) {
+ConcaveMeshShape* PhysicsCommon::createConcaveMeshShape(TriangleMesh* triangleMesh, const Vector3& scaling,
+                                                        TaskScheduler* taskScheduler) {
 
-    ConcaveMeshShape* shape = new (mMemoryManager.allocate(MemoryManager::AllocationType::Pool, sizeof(ConcaveMeshShape))) ConcaveMeshShape(triangleMesh, mMemoryManager.getHeapAllocator(), scaling);
+    ConcaveMeshShape* shape = new (mMemoryManager.allocate(MemoryManager::AllocationType::Pool, sizeof(ConcaveMeshShape))) ConcaveMeshShape(triangleMesh, mMemoryManager.getHeapAllocator(), scaling, taskScheduler);
 
     mConcaveMeshShapes.add(shape);
 
@@ -496,6 +504,37 @@ void PhysicsCommon::destroyDefaultLogger(DefaultLogger* logger) {
    mDefaultLoggers.remove(logger);
 }
 
+// Create and return a new default task scheduler
+/**
+ * @param nbThreads Number of threads used by the scheduler (including the thread calling
+ *                  PhysicsWorld::update()). If zero, the number of hardware threads is used
+ * @return A pointer to the created default task scheduler
+ */
+DefaultTaskScheduler* PhysicsCommon::createDefaultTaskScheduler(uint32 nbThreads) {
+
+    DefaultTaskScheduler* taskScheduler = new (mMemoryManager.allocate(MemoryManager::AllocationType::Heap, sizeof(DefaultTaskScheduler)))
+                                              DefaultTaskScheduler(mMemoryManager.getHeapAllocator(), nbThreads);
+
+    mDefaultTaskSchedulers.add(taskScheduler);
+
+    return taskScheduler;
+}
+
+// Destroy a default task scheduler
+/**
+ * @param taskScheduler A pointer to the default task scheduler to destroy
+ */
+void PhysicsCommon::destroyDefaultTaskScheduler(DefaultTaskScheduler* taskScheduler) {
+
+   // Call the destructor of the task scheduler (this stops its threads)
+   taskScheduler->~DefaultTaskScheduler();
+
+   // Release allocated memory
+   mMemoryManager.release(MemoryManager::AllocationType::Heap, taskScheduler, sizeof(DefaultTaskScheduler));
+
+   mDefaultTaskSchedulers.remove(taskScheduler);
+}
+
 // If profiling is enabled
 #ifdef IS_RP3D_PROFILING_ENABLED
 
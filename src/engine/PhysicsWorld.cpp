@@ -57,7 +57,9 @@ PhysicsWorld::PhysicsWorld(MemoryManager& memoryManager, const WorldSettings& wo
                 mJointsComponents(mMemoryManager.getHeapAllocator()), mBallAndSocketJointsComponents(mMemoryManager.getHeapAllocator()),
                 mFixedJointsComponents(mMemoryManager.getHeapAllocator()), mHingeJointsComponents(mMemoryManager.getHeapAllocator()),
                 mSliderJointsComponents(mMemoryManager.getHeapAllocator()), mCollisionDetection(this, mCollidersComponents, mTransformComponents, mCollisionBodyComponents, mRigidBodyComponents,
-                                        mMemoryManager),
+                                        mMemoryManager, mConfig.taskScheduler, mConfig.broadPhaseAlgorithm,
+                                        mConfig.dynamicTreeOptimizationBudget, mConfig.isFatAABBVelocityPredictionEnabled,
+                                        mConfig.hashGridCellSize),
                 mCollisionBodies(mMemoryManager.getHeapAllocator()), mEventListener(nullptr),
                 mName(worldSettings.worldName),  mIslands(mMemoryManager.getSingleFrameAllocator()),
                 mContactSolverSystem(mMemoryManager, *this, mIslands, mCollisionBodyComponents, mRigidBodyComponents,
@@ -65,7 +67,8 @@ PhysicsWorld::PhysicsWorld(MemoryManager& memoryManager, const WorldSettings& wo
                 mConstraintSolverSystem(*this, mIslands, mRigidBodyComponents, mTransformComponents, mJointsComponents,
                                         mBallAndSocketJointsComponents, mFixedJointsComponents, mHingeJointsComponents,
                                         mSliderJointsComponents),
-                mDynamicsSystem(*this, mCollisionBodyComponents, mRigidBodyComponents, mTransformComponents, mCollidersComponents, mIsGravityEnabled, mConfig.gravity),
+                mDynamicsSystem(*this, mCollisionBodyComponents, mRigidBodyComponents, mTransformComponents, mCollidersComponents, mIsGravityEnabled, mConfig.gravity,
+                                mConfig.taskScheduler),
                 mNbVelocitySolverIterations(mConfig.defaultVelocitySolverNbIterations),
                 mNbPositionSolverIterations(mConfig.defaultPositionSolverNbIterations), 
                 mIsSleepingEnabled(mConfig.isSleepingEnabled), mRigidBodies(mMemoryManager.getPoolAllocator()),
@@ -317,6 +320,18 @@ AABB PhysicsWorld::getWorldAABB(const Collider* collider) const {
    return mCollisionDetection.getWorldAABB(collider);
 }
 
+// Reorder the internal data of the broad-phase in memory to make the queries faster
+/// After many colliders have been created, destroyed or moved (when a level has been
+/// loaded for instance), the nodes of the broad-phase tree are scattered in memory. This
+/// method moves them so that a node is close to its children in memory. It is not called
+/// automatically for the colliders of non-static bodies because it takes some time.
+void PhysicsWorld::compactBroadPhase() {
+
+    RP3D_PROFILE("PhysicsWorld::compactBroadPhase()", mProfiler);
+
+    mCollisionDetection.compactBroadPhase();
+}
+
 // Update the physics simulation
 /**
  * @param timeStep The amount of time to step the simulation by (in seconds)
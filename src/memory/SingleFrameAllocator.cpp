@@ -32,8 +32,13 @@
 using namespace reactphysics3d;
 
 // Constructor
-SingleFrameAllocator::SingleFrameAllocator(MemoryAllocator& baseAllocator) : mBaseAllocator(baseAllocator),
-                                           mTotalSizeBytes(INIT_SINGLE_FRAME_ALLOCATOR_NB_BYTES),
+/**
+ * @param baseAllocator Allocator used to allocate the memory block of the allocator
+ * @param initAllocatedMemory Initial size (in bytes) of the memory block (if zero, the
+ *                            default initial size is used)
+ */
+SingleFrameAllocator::SingleFrameAllocator(MemoryAllocator& baseAllocator, size_t initAllocatedMemory) : mBaseAllocator(baseAllocator),
+                                           mTotalSizeBytes(initAllocatedMemory > 0 ? initAllocatedMemory : INIT_SINGLE_FRAME_ALLOCATOR_NB_BYTES),
                                            mCurrentOffset(0), mNbFramesTooMuchAllocated(0), mNeedToAllocatedMore(false) {
 
     // Allocate a whole block of memory at the beginning
@@ -25,6 +25,12 @@
 
 // Libraries
 #include <reactphysics3d/systems/BroadPhaseSystem.h>
+#include <reactphysics3d/collision/broadphase/DynamicAABBTreeBroadPhase.h>
+#include <reactphysics3d/collision/broadphase/SweepAndPruneBroadPhase.h>
+#include <reactphysics3d/collision/broadphase/HashGridBroadPhase.h>
+#include <reactphysics3d/collision/shapes/BoxShape.h>
+#include <reactphysics3d/collision/shapes/SphereShape.h>
+#include <reactphysics3d/collision/shapes/CapsuleShape.h>
 #include <reactphysics3d/systems/CollisionDetectionSystem.h>
 #include <reactphysics3d/utils/Profiler.h>
 #include <reactphysics3d/collision/RaycastInfo.h>
@@ -36,11 +42,40 @@ using namespace reactphysics3d;
 
 // Constructor
 BroadPhaseSystem::BroadPhaseSystem(CollisionDetectionSystem& collisionDetection, ColliderComponents& collidersComponents,
-                                   TransformComponents& transformComponents, RigidBodyComponents& rigidBodyComponents)
-                    :mDynamicAABBTree(collisionDetection.getMemoryManager().getPoolAllocator(), DYNAMIC_TREE_FAT_AABB_INFLATE_PERCENTAGE),
+                                   TransformComponents& transformComponents, RigidBodyComponents& rigidBodyComponents,
+                                   BroadPhaseAlgorithmType broadPhaseAlgorithmType, uint32 dynamicTreeOptimizationBudget,
+                                   TaskScheduler* taskScheduler, bool isFatAABBVelocityPredictionEnabled, decimal hashGridCellSize)
+                    :mAllocator(collisionDetection.getMemoryManager().getHeapAllocator()), mBroadPhaseAlgorithmType(broadPhaseAlgorithmType),
+                     mBroadPhaseAlgorithm(nullptr),
                      mCollidersComponents(collidersComponents), mTransformsComponents(transformComponents),
                      mRigidBodyComponents(rigidBodyComponents), mMovedShapes(collisionDetection.getMemoryManager().getPoolAllocator()),
-                     mCollisionDetection(collisionDetection) {
+                     mCollisionDetection(collisionDetection),
+                     mIsFatAABBVelocityPredictionEnabled(isFatAABBVelocityPredictionEnabled), mTaskScheduler(taskScheduler),
+                     mCollidersAABBs(mAllocator), mHaveCollidersLeftFatAABB(mAllocator) {
+
+    MemoryAllocator& poolAllocator = collisionDetection.getMemoryManager().getPoolAllocator();
+
+    // Create the broad-phase algorithm
+    switch (mBroadPhaseAlgorithmType) {
+
+        case BroadPhaseAlgorithmType::SWEEP_AND_PRUNE:
+            mBroadPhaseAlgorithm = new (mAllocator.allocate(sizeof(SweepAndPruneBroadPhase)))
+                    SweepAndPruneBroadPhase(poolAllocator, DYNAMIC_TREE_FAT_AABB_INFLATE_PERCENTAGE, taskScheduler);
+            break;
+
+        case BroadPhaseAlgorithmType::HASH_GRID:
+            mBroadPhaseAlgorithm = new (mAllocator.allocate(sizeof(HashGridBroadPhase)))
+                    HashGridBroadPhase(poolAllocator, DYNAMIC_TREE_FAT_AABB_INFLATE_PERCENTAGE, hashGridCellSize,
+                                       dynamicTreeOptimizationBudget, taskScheduler);
+            break;
+
+        case BroadPhaseAlgorithmType::DYNAMIC_AABB_TREE:
+        default:
+            mBroadPhaseAlgorithm = new (mAllocator.allocate(sizeof(DynamicAABBTreeBroadPhase)))
+                    DynamicAABBTreeBroadPhase(poolAllocator, DYNAMIC_TREE_FAT_AABB_INFLATE_PERCENTAGE,
+                                              dynamicTreeOptimizationBudget, taskScheduler);
+            break;
+    }
 
 #ifdef IS_RP3D_PROFILING_ENABLED
 
@@ -51,6 +86,31 @@ BroadPhaseSystem::BroadPhaseSystem(CollisionDetectionSystem& collisionDetection,
 
 }
 
+// Destructor
+BroadPhaseSystem::~BroadPhaseSystem() {
+
+    // Destroy the broad-phase algorithm
+    size_t size;
+    switch (mBroadPhaseAlgorithmType) {
+
+        case BroadPhaseAlgorithmType::SWEEP_AND_PRUNE:
+            size = sizeof(SweepAndPruneBroadPhase);
+            break;
+
+        case BroadPhaseAlgorithmType::HASH_GRID:
+            size = sizeof(HashGridBroadPhase);
+            break;
+
+        case BroadPhaseAlgorithmType::DYNAMIC_AABB_TREE:
+        default:
+            size = sizeof(DynamicAABBTreeBroadPhase);
+            break;
+    }
+
+    mBroadPhaseAlgorithm->~BroadPhaseAlgorithm();
+    mAllocator.release(mBroadPhaseAlgorithm, size);
+}
+
 // Return true if the two broad-phase collision shapes are overlapping
 bool BroadPhaseSystem::testOverlappingShapes(int32 shape1BroadPhaseId, int32 shape2BroadPhaseId) const {
 
@@ -59,8 +119,8 @@ bool BroadPhaseSystem::testOverlappingShapes(int32 shape1BroadPhaseId, int32 sha
     assert(shape1BroadPhaseId != -1 && shape2BroadPhaseId != -1);
 
     // Get the two AABBs of the collision shapes
-    const AABB& aabb1 = mDynamicAABBTree.getFatAABB(shape1BroadPhaseId);
-    const AABB& aabb2 = mDynamicAABBTree.getFatAABB(shape2BroadPhaseId);
+    const AABB& aabb1 = mBroadPhaseAlgorithm->getFatAABB(shape1BroadPhaseId);
+    const AABB& aabb2 = mBroadPhaseAlgorithm->getFatAABB(shape2BroadPhaseId);
 
     // Check if the two AABBs are overlapping
     return aabb1.testCollision(aabb2);
@@ -72,9 +132,19 @@ void BroadPhaseSystem::raycast(const Ray& ray, RaycastTest& raycastTest,
 
     RP3D_PROFILE("BroadPhaseSystem::raycast()", mProfiler);
 
-    BroadPhaseRaycastCallback broadPhaseRaycastCallback(mDynamicAABBTree, raycastWithCategoryMaskBits, raycastTest);
+    BroadPhaseRaycastCallback broadPhaseRaycastCallback(*mBroadPhaseAlgorithm, raycastWithCategoryMaskBits, raycastTest);
 
-    mDynamicAABBTree.raycast(ray, broadPhaseRaycastCallback);
+    mBroadPhaseAlgorithm->raycast(ray, broadPhaseRaycastCallback);
+}
+
+// Ray cast the rays of a packet against the colliders of the broad-phase
+/// The colliders whose fat AABB is hit by some rays of the packet are given to the batch test.
+void BroadPhaseSystem::raycast(RayPacket& packet, Stack<int32>& stack, RaycastBatchTest& raycastBatchTest,
+                               unsigned short raycastWithCategoryMaskBits) const {
+
+    BroadPhaseRayPacketCallback broadPhaseRayPacketCallback(*mBroadPhaseAlgorithm, raycastWithCategoryMaskBits, raycastBatchTest);
+
+    mBroadPhaseAlgorithm->raycast(packet, stack, broadPhaseRayPacketCallback);
 }
 
 // Add a collider into the broad-phase collision detection
@@ -82,12 +152,18 @@ void BroadPhaseSystem::addCollider(Collider* collider, const AABB& aabb) {
 
     assert(collider->getBroadPhaseId() == -1);
 
-    // Add the collision shape into the dynamic AABB tree and get its broad-phase ID
-    int nodeId = mDynamicAABBTree.addObject(aabb, collider);
+    // Add the collision shape into the broad-phase algorithm and get its broad-phase ID
+    int nodeId = mBroadPhaseAlgorithm->addObject(aabb, collider, isColliderStatic(collider));
 
     // Set the broad-phase ID of the collider
     mCollidersComponents.setBroadPhaseId(collider->getEntity(), nodeId);
 
+    // If the collider has its own inflation percentage, reset its fat AABB with it
+    const decimal fatAABBInflatePercentage = mCollidersComponents.getFatAABBInflatePercentage(collider->getEntity());
+    if (fatAABBInflatePercentage >= decimal(0.0)) {
+        mBroadPhaseAlgorithm->updateObject(nodeId, aabb, Vector3::zero(), fatAABBInflatePercentage, true);
+    }
+
     // Add the collision shape into the array of bodies that have moved (or have been created)
     // during the last simulation step
     addMovedCollider(collider->getBroadPhaseId(), collider);
@@ -102,14 +178,29 @@ void BroadPhaseSystem::removeCollider(Collider* collider) {
 
     mCollidersComponents.setBroadPhaseId(collider->getEntity(), -1);
 
-    // Remove the collision shape from the dynamic AABB tree
-    mDynamicAABBTree.removeObject(broadPhaseID);
+    // Remove the collision shape from the broad-phase algorithm
+    mBroadPhaseAlgorithm->removeObject(broadPhaseID);
 
     // Remove the collision shape into the array of shapes that have moved (or have been created)
     // during the last simulation step
     removeMovedCollider(broadPhaseID);
 }
 
+// Return true if a collider belongs to a static body
+bool BroadPhaseSystem::isColliderStatic(const Collider* collider) const {
+
+    const Entity bodyEntity = mCollidersComponents.getBody(collider->getEntity());
+    return mRigidBodyComponents.hasComponent(bodyEntity) && mRigidBodyComponents.getBodyType(bodyEntity) == BodyType::STATIC;
+}
+
+// Update the broad-phase state of a collider after the type of its body has changed
+void BroadPhaseSystem::updateColliderBodyType(Collider* collider) {
+
+    assert(collider->getBroadPhaseId() != -1);
+
+    mBroadPhaseAlgorithm->setObjectIsStatic(collider->getBroadPhaseId(), isColliderStatic(collider));
+}
+
 // Update the broad-phase state of a single collider
 void BroadPhaseSystem::updateCollider(Entity colliderEntity, decimal timeStep) {
 
@@ -135,15 +226,17 @@ void BroadPhaseSystem::updateColliders(decimal timeStep) {
 
 // Notify the broad-phase that a collision shape has moved and need to be updated
 void BroadPhaseSystem::updateColliderInternal(int32 broadPhaseId, Collider* collider, const AABB& aabb,
+                                              const Vector3& displacement, decimal fatAABBInflatePercentage,
                                               bool forceReInsert) {
 
     assert(broadPhaseId >= 0);
 
-    // Update the dynamic AABB tree according to the movement of the collision shape
-    bool hasBeenReInserted = mDynamicAABBTree.updateObject(broadPhaseId, aabb, forceReInsert);
+    // Update the broad-phase algorithm according to the movement of the collision shape
+    bool hasBeenReInserted = mBroadPhaseAlgorithm->updateObject(broadPhaseId, aabb, displacement,
+                                                                fatAABBInflatePercentage, forceReInsert);
 
-    // If the collision shape has moved out of its fat AABB (and therefore has been reinserted
-    // into the tree).
+    // If the collision shape has moved out of its fat AABB (and therefore its fat AABB
+    // has been updated in the broad-phase algorithm).
     if (hasBeenReInserted) {
 
         // Add the collision shape into the array of shapes that have moved (or have been created)
@@ -153,6 +246,9 @@ void BroadPhaseSystem::updateColliderInternal(int32 broadPhaseId, Collider* coll
 }
 
 // Update the broad-phase state of some colliders components
+/// The world-space AABBs of the colliders are computed first (in parallel if the world has a task
+/// scheduler) together with the colliders that are not inside their fat AABB anymore. Then, only
+/// those colliders are updated in the broad-phase algorithm (which is not thread-safe).
 void BroadPhaseSystem::updateCollidersComponents(uint32 startIndex, uint32 nbItems, decimal timeStep) {
 
     RP3D_PROFILE("BroadPhaseSystem::updateCollidersComponents()", mProfiler);
@@ -166,31 +262,204 @@ void BroadPhaseSystem::updateCollidersComponents(uint32 startIndex, uint32 nbIte
     uint32 endIndex = std::min(startIndex + nbItems, mCollidersComponents.getNbEnabledComponents());
     nbItems = endIndex - startIndex;
 
-    // For each collider component to update
-    for (uint32 i = startIndex; i < startIndex + nbItems; i++) {
+    mCollidersAABBs.clear();
+    mCollidersAABBs.addWithoutInit(nbItems);
+    mHaveCollidersLeftFatAABB.clear();
+    mHaveCollidersLeftFatAABB.addWithoutInit(nbItems);
 
-        const int32 broadPhaseId = mCollidersComponents.mBroadPhaseIds[i];
-        if (broadPhaseId != -1) {
+    // Each collider only writes its own AABB and the broad-phase is only read here
+    auto computeAABBs = [this, startIndex](uint32 start, uint32 end) {
 
-            const Entity& bodyEntity = mCollidersComponents.mBodiesEntities[i];
-            const Transform& transform = mTransformsComponents.getTransform(bodyEntity);
+        // Recompute the world-space AABBs of the collision shapes
+        computeCollidersAABBs(startIndex + start, startIndex + end, &(mCollidersAABBs[start]));
 
-            // Recompute the world-space AABB of the collision shape
-            AABB aabb;
-            mCollidersComponents.mCollisionShapes[i]->computeAABB(aabb, transform * mCollidersComponents.mLocalToBodyTransforms[i]);
+        for (uint32 i = start; i < end; i++) {
+
+            const int32 broadPhaseId = mCollidersComponents.mBroadPhaseIds[startIndex + i];
 
             // If the size of the collision shape has been changed by the user,
             // we need to reset the broad-phase AABB to its new size
-            const bool forceReInsert = mCollidersComponents.mHasCollisionShapeChangedSize[i];
+            mHaveCollidersLeftFatAABB[i] = broadPhaseId != -1 &&
+                                           (mCollidersComponents.mHasCollisionShapeChangedSize[startIndex + i] ||
+                                            !mBroadPhaseAlgorithm->getFatAABB(broadPhaseId).contains(mCollidersAABBs[i]));
+        }
+    };
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+    computeAABBs(0, nbItems);
+
+#else
+
+    parallelFor(mTaskScheduler, nbItems, PARALLEL_FOR_GRAIN_SIZE, computeAABBs);
+
+#endif
+
+    // For each collider that is not inside its fat AABB anymore
+    for (uint32 i = 0; i < nbItems; i++) {
 
-            // Update the broad-phase state of the collider
-            updateColliderInternal(broadPhaseId, mCollidersComponents.mColliders[i], aabb, forceReInsert);
+        if (!mHaveCollidersLeftFatAABB[i]) continue;
 
-            mCollidersComponents.mHasCollisionShapeChangedSize[i] = false;
+        const uint32 index = startIndex + i;
+        const Entity& bodyEntity = mCollidersComponents.mBodiesEntities[index];
+
+        // If the velocity prediction is enabled, the fat AABB is extended in the direction of
+        // the motion of the body during the next frame (assuming a constant velocity)
+        Vector3 displacement(0, 0, 0);
+        if (mIsFatAABBVelocityPredictionEnabled && timeStep > decimal(0.0) && mRigidBodyComponents.hasComponent(bodyEntity)) {
+            displacement = mRigidBodyComponents.getLinearVelocity(bodyEntity) * (timeStep * FAT_AABB_DISPLACEMENT_MULTIPLIER);
         }
+
+        // Update the broad-phase state of the collider
+        updateColliderInternal(mCollidersComponents.mBroadPhaseIds[index], mCollidersComponents.mColliders[index],
+                               mCollidersAABBs[i], displacement, mCollidersComponents.mFatAABBInflatePercentages[index],
+                               mCollidersComponents.mHasCollisionShapeChangedSize[index]);
+
+        mCollidersComponents.mHasCollisionShapeChangedSize[index] = false;
+    }
+}
+
+// Compute the world-space AABBs of a range of colliders components
+/// The colliders are processed by batches. The world-space data of the boxes, capsules and spheres
+/// of a batch are gathered into structures of arrays and their AABBs are computed together by
+/// batch kernels without a virtual call for each collider. The AABBs of the other collision shapes
+/// are computed by the shapes themselves.
+void BroadPhaseSystem::computeCollidersAABBs(uint32 startIndex, uint32 endIndex, AABB* outAABBs) const {
+
+    OrientedBoxesBatch orientedBoxes;
+    SpheresBatch spheres;
+
+    for (uint32 batchStart = startIndex; batchStart < endIndex; batchStart += COLLIDERS_AABBS_BATCH_SIZE) {
+
+        const uint32 batchEnd = std::min(batchStart + COLLIDERS_AABBS_BATCH_SIZE, endIndex);
+        AABB* batchAABBs = outAABBs + (batchStart - startIndex);
+        uint32 nbOrientedBoxes = 0;
+        uint32 nbSpheres = 0;
+
+        // Sort the colliders of the batch by type of collision shape
+        for (uint32 i = batchStart; i < batchEnd; i++) {
+
+            const uint32 k = i - batchStart;
+            const Entity& bodyEntity = mCollidersComponents.mBodiesEntities[i];
+            const Transform transform = mTransformsComponents.getTransform(bodyEntity) * mCollidersComponents.mLocalToBodyTransforms[i];
+            const Vector3& position = transform.getPosition();
+            const Quaternion& orientation = transform.getOrientation();
+
+            const CollisionShape* shape = mCollidersComponents.mCollisionShapes[i];
+            Vector3 halfExtents;
+            switch (shape->getName()) {
+
+                case CollisionShapeName::BOX:
+                    halfExtents = static_cast<const BoxShape*>(shape)->getHalfExtents();
+                    break;
+
+                case CollisionShapeName::CAPSULE:
+                {
+                    // The AABB of a capsule is the one of its local bounds box
+                    const CapsuleShape* capsule = static_cast<const CapsuleShape*>(shape);
+                    const decimal radius = capsule->getRadius();
+                    halfExtents = Vector3(radius, capsule->getHeight() * decimal(0.5) + radius, radius);
+                    break;
+                }
+
+                case CollisionShapeName::SPHERE:
+                    spheres.indices[nbSpheres] = k;
+                    spheres.positionsX[nbSpheres] = position.x;
+                    spheres.positionsY[nbSpheres] = position.y;
+                    spheres.positionsZ[nbSpheres] = position.z;
+                    spheres.radiuses[nbSpheres] = static_cast<const SphereShape*>(shape)->getRadius();
+                    nbSpheres++;
+                    continue;
+
+                default:
+                    shape->computeAABB(batchAABBs[k], transform);
+                    continue;
+            }
+
+            orientedBoxes.indices[nbOrientedBoxes] = k;
+            orientedBoxes.positionsX[nbOrientedBoxes] = position.x;
+            orientedBoxes.positionsY[nbOrientedBoxes] = position.y;
+            orientedBoxes.positionsZ[nbOrientedBoxes] = position.z;
+            orientedBoxes.orientationsX[nbOrientedBoxes] = orientation.x;
+            orientedBoxes.orientationsY[nbOrientedBoxes] = orientation.y;
+            orientedBoxes.orientationsZ[nbOrientedBoxes] = orientation.z;
+            orientedBoxes.orientationsW[nbOrientedBoxes] = orientation.w;
+            orientedBoxes.halfExtentsX[nbOrientedBoxes] = halfExtents.x;
+            orientedBoxes.halfExtentsY[nbOrientedBoxes] = halfExtents.y;
+            orientedBoxes.halfExtentsZ[nbOrientedBoxes] = halfExtents.z;
+            nbOrientedBoxes++;
+        }
+
+        computeOrientedBoxesAABBs(orientedBoxes, nbOrientedBoxes, batchAABBs);
+        computeSpheresAABBs(spheres, nbSpheres, batchAABBs);
+    }
+}
+
+// Compute the world-space AABBs of the oriented boxes of a batch of colliders
+/// The extent of the AABB of a box along each world axis is the sum of the half-extents of the
+/// box projected on this axis. The extents are computed by a loop over the arrays of the batch
+/// that the compiler can vectorize. The rotation matrix of each box is computed from its
+/// quaternion as in Quaternion::getMatrix(). Then, the AABBs are written.
+void BroadPhaseSystem::computeOrientedBoxesAABBs(OrientedBoxesBatch& boxes, uint32 nbBoxes, AABB* outAABBs) {
+
+    for (uint32 i = 0; i < nbBoxes; i++) {
+
+        const decimal x = boxes.orientationsX[i];
+        const decimal y = boxes.orientationsY[i];
+        const decimal z = boxes.orientationsZ[i];
+        const decimal w = boxes.orientationsW[i];
+
+        const decimal nQ = x*x + y*y + z*z + w*w;
+        // The smallest positive value is added to the norm instead of testing it so that the loop does
+        // not branch (it does not change a norm that is not tiny). If the norm is zero, the components
+        // are zero and so are the products below.
+        const decimal s = decimal(2.0) / (nQ + std::numeric_limits<decimal>::min());
+
+        const decimal xs = x*s;
+        const decimal ys = y*s;
+        const decimal zs = z*s;
+        const decimal wxs = w*xs;
+        const decimal wys = w*ys;
+        const decimal wzs = w*zs;
+        const decimal xxs = x*xs;
+        const decimal xys = x*ys;
+        const decimal xzs = x*zs;
+        const decimal yys = y*ys;
+        const decimal yzs = y*zs;
+        const decimal zzs = z*zs;
+
+        const decimal hx = boxes.halfExtentsX[i];
+        const decimal hy = boxes.halfExtentsY[i];
+        const decimal hz = boxes.halfExtentsZ[i];
+
+        // Project the half-extents of the box on each world axis with the absolute rotation matrix
+        boxes.extentsX[i] = std::abs(decimal(1.0) - yys - zzs) * hx + std::abs(xys - wzs) * hy + std::abs(xzs + wys) * hz;
+        boxes.extentsY[i] = std::abs(xys + wzs) * hx + std::abs(decimal(1.0) - xxs - zzs) * hy + std::abs(yzs - wxs) * hz;
+        boxes.extentsZ[i] = std::abs(xzs - wys) * hx + std::abs(yzs + wxs) * hy + std::abs(decimal(1.0) - xxs - yys) * hz;
+    }
+
+    for (uint32 i = 0; i < nbBoxes; i++) {
+
+        AABB& aabb = outAABBs[boxes.indices[i]];
+        aabb.setMin(Vector3(boxes.positionsX[i] - boxes.extentsX[i], boxes.positionsY[i] - boxes.extentsY[i],
+                            boxes.positionsZ[i] - boxes.extentsZ[i]));
+        aabb.setMax(Vector3(boxes.positionsX[i] + boxes.extentsX[i], boxes.positionsY[i] + boxes.extentsY[i],
+                            boxes.positionsZ[i] + boxes.extentsZ[i]));
     }
 }
 
+// Compute the world-space AABBs of the spheres of a batch of colliders
+void BroadPhaseSystem::computeSpheresAABBs(const SpheresBatch& spheres, uint32 nbSpheres, AABB* outAABBs) {
+
+    for (uint32 i = 0; i < nbSpheres; i++) {
+
+        const decimal radius = spheres.radiuses[i];
+
+        AABB& aabb = outAABBs[spheres.indices[i]];
+        aabb.setMin(Vector3(spheres.positionsX[i] - radius, spheres.positionsY[i] - radius, spheres.positionsZ[i] - radius));
+        aabb.setMax(Vector3(spheres.positionsX[i] + radius, spheres.positionsY[i] + radius, spheres.positionsZ[i] + radius));
+    }
+}
 
 // Add a collider in the array of colliders that have moved in the last simulation step
 // and that need to be tested again for broad-phase overlapping.
@@ -213,8 +482,8 @@ void BroadPhaseSystem::computeOverlappingPairs(MemoryManager& memoryManager, Lis
     // Get the list of the colliders that have moved or have been created in the last frame
     List<int> shapesToTest = mMovedShapes.toList(memoryManager.getPoolAllocator());
 
-    // Ask the dynamic AABB tree to report all collision shapes that overlap with the shapes to test
-    mDynamicAABBTree.reportAllShapesOverlappingWithShapes(shapesToTest, 0, shapesToTest.size(), overlappingNodes);
+    // Ask the broad-phase algorithm to report all collision shapes that overlap with the shapes to test
+    mBroadPhaseAlgorithm->computeOverlappingPairs(memoryManager, shapesToTest, overlappingNodes);
 
     // Reset the array of collision shapes that have move (or have been created) during the
     // last simulation step
@@ -233,7 +502,7 @@ decimal BroadPhaseRaycastCallback::raycastBroadPhaseShape(int32 nodeId, const Ra
     decimal hitFraction = decimal(-1.0);
 
     // Get the collider from the node
-    Collider* collider = static_cast<Collider*>(mDynamicAABBTree.getNodeDataPointer(nodeId));
+    Collider* collider = static_cast<Collider*>(mBroadPhaseAlgorithm.getObjectData(nodeId));
 
     // Check if the raycast filtering mask allows raycast against this shape
     if ((mRaycastWithCategoryMaskBits & collider->getCollisionCategoryBits()) != 0) {
@@ -246,3 +515,18 @@ decimal BroadPhaseRaycastCallback::raycastBroadPhaseShape(int32 nodeId, const Ra
 
     return hitFraction;
 }
+
+// Called for a broad-phase shape that has to be tested for raycast by the rays of a packet in the bit mask
+void BroadPhaseRayPacketCallback::raycastBroadPhaseShape(int32 nodeId, RayPacket& packet, uint32 rayMask) {
+
+    // Get the collider from the node
+    Collider* collider = static_cast<Collider*>(mBroadPhaseAlgorithm.getObjectData(nodeId));
+
+    // Check if the raycast filtering mask allows raycast against this shape
+    if ((mRaycastWithCategoryMaskBits & collider->getCollisionCategoryBits()) != 0) {
+
+        // Ask the collision detection to perform a ray cast test of the hit rays against
+        // the collider of this node
+        mRaycastBatchTest.raycastAgainstShape(collider, packet, rayMask);
+    }
+}
@@ -40,6 +40,7 @@
 #include <reactphysics3d/utils/Profiler.h>
 #include <reactphysics3d/engine/EventListener.h>
 #include <reactphysics3d/collision/RaycastInfo.h>
+#include <reactphysics3d/collision/RayPacket.h>
 #include <reactphysics3d/containers/Pair.h>
 #include <cassert>
 #include <iostream>
@@ -50,15 +51,20 @@ using namespace std;
 
 // Constructor
 CollisionDetectionSystem::CollisionDetectionSystem(PhysicsWorld* world, ColliderComponents& collidersComponents, TransformComponents& transformComponents,
-                                       CollisionBodyComponents& collisionBodyComponents, RigidBodyComponents& rigidBodyComponents, MemoryManager& memoryManager)
+                                       CollisionBodyComponents& collisionBodyComponents, RigidBodyComponents& rigidBodyComponents, MemoryManager& memoryManager,
+                                       TaskScheduler* taskScheduler, BroadPhaseAlgorithmType broadPhaseAlgorithmType,
+                                       uint32 dynamicTreeOptimizationBudget, bool isFatAABBVelocityPredictionEnabled,
+                                       decimal hashGridCellSize)
                    : mMemoryManager(memoryManager), mCollidersComponents(collidersComponents),
-                     mCollisionDispatch(mMemoryManager.getPoolAllocator()), mWorld(world),
+                     mCollisionDispatch(mMemoryManager.getPoolAllocator()), mWorld(world), mTaskScheduler(taskScheduler),
                      mNoCollisionPairs(mMemoryManager.getPoolAllocator()),
                      mOverlappingPairs(mMemoryManager.getPoolAllocator(), mMemoryManager.getSingleFrameAllocator(), mCollidersComponents,
                                        collisionBodyComponents, rigidBodyComponents, mNoCollisionPairs, mCollisionDispatch),
-                     mBroadPhaseSystem(*this, mCollidersComponents, transformComponents, rigidBodyComponents),
+                     mBroadPhaseSystem(*this, mCollidersComponents, transformComponents, rigidBodyComponents, broadPhaseAlgorithmType,
+                                      dynamicTreeOptimizationBudget, taskScheduler, isFatAABBVelocityPredictionEnabled, hashGridCellSize),
                      mMapBroadPhaseIdToColliderEntity(memoryManager.getPoolAllocator()),
-                     mNarrowPhaseInput(mMemoryManager.getSingleFrameAllocator(), mOverlappingPairs), mPotentialContactPoints(mMemoryManager.getSingleFrameAllocator()),
+                     mNarrowPhaseInput(mMemoryManager.getSingleFrameAllocator(), mOverlappingPairs),
+                     mNarrowPhaseAllocators(nullptr), mNbNarrowPhaseAllocators(0), mPotentialContactPoints(mMemoryManager.getSingleFrameAllocator()),
                      mPotentialContactManifolds(mMemoryManager.getSingleFrameAllocator()), mContactPairs1(mMemoryManager.getPoolAllocator()),
                      mContactPairs2(mMemoryManager.getPoolAllocator()), mPreviousContactPairs(&mContactPairs1), mCurrentContactPairs(&mContactPairs2),
                      mLostContactPairs(mMemoryManager.getSingleFrameAllocator()), mMapPairIdToContactPairIndex1(mMemoryManager.getPoolAllocator()),
@@ -69,6 +75,17 @@ CollisionDetectionSystem::CollisionDetectionSystem(PhysicsWorld* world, Collider
                      mContactPoints2(mMemoryManager.getPoolAllocator()), mPreviousContactPoints(&mContactPoints1),
                      mCurrentContactPoints(&mContactPoints2), mMapBodyToContactPairs(mMemoryManager.getSingleFrameAllocator()) {
 
+    // If the narrow-phase can be split among several threads, create the single frame
+    // allocators of its tasks
+    if (mTaskScheduler != nullptr && mTaskScheduler->getNbThreads() > 1) {
+
+        mNbNarrowPhaseAllocators = mTaskScheduler->getNbThreads() * NARROW_PHASE_NB_TASKS_PER_THREAD;
+        mNarrowPhaseAllocators = static_cast<SingleFrameAllocator*>(mMemoryManager.getPoolAllocator().allocate(mNbNarrowPhaseAllocators * sizeof(SingleFrameAllocator)));
+        for (uint32 i=0; i < mNbNarrowPhaseAllocators; i++) {
+            new (mNarrowPhaseAllocators + i) SingleFrameAllocator(mMemoryManager.getHeapAllocator(), NARROW_PHASE_ALLOCATOR_INIT_NB_BYTES);
+        }
+    }
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
 
@@ -80,6 +97,18 @@ CollisionDetectionSystem::CollisionDetectionSystem(PhysicsWorld* world, Collider
 
 }
 
+// Destructor
+CollisionDetectionSystem::~CollisionDetectionSystem() {
+
+    // Destroy the single frame allocators of the narrow-phase tasks
+    for (uint32 i=0; i < mNbNarrowPhaseAllocators; i++) {
+        mNarrowPhaseAllocators[i].~SingleFrameAllocator();
+    }
+    if (mNarrowPhaseAllocators != nullptr) {
+        mMemoryManager.getPoolAllocator().release(mNarrowPhaseAllocators, mNbNarrowPhaseAllocators * sizeof(SingleFrameAllocator));
+    }
+}
+
 // Compute the collision detection
 void CollisionDetectionSystem::computeCollisionDetection() {
 
@@ -89,7 +118,7 @@ void CollisionDetectionSystem::computeCollisionDetection() {
     computeBroadPhase();
 
     // Compute the middle-phase collision detection
-    computeMiddlePhase(mNarrowPhaseInput, true);
+    computeMiddlePhase(mNarrowPhaseInput, true, true);
     
     // Compute the narrow-phase collision detection
     computeNarrowPhase();
@@ -231,7 +260,11 @@ void CollisionDetectionSystem::updateOverlappingPairs(const List<Pair<int32, int
 }
 
 // Compute the middle-phase collision detection
-void CollisionDetectionSystem::computeMiddlePhase(NarrowPhaseInput& narrowPhaseInput, bool needToReportContacts) {
+/// If the reuse of the cached contact points is allowed, the convex vs convex pairs whose relative
+/// pose has barely changed since their last narrow-phase test are not tested again. Their cached
+/// contact points are re-projected with the current transforms of their shapes instead.
+void CollisionDetectionSystem::computeMiddlePhase(NarrowPhaseInput& narrowPhaseInput, bool needToReportContacts,
+                                                  bool isCachedContactPointsReuseAllowed) {
 
     RP3D_PROFILE("CollisionDetectionSystem::computeMiddlePhase()", mProfiler);
 
@@ -241,6 +274,11 @@ void CollisionDetectionSystem::computeMiddlePhase(NarrowPhaseInput& narrowPhaseI
     // Remove the obsolete last frame collision infos and mark all the others as obsolete
     mOverlappingPairs.clearObsoleteLastFrameCollisionInfos();
 
+    const bool isCachedContactPointsReuseEnabled = isCachedContactPointsReuseAllowed &&
+                                                   mWorld->mConfig.narrowPhaseReuseLinearThreshold > decimal(0.0) &&
+                                                   mWorld->mConfig.narrowPhaseReuseAngularThreshold > decimal(0.0);
+    const decimal minCosHalfRotationAngle = std::cos(decimal(0.5) * mWorld->mConfig.narrowPhaseReuseAngularThreshold);
+
     // For each possible convex vs convex pair of bodies
     for (uint64 i=0; i < mOverlappingPairs.getNbConvexVsConvexPairs(); i++) {
 
@@ -266,12 +304,32 @@ void CollisionDetectionSystem::computeMiddlePhase(NarrowPhaseInput& narrowPhaseI
             const bool isCollider2Trigger = mCollidersComponents.mIsTrigger[collider2Index];
             const bool reportContacts = needToReportContacts && !isCollider1Trigger && !isCollider2Trigger;
 
-            // No middle-phase is necessary, simply create a narrow phase info
-            // for the narrow-phase collision detection
-            narrowPhaseInput.addNarrowPhaseTest(mOverlappingPairs.mPairIds[i], i, collider1Entity, collider2Entity, collisionShape1, collisionShape2,
-                                                      mCollidersComponents.mLocalToWorldTransforms[collider1Index],
-                                                      mCollidersComponents.mLocalToWorldTransforms[collider2Index],
-                                                      algorithmType, reportContacts, mMemoryManager.getSingleFrameAllocator());
+            const Transform& shape1ToWorldTransform = mCollidersComponents.mLocalToWorldTransforms[collider1Index];
+            const Transform& shape2ToWorldTransform = mCollidersComponents.mLocalToWorldTransforms[collider2Index];
+
+            // Check if the contact points cached during the last narrow-phase test of the pair can be reused
+            bool isUsingCachedContactPoints = false;
+            if (isCachedContactPointsReuseEnabled && reportContacts) {
+
+                LastFrameCollisionInfo* lastFrameInfo = mOverlappingPairs.addLastFrameInfoIfNecessary(i, collisionShape1->getId(),
+                                                                                                      collisionShape2->getId());
+                isUsingCachedContactPoints = canReuseCachedContactPoints(lastFrameInfo, shape1ToWorldTransform, shape2ToWorldTransform,
+                                                                         minCosHalfRotationAngle);
+                lastFrameInfo->isUsingCachedContactPoints = isUsingCachedContactPoints;
+            }
+
+            if (isUsingCachedContactPoints) {
+
+                narrowPhaseInput.addCachedContactPointsTest(mOverlappingPairs.mPairIds[i], i, collider1Entity, collider2Entity, collisionShape1,
+                                                            collisionShape2, shape1ToWorldTransform, shape2ToWorldTransform);
+            }
+            else {
+
+                // No middle-phase is necessary, simply create a narrow phase info
+                // for the narrow-phase collision detection
+                narrowPhaseInput.addNarrowPhaseTest(mOverlappingPairs.mPairIds[i], i, collider1Entity, collider2Entity, collisionShape1, collisionShape2,
+                                                    shape1ToWorldTransform, shape2ToWorldTransform, algorithmType, reportContacts);
+            }
 
             mOverlappingPairs.mCollidingInCurrentFrame[i] = false;
         }
@@ -335,7 +393,7 @@ void CollisionDetectionSystem::computeMiddlePhaseCollisionSnapshot(List<uint64>&
         narrowPhaseInput.addNarrowPhaseTest(pairId, pairIndex, collider1Entity, collider2Entity, collisionShape1, collisionShape2,
                                                   mCollidersComponents.mLocalToWorldTransforms[collider1Index],
                                                   mCollidersComponents.mLocalToWorldTransforms[collider2Index],
-                                                  algorithmType, reportContacts, mMemoryManager.getSingleFrameAllocator());
+                                                  algorithmType, reportContacts);
 
     }
 
@@ -392,11 +450,42 @@ void CollisionDetectionSystem::computeConvexVsConcaveMiddlePhase(uint64 pairInde
     AABB aabb;
     convexShape->computeAABB(aabb, convexToConcaveTransform);
 
-    // Compute the concave shape triangles that are overlapping with the convex mesh AABB
+    // If the convex shape AABB is not inside the AABB of the triangles cached for the pair anymore
+    // or if the data of the concave shape have been modified since the triangles have been cached
+    OverlappingTrianglesCache* trianglesCache = mOverlappingPairs.addOverlappingTrianglesCacheIfNecessary(pairIndex);
+    if (!trianglesCache->isValid || !trianglesCache->aabb.contains(aabb) ||
+        trianglesCache->concaveShapeDataVersion != concaveShape->getDataVersion()) {
+
+        // Compute the concave shape triangles that are overlapping with the inflated convex shape AABB
+        const Vector3 gap = aabb.getExtent() * OVERLAPPING_TRIANGLES_CACHE_AABB_INFLATE_PERCENTAGE;
+        trianglesCache->aabb = aabb;
+        trianglesCache->aabb.inflate(gap.x, gap.y, gap.z);
+        trianglesCache->concaveShapeDataVersion = concaveShape->getDataVersion();
+        trianglesCache->triangleVertices.clear();
+        trianglesCache->triangleVerticesNormals.clear();
+        trianglesCache->shapeIds.clear();
+        concaveShape->computeOverlappingTriangles(trianglesCache->aabb, trianglesCache->triangleVertices,
+                                                  trianglesCache->triangleVerticesNormals, trianglesCache->shapeIds, allocator);
+        trianglesCache->isValid = true;
+    }
+
+    // Select the cached triangles that are overlapping with the convex shape AABB
     List<Vector3> triangleVertices(allocator);
     List<Vector3> triangleVerticesNormals(allocator);
     List<uint> shapeIds(allocator);
-    concaveShape->computeOverlappingTriangles(aabb, triangleVertices, triangleVerticesNormals, shapeIds, allocator);
+    for (uint i=0; i < trianglesCache->shapeIds.size(); i++) {
+
+        if (aabb.testCollisionTriangleAABB(&(trianglesCache->triangleVertices[i * 3]))) {
+
+            triangleVertices.add(trianglesCache->triangleVertices[i * 3]);
+            triangleVertices.add(trianglesCache->triangleVertices[i * 3 + 1]);
+            triangleVertices.add(trianglesCache->triangleVertices[i * 3 + 2]);
+            triangleVerticesNormals.add(trianglesCache->triangleVerticesNormals[i * 3]);
+            triangleVerticesNormals.add(trianglesCache->triangleVerticesNormals[i * 3 + 1]);
+            triangleVerticesNormals.add(trianglesCache->triangleVerticesNormals[i * 3 + 2]);
+            shapeIds.add(trianglesCache->shapeIds[i]);
+        }
+    }
 
     assert(triangleVertices.size() == triangleVerticesNormals.size());
     assert(shapeIds.size() == triangleVertices.size() / 3);
@@ -407,13 +496,15 @@ void CollisionDetectionSystem::computeConvexVsConcaveMiddlePhase(uint64 pairInde
     const bool isCollider2Trigger = mCollidersComponents.mIsTrigger[collider2Index];
     const bool reportContacts = !isCollider1Trigger && !isCollider2Trigger;
 
+    if (shapeIds.size() == 0) return;
+
+    // Create the triangle collision shapes in a single block of memory owned by the narrow-phase input
+    TriangleShape* triangleShapes = narrowPhaseInput.createTriangleShapes(triangleVertices, triangleVerticesNormals, shapeIds);
+
     // For each overlapping triangle
     for (uint i=0; i < shapeIds.size(); i++)
     {
-        // Create a triangle collision shape (the allocated memory for the TriangleShape will be released in the
-        // destructor of the corresponding NarrowPhaseInfo.
-        TriangleShape* triangleShape = new (allocator.allocate(sizeof(TriangleShape)))
-                                       TriangleShape(&(triangleVertices[i * 3]), &(triangleVerticesNormals[i * 3]), shapeIds[i], allocator);
+        TriangleShape* triangleShape = &(triangleShapes[i]);
 
     #ifdef IS_RP3D_PROFILING_ENABLED
 
@@ -427,7 +518,7 @@ void CollisionDetectionSystem::computeConvexVsConcaveMiddlePhase(uint64 pairInde
         narrowPhaseInput.addNarrowPhaseTest(mOverlappingPairs.mPairIds[pairIndex], pairIndex, collider1, collider2, isShape1Convex ? convexShape : triangleShape,
                                                 isShape1Convex ? triangleShape : convexShape,
                                                 shape1LocalToWorldTransform, shape2LocalToWorldTransform,
-                                                mOverlappingPairs.mNarrowPhaseAlgorithmType[pairIndex], reportContacts, allocator);
+                                                mOverlappingPairs.mNarrowPhaseAlgorithmType[pairIndex], reportContacts);
     }
 }
 
@@ -444,6 +535,9 @@ bool CollisionDetectionSystem::testNarrowPhaseCollision(NarrowPhaseInput& narrow
     SphereVsConvexPolyhedronAlgorithm* sphereVsConvexPolyAlgo = mCollisionDispatch.getSphereVsConvexPolyhedronAlgorithm();
     CapsuleVsConvexPolyhedronAlgorithm* capsuleVsConvexPolyAlgo = mCollisionDispatch.getCapsuleVsConvexPolyhedronAlgorithm();
     ConvexPolyhedronVsConvexPolyhedronAlgorithm* convexPolyVsConvexPolyAlgo = mCollisionDispatch.getConvexPolyhedronVsConvexPolyhedronAlgorithm();
+    BoxVsBoxAlgorithm* boxVsBoxAlgo = mCollisionDispatch.getBoxVsBoxAlgorithm();
+    SphereVsBoxAlgorithm* sphereVsBoxAlgo = mCollisionDispatch.getSphereVsBoxAlgorithm();
+    CapsuleVsBoxAlgorithm* capsuleVsBoxAlgo = mCollisionDispatch.getCapsuleVsBoxAlgorithm();
 
     // get the narrow-phase batches to test for collision for contacts
     SphereVsSphereNarrowPhaseInfoBatch& sphereVsSphereBatchContacts = narrowPhaseInput.getSphereVsSphereBatch();
@@ -452,31 +546,223 @@ bool CollisionDetectionSystem::testNarrowPhaseCollision(NarrowPhaseInput& narrow
     NarrowPhaseInfoBatch& sphereVsConvexPolyhedronBatchContacts = narrowPhaseInput.getSphereVsConvexPolyhedronBatch();
     NarrowPhaseInfoBatch& capsuleVsConvexPolyhedronBatchContacts = narrowPhaseInput.getCapsuleVsConvexPolyhedronBatch();
     NarrowPhaseInfoBatch& convexPolyhedronVsConvexPolyhedronBatchContacts = narrowPhaseInput.getConvexPolyhedronVsConvexPolyhedronBatch();
+    NarrowPhaseInfoBatch& boxVsBoxBatchContacts = narrowPhaseInput.getBoxVsBoxBatch();
+    NarrowPhaseInfoBatch& sphereVsBoxBatchContacts = narrowPhaseInput.getSphereVsBoxBatch();
+    NarrowPhaseInfoBatch& capsuleVsBoxBatchContacts = narrowPhaseInput.getCapsuleVsBoxBatch();
+    NarrowPhaseInfoBatch& cachedContactPointsBatch = narrowPhaseInput.getCachedContactPointsBatch();
+
+    // Reset the single frame allocators of the narrow-phase tasks (the contact points of the
+    // previous tests have all been released when their batches were processed)
+    for (uint32 i=0; i < mNbNarrowPhaseAllocators; i++) {
+        mNarrowPhaseAllocators[i].reset();
+    }
 
     // Compute the narrow-phase collision detection for each kind of collision shapes (for contacts)
-    if (sphereVsSphereBatchContacts.getNbObjects() > 0) {
-        contactFound |= sphereVsSphereAlgo->testCollision(sphereVsSphereBatchContacts, 0, sphereVsSphereBatchContacts.getNbObjects(), allocator);
-    }
-    if (sphereVsCapsuleBatchContacts.getNbObjects() > 0) {
-        contactFound |= sphereVsCapsuleAlgo->testCollision(sphereVsCapsuleBatchContacts, 0, sphereVsCapsuleBatchContacts.getNbObjects(), allocator);
-    }
-    if (capsuleVsCapsuleBatchContacts.getNbObjects() > 0) {
-        contactFound |= capsuleVsCapsuleAlgo->testCollision(capsuleVsCapsuleBatchContacts, 0, capsuleVsCapsuleBatchContacts.getNbObjects(), allocator);
-    }
-    if (sphereVsConvexPolyhedronBatchContacts.getNbObjects() > 0) {
-        contactFound |= sphereVsConvexPolyAlgo->testCollision(sphereVsConvexPolyhedronBatchContacts, 0, sphereVsConvexPolyhedronBatchContacts.getNbObjects(), clipWithPreviousAxisIfStillColliding, allocator);
+    contactFound |= testNarrowPhaseBatchCollision(sphereVsSphereBatchContacts, allocator,
+                    [&](uint32 batchStartIndex, uint32 batchNbItems, MemoryAllocator& batchAllocator) {
+        return sphereVsSphereAlgo->testCollision(sphereVsSphereBatchContacts, batchStartIndex, batchNbItems, batchAllocator);
+    });
+    contactFound |= testNarrowPhaseBatchCollision(sphereVsCapsuleBatchContacts, allocator,
+                    [&](uint32 batchStartIndex, uint32 batchNbItems, MemoryAllocator& batchAllocator) {
+        return sphereVsCapsuleAlgo->testCollision(sphereVsCapsuleBatchContacts, batchStartIndex, batchNbItems, batchAllocator);
+    });
+    contactFound |= testNarrowPhaseBatchCollision(capsuleVsCapsuleBatchContacts, allocator,
+                    [&](uint32 batchStartIndex, uint32 batchNbItems, MemoryAllocator& batchAllocator) {
+        return capsuleVsCapsuleAlgo->testCollision(capsuleVsCapsuleBatchContacts, batchStartIndex, batchNbItems, batchAllocator);
+    });
+    contactFound |= testNarrowPhaseBatchCollision(sphereVsConvexPolyhedronBatchContacts, allocator,
+                    [&](uint32 batchStartIndex, uint32 batchNbItems, MemoryAllocator& batchAllocator) {
+        return sphereVsConvexPolyAlgo->testCollision(sphereVsConvexPolyhedronBatchContacts, batchStartIndex, batchNbItems,
+                                                     clipWithPreviousAxisIfStillColliding, batchAllocator);
+    });
+    contactFound |= testNarrowPhaseBatchCollision(capsuleVsConvexPolyhedronBatchContacts, allocator,
+                    [&](uint32 batchStartIndex, uint32 batchNbItems, MemoryAllocator& batchAllocator) {
+        return capsuleVsConvexPolyAlgo->testCollision(capsuleVsConvexPolyhedronBatchContacts, batchStartIndex, batchNbItems,
+                                                      clipWithPreviousAxisIfStillColliding, batchAllocator);
+    });
+    contactFound |= testNarrowPhaseBatchCollision(convexPolyhedronVsConvexPolyhedronBatchContacts, allocator,
+                    [&](uint32 batchStartIndex, uint32 batchNbItems, MemoryAllocator& batchAllocator) {
+        return convexPolyVsConvexPolyAlgo->testCollision(convexPolyhedronVsConvexPolyhedronBatchContacts, batchStartIndex, batchNbItems,
+                                                         clipWithPreviousAxisIfStillColliding, batchAllocator);
+    });
+    contactFound |= testNarrowPhaseBatchCollision(boxVsBoxBatchContacts, allocator,
+                    [&](uint32 batchStartIndex, uint32 batchNbItems, MemoryAllocator&) {
+        return boxVsBoxAlgo->testCollision(boxVsBoxBatchContacts, batchStartIndex, batchNbItems);
+    });
+    contactFound |= testNarrowPhaseBatchCollision(sphereVsBoxBatchContacts, allocator,
+                    [&](uint32 batchStartIndex, uint32 batchNbItems, MemoryAllocator&) {
+        return sphereVsBoxAlgo->testCollision(sphereVsBoxBatchContacts, batchStartIndex, batchNbItems);
+    });
+    contactFound |= testNarrowPhaseBatchCollision(capsuleVsBoxBatchContacts, allocator,
+                    [&](uint32 batchStartIndex, uint32 batchNbItems, MemoryAllocator&) {
+        return capsuleVsBoxAlgo->testCollision(capsuleVsBoxBatchContacts, batchStartIndex, batchNbItems);
+    });
+
+    // Re-project the cached contact points of the pairs that are not tested again
+    contactFound |= testNarrowPhaseBatchCollision(cachedContactPointsBatch, allocator,
+                    [&](uint32 batchStartIndex, uint32 batchNbItems, MemoryAllocator&) {
+        return projectCachedContactPoints(cachedContactPointsBatch, batchStartIndex, batchNbItems);
+    });
+
+    return contactFound;
+}
+
+// Execute a narrow-phase collision detection algorithm on a batch
+/// If the world has a task scheduler, the batch is split into chunks of consecutive objects
+/// that are tested by several threads. A chunk only writes the results and contact points of its own
+/// objects and allocates its temporary memory with its own single frame allocator. The
+/// results stay at the index of their object in the batch and are therefore processed in the
+/// same order as with a single thread.
+bool CollisionDetectionSystem::testNarrowPhaseBatchCollision(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, MemoryAllocator& allocator,
+                                                             const NarrowPhaseBatchTest& batchTest) {
+
+    const uint32 nbObjects = narrowPhaseInfoBatch.getNbObjects();
+    if (nbObjects == 0) return false;
+
+    // The narrow-phase algorithms are profiled and the profiler cannot be used by several threads
+#ifndef IS_RP3D_PROFILING_ENABLED
+
+    if (mNbNarrowPhaseAllocators > 1 && nbObjects > NARROW_PHASE_GRAIN_SIZE) {
+
+        // Compute the chunks of objects (there is at most one chunk per allocator)
+        uint32 nbChunks = std::min((nbObjects + NARROW_PHASE_GRAIN_SIZE - 1) / NARROW_PHASE_GRAIN_SIZE, mNbNarrowPhaseAllocators);
+        const uint32 nbObjectsPerChunk = (nbObjects + nbChunks - 1) / nbChunks;
+        nbChunks = (nbObjects + nbObjectsPerChunk - 1) / nbObjectsPerChunk;
+
+        // Each chunk writes whether it has found a contact at its own index
+        List<bool> isContactFoundInChunks(mMemoryManager.getPoolAllocator(), nbChunks);
+        for (uint32 i=0; i < nbChunks; i++) {
+            isContactFoundInChunks.add(false);
+        }
+
+        mTaskScheduler->parallelFor(nbChunks, 1, [this, &batchTest, &isContactFoundInChunks, nbObjects, nbObjectsPerChunk](uint32 startChunk, uint32 endChunk) {
+
+            for (uint32 c=startChunk; c < endChunk; c++) {
+
+                const uint32 batchStartIndex = c * nbObjectsPerChunk;
+                const uint32 batchNbItems = std::min(nbObjectsPerChunk, nbObjects - batchStartIndex);
+                isContactFoundInChunks[c] = batchTest(batchStartIndex, batchNbItems, mNarrowPhaseAllocators[c]);
+            }
+        });
+
+        bool contactFound = false;
+        for (uint32 i=0; i < nbChunks; i++) {
+            contactFound |= isContactFoundInChunks[i];
+        }
+
+        return contactFound;
     }
-    if (capsuleVsConvexPolyhedronBatchContacts.getNbObjects() > 0) {
-        contactFound |= capsuleVsConvexPolyAlgo->testCollision(capsuleVsConvexPolyhedronBatchContacts, 0, capsuleVsConvexPolyhedronBatchContacts.getNbObjects(), clipWithPreviousAxisIfStillColliding, allocator);
+
+#endif
+
+    return batchTest(0, nbObjects, allocator);
+}
+
+// Return true if the cached contact points of two shapes can be reused with their current transforms
+/// This is the case if the contact points of the last narrow-phase test of the shapes are cached and if
+/// the relative translation and rotation of the shapes since this test are below the thresholds of the world
+bool CollisionDetectionSystem::canReuseCachedContactPoints(const LastFrameCollisionInfo* lastFrameInfo, const Transform& shape1ToWorldTransform,
+                                                           const Transform& shape2ToWorldTransform, decimal minCosHalfRotationAngle) const {
+
+    if (!lastFrameInfo->hasCachedContactPoints) return false;
+
+    const CachedContactPoints* cachedContactPoints = lastFrameInfo->cachedContactPoints;
+    assert(cachedContactPoints != nullptr);
+
+    const Transform shape2ToShape1Transform = shape1ToWorldTransform.getInverse() * shape2ToWorldTransform;
+
+    // Check the relative translation since the last narrow-phase test
+    const decimal linearThreshold = mWorld->mConfig.narrowPhaseReuseLinearThreshold;
+    const Vector3 translation = shape2ToShape1Transform.getPosition() - cachedContactPoints->shape2ToShape1Transform.getPosition();
+    if (translation.lengthSquare() >= linearThreshold * linearThreshold) return false;
+
+    // Check the relative rotation since the last narrow-phase test (the cosine of half the rotation
+    // angle is the absolute value of the real part of the rotation quaternion)
+    const Quaternion rotation = cachedContactPoints->shape2ToShape1Transform.getOrientation().getInverse() *
+                                shape2ToShape1Transform.getOrientation();
+    return std::abs(rotation.w) > minCosHalfRotationAngle;
+}
+
+// Cache the contact points of an object of a batch after its narrow-phase collision detection test
+/// The contact points are cached in the last frame collision info of the two shapes. The contact
+/// normals are stored in the local-space of the first shape so that they follow its rotation.
+void CollisionDetectionSystem::cacheContactPoints(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchIndex) {
+
+    LastFrameCollisionInfo* lastFrameInfo = narrowPhaseInfoBatch.lastFrameCollisionInfos[batchIndex];
+    const uint8 nbContactPoints = narrowPhaseInfoBatch.nbContactPoints[batchIndex];
+
+    lastFrameInfo->hasCachedContactPoints = narrowPhaseInfoBatch.isColliding[batchIndex] && narrowPhaseInfoBatch.reportContacts[batchIndex] &&
+                                            nbContactPoints > 0 && nbContactPoints <= NB_MAX_CACHED_CONTACT_POINTS;
+    if (!lastFrameInfo->hasCachedContactPoints) return;
+
+    CachedContactPoints* cachedContactPoints = mOverlappingPairs.addCachedContactPointsIfNecessary(lastFrameInfo);
+
+    const Transform worldToShape1Transform = narrowPhaseInfoBatch.shape1ToWorldTransforms[batchIndex].getInverse();
+    cachedContactPoints->shape2ToShape1Transform = worldToShape1Transform * narrowPhaseInfoBatch.shape2ToWorldTransforms[batchIndex];
+
+    const ContactPointInfo* contactPoints = narrowPhaseInfoBatch.getContactPoints(batchIndex);
+
+    cachedContactPoints->nbContactPoints = nbContactPoints;
+    for (uint p=0; p < nbContactPoints; p++) {
+
+        cachedContactPoints->contactNormals[p] = worldToShape1Transform.getOrientation() * contactPoints[p].normal;
+        cachedContactPoints->localPoints1[p] = contactPoints[p].localPoint1;
+        cachedContactPoints->localPoints2[p] = contactPoints[p].localPoint2;
+        cachedContactPoints->penetrationDepths[p] = contactPoints[p].penetrationDepth;
     }
-    if (convexPolyhedronVsConvexPolyhedronBatchContacts.getNbObjects() > 0) {
-        contactFound |= convexPolyVsConvexPolyAlgo->testCollision(convexPolyhedronVsConvexPolyhedronBatchContacts, 0, convexPolyhedronVsConvexPolyhedronBatchContacts.getNbObjects(), clipWithPreviousAxisIfStillColliding, allocator);
+}
+
+// Re-project the cached contact points of the objects of a batch with the current transforms of their shapes
+/// The contact points are attached to their shapes. Therefore, the local contact points and the contact
+/// normal (in the local-space of the first shape) do not change. The penetration depth of a contact point
+/// is corrected with the displacement of the contact point of the second shape along the normal since the
+/// last narrow-phase test. The contact points that are not penetrating anymore are discarded.
+bool CollisionDetectionSystem::projectCachedContactPoints(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint batchStartIndex, uint batchNbItems) {
+
+    bool isCollisionFound = false;
+
+    for (uint batchIndex = batchStartIndex; batchIndex < batchStartIndex + batchNbItems; batchIndex++) {
+
+        const LastFrameCollisionInfo* lastFrameInfo = narrowPhaseInfoBatch.lastFrameCollisionInfos[batchIndex];
+
+        assert(lastFrameInfo->hasCachedContactPoints);
+        assert(narrowPhaseInfoBatch.reportContacts[batchIndex]);
+        assert(narrowPhaseInfoBatch.nbContactPoints[batchIndex] == 0);
+
+        const CachedContactPoints* cachedContactPoints = lastFrameInfo->cachedContactPoints;
+        assert(cachedContactPoints != nullptr);
+
+        const Transform& shape1ToWorldTransform = narrowPhaseInfoBatch.shape1ToWorldTransforms[batchIndex];
+        const Transform shape2ToShape1Transform = shape1ToWorldTransform.getInverse() * narrowPhaseInfoBatch.shape2ToWorldTransforms[batchIndex];
+
+        for (uint p=0; p < cachedContactPoints->nbContactPoints; p++) {
+
+            const Vector3& normal = cachedContactPoints->contactNormals[p];
+            const Vector3& localPoint2 = cachedContactPoints->localPoints2[p];
+
+            // Displacement of the contact point of the second shape (in the local-space of the first shape)
+            const Vector3 displacement = shape2ToShape1Transform * localPoint2 - cachedContactPoints->shape2ToShape1Transform * localPoint2;
+            const decimal penetrationDepth = cachedContactPoints->penetrationDepths[p] - displacement.dot(normal);
+
+            if (penetrationDepth > decimal(0.0)) {
+                narrowPhaseInfoBatch.addContactPoint(batchIndex, shape1ToWorldTransform.getOrientation() * normal, penetrationDepth,
+                                                     cachedContactPoints->localPoints1[p], localPoint2);
+            }
+        }
+
+        if (narrowPhaseInfoBatch.nbContactPoints[batchIndex] > 0) {
+            narrowPhaseInfoBatch.isColliding[batchIndex] = true;
+            isCollisionFound = true;
+        }
     }
 
-    return contactFound;
+    return isCollisionFound;
 }
 
 // Process the potential contacts after narrow-phase collision detection
+/// The batches are processed one after the other in the order of their objects. Therefore, the
+/// contact pairs, manifolds and points are created in the same order whether the narrow-phase
+/// tests have been executed by one or several threads.
 void CollisionDetectionSystem::processAllPotentialContacts(NarrowPhaseInput& narrowPhaseInput, bool updateLastFrameInfo,
                                                      List<ContactPointInfo>& potentialContactPoints,
                                                      Map<uint64, uint>* mapPairIdToContactPairIndex,
@@ -494,6 +780,10 @@ void CollisionDetectionSystem::processAllPotentialContacts(NarrowPhaseInput& nar
     NarrowPhaseInfoBatch& sphereVsConvexPolyhedronBatch = narrowPhaseInput.getSphereVsConvexPolyhedronBatch();
     NarrowPhaseInfoBatch& capsuleVsConvexPolyhedronBatch = narrowPhaseInput.getCapsuleVsConvexPolyhedronBatch();
     NarrowPhaseInfoBatch& convexPolyhedronVsConvexPolyhedronBatch = narrowPhaseInput.getConvexPolyhedronVsConvexPolyhedronBatch();
+    NarrowPhaseInfoBatch& boxVsBoxBatch = narrowPhaseInput.getBoxVsBoxBatch();
+    NarrowPhaseInfoBatch& sphereVsBoxBatch = narrowPhaseInput.getSphereVsBoxBatch();
+    NarrowPhaseInfoBatch& capsuleVsBoxBatch = narrowPhaseInput.getCapsuleVsBoxBatch();
+    NarrowPhaseInfoBatch& cachedContactPointsBatch = narrowPhaseInput.getCachedContactPointsBatch();
 
     // Process the potential contacts
     processPotentialContacts(sphereVsSphereBatch, updateLastFrameInfo, potentialContactPoints, mapPairIdToContactPairIndex,
@@ -508,6 +798,14 @@ void CollisionDetectionSystem::processAllPotentialContacts(NarrowPhaseInput& nar
                              potentialContactManifolds, contactPairs, mapBodyToContactPairs);
     processPotentialContacts(convexPolyhedronVsConvexPolyhedronBatch, updateLastFrameInfo, potentialContactPoints, mapPairIdToContactPairIndex,
                              potentialContactManifolds, contactPairs, mapBodyToContactPairs);
+    processPotentialContacts(boxVsBoxBatch, updateLastFrameInfo, potentialContactPoints, mapPairIdToContactPairIndex,
+                             potentialContactManifolds, contactPairs, mapBodyToContactPairs);
+    processPotentialContacts(sphereVsBoxBatch, updateLastFrameInfo, potentialContactPoints, mapPairIdToContactPairIndex,
+                             potentialContactManifolds, contactPairs, mapBodyToContactPairs);
+    processPotentialContacts(capsuleVsBoxBatch, updateLastFrameInfo, potentialContactPoints, mapPairIdToContactPairIndex,
+                             potentialContactManifolds, contactPairs, mapBodyToContactPairs);
+    processPotentialContacts(cachedContactPointsBatch, updateLastFrameInfo, potentialContactPoints, mapPairIdToContactPairIndex,
+                             potentialContactManifolds, contactPairs, mapBodyToContactPairs);
 }
 
 // Compute the narrow-phase collision detection
@@ -576,6 +874,9 @@ void CollisionDetectionSystem::computeOverlapSnapshotContactPairs(NarrowPhaseInp
     NarrowPhaseInfoBatch& sphereVsConvexPolyhedronBatch = narrowPhaseInput.getSphereVsConvexPolyhedronBatch();
     NarrowPhaseInfoBatch& capsuleVsConvexPolyhedronBatch = narrowPhaseInput.getCapsuleVsConvexPolyhedronBatch();
     NarrowPhaseInfoBatch& convexPolyhedronVsConvexPolyhedronBatch = narrowPhaseInput.getConvexPolyhedronVsConvexPolyhedronBatch();
+    NarrowPhaseInfoBatch& boxVsBoxBatch = narrowPhaseInput.getBoxVsBoxBatch();
+    NarrowPhaseInfoBatch& sphereVsBoxBatch = narrowPhaseInput.getSphereVsBoxBatch();
+    NarrowPhaseInfoBatch& capsuleVsBoxBatch = narrowPhaseInput.getCapsuleVsBoxBatch();
 
     // Process the potential contacts
     computeOverlapSnapshotContactPairs(sphereVsSphereBatch, contactPairs, setOverlapContactPairId);
@@ -584,6 +885,9 @@ void CollisionDetectionSystem::computeOverlapSnapshotContactPairs(NarrowPhaseInp
     computeOverlapSnapshotContactPairs(sphereVsConvexPolyhedronBatch, contactPairs, setOverlapContactPairId);
     computeOverlapSnapshotContactPairs(capsuleVsConvexPolyhedronBatch, contactPairs, setOverlapContactPairId);
     computeOverlapSnapshotContactPairs(convexPolyhedronVsConvexPolyhedronBatch, contactPairs, setOverlapContactPairId);
+    computeOverlapSnapshotContactPairs(boxVsBoxBatch, contactPairs, setOverlapContactPairId);
+    computeOverlapSnapshotContactPairs(sphereVsBoxBatch, contactPairs, setOverlapContactPairId);
+    computeOverlapSnapshotContactPairs(capsuleVsBoxBatch, contactPairs, setOverlapContactPairId);
 }
 
 // Notify that the overlapping pairs where a given collider is involved need to be tested for overlap
@@ -599,6 +903,19 @@ void CollisionDetectionSystem::notifyOverlappingPairsToTestOverlap(Collider* col
     }
 }
 
+// Prevent the cached contact points of the overlapping pairs of a given collider from being reused
+/// This is necessary when the size of the collision shape of the collider has changed because the
+/// cached contact points have been computed with the previous size.
+void CollisionDetectionSystem::clearCachedContactPoints(Collider* collider) {
+
+    // Get the overlapping pairs involved with this collider
+    List<uint64>& overlappingPairs = mCollidersComponents.getOverlappingPairs(collider->getEntity());
+
+    for (uint i=0; i < overlappingPairs.size(); i++) {
+        mOverlappingPairs.clearCachedContactPoints(overlappingPairs[i]);
+    }
+}
+
 // Convert the potential overlapping bodies for the testOverlap() methods
 void CollisionDetectionSystem::computeOverlapSnapshotContactPairs(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, List<ContactPair>& contactPairs,
                                                            Set<uint64>& setOverlapContactPairId) const {
@@ -977,6 +1294,55 @@ void CollisionDetectionSystem::raycast(RaycastCallback* raycastCallback,
     mBroadPhaseSystem.raycast(ray, rayCastTest, raycastWithCategoryMaskBits);
 }
 
+// Ray casting method for a batch of rays that returns the closest hit of each ray
+/// The rays are cast as packets of four consecutive rays. Therefore, the batch is faster
+/// when consecutive rays are coherent (similar origins and directions). The packets are
+/// split among several threads when the world has a task scheduler (except when the
+/// profiler is enabled because it is not thread-safe).
+void CollisionDetectionSystem::raycast(const Ray* rays, uint32 nbRays, RaycastInfo* outRaycastInfos,
+                                       unsigned short raycastWithCategoryMaskBits) const {
+
+    RP3D_PROFILE("CollisionDetectionSystem::raycast()", mProfiler);
+
+    const uint32 nbPackets = (nbRays + RayPacket::MAX_NB_RAYS - 1) / RayPacket::MAX_NB_RAYS;
+
+    auto raycastPackets = [this, rays, nbRays, outRaycastInfos, raycastWithCategoryMaskBits](uint32 startPacket, uint32 endPacket) {
+
+        // Stack used to traverse the broad-phase and reused between the packets
+        Stack<int32> stack(mMemoryManager.getPoolAllocator(), 64);
+
+        for (uint32 p=startPacket; p < endPacket; p++) {
+
+            const uint32 firstRay = p * RayPacket::MAX_NB_RAYS;
+            const uint32 nbPacketRays = std::min(nbRays - firstRay, RayPacket::MAX_NB_RAYS);
+
+            // Reset the hits of the rays of the packet
+            for (uint32 i=firstRay; i < firstRay + nbPacketRays; i++) {
+                outRaycastInfos[i].hitFraction = rays[i].maxFraction;
+                outRaycastInfos[i].meshSubpart = -1;
+                outRaycastInfos[i].triangleIndex = -1;
+                outRaycastInfos[i].body = nullptr;
+                outRaycastInfos[i].collider = nullptr;
+            }
+
+            RayPacket packet(rays + firstRay, nbPacketRays);
+            RaycastBatchTest raycastBatchTest(outRaycastInfos + firstRay);
+            mBroadPhaseSystem.raycast(packet, stack, raycastBatchTest, raycastWithCategoryMaskBits);
+        }
+    };
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+    raycastPackets(0, nbPackets);
+
+#else
+
+    parallelFor(mTaskScheduler, nbPackets, RAYCAST_BATCH_GRAIN_SIZE, raycastPackets);
+
+#endif
+
+}
+
 // Convert the potential contact into actual contacts
 void CollisionDetectionSystem::processPotentialContacts(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, bool updateLastFrameInfo,
                                                         List<ContactPointInfo>& potentialContactPoints,
@@ -987,18 +1353,36 @@ void CollisionDetectionSystem::processPotentialContacts(NarrowPhaseInfoBatch& na
 
     RP3D_PROFILE("CollisionDetectionSystem::processPotentialContacts()", mProfiler);
 
+    const bool isCachedContactPointsReuseEnabled = mWorld->mConfig.narrowPhaseReuseLinearThreshold > decimal(0.0) &&
+                                                   mWorld->mConfig.narrowPhaseReuseAngularThreshold > decimal(0.0);
+
     // For each narrow phase info object
     for(uint i=0; i < narrowPhaseInfoBatch.getNbObjects(); i++) {
 
+        const uint64 pairId = narrowPhaseInfoBatch.overlappingPairIds[i];
+        const uint64 pairIndex = mOverlappingPairs.mMapPairIdToPairIndex[pairId];
+
         if (updateLastFrameInfo) {
-            narrowPhaseInfoBatch.lastFrameCollisionInfos[i]->wasColliding = narrowPhaseInfoBatch.isColliding[i];
+
+            LastFrameCollisionInfo* lastFrameInfo = narrowPhaseInfoBatch.lastFrameCollisionInfos[i];
+
+            lastFrameInfo->wasColliding = narrowPhaseInfoBatch.isColliding[i];
 
             // The previous frame collision info is now valid
-            narrowPhaseInfoBatch.lastFrameCollisionInfos[i]->isValid = true;
-        }
+            lastFrameInfo->isValid = true;
 
-        const uint64 pairId = narrowPhaseInfoBatch.overlappingPairIds[i];
-        const uint64 pairIndex = mOverlappingPairs.mMapPairIdToPairIndex[pairId];
+            // If the cached contact points have been reused, they stay cached (with the transforms of the
+            // last narrow-phase test) as long as the shapes are colliding
+            if (lastFrameInfo->isUsingCachedContactPoints) {
+                lastFrameInfo->hasCachedContactPoints = narrowPhaseInfoBatch.isColliding[i];
+                lastFrameInfo->isUsingCachedContactPoints = false;
+            }
+            else if (isCachedContactPointsReuseEnabled && pairIndex < mOverlappingPairs.getConvexVsConcavePairsStartIndex()) {
+
+                // Cache the contact points of the convex vs convex pairs
+                cacheContactPoints(narrowPhaseInfoBatch, i);
+            }
+        }
 
         // If the two colliders are colliding
         if (narrowPhaseInfoBatch.isColliding[i]) {
@@ -1063,9 +1447,10 @@ void CollisionDetectionSystem::processPotentialContacts(NarrowPhaseInfoBatch& na
             assert(pairContact != nullptr);
 
             // Add the potential contacts
-            for (uint j=0; j < narrowPhaseInfoBatch.contactPoints[i].size(); j++) {
+            const ContactPointInfo* contactPoints = narrowPhaseInfoBatch.getContactPoints(i);
+            for (uint j=0; j < narrowPhaseInfoBatch.nbContactPoints[i]; j++) {
 
-                const ContactPointInfo& contactPoint = *(narrowPhaseInfoBatch.contactPoints[i][j]);
+                const ContactPointInfo& contactPoint = contactPoints[j];
 
                 // Add the contact point to the list of potential contact points
                 const uint contactPointIndex = static_cast<uint>(potentialContactPoints.size());
@@ -1488,7 +1873,7 @@ void CollisionDetectionSystem::testOverlap(OverlapCallback& callback) {
     computeBroadPhase();
 
     // Compute the middle-phase collision detection
-    computeMiddlePhase(narrowPhaseInput, false);
+    computeMiddlePhase(narrowPhaseInput, false, false);
 
     // Compute the narrow-phase collision detection and report overlapping shapes
     computeNarrowPhaseOverlapSnapshot(narrowPhaseInput, &callback);
@@ -1572,7 +1957,7 @@ void CollisionDetectionSystem::testCollision(CollisionCallback& callback) {
     computeBroadPhase();
 
     // Compute the middle-phase collision detection
-    computeMiddlePhase(narrowPhaseInput, true);
+    computeMiddlePhase(narrowPhaseInput, true, false);
 
     // Compute the narrow-phase collision detection and report contacts
     computeNarrowPhaseCollisionSnapshot(narrowPhaseInput, callback);
@@ -32,9 +32,10 @@ using namespace reactphysics3d;
 
 // Constructor
 DynamicsSystem::DynamicsSystem(PhysicsWorld& world, CollisionBodyComponents& collisionBodyComponents, RigidBodyComponents& rigidBodyComponents,
-                               TransformComponents& transformComponents, ColliderComponents& colliderComponents, bool& isGravityEnabled, Vector3& gravity)
+                               TransformComponents& transformComponents, ColliderComponents& colliderComponents, bool& isGravityEnabled, Vector3& gravity,
+                               TaskScheduler* taskScheduler)
               :mWorld(world), mCollisionBodyComponents(collisionBodyComponents), mRigidBodyComponents(rigidBodyComponents), mTransformComponents(transformComponents), mColliderComponents(colliderComponents),
-               mIsGravityEnabled(isGravityEnabled), mGravity(gravity) {
+               mIsGravityEnabled(isGravityEnabled), mGravity(gravity), mTaskScheduler(taskScheduler) {
 
 }
 
@@ -47,26 +48,31 @@ void DynamicsSystem::integrateRigidBodiesPositions(decimal timeStep, bool isSpli
 
     const decimal isSplitImpulseFactor = isSplitImpulseActive ? decimal(1.0) : decimal(0.0);
 
-    for (uint32 i=0; i < mRigidBodyComponents.getNbEnabledComponents(); i++) {
+    // Each body only writes its own data so the bodies can be integrated in parallel
+    parallelFor(mTaskScheduler, mRigidBodyComponents.getNbEnabledComponents(), PARALLEL_FOR_GRAIN_SIZE,
+                [this, timeStep, isSplitImpulseFactor](uint32 startIndex, uint32 endIndex) {
 
-        // Get the constrained velocity
-        Vector3 newLinVelocity = mRigidBodyComponents.mConstrainedLinearVelocities[i];
-        Vector3 newAngVelocity = mRigidBodyComponents.mConstrainedAngularVelocities[i];
+        for (uint32 i=startIndex; i < endIndex; i++) {
 
-        // Add the split impulse velocity from Contact Solver (only used
-        // to update the position)
-        newLinVelocity += isSplitImpulseFactor * mRigidBodyComponents.mSplitLinearVelocities[i];
-        newAngVelocity += isSplitImpulseFactor * mRigidBodyComponents.mSplitAngularVelocities[i];
+            // Get the constrained velocity
+            Vector3 newLinVelocity = mRigidBodyComponents.mConstrainedLinearVelocities[i];
+            Vector3 newAngVelocity = mRigidBodyComponents.mConstrainedAngularVelocities[i];
 
-        // Get current position and orientation of the body
-        const Vector3& currentPosition = mRigidBodyComponents.mCentersOfMassWorld[i];
-        const Quaternion& currentOrientation = mTransformComponents.getTransform(mRigidBodyComponents.mBodiesEntities[i]).getOrientation();
+            // Add the split impulse velocity from Contact Solver (only used
+            // to update the position)
+            newLinVelocity += isSplitImpulseFactor * mRigidBodyComponents.mSplitLinearVelocities[i];
+            newAngVelocity += isSplitImpulseFactor * mRigidBodyComponents.mSplitAngularVelocities[i];
 
-        // Update the new constrained position and orientation of the body
-        mRigidBodyComponents.mConstrainedPositions[i] = currentPosition + newLinVelocity * timeStep;
-        mRigidBodyComponents.mConstrainedOrientations[i] = currentOrientation + Quaternion(0, newAngVelocity) *
-                                                           currentOrientation * decimal(0.5) * timeStep;
-    }
+            // Get current position and orientation of the body
+            const Vector3& currentPosition = mRigidBodyComponents.mCentersOfMassWorld[i];
+            const Quaternion& currentOrientation = mTransformComponents.getTransform(mRigidBodyComponents.mBodiesEntities[i]).getOrientation();
+
+            // Update the new constrained position and orientation of the body
+            mRigidBodyComponents.mConstrainedPositions[i] = currentPosition + newLinVelocity * timeStep;
+            mRigidBodyComponents.mConstrainedOrientations[i] = currentOrientation + Quaternion(0, newAngVelocity) *
+                                                               currentOrientation * decimal(0.5) * timeStep;
+        }
+    });
 }
 
 // Update the postion/orientation of the bodies
@@ -74,36 +80,44 @@ void DynamicsSystem::updateBodiesState() {
 
     RP3D_PROFILE("DynamicsSystem::updateBodiesState()", mProfiler);
 
-    for (uint32 i=0; i < mRigidBodyComponents.getNbEnabledComponents(); i++) {
+    parallelFor(mTaskScheduler, mRigidBodyComponents.getNbEnabledComponents(), PARALLEL_FOR_GRAIN_SIZE,
+                [this](uint32 startIndex, uint32 endIndex) {
 
-        // Update the linear and angular velocity of the body
-        mRigidBodyComponents.mLinearVelocities[i] = mRigidBodyComponents.mConstrainedLinearVelocities[i];
-        mRigidBodyComponents.mAngularVelocities[i] = mRigidBodyComponents.mConstrainedAngularVelocities[i];
+        for (uint32 i=startIndex; i < endIndex; i++) {
 
-        // Update the position of the center of mass of the body
-        mRigidBodyComponents.mCentersOfMassWorld[i] = mRigidBodyComponents.mConstrainedPositions[i];
+            // Update the linear and angular velocity of the body
+            mRigidBodyComponents.mLinearVelocities[i] = mRigidBodyComponents.mConstrainedLinearVelocities[i];
+            mRigidBodyComponents.mAngularVelocities[i] = mRigidBodyComponents.mConstrainedAngularVelocities[i];
 
-        // Update the orientation of the body
-        const Quaternion& constrainedOrientation = mRigidBodyComponents.mConstrainedOrientations[i];
-        mTransformComponents.getTransform(mRigidBodyComponents.mBodiesEntities[i]).setOrientation(constrainedOrientation.getUnit());
-    }
+            // Update the position of the center of mass of the body
+            mRigidBodyComponents.mCentersOfMassWorld[i] = mRigidBodyComponents.mConstrainedPositions[i];
+
+            // Update the orientation of the body
+            const Quaternion& constrainedOrientation = mRigidBodyComponents.mConstrainedOrientations[i];
+            mTransformComponents.getTransform(mRigidBodyComponents.mBodiesEntities[i]).setOrientation(constrainedOrientation.getUnit());
+        }
 
-    // Update the position of the body (using the new center of mass and new orientation)
-    for (uint32 i=0; i < mRigidBodyComponents.getNbEnabledComponents(); i++) {
+        // Update the position of the body (using the new center of mass and new orientation)
+        for (uint32 i=startIndex; i < endIndex; i++) {
 
-        Transform& transform = mTransformComponents.getTransform(mRigidBodyComponents.mBodiesEntities[i]);
-        const Vector3& centerOfMassWorld = mRigidBodyComponents.mCentersOfMassWorld[i];
-        const Vector3& centerOfMassLocal = mRigidBodyComponents.mCentersOfMassLocal[i];
-        transform.setPosition(centerOfMassWorld - transform.getOrientation() * centerOfMassLocal);
-    }
+            Transform& transform = mTransformComponents.getTransform(mRigidBodyComponents.mBodiesEntities[i]);
+            const Vector3& centerOfMassWorld = mRigidBodyComponents.mCentersOfMassWorld[i];
+            const Vector3& centerOfMassLocal = mRigidBodyComponents.mCentersOfMassLocal[i];
+            transform.setPosition(centerOfMassWorld - transform.getOrientation() * centerOfMassLocal);
+        }
+    });
 
     // Update the local-to-world transform of the colliders
-    for (uint32 i=0; i < mColliderComponents.getNbEnabledComponents(); i++) {
+    parallelFor(mTaskScheduler, mColliderComponents.getNbEnabledComponents(), PARALLEL_FOR_GRAIN_SIZE,
+                [this](uint32 startIndex, uint32 endIndex) {
 
-        // Update the local-to-world transform of the collider
-        mColliderComponents.mLocalToWorldTransforms[i] = mTransformComponents.getTransform(mColliderComponents.mBodiesEntities[i]) *
-                                                           mColliderComponents.mLocalToBodyTransforms[i];
-    }
+        for (uint32 i=startIndex; i < endIndex; i++) {
+
+            // Update the local-to-world transform of the collider
+            mColliderComponents.mLocalToWorldTransforms[i] = mTransformComponents.getTransform(mColliderComponents.mBodiesEntities[i]) *
+                                                               mColliderComponents.mLocalToBodyTransforms[i];
+        }
+    });
 }
 
 // Integrate the velocities of rigid bodies.
@@ -115,62 +129,67 @@ void DynamicsSystem::integrateRigidBodiesVelocities(decimal timeStep) {
 
     RP3D_PROFILE("DynamicsSystem::integrateRigidBodiesVelocities()", mProfiler);
 
-    // Reset the split velocities of the bodies
-    resetSplitVelocities();
+    // Each body only writes its own data so the bodies can be integrated in parallel
+    parallelFor(mTaskScheduler, mRigidBodyComponents.getNbEnabledComponents(), PARALLEL_FOR_GRAIN_SIZE,
+                [this, timeStep](uint32 startIndex, uint32 endIndex) {
 
-    // Integration component velocities using force/torque
-    for (uint32 i=0; i < mRigidBodyComponents.getNbEnabledComponents(); i++) {
+        // Reset the split velocities of the bodies
+        resetSplitVelocities(startIndex, endIndex);
 
-        assert(mRigidBodyComponents.mSplitLinearVelocities[i] == Vector3(0, 0, 0));
-        assert(mRigidBodyComponents.mSplitAngularVelocities[i] == Vector3(0, 0, 0));
+        // Integration component velocities using force/torque
+        for (uint32 i=startIndex; i < endIndex; i++) {
 
-        const Vector3& linearVelocity = mRigidBodyComponents.mLinearVelocities[i];
-        const Vector3& angularVelocity = mRigidBodyComponents.mAngularVelocities[i];
+            assert(mRigidBodyComponents.mSplitLinearVelocities[i] == Vector3(0, 0, 0));
+            assert(mRigidBodyComponents.mSplitAngularVelocities[i] == Vector3(0, 0, 0));
 
-        // Integrate the external force to get the new velocity of the body
-        mRigidBodyComponents.mConstrainedLinearVelocities[i] = linearVelocity + timeStep *
-                                                              mRigidBodyComponents.mInverseMasses[i] * mRigidBodyComponents.mExternalForces[i];
-        mRigidBodyComponents.mConstrainedAngularVelocities[i] = angularVelocity + timeStep *
-                                                 RigidBody::getWorldInertiaTensorInverse(mWorld, mRigidBodyComponents.mBodiesEntities[i]) * mRigidBodyComponents.mExternalTorques[i];
-    }
+            const Vector3& linearVelocity = mRigidBodyComponents.mLinearVelocities[i];
+            const Vector3& angularVelocity = mRigidBodyComponents.mAngularVelocities[i];
 
-    // Apply gravity force
-    if (mIsGravityEnabled) {
+            // Integrate the external force to get the new velocity of the body
+            mRigidBodyComponents.mConstrainedLinearVelocities[i] = linearVelocity + timeStep *
+                                                                  mRigidBodyComponents.mInverseMasses[i] * mRigidBodyComponents.mExternalForces[i];
+            mRigidBodyComponents.mConstrainedAngularVelocities[i] = angularVelocity + timeStep *
+                                                     RigidBody::getWorldInertiaTensorInverse(mWorld, mRigidBodyComponents.mBodiesEntities[i]) * mRigidBodyComponents.mExternalTorques[i];
+        }
 
-        for (uint32 i=0; i < mRigidBodyComponents.getNbEnabledComponents(); i++) {
+        // Apply gravity force
+        if (mIsGravityEnabled) {
 
-            // If the gravity has to be applied to this rigid body
-            if (mRigidBodyComponents.mIsGravityEnabled[i]) {
+            for (uint32 i=startIndex; i < endIndex; i++) {
 
-                // Integrate the gravity force
-                mRigidBodyComponents.mConstrainedLinearVelocities[i] = mRigidBodyComponents.mConstrainedLinearVelocities[i] + timeStep *
-                                                                       mRigidBodyComponents.mInverseMasses[i] * mRigidBodyComponents.mMasses[i] * mGravity;
+                // If the gravity has to be applied to this rigid body
+                if (mRigidBodyComponents.mIsGravityEnabled[i]) {
+
+                    // Integrate the gravity force
+                    mRigidBodyComponents.mConstrainedLinearVelocities[i] = mRigidBodyComponents.mConstrainedLinearVelocities[i] + timeStep *
+                                                                           mRigidBodyComponents.mInverseMasses[i] * mRigidBodyComponents.mMasses[i] * mGravity;
+                }
             }
         }
-    }
 
-    // Apply the velocity damping
-    // Damping force : F_c = -c' * v (c=damping factor)
-    // Equation      : m * dv/dt = -c' * v
-    //                 => dv/dt = -c * v (with c=c'/m)
-    //                 => dv/dt + c * v = 0
-    // Solution      : v(t) = v0 * e^(-c * t)
-    //                 => v(t + dt) = v0 * e^(-c(t + dt))
-    //                              = v0 * e^(-ct) * e^(-c * dt)
-    //                              = v(t) * e^(-c * dt)
-    //                 => v2 = v1 * e^(-c * dt)
-    // Using Taylor Serie for e^(-x) : e^x ~ 1 + x + x^2/2! + ...
-    //                              => e^(-x) ~ 1 - x
-    //                 => v2 = v1 * (1 - c * dt)
-    for (uint32 i=0; i < mRigidBodyComponents.getNbEnabledComponents(); i++) {
-
-        const decimal linDampingFactor = mRigidBodyComponents.mLinearDampings[i];
-        const decimal angDampingFactor = mRigidBodyComponents.mAngularDampings[i];
-        const decimal linearDamping = std::pow(decimal(1.0) - linDampingFactor, timeStep);
-        const decimal angularDamping = std::pow(decimal(1.0) - angDampingFactor, timeStep);
-        mRigidBodyComponents.mConstrainedLinearVelocities[i] = mRigidBodyComponents.mConstrainedLinearVelocities[i] * linearDamping;
-        mRigidBodyComponents.mConstrainedAngularVelocities[i] = mRigidBodyComponents.mConstrainedAngularVelocities[i] * angularDamping;
-    }
+        // Apply the velocity damping
+        // Damping force : F_c = -c' * v (c=damping factor)
+        // Equation      : m * dv/dt = -c' * v
+        //                 => dv/dt = -c * v (with c=c'/m)
+        //                 => dv/dt + c * v = 0
+        // Solution      : v(t) = v0 * e^(-c * t)
+        //                 => v(t + dt) = v0 * e^(-c(t + dt))
+        //                              = v0 * e^(-ct) * e^(-c * dt)
+        //                              = v(t) * e^(-c * dt)
+        //                 => v2 = v1 * e^(-c * dt)
+        // Using Taylor Serie for e^(-x) : e^x ~ 1 + x + x^2/2! + ...
+        //                              => e^(-x) ~ 1 - x
+        //                 => v2 = v1 * (1 - c * dt)
+        for (uint32 i=startIndex; i < endIndex; i++) {
+
+            const decimal linDampingFactor = mRigidBodyComponents.mLinearDampings[i];
+            const decimal angDampingFactor = mRigidBodyComponents.mAngularDampings[i];
+            const decimal linearDamping = std::pow(decimal(1.0) - linDampingFactor, timeStep);
+            const decimal angularDamping = std::pow(decimal(1.0) - angDampingFactor, timeStep);
+            mRigidBodyComponents.mConstrainedLinearVelocities[i] = mRigidBodyComponents.mConstrainedLinearVelocities[i] * linearDamping;
+            mRigidBodyComponents.mConstrainedAngularVelocities[i] = mRigidBodyComponents.mConstrainedAngularVelocities[i] * angularDamping;
+        }
+    });
 }
 
 // Reset the external force and torque applied to the bodies
@@ -185,8 +204,13 @@ void DynamicsSystem::resetBodiesForceAndTorque() {
 
 // Reset the split velocities of the bodies
 void DynamicsSystem::resetSplitVelocities() {
+    resetSplitVelocities(0, mRigidBodyComponents.getNbEnabledComponents());
+}
+
+// Reset the split velocities of the bodies in the range [startIndex, endIndex)
+void DynamicsSystem::resetSplitVelocities(uint32 startIndex, uint32 endIndex) {
 
-    for(uint32 i=0; i < mRigidBodyComponents.getNbEnabledComponents(); i++) {
+    for(uint32 i=startIndex; i < endIndex; i++) {
         mRigidBodyComponents.mSplitLinearVelocities[i].setToZero();
         mRigidBodyComponents.mSplitAngularVelocities[i].setToZero();
     }
@@ -37,6 +37,7 @@
 #include "tests/collision/TestCollisionWorld.h"
 #include "tests/collision/TestAABB.h"
 #include "tests/collision/TestDynamicAABBTree.h"
+#include "tests/collision/TestBroadPhaseAlgorithms.h"
 #include "tests/collision/TestHalfEdgeStructure.h"
 #include "tests/collision/TestTriangleVertexArray.h"
 #include "tests/containers/TestList.h"
@@ -44,6 +45,7 @@
 #include "tests/containers/TestSet.h"
 #include "tests/containers/TestDeque.h"
 #include "tests/containers/TestStack.h"
+#include "tests/engine/TestTaskScheduler.h"
 
 using namespace reactphysics3d;
 
@@ -77,8 +79,13 @@ int main() {
     testSuite.addTest(new TestRaycast("Raycasting"));
     testSuite.addTest(new TestCollisionWorld("CollisionWorld"));
     testSuite.addTest(new TestDynamicAABBTree("DynamicAABBTree"));
+    testSuite.addTest(new TestBroadPhaseAlgorithms("BroadPhaseAlgorithms"));
     testSuite.addTest(new TestHalfEdgeStructure("HalfEdgeStructure"));
 
+    // ---------- Engine tests ---------- //
+
+    testSuite.addTest(new TestTaskScheduler("TaskScheduler"));
+
     // Run the tests
     testSuite.run();
 
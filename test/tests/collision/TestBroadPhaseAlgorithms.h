@@ -0,0 +1,662 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_BROAD_PHASE_ALGORITHMS_H
+#define TEST_BROAD_PHASE_ALGORITHMS_H
+
+// Libraries
+#include "Test.h"
+#include <reactphysics3d/collision/broadphase/DynamicAABBTreeBroadPhase.h>
+#include <reactphysics3d/collision/broadphase/SweepAndPruneBroadPhase.h>
+#include <reactphysics3d/collision/broadphase/HashGridBroadPhase.h>
+#include <reactphysics3d/collision/RayPacket.h>
+#include <reactphysics3d/memory/MemoryManager.h>
+#include <reactphysics3d/engine/DefaultTaskScheduler.h>
+#include <reactphysics3d/utils/Profiler.h>
+#include <set>
+#include <utility>
+#include <vector>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class BroadPhaseRaycastDataCallback
+/**
+ * Raycast callback that records the data of the hit objects
+ */
+class BroadPhaseRaycastDataCallback : public DynamicAABBTreeRaycastCallback {
+
+    public:
+
+        const BroadPhaseAlgorithm& mBroadPhaseAlgorithm;
+
+        std::set<size_t> mHitObjects;
+
+        uint32 mNbHits = 0;
+
+        BroadPhaseRaycastDataCallback(const BroadPhaseAlgorithm& broadPhaseAlgorithm)
+            : mBroadPhaseAlgorithm(broadPhaseAlgorithm) {
+
+        }
+
+        // Called when the fat AABB of an object is hit by a ray
+        virtual decimal raycastBroadPhaseShape(int32 broadPhaseId, const Ray& ray) override {
+            mHitObjects.insert(reinterpret_cast<size_t>(mBroadPhaseAlgorithm.getObjectData(broadPhaseId)));
+            mNbHits++;
+            return decimal(-1.0);
+        }
+};
+
+// Class BroadPhaseRayPacketDataCallback
+/**
+ * Ray packet callback that records the data of the objects hit by each ray of the packet
+ */
+class BroadPhaseRayPacketDataCallback : public DynamicAABBTreeRayPacketCallback {
+
+    public:
+
+        const BroadPhaseAlgorithm& mBroadPhaseAlgorithm;
+
+        std::set<size_t> mHitObjects[RayPacket::MAX_NB_RAYS];
+
+        uint32 mNbHits = 0;
+
+        BroadPhaseRayPacketDataCallback(const BroadPhaseAlgorithm& broadPhaseAlgorithm)
+            : mBroadPhaseAlgorithm(broadPhaseAlgorithm) {
+
+        }
+
+        // Called when the fat AABB of an object is hit by some rays of a packet
+        virtual void raycastBroadPhaseShape(int32 broadPhaseId, RayPacket& packet, uint32 rayMask) override {
+            for (uint32 i=0; i < packet.nbRays; i++) {
+                if ((rayMask & (1u << i)) != 0) {
+                    mHitObjects[i].insert(reinterpret_cast<size_t>(mBroadPhaseAlgorithm.getObjectData(broadPhaseId)));
+                    mNbHits++;
+                }
+            }
+        }
+};
+
+// Class TestBroadPhaseAlgorithms
+/**
+ * Unit test for the broad-phase algorithms. The sweep-and-prune and the hash grid
+ * must report the same overlapping pairs as the dynamic AABB tree.
+ */
+class TestBroadPhaseAlgorithms : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        MemoryManager mMemoryManager;
+
+        /// Random number generator state
+        uint32 mSeed;
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+        Profiler* mProfiler;
+#endif
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestBroadPhaseAlgorithms(const std::string& name) : Test(name), mMemoryManager(nullptr), mSeed(4321) {
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+            mProfiler = new Profiler();
+#endif
+
+        }
+
+        /// Destructor
+        ~TestBroadPhaseAlgorithms() {
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+            delete mProfiler;
+#endif
+
+        }
+
+        /// Return a pseudo-random number in [0, 1)
+        decimal random() {
+            mSeed = mSeed * 1664525u + 1013904223u;
+            return decimal(mSeed >> 8) / decimal(1 << 24);
+        }
+
+        /// Return a pseudo-random AABB
+        AABB createRandomAABB() {
+            const Vector3 min(random() * 60, random() * 10, random() * 60);
+            const Vector3 size(random() * 2 + decimal(0.1), random() * 2 + decimal(0.1), random() * 2 + decimal(0.1));
+            return AABB(min, min + size);
+        }
+
+        /// Return the set of overlapping pairs (as pairs of object data) of a broad-phase algorithm
+        std::set<std::pair<size_t, size_t>> computePairs(BroadPhaseAlgorithm& broadPhase, const List<int32>& movedObjects) {
+
+            List<Pair<int32, int32>> overlappingPairs(mMemoryManager.getPoolAllocator());
+            broadPhase.computeOverlappingPairs(mMemoryManager, movedObjects, overlappingPairs);
+
+            std::set<std::pair<size_t, size_t>> pairs;
+            for (uint32 i=0; i < overlappingPairs.size(); i++) {
+
+                if (overlappingPairs[i].first == overlappingPairs[i].second) continue;
+
+                const size_t data1 = reinterpret_cast<size_t>(broadPhase.getObjectData(overlappingPairs[i].first));
+                const size_t data2 = reinterpret_cast<size_t>(broadPhase.getObjectData(overlappingPairs[i].second));
+                pairs.insert(std::make_pair(std::min(data1, data2), std::max(data1, data2)));
+            }
+
+            return pairs;
+        }
+
+        /// Run the tests
+        void run() {
+
+            testSweepAndPruneBasicMethods();
+            testHashGridBasicMethods();
+            testFatAABBPrediction();
+            testOverlappingPairs();
+            testRaycast();
+        }
+
+        void testSweepAndPruneBasicMethods() {
+
+            SweepAndPruneBroadPhase broadPhase(mMemoryManager.getPoolAllocator(), decimal(0.1));
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+            broadPhase.setProfiler(mProfiler);
+#endif
+
+            int object1Data = 1;
+            int object2Data = 2;
+
+            const AABB aabb1(Vector3(0, 0, 0), Vector3(10, 10, 10));
+            const int32 object1Id = broadPhase.addObject(aabb1, &object1Data, false);
+            const int32 object2Id = broadPhase.addObject(AABB(Vector3(20, 0, 0), Vector3(30, 10, 10)), &object2Data, false);
+
+            rp3d_test(object1Id != object2Id);
+            rp3d_test(broadPhase.getNbObjects() == 2);
+            rp3d_test(broadPhase.getObjectData(object1Id) == &object1Data);
+            rp3d_test(broadPhase.getObjectData(object2Id) == &object2Data);
+
+            // The fat AABB is inflated by 10% of the size of the AABB
+            rp3d_test(approxEqual(broadPhase.getFatAABB(object1Id).getMin(), Vector3(decimal(-0.5), decimal(-0.5), decimal(-0.5)), decimal(0.0001)));
+            rp3d_test(approxEqual(broadPhase.getFatAABB(object1Id).getMax(), Vector3(decimal(10.5), decimal(10.5), decimal(10.5)), decimal(0.0001)));
+
+            // An AABB inside the fat AABB does not change the fat AABB
+            rp3d_test(!broadPhase.updateObject(object1Id, AABB(Vector3(decimal(0.2), 0, 0), Vector3(decimal(10.2), 10, 10)), Vector3::zero(), decimal(-1.0), false));
+            rp3d_test(broadPhase.updateObject(object1Id, AABB(Vector3(decimal(0.2), 0, 0), Vector3(decimal(10.2), 10, 10)), Vector3::zero(), decimal(-1.0), true));
+            rp3d_test(broadPhase.updateObject(object1Id, AABB(Vector3(15, 0, 0), Vector3(25, 10, 10)), Vector3::zero(), decimal(-1.0), false));
+            rp3d_test(approxEqual(broadPhase.getFatAABB(object1Id).getMin().x, decimal(14.5), decimal(0.0001)));
+
+            // The two objects are now overlapping
+            List<int32> movedObjects(mMemoryManager.getPoolAllocator());
+            movedObjects.add(object1Id);
+            List<Pair<int32, int32>> overlappingPairs(mMemoryManager.getPoolAllocator());
+            broadPhase.computeOverlappingPairs(mMemoryManager, movedObjects, overlappingPairs);
+            rp3d_test(overlappingPairs.size() == 1);
+            rp3d_test(overlappingPairs[0].first == object1Id);
+            rp3d_test(overlappingPairs[0].second == object2Id);
+
+            // No pair is reported if no object has moved
+            List<int32> noMovedObjects(mMemoryManager.getPoolAllocator());
+            overlappingPairs.clear();
+            broadPhase.computeOverlappingPairs(mMemoryManager, noMovedObjects, overlappingPairs);
+            rp3d_test(overlappingPairs.size() == 0);
+
+            // The ID of a removed object is reused
+            broadPhase.removeObject(object1Id);
+            rp3d_test(broadPhase.getNbObjects() == 1);
+            const int32 object3Id = broadPhase.addObject(aabb1, &object1Data, false);
+            rp3d_test(object3Id == object1Id);
+            rp3d_test(broadPhase.getNbObjects() == 2);
+            rp3d_test(broadPhase.getObjectData(object2Id) == &object2Data);
+
+            broadPhase.computeOverlappingPairs(mMemoryManager, noMovedObjects, overlappingPairs);
+            rp3d_test(approxEqual(broadPhase.getFatAABB(object2Id).getMin().x, decimal(19.5), decimal(0.0001)));
+
+            // The AABB of a static object is not inflated
+            int object4Data = 4;
+            const int32 object4Id = broadPhase.addObject(AABB(Vector3(5, 0, 0), Vector3(25, 10, 10)), &object4Data, true);
+            rp3d_test(broadPhase.getFatAABB(object4Id).getMin() == Vector3(5, 0, 0));
+            rp3d_test(broadPhase.getFatAABB(object4Id).getMax() == Vector3(25, 10, 10));
+
+            // A pair of two static objects is not reported
+            broadPhase.setObjectIsStatic(object2Id, true);
+            movedObjects.clear();
+            movedObjects.add(object2Id);
+            movedObjects.add(object4Id);
+            overlappingPairs.clear();
+            broadPhase.computeOverlappingPairs(mMemoryManager, movedObjects, overlappingPairs);
+            rp3d_test(overlappingPairs.size() == 1);
+            rp3d_test(overlappingPairs[0].first == object4Id);
+            rp3d_test(overlappingPairs[0].second == object3Id);
+        }
+
+        void testHashGridBasicMethods() {
+
+            HashGridBroadPhase broadPhase(mMemoryManager.getPoolAllocator(), decimal(0.1));
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+            broadPhase.setProfiler(mProfiler);
+#endif
+
+            void* object1Data = reinterpret_cast<void*>(size_t(1));
+            void* object2Data = reinterpret_cast<void*>(size_t(2));
+            void* object3Data = reinterpret_cast<void*>(size_t(3));
+            void* object4Data = reinterpret_cast<void*>(size_t(4));
+
+            const AABB aabb1(Vector3(0, 0, 0), Vector3(1, 1, 1));
+            const int32 object1Id = broadPhase.addObject(aabb1, object1Data, false);
+            const int32 object2Id = broadPhase.addObject(AABB(Vector3(decimal(1.02), 0, 0), Vector3(decimal(2.02), 1, 1)), object2Data, false);
+
+            rp3d_test(object1Id != object2Id);
+            rp3d_test(broadPhase.getObjectData(object1Id) == object1Data);
+            rp3d_test(broadPhase.getObjectData(object2Id) == object2Data);
+
+            // The grid is built the first time the overlapping pairs are computed
+            rp3d_test(broadPhase.getCellSize() == decimal(0.0));
+            rp3d_test(broadPhase.getNbGridObjects() == 0);
+
+            List<int32> movedObjects(mMemoryManager.getPoolAllocator());
+            movedObjects.add(object1Id);
+            movedObjects.add(object2Id);
+            std::set<std::pair<size_t, size_t>> pairs = computePairs(broadPhase, movedObjects);
+            rp3d_test(pairs.size() == 1);
+            rp3d_test(pairs.count(std::make_pair(size_t(1), size_t(2))) == 1);
+
+            // The pair of two moved objects of the grid is only reported once
+            List<Pair<int32, int32>> overlappingPairs(mMemoryManager.getPoolAllocator());
+            broadPhase.computeOverlappingPairs(mMemoryManager, movedObjects, overlappingPairs);
+            rp3d_test(overlappingPairs.size() == 1);
+
+            // The size of the cells is computed from the average size of the fat AABBs
+            rp3d_test(approxEqual(broadPhase.getCellSize(), HASH_GRID_CELL_SIZE_MULTIPLIER * decimal(1.1), decimal(0.0001)));
+            rp3d_test(broadPhase.getNbGridObjects() == 2);
+
+            // A large object is stored in the trees. The cell size follows the average size of the objects.
+            const int32 object3Id = broadPhase.addObject(AABB(Vector3(decimal(1.5), 0, 0), Vector3(decimal(11.5), 1, 1)), object3Data, false);
+            rp3d_test(broadPhase.getNbGridObjects() == 2);
+            movedObjects.clear();
+            movedObjects.add(object3Id);
+            pairs = computePairs(broadPhase, movedObjects);
+            rp3d_test(approxEqual(broadPhase.getCellSize(), HASH_GRID_CELL_SIZE_MULTIPLIER * decimal(4.4), decimal(0.0001)));
+            rp3d_test(broadPhase.getNbGridObjects() == 2);
+            rp3d_test(pairs.size() == 2);
+            rp3d_test(pairs.count(std::make_pair(size_t(1), size_t(3))) == 1);
+            rp3d_test(pairs.count(std::make_pair(size_t(2), size_t(3))) == 1);
+
+            // A static object is stored in the trees and its AABB is not inflated
+            const int32 object4Id = broadPhase.addObject(AABB(Vector3(0, -1, 0), Vector3(3, 0, 1)), object4Data, true);
+            rp3d_test(broadPhase.getNbGridObjects() == 2);
+            rp3d_test(broadPhase.getFatAABB(object4Id).getMin() == Vector3(0, -1, 0));
+            movedObjects.clear();
+            movedObjects.add(object4Id);
+            pairs = computePairs(broadPhase, movedObjects);
+            rp3d_test(pairs.size() == 3);
+            rp3d_test(pairs.count(std::make_pair(size_t(3), size_t(4))) == 1);
+
+            // An object of the grid that becomes too large for the cells is moved into the trees (and back)
+            rp3d_test(broadPhase.updateObject(object1Id, aabb1, Vector3(20, 0, 0), decimal(-1.0), false) == false);
+            rp3d_test(broadPhase.updateObject(object1Id, aabb1, Vector3(20, 0, 0), decimal(-1.0), true));
+            rp3d_test(broadPhase.getNbGridObjects() == 1);
+            rp3d_test(approxEqual(broadPhase.getFatAABB(object1Id).getMax().x, decimal(21.05), decimal(0.0001)));
+            rp3d_test(broadPhase.updateObject(object1Id, aabb1, Vector3::zero(), decimal(-1.0), true));
+            rp3d_test(broadPhase.getNbGridObjects() == 2);
+            rp3d_test(approxEqual(broadPhase.getFatAABB(object1Id).getMax().x, decimal(1.05), decimal(0.0001)));
+
+            // A static object is moved into the trees with its fat AABB (inflated again when it is not static anymore)
+            broadPhase.setObjectIsStatic(object2Id, true);
+            rp3d_test(broadPhase.getNbGridObjects() == 1);
+            rp3d_test(approxEqual(broadPhase.getFatAABB(object2Id).getMin().x, decimal(0.97), decimal(0.0001)));
+            broadPhase.setObjectIsStatic(object2Id, false);
+            rp3d_test(broadPhase.getNbGridObjects() == 2);
+            rp3d_test(approxEqual(broadPhase.getFatAABB(object2Id).getMin().x, decimal(0.915), decimal(0.0001)));
+
+            // The ID of a removed object is reused
+            broadPhase.removeObject(object1Id);
+            rp3d_test(broadPhase.getNbGridObjects() == 1);
+            const int32 object5Id = broadPhase.addObject(aabb1, object1Data, false);
+            rp3d_test(object5Id == object1Id);
+            rp3d_test(broadPhase.getNbGridObjects() == 2);
+
+            // No pair is reported if no object has moved
+            movedObjects.clear();
+            rp3d_test(computePairs(broadPhase, movedObjects).size() == 0);
+
+            // The objects are still found after the grid has been compacted
+            broadPhase.compact();
+            movedObjects.add(object2Id);
+            pairs = computePairs(broadPhase, movedObjects);
+            rp3d_test(pairs.size() == 3);
+            rp3d_test(pairs.count(std::make_pair(size_t(1), size_t(2))) == 1);
+
+            // A huge object covers more cells along the three axes than an unsigned 64 bits integer can count
+            void* object6Data = reinterpret_cast<void*>(size_t(6));
+            const int32 object6Id = broadPhase.addObject(AABB(Vector3(decimal(-1e9), decimal(-1e9), decimal(-1e9)),
+                                                              Vector3(decimal(1e9), decimal(1e9), decimal(1e9))), object6Data, true);
+            movedObjects.clear();
+            movedObjects.add(object6Id);
+            pairs = computePairs(broadPhase, movedObjects);
+            rp3d_test(pairs.size() == 3);
+            rp3d_test(pairs.count(std::make_pair(size_t(1), size_t(6))) == 1);
+            rp3d_test(pairs.count(std::make_pair(size_t(2), size_t(6))) == 1);
+            rp3d_test(pairs.count(std::make_pair(size_t(3), size_t(6))) == 1);
+        }
+
+        void testFatAABBPrediction() {
+
+            DynamicAABBTreeBroadPhase treeBroadPhase(mMemoryManager.getPoolAllocator(), decimal(0.1));
+            SweepAndPruneBroadPhase sweepAndPrune(mMemoryManager.getPoolAllocator(), decimal(0.1));
+            HashGridBroadPhase hashGrid(mMemoryManager.getPoolAllocator(), decimal(0.1), decimal(10.0));
+            BroadPhaseAlgorithm* broadPhases[3] = {&treeBroadPhase, &sweepAndPrune, &hashGrid};
+
+            for (int b=0; b < 3; b++) {
+
+                BroadPhaseAlgorithm& broadPhase = *broadPhases[b];
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+                broadPhase.setProfiler(mProfiler);
+#endif
+
+                int objectData = 1;
+                int staticObjectData = 2;
+                const int32 objectId = broadPhase.addObject(AABB(Vector3(0, 0, 0), Vector3(1, 1, 1)), &objectData, false);
+                const int32 staticObjectId = broadPhase.addObject(AABB(Vector3(0, 5, 0), Vector3(1, 6, 1)), &staticObjectData, true);
+
+                // The fat AABB is extended in the direction of the displacement only
+                const Vector3 displacement(2, 0, decimal(-1.5));
+                rp3d_test(broadPhase.updateObject(objectId, AABB(Vector3(3, 0, 0), Vector3(4, 1, 1)), displacement,
+                                                  decimal(-1.0), false));
+                rp3d_test(approxEqual(broadPhase.getFatAABB(objectId).getMin(), Vector3(decimal(2.95), decimal(-0.05), decimal(-1.55)), decimal(0.0001)));
+                rp3d_test(approxEqual(broadPhase.getFatAABB(objectId).getMax(), Vector3(decimal(6.05), decimal(1.05), decimal(1.05)), decimal(0.0001)));
+
+                // An object moving with the predicted displacement stays inside its fat AABB
+                rp3d_test(!broadPhase.updateObject(objectId, AABB(Vector3(5, 0, decimal(-1.5)), Vector3(6, 1, decimal(-0.5))), displacement,
+                                                   decimal(-1.0), false));
+
+                // The inflation percentage of an object can be overridden
+                rp3d_test(broadPhase.updateObject(objectId, AABB(Vector3(0, 0, 0), Vector3(1, 1, 1)), Vector3::zero(),
+                                                  decimal(1.0), true));
+                rp3d_test(approxEqual(broadPhase.getFatAABB(objectId).getMin(), Vector3(decimal(-0.5), decimal(-0.5), decimal(-0.5)), decimal(0.0001)));
+                rp3d_test(approxEqual(broadPhase.getFatAABB(objectId).getMax(), Vector3(decimal(1.5), decimal(1.5), decimal(1.5)), decimal(0.0001)));
+                rp3d_test(!broadPhase.updateObject(objectId, AABB(Vector3(decimal(0.4), 0, 0), Vector3(decimal(1.4), 1, 1)), Vector3::zero(),
+                                                   decimal(1.0), false));
+
+                // The fat AABB of a static object is neither inflated nor extended
+                rp3d_test(broadPhase.updateObject(staticObjectId, AABB(Vector3(0, 5, 0), Vector3(1, 6, 1)), displacement,
+                                                  decimal(1.0), true));
+                rp3d_test(broadPhase.getFatAABB(staticObjectId).getMin() == Vector3(0, 5, 0));
+                rp3d_test(broadPhase.getFatAABB(staticObjectId).getMax() == Vector3(1, 6, 1));
+            }
+        }
+
+        void testOverlappingPairs() {
+
+            const int nbObjects = 2000;
+            const int nbBroadPhases = 6;
+
+            DefaultTaskScheduler scheduler(mMemoryManager.getHeapAllocator(), 4);
+
+            DynamicAABBTreeBroadPhase treeBroadPhase(mMemoryManager.getPoolAllocator(), DYNAMIC_TREE_FAT_AABB_INFLATE_PERCENTAGE, 16);
+            DynamicAABBTreeBroadPhase parallelTreeBroadPhase(mMemoryManager.getPoolAllocator(), DYNAMIC_TREE_FAT_AABB_INFLATE_PERCENTAGE,
+                                                             0, &scheduler);
+            SweepAndPruneBroadPhase sweepAndPrune(mMemoryManager.getPoolAllocator(), DYNAMIC_TREE_FAT_AABB_INFLATE_PERCENTAGE);
+            SweepAndPruneBroadPhase parallelSweepAndPrune(mMemoryManager.getPoolAllocator(), DYNAMIC_TREE_FAT_AABB_INFLATE_PERCENTAGE,
+                                                          &scheduler);
+            HashGridBroadPhase hashGrid(mMemoryManager.getPoolAllocator(), DYNAMIC_TREE_FAT_AABB_INFLATE_PERCENTAGE);
+            HashGridBroadPhase parallelHashGrid(mMemoryManager.getPoolAllocator(), DYNAMIC_TREE_FAT_AABB_INFLATE_PERCENTAGE,
+                                                decimal(1.5), 16, &scheduler);
+            BroadPhaseAlgorithm* broadPhases[nbBroadPhases] = {&treeBroadPhase, &sweepAndPrune, &parallelSweepAndPrune,
+                                                               &hashGrid, &parallelHashGrid, &parallelTreeBroadPhase};
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+            for (BroadPhaseAlgorithm* broadPhase : broadPhases) {
+                broadPhase->setProfiler(mProfiler);
+            }
+#endif
+
+            // Broad-phase IDs of each object in each broad-phase (the data of an object is its index + 1)
+            std::vector<int32> ids[nbBroadPhases];
+            std::vector<bool> isRemoved(nbObjects, false);
+            std::vector<bool> isStatic(nbObjects, false);
+            List<int32> movedObjects[nbBroadPhases] = {List<int32>(mMemoryManager.getPoolAllocator()), List<int32>(mMemoryManager.getPoolAllocator()),
+                                                       List<int32>(mMemoryManager.getPoolAllocator()), List<int32>(mMemoryManager.getPoolAllocator()),
+                                                       List<int32>(mMemoryManager.getPoolAllocator()), List<int32>(mMemoryManager.getPoolAllocator())};
+
+            for (int i=0; i < nbObjects; i++) {
+
+                isStatic[i] = i % 7 == 0;
+
+                const AABB aabb = createRandomAABB();
+                for (int b=0; b < nbBroadPhases; b++) {
+                    ids[b].push_back(broadPhases[b]->addObject(aabb, reinterpret_cast<void*>(size_t(i + 1)), isStatic[i]));
+                    movedObjects[b].add(ids[b][i]);
+                }
+            }
+
+            bool isValid = true;
+            bool hasPairs = true;
+
+            for (int frame=0; frame < 10; frame++) {
+
+                // Reorder the internal data of the broad-phases
+                if (frame == 4 || frame == 8) {
+                    for (int b=0; b < nbBroadPhases; b++) {
+                        broadPhases[b]->compact();
+                    }
+                }
+
+                // Compute the overlapping pairs in each broad-phase
+                const std::set<std::pair<size_t, size_t>> treePairs = computePairs(treeBroadPhase, movedObjects[0]);
+                const std::set<std::pair<size_t, size_t>> sweepAndPrunePairs = computePairs(sweepAndPrune, movedObjects[1]);
+                const std::set<std::pair<size_t, size_t>> parallelSweepAndPrunePairs = computePairs(parallelSweepAndPrune, movedObjects[2]);
+                const std::set<std::pair<size_t, size_t>> hashGridPairs = computePairs(hashGrid, movedObjects[3]);
+                const std::set<std::pair<size_t, size_t>> parallelHashGridPairs = computePairs(parallelHashGrid, movedObjects[4]);
+                const std::set<std::pair<size_t, size_t>> parallelTreePairs = computePairs(parallelTreeBroadPhase, movedObjects[5]);
+
+                isValid &= treePairs == sweepAndPrunePairs;
+                isValid &= treePairs == parallelSweepAndPrunePairs;
+                isValid &= treePairs == hashGridPairs;
+                isValid &= treePairs == parallelHashGridPairs;
+                isValid &= treePairs == parallelTreePairs;
+                hasPairs &= treePairs.size() > 0;
+
+                // A pair of two static objects must never be reported
+                for (auto it = treePairs.begin(); it != treePairs.end(); ++it) {
+                    isValid &= !isStatic[it->first - 1] || !isStatic[it->second - 1];
+                }
+
+                for (int b=0; b < nbBroadPhases; b++) {
+                    movedObjects[b].clear();
+                }
+
+                // During the last frames, the static objects do not change anymore
+                const bool areStaticObjectsModified = frame < 6;
+
+                // During some frames, all the objects are re-inserted (most of the objects have moved)
+                const bool forceReInsert = frame == 2 || frame == 5;
+
+                // Move some objects (most of them stay inside their fat AABB)
+                for (int i=0; i < nbObjects; i++) {
+
+                    if (isRemoved[i] || (isStatic[i] && !areStaticObjectsModified)) continue;
+
+                    const AABB& fatAABB = treeBroadPhase.getFatAABB(ids[0][i]);
+                    const Vector3 displacement((random() - decimal(0.5)) * decimal(0.4), (random() - decimal(0.5)) * decimal(0.4),
+                                               (random() - decimal(0.5)) * decimal(0.4));
+                    const Vector3 size = fatAABB.getExtent() / (decimal(1.0) + DYNAMIC_TREE_FAT_AABB_INFLATE_PERCENTAGE);
+                    const Vector3 min = fatAABB.getCenter() - decimal(0.5) * size + displacement;
+                    const AABB newAABB(min, min + size);
+
+                    for (int b=0; b < nbBroadPhases; b++) {
+                        if (broadPhases[b]->updateObject(ids[b][i], newAABB, Vector3::zero(), decimal(-1.0), forceReInsert)) {
+                            movedObjects[b].add(ids[b][i]);
+                        }
+                    }
+                }
+
+                if (!areStaticObjectsModified) continue;
+
+                // Change the static state of some objects
+                for (int i=frame; i < nbObjects; i += 61) {
+
+                    if (isRemoved[i]) continue;
+
+                    isStatic[i] = !isStatic[i];
+                    for (int b=0; b < nbBroadPhases; b++) {
+                        broadPhases[b]->setObjectIsStatic(ids[b][i], isStatic[i]);
+                        if (movedObjects[b].find(ids[b][i]) == movedObjects[b].end()) {
+                            movedObjects[b].add(ids[b][i]);
+                        }
+                    }
+                }
+
+                // Remove and add some objects
+                for (int i=frame; i < nbObjects; i += 97) {
+
+                    if (isRemoved[i]) {
+
+                        const AABB aabb = createRandomAABB();
+                        for (int b=0; b < nbBroadPhases; b++) {
+                            ids[b][i] = broadPhases[b]->addObject(aabb, reinterpret_cast<void*>(size_t(i + 1)), isStatic[i]);
+                            movedObjects[b].add(ids[b][i]);
+                        }
+                    }
+                    else {
+
+                        for (int b=0; b < nbBroadPhases; b++) {
+                            broadPhases[b]->removeObject(ids[b][i]);
+                            if (movedObjects[b].find(ids[b][i]) != movedObjects[b].end()) {
+                                movedObjects[b].remove(ids[b][i]);
+                            }
+                        }
+                    }
+
+                    isRemoved[i] = !isRemoved[i];
+                }
+            }
+
+            rp3d_test(isValid);
+            rp3d_test(hasPairs);
+
+            // Most of the objects are small enough to be stored in the cells of the grids
+            rp3d_test(hashGrid.getCellSize() > decimal(0.0));
+            rp3d_test(hashGrid.getNbGridObjects() > 0);
+            rp3d_test(parallelHashGrid.getNbGridObjects() > 0);
+        }
+
+        void testRaycast() {
+
+            const int nbObjects = 500;
+
+            DynamicAABBTreeBroadPhase treeBroadPhase(mMemoryManager.getPoolAllocator(), DYNAMIC_TREE_FAT_AABB_INFLATE_PERCENTAGE);
+            SweepAndPruneBroadPhase sweepAndPrune(mMemoryManager.getPoolAllocator(), DYNAMIC_TREE_FAT_AABB_INFLATE_PERCENTAGE);
+            HashGridBroadPhase hashGrid(mMemoryManager.getPoolAllocator(), DYNAMIC_TREE_FAT_AABB_INFLATE_PERCENTAGE, decimal(1.5));
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+            treeBroadPhase.setProfiler(mProfiler);
+            sweepAndPrune.setProfiler(mProfiler);
+            hashGrid.setProfiler(mProfiler);
+#endif
+
+            for (int i=0; i < nbObjects; i++) {
+                const AABB aabb = createRandomAABB();
+                treeBroadPhase.addObject(aabb, reinterpret_cast<void*>(size_t(i + 1)), i % 5 == 0);
+                sweepAndPrune.addObject(aabb, reinterpret_cast<void*>(size_t(i + 1)), i % 5 == 0);
+                hashGrid.addObject(aabb, reinterpret_cast<void*>(size_t(i + 1)), i % 5 == 0);
+            }
+
+            List<int32> noMovedObjects(mMemoryManager.getPoolAllocator());
+            List<Pair<int32, int32>> overlappingPairs(mMemoryManager.getPoolAllocator());
+            sweepAndPrune.computeOverlappingPairs(mMemoryManager, noMovedObjects, overlappingPairs);
+            hashGrid.computeOverlappingPairs(mMemoryManager, noMovedObjects, overlappingPairs);
+
+            bool isValid = true;
+            bool hasHits = false;
+
+            Stack<int32> stack(mMemoryManager.getPoolAllocator());
+
+            for (int r=0; r < 50; r++) {
+
+                Ray rays[RayPacket::MAX_NB_RAYS] = {Ray(Vector3::zero(), Vector3::zero()), Ray(Vector3::zero(), Vector3::zero()),
+                                                    Ray(Vector3::zero(), Vector3::zero()), Ray(Vector3::zero(), Vector3::zero())};
+                for (uint32 i=0; i < RayPacket::MAX_NB_RAYS; i++) {
+
+                    // Some rays are parallel to an axis
+                    const Vector3 point1(random() * 60, random() * 10, random() * 60);
+                    Vector3 point2(random() * 60, random() * 10, random() * 60);
+                    if (i == 3) {
+                        point2.y = point1.y;
+                        point2.z = point1.z;
+                    }
+                    rays[i] = Ray(point1, point2);
+                }
+
+                for (uint32 i=0; i < RayPacket::MAX_NB_RAYS; i++) {
+
+                    BroadPhaseRaycastDataCallback treeCallback(treeBroadPhase);
+                    BroadPhaseRaycastDataCallback sweepAndPruneCallback(sweepAndPrune);
+                    BroadPhaseRaycastDataCallback hashGridCallback(hashGrid);
+                    treeBroadPhase.raycast(rays[i], treeCallback);
+                    sweepAndPrune.raycast(rays[i], sweepAndPruneCallback);
+                    hashGrid.raycast(rays[i], hashGridCallback);
+
+                    isValid &= treeCallback.mHitObjects == sweepAndPruneCallback.mHitObjects;
+                    isValid &= treeCallback.mHitObjects == hashGridCallback.mHitObjects;
+                    hasHits |= treeCallback.mHitObjects.size() > 0;
+
+                    // Each object of the grid must only be reported once
+                    isValid &= hashGridCallback.mNbHits == hashGridCallback.mHitObjects.size();
+                }
+
+                // Cast the rays as a packet
+                RayPacket packet(rays, RayPacket::MAX_NB_RAYS);
+                BroadPhaseRayPacketDataCallback treePacketCallback(treeBroadPhase);
+                BroadPhaseRayPacketDataCallback hashGridPacketCallback(hashGrid);
+                treeBroadPhase.raycast(packet, stack, treePacketCallback);
+                hashGrid.raycast(packet, stack, hashGridPacketCallback);
+
+                uint32 nbHitObjects = 0;
+                for (uint32 i=0; i < RayPacket::MAX_NB_RAYS; i++) {
+                    isValid &= treePacketCallback.mHitObjects[i] == hashGridPacketCallback.mHitObjects[i];
+                    nbHitObjects += static_cast<uint32>(hashGridPacketCallback.mHitObjects[i].size());
+                }
+                isValid &= hashGridPacketCallback.mNbHits == nbHitObjects;
+            }
+
+            rp3d_test(isValid);
+            rp3d_test(hasHits);
+        }
+ };
+
+}
+
+#endif
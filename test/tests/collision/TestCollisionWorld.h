@@ -255,6 +255,81 @@ class WorldOverlapCallback : public OverlapCallback {
 		}
 };
 
+/// Collision callback that records the largest penetration depth of the contact points of each contact pair
+class ContactPairsCallback : public CollisionCallback {
+
+    private:
+
+        std::map<std::pair<const Collider*, const Collider*>, decimal> mPenetrationDepths;
+
+        std::map<std::pair<const Collider*, const Collider*>, uint> mNbContactPoints;
+
+        std::pair<const Collider*, const Collider*> getKeyPair(const Collider* collider1, const Collider* collider2) const {
+            return collider1 < collider2 ? std::make_pair(collider1, collider2) : std::make_pair(collider2, collider1);
+        }
+
+    public:
+
+        bool isContactPair(const Collider* collider1, const Collider* collider2) const {
+            return mPenetrationDepths.find(getKeyPair(collider1, collider2)) != mPenetrationDepths.end();
+        }
+
+        decimal getPenetrationDepth(const Collider* collider1, const Collider* collider2) const {
+            auto it = mPenetrationDepths.find(getKeyPair(collider1, collider2));
+            return it != mPenetrationDepths.end() ? it->second : decimal(0.0);
+        }
+
+        uint getNbContactPoints(const Collider* collider1, const Collider* collider2) const {
+            auto it = mNbContactPoints.find(getKeyPair(collider1, collider2));
+            return it != mNbContactPoints.end() ? it->second : 0;
+        }
+
+        // This method is called when some contacts occur
+        virtual void onContact(const CallbackData& callbackData) override {
+
+            for (uint p=0; p < callbackData.getNbContactPairs(); p++) {
+
+                ContactPair contactPair = callbackData.getContactPair(p);
+                for (uint c=0; c < contactPair.getNbContactPoints(); c++) {
+                    decimal& penetrationDepth = mPenetrationDepths[getKeyPair(contactPair.getCollider1(), contactPair.getCollider2())];
+                    penetrationDepth = std::max(penetrationDepth, contactPair.getContactPoint(c).getPenetrationDepth());
+                    mNbContactPoints[getKeyPair(contactPair.getCollider1(), contactPair.getCollider2())]++;
+                }
+            }
+        }
+};
+
+/// Event listener that records the contact points reported by the last update of a world
+class ContactPointsEventListener : public EventListener {
+
+    public:
+
+        /// Colliders of the recorded contact points
+        std::pair<const Collider*, const Collider*> colliders;
+
+        /// Recorded contact points
+        std::vector<CollisionPointData> contactPoints;
+
+        // This method is called when some contacts occur
+        virtual void onContact(const CollisionCallback::CallbackData& callbackData) override {
+
+            contactPoints.clear();
+
+            for (uint p=0; p < callbackData.getNbContactPairs(); p++) {
+
+                CollisionCallback::ContactPair contactPair = callbackData.getContactPair(p);
+                colliders = std::make_pair(contactPair.getCollider1(), contactPair.getCollider2());
+
+                for (uint c=0; c < contactPair.getNbContactPoints(); c++) {
+
+                    CollisionCallback::ContactPoint contactPoint = contactPair.getContactPoint(c);
+                    contactPoints.push_back(CollisionPointData(contactPoint.getLocalPointOnCollider1(), contactPoint.getLocalPointOnCollider2(),
+                                                               contactPoint.getPenetrationDepth()));
+                }
+            }
+        }
+};
+
 // Class TestCollisionWorld
 /**
  * Unit test for the CollisionWorld class.
@@ -513,6 +588,15 @@ class TestCollisionWorld : public Test {
             testConvexMeshVsConvexMeshCollision();
             testConvexMeshVsCapsuleCollision();
             testConvexMeshVsConcaveMeshCollision();
+
+            testManySpheresAndCapsulesCollision();
+            testSpheresVsLargeConvexMeshCollision();
+            testRotatedBoxVsBoxCollision();
+            testRotatedSphereAndCapsuleVsBoxCollision();
+            testRestingBodiesWithCachedContactPoints();
+            testHeightFieldMinMaxHeightPyramid();
+            testConvexVsConcaveOverlappingTrianglesCache();
+            testFatAABBInflatePercentageOfDisabledCollider();
         }
 
 		void testNoCollisions() {
@@ -2953,6 +3037,761 @@ class TestCollisionWorld : public Test {
             mCapsuleBody1->setTransform(initTransform1);
             mConcaveMeshBody->setTransform(initTransform2);
         }
+
+        /// Test many pairs of spheres and of spheres and capsules (tested several pairs at a time by the narrow-phase)
+        void testManySpheresAndCapsulesCollision() {
+
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld();
+
+            SphereShape* sphereShape = mPhysicsCommon.createSphereShape(decimal(0.5));
+            CapsuleShape* capsuleShape = mPhysicsCommon.createCapsuleShape(decimal(0.5), decimal(2.0));
+
+            // Capsules with their inner segment along the x axis
+            const Quaternion capsuleOrientation = Quaternion::fromEulerAngles(0, 0, PI * decimal(0.5));
+
+            const int nbPairs = 11;
+            std::vector<Collider*> sphereColliders1;
+            std::vector<Collider*> sphereColliders2;
+            std::vector<Collider*> capsuleColliders;
+            std::vector<Collider*> sphereColliders3;
+            for (int i=0; i < nbPairs; i++) {
+
+                // The pairs of shapes are alternatively overlapping or separated by a small distance
+                const decimal gap = i % 2 == 0 ? decimal(-0.1) : decimal(0.1);
+                const decimal x = decimal(10 * i);
+
+                // Pair of spheres
+                CollisionBody* sphereBody1 = world->createCollisionBody(Transform(Vector3(x, 0, 0), Quaternion::identity()));
+                CollisionBody* sphereBody2 = world->createCollisionBody(Transform(Vector3(x + decimal(1.0) + gap, 0, 0), Quaternion::identity()));
+                sphereColliders1.push_back(sphereBody1->addCollider(sphereShape, Transform::identity()));
+                sphereColliders2.push_back(sphereBody2->addCollider(sphereShape, Transform::identity()));
+
+                // Pair of a capsule and a sphere close to the end or to the middle of the capsule inner segment
+                const Vector3 spherePosition = i % 4 < 2 ? Vector3(x + decimal(2.0) + gap, 20, 0) : Vector3(x, decimal(21.0) + gap, 0);
+                CollisionBody* capsuleBody = world->createCollisionBody(Transform(Vector3(x, 20, 0), capsuleOrientation));
+                CollisionBody* sphereBody3 = world->createCollisionBody(Transform(spherePosition, Quaternion::identity()));
+                capsuleColliders.push_back(capsuleBody->addCollider(capsuleShape, Transform::identity()));
+                sphereColliders3.push_back(sphereBody3->addCollider(sphereShape, Transform::identity()));
+            }
+
+            ContactPairsCallback contactPairsCallback;
+            world->testCollision(contactPairsCallback);
+
+            for (int i=0; i < nbPairs; i++) {
+
+                const bool isOverlapping = i % 2 == 0;
+
+                rp3d_test(contactPairsCallback.isContactPair(sphereColliders1[i], sphereColliders2[i]) == isOverlapping);
+                rp3d_test(contactPairsCallback.isContactPair(capsuleColliders[i], sphereColliders3[i]) == isOverlapping);
+
+                if (isOverlapping) {
+                    rp3d_test(approxEqual(contactPairsCallback.getPenetrationDepth(sphereColliders1[i], sphereColliders2[i]), decimal(0.1), decimal(0.0001)));
+                    rp3d_test(approxEqual(contactPairsCallback.getPenetrationDepth(capsuleColliders[i], sphereColliders3[i]), decimal(0.1), decimal(0.0001)));
+                }
+            }
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+        }
+
+        void testSpheresVsLargeConvexMeshCollision() {
+
+            // Prism with a regular polygon base (the first vertices are on the bottom face
+            // and the next ones on the top face)
+            const int nbSides = 32;
+            const float radius = 2.0f;
+            std::vector<float> vertices;
+            for (int h=0; h < 2; h++) {
+                for (int i=0; i < nbSides; i++) {
+                    const float angle = float(i) * 2.0f * float(PI) / float(nbSides);
+                    vertices.push_back(radius * std::cos(angle));
+                    vertices.push_back(radius * std::sin(angle));
+                    vertices.push_back(h == 0 ? -1.0f : 1.0f);
+                }
+            }
+
+            // Faces of the prism: the top face is either a single polygon or a fan of coplanar
+            // triangles (in which case the support points cannot be found with hill-climbing)
+            for (int t=0; t < 2; t++) {
+
+                const bool isTopFaceTriangulated = t == 1;
+
+                std::vector<int> indices;
+                std::vector<PolygonVertexArray::PolygonFace> faces;
+                for (int i=0; i < nbSides; i++) {
+                    const int next = (i + 1) % nbSides;
+                    PolygonVertexArray::PolygonFace face;
+                    face.indexBase = indices.size();
+                    face.nbVertices = 4;
+                    indices.push_back(i); indices.push_back(next);
+                    indices.push_back(nbSides + next); indices.push_back(nbSides + i);
+                    faces.push_back(face);
+                }
+                PolygonVertexArray::PolygonFace bottomFace;
+                bottomFace.indexBase = indices.size();
+                bottomFace.nbVertices = nbSides;
+                for (int i=nbSides-1; i >= 0; i--) {
+                    indices.push_back(i);
+                }
+                faces.push_back(bottomFace);
+                if (isTopFaceTriangulated) {
+                    for (int i=1; i < nbSides - 1; i++) {
+                        PolygonVertexArray::PolygonFace face;
+                        face.indexBase = indices.size();
+                        face.nbVertices = 3;
+                        indices.push_back(nbSides); indices.push_back(nbSides + i); indices.push_back(nbSides + i + 1);
+                        faces.push_back(face);
+                    }
+                }
+                else {
+                    PolygonVertexArray::PolygonFace topFace;
+                    topFace.indexBase = indices.size();
+                    topFace.nbVertices = nbSides;
+                    for (int i=0; i < nbSides; i++) {
+                        indices.push_back(nbSides + i);
+                    }
+                    faces.push_back(topFace);
+                }
+
+                PolygonVertexArray polygonVertexArray(2 * nbSides, &(vertices[0]), 3 * sizeof(float),
+                                                      &(indices[0]), sizeof(int), faces.size(), &(faces[0]),
+                                                      PolygonVertexArray::VertexDataType::VERTEX_FLOAT_TYPE,
+                                                      PolygonVertexArray::IndexDataType::INDEX_INTEGER_TYPE);
+                PolyhedronMesh* polyhedronMesh = mPhysicsCommon.createPolyhedronMesh(&polygonVertexArray);
+                rp3d_test(polyhedronMesh->isStrictlyConvex() == !isTopFaceTriangulated);
+
+                const Vector3 scale(1, 1, 2);
+                ConvexMeshShape* convexMeshShape = mPhysicsCommon.createConvexMeshShape(polyhedronMesh, scale);
+
+                PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld();
+
+                const Transform meshTransform(Vector3(1, 2, 3), Quaternion::fromEulerAngles(decimal(0.3), decimal(-0.2), decimal(0.7)));
+                CollisionBody* meshBody = world->createCollisionBody(meshTransform);
+                Collider* meshCollider = meshBody->addCollider(convexMeshShape, Transform::identity());
+
+                // Spheres close to the vertices of the middle and of the top of the prism (the closest
+                // point of the prism to a sphere is a vertex or a point on a vertical edge). The spheres
+                // are alternatively overlapping or separated by a small distance.
+                SphereShape* sphereShape = mPhysicsCommon.createSphereShape(decimal(0.25));
+                std::vector<Collider*> sphereColliders;
+                for (int i=0; i < 2 * nbSides; i++) {
+
+                    const decimal gap = i % 2 == 0 ? decimal(-0.1) : decimal(0.1);
+                    const int vertexIndex = i % nbSides;
+                    const Vector3 radialDirection(vertices[3 * vertexIndex], vertices[3 * vertexIndex + 1], 0);
+                    Vector3 closestPoint = radialDirection;
+                    Vector3 direction = radialDirection.getUnit();
+                    if (i >= nbSides) {
+                        closestPoint.z = decimal(2.0);
+                        direction = (direction + Vector3(0, 0, 1)).getUnit();
+                    }
+                    const Vector3 sphereLocalPosition = closestPoint + direction * (decimal(0.25) + gap);
+
+                    CollisionBody* sphereBody = world->createCollisionBody(Transform(meshTransform * sphereLocalPosition, Quaternion::identity()));
+                    sphereColliders.push_back(sphereBody->addCollider(sphereShape, Transform::identity()));
+                }
+
+                // Test the collisions twice to also use the support vertices cached at the previous frame
+                for (int frame=0; frame < 2; frame++) {
+
+                    ContactPairsCallback contactPairsCallback;
+                    world->testCollision(contactPairsCallback);
+
+                    for (int i=0; i < 2 * nbSides; i++) {
+
+                        const bool isOverlapping = i % 2 == 0;
+
+                        rp3d_test(contactPairsCallback.isContactPair(meshCollider, sphereColliders[i]) == isOverlapping);
+                        if (isOverlapping) {
+                            rp3d_test(approxEqual(contactPairsCallback.getPenetrationDepth(meshCollider, sphereColliders[i]), decimal(0.1), decimal(0.001)));
+                        }
+                    }
+                }
+
+                mPhysicsCommon.destroyPhysicsWorld(world);
+                mPhysicsCommon.destroySphereShape(sphereShape);
+                mPhysicsCommon.destroyConvexMeshShape(convexMeshShape);
+                mPhysicsCommon.destroyPolyhedronMesh(polyhedronMesh);
+            }
+        }
+
+        /// Return the penetration depth of two boxes with the same half-extents computed with the separating axis
+        /// theorem. The depth is the smallest overlap of the boxes along the fifteen candidate axes (the three face
+        /// normals of each box and the nine cross products of their edge directions).
+        static decimal computeBoxesSATPenetrationDepth(const Vector3& halfExtents, const Transform& transform1,
+                                                       const Transform& transform2) {
+
+            const Matrix3x3 orientation1 = transform1.getOrientation().getMatrix();
+            const Matrix3x3 orientation2 = transform2.getOrientation().getMatrix();
+            const Vector3 centersVector = transform2.getPosition() - transform1.getPosition();
+
+            std::vector<Vector3> axes;
+            for (int i=0; i < 3; i++) {
+                axes.push_back(orientation1.getColumn(i));
+                axes.push_back(orientation2.getColumn(i));
+                for (int j=0; j < 3; j++) {
+
+                    // The cross product of two parallel edges is not a separating axis candidate
+                    const Vector3 axis = orientation1.getColumn(i).cross(orientation2.getColumn(j));
+                    if (axis.length() > decimal(0.001)) {
+                        axes.push_back(axis.getUnit());
+                    }
+                }
+            }
+
+            decimal minOverlap = DECIMAL_LARGEST;
+            for (uint a=0; a < axes.size(); a++) {
+
+                decimal radius1 = 0;
+                decimal radius2 = 0;
+                for (int i=0; i < 3; i++) {
+                    radius1 += halfExtents[i] * std::abs(orientation1.getColumn(i).dot(axes[a]));
+                    radius2 += halfExtents[i] * std::abs(orientation2.getColumn(i).dot(axes[a]));
+                }
+
+                minOverlap = std::min(minOverlap, radius1 + radius2 - std::abs(centersVector.dot(axes[a])));
+            }
+
+            return minOverlap;
+        }
+
+        /// Test a shape with random poses against a box shape and against the same box as a convex mesh (tested
+        /// with the generic convex polyhedron algorithms). The pairs of the box and of the convex mesh must collide
+        /// in the same way. The shapes under test alternate between the two shapes and a null shape is replaced
+        /// by the box (or by the convex mesh) itself. The penetration depths of two boxes are compared with the
+        /// depths computed with the separating axis theorem.
+        void testRandomPosesVsBox(CollisionShape* shape1, CollisionShape* shape2, decimal minDistance, decimal distanceRange,
+                                  bool isPenetrationDepthCompared) {
+
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld();
+
+            const Vector3 halfExtents(decimal(1.0), decimal(0.5), decimal(1.5));
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(halfExtents);
+
+            float vertices[24];
+            for (int i=0; i < 8; i++) {
+                vertices[3 * i] = (i & 1) != 0 ? float(halfExtents.x) : float(-halfExtents.x);
+                vertices[3 * i + 1] = (i & 2) != 0 ? float(halfExtents.y) : float(-halfExtents.y);
+                vertices[3 * i + 2] = (i & 4) != 0 ? float(halfExtents.z) : float(-halfExtents.z);
+            }
+            int indices[24] = {0, 4, 6, 2,   1, 3, 7, 5,   0, 1, 5, 4,   2, 6, 7, 3,   0, 2, 3, 1,   4, 5, 7, 6};
+            PolygonVertexArray::PolygonFace faces[6];
+            for (int f=0; f < 6; f++) {
+                faces[f].indexBase = 4 * f;
+                faces[f].nbVertices = 4;
+            }
+            PolygonVertexArray polygonVertexArray(8, vertices, 3 * sizeof(float), indices, sizeof(int), 6, faces,
+                                                  PolygonVertexArray::VertexDataType::VERTEX_FLOAT_TYPE,
+                                                  PolygonVertexArray::IndexDataType::INDEX_INTEGER_TYPE);
+            PolyhedronMesh* polyhedronMesh = mPhysicsCommon.createPolyhedronMesh(&polygonVertexArray);
+            ConvexMeshShape* convexMeshShape = mPhysicsCommon.createConvexMeshShape(polyhedronMesh);
+
+            const int nbPairs = 60;
+            std::vector<Collider*> boxColliders, meshColliders, boxOtherColliders, meshOtherColliders;
+            std::vector<Transform> boxTransforms, boxOtherTransforms;
+            for (int i=0; i < nbPairs; i++) {
+
+                const decimal a = decimal(i);
+                const Quaternion orientation1 = Quaternion::fromEulerAngles(std::sin(a) * PI, std::cos(decimal(1.3) * a) * PI, std::sin(decimal(0.7) * a + 1) * PI);
+                const Quaternion orientation2 = Quaternion::fromEulerAngles(std::cos(decimal(2.1) * a) * PI, std::sin(decimal(1.7) * a) * PI, std::cos(a + 2) * PI);
+                const Vector3 direction = Vector3(std::sin(decimal(3.1) * a), std::cos(decimal(2.3) * a), std::sin(decimal(1.1) * a + decimal(0.5))).getUnit();
+                const decimal distance = minDistance + distanceRange * (std::sin(decimal(5.3) * a) + decimal(1.0)) * decimal(0.5);
+
+                const Vector3 position1(decimal(10 * i), 50, 0);
+                const Vector3 position2 = position1 + distance * direction;
+
+                CollisionShape* otherShape = i % 2 == 0 ? shape1 : shape2;
+
+                boxTransforms.push_back(Transform(position1, orientation1));
+                boxOtherTransforms.push_back(Transform(position2, orientation2));
+
+                CollisionBody* boxBody = world->createCollisionBody(Transform(position1, orientation1));
+                CollisionBody* boxOtherBody = world->createCollisionBody(Transform(position2, orientation2));
+                CollisionBody* meshBody = world->createCollisionBody(Transform(position1 + Vector3(0, 50, 0), orientation1));
+                CollisionBody* meshOtherBody = world->createCollisionBody(Transform(position2 + Vector3(0, 50, 0), orientation2));
+                boxColliders.push_back(boxBody->addCollider(boxShape, Transform::identity()));
+                boxOtherColliders.push_back(boxOtherBody->addCollider(otherShape != nullptr ? otherShape : boxShape, Transform::identity()));
+                meshColliders.push_back(meshBody->addCollider(convexMeshShape, Transform::identity()));
+                meshOtherColliders.push_back(meshOtherBody->addCollider(otherShape != nullptr ? otherShape : convexMeshShape, Transform::identity()));
+            }
+
+            ContactPairsCallback contactPairsCallback;
+            world->testCollision(contactPairsCallback);
+
+            int nbCollidingPairs = 0;
+            for (int i=0; i < nbPairs; i++) {
+
+                const bool isBoxPairColliding = contactPairsCallback.isContactPair(boxColliders[i], boxOtherColliders[i]);
+                rp3d_test(isBoxPairColliding == contactPairsCallback.isContactPair(meshColliders[i], meshOtherColliders[i]));
+
+                // Penetration depth of two boxes with the separating axis theorem (negative if they are separated)
+                const bool isBoxVsBox = boxOtherColliders[i]->getCollisionShape() == boxShape;
+                const decimal satPenetrationDepth = isBoxVsBox ? computeBoxesSATPenetrationDepth(halfExtents, boxTransforms[i],
+                                                                                                 boxOtherTransforms[i]) : decimal(0.0);
+                if (isBoxVsBox && !isBoxPairColliding) {
+                    rp3d_test(satPenetrationDepth < decimal(0.001));
+                }
+
+                if (isBoxPairColliding) {
+                    const decimal penetrationDepth = contactPairsCallback.getPenetrationDepth(boxColliders[i], boxOtherColliders[i]);
+                    rp3d_test(penetrationDepth > decimal(0.0));
+                    if (isPenetrationDepthCompared) {
+                        rp3d_test(approxEqual(penetrationDepth, contactPairsCallback.getPenetrationDepth(meshColliders[i], meshOtherColliders[i]),
+                                              decimal(0.01)));
+                    }
+                    if (isBoxVsBox) {
+                        rp3d_test(approxEqual(penetrationDepth, satPenetrationDepth, decimal(0.001)));
+                    }
+                    nbCollidingPairs++;
+                }
+            }
+
+            // Make sure that the random poses test both colliding and separated pairs
+            rp3d_test(nbCollidingPairs > 0 && nbCollidingPairs < nbPairs);
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+            mPhysicsCommon.destroyBoxShape(boxShape);
+            mPhysicsCommon.destroyConvexMeshShape(convexMeshShape);
+            mPhysicsCommon.destroyPolyhedronMesh(polyhedronMesh);
+        }
+
+        void testRotatedBoxVsBoxCollision() {
+
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld();
+
+            // ---------- Face contact ---------- //
+
+            // Box rotated around the vertical axis on the top face of another box
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(decimal(1.0), decimal(0.5), decimal(1.5)));
+            CollisionBody* body1 = world->createCollisionBody(Transform(Vector3(0, 0, 0), Quaternion::identity()));
+            CollisionBody* body2 = world->createCollisionBody(Transform(Vector3(decimal(0.2), decimal(0.9), 0),
+                                                                        Quaternion::fromEulerAngles(0, PI * decimal(0.25), 0)));
+            Collider* faceCollider1 = body1->addCollider(boxShape, Transform::identity());
+            Collider* faceCollider2 = body2->addCollider(boxShape, Transform::identity());
+
+            // ---------- Edge contact ---------- //
+
+            // Two cubes rotated by 45 degrees around the z and x axes (crossing edges)
+            BoxShape* cubeShape = mPhysicsCommon.createBoxShape(Vector3(1, 1, 1));
+            const decimal sqrt2 = std::sqrt(decimal(2.0));
+            CollisionBody* body3 = world->createCollisionBody(Transform(Vector3(0, 0, 20), Quaternion::fromEulerAngles(0, 0, PI * decimal(0.25))));
+            CollisionBody* body4 = world->createCollisionBody(Transform(Vector3(0, 2 * sqrt2 - decimal(0.05), 20),
+                                                                        Quaternion::fromEulerAngles(PI * decimal(0.25), 0, 0)));
+            Collider* edgeCollider1 = body3->addCollider(cubeShape, Transform::identity());
+            Collider* edgeCollider2 = body4->addCollider(cubeShape, Transform::identity());
+
+            ContactPairsCallback contactPairsCallback;
+            world->testCollision(contactPairsCallback);
+
+            rp3d_test(contactPairsCallback.isContactPair(faceCollider1, faceCollider2));
+            rp3d_test(approxEqual(contactPairsCallback.getPenetrationDepth(faceCollider1, faceCollider2), decimal(0.1), decimal(0.0001)));
+
+            rp3d_test(contactPairsCallback.isContactPair(edgeCollider1, edgeCollider2));
+            rp3d_test(approxEqual(contactPairsCallback.getPenetrationDepth(edgeCollider1, edgeCollider2), decimal(0.05), decimal(0.0001)));
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+            mPhysicsCommon.destroyBoxShape(boxShape);
+            mPhysicsCommon.destroyBoxShape(cubeShape);
+
+            // ---------- Random poses ---------- //
+
+            // Pairs of boxes and pairs of convex meshes with the same random poses
+            testRandomPosesVsBox(nullptr, nullptr, decimal(1.0), decimal(1.5), false);
+        }
+
+        void testRotatedSphereAndCapsuleVsBoxCollision() {
+
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld();
+
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(decimal(1.0), decimal(0.5), decimal(1.5)));
+            SphereShape* sphereShape = mPhysicsCommon.createSphereShape(decimal(0.3));
+            CapsuleShape* capsuleShape = mPhysicsCommon.createCapsuleShape(decimal(0.25), decimal(1.0));
+
+            // Rotated box (the other shapes are placed in its local-space)
+            const Transform boxTransform(Vector3(0, 0, 0), Quaternion::fromEulerAngles(decimal(0.3), decimal(0.7), decimal(-0.4)));
+            CollisionBody* boxBody = world->createCollisionBody(boxTransform);
+            Collider* boxCollider = boxBody->addCollider(boxShape, Transform::identity());
+
+            // ---------- Center of the sphere inside the box ---------- //
+
+            CollisionBody* sphereBody = world->createCollisionBody(boxTransform * Transform(Vector3(decimal(0.2), decimal(0.35), 0),
+                                                                                             Quaternion::identity()));
+            Collider* sphereCollider = sphereBody->addCollider(sphereShape, Transform::identity());
+
+            // ---------- Capsule lying on the top face of the box ---------- //
+
+            CollisionBody* lyingCapsuleBody = world->createCollisionBody(boxTransform * Transform(Vector3(decimal(0.1), decimal(0.7), decimal(0.2)),
+                                                                                                   Quaternion::fromEulerAngles(0, 0, PI * decimal(0.5))));
+            Collider* lyingCapsuleCollider = lyingCapsuleBody->addCollider(capsuleShape, Transform::identity());
+
+            // ---------- Inner segment of the capsule inside the box ---------- //
+
+            CollisionBody* deepCapsuleBody = world->createCollisionBody(boxTransform * Transform(Vector3(decimal(0.7), 0, decimal(0.3)),
+                                                                                                  Quaternion::identity()));
+            Collider* deepCapsuleCollider = deepCapsuleBody->addCollider(capsuleShape, Transform::identity());
+
+            ContactPairsCallback contactPairsCallback;
+            world->testCollision(contactPairsCallback);
+
+            rp3d_test(contactPairsCallback.isContactPair(boxCollider, sphereCollider));
+            rp3d_test(contactPairsCallback.getNbContactPoints(boxCollider, sphereCollider) == 1);
+            rp3d_test(approxEqual(contactPairsCallback.getPenetrationDepth(boxCollider, sphereCollider), decimal(0.45), decimal(0.0001)));
+
+            rp3d_test(contactPairsCallback.isContactPair(boxCollider, lyingCapsuleCollider));
+            rp3d_test(contactPairsCallback.getNbContactPoints(boxCollider, lyingCapsuleCollider) == 2);
+            rp3d_test(approxEqual(contactPairsCallback.getPenetrationDepth(boxCollider, lyingCapsuleCollider), decimal(0.05), decimal(0.0001)));
+
+            rp3d_test(contactPairsCallback.isContactPair(boxCollider, deepCapsuleCollider));
+            rp3d_test(contactPairsCallback.getNbContactPoints(boxCollider, deepCapsuleCollider) == 2);
+            rp3d_test(approxEqual(contactPairsCallback.getPenetrationDepth(boxCollider, deepCapsuleCollider), decimal(0.55), decimal(0.0001)));
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+            mPhysicsCommon.destroyBoxShape(boxShape);
+            mPhysicsCommon.destroySphereShape(sphereShape);
+            mPhysicsCommon.destroyCapsuleShape(capsuleShape);
+
+            // ---------- Random poses ---------- //
+
+            // Spheres and capsules against a box and against a convex mesh with the same random poses
+            SphereShape* randomSphereShape = mPhysicsCommon.createSphereShape(decimal(0.6));
+            CapsuleShape* randomCapsuleShape = mPhysicsCommon.createCapsuleShape(decimal(0.4), decimal(1.2));
+            testRandomPosesVsBox(randomSphereShape, randomCapsuleShape, decimal(0.3), decimal(2.0), true);
+            mPhysicsCommon.destroySphereShape(randomSphereShape);
+            mPhysicsCommon.destroyCapsuleShape(randomCapsuleShape);
+        }
+
+        void testRestingBodiesWithCachedContactPoints() {
+
+            BoxShape* groundShape = mPhysicsCommon.createBoxShape(Vector3(20, 1, 20));
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5)));
+            SphereShape* sphereShape = mPhysicsCommon.createSphereShape(decimal(0.5));
+            CapsuleShape* capsuleShape = mPhysicsCommon.createCapsuleShape(decimal(0.3), decimal(1.0));
+
+            // Same resting bodies in a world that reuses the cached contact points of the pairs that
+            // barely move and in a world that always runs the narrow-phase algorithms
+            PhysicsWorld::WorldSettings settings;
+            settings.isSleepingEnabled = false;
+            PhysicsWorld* noReuseWorld = mPhysicsCommon.createPhysicsWorld(settings);
+            settings.narrowPhaseReuseLinearThreshold = decimal(0.001);
+            settings.narrowPhaseReuseAngularThreshold = decimal(0.2) * (PI / decimal(180.0));
+            PhysicsWorld* reuseWorld = mPhysicsCommon.createPhysicsWorld(settings);
+
+            std::vector<RigidBody*> reuseBodies;
+            std::vector<RigidBody*> noReuseBodies;
+            PhysicsWorld* worlds[2] = {reuseWorld, noReuseWorld};
+            for (int w=0; w < 2; w++) {
+
+                std::vector<RigidBody*>& bodies = w == 0 ? reuseBodies : noReuseBodies;
+
+                RigidBody* ground = worlds[w]->createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+                ground->setType(BodyType::STATIC);
+                ground->addCollider(groundShape, Transform::identity());
+
+                // Stack of three boxes
+                for (int i=0; i < 3; i++) {
+                    RigidBody* box = worlds[w]->createRigidBody(Transform(Vector3(0, decimal(0.5) + decimal(i), 0), Quaternion::identity()));
+                    box->addCollider(boxShape, Transform::identity());
+                    bodies.push_back(box);
+                }
+
+                RigidBody* sphere = worlds[w]->createRigidBody(Transform(Vector3(3, decimal(0.5), 0), Quaternion::identity()));
+                sphere->addCollider(sphereShape, Transform::identity());
+                bodies.push_back(sphere);
+
+                RigidBody* capsule = worlds[w]->createRigidBody(Transform(Vector3(-3, decimal(0.3), 0),
+                                                                          Quaternion::fromEulerAngles(0, 0, PI * decimal(0.5))));
+                capsule->addCollider(capsuleShape, Transform::identity());
+                bodies.push_back(capsule);
+            }
+
+            for (int i=0; i < 120; i++) {
+                reuseWorld->update(decimal(1.0) / decimal(60.0));
+                noReuseWorld->update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The bodies must stay at rest at the same positions in both worlds
+            const decimal expectedHeights[5] = {decimal(0.5), decimal(1.5), decimal(2.5), decimal(0.5), decimal(0.3)};
+            for (uint i=0; i < reuseBodies.size(); i++) {
+
+                const Vector3& position = reuseBodies[i]->getTransform().getPosition();
+                rp3d_test(approxEqual(position.y, expectedHeights[i], decimal(0.05)));
+                rp3d_test(approxEqual(position.x, noReuseBodies[i]->getTransform().getPosition().x, decimal(0.01)));
+                rp3d_test(approxEqual(position.y, noReuseBodies[i]->getTransform().getPosition().y, decimal(0.01)));
+                rp3d_test(approxEqual(position.z, noReuseBodies[i]->getTransform().getPosition().z, decimal(0.01)));
+            }
+
+            mPhysicsCommon.destroyPhysicsWorld(reuseWorld);
+            mPhysicsCommon.destroyPhysicsWorld(noReuseWorld);
+
+            // A kinematic sphere penetrating a static box. A new narrow-phase test of the pair returns a contact
+            // point right below the center of the sphere. Therefore, after a small horizontal move of the sphere,
+            // only the re-projection of the cached contact point keeps the contact point at its previous location
+            // on the box
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(settings);
+            ContactPointsEventListener eventListener;
+            world->setEventListener(&eventListener);
+
+            RigidBody* ground = world->createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            ground->setType(BodyType::STATIC);
+            Collider* groundCollider = ground->addCollider(groundShape, Transform::identity());
+
+            RigidBody* sphere = world->createRigidBody(Transform(Vector3(0, decimal(0.45), 0), Quaternion::identity()));
+            sphere->setType(BodyType::KINEMATIC);
+            sphere->addCollider(sphereShape, Transform::identity());
+
+            const decimal sphereX[4] = {decimal(0.0), decimal(0.0005), decimal(0.0008), decimal(0.02)};
+            Vector3 groundPoints[4];
+            for (int i=0; i < 4; i++) {
+
+                sphere->setTransform(Transform(Vector3(sphereX[i], decimal(0.45), 0), Quaternion::identity()));
+                world->update(decimal(1.0) / decimal(60.0));
+
+                rp3d_test(eventListener.contactPoints.size() == 1);
+                if (eventListener.contactPoints.size() != 1) break;
+
+                const CollisionPointData& contactPoint = eventListener.contactPoints[0];
+                groundPoints[i] = eventListener.colliders.first == groundCollider ? contactPoint.localPointBody1 : contactPoint.localPointBody2;
+                rp3d_test(approxEqual(contactPoint.penetrationDepth, decimal(0.05), decimal(0.001)));
+            }
+
+            // Below the linear threshold (the sphere moved less than 1 millimeter since the narrow-phase test), the
+            // contact point is the cached one and not the one below the sphere
+            rp3d_test(approxEqual(groundPoints[0], Vector3(0, 1, 0), decimal(0.0001)));
+            rp3d_test(groundPoints[1] == groundPoints[0]);
+            rp3d_test(groundPoints[2] == groundPoints[0]);
+            rp3d_test(!approxEqual(groundPoints[2].x, sphereX[2], decimal(0.0001)));
+
+            // Above the linear threshold, the narrow-phase test runs again
+            rp3d_test(approxEqual(groundPoints[3], Vector3(sphereX[3], 1, 0), decimal(0.0001)));
+
+            // The cached contact points are not reused after the size of a collision shape has changed
+            sphereShape->setRadius(decimal(0.52));
+            world->update(decimal(1.0) / decimal(60.0));
+            rp3d_test(eventListener.contactPoints.size() == 1);
+            if (eventListener.contactPoints.size() == 1) {
+                rp3d_test(approxEqual(eventListener.contactPoints[0].penetrationDepth, decimal(0.07), decimal(0.001)));
+            }
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+            mPhysicsCommon.destroyBoxShape(groundShape);
+            mPhysicsCommon.destroyBoxShape(boxShape);
+            mPhysicsCommon.destroySphereShape(sphereShape);
+            mPhysicsCommon.destroyCapsuleShape(capsuleShape);
+        }
+
+        /// Test that the min/max height pyramid of a height field only removes the triangles
+        /// whose height range does not overlap with the AABB of an overlap query
+        void testHeightFieldMinMaxHeightPyramid() {
+
+            const int nbColumns = 45;
+            const int nbRows = 23;
+            std::vector<float> heights(nbColumns * nbRows);
+            for (int j=0; j < nbRows; j++) {
+                for (int i=0; i < nbColumns; i++) {
+                    heights[j * nbColumns + i] = float(10 + 4 * std::sin(i * 0.3) + 3 * std::cos(j * 0.5) + ((i * 3 + j * 7) % 4) * 0.25);
+                }
+            }
+
+            DefaultAllocator allocator;
+
+            for (int upAxis=0; upAxis < 3; upAxis++) {
+
+                HeightFieldShape* shape = mPhysicsCommon.createHeightFieldShape(nbColumns, nbRows, 0, 20, heights.data(),
+                                                                                HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE,
+                                                                                upAxis, 1, Vector3(decimal(2.0), decimal(0.5), decimal(1.5)));
+                Vector3 min, max;
+                shape->getLocalBounds(min, max);
+                const Vector3 extent = max - min;
+
+                uint nbTrianglesWithoutPyramid = 0;
+                uint nbTrianglesWithPyramid = 0;
+
+                for (int k=0; k < 40; k++) {
+
+                    // Query AABB above, below or crossing the terrain
+                    Vector3 aabbMin = min + Vector3(decimal((k * 13) % 17) / decimal(17.0) * extent.x,
+                                                    decimal((k * 7) % 19) / decimal(19.0) * extent.y,
+                                                    decimal((k * 11) % 23) / decimal(23.0) * extent.z);
+                    Vector3 aabbMax = aabbMin + extent * decimal(0.15);
+                    aabbMin[upAxis] = min[upAxis] + decimal(k % 10) / decimal(10.0) * extent[upAxis];
+                    aabbMax[upAxis] = aabbMin[upAxis] + extent[upAxis] * decimal(0.05);
+                    const AABB aabb(aabbMin, aabbMax);
+
+                    List<Vector3> allVertices(allocator), allNormals(allocator), vertices(allocator), normals(allocator);
+                    List<uint> allShapeIds(allocator), shapeIds(allocator);
+
+                    shape->enableMinMaxHeightPyramid(false);
+                    shape->computeOverlappingTriangles(aabb, allVertices, allNormals, allShapeIds, allocator);
+                    shape->enableMinMaxHeightPyramid(true);
+                    shape->computeOverlappingTriangles(aabb, vertices, normals, shapeIds, allocator);
+
+                    rp3d_test(shapeIds.size() <= allShapeIds.size());
+                    nbTrianglesWithoutPyramid += allShapeIds.size();
+                    nbTrianglesWithPyramid += shapeIds.size();
+
+                    // Each triangle whose height range overlaps with the AABB must be kept by the pyramid
+                    for (uint t=0; t < allShapeIds.size(); t++) {
+
+                        decimal triangleMin = DECIMAL_LARGEST;
+                        decimal triangleMax = DECIMAL_SMALLEST;
+                        for (uint v=0; v < 3; v++) {
+                            triangleMin = std::min(triangleMin, allVertices[t * 3 + v][upAxis]);
+                            triangleMax = std::max(triangleMax, allVertices[t * 3 + v][upAxis]);
+                        }
+
+                        const bool isKept = shapeIds.find(allShapeIds[t]) != shapeIds.end();
+                        if (triangleMin <= aabbMax[upAxis] && triangleMax >= aabbMin[upAxis]) {
+                            rp3d_test(isKept);
+                        }
+                    }
+                }
+
+                // The pyramid must remove the triangles of the AABBs above or below the terrain
+                rp3d_test(nbTrianglesWithPyramid < nbTrianglesWithoutPyramid);
+
+                mPhysicsCommon.destroyHeightFieldShape(shape);
+            }
+
+            // The pyramid is computed again when the height values have been modified
+            HeightFieldShape* shape = mPhysicsCommon.createHeightFieldShape(nbColumns, nbRows, 0, 20, heights.data(),
+                                                                            HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE,
+                                                                            1, 1, Vector3(decimal(2.0), decimal(0.5), decimal(1.5)));
+            shape->enableMinMaxHeightPyramid(true);
+            Vector3 min, max;
+            shape->getLocalBounds(min, max);
+            const AABB topAABB(Vector3(min.x, max.y - (max.y - min.y) * decimal(0.05), min.z), max);
+
+            List<Vector3> vertices(allocator), normals(allocator);
+            List<uint> shapeIds(allocator);
+            shape->computeOverlappingTriangles(topAABB, vertices, normals, shapeIds, allocator);
+            rp3d_test(shapeIds.size() == 0);
+
+            for (uint i=0; i < heights.size(); i++) {
+                heights[i] = 19.5f;
+            }
+            shape->notifyDataChanged();
+            rp3d_test(shape->isMinMaxHeightPyramidEnabled());
+            shape->computeOverlappingTriangles(topAABB, vertices, normals, shapeIds, allocator);
+            rp3d_test(shapeIds.size() == uint((nbColumns - 1) * (nbRows - 1) * 2));
+
+            mPhysicsCommon.destroyHeightFieldShape(shape);
+        }
+
+        /// Test the contacts of a box moved over a concave mesh. The overlapping triangles cached
+        /// for the pair must be reused for small motions and computed again for large ones
+        void testConvexVsConcaveOverlappingTrianglesCache() {
+
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld();
+
+            CollisionBody* meshBody = world->createCollisionBody(Transform::identity());
+            Collider* meshCollider = meshBody->addCollider(mConcaveMeshShape, Transform::identity());
+
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(decimal(0.3), decimal(0.3), decimal(0.3)));
+            CollisionBody* boxBody = world->createCollisionBody(Transform::identity());
+            Collider* boxCollider = boxBody->addCollider(boxShape, Transform::identity());
+
+            // Small motions, a motion to the other side of the mesh, a motion above the mesh and back to the start
+            const Vector3 positions[6] = {Vector3(decimal(-1.2), decimal(0.25), decimal(-1.4)), Vector3(decimal(-1.18), decimal(0.26), decimal(-1.39)),
+                                          Vector3(decimal(-1.17), decimal(0.24), decimal(-1.41)), Vector3(decimal(-1.0), decimal(0.2), decimal(1.6)),
+                                          Vector3(decimal(-1.0), decimal(1.0), decimal(1.6)), Vector3(decimal(-1.2), decimal(0.25), decimal(-1.4))};
+            const decimal expectedDepths[6] = {decimal(0.05), decimal(0.04), decimal(0.06), decimal(0.1), decimal(0.0), decimal(0.05)};
+
+            for (int k=0; k < 6; k++) {
+
+                boxBody->setTransform(Transform(positions[k], Quaternion::identity()));
+
+                mCollisionCallback.reset();
+                world->testCollision(boxBody, meshBody, mCollisionCallback);
+
+                if (expectedDepths[k] == decimal(0.0)) {
+                    rp3d_test(!mCollisionCallback.areCollidersColliding(boxCollider, meshCollider));
+                    continue;
+                }
+
+                rp3d_test(mCollisionCallback.areCollidersColliding(boxCollider, meshCollider));
+                const CollisionData* collisionData = mCollisionCallback.getCollisionData(boxCollider, meshCollider);
+                rp3d_test(collisionData != nullptr);
+                rp3d_test(collisionData->getTotalNbContactPoints() >= 1);
+
+                decimal maxDepth = 0;
+                for (size_t p=0; p < collisionData->contactPairs[0].contactPoints.size(); p++) {
+                    maxDepth = std::max(maxDepth, collisionData->contactPairs[0].contactPoints[p].penetrationDepth);
+                }
+                rp3d_test(approxEqual(maxDepth, expectedDepths[k], decimal(0.001)));
+            }
+
+            // Flat height field whose height values are modified. The box penetrates the terrain by 0.05 before
+            // the height values are raised by 0.1 and by 0.15 after
+            const int nbColumns = 9;
+            const int nbRows = 9;
+            std::vector<float> heights(nbColumns * nbRows, 5.0f);
+            HeightFieldShape* heightFieldShape = mPhysicsCommon.createHeightFieldShape(nbColumns, nbRows, 0, 10, heights.data(),
+                                                                                      HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE, 1);
+            CollisionBody* heightFieldBody = world->createCollisionBody(Transform::identity());
+            Collider* heightFieldCollider = heightFieldBody->addCollider(heightFieldShape, Transform::identity());
+
+            // The cache is computed, then the height values are modified without notifying the shape. A move inside
+            // the inflated AABB of the cache still uses the cached triangles (the old terrain) while a move outside
+            // of it computes the triangles again (the new terrain). Finally, the height values are restored and the
+            // shape is notified, which invalidates the cache even if the box moves inside its inflated AABB
+            const Vector3 boxPositions[4] = {Vector3(0, decimal(0.25), 0), Vector3(decimal(0.02), decimal(0.25), decimal(0.01)),
+                                             Vector3(decimal(2.5), decimal(0.25), decimal(2.5)), Vector3(decimal(2.52), decimal(0.25), decimal(2.5))};
+            const float heightValues[4] = {5.0f, 5.1f, 5.1f, 5.0f};
+            const decimal expectedTerrainDepths[4] = {decimal(0.05), decimal(0.05), decimal(0.15), decimal(0.05)};
+
+            for (int k=0; k < 4; k++) {
+
+                std::fill(heights.begin(), heights.end(), heightValues[k]);
+                if (k == 3) heightFieldShape->notifyDataChanged();
+
+                boxBody->setTransform(Transform(boxPositions[k], Quaternion::identity()));
+
+                mCollisionCallback.reset();
+                world->testCollision(boxBody, heightFieldBody, mCollisionCallback);
+
+                const CollisionData* collisionData = mCollisionCallback.getCollisionData(boxCollider, heightFieldCollider);
+                rp3d_test(collisionData != nullptr);
+                if (collisionData == nullptr) continue;
+
+                decimal maxDepth = 0;
+                for (size_t p=0; p < collisionData->contactPairs[0].contactPoints.size(); p++) {
+                    maxDepth = std::max(maxDepth, collisionData->contactPairs[0].contactPoints[p].penetrationDepth);
+                }
+                rp3d_test(approxEqual(maxDepth, expectedTerrainDepths[k], decimal(0.001)));
+            }
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+            mPhysicsCommon.destroyBoxShape(boxShape);
+            mPhysicsCommon.destroyHeightFieldShape(heightFieldShape);
+        }
+
+        void testFatAABBInflatePercentageOfDisabledCollider() {
+
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld();
+
+            SphereShape* sphereShape = mPhysicsCommon.createSphereShape(decimal(0.5));
+            CollisionBody* body1 = world->createCollisionBody(Transform::identity());
+            Collider* collider1 = body1->addCollider(sphereShape, Transform::identity());
+            CollisionBody* body2 = world->createCollisionBody(Transform(Vector3(decimal(0.9), 0, 0), Quaternion::identity()));
+            Collider* collider2 = body2->addCollider(sphereShape, Transform::identity());
+
+            // The collider of a disabled body is not in the broad-phase
+            body1->setIsActive(false);
+            rp3d_test(collider1->getBroadPhaseId() == -1);
+            collider1->setFatAABBInflatePercentage(decimal(0.5));
+            rp3d_test(approxEqual(collider1->getFatAABBInflatePercentage(), decimal(0.5)));
+            rp3d_test(collider1->getBroadPhaseId() == -1);
+
+            // The collider is added back to the broad-phase when its body is enabled
+            body1->setIsActive(true);
+            rp3d_test(collider1->getBroadPhaseId() != -1);
+
+            mCollisionCallback.reset();
+            world->testCollision(body1, body2, mCollisionCallback);
+            rp3d_test(mCollisionCallback.areCollidersColliding(collider1, collider2));
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+            mPhysicsCommon.destroySphereShape(sphereShape);
+        }
  };
 
 }
@@ -29,10 +29,14 @@
 // Libraries
 #include "Test.h"
 #include <reactphysics3d/collision/broadphase/DynamicAABBTree.h>
+#include <reactphysics3d/collision/broadphase/WideAABBTree.h>
+#include <reactphysics3d/collision/broadphase/QuantizedAABBTree.h>
 #include <reactphysics3d/memory/MemoryManager.h>
 #include <reactphysics3d/engine/PhysicsCommon.h>
+#include <reactphysics3d/engine/DefaultTaskScheduler.h>
 #include <reactphysics3d/utils/Profiler.h>
 #include <vector>
+#include <algorithm>
 
 /// Reactphysics3D namespace
 namespace reactphysics3d {
@@ -130,12 +134,34 @@ class TestDynamicAABBTree : public Test {
             return std::find(overlappingNodes.begin(), overlappingNodes.end(), nodeId) != overlappingNodes.end();
         }
 
+        /// Create a list of objects with pseudo-random AABBs
+        void createRandomObjects(List<DynamicAABBTreeObject>& objects, int nbObjects) const {
+
+            uint32 seed = 12345;
+            auto random = [&seed]() {
+                seed = seed * 1664525u + 1013904223u;
+                return decimal(seed >> 8) / decimal(1 << 24);
+            };
+
+            for (int i=0; i < nbObjects; i++) {
+                const Vector3 min(random() * 100, random() * 20, random() * 100);
+                const Vector3 size(random() * 2 + decimal(0.1), random() * 2 + decimal(0.1), random() * 2 + decimal(0.1));
+                objects.add(DynamicAABBTreeObject(AABB(min, min + size), i, 2 * i));
+            }
+        }
+
         /// Run the tests
         void run() {
 
             testBasicsMethods();
             testOverlapping();
             testRaycast();
+            testBulkBuild();
+            testWideTree();
+            testQuantizedTree();
+            testTreeVsTree();
+            testIncrementalOptimization();
+            testCompaction();
 
         }
 
@@ -560,6 +586,700 @@ class TestDynamicAABBTree : public Test {
             rp3d_test(mRaycastCallback.isHit(object4Id));
 
         }
+
+        void testBulkBuild() {
+
+            const int nbObjects = 5000;
+            List<DynamicAABBTreeObject> objects(mAllocator);
+            createRandomObjects(objects, nbObjects);
+
+            // ------------ Build the trees ---------- //
+
+            DynamicAABBTree tree(mAllocator);
+            DynamicAABBTree parallelTree(mAllocator);
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+            tree.setProfiler(mProfiler);
+            parallelTree.setProfiler(mProfiler);
+#endif
+
+            List<int32> nodesIds(mAllocator);
+            tree.build(objects, &nodesIds);
+
+            DefaultTaskScheduler scheduler(mAllocator, 4);
+            List<int32> parallelNodesIds(mAllocator);
+            parallelTree.build(objects, &parallelNodesIds, &scheduler);
+
+            // ----------- Tests ----------- //
+
+            rp3d_test(nodesIds.size() == nbObjects);
+
+            // The data, the AABBs and the node of each object must be the same in both trees
+            bool isValid = true;
+            for (int i=0; i < nbObjects; i++) {
+                isValid &= nodesIds[i] == parallelNodesIds[i];
+                isValid &= tree.getNodeDataInt(nodesIds[i])[0] == i;
+                isValid &= tree.getNodeDataInt(nodesIds[i])[1] == 2 * i;
+                isValid &= tree.getFatAABB(nodesIds[i]).getMin() == objects[i].aabb.getMin();
+                isValid &= tree.getFatAABB(nodesIds[i]).getMax() == objects[i].aabb.getMax();
+                isValid &= parallelTree.getNodeDataInt(parallelNodesIds[i])[0] == i;
+            }
+            rp3d_test(isValid);
+
+            // The height of a tree built with the SAH must stay small
+            rp3d_test(tree.computeHeight() < 40);
+
+            // The overlapping objects must be the same as with a brute-force test
+            AABB queries[3] = {AABB(Vector3(10, 0, 10), Vector3(20, 5, 20)), AABB(Vector3(-10, -10, -10), Vector3(110, 30, 110)),
+                               AABB(Vector3(50, 10, 0), Vector3(51, 11, 100))};
+            for (int q=0; q < 3; q++) {
+
+                List<int> overlappingNodes(mAllocator);
+                tree.reportAllShapesOverlappingWithAABB(queries[q], overlappingNodes);
+
+                List<int> parallelOverlappingNodes(mAllocator);
+                parallelTree.reportAllShapesOverlappingWithAABB(queries[q], parallelOverlappingNodes);
+
+                uint nbExpectedNodes = 0;
+                bool isFound = true;
+                for (int i=0; i < nbObjects; i++) {
+                    if (queries[q].testCollision(objects[i].aabb)) {
+                        nbExpectedNodes++;
+                        isFound &= isOverlapping(nodesIds[i], overlappingNodes);
+                    }
+                }
+                rp3d_test(isFound);
+                rp3d_test(overlappingNodes.size() == nbExpectedNodes);
+                rp3d_test(overlappingNodes == parallelOverlappingNodes);
+            }
+
+            // ------------ The tree must still be dynamic after a bulk-build ---------- //
+
+            for (int i=0; i < nbObjects; i += 2) {
+                tree.removeObject(nodesIds[i]);
+            }
+            int object1Data = 56;
+            int newObjectId = tree.addObject(AABB(Vector3(200, 200, 200), Vector3(201, 201, 201)), &object1Data);
+
+            List<int> overlappingNodes(mAllocator);
+            tree.reportAllShapesOverlappingWithAABB(AABB(Vector3(-10, -10, -10), Vector3(300, 300, 300)), overlappingNodes);
+            rp3d_test(overlappingNodes.size() == nbObjects / 2 + 1);
+            rp3d_test(isOverlapping(newObjectId, overlappingNodes));
+            rp3d_test(!isOverlapping(nodesIds[0], overlappingNodes));
+            rp3d_test(isOverlapping(nodesIds[1], overlappingNodes));
+
+            // ------------ Build a tree with a single object ---------- //
+
+            DynamicAABBTree smallTree(mAllocator);
+            List<DynamicAABBTreeObject> singleObject(mAllocator);
+            singleObject.add(DynamicAABBTreeObject(AABB(Vector3(1, 2, 3), Vector3(4, 5, 6)), &object1Data));
+            smallTree.build(singleObject);
+            rp3d_test(smallTree.getRootAABB().getMin() == Vector3(1, 2, 3));
+            rp3d_test(smallTree.getRootAABB().getMax() == Vector3(4, 5, 6));
+            rp3d_test(smallTree.computeHeight() == 0);
+        }
+
+        void testWideTree() {
+
+            const int nbObjects = 3000;
+            List<DynamicAABBTreeObject> objects(mAllocator);
+            createRandomObjects(objects, nbObjects);
+
+            // ------------ Collapse a bulk-built tree and a tree built by insertions ---------- //
+
+            DynamicAABBTree bulkTree(mAllocator);
+            bulkTree.build(objects);
+
+            DynamicAABBTree insertedTree(mAllocator, decimal(0.08));
+            for (int i=0; i < nbObjects; i++) {
+                insertedTree.addObject(objects[i].aabb, i, 0);
+            }
+
+            DynamicAABBTree* trees[2] = {&bulkTree, &insertedTree};
+            for (int t=0; t < 2; t++) {
+
+                const DynamicAABBTree& tree = *(trees[t]);
+
+                WideAABBTree wideTree(mAllocator);
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+                wideTree.setProfiler(mProfiler);
+#endif
+                rp3d_test(wideTree.isEmpty());
+                wideTree.build(tree);
+                rp3d_test(!wideTree.isEmpty());
+
+                // A wide node has up to four children
+                rp3d_test(wideTree.getNbNodes() >= (nbObjects - 1) / 3);
+                rp3d_test(wideTree.getNbNodes() < nbObjects);
+
+                // The overlapping leaves must be the same as in the binary tree
+                AABB queries[4] = {AABB(Vector3(10, 0, 10), Vector3(20, 5, 20)), AABB(Vector3(-10, -10, -10), Vector3(110, 30, 110)),
+                                   AABB(Vector3(50, 10, 0), Vector3(51, 11, 100)), AABB(Vector3(200, 0, 0), Vector3(210, 10, 10))};
+                for (int q=0; q < 4; q++) {
+
+                    List<int> expectedNodes(mAllocator);
+                    tree.reportAllShapesOverlappingWithAABB(queries[q], expectedNodes);
+
+                    List<int> overlappingNodes(mAllocator);
+                    wideTree.reportAllShapesOverlappingWithAABB(queries[q], overlappingNodes);
+
+                    Stack<int32> stack(mAllocator);
+                    List<Pair<int32, int32>> overlappingPairs(mAllocator);
+                    wideTree.reportAllShapesOverlappingWithAABB(queries[q], 7, stack, overlappingPairs);
+
+                    std::sort(expectedNodes.begin(), expectedNodes.end());
+                    std::sort(overlappingNodes.begin(), overlappingNodes.end());
+                    rp3d_test(overlappingNodes == expectedNodes);
+                    // The pairs contain the first data integer of the leaves
+                    List<int32> expectedData(mAllocator);
+                    List<int32> pairsData(mAllocator);
+                    bool isValid = overlappingPairs.size() == expectedNodes.size();
+                    for (uint i=0; i < overlappingPairs.size(); i++) {
+                        isValid &= overlappingPairs[i].first == 7;
+                        pairsData.add(overlappingPairs[i].second);
+                    }
+                    for (uint i=0; i < expectedNodes.size(); i++) {
+                        expectedData.add(tree.getNodeDataInt(expectedNodes[i])[0]);
+                    }
+                    std::sort(expectedData.begin(), expectedData.end());
+                    std::sort(pairsData.begin(), pairsData.end());
+                    rp3d_test(isValid);
+                    rp3d_test(pairsData == expectedData);
+                }
+
+                // The leaves hit by a ray must be the same as in the binary tree
+                Ray rays[4] = {Ray(Vector3(-10, 5, -10), Vector3(110, 5, 110)), Ray(Vector3(50, 30, 50), Vector3(50, -10, 50)),
+                               Ray(Vector3(0, 10, 40), Vector3(100, 10, 40)), Ray(Vector3(0, 50, 0), Vector3(100, 50, 100))};
+                for (int r=0; r < 4; r++) {
+
+                    mRaycastCallback.reset();
+                    tree.raycast(rays[r], mRaycastCallback);
+                    std::vector<int> expectedHitNodes = mRaycastCallback.mHitNodes;
+
+                    mRaycastCallback.reset();
+                    wideTree.raycast(rays[r], mRaycastCallback);
+                    std::vector<int> hitNodes = mRaycastCallback.mHitNodes;
+
+                    std::sort(expectedHitNodes.begin(), expectedHitNodes.end());
+                    std::sort(hitNodes.begin(), hitNodes.end());
+                    rp3d_test(hitNodes == expectedHitNodes);
+                }
+            }
+
+            // ------------ Collapse an empty tree and a tree with a single object ---------- //
+
+            DynamicAABBTree smallTree(mAllocator);
+            WideAABBTree wideTree(mAllocator);
+            wideTree.build(smallTree);
+            rp3d_test(wideTree.isEmpty());
+
+            List<int> overlappingNodes(mAllocator);
+            wideTree.reportAllShapesOverlappingWithAABB(AABB(Vector3(-10, -10, -10), Vector3(10, 10, 10)), overlappingNodes);
+            rp3d_test(overlappingNodes.size() == 0);
+
+            const int32 nodeId = smallTree.addObject(AABB(Vector3(1, 2, 3), Vector3(4, 5, 6)), 3, 4);
+            wideTree.build(smallTree);
+            rp3d_test(wideTree.getNbNodes() == 1);
+
+            wideTree.reportAllShapesOverlappingWithAABB(AABB(Vector3(-10, -10, -10), Vector3(10, 10, 10)), overlappingNodes);
+            rp3d_test(overlappingNodes.size() == 1);
+            rp3d_test(overlappingNodes[0] == nodeId);
+
+            mRaycastCallback.reset();
+            wideTree.raycast(Ray(Vector3(2, 3, -10), Vector3(2, 3, 10)), mRaycastCallback);
+            rp3d_test(mRaycastCallback.isHit(nodeId));
+
+            mRaycastCallback.reset();
+            wideTree.raycast(Ray(Vector3(2, 3, -10), Vector3(2, 3, 10), decimal(0.5)), mRaycastCallback);
+            rp3d_test(!mRaycastCallback.isHit(nodeId));
+
+            wideTree.reset();
+            rp3d_test(wideTree.isEmpty());
+        }
+
+        void testQuantizedTree() {
+
+            const int nbObjects = 3000;
+            List<DynamicAABBTreeObject> objects(mAllocator);
+            createRandomObjects(objects, nbObjects);
+
+            DynamicAABBTree tree(mAllocator);
+            tree.build(objects);
+
+            QuantizedAABBTree quantizedTree(mAllocator);
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+            quantizedTree.setProfiler(mProfiler);
+#endif
+            rp3d_test(quantizedTree.isEmpty());
+            quantizedTree.build(tree);
+            rp3d_test(!quantizedTree.isEmpty());
+
+            // ------------ Structure of the tree ---------- //
+
+            rp3d_test(quantizedTree.getNbLeaves() == nbObjects);
+            rp3d_test(quantizedTree.getNbNodes() >= (nbObjects - 1) / 3);
+            rp3d_test(quantizedTree.getNbNodes() < nbObjects);
+            rp3d_test(quantizedTree.getRootAABB().getMin() == tree.getRootAABB().getMin());
+            rp3d_test(quantizedTree.getRootAABB().getMax() == tree.getRootAABB().getMax());
+
+            // The data of the leaves are copied from the dynamic tree
+            List<bool> isLeafFound(mAllocator, nbObjects);
+            for (int i=0; i < nbObjects; i++) {
+                isLeafFound.add(false);
+            }
+            bool isDataValid = true;
+            for (uint32 i=0; i < quantizedTree.getNbLeaves(); i++) {
+                const int32* data = quantizedTree.getLeafDataInt(static_cast<int32>(i));
+                isDataValid &= data[0] >= 0 && data[0] < nbObjects && data[1] == 2 * data[0] && !isLeafFound[data[0]];
+                if (data[0] >= 0 && data[0] < nbObjects) isLeafFound[data[0]] = true;
+            }
+            rp3d_test(isDataValid);
+
+            // The compressed tree is several times smaller than the nodes of the dynamic and wide trees
+            WideAABBTree wideTree(mAllocator);
+            wideTree.build(tree);
+            const size_t uncompressedSize = (2 * nbObjects - 1) * sizeof(TreeNode) + wideTree.getNbNodes() * sizeof(WideTreeNode);
+            rp3d_test(quantizedTree.getSizeInBytes() * 4 < uncompressedSize);
+
+            // ------------ Overlapping queries ---------- //
+
+            // The quantized AABBs are a bit larger than the original ones. Therefore, all the leaves
+            // reported by the dynamic tree must be reported and the other ones must be very close to the query
+            AABB queries[5] = {AABB(Vector3(10, 0, 10), Vector3(20, 5, 20)), AABB(Vector3(-10, -10, -10), Vector3(110, 30, 110)),
+                               AABB(Vector3(50, 10, 0), Vector3(51, 11, 100)), AABB(Vector3(200, 0, 0), Vector3(210, 10, 10)),
+                               AABB(Vector3(30, 5, 30), Vector3(30, 5, 30))};
+            for (int q=0; q < 5; q++) {
+
+                List<int> expectedNodes(mAllocator);
+                tree.reportAllShapesOverlappingWithAABB(queries[q], expectedNodes);
+                List<int32> expectedObjects(mAllocator);
+                for (uint i=0; i < expectedNodes.size(); i++) {
+                    expectedObjects.add(tree.getNodeDataInt(expectedNodes[i])[0]);
+                }
+
+                List<int32> overlappingLeaves(mAllocator);
+                quantizedTree.reportAllShapesOverlappingWithAABB(queries[q], overlappingLeaves);
+                List<int32> overlappingObjects(mAllocator);
+                for (uint i=0; i < overlappingLeaves.size(); i++) {
+                    overlappingObjects.add(quantizedTree.getLeafDataInt(overlappingLeaves[i])[0]);
+                }
+
+                std::sort(expectedObjects.begin(), expectedObjects.end());
+                std::sort(overlappingObjects.begin(), overlappingObjects.end());
+                rp3d_test(std::includes(overlappingObjects.begin(), overlappingObjects.end(),
+                                        expectedObjects.begin(), expectedObjects.end()));
+
+                bool isClose = true;
+                for (uint i=0; i < overlappingObjects.size(); i++) {
+                    AABB objectAABB = objects[overlappingObjects[i]].aabb;
+                    objectAABB.inflate(decimal(0.01), decimal(0.01), decimal(0.01));
+                    isClose &= objectAABB.testCollision(queries[q]);
+                }
+                rp3d_test(isClose);
+            }
+
+            // ------------ Raycasting ---------- //
+
+            Ray rays[4] = {Ray(Vector3(-10, 5, -10), Vector3(110, 5, 110)), Ray(Vector3(50, 30, 50), Vector3(50, -10, 50)),
+                           Ray(Vector3(0, 10, 40), Vector3(100, 10, 40)), Ray(Vector3(0, 50, 0), Vector3(100, 50, 100))};
+            for (int r=0; r < 4; r++) {
+
+                mRaycastCallback.reset();
+                tree.raycast(rays[r], mRaycastCallback);
+                List<int32> expectedObjects(mAllocator);
+                for (uint i=0; i < mRaycastCallback.mHitNodes.size(); i++) {
+                    expectedObjects.add(tree.getNodeDataInt(mRaycastCallback.mHitNodes[i])[0]);
+                }
+
+                mRaycastCallback.reset();
+                quantizedTree.raycast(rays[r], mRaycastCallback);
+                List<int32> hitObjects(mAllocator);
+                for (uint i=0; i < mRaycastCallback.mHitNodes.size(); i++) {
+                    hitObjects.add(quantizedTree.getLeafDataInt(mRaycastCallback.mHitNodes[i])[0]);
+                }
+
+                std::sort(expectedObjects.begin(), expectedObjects.end());
+                std::sort(hitObjects.begin(), hitObjects.end());
+                rp3d_test(std::includes(hitObjects.begin(), hitObjects.end(), expectedObjects.begin(), expectedObjects.end()));
+
+                bool isClose = true;
+                for (uint i=0; i < hitObjects.size(); i++) {
+                    AABB objectAABB = objects[hitObjects[i]].aabb;
+                    objectAABB.inflate(decimal(0.01), decimal(0.01), decimal(0.01));
+                    isClose &= objectAABB.testRayIntersect(rays[r]);
+                }
+                rp3d_test(isClose);
+            }
+
+            // ------------ Flat objects ---------- //
+
+            // The children of a node without thickness along an axis are decoded exactly along this axis
+            List<DynamicAABBTreeObject> flatObjects(mAllocator);
+            for (int i=0; i < 100; i++) {
+                const Vector3 min(decimal(i % 10), 5, decimal(i / 10));
+                flatObjects.add(DynamicAABBTreeObject(AABB(min, min + Vector3(1, 0, 1)), i, 0));
+            }
+            DynamicAABBTree flatTree(mAllocator);
+            flatTree.build(flatObjects);
+            quantizedTree.build(flatTree);
+            rp3d_test(quantizedTree.getNbLeaves() == 100);
+
+            List<int32> overlappingLeaves(mAllocator);
+            quantizedTree.reportAllShapesOverlappingWithAABB(AABB(Vector3(decimal(3.5), 5, decimal(3.5)),
+                                                                  Vector3(decimal(3.5), 10, decimal(3.5))), overlappingLeaves);
+            rp3d_test(overlappingLeaves.size() == 1);
+            rp3d_test(overlappingLeaves.size() == 1 && quantizedTree.getLeafDataInt(overlappingLeaves[0])[0] == 33);
+
+            overlappingLeaves.clear();
+            quantizedTree.reportAllShapesOverlappingWithAABB(AABB(Vector3(0, decimal(5.01), 0), Vector3(10, 10, 10)), overlappingLeaves);
+            rp3d_test(overlappingLeaves.size() == 0);
+
+            // ------------ Empty tree and tree with a single object ---------- //
+
+            DynamicAABBTree smallTree(mAllocator);
+            quantizedTree.build(smallTree);
+            rp3d_test(quantizedTree.isEmpty());
+            rp3d_test(quantizedTree.getNbLeaves() == 0);
+
+            quantizedTree.reportAllShapesOverlappingWithAABB(AABB(Vector3(-10, -10, -10), Vector3(10, 10, 10)), overlappingLeaves);
+            rp3d_test(overlappingLeaves.size() == 0);
+
+            smallTree.addObject(AABB(Vector3(1, 2, 3), Vector3(4, 5, 6)), 3, 4);
+            quantizedTree.build(smallTree);
+            rp3d_test(quantizedTree.getNbNodes() == 1);
+            rp3d_test(quantizedTree.getNbLeaves() == 1);
+            rp3d_test(quantizedTree.getLeafDataInt(0)[0] == 3);
+            rp3d_test(quantizedTree.getLeafDataInt(0)[1] == 4);
+
+            quantizedTree.reportAllShapesOverlappingWithAABB(AABB(Vector3(-10, -10, -10), Vector3(10, 10, 10)), overlappingLeaves);
+            rp3d_test(overlappingLeaves.size() == 1);
+            rp3d_test(overlappingLeaves.size() == 1 && overlappingLeaves[0] == 0);
+
+            mRaycastCallback.reset();
+            quantizedTree.raycast(Ray(Vector3(2, 3, -10), Vector3(2, 3, 10)), mRaycastCallback);
+            rp3d_test(mRaycastCallback.isHit(0));
+
+            mRaycastCallback.reset();
+            quantizedTree.raycast(Ray(Vector3(2, 3, -10), Vector3(2, 3, 10), decimal(0.5)), mRaycastCallback);
+            rp3d_test(!mRaycastCallback.isHit(0));
+        }
+
+        void testTreeVsTree() {
+
+            const int nbObjects = 1000;
+            List<DynamicAABBTreeObject> objects(mAllocator);
+            createRandomObjects(objects, 2 * nbObjects);
+
+            // The first half of the objects is in the first tree (built by insertions) and the
+            // second half in the second tree (bulk-built)
+            DynamicAABBTree tree(mAllocator, decimal(0.08));
+            List<DynamicAABBTreeObject> otherObjects(mAllocator);
+            for (int i=0; i < nbObjects; i++) {
+                tree.addObject(objects[i].aabb, i, 0);
+                otherObjects.add(objects[nbObjects + i]);
+            }
+            DynamicAABBTree otherTree(mAllocator);
+            otherTree.build(otherObjects);
+
+            // Fat AABBs of the objects of the first tree (indexed by their data)
+            std::vector<AABB> fatAABBs(nbObjects);
+            List<int> nodes(mAllocator);
+            tree.reportAllShapesOverlappingWithAABB(tree.getRootAABB(), nodes);
+            for (uint i=0; i < nodes.size(); i++) {
+                fatAABBs[tree.getNodeDataInt(nodes[i])[0]] = tree.getFatAABB(nodes[i]);
+            }
+
+            // Compute the expected pairs by testing all the pairs of objects
+            std::vector<std::pair<int, int>> expectedSelfPairs;
+            std::vector<std::pair<int, int>> expectedPairs;
+            for (int i=0; i < nbObjects; i++) {
+                for (int j=i+1; j < nbObjects; j++) {
+                    if (fatAABBs[i].testCollision(fatAABBs[j])) {
+                        expectedSelfPairs.push_back(std::make_pair(i, j));
+                    }
+                }
+                for (int j=0; j < nbObjects; j++) {
+                    if (fatAABBs[i].testCollision(otherObjects[j].aabb)) {
+                        expectedPairs.push_back(std::make_pair(i, otherObjects[j].dataInt[0]));
+                    }
+                }
+            }
+            rp3d_test(expectedSelfPairs.size() > 0);
+            rp3d_test(expectedPairs.size() > 0);
+
+            // ------------ Self-collision of a tree ---------- //
+
+            Stack<Pair<int32, int32>> stack(mAllocator);
+            List<Pair<int32, int32>> overlappingPairs(mAllocator);
+            tree.reportAllOverlappingLeaves(tree, stack, overlappingPairs);
+
+            // Each pair is reported once
+            std::vector<std::pair<int, int>> selfPairs;
+            for (uint i=0; i < overlappingPairs.size(); i++) {
+                selfPairs.push_back(std::make_pair(std::min(overlappingPairs[i].first, overlappingPairs[i].second),
+                                                   std::max(overlappingPairs[i].first, overlappingPairs[i].second)));
+            }
+            std::sort(selfPairs.begin(), selfPairs.end());
+            rp3d_test(selfPairs == expectedSelfPairs);
+
+            // ------------ Traversal of two trees ---------- //
+
+            overlappingPairs.clear();
+            tree.reportAllOverlappingLeaves(otherTree, stack, overlappingPairs);
+
+            std::vector<std::pair<int, int>> pairs;
+            for (uint i=0; i < overlappingPairs.size(); i++) {
+                pairs.push_back(std::make_pair(overlappingPairs[i].first, overlappingPairs[i].second));
+            }
+            std::sort(pairs.begin(), pairs.end());
+            std::sort(expectedPairs.begin(), expectedPairs.end());
+            rp3d_test(pairs == expectedPairs);
+
+            // ------------ Traversals split into pairs of nodes ---------- //
+
+            List<Pair<int32, int32>> nodePairs(mAllocator);
+            tree.splitTreeVsTreeTraversal(tree, 32, nodePairs);
+            rp3d_test(nodePairs.size() >= 32);
+
+            overlappingPairs.clear();
+            for (uint i=0; i < nodePairs.size(); i++) {
+                tree.reportOverlappingLeaves(tree, nodePairs[i], stack, overlappingPairs);
+            }
+            selfPairs.clear();
+            for (uint i=0; i < overlappingPairs.size(); i++) {
+                selfPairs.push_back(std::make_pair(std::min(overlappingPairs[i].first, overlappingPairs[i].second),
+                                                   std::max(overlappingPairs[i].first, overlappingPairs[i].second)));
+            }
+            std::sort(selfPairs.begin(), selfPairs.end());
+            rp3d_test(selfPairs == expectedSelfPairs);
+
+            tree.splitTreeVsTreeTraversal(otherTree, 32, nodePairs);
+            rp3d_test(nodePairs.size() >= 32);
+
+            overlappingPairs.clear();
+            for (uint i=0; i < nodePairs.size(); i++) {
+                tree.reportOverlappingLeaves(otherTree, nodePairs[i], stack, overlappingPairs);
+            }
+            pairs.clear();
+            for (uint i=0; i < overlappingPairs.size(); i++) {
+                pairs.push_back(std::make_pair(overlappingPairs[i].first, overlappingPairs[i].second));
+            }
+            std::sort(pairs.begin(), pairs.end());
+            rp3d_test(pairs == expectedPairs);
+
+            // ------------ Empty tree and tree with a single object ---------- //
+
+            DynamicAABBTree smallTree(mAllocator);
+            overlappingPairs.clear();
+            smallTree.reportAllOverlappingLeaves(smallTree, stack, overlappingPairs);
+            smallTree.reportAllOverlappingLeaves(tree, stack, overlappingPairs);
+            tree.reportAllOverlappingLeaves(smallTree, stack, overlappingPairs);
+            rp3d_test(overlappingPairs.size() == 0);
+            smallTree.splitTreeVsTreeTraversal(tree, 32, nodePairs);
+            rp3d_test(nodePairs.size() == 0);
+
+            smallTree.addObject(AABB(Vector3(40, 0, 40), Vector3(60, 20, 60)), 7, 0);
+            smallTree.reportAllOverlappingLeaves(smallTree, stack, overlappingPairs);
+            rp3d_test(overlappingPairs.size() == 0);
+
+            smallTree.reportAllOverlappingLeaves(tree, stack, overlappingPairs);
+            bool isValid = overlappingPairs.size() > 0;
+            for (uint i=0; i < overlappingPairs.size(); i++) {
+                isValid &= overlappingPairs[i].first == 7 && fatAABBs[overlappingPairs[i].second].testCollision(smallTree.getRootAABB());
+            }
+            rp3d_test(isValid);
+        }
+
+        void testIncrementalOptimization() {
+
+            const int nbObjects = 2000;
+            List<DynamicAABBTreeObject> objects(mAllocator);
+            createRandomObjects(objects, nbObjects);
+
+            // ------------ Degrade a tree with many removals and insertions ---------- //
+
+            DynamicAABBTree tree(mAllocator);
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+            tree.setProfiler(mProfiler);
+#endif
+
+            rp3d_test(tree.computeSAHCost() == decimal(0.0));
+
+            List<int32> nodesIds(mAllocator);
+            for (int i=0; i < nbObjects; i++) {
+                nodesIds.add(tree.addObject(objects[i].aabb, i, 0));
+            }
+            for (int k=0; k < 10; k++) {
+                for (int i=k; i < nbObjects; i += 3) {
+                    tree.removeObject(nodesIds[i]);
+                    const Vector3 offset((k * 37 + i) % 100 - objects[i].aabb.getMin().x, 0, 0);
+                    objects[i].aabb = AABB(objects[i].aabb.getMin() + offset, objects[i].aabb.getMax() + offset);
+                    nodesIds[i] = tree.addObject(objects[i].aabb, i, 0);
+                }
+            }
+
+            const decimal initialCost = tree.computeSAHCost();
+            const int initialHeight = tree.computeHeight();
+            rp3d_test(initialCost > decimal(1.0));
+
+            // ------------ Optimize the tree with a small budget at each frame ---------- //
+
+            tree.optimizeIncremental(0);
+            rp3d_test(tree.computeSAHCost() == initialCost);
+
+            for (int frame=0; frame < 200; frame++) {
+                tree.optimizeIncremental(64);
+            }
+
+            // The cost must decrease and the height must not increase
+            rp3d_test(tree.computeSAHCost() < decimal(0.9) * initialCost);
+            rp3d_test(tree.computeHeight() <= initialHeight);
+
+            // The overlapping objects must still be the same as with a brute-force test
+            AABB queries[3] = {AABB(Vector3(10, 0, 10), Vector3(20, 5, 20)), AABB(Vector3(-10, -10, -10), Vector3(110, 30, 110)),
+                               AABB(Vector3(50, 10, 0), Vector3(51, 11, 100))};
+            for (int q=0; q < 3; q++) {
+
+                List<int> overlappingNodes(mAllocator);
+                tree.reportAllShapesOverlappingWithAABB(queries[q], overlappingNodes);
+
+                uint nbExpectedNodes = 0;
+                bool isFound = true;
+                for (int i=0; i < nbObjects; i++) {
+                    if (queries[q].testCollision(objects[i].aabb)) {
+                        nbExpectedNodes++;
+                        isFound &= isOverlapping(nodesIds[i], overlappingNodes);
+                    }
+                }
+                rp3d_test(isFound);
+                rp3d_test(overlappingNodes.size() == nbExpectedNodes);
+            }
+
+            // ------------ The tree must still be dynamic after the optimization ---------- //
+
+            for (int i=0; i < nbObjects; i += 2) {
+                tree.removeObject(nodesIds[i]);
+            }
+
+            List<int> overlappingNodes(mAllocator);
+            tree.reportAllShapesOverlappingWithAABB(AABB(Vector3(-10, -10, -10), Vector3(300, 300, 300)), overlappingNodes);
+            rp3d_test(overlappingNodes.size() == nbObjects / 2);
+
+            // ------------ Optimize a tree with a single object ---------- //
+
+            DynamicAABBTree smallTree(mAllocator);
+            smallTree.optimizeIncremental(10);
+            smallTree.addObject(AABB(Vector3(1, 2, 3), Vector3(4, 5, 6)), 1, 0);
+            smallTree.optimizeIncremental(10);
+            rp3d_test(smallTree.computeHeight() == 0);
+            rp3d_test(smallTree.computeSAHCost() == decimal(0.0));
+        }
+
+        void testCompaction() {
+
+            const int nbObjects = 1000;
+            List<DynamicAABBTreeObject> objects(mAllocator);
+            createRandomObjects(objects, nbObjects);
+
+            // ------------ Create a tree with many removals and insertions ---------- //
+
+            DynamicAABBTree tree(mAllocator);
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+            tree.setProfiler(mProfiler);
+#endif
+
+            List<int32> nodesIds(mAllocator);
+            for (int i=0; i < nbObjects; i++) {
+                nodesIds.add(tree.addObject(objects[i].aabb, i, 2 * i));
+            }
+            for (int i=0; i < nbObjects; i += 3) {
+                tree.removeObject(nodesIds[i]);
+                nodesIds[i] = tree.addObject(objects[i].aabb, i, 2 * i);
+            }
+            for (int i=1; i < nbObjects; i += 5) {
+                tree.removeObject(nodesIds[i]);
+                nodesIds[i] = -1;
+            }
+
+            const AABB query(Vector3(10, 0, 10), Vector3(40, 10, 40));
+            List<int> overlappingNodes(mAllocator);
+            tree.reportAllShapesOverlappingWithAABB(query, overlappingNodes);
+            const int height = tree.computeHeight();
+            const AABB rootAABB = tree.getRootAABB();
+
+            // ------------ Compact the tree ---------- //
+
+            List<int32> newNodesIds(mAllocator);
+            tree.compact(&newNodesIds);
+
+            // The nodes keep their data and AABB with their new IDs
+            bool isValid = true;
+            for (int i=0; i < nbObjects; i++) {
+                if (nodesIds[i] == -1) continue;
+                const int32 newNodeId = newNodesIds[nodesIds[i]];
+                isValid &= newNodeId != -1;
+                isValid &= tree.getNodeDataInt(newNodeId)[0] == i;
+                isValid &= tree.getNodeDataInt(newNodeId)[1] == 2 * i;
+                isValid &= tree.getFatAABB(newNodeId).getMin() == objects[i].aabb.getMin();
+                nodesIds[i] = newNodeId;
+            }
+            rp3d_test(isValid);
+
+            // The tree structure does not change
+            rp3d_test(tree.computeHeight() == height);
+            rp3d_test(tree.getRootAABB().getMin() == rootAABB.getMin());
+            rp3d_test(tree.getRootAABB().getMax() == rootAABB.getMax());
+
+            List<int> newOverlappingNodes(mAllocator);
+            tree.reportAllShapesOverlappingWithAABB(query, newOverlappingNodes);
+            rp3d_test(newOverlappingNodes.size() == overlappingNodes.size());
+            isValid = true;
+            for (uint i=0; i < overlappingNodes.size(); i++) {
+                isValid &= isOverlapping(newNodesIds[overlappingNodes[i]], newOverlappingNodes);
+            }
+            rp3d_test(isValid);
+
+            // ------------ The tree must still be dynamic after the compaction ---------- //
+
+            for (int i=0; i < nbObjects; i += 2) {
+                if (nodesIds[i] != -1) {
+                    tree.removeObject(nodesIds[i]);
+                    nodesIds[i] = -1;
+                }
+            }
+            for (int i=1; i < nbObjects; i += 5) {
+                nodesIds[i] = tree.addObject(objects[i].aabb, i, 2 * i);
+            }
+
+            int nbObjectsInTree = 0;
+            isValid = true;
+            overlappingNodes.clear();
+            tree.reportAllShapesOverlappingWithAABB(AABB(Vector3(-10, -10, -10), Vector3(300, 300, 300)), overlappingNodes);
+            for (int i=0; i < nbObjects; i++) {
+                if (nodesIds[i] != -1) {
+                    nbObjectsInTree++;
+                    isValid &= isOverlapping(nodesIds[i], overlappingNodes);
+                }
+            }
+            rp3d_test(isValid);
+            rp3d_test(overlappingNodes.size() == static_cast<uint>(nbObjectsInTree));
+
+            // ------------ Compact an empty tree ---------- //
+
+            DynamicAABBTree emptyTree(mAllocator);
+            emptyTree.compact(&newNodesIds);
+            isValid = newNodesIds.size() > 0;
+            for (uint i=0; i < newNodesIds.size(); i++) {
+                isValid &= newNodesIds[i] == -1;
+            }
+            rp3d_test(isValid);
+            const int32 nodeId = emptyTree.addObject(AABB(Vector3(1, 2, 3), Vector3(4, 5, 6)), 3, 4);
+            rp3d_test(emptyTree.getNodeDataInt(nodeId)[0] == 3);
+        }
  };
 
 }
@@ -31,6 +31,7 @@
 #include <reactphysics3d/engine/PhysicsCommon.h>
 #include <reactphysics3d/engine/PhysicsWorld.h>
 #include <reactphysics3d/body/CollisionBody.h>
+#include <reactphysics3d/body/RigidBody.h>
 #include <reactphysics3d/collision/shapes/BoxShape.h>
 #include <reactphysics3d/collision/shapes/SphereShape.h>
 #include <reactphysics3d/collision/shapes/CapsuleShape.h>
@@ -42,6 +43,7 @@
 #include <reactphysics3d/collision/TriangleVertexArray.h>
 #include <reactphysics3d/collision/RaycastInfo.h>
 #include <reactphysics3d/collision/PolygonVertexArray.h>
+#include <reactphysics3d/engine/DefaultTaskScheduler.h>
 #include <vector>
 
 /// Reactphysics3D namespace
@@ -92,6 +94,33 @@ class WorldRaycastCallback : public RaycastCallback {
         }
 };
 
+/// Class ClosestRaycastCallback
+class ClosestRaycastCallback : public RaycastCallback {
+
+    public:
+
+        RaycastInfo raycastInfo;
+
+        ClosestRaycastCallback() {
+            raycastInfo.hitFraction = DECIMAL_LARGEST;
+        }
+
+        virtual decimal notifyRaycastHit(const RaycastInfo& info) override {
+
+            if (info.hitFraction <= raycastInfo.hitFraction) {
+                raycastInfo.body = info.body;
+                raycastInfo.hitFraction = info.hitFraction;
+                raycastInfo.collider = info.collider;
+                raycastInfo.worldNormal = info.worldNormal;
+                raycastInfo.worldPoint = info.worldPoint;
+                raycastInfo.triangleIndex = info.triangleIndex;
+            }
+
+            // Clip the ray to the hit to find the closest hit
+            return info.hitFraction;
+        }
+};
+
 // Class TestPointInside
 /**
  * Unit test for the CollisionBody::testPointInside() method.
@@ -327,6 +356,8 @@ class TestRaycast : public Test {
             testCompound();
             testConcaveMesh();
             testHeightField();
+            testHeightFieldGridWalk();
+            testBatchRaycast();
         }
 
         /// Test the Collider::raycast(), CollisionBody::raycast() and
@@ -1742,6 +1773,179 @@ class TestRaycast : public Test {
             mWorld->raycast(Ray(ray14.point1, ray14.point2, decimal(0.8)), &mCallback);
             rp3d_test(mCallback.isHit);
         }
+
+        /// Test the raycast against a height field (walk over the grid cells crossed by the ray)
+        /// by comparing it with a raycast against all the triangles of the height field
+        void testHeightFieldGridWalk() {
+
+            const int nbColumns = 33;
+            const int nbRows = 17;
+            std::vector<float> heights(nbColumns * nbRows);
+            for (int j=0; j < nbRows; j++) {
+                for (int i=0; i < nbColumns; i++) {
+                    heights[j * nbColumns + i] = float(3 + 1.5 * std::sin(i * 0.7) * std::cos(j * 1.3) + (((i * 7 + j * 13) % 5) * 0.3));
+                }
+            }
+
+            CollisionBody* body = mWorld->createCollisionBody(Transform::identity());
+
+            // Test with and without the min/max height pyramid for each up axis
+            for (int k=0; k < 6; k++) {
+
+                const int upAxis = k % 3;
+                HeightFieldShape* shape = mPhysicsCommon.createHeightFieldShape(nbColumns, nbRows, 0, 6, heights.data(),
+                                                                                HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE,
+                                                                                upAxis, 1, Vector3(decimal(1.5), decimal(0.8), decimal(1.2)));
+                shape->enableMinMaxHeightPyramid(k >= 3);
+                rp3d_test(shape->isMinMaxHeightPyramidEnabled() == (k >= 3));
+                Collider* collider = body->addCollider(shape, Transform::identity());
+
+                Vector3 min, max;
+                shape->getLocalBounds(min, max);
+                const Vector3 extent = max - min;
+
+                // Long diagonal, short, vertical and horizontal rays
+                for (int r=0; r < 300; r++) {
+
+                    const decimal a = decimal((r * 37) % 101) / decimal(100.0);
+                    const decimal b = decimal((r * 53) % 97) / decimal(96.0);
+                    const decimal c = decimal((r * 17) % 89) / decimal(88.0);
+                    const decimal d = decimal((r * 29) % 83) / decimal(82.0);
+
+                    Vector3 point1 = min + Vector3(a * extent.x * decimal(1.4), b * extent.y * decimal(1.4), c * extent.z * decimal(1.4)) - extent * decimal(0.2);
+                    Vector3 point2 = min + Vector3(d * extent.x, c * extent.y, a * extent.z);
+                    point1[upAxis] = max[upAxis] + 1;
+                    point2[upAxis] = min[upAxis] + (r % 4 == 0 ? -1 : b * extent[upAxis]);
+                    if (r % 7 == 0) {
+                        const decimal upCoord = point2[upAxis];
+                        point2 = point1;
+                        point2[upAxis] = upCoord;
+                    }
+                    else if (r % 11 == 0) {
+                        point1[upAxis] = min[upAxis] + c * extent[upAxis];
+                        point2[upAxis] = point1[upAxis] + decimal(0.1);
+                    }
+                    const Ray ray(point1, point2, r % 5 == 0 ? decimal(0.6) : decimal(1.0));
+
+                    // Raycast against all the triangles of the height field
+                    bool isHitExpected = false;
+                    decimal expectedHitFraction = ray.maxFraction;
+                    for (int i=0; i < nbColumns - 1; i++) {
+                        for (int j=0; j < nbRows - 1; j++) {
+
+                            const Vector3 triangle1[3] = {shape->getVertexAt(i, j), shape->getVertexAt(i, j + 1), shape->getVertexAt(i + 1, j)};
+                            const Vector3 triangle2[3] = {shape->getVertexAt(i + 1, j), shape->getVertexAt(i, j + 1), shape->getVertexAt(i + 1, j + 1)};
+                            decimal hitFraction;
+                            Vector3 hitPoint, hitNormal;
+                            if (TriangleShape::raycastTriangle(ray, triangle1, TriangleRaycastSide::FRONT, hitFraction, hitPoint, hitNormal) &&
+                                hitFraction < expectedHitFraction && (hitPoint - ray.point1).dot(ray.point2 - ray.point1) >= 0) {
+                                expectedHitFraction = hitFraction;
+                                isHitExpected = true;
+                            }
+                            if (TriangleShape::raycastTriangle(ray, triangle2, TriangleRaycastSide::FRONT, hitFraction, hitPoint, hitNormal) &&
+                                hitFraction < expectedHitFraction && (hitPoint - ray.point1).dot(ray.point2 - ray.point1) >= 0) {
+                                expectedHitFraction = hitFraction;
+                                isHitExpected = true;
+                            }
+                        }
+                    }
+
+                    RaycastInfo raycastInfo;
+                    const bool isHit = collider->raycast(ray, raycastInfo);
+                    rp3d_test(isHit == isHitExpected);
+                    if (isHit && isHitExpected) {
+                        rp3d_test(approxEqual(raycastInfo.hitFraction, expectedHitFraction, decimal(0.0001)));
+                        rp3d_test(raycastInfo.collider == collider);
+                    }
+                }
+
+                body->removeCollider(collider);
+                mPhysicsCommon.destroyHeightFieldShape(shape);
+            }
+
+            mWorld->destroyCollisionBody(body);
+        }
+
+        /// Test the PhysicsWorld::raycast() method with a batch of rays
+        void testBatchRaycast() {
+
+            // Vertical rays (some of them without x and z components) and horizontal rays
+            std::vector<Ray> rays;
+            for (int i=0; i < 250; i++) {
+                const Vector3 origin(decimal(-30 + i * 0.24), 20, decimal(-30 + (i % 11) * 5.5));
+                const Vector3 direction = i % 3 == 0 ? Vector3(0, -40, 0) : Vector3(4, -40, 3);
+                rays.push_back(Ray(origin, origin + direction));
+            }
+            for (int i=0; i < 101; i++) {
+                const Vector3 origin(-40, decimal(-3 + (i % 13) * 0.5), decimal(-30 + i * 0.6));
+                rays.push_back(Ray(origin, origin + Vector3(80, decimal(0.5), 1), decimal(0.9)));
+            }
+
+            std::vector<RaycastInfo> hits(rays.size());
+            const unsigned short masks[2] = {0xFFFF, CATEGORY1};
+            const BroadPhaseAlgorithmType broadPhaseAlgorithms[3] = {BroadPhaseAlgorithmType::DYNAMIC_AABB_TREE,
+                                                                     BroadPhaseAlgorithmType::SWEEP_AND_PRUNE,
+                                                                     BroadPhaseAlgorithmType::HASH_GRID};
+
+            // Create a task scheduler so that the batch is split among several threads
+            DefaultTaskScheduler* taskScheduler = mPhysicsCommon.createDefaultTaskScheduler(4);
+
+            for (int b=0; b < 3; b++) {
+
+                PhysicsWorld::WorldSettings settings;
+                settings.taskScheduler = taskScheduler;
+                settings.broadPhaseAlgorithm = broadPhaseAlgorithms[b];
+                PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(settings);
+
+                // Create a grid of static and kinematic bodies with the different shapes
+                CollisionShape* shapes[5] = {mBoxShape, mSphereShape, mCapsuleShape, mConvexMeshShape, mConcaveMeshShape};
+                for (int i=0; i < 5; i++) {
+                    for (int j=0; j < 5; j++) {
+
+                        Transform transform(Vector3(decimal(i * 12 - 24), 0, decimal(j * 12 - 24)),
+                                            Quaternion::fromEulerAngles(decimal(i * 0.3), decimal(j * 0.5), decimal(0.2)));
+                        RigidBody* body = world->createRigidBody(transform);
+                        body->setType(i % 2 == 0 ? BodyType::STATIC : BodyType::KINEMATIC);
+                        Collider* collider = body->addCollider(shapes[(i + j) % 5], Transform::identity());
+                        collider->setCollisionCategoryBits(j % 2 == 0 ? CATEGORY1 : CATEGORY2);
+                    }
+                }
+
+                // Update the world twice so that the static objects of the broad-phase are in the wide tree
+                world->update(decimal(1.0 / 60.0));
+                world->update(decimal(1.0 / 60.0));
+
+                for (int m=0; m < 2; m++) {
+
+                    world->raycast(&(rays[0]), static_cast<uint32>(rays.size()), &(hits[0]), masks[m]);
+
+                    // Compare the closest hits of the batch with the ones of a raycast per ray
+                    uint nbHits = 0;
+                    for (uint i=0; i < rays.size(); i++) {
+
+                        ClosestRaycastCallback callback;
+                        world->raycast(rays[i], &callback, masks[m]);
+
+                        rp3d_test(hits[i].collider == callback.raycastInfo.collider);
+                        if (hits[i].collider == nullptr) continue;
+
+                        nbHits++;
+                        rp3d_test(hits[i].body == hits[i].collider->getBody());
+                        rp3d_test(approxEqual(hits[i].hitFraction, callback.raycastInfo.hitFraction, epsilon));
+                        rp3d_test(approxEqual(hits[i].worldPoint.x, callback.raycastInfo.worldPoint.x, epsilon));
+                        rp3d_test(approxEqual(hits[i].worldPoint.y, callback.raycastInfo.worldPoint.y, epsilon));
+                        rp3d_test(approxEqual(hits[i].worldPoint.z, callback.raycastInfo.worldPoint.z, epsilon));
+                        rp3d_test(approxEqual(hits[i].worldNormal.dot(callback.raycastInfo.worldNormal), decimal(1.0), epsilon));
+                    }
+
+                    rp3d_test(nbHits > 50);
+                }
+
+                mPhysicsCommon.destroyPhysicsWorld(world);
+            }
+
+            mPhysicsCommon.destroyDefaultTaskScheduler(taskScheduler);
+        }
 };
 
 }
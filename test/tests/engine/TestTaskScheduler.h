@@ -0,0 +1,436 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_TASK_SCHEDULER_H
+#define TEST_TASK_SCHEDULER_H
+
+// Libraries
+#include "Test.h"
+#include <reactphysics3d/reactphysics3d.h>
+#include <atomic>
+#include <map>
+#include <vector>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class ContactPairsCounter
+/**
+ * Event listener that records the number of contact pairs reported at each step
+ */
+class ContactPairsCounter : public EventListener {
+
+    public:
+
+        std::vector<uint> mNbContactPairs;
+
+        virtual void onContact(const CollisionCallback::CallbackData& callbackData) override {
+            mNbContactPairs.push_back(callbackData.getNbContactPairs());
+        }
+};
+
+// Class ShapeTypesPairsCounter
+/**
+ * Event listener that also records the number of contact pairs of each pair of shape types at the first step
+ */
+class ShapeTypesPairsCounter : public ContactPairsCounter {
+
+    public:
+
+        std::map<std::pair<int, int>, uint> mNbShapeTypesPairs;
+
+        virtual void onContact(const CollisionCallback::CallbackData& callbackData) override {
+
+            ContactPairsCounter::onContact(callbackData);
+            if (mNbContactPairs.size() > 1) return;
+
+            for (uint i=0; i < callbackData.getNbContactPairs(); i++) {
+
+                const CollisionCallback::ContactPair contactPair = callbackData.getContactPair(i);
+                const int type1 = static_cast<int>(contactPair.getCollider1()->getCollisionShape()->getName());
+                const int type2 = static_cast<int>(contactPair.getCollider2()->getCollisionShape()->getName());
+                mNbShapeTypesPairs[std::make_pair(std::min(type1, type2), std::max(type1, type2))]++;
+            }
+        }
+};
+
+// Class TestTaskScheduler
+/**
+ * Unit test for the task scheduler and the multithreaded simulation step
+ */
+class TestTaskScheduler : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        PhysicsCommon mPhysicsCommon;
+
+        // ---------- Methods ---------- //
+
+        /// Create a world with a ground and a grid of falling boxes, spheres and capsules
+        PhysicsWorld* createWorld(TaskScheduler* taskScheduler, BoxShape* boxShape, SphereShape* sphereShape,
+                                  CapsuleShape* capsuleShape, std::vector<RigidBody*>& bodies) {
+
+            PhysicsWorld::WorldSettings settings;
+            settings.taskScheduler = taskScheduler;
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(settings);
+
+            RigidBody* ground = world->createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            ground->setType(BodyType::STATIC);
+            ground->addCollider(mPhysicsCommon.createBoxShape(Vector3(100, 1, 100)), Transform::identity());
+
+            for (int i=0; i < 20; i++) {
+                for (int j=0; j < 30; j++) {
+
+                    const Vector3 position(decimal(i) * decimal(2.5) - decimal(25), decimal(1 + (i + j) % 4), decimal(j) * decimal(2.5) - decimal(37));
+                    RigidBody* body = world->createRigidBody(Transform(position, Quaternion::fromEulerAngles(decimal(0.1) * i, 0, decimal(0.2) * j)));
+                    body->setAngularDamping(decimal(0.1));
+                    if ((i + j) % 3 == 0) {
+                        body->addCollider(boxShape, Transform::identity());
+                    }
+                    else if ((i + j) % 3 == 1) {
+                        body->addCollider(sphereShape, Transform::identity());
+                    }
+                    else {
+                        body->addCollider(capsuleShape, Transform::identity());
+                    }
+                    body->updateMassPropertiesFromColliders();
+                    body->applyTorque(Vector3(decimal(i), decimal(j), 0));
+                    bodies.push_back(body);
+                }
+            }
+
+            return world;
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestTaskScheduler(const std::string& name): Test(name)  {
+
+        }
+
+        /// Run the tests
+        void run() {
+
+            testParallelFor();
+            testNestedParallelFor();
+            testSimulationIsIdentical();
+            testNarrowPhaseIsIdentical();
+            testRotatedCollidersAABBs();
+        }
+
+        void testParallelFor() {
+
+            DefaultTaskScheduler* scheduler = mPhysicsCommon.createDefaultTaskScheduler(4);
+            rp3d_test(scheduler->getNbThreads() == 4);
+
+            const uint32 nbItems = 10007;
+            std::vector<std::atomic<int>> counters(nbItems);
+            for (uint32 i=0; i < nbItems; i++) counters[i] = 0;
+
+            // Run several ranges with different grain sizes
+            for (uint32 grainSize = 1; grainSize <= 4096; grainSize *= 8) {
+
+                scheduler->parallelFor(nbItems, grainSize, [&counters, grainSize](uint32 startIndex, uint32 endIndex) {
+                    assert(endIndex - startIndex <= grainSize);
+                    for (uint32 i=startIndex; i < endIndex; i++) {
+                        counters[i]++;
+                    }
+                });
+            }
+
+            // Each item must have been processed exactly once per range
+            bool isCorrect = true;
+            for (uint32 i=0; i < nbItems; i++) {
+                isCorrect &= counters[i] == 5;
+            }
+            rp3d_test(isCorrect);
+
+            // Empty range
+            bool isCalled = false;
+            scheduler->parallelFor(0, 16, [&isCalled](uint32, uint32) { isCalled = true; });
+            rp3d_test(!isCalled);
+
+            // Without a scheduler, the task is executed on the whole range on the calling thread
+            uint32 nbCalls = 0;
+            parallelFor(nullptr, 1000, 10, [&nbCalls](uint32 startIndex, uint32 endIndex) {
+                nbCalls++;
+                assert(startIndex == 0 && endIndex == 1000);
+            });
+            rp3d_test(nbCalls == 1);
+
+            mPhysicsCommon.destroyDefaultTaskScheduler(scheduler);
+        }
+
+        void testNestedParallelFor() {
+
+            DefaultTaskScheduler* scheduler = mPhysicsCommon.createDefaultTaskScheduler(3);
+
+            std::atomic<uint32> sum(0);
+            scheduler->parallelFor(64, 4, [scheduler, &sum](uint32 startIndex, uint32 endIndex) {
+                for (uint32 i=startIndex; i < endIndex; i++) {
+
+                    // A nested range is executed on the current thread
+                    scheduler->parallelFor(100, 10, [&sum](uint32 start, uint32 end) {
+                        sum += end - start;
+                    });
+                }
+            });
+
+            rp3d_test(sum == 6400);
+
+            mPhysicsCommon.destroyDefaultTaskScheduler(scheduler);
+        }
+
+        void testSimulationIsIdentical() {
+
+            DefaultTaskScheduler* scheduler = mPhysicsCommon.createDefaultTaskScheduler(4);
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5)));
+            SphereShape* sphereShape = mPhysicsCommon.createSphereShape(decimal(0.6));
+            CapsuleShape* capsuleShape = mPhysicsCommon.createCapsuleShape(decimal(0.4), decimal(1.0));
+
+            std::vector<RigidBody*> serialBodies;
+            std::vector<RigidBody*> parallelBodies;
+            PhysicsWorld* serialWorld = createWorld(nullptr, boxShape, sphereShape, capsuleShape, serialBodies);
+            PhysicsWorld* parallelWorld = createWorld(scheduler, boxShape, sphereShape, capsuleShape, parallelBodies);
+
+            ContactPairsCounter serialCounter;
+            ContactPairsCounter parallelCounter;
+            serialWorld->setEventListener(&serialCounter);
+            parallelWorld->setEventListener(&parallelCounter);
+
+            for (int i=0; i < 90; i++) {
+                serialWorld->update(decimal(1.0) / decimal(60.0));
+                parallelWorld->update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The results must be bitwise identical
+            bool isIdentical = true;
+            for (uint32 i=0; i < serialBodies.size(); i++) {
+
+                const Transform& transform1 = serialBodies[i]->getTransform();
+                const Transform& transform2 = parallelBodies[i]->getTransform();
+                isIdentical &= transform1.getPosition() == transform2.getPosition();
+                isIdentical &= transform1.getOrientation() == transform2.getOrientation();
+                isIdentical &= serialBodies[i]->getLinearVelocity() == parallelBodies[i]->getLinearVelocity();
+                isIdentical &= serialBodies[i]->getAngularVelocity() == parallelBodies[i]->getAngularVelocity();
+            }
+            rp3d_test(isIdentical);
+
+            // The broad-phase and narrow-phase must have reported the same contacts
+            rp3d_test(serialCounter.mNbContactPairs.size() > 0);
+            rp3d_test(serialCounter.mNbContactPairs == parallelCounter.mNbContactPairs);
+
+            // The bodies must have moved
+            rp3d_test(serialBodies[1]->getTransform().getPosition().y < decimal(1.0));
+
+            mPhysicsCommon.destroyPhysicsWorld(serialWorld);
+            mPhysicsCommon.destroyPhysicsWorld(parallelWorld);
+            mPhysicsCommon.destroyDefaultTaskScheduler(scheduler);
+        }
+
+        void testNarrowPhaseIsIdentical() {
+
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(decimal(0.52), decimal(0.52), decimal(0.52)));
+            SphereShape* sphereShape = mPhysicsCommon.createSphereShape(decimal(0.55));
+            CapsuleShape* capsuleShape = mPhysicsCommon.createCapsuleShape(decimal(0.52), decimal(0.4));
+
+            // Lattice of overlapping boxes, spheres and capsules where each narrow-phase batch (sphere vs sphere,
+            // sphere vs capsule, capsule vs capsule, sphere vs polyhedron, capsule vs polyhedron and polyhedron
+            // vs polyhedron) has enough tests to be split among the threads
+            const int nbThreads[4] = {1, 2, 3, 4};
+            std::vector<RigidBody*> bodies[4];
+            PhysicsWorld* worlds[4];
+            DefaultTaskScheduler* schedulers[4];
+            ShapeTypesPairsCounter counters[4];
+            for (int w=0; w < 4; w++) {
+
+                schedulers[w] = mPhysicsCommon.createDefaultTaskScheduler(nbThreads[w]);
+                PhysicsWorld::WorldSettings settings;
+                settings.taskScheduler = schedulers[w];
+                worlds[w] = mPhysicsCommon.createPhysicsWorld(settings);
+                worlds[w]->setEventListener(&counters[w]);
+
+                for (int i=0; i < 8; i++) {
+                    for (int j=0; j < 6; j++) {
+                        for (int k=0; k < 8; k++) {
+
+                            const Vector3 position(static_cast<decimal>(i), static_cast<decimal>(j), static_cast<decimal>(k));
+                            RigidBody* body = worlds[w]->createRigidBody(Transform(position, Quaternion::fromEulerAngles(decimal(0.1) * j, decimal(0.2) * k, decimal(0.1) * i)));
+                            body->enableGravity(false);
+                            const int shapeType = (i / 2 + j + k / 2) % 3;
+                            if (shapeType == 0) {
+                                body->addCollider(boxShape, Transform::identity());
+                            }
+                            else if (shapeType == 1) {
+                                body->addCollider(sphereShape, Transform::identity());
+                            }
+                            else {
+                                body->addCollider(capsuleShape, Transform::identity());
+                            }
+                            body->updateMassPropertiesFromColliders();
+                            bodies[w].push_back(body);
+                        }
+                    }
+                }
+            }
+
+            for (int i=0; i < 40; i++) {
+                for (int w=0; w < 4; w++) {
+                    worlds[w]->update(decimal(1.0) / decimal(60.0));
+                }
+            }
+
+            // Each pair of shape types must have been tested more than NARROW_PHASE_GRAIN_SIZE times
+            const int sphere = static_cast<int>(CollisionShapeName::SPHERE);
+            const int capsule = static_cast<int>(CollisionShapeName::CAPSULE);
+            const int box = static_cast<int>(CollisionShapeName::BOX);
+            const std::pair<int, int> shapeTypesPairs[6] = {std::make_pair(sphere, sphere), std::make_pair(std::min(sphere, capsule), std::max(sphere, capsule)),
+                                                            std::make_pair(capsule, capsule), std::make_pair(std::min(sphere, box), std::max(sphere, box)),
+                                                            std::make_pair(std::min(capsule, box), std::max(capsule, box)), std::make_pair(box, box)};
+            for (int p=0; p < 6; p++) {
+                rp3d_test(counters[0].mNbShapeTypesPairs[shapeTypesPairs[p]] > NARROW_PHASE_GRAIN_SIZE);
+            }
+
+            // The results with several threads must be bitwise identical to the results with a single thread
+            for (int w=1; w < 4; w++) {
+
+                bool isIdentical = true;
+                for (uint32 i=0; i < bodies[0].size(); i++) {
+
+                    const Transform& transform1 = bodies[0][i]->getTransform();
+                    const Transform& transform2 = bodies[w][i]->getTransform();
+                    isIdentical &= transform1.getPosition() == transform2.getPosition();
+                    isIdentical &= transform1.getOrientation() == transform2.getOrientation();
+                }
+                rp3d_test(isIdentical);
+                rp3d_test(counters[w].mNbContactPairs == counters[0].mNbContactPairs);
+            }
+
+            // The bodies must have been pushed apart
+            rp3d_test(bodies[0][1]->getTransform().getPosition() != Vector3(0, 0, 1));
+
+            for (int w=0; w < 4; w++) {
+                mPhysicsCommon.destroyPhysicsWorld(worlds[w]);
+                mPhysicsCommon.destroyDefaultTaskScheduler(schedulers[w]);
+            }
+        }
+
+        void testRotatedCollidersAABBs() {
+
+            DefaultTaskScheduler* scheduler = mPhysicsCommon.createDefaultTaskScheduler(4);
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(decimal(1.0), decimal(0.5), decimal(0.3)));
+            CapsuleShape* capsuleShape = mPhysicsCommon.createCapsuleShape(decimal(0.3), decimal(2.0));
+            SphereShape* sphereShape = mPhysicsCommon.createSphereShape(decimal(0.5));
+            SphereShape* probeShape = mPhysicsCommon.createSphereShape(decimal(0.05));
+
+            PhysicsWorld::WorldSettings settings;
+            settings.taskScheduler = scheduler;
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(settings);
+
+            // Grid of rotated shapes with a small probe inside of each shape near the extreme
+            // point of the shape along a world axis (outside of the local bounds of the shape)
+            std::vector<RigidBody*> bodies;
+            std::vector<RigidBody*> probes;
+            for (int i=0; i < 600; i++) {
+
+                const Vector3 position(decimal(i % 30) * decimal(5.0), 0, decimal(i / 30) * decimal(5.0));
+                const Quaternion orientation = Quaternion::fromEulerAngles(decimal(0.3) * (i % 7), decimal(0.2) * (i % 11),
+                                                                           decimal(0.1) * (i % 13));
+                const Matrix3x3 matrix = orientation.getMatrix();
+                const int axis = i % 3;
+
+                RigidBody* body = world->createRigidBody(Transform(position, orientation));
+                body->setType(BodyType::KINEMATIC);
+
+                Vector3 extremePoint;
+                switch (i % 3) {
+
+                    case 0:
+                    {
+                        body->addCollider(boxShape, Transform::identity());
+                        const Vector3 halfExtents = boxShape->getHalfExtents();
+                        Vector3 localCorner;
+                        for (int j=0; j < 3; j++) {
+                            localCorner[j] = matrix[axis][j] < decimal(0.0) ? -halfExtents[j] : halfExtents[j];
+                        }
+                        extremePoint = position + matrix * localCorner;
+                        break;
+                    }
+                    case 1:
+                    {
+                        body->addCollider(capsuleShape, Transform::identity());
+                        const decimal halfHeight = capsuleShape->getHeight() * decimal(0.5);
+                        const Vector3 sphereCenter(0, matrix[axis][1] < decimal(0.0) ? -halfHeight : halfHeight, 0);
+                        Vector3 direction(0, 0, 0);
+                        direction[axis] = capsuleShape->getRadius();
+                        extremePoint = position + matrix * sphereCenter + direction;
+                        break;
+                    }
+                    default:
+                    {
+                        body->addCollider(sphereShape, Transform::identity());
+                        Vector3 direction(0, 0, 0);
+                        direction[axis] = sphereShape->getRadius();
+                        extremePoint = position + direction;
+                        break;
+                    }
+                }
+
+                RigidBody* probe = world->createRigidBody(Transform(extremePoint + (position - extremePoint) * decimal(0.03),
+                                                                    Quaternion::identity()));
+                probe->setType(BodyType::KINEMATIC);
+                probe->addCollider(probeShape, Transform::identity());
+
+                bodies.push_back(body);
+                probes.push_back(probe);
+            }
+
+            // Move all the bodies out of their fat AABBs so that their AABBs are recomputed
+            for (uint32 i=0; i < bodies.size(); i++) {
+                bodies[i]->setLinearVelocity(Vector3(0, decimal(120.0), 0));
+                probes[i]->setLinearVelocity(Vector3(0, decimal(120.0), 0));
+            }
+            world->update(decimal(1.0) / decimal(60.0));
+
+            // Each probe is only detected if the AABB of its shape contains the extreme point
+            bool areOverlapping = true;
+            for (uint32 i=0; i < bodies.size(); i++) {
+                areOverlapping &= world->testOverlap(bodies[i], probes[i]);
+            }
+            rp3d_test(areOverlapping);
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+            mPhysicsCommon.destroyDefaultTaskScheduler(scheduler);
+        }
+ };
+
+}
+
+#endif